@@ -154,7 +154,8 @@ namespace btk
     
     for (std::list< std::pair<Analog::Pointer, Analog::Pointer> >::iterator it = signals.begin() ; it != signals.end() ; ++it)
     {
-      double dc = it->second->GetValues().sum() / it->second->GetValues().rows();
+      const Analog::Values& offset = static_cast<const Analog*>(it->second.get())->GetValues(); // Read-only access to not copy the shared values
+      double dc = offset.sum() / offset.rows();
       it->first->GetValues().array() -= dc;
     }
     
@@ -0,0 +1,465 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkButterworthFilter.h"
+#include "btkConvert.h"
+
+#include <btkEigen/SignalProcessing/FiltFilt.h>
+#include <btkEigen/SignalProcessing/IIRFilterDesign.h>
+
+#include <algorithm>
+
+namespace btk
+{
+  // Column(s) of a measure to filter.
+  struct ButterworthJob
+  {
+    std::string label;
+    double* values;
+    const double* residuals; // Null for analog channels
+    int rows;
+    int cols;
+    bool fullyFiltered;
+  };
+  
+  static bool DesignButterworth(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, const double* fc, ButterworthFilter::BandType type, double fs)
+  {
+    const double nyquist = fs / 2.0;
+    if ((type == ButterworthFilter::LowPass) || (type == ButterworthFilter::HighPass))
+    {
+      double wn = fc[0] / nyquist;
+      if ((wn <= 0.0) || (wn >= 1.0))
+        return false;
+      return btkEigen::butter(b, a, order, wn, (type == ButterworthFilter::LowPass) ? btkEigen::LowPass : btkEigen::HighPass);
+    }
+    double wn[2] = {fc[0] / nyquist, fc[1] / nyquist};
+    if ((wn[0] <= 0.0) || (wn[1] >= 1.0) || (wn[0] >= wn[1]))
+      return false;
+    return btkEigen::butter(b, a, order, wn, (type == ButterworthFilter::BandPass) ? btkEigen::BandPass : btkEigen::BandStop);
+  };
+  
+  // Filter each segment of consecutive valid samples (residual greater or equal to 0). 
+  // Segments too short for the forward-backward filter are not modified.
+  static void FilterButterworthJob(ButterworthJob* job, const Eigen::Matrix<double, Eigen::Dynamic, 1>& b, const Eigen::Matrix<double, Eigen::Dynamic, 1>& a)
+  {
+    const int minLength = 3 * (static_cast<int>(std::max(b.rows(), a.rows())) - 1) + 1;
+    Eigen::Map< Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> > values(job->values, job->rows, job->cols);
+    job->fullyFiltered = true;
+    int start = 0;
+    while (start < job->rows)
+    {
+      if ((job->residuals != 0) && (job->residuals[start] < 0.0))
+      {
+        ++start;
+        continue;
+      }
+      int stop = start + 1;
+      while ((stop < job->rows) && ((job->residuals == 0) || (job->residuals[stop] >= 0.0)))
+        ++stop;
+      const int len = stop - start;
+      if (len >= minLength)
+      {
+        Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> segment = values.block(start, 0, len, job->cols);
+        values.block(start, 0, len, job->cols) = btkEigen::filtfilt(b, a, segment);
+      }
+      else
+        job->fullyFiltered = false;
+      start = stop;
+    }
+  };
+  
+  static void FilterButterworthJobs(std::vector<ButterworthJob>& jobs, const Eigen::Matrix<double, Eigen::Dynamic, 1>& b, const Eigen::Matrix<double, Eigen::Dynamic, 1>& a)
+  {
+    const int num = static_cast<int>(jobs.size());
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0 ; i < num ; ++i)
+      FilterButterworthJob(&(jobs[i]), b, a);
+    for (int i = 0 ; i < num ; ++i)
+    {
+      if (!jobs[i].fullyFiltered)
+      {
+        btkWarningMacro("Some parts of '" + jobs[i].label + "' are too short to be filtered and are kept unmodified.");
+      }
+    }
+  };
+  
+  static bool IsButterworthLabelSelected(const std::list<std::string>& labels, const std::string& label)
+  {
+    return labels.empty() || (std::find(labels.begin(), labels.end(), label) != labels.end());
+  };
+  
+  /**
+   * @class ButterworthFilter btkButterworthFilter.h
+   * @brief Zero-phase Butterworth filter applied on the points and analog channels of an acquisition.
+   *
+   * The filter is designed with the function btkEigen::butter() and applied forward and backward 
+   * with the function btkEigen::filtfilt(). As the signals are filtered twice, the resulting filter has 
+   * no phase lag and its order is twice the order given by SetOrder(). The cutoff frequencies are 
+   * not adjusted for this second pass.
+   *
+   * The points are filtered with the point frequency of the acquisition and the analog channels with its analog frequency.
+   * Each filter is designed only once for all the measures sharing the same frequency. 
+   * If a filter cannot be designed (cutoff frequency above the Nyquist frequency), an error is reported 
+   * and the corresponding measures are kept unfiltered in the output.
+   * The occluded frames of a point (negative residual) are not used: each segment of consecutive 
+   * visible frames is filtered separately. The segments too short to be filtered are kept unmodified.
+   *
+   * By default, all the points and analog channels are filtered. You can select the measures to filter 
+   * with the methods SetPointLabels(), SetAnalogLabels(), SetPointsFiltered() and SetAnalogsFiltered().
+   * The measures which are not filtered are shared with the input. The filtered measures are cloned, 
+   * except if the in-place mode is enabled (see SetInPlace()). In this case, the input is directly modified.
+   *
+   * When BTK is compiled with OpenMP (option BTK_USE_OPENMP), the measures are filtered in parallel.
+   *
+   * @ingroup BTKBasicFilters
+   */
+  
+  /**
+   * @enum ButterworthFilter::BandType
+   * Type of filter.
+   */
+  /**
+   * @var ButterworthFilter::BandType ButterworthFilter::LowPass
+   * Low-pass filter (one cutoff frequency).
+   */
+  /**
+   * @var ButterworthFilter::BandType ButterworthFilter::HighPass
+   * High-pass filter (one cutoff frequency).
+   */
+  /**
+   * @var ButterworthFilter::BandType ButterworthFilter::BandPass
+   * Band-pass filter (two cutoff frequencies).
+   */
+  /**
+   * @var ButterworthFilter::BandType ButterworthFilter::BandStop
+   * Band-stop filter (two cutoff frequencies).
+   */
+  
+  /**
+   * @typedef ButterworthFilter::Pointer
+   * Smart pointer associated with a ButterworthFilter object.
+   */
+  
+  /**
+   * @typedef ButterworthFilter::ConstPointer
+   * Smart pointer associated with a const ButterworthFilter object.
+   */
+  
+  /**
+   * @fn static Pointer ButterworthFilter::New();
+   * Creates a smart pointer associated with a ButterworthFilter object.
+   */
+  
+  /**
+   * @fn Acquisition::Pointer ButterworthFilter::GetInput()
+   * Gets the input registered with this process.
+   */
+
+  /**
+   * @fn void ButterworthFilter::SetInput(Acquisition::Pointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn Acquisition::Pointer ButterworthFilter::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * @fn BandType ButterworthFilter::GetBandType() const
+   * Returns the type of filter.
+   */
+  
+  /**
+   * Sets the type of filter (low-pass by default).
+   */
+  void ButterworthFilter::SetBandType(BandType type)
+  {
+    if (this->m_BandType == type)
+      return;
+    this->m_BandType = type;
+    this->Modified();
+  };
+  
+  /**
+   * @fn int ButterworthFilter::GetOrder() const
+   * Returns the order of the designed filter (the zero-phase filter has twice this order).
+   */
+  
+  /**
+   * Sets the order of the designed filter (2 by default). The zero-phase filter has twice this order.
+   */
+  void ButterworthFilter::SetOrder(int order)
+  {
+    if (order <= 0)
+    {
+      btkErrorMacro("The order of the filter must be strictly positive.");
+      return;
+    }
+    if (this->m_Order == order)
+      return;
+    this->m_Order = order;
+    this->Modified();
+  };
+  
+  /**
+   * @fn const double* ButterworthFilter::GetCutoffFrequencies() const
+   * Returns the cutoff frequencies (in hertz). Only the first one is used for the low-pass and high-pass filters.
+   */
+  
+  /**
+   * Sets the cutoff frequency (in hertz) of a low-pass or high-pass filter.
+   */
+  void ButterworthFilter::SetCutoffFrequency(double fc)
+  {
+    this->SetCutoffFrequencies(fc, 0.0);
+  };
+  
+  /**
+   * Sets the cutoff frequencies (in hertz) of a band-pass or band-stop filter.
+   */
+  void ButterworthFilter::SetCutoffFrequencies(double fcLow, double fcHigh)
+  {
+    if ((this->mp_CutoffFrequencies[0] == fcLow) && (this->mp_CutoffFrequencies[1] == fcHigh))
+      return;
+    this->mp_CutoffFrequencies[0] = fcLow;
+    this->mp_CutoffFrequencies[1] = fcHigh;
+    this->Modified();
+  };
+  
+  /**
+   * @fn bool ButterworthFilter::GetPointsFiltered() const
+   * Returns the state of the filtering of the points.
+   */
+  
+  /**
+   * Enables or disables the filtering of the points (enabled by default).
+   */
+  void ButterworthFilter::SetPointsFiltered(bool enabled)
+  {
+    if (this->m_PointsFiltered == enabled)
+      return;
+    this->m_PointsFiltered = enabled;
+    this->Modified();
+  };
+  
+  /**
+   * @fn const std::list<std::string>& ButterworthFilter::GetPointLabels() const
+   * Returns the labels of the points to filter. An empty list means all the points.
+   */
+  
+  /**
+   * Sets the labels of the points to filter. An empty list means all the points.
+   */
+  void ButterworthFilter::SetPointLabels(const std::list<std::string>& labels)
+  {
+    if (this->m_PointLabels == labels)
+      return;
+    this->m_PointLabels = labels;
+    this->Modified();
+  };
+  
+  /**
+   * @fn bool ButterworthFilter::GetAnalogsFiltered() const
+   * Returns the state of the filtering of the analog channels.
+   */
+  
+  /**
+   * Enables or disables the filtering of the analog channels (enabled by default).
+   */
+  void ButterworthFilter::SetAnalogsFiltered(bool enabled)
+  {
+    if (this->m_AnalogsFiltered == enabled)
+      return;
+    this->m_AnalogsFiltered = enabled;
+    this->Modified();
+  };
+  
+  /**
+   * @fn const std::list<std::string>& ButterworthFilter::GetAnalogLabels() const
+   * Returns the labels of the analog channels to filter. An empty list means all the analog channels.
+   */
+  
+  /**
+   * Sets the labels of the analog channels to filter. An empty list means all the analog channels.
+   */
+  void ButterworthFilter::SetAnalogLabels(const std::list<std::string>& labels)
+  {
+    if (this->m_AnalogLabels == labels)
+      return;
+    this->m_AnalogLabels = labels;
+    this->Modified();
+  };
+  
+  /**
+   * @fn bool ButterworthFilter::GetInPlace() const
+   * Returns the state of the in-place mode.
+   */
+  
+  /**
+   * Enables or disables the in-place mode (disabled by default). 
+   * When enabled, the measures of the input are directly filtered instead of being cloned.
+   */
+  void ButterworthFilter::SetInPlace(bool enabled)
+  {
+    if (this->m_InPlace == enabled)
+      return;
+    this->m_InPlace = enabled;
+    this->Modified();
+  };
+  
+  /**
+   * Constructor. 
+   * Sets the number of inputs and outputs to 1.
+   */
+  ButterworthFilter::ButterworthFilter()
+  : ProcessObject(), m_PointLabels(), m_AnalogLabels()
+  {
+    this->m_BandType = LowPass;
+    this->m_Order = 2;
+    this->mp_CutoffFrequencies[0] = 0.0;
+    this->mp_CutoffFrequencies[1] = 0.0;
+    this->m_PointsFiltered = true;
+    this->m_AnalogsFiltered = true;
+    this->m_InPlace = false;
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+  };
+  
+  /**
+   * @fn Acquisition::Pointer ButterworthFilter::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn Acquisition::Pointer ButterworthFilter::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates an Acquisition:Pointer object and return it as a DataObject::Pointer.
+   */
+  DataObject::Pointer ButterworthFilter::MakeOutput(int /* idx */)
+  {
+    return Acquisition::New();
+  };
+  
+  /**
+   * Generates the outputs' data.
+   */
+  void ButterworthFilter::GenerateData()
+  {
+    Acquisition::Pointer output = this->GetOutput();
+    output->Reset();
+    
+    Acquisition::Pointer input = this->GetInput();
+    if (!input)
+      return;
+    
+    // Both filters are designed before touching any data, so that a failing design
+    // only leaves its own group unfiltered.
+    Eigen::Matrix<double, Eigen::Dynamic, 1> pb, pa, ab, aa;
+    bool pointsFiltered = this->m_PointsFiltered && (input->GetPointNumber() != 0);
+    if (pointsFiltered && !DesignButterworth(&pb, &pa, this->m_Order, this->mp_CutoffFrequencies, this->m_BandType, input->GetPointFrequency()))
+    {
+      btkErrorMacro("Impossible to design the filter for the points. Check the cutoff frequencies compared to the point frequency. The points are not filtered.");
+      pointsFiltered = false;
+    }
+    bool analogsFiltered = this->m_AnalogsFiltered && (input->GetAnalogNumber() != 0);
+    if (analogsFiltered && !DesignButterworth(&ab, &aa, this->m_Order, this->mp_CutoffFrequencies, this->m_BandType, input->GetAnalogFrequency()))
+    {
+      btkErrorMacro("Impossible to design the filter for the analog channels. Check the cutoff frequencies compared to the analog frequency. The analog channels are not filtered.");
+      analogsFiltered = false;
+    }
+    
+    PointCollection::Pointer points = input->GetPoints();
+    AnalogCollection::Pointer analogs = input->GetAnalogs();
+    if (!this->m_InPlace)
+    {
+      points = PointCollection::New();
+      analogs = AnalogCollection::New();
+    }
+    
+    // Points
+    std::vector<ButterworthJob> jobs;
+    for (Acquisition::PointIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it)
+    {
+      Point::Pointer point = *it;
+      if (pointsFiltered && IsButterworthLabelSelected(this->m_PointLabels, point->GetLabel()))
+      {
+        if (!this->m_InPlace)
+          point = point->Clone();
+        ButterworthJob job = {point->GetLabel(), point->GetValues().data(), point->GetResiduals().data(), static_cast<int>(point->GetValues().rows()), 3, true};
+        jobs.push_back(job);
+      }
+      if (!this->m_InPlace)
+        points->InsertItem(point);
+    }
+    if (!jobs.empty())
+      FilterButterworthJobs(jobs, pb, pa);
+    
+    // Analog channels
+    jobs.clear();
+    for (Acquisition::AnalogIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
+    {
+      Analog::Pointer analog = *it;
+      if (analogsFiltered && IsButterworthLabelSelected(this->m_AnalogLabels, analog->GetLabel()))
+      {
+        if (!this->m_InPlace)
+          analog = analog->Clone();
+        ButterworthJob job = {analog->GetLabel(), analog->GetValues().data(), 0, static_cast<int>(analog->GetValues().rows()), 1, true};
+        jobs.push_back(job);
+      }
+      if (!this->m_InPlace)
+        analogs->InsertItem(analog);
+    }
+    if (!jobs.empty())
+      FilterButterworthJobs(jobs, ab, aa);
+    
+    output->SetFirstFrame(input->GetFirstFrame());
+    output->SetPointFrequency(input->GetPointFrequency());
+    output->SetAnalogResolution(input->GetAnalogResolution());
+    output->SetPointUnits(input->GetPointUnits());
+    output->SetMaxInterpolationGap(input->GetMaxInterpolationGap());
+    output->SetEvents(input->GetEvents());
+    output->SetMetaData(input->GetMetaData());
+    output->SetPoints(points);
+    output->SetAnalogs(analogs);
+    // To set internal variables
+    output->Resize(input->GetPointNumber(), input->GetPointFrameNumber(), input->GetAnalogNumber(), input->GetNumberAnalogSamplePerFrame());
+  };
+};
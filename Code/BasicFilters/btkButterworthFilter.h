@@ -0,0 +1,106 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkButterworthFilter_h
+#define __btkButterworthFilter_h
+
+#include "btkProcessObject.h"
+#include "btkAcquisition.h"
+
+#include <list>
+#include <string>
+
+namespace btk
+{
+  class ButterworthFilter : public ProcessObject
+  {
+  public:
+    typedef enum {LowPass = 0, HighPass, BandPass, BandStop} BandType;
+    
+    typedef btkSharedPtr<ButterworthFilter> Pointer;
+    typedef btkSharedPtr<const ButterworthFilter> ConstPointer;
+    
+    static Pointer New() {return Pointer(new ButterworthFilter());};
+    
+    // ~ButterworthFilter(); // Implicit
+    
+    Acquisition::Pointer GetInput() {return this->GetInput(0);};
+    void SetInput(Acquisition::Pointer input) {this->SetNthInput(0, input);};
+    Acquisition::Pointer GetOutput() {return this->GetOutput(0);};
+    
+    BandType GetBandType() const {return this->m_BandType;};
+    BTK_BASICFILTERS_EXPORT void SetBandType(BandType type);
+    int GetOrder() const {return this->m_Order;};
+    BTK_BASICFILTERS_EXPORT void SetOrder(int order);
+    const double* GetCutoffFrequencies() const {return this->mp_CutoffFrequencies;};
+    BTK_BASICFILTERS_EXPORT void SetCutoffFrequency(double fc);
+    BTK_BASICFILTERS_EXPORT void SetCutoffFrequencies(double fcLow, double fcHigh);
+    
+    bool GetPointsFiltered() const {return this->m_PointsFiltered;};
+    BTK_BASICFILTERS_EXPORT void SetPointsFiltered(bool enabled);
+    const std::list<std::string>& GetPointLabels() const {return this->m_PointLabels;};
+    BTK_BASICFILTERS_EXPORT void SetPointLabels(const std::list<std::string>& labels);
+    bool GetAnalogsFiltered() const {return this->m_AnalogsFiltered;};
+    BTK_BASICFILTERS_EXPORT void SetAnalogsFiltered(bool enabled);
+    const std::list<std::string>& GetAnalogLabels() const {return this->m_AnalogLabels;};
+    BTK_BASICFILTERS_EXPORT void SetAnalogLabels(const std::list<std::string>& labels);
+    
+    bool GetInPlace() const {return this->m_InPlace;};
+    BTK_BASICFILTERS_EXPORT void SetInPlace(bool enabled);
+    
+  protected:
+    BTK_BASICFILTERS_EXPORT ButterworthFilter();
+    
+    Acquisition::Pointer GetInput(int idx) {return static_pointer_cast<Acquisition>(this->GetNthInput(idx));};
+    Acquisition::Pointer GetOutput(int idx) {return static_pointer_cast<Acquisition>(this->GetNthOutput(idx));};
+    BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
+    BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    
+  private:
+    ButterworthFilter(const ButterworthFilter& ); // Not implemented.
+    ButterworthFilter& operator=(const ButterworthFilter& ); // Not implemented.
+    
+    BandType m_BandType;
+    int m_Order;
+    double mp_CutoffFrequencies[2];
+    bool m_PointsFiltered;
+    std::list<std::string> m_PointLabels;
+    bool m_AnalogsFiltered;
+    std::list<std::string> m_AnalogLabels;
+    bool m_InPlace;
+  };
+};
+
+#endif // __btkButterworthFilter_h
@@ -229,9 +229,10 @@ namespace btk
     output->GetForce()->SetFrameNumber(outFrameNumber);
     output->GetMoment()->SetLabel(input->GetMoment()->GetLabel());
     output->GetMoment()->SetFrameNumber(outFrameNumber);
-    double* inPosition = input->GetPosition()->GetValues().data();
-    double* inForce = input->GetForce()->GetValues().data();
-    double* inMoment = input->GetMoment()->GetValues().data();
+    // Read-only access to the input to not copy the values shared with other objects
+    const double* inPosition = Point::ConstPointer(input->GetPosition())->GetValues().data();
+    const double* inForce = Point::ConstPointer(input->GetForce())->GetValues().data();
+    const double* inMoment = Point::ConstPointer(input->GetMoment())->GetValues().data();
     double* outPosition = output->GetPosition()->GetValues().data();
     double* outForce = output->GetForce()->GetValues().data();
     double* outMoment = output->GetMoment()->GetValues().data();
@@ -0,0 +1,631 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkEMGProcessingFilter.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+  #define M_PI 3.14159265358979323846
+#endif
+
+namespace btk
+{
+  // Second order section (direct form II transposed, a0 = 1).
+  struct EMGBiquad
+  {
+    double b0, b1, b2, a1, a2;
+  };
+  
+  // State of a channel kept between two updates in streaming mode.
+  struct EMGProcessingState
+  {
+    bool initialized;
+    double offset;
+    double peak;
+    std::vector<double> bandPass; // Delay lines (2 per section)
+    std::vector<double> envelope;
+    std::vector<double> window; // Last squared samples for the RMS envelope
+    int windowIndex;
+    int windowCount;
+    double windowSum;
+  };
+  
+  struct EMGProcessingJob
+  {
+    double* values;
+    int rows;
+    EMGProcessingState* state;
+    double reference; // Normalization value (0: none)
+  };
+  
+  // Butterworth filter (bilinear transform) as a cascade of biquads.
+  static bool DesignEMGBiquads(std::vector<EMGBiquad>* sections, int order, double fc, double fs, bool highPass)
+  {
+    if ((fc <= 0.0) || (fc >= fs / 2.0))
+      return false;
+    const double w0 = 2.0 * M_PI * fc / fs;
+    const double cw = std::cos(w0), sw = std::sin(w0);
+    for (int k = 0 ; k < order / 2 ; ++k)
+    {
+      const double q = 1.0 / (2.0 * std::cos(M_PI * (2.0 * k + 1.0) / (2.0 * order)));
+      const double alpha = sw / (2.0 * q), a0 = 1.0 + alpha;
+      EMGBiquad s;
+      s.b0 = (highPass ? (1.0 + cw) : (1.0 - cw)) / (2.0 * a0);
+      s.b1 = (highPass ? -(1.0 + cw) : (1.0 - cw)) / a0;
+      s.b2 = s.b0;
+      s.a1 = -2.0 * cw / a0;
+      s.a2 = (1.0 - alpha) / a0;
+      sections->push_back(s);
+    }
+    if ((order % 2) != 0)
+    {
+      const double K = std::tan(w0 / 2.0);
+      EMGBiquad s;
+      s.b0 = (highPass ? 1.0 : K) / (1.0 + K);
+      s.b1 = highPass ? -s.b0 : s.b0;
+      s.b2 = 0.0;
+      s.a1 = (K - 1.0) / (K + 1.0);
+      s.a2 = 0.0;
+      sections->push_back(s);
+    }
+    return true;
+  };
+  
+  static inline double FilterEMGSample(double x, const std::vector<EMGBiquad>& sections, double* z)
+  {
+    for (size_t i = 0 ; i < sections.size() ; ++i)
+    {
+      const EMGBiquad& s = sections[i];
+      const double y = s.b0 * x + z[0];
+      z[0] = s.b1 * x - s.a1 * y + z[1];
+      z[1] = s.b2 * x - s.a2 * y;
+      x = y;
+      z += 2;
+    }
+    return x;
+  };
+  
+  // Offset removal, band-pass, rectification/RMS and low-pass done in a single pass over the samples.
+  static void ProcessEMGJob(EMGProcessingJob* job, const std::vector<EMGBiquad>& bandPass, const std::vector<EMGBiquad>& envelope, int window, bool offsetRemoval, bool streaming, EMGProcessingFilter::NormalizationMethod normalization)
+  {
+    EMGProcessingState* state = job->state;
+    Eigen::Map< Eigen::Matrix<double, Eigen::Dynamic, 1> > values(job->values, job->rows);
+    if (!state->initialized)
+    {
+      state->offset = (offsetRemoval && (job->rows != 0)) ? values.mean() : 0.0;
+      state->peak = 0.0;
+      state->bandPass.assign(2 * bandPass.size(), 0.0);
+      state->envelope.assign(2 * envelope.size(), 0.0);
+      state->window.assign(window, 0.0);
+      state->windowIndex = 0;
+      state->windowCount = 0;
+      state->windowSum = 0.0;
+      state->initialized = true;
+    }
+    const double offset = state->offset;
+    double* zb = state->bandPass.empty() ? 0 : &(state->bandPass[0]);
+    double* ze = state->envelope.empty() ? 0 : &(state->envelope[0]);
+    double* w = state->window.empty() ? 0 : &(state->window[0]);
+    for (int i = 0 ; i < job->rows ; ++i)
+    {
+      const double x = FilterEMGSample(job->values[i] - offset, bandPass, zb);
+      if (window != 0)
+      {
+        // Running sum of the squared samples
+        const double sq = x * x;
+        state->windowSum += sq - w[state->windowIndex];
+        w[state->windowIndex] = sq;
+        state->windowIndex = (state->windowIndex + 1) % window;
+        if (state->windowCount < window)
+          ++state->windowCount;
+        job->values[i] = std::sqrt(std::max(state->windowSum, 0.0) / state->windowCount);
+      }
+      else
+        job->values[i] = FilterEMGSample(std::fabs(x), envelope, ze);
+    }
+    // Normalization
+    if (normalization == EMGProcessingFilter::PeakNormalization)
+    {
+      if (job->rows != 0)
+        state->peak = std::max(streaming ? state->peak : 0.0, values.maxCoeff());
+      if (state->peak > 0.0)
+        values /= state->peak;
+    }
+    else if ((normalization == EMGProcessingFilter::ReferenceNormalization) && (job->reference != 0.0))
+      values /= job->reference;
+  };
+  
+  static bool IsEMGLabelSelected(const std::list<std::string>& labels, const std::string& label)
+  {
+    return labels.empty() || (std::find(labels.begin(), labels.end(), label) != labels.end());
+  };
+  
+  /**
+   * @class EMGProcessingFilter btkEMGProcessingFilter.h
+   * @brief Computes the envelope of EMG signals stored in the analog channels of an acquisition.
+   *
+   * The following steps are fused in a single pass over the samples of each channel:
+   *  -# offset removal (mean of the channel, see SetOffsetRemoval());
+   *  -# Butterworth band-pass filter (high-pass and low-pass filters of the order given by SetBandPassOrder(), 20-450 Hz by default);
+   *  -# envelope computed with a full-wave rectification followed by a Butterworth low-pass filter (6 Hz, order 2 by default) 
+   *     or with a moving RMS window (see SetEnvelopeMethod());
+   *  -# normalization by the peak of the envelope or by a reference value given for each channel (e.g. maximum voluntary contraction).
+   *
+   * The filters are causal and implemented as cascades of biquads. The moving RMS window is updated with a running sum.
+   * Contrary to the ButterworthFilter, the envelope has then a phase lag but the results can be computed sample by sample.
+   * The channels are processed in parallel when OpenMP is enabled.
+   *
+   * By default, only the analog channels given by SetLabels() are processed (all of them if the list is empty).
+   * The other analog channels are copied in the output without modification.
+   *
+   * In streaming mode (see SetStreaming()), each input is considered as the next block of samples of the 
+   * same signals: the states of the filters, the RMS window, the offset (computed on the first block) and the peak 
+   * (computed since the first block) are kept between the updates. The concatenation of the outputs is 
+   * then the same than the output of the whole signal (except for the offset and the peak normalization).
+   * The states are associated with the index of the channels (the channels can share the same label), 
+   * so the blocks must keep the same channels in the same order.
+   * Use ResetStreaming() to start a new stream. Modifying a parameter also resets the stream.
+   *
+   * @ingroup BTKBasicFilters
+   */
+  /**
+   * @var EMGProcessingFilter::EnvelopeMethod EMGProcessingFilter::LowPassEnvelope
+   * Full-wave rectification followed by a Butterworth low-pass filter.
+   */
+  /**
+   * @var EMGProcessingFilter::EnvelopeMethod EMGProcessingFilter::RMSEnvelope
+   * Moving RMS window.
+   */
+  /**
+   * @var EMGProcessingFilter::NormalizationMethod EMGProcessingFilter::NoNormalization
+   * The envelope is not normalized.
+   */
+  /**
+   * @var EMGProcessingFilter::NormalizationMethod EMGProcessingFilter::PeakNormalization
+   * The envelope is divided by its maximum.
+   */
+  /**
+   * @var EMGProcessingFilter::NormalizationMethod EMGProcessingFilter::ReferenceNormalization
+   * The envelope is divided by the reference given for its channel (see SetNormalizationReference()).
+   */
+  
+  /**
+   * @typedef EMGProcessingFilter::Pointer
+   * Smart pointer associated with a EMGProcessingFilter object.
+   */
+  
+  /**
+   * @typedef EMGProcessingFilter::ConstPointer
+   * Smart pointer associated with a const EMGProcessingFilter object.
+   */
+  
+  /**
+   * @fn static Pointer EMGProcessingFilter::New();
+   * Creates a smart pointer associated with a EMGProcessingFilter object.
+   */
+  
+  /**
+   * @fn Acquisition::Pointer EMGProcessingFilter::GetInput()
+   * Gets the input registered with this process.
+   */
+
+  /**
+   * @fn void EMGProcessingFilter::SetInput(Acquisition::Pointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn Acquisition::Pointer EMGProcessingFilter::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * @fn const std::list<std::string>& EMGProcessingFilter::GetLabels() const
+   * Returns the labels of the analog channels to process. An empty list means all the analog channels.
+   */
+  
+  /**
+   * Sets the labels of the analog channels to process. An empty list (default) means all the analog channels.
+   */
+  void EMGProcessingFilter::SetLabels(const std::list<std::string>& labels)
+  {
+    if (this->m_Labels == labels)
+      return;
+    this->m_Labels = labels;
+    this->Modified();
+  };
+  
+  /**
+   * @fn bool EMGProcessingFilter::GetOffsetRemoval() const
+   * Returns the state of the offset removal.
+   */
+  
+  /**
+   * Enables or disables the removal of the mean of each channel before the band-pass filter (enabled by default).
+   */
+  void EMGProcessingFilter::SetOffsetRemoval(bool enabled)
+  {
+    if (this->m_OffsetRemoval == enabled)
+      return;
+    this->m_OffsetRemoval = enabled;
+    this->ResetStreaming();
+    this->Modified();
+  };
+  
+  /**
+   * @fn const double* EMGProcessingFilter::GetBandPassFrequencies() const
+   * Returns the cutoff frequencies of the band-pass filter.
+   */
+  
+  /**
+   * Sets the cutoff frequencies of the band-pass filter (20 and 450 Hz by default). 
+   * A frequency equal to 0 disables the corresponding filter (high-pass for @a fcLow, low-pass for @a fcHigh).
+   */
+  void EMGProcessingFilter::SetBandPassFrequencies(double fcLow, double fcHigh)
+  {
+    if ((fcLow < 0.0) || (fcHigh < 0.0) || ((fcHigh != 0.0) && (fcLow >= fcHigh)))
+    {
+      btkErrorMacro("Invalid cutoff frequencies for the band-pass filter.");
+      return;
+    }
+    if ((this->mp_BandPassFrequencies[0] == fcLow) && (this->mp_BandPassFrequencies[1] == fcHigh))
+      return;
+    this->mp_BandPassFrequencies[0] = fcLow;
+    this->mp_BandPassFrequencies[1] = fcHigh;
+    this->ResetStreaming();
+    this->Modified();
+  };
+  
+  /**
+   * @fn int EMGProcessingFilter::GetBandPassOrder() const
+   * Returns the order of the high-pass and low-pass filters composing the band-pass filter.
+   */
+  
+  /**
+   * Sets the order of the high-pass and low-pass filters composing the band-pass filter (2 by default).
+   */
+  void EMGProcessingFilter::SetBandPassOrder(int order)
+  {
+    if (order <= 0)
+    {
+      btkErrorMacro("The order must be strictly positive.");
+      return;
+    }
+    if (this->m_BandPassOrder == order)
+      return;
+    this->m_BandPassOrder = order;
+    this->ResetStreaming();
+    this->Modified();
+  };
+  
+  /**
+   * @fn EnvelopeMethod EMGProcessingFilter::GetEnvelopeMethod() const
+   * Returns the method used to compute the envelope.
+   */
+  
+  /**
+   * Sets the method used to compute the envelope (LowPassEnvelope by default).
+   */
+  void EMGProcessingFilter::SetEnvelopeMethod(EnvelopeMethod method)
+  {
+    if (this->m_EnvelopeMethod == method)
+      return;
+    this->m_EnvelopeMethod = method;
+    this->ResetStreaming();
+    this->Modified();
+  };
+  
+  /**
+   * @fn double EMGProcessingFilter::GetEnvelopeFrequency() const
+   * Returns the cutoff frequency of the low-pass filter used to compute the envelope.
+   */
+  
+  /**
+   * Sets the cutoff frequency of the low-pass filter used to compute the envelope (6 Hz by default).
+   */
+  void EMGProcessingFilter::SetEnvelopeFrequency(double fc)
+  {
+    if (fc <= 0.0)
+    {
+      btkErrorMacro("The cutoff frequency must be strictly positive.");
+      return;
+    }
+    if (this->m_EnvelopeFrequency == fc)
+      return;
+    this->m_EnvelopeFrequency = fc;
+    this->ResetStreaming();
+    this->Modified();
+  };
+  
+  /**
+   * @fn int EMGProcessingFilter::GetEnvelopeOrder() const
+   * Returns the order of the low-pass filter used to compute the envelope.
+   */
+  
+  /**
+   * Sets the order of the low-pass filter used to compute the envelope (2 by default).
+   */
+  void EMGProcessingFilter::SetEnvelopeOrder(int order)
+  {
+    if (order <= 0)
+    {
+      btkErrorMacro("The order must be strictly positive.");
+      return;
+    }
+    if (this->m_EnvelopeOrder == order)
+      return;
+    this->m_EnvelopeOrder = order;
+    this->ResetStreaming();
+    this->Modified();
+  };
+  
+  /**
+   * @fn double EMGProcessingFilter::GetRMSWindow() const
+   * Returns the duration (in seconds) of the moving RMS window.
+   */
+  
+  /**
+   * Sets the duration (in seconds) of the moving RMS window (0.05 s by default).
+   */
+  void EMGProcessingFilter::SetRMSWindow(double duration)
+  {
+    if (duration <= 0.0)
+    {
+      btkErrorMacro("The duration of the RMS window must be strictly positive.");
+      return;
+    }
+    if (this->m_RMSWindow == duration)
+      return;
+    this->m_RMSWindow = duration;
+    this->ResetStreaming();
+    this->Modified();
+  };
+  
+  /**
+   * @fn NormalizationMethod EMGProcessingFilter::GetNormalizationMethod() const
+   * Returns the method used to normalize the envelopes.
+   */
+  
+  /**
+   * Sets the method used to normalize the envelopes (NoNormalization by default).
+   */
+  void EMGProcessingFilter::SetNormalizationMethod(NormalizationMethod method)
+  {
+    if (this->m_NormalizationMethod == method)
+      return;
+    this->m_NormalizationMethod = method;
+    this->ResetStreaming();
+    this->Modified();
+  };
+  
+  /**
+   * Returns the reference value used to normalize the envelope of the channel @a label (0 if not set).
+   */
+  double EMGProcessingFilter::GetNormalizationReference(const std::string& label) const
+  {
+    std::map<std::string, double>::const_iterator it = this->m_NormalizationReferences.find(label);
+    return (it != this->m_NormalizationReferences.end()) ? it->second : 0.0;
+  };
+  
+  /**
+   * Sets the reference value used to normalize the envelope of the channel @a label. 
+   * The envelope of a channel without reference is not normalized.
+   */
+  void EMGProcessingFilter::SetNormalizationReference(const std::string& label, double value)
+  {
+    if (value <= 0.0)
+    {
+      btkErrorMacro("The normalization reference must be strictly positive.");
+      return;
+    }
+    std::map<std::string, double>::iterator it = this->m_NormalizationReferences.find(label);
+    if ((it != this->m_NormalizationReferences.end()) && (it->second == value))
+      return;
+    this->m_NormalizationReferences[label] = value;
+    this->Modified();
+  };
+  
+  /**
+   * Removes all the normalization references.
+   */
+  void EMGProcessingFilter::ClearNormalizationReferences()
+  {
+    if (this->m_NormalizationReferences.empty())
+      return;
+    this->m_NormalizationReferences.clear();
+    this->Modified();
+  };
+  
+  /**
+   * @fn bool EMGProcessingFilter::GetStreaming() const
+   * Returns the state of the streaming mode.
+   */
+  
+  /**
+   * Enables or disables the streaming mode (disabled by default).
+   */
+  void EMGProcessingFilter::SetStreaming(bool enabled)
+  {
+    if (this->m_Streaming == enabled)
+      return;
+    this->m_Streaming = enabled;
+    this->ResetStreaming();
+    this->Modified();
+  };
+  
+  /**
+   * Resets the states of the filters kept between two updates in streaming mode.
+   * The next input will be considered as the first block of a new stream.
+   */
+  void EMGProcessingFilter::ResetStreaming()
+  {
+    this->m_States.clear();
+  };
+  
+  /**
+   * @fn bool EMGProcessingFilter::GetInPlace() const
+   * Returns the state of the in-place mode.
+   */
+  
+  /**
+   * Enables or disables the in-place mode (disabled by default). 
+   * When enabled, the analog channels of the input are directly processed instead of being cloned.
+   */
+  void EMGProcessingFilter::SetInPlace(bool enabled)
+  {
+    if (this->m_InPlace == enabled)
+      return;
+    this->m_InPlace = enabled;
+    this->Modified();
+  };
+  
+  /**
+   * Constructor. 
+   * Sets the number of inputs and outputs to 1.
+   */
+  EMGProcessingFilter::EMGProcessingFilter()
+  : ProcessObject(), m_Labels(), m_NormalizationReferences(), m_States()
+  {
+    this->m_OffsetRemoval = true;
+    this->mp_BandPassFrequencies[0] = 20.0;
+    this->mp_BandPassFrequencies[1] = 450.0;
+    this->m_BandPassOrder = 2;
+    this->m_EnvelopeMethod = LowPassEnvelope;
+    this->m_EnvelopeFrequency = 6.0;
+    this->m_EnvelopeOrder = 2;
+    this->m_RMSWindow = 0.05;
+    this->m_NormalizationMethod = NoNormalization;
+    this->m_Streaming = false;
+    this->m_InPlace = false;
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+  };
+  
+  /**
+   * @fn Acquisition::Pointer EMGProcessingFilter::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn Acquisition::Pointer EMGProcessingFilter::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates an Acquisition:Pointer object and return it as a DataObject::Pointer.
+   */
+  DataObject::Pointer EMGProcessingFilter::MakeOutput(int /* idx */)
+  {
+    return Acquisition::New();
+  };
+  
+  /**
+   * Generates the outputs' data.
+   */
+  void EMGProcessingFilter::GenerateData()
+  {
+    Acquisition::Pointer output = this->GetOutput();
+    output->Reset();
+    
+    Acquisition::Pointer input = this->GetInput();
+    if (!input)
+      return;
+    
+    // Filters
+    const double fs = input->GetAnalogFrequency();
+    std::vector<EMGBiquad> bandPass, envelope;
+    if (((this->mp_BandPassFrequencies[0] != 0.0) && !DesignEMGBiquads(&bandPass, this->m_BandPassOrder, this->mp_BandPassFrequencies[0], fs, true))
+        || ((this->mp_BandPassFrequencies[1] != 0.0) && !DesignEMGBiquads(&bandPass, this->m_BandPassOrder, this->mp_BandPassFrequencies[1], fs, false)))
+    {
+      btkErrorMacro("Impossible to design the band-pass filter. Check the cutoff frequencies compared to the analog frequency.");
+      return;
+    }
+    int window = 0;
+    if (this->m_EnvelopeMethod == RMSEnvelope)
+      window = std::max(1, static_cast<int>(this->m_RMSWindow * fs + 0.5));
+    else if (!DesignEMGBiquads(&envelope, this->m_EnvelopeOrder, this->m_EnvelopeFrequency, fs, false))
+    {
+      btkErrorMacro("Impossible to design the low-pass filter of the envelope. Check the cutoff frequency compared to the analog frequency.");
+      return;
+    }
+    if (!this->m_Streaming)
+      this->m_States.clear();
+    this->m_States.resize(input->GetAnalogNumber());
+    
+    // Channels
+    AnalogCollection::Pointer analogs = this->m_InPlace ? input->GetAnalogs() : AnalogCollection::New();
+    std::vector<EMGProcessingJob> jobs;
+    int idx = 0;
+    for (Acquisition::AnalogIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it, ++idx)
+    {
+      Analog::Pointer analog = *it;
+      if (IsEMGLabelSelected(this->m_Labels, analog->GetLabel()))
+      {
+        if (!this->m_InPlace)
+          analog = analog->Clone();
+        btkSharedPtr<EMGProcessingState>& state = this->m_States[idx];
+        if (!state)
+        {
+          state = btkSharedPtr<EMGProcessingState>(new EMGProcessingState);
+          state->initialized = false;
+        }
+        EMGProcessingJob job = {analog->GetValues().data(), static_cast<int>(analog->GetValues().rows()), state.get(), this->GetNormalizationReference(analog->GetLabel())};
+        jobs.push_back(job);
+      }
+      if (!this->m_InPlace)
+        analogs->InsertItem(analog);
+    }
+    const int num = static_cast<int>(jobs.size());
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0 ; i < num ; ++i)
+      ProcessEMGJob(&(jobs[i]), bandPass, envelope, window, this->m_OffsetRemoval, this->m_Streaming, this->m_NormalizationMethod);
+    
+    output->SetFirstFrame(input->GetFirstFrame());
+    output->SetPointFrequency(input->GetPointFrequency());
+    output->SetAnalogResolution(input->GetAnalogResolution());
+    output->SetPointUnits(input->GetPointUnits());
+    output->SetMaxInterpolationGap(input->GetMaxInterpolationGap());
+    output->SetEvents(input->GetEvents());
+    output->SetMetaData(input->GetMetaData());
+    output->SetPoints(input->GetPoints());
+    output->SetAnalogs(analogs);
+    // To set internal variables
+    output->Resize(input->GetPointNumber(), input->GetPointFrameNumber(), input->GetAnalogNumber(), input->GetNumberAnalogSamplePerFrame());
+  };
+};
@@ -0,0 +1,128 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkEMGProcessingFilter_h
+#define __btkEMGProcessingFilter_h
+
+#include "btkProcessObject.h"
+#include "btkAcquisition.h"
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace btk
+{
+  struct EMGProcessingState;
+  
+  class EMGProcessingFilter : public ProcessObject
+  {
+  public:
+    typedef enum {LowPassEnvelope = 0, RMSEnvelope} EnvelopeMethod;
+    typedef enum {NoNormalization = 0, PeakNormalization, ReferenceNormalization} NormalizationMethod;
+    
+    typedef btkSharedPtr<EMGProcessingFilter> Pointer;
+    typedef btkSharedPtr<const EMGProcessingFilter> ConstPointer;
+    
+    static Pointer New() {return Pointer(new EMGProcessingFilter());};
+    
+    // ~EMGProcessingFilter(); // Implicit
+    
+    Acquisition::Pointer GetInput() {return this->GetInput(0);};
+    void SetInput(Acquisition::Pointer input) {this->SetNthInput(0, input);};
+    Acquisition::Pointer GetOutput() {return this->GetOutput(0);};
+    
+    const std::list<std::string>& GetLabels() const {return this->m_Labels;};
+    BTK_BASICFILTERS_EXPORT void SetLabels(const std::list<std::string>& labels);
+    
+    bool GetOffsetRemoval() const {return this->m_OffsetRemoval;};
+    BTK_BASICFILTERS_EXPORT void SetOffsetRemoval(bool enabled);
+    const double* GetBandPassFrequencies() const {return this->mp_BandPassFrequencies;};
+    BTK_BASICFILTERS_EXPORT void SetBandPassFrequencies(double fcLow, double fcHigh);
+    int GetBandPassOrder() const {return this->m_BandPassOrder;};
+    BTK_BASICFILTERS_EXPORT void SetBandPassOrder(int order);
+    
+    EnvelopeMethod GetEnvelopeMethod() const {return this->m_EnvelopeMethod;};
+    BTK_BASICFILTERS_EXPORT void SetEnvelopeMethod(EnvelopeMethod method);
+    double GetEnvelopeFrequency() const {return this->m_EnvelopeFrequency;};
+    BTK_BASICFILTERS_EXPORT void SetEnvelopeFrequency(double fc);
+    int GetEnvelopeOrder() const {return this->m_EnvelopeOrder;};
+    BTK_BASICFILTERS_EXPORT void SetEnvelopeOrder(int order);
+    double GetRMSWindow() const {return this->m_RMSWindow;};
+    BTK_BASICFILTERS_EXPORT void SetRMSWindow(double duration);
+    
+    NormalizationMethod GetNormalizationMethod() const {return this->m_NormalizationMethod;};
+    BTK_BASICFILTERS_EXPORT void SetNormalizationMethod(NormalizationMethod method);
+    BTK_BASICFILTERS_EXPORT double GetNormalizationReference(const std::string& label) const;
+    BTK_BASICFILTERS_EXPORT void SetNormalizationReference(const std::string& label, double value);
+    BTK_BASICFILTERS_EXPORT void ClearNormalizationReferences();
+    
+    bool GetStreaming() const {return this->m_Streaming;};
+    BTK_BASICFILTERS_EXPORT void SetStreaming(bool enabled);
+    BTK_BASICFILTERS_EXPORT void ResetStreaming();
+    
+    bool GetInPlace() const {return this->m_InPlace;};
+    BTK_BASICFILTERS_EXPORT void SetInPlace(bool enabled);
+    
+  protected:
+    BTK_BASICFILTERS_EXPORT EMGProcessingFilter();
+    
+    Acquisition::Pointer GetInput(int idx) {return static_pointer_cast<Acquisition>(this->GetNthInput(idx));};
+    Acquisition::Pointer GetOutput(int idx) {return static_pointer_cast<Acquisition>(this->GetNthOutput(idx));};
+    BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
+    BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    
+  private:
+    EMGProcessingFilter(const EMGProcessingFilter& ); // Not implemented.
+    EMGProcessingFilter& operator=(const EMGProcessingFilter& ); // Not implemented.
+    
+    std::list<std::string> m_Labels;
+    bool m_OffsetRemoval;
+    double mp_BandPassFrequencies[2];
+    int m_BandPassOrder;
+    EnvelopeMethod m_EnvelopeMethod;
+    double m_EnvelopeFrequency;
+    int m_EnvelopeOrder;
+    double m_RMSWindow;
+    NormalizationMethod m_NormalizationMethod;
+    std::map<std::string, double> m_NormalizationReferences;
+    bool m_Streaming;
+    std::vector< btkSharedPtr<EMGProcessingState> > m_States;
+    bool m_InPlace;
+  };
+};
+
+#endif // __btkEMGProcessingFilter_h
@@ -38,6 +38,13 @@
 
 namespace btk
 {
+  // Read-only access to the values of a channel, to not copy the values shared with other objects.
+  static const Analog::Values& ForcePlatformWrenchChannel(ForcePlatform::Pointer fp, int idx)
+  {
+    Analog::ConstPointer channel = fp->GetChannel(idx);
+    return channel->GetValues();
+  };
+  
   /**
    * @class ForcePlatformWrenchFilter btkForcePlatformWrenchFilter.h
    * @brief Calcule the wrench of the center of the force platform data, expressed in the global frame (by default).
@@ -171,41 +178,41 @@ namespace btk
         {
           // 6 channels
           case 1:
-            wrh->GetForce()->GetValues().col(0) = (*it)->GetChannel(0)->GetValues();
-            wrh->GetForce()->GetValues().col(1) = (*it)->GetChannel(1)->GetValues();
-            wrh->GetForce()->GetValues().col(2) = (*it)->GetChannel(2)->GetValues();
-            wrh->GetPosition()->GetValues().col(0) = (*it)->GetChannel(3)->GetValues();
-            wrh->GetPosition()->GetValues().col(1) = (*it)->GetChannel(4)->GetValues();
+            wrh->GetForce()->GetValues().col(0) = ForcePlatformWrenchChannel(*it, 0);
+            wrh->GetForce()->GetValues().col(1) = ForcePlatformWrenchChannel(*it, 1);
+            wrh->GetForce()->GetValues().col(2) = ForcePlatformWrenchChannel(*it, 2);
+            wrh->GetPosition()->GetValues().col(0) = ForcePlatformWrenchChannel(*it, 3);
+            wrh->GetPosition()->GetValues().col(1) = ForcePlatformWrenchChannel(*it, 4);
             wrh->GetPosition()->GetValues().col(2).setZero();
             wrh->GetMoment()->GetValues().col(0).setZero();
             wrh->GetMoment()->GetValues().col(1).setZero();
-            wrh->GetMoment()->GetValues().col(2) = (*it)->GetChannel(5)->GetValues();
+            wrh->GetMoment()->GetValues().col(2) = ForcePlatformWrenchChannel(*it, 5);
             this->FinishTypeI(wrh, *it, inc);
             break;
           case 2:
           case 4:
           case 5:
-            wrh->GetForce()->GetValues().col(0) = (*it)->GetChannel(0)->GetValues();
-            wrh->GetForce()->GetValues().col(1) = (*it)->GetChannel(1)->GetValues();
-            wrh->GetForce()->GetValues().col(2) = (*it)->GetChannel(2)->GetValues();
-            wrh->GetMoment()->GetValues().col(0) = (*it)->GetChannel(3)->GetValues();
-            wrh->GetMoment()->GetValues().col(1) = (*it)->GetChannel(4)->GetValues();
-            wrh->GetMoment()->GetValues().col(2) = (*it)->GetChannel(5)->GetValues();
+            wrh->GetForce()->GetValues().col(0) = ForcePlatformWrenchChannel(*it, 0);
+            wrh->GetForce()->GetValues().col(1) = ForcePlatformWrenchChannel(*it, 1);
+            wrh->GetForce()->GetValues().col(2) = ForcePlatformWrenchChannel(*it, 2);
+            wrh->GetMoment()->GetValues().col(0) = ForcePlatformWrenchChannel(*it, 3);
+            wrh->GetMoment()->GetValues().col(1) = ForcePlatformWrenchChannel(*it, 4);
+            wrh->GetMoment()->GetValues().col(2) = ForcePlatformWrenchChannel(*it, 5);
             this->FinishAMTI(wrh, *it, inc);
             break;
           case 3:
             // Fx
-            wrh->GetForce()->GetValues().col(0) = (*it)->GetChannel(0)->GetValues() + (*it)->GetChannel(1)->GetValues();
+            wrh->GetForce()->GetValues().col(0) = ForcePlatformWrenchChannel(*it, 0) + ForcePlatformWrenchChannel(*it, 1);
             // Fy
-            wrh->GetForce()->GetValues().col(1) = (*it)->GetChannel(2)->GetValues() + (*it)->GetChannel(3)->GetValues();
+            wrh->GetForce()->GetValues().col(1) = ForcePlatformWrenchChannel(*it, 2) + ForcePlatformWrenchChannel(*it, 3);
             // Fz
-            wrh->GetForce()->GetValues().col(2) = (*it)->GetChannel(4)->GetValues() + (*it)->GetChannel(5)->GetValues() + (*it)->GetChannel(6)->GetValues() + (*it)->GetChannel(7)->GetValues();
+            wrh->GetForce()->GetValues().col(2) = ForcePlatformWrenchChannel(*it, 4) + ForcePlatformWrenchChannel(*it, 5) + ForcePlatformWrenchChannel(*it, 6) + ForcePlatformWrenchChannel(*it, 7);
             // Mx
-            wrh->GetMoment()->GetValues().col(0) = (*it)->GetOrigin().y() * ((*it)->GetChannel(4)->GetValues() + (*it)->GetChannel(5)->GetValues() - (*it)->GetChannel(6)->GetValues() - (*it)->GetChannel(7)->GetValues());
+            wrh->GetMoment()->GetValues().col(0) = (*it)->GetOrigin().y() * (ForcePlatformWrenchChannel(*it, 4) + ForcePlatformWrenchChannel(*it, 5) - ForcePlatformWrenchChannel(*it, 6) - ForcePlatformWrenchChannel(*it, 7));
             // My
-            wrh->GetMoment()->GetValues().col(1) = (*it)->GetOrigin().x() * ((*it)->GetChannel(5)->GetValues() + (*it)->GetChannel(6)->GetValues() - (*it)->GetChannel(4)->GetValues() - (*it)->GetChannel(7)->GetValues());
+            wrh->GetMoment()->GetValues().col(1) = (*it)->GetOrigin().x() * (ForcePlatformWrenchChannel(*it, 5) + ForcePlatformWrenchChannel(*it, 6) - ForcePlatformWrenchChannel(*it, 4) - ForcePlatformWrenchChannel(*it, 7));
             // Mz
-            wrh->GetMoment()->GetValues().col(2) = (*it)->GetOrigin().y() * ((*it)->GetChannel(1)->GetValues() - (*it)->GetChannel(0)->GetValues()) + (*it)->GetOrigin().x() * ((*it)->GetChannel(2)->GetValues() - (*it)->GetChannel(3)->GetValues());
+            wrh->GetMoment()->GetValues().col(2) = (*it)->GetOrigin().y() * (ForcePlatformWrenchChannel(*it, 1) - ForcePlatformWrenchChannel(*it, 0)) + (*it)->GetOrigin().x() * (ForcePlatformWrenchChannel(*it, 2) - ForcePlatformWrenchChannel(*it, 3));
             this->FinishKistler(wrh, *it, inc);
             break;
           case 6:
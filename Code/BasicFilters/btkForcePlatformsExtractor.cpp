@@ -413,7 +413,7 @@ namespace btk
       for (int i = 0 ; i < numberOfChannelToExtract ; ++i)
       {
         Analog::Pointer channel = Analog::New();
-        Analog::Pointer channelToCopy = channels->GetItem(channelsIndex[i + alreadyExtracted] - 1);
+        Analog::ConstPointer channelToCopy = channels->GetItem(channelsIndex[i + alreadyExtracted] - 1); // Read-only access to not copy the shared values
         channel->SetLabel(channelToCopy->GetLabel());
         channel->SetDescription(channelToCopy->GetDescription());
         fp->SetChannel(i, channel);
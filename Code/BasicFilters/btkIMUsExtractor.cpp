@@ -275,7 +275,7 @@ namespace btk
       if ((index >= 1) && (index <= numberOfChannels))
       {
         Analog::Pointer channel = Analog::New();
-        Analog::Pointer channelToCopy = channels->GetItem(index - 1);
+        Analog::ConstPointer channelToCopy = channels->GetItem(index - 1); // Read-only access to not copy the shared values
         channel->SetLabel(channelToCopy->GetLabel());
         channel->SetDescription(channelToCopy->GetDescription());
         channel->SetUnit(channelToCopy->GetUnit());
@@ -0,0 +1,646 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkInverseDynamicsFilter.h"
+
+#include <algorithm>
+#include <map>
+
+namespace btk
+{
+  typedef Eigen::Matrix<double, Eigen::Dynamic, 3> InverseDynamicsSeries;
+  
+  // Components of an external wrench, only read by the jobs.
+  struct InverseDynamicsWrench
+  {
+    Point::ConstPointer position;
+    Point::ConstPointer force;
+    Point::ConstPointer moment;
+  };
+  
+  struct InverseDynamicsJob
+  {
+    const InverseDynamicsFilter::Segment* segment;
+    Point::ConstPointer frame[4]; // Origin and 3 axes
+    Point::ConstPointer center; // Null for the origin of the segment
+    std::vector<InverseDynamicsWrench> wrenches;
+    int parent;
+    std::vector<int> children;
+    int height; // Longest path to a terminal segment
+    // Kinematics (global frame)
+    InverseDynamicsSeries axes[3];
+    InverseDynamicsSeries com;
+    InverseDynamicsSeries jointCenter;
+    InverseDynamicsSeries omega;
+    InverseDynamicsSeries alpha;
+    InverseDynamicsSeries acceleration;
+    std::vector<char> valid;
+    // Loads applied by the proximal segment at the joint center (global frame)
+    InverseDynamicsSeries force;
+    InverseDynamicsSeries moment;
+  };
+  
+  static InverseDynamicsSeries InverseDynamicsCross(const InverseDynamicsSeries& a, const InverseDynamicsSeries& b)
+  {
+    InverseDynamicsSeries c(a.rows(), 3);
+    c.col(0) = a.col(1).cwiseProduct(b.col(2)) - a.col(2).cwiseProduct(b.col(1));
+    c.col(1) = a.col(2).cwiseProduct(b.col(0)) - a.col(0).cwiseProduct(b.col(2));
+    c.col(2) = a.col(0).cwiseProduct(b.col(1)) - a.col(1).cwiseProduct(b.col(0));
+    return c;
+  };
+  
+  // Coordinates of the vectors v in the frame defined by the axes.
+  static InverseDynamicsSeries InverseDynamicsToLocal(const InverseDynamicsSeries* axes, const InverseDynamicsSeries& v)
+  {
+    InverseDynamicsSeries l(v.rows(), 3);
+    for (int i = 0 ; i < 3 ; ++i)
+      l.col(i) = axes[i].cwiseProduct(v).rowwise().sum();
+    return l;
+  };
+  
+  static InverseDynamicsSeries InverseDynamicsToGlobal(const InverseDynamicsSeries* axes, const InverseDynamicsSeries& l)
+  {
+    InverseDynamicsSeries v = InverseDynamicsSeries::Zero(l.rows(), 3);
+    for (int i = 0 ; i < 3 ; ++i)
+      v.array() += axes[i].array().colwise() * l.col(i).array();
+    return v;
+  };
+  
+  // First derivative: central differences, one-sided differences at the boundaries.
+  static InverseDynamicsSeries InverseDynamicsDerivative(const InverseDynamicsSeries& x, double freq)
+  {
+    const int n = static_cast<int>(x.rows());
+    InverseDynamicsSeries d = InverseDynamicsSeries::Zero(n, 3);
+    if (n < 2)
+      return d;
+    if (n > 2)
+      d.block(1,0,n-2,3) = (x.block(2,0,n-2,3) - x.block(0,0,n-2,3)) * (0.5 * freq);
+    d.row(0) = (x.row(1) - x.row(0)) * freq;
+    d.row(n-1) = (x.row(n-1) - x.row(n-2)) * freq;
+    return d;
+  };
+  
+  static void ComputeInverseDynamicsKinematics(InverseDynamicsJob* job, double freq)
+  {
+    const int n = job->frame[0]->GetFrameNumber();
+    const Point::Values& origin = job->frame[0]->GetValues();
+    InverseDynamicsSeries da[3];
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      job->axes[i] = job->frame[i+1]->GetValues() - origin;
+      const Eigen::Array<double, Eigen::Dynamic, 1> norm = job->axes[i].rowwise().norm().array();
+      for (int j = 0 ; j < 3 ; ++j)
+        job->axes[i].col(j).array() /= (norm > 0.0).select(norm, 1.0);
+      da[i] = InverseDynamicsDerivative(job->axes[i], freq);
+    }
+    job->com = origin + InverseDynamicsToGlobal(job->axes, InverseDynamicsSeries(job->segment->CenterOfMass.transpose().replicate(n, 1)));
+    job->jointCenter = job->center ? job->center->GetValues() : origin;
+    // Angular velocity: w = 1/2 * sum(e_i x de_i/dt)
+    job->omega = 0.5 * (InverseDynamicsCross(job->axes[0], da[0]) + InverseDynamicsCross(job->axes[1], da[1]) + InverseDynamicsCross(job->axes[2], da[2]));
+    job->alpha = InverseDynamicsDerivative(job->omega, freq);
+    job->acceleration = InverseDynamicsDerivative(InverseDynamicsDerivative(job->com, freq), freq);
+    // Valid frames: all the points visible in the window used by the second derivatives
+    OcclusionMask visible(n);
+    for (int i = 0 ; i < 5 ; ++i)
+    {
+      Point::ConstPointer p = (i < 4) ? job->frame[i] : job->center;
+      if (p)
+        visible &= p->GetOcclusionMask();
+    }
+    job->valid.assign(n, 1);
+    const std::vector<OcclusionMask::Range>& gaps = visible.GetGaps();
+    for (std::vector<OcclusionMask::Range>::const_iterator it = gaps.begin() ; it != gaps.end() ; ++it)
+      std::fill(job->valid.begin() + std::max(0, it->start - 2), job->valid.begin() + std::min(n, it->start + it->length + 2), 0);
+  };
+  
+  // Newton-Euler equations of the segment. The loads of the distal segments must be already computed.
+  static void ComputeInverseDynamicsLoads(InverseDynamicsJob* job, const std::vector<InverseDynamicsJob>& jobs, const Eigen::Matrix<double, 3, 1>& gravity, double scale)
+  {
+    const int n = static_cast<int>(job->com.rows());
+    const InverseDynamicsFilter::Segment* segment = job->segment;
+    // Inertial terms
+    job->force = segment->Mass * (job->acceleration * scale - InverseDynamicsSeries(gravity.transpose().replicate(n, 1)));
+    const InverseDynamicsSeries omegaL = InverseDynamicsToLocal(job->axes, job->omega);
+    const InverseDynamicsSeries alphaL = InverseDynamicsToLocal(job->axes, job->alpha);
+    const InverseDynamicsSeries momentumL = omegaL * segment->Inertia.transpose();
+    job->moment = InverseDynamicsToGlobal(job->axes, InverseDynamicsSeries(alphaL * segment->Inertia.transpose() + InverseDynamicsCross(omegaL, momentumL))) / scale;
+    // Loads transmitted by the distal segments
+    for (size_t i = 0 ; i < job->children.size() ; ++i)
+    {
+      const InverseDynamicsJob& child = jobs[job->children[i]];
+      job->force += child.force;
+      job->moment += child.moment + InverseDynamicsCross(InverseDynamicsSeries(child.jointCenter - job->com), child.force);
+      for (int f = 0 ; f < n ; ++f)
+        job->valid[f] &= child.valid[f];
+    }
+    // External wrenches
+    for (size_t i = 0 ; i < job->wrenches.size() ; ++i)
+    {
+      const InverseDynamicsWrench& wrench = job->wrenches[i];
+      const int step = wrench.force->GetFrameNumber() / n;
+      InverseDynamicsSeries position(n, 3), force(n, 3), moment(n, 3);
+      for (int f = 0 ; f < n ; ++f)
+      {
+        position.row(f) = wrench.position->GetValues().row(f * step);
+        force.row(f) = wrench.force->GetValues().row(f * step);
+        moment.row(f) = wrench.moment->GetValues().row(f * step);
+      }
+      job->force -= force;
+      job->moment -= moment + InverseDynamicsCross(InverseDynamicsSeries(position - job->com), force);
+    }
+    job->moment -= InverseDynamicsCross(InverseDynamicsSeries(job->jointCenter - job->com), job->force);
+  };
+  
+  /**
+   * @class InverseDynamicsFilter btkInverseDynamicsFilter.h
+   * @brief Computes the joint forces, moments and powers with a bottom-up Newton-Euler approach.
+   *
+   * The segments are given as virtual reference frames in the first input (see RigidBodyPoseFilter): 
+   * a segment labeled "RTI" corresponds to the points RTIO (origin), RTIA (first axis), RTIL (second axis) and RTIP (third axis).
+   * Each segment is defined with its inertial parameters (mass, position of the center of mass and inertia tensor 
+   * at the center of mass, both expressed in the segment's frame), the label of its proximal segment and the 
+   * label of its proximal joint. The joint center is the origin of the segment, unless the label of a point is 
+   * given in Segment::JointCenter. The external wrenches applied on a segment (e.g. the outputs of the 
+   * GroundReactionWrenchFilter assigned to a foot) are given by their index in the second input.
+   *
+   * The segments are processed from the distal to the proximal ones. The loads transmitted by a segment to its 
+   * proximal segment are the sum of its inertial terms, the weight, the loads of its distal segments and the external wrenches.
+   * The velocities and accelerations are computed with central differences on the whole acquisition.
+   * Segments sharing the same level in the chains are processed in parallel when OpenMP is enabled.
+   *
+   * For each segment with a joint label, the output contains 3 points:
+   *  - <joint>Force (Point::Force, newtons): Force applied by the proximal segment at the joint center;
+   *  - <joint>Moment (Point::Moment, newtons times the unit of the points): Moment applied by the proximal segment at the joint center;
+   *  - <joint>Power (Point::Power, watts, stored in the Z component): Joint power (moment times the relative angular velocity).
+   * The force and the moment are expressed in the frame set by SetExpressionFrame().
+   * The residuals are set to -1 for the frames which cannot be computed (occluded points in the chain).
+   *
+   * The point frequency must be set with SetPointFrequency(). The wrenches must be sampled at the same frequency 
+   * or at a integer multiple of it (the samples corresponding to the points' frames are then used).
+   *
+   * @ingroup BTKBasicFilters
+   */
+  /**
+   * @var InverseDynamicsFilter::ExpressionFrame InverseDynamicsFilter::Global
+   * The joint loads are expressed in the global frame.
+   */
+  /**
+   * @var InverseDynamicsFilter::ExpressionFrame InverseDynamicsFilter::Proximal
+   * The joint loads are expressed in the frame of the proximal segment (global frame if the segment has no proximal segment).
+   */
+  /**
+   * @var InverseDynamicsFilter::ExpressionFrame InverseDynamicsFilter::Distal
+   * The joint loads are expressed in the frame of the distal segment.
+   */
+  
+  /**
+   * @struct InverseDynamicsFilter::Segment
+   * @brief Definition of a segment.
+   */
+  /**
+   * @var std::string InverseDynamicsFilter::Segment::Label
+   * Label of the segment (prefix of its virtual reference frame).
+   */
+  /**
+   * @var std::string InverseDynamicsFilter::Segment::Proximal
+   * Label of the proximal segment (empty if none).
+   */
+  /**
+   * @var std::string InverseDynamicsFilter::Segment::Joint
+   * Label of the proximal joint used as prefix for the output points (empty to not output the loads of the joint).
+   */
+  /**
+   * @var std::string InverseDynamicsFilter::Segment::JointCenter
+   * Label of the point used as proximal joint center (empty for the origin of the segment).
+   */
+  /**
+   * @var double InverseDynamicsFilter::Segment::Mass
+   * Mass of the segment (kilograms).
+   */
+  /**
+   * @var Eigen::Matrix<double, 3, 1> InverseDynamicsFilter::Segment::CenterOfMass
+   * Position of the center of mass in the frame of the segment (unit of the points).
+   */
+  /**
+   * @var Eigen::Matrix<double, 3, 3> InverseDynamicsFilter::Segment::Inertia
+   * Inertia tensor at the center of mass expressed in the frame of the segment (kilograms times square meters).
+   */
+  /**
+   * @var std::vector<int> InverseDynamicsFilter::Segment::Wrenches
+   * Indices of the external wrenches applied on the segment.
+   */
+  /**
+   * @fn InverseDynamicsFilter::Segment::Segment(const std::string& label, const std::string& proximal, const std::string& joint, double mass, const Eigen::Matrix<double, 3, 1>& com, const Eigen::Matrix<double, 3, 3>& inertia)
+   * Constructor.
+   */
+  
+  /**
+   * @typedef InverseDynamicsFilter::Pointer
+   * Smart pointer associated with a InverseDynamicsFilter object.
+   */
+  
+  /**
+   * @typedef InverseDynamicsFilter::ConstPointer
+   * Smart pointer associated with a const InverseDynamicsFilter object.
+   */
+  
+  /**
+   * @fn static Pointer InverseDynamicsFilter::New();
+   * Creates a smart pointer associated with a InverseDynamicsFilter object.
+   */
+  
+  /**
+   * @fn PointCollection::Pointer InverseDynamicsFilter::GetInput()
+   * Gets the segments' frames registered with this process.
+   */
+
+  /**
+   * @fn void InverseDynamicsFilter::SetInput(PointCollection::Pointer input)
+   * Sets the segments' frames (and the joint centers) required with this process.
+   */
+  
+  /**
+   * @fn WrenchCollection::Pointer InverseDynamicsFilter::GetWrenchInput()
+   * Gets the external wrenches registered with this process.
+   */
+
+  /**
+   * @fn void InverseDynamicsFilter::SetWrenchInput(WrenchCollection::Pointer input)
+   * Sets the external wrenches (expressed in the global frame) used by this process.
+   */
+  
+  /**
+   * @fn PointCollection::Pointer InverseDynamicsFilter::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * Appends a segment. The mass must be positive and a segment cannot be its own proximal segment.
+   */
+  void InverseDynamicsFilter::AppendSegment(const Segment& segment)
+  {
+    if (segment.Mass < 0.0)
+    {
+      btkErrorMacro("The mass of a segment cannot be negative.");
+      return;
+    }
+    if (segment.Label.compare(segment.Proximal) == 0)
+    {
+      btkErrorMacro("A segment cannot be its own proximal segment.");
+      return;
+    }
+    this->m_Segments.push_back(segment);
+    this->Modified();
+  };
+  
+  /**
+   * Sets the list of segments.
+   */
+  void InverseDynamicsFilter::SetSegments(const std::list<Segment>& segments)
+  {
+    this->m_Segments.clear();
+    for (std::list<Segment>::const_iterator it = segments.begin() ; it != segments.end() ; ++it)
+      this->AppendSegment(*it);
+    this->Modified();
+  };
+  
+  /**
+   * @fn const std::list<Segment>& InverseDynamicsFilter::GetSegments() const
+   * Returns the list of segments.
+   */
+  
+  /**
+   * Removes all the segments.
+   */
+  void InverseDynamicsFilter::ClearSegments()
+  {
+    if (this->m_Segments.empty())
+      return;
+    this->m_Segments.clear();
+    this->Modified();
+  };
+  
+  /**
+   * @fn double InverseDynamicsFilter::GetPointFrequency() const
+   * Returns the sampling frequency of the points.
+   */
+  
+  /**
+   * Sets the sampling frequency of the points.
+   */
+  void InverseDynamicsFilter::SetPointFrequency(double freq)
+  {
+    if (freq <= 0.0)
+    {
+      btkErrorMacro("The frequency must be strictly positive.");
+      return;
+    }
+    if (this->m_PointFrequency == freq)
+      return;
+    this->m_PointFrequency = freq;
+    this->Modified();
+  };
+  
+  /**
+   * @fn double InverseDynamicsFilter::GetPointUnitScale() const
+   * Returns the scale to convert the unit of the points in meters.
+   */
+  
+  /**
+   * Sets the scale to convert the unit of the points in meters (0.001 by default, i.e. millimeters).
+   */
+  void InverseDynamicsFilter::SetPointUnitScale(double scale)
+  {
+    if (scale <= 0.0)
+    {
+      btkErrorMacro("The scale must be strictly positive.");
+      return;
+    }
+    if (this->m_PointUnitScale == scale)
+      return;
+    this->m_PointUnitScale = scale;
+    this->Modified();
+  };
+  
+  /**
+   * @fn const Eigen::Matrix<double, 3, 1>& InverseDynamicsFilter::GetGravity() const
+   * Returns the gravitational acceleration expressed in the global frame (meters per square seconds).
+   */
+  
+  /**
+   * Sets the gravitational acceleration expressed in the global frame (meters per square seconds). By default, it is set to (0, 0, -9.81).
+   */
+  void InverseDynamicsFilter::SetGravity(const Eigen::Matrix<double, 3, 1>& g)
+  {
+    if (this->m_Gravity == g)
+      return;
+    this->m_Gravity = g;
+    this->Modified();
+  };
+  
+  /**
+   * @fn ExpressionFrame InverseDynamicsFilter::GetExpressionFrame() const
+   * Returns the frame used to express the joint forces and moments.
+   */
+  
+  /**
+   * Sets the frame used to express the joint forces and moments (Global by default).
+   */
+  void InverseDynamicsFilter::SetExpressionFrame(ExpressionFrame frame)
+  {
+    if (this->m_ExpressionFrame == frame)
+      return;
+    this->m_ExpressionFrame = frame;
+    this->Modified();
+  };
+  
+  /**
+   * Constructor. 
+   * Sets the number of inputs to 2 and outputs to 1.
+   */
+  InverseDynamicsFilter::InverseDynamicsFilter()
+  : ProcessObject(), m_Segments(), m_Gravity(0.0, 0.0, -9.81)
+  {
+    this->m_PointFrequency = 0.0;
+    this->m_PointUnitScale = 0.001;
+    this->m_ExpressionFrame = Global;
+    this->SetInputNumber(2);
+    this->SetOutputNumber(1);
+  };
+  
+  /**
+   * @fn PointCollection::Pointer InverseDynamicsFilter::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn PointCollection::Pointer InverseDynamicsFilter::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates a PointCollection:Pointer object and return it as a DataObject::Pointer.
+   */
+  DataObject::Pointer InverseDynamicsFilter::MakeOutput(int /* idx */)
+  {
+    return PointCollection::New();
+  };
+  
+  /**
+   * Generates the outputs' data.
+   */
+  void InverseDynamicsFilter::GenerateData()
+  {
+    PointCollection::Pointer output = this->GetOutput();
+    output->Clear();
+    PointCollection::Pointer input = this->GetInput();
+    if (!input || input->IsEmpty() || this->m_Segments.empty())
+      return;
+    if (this->m_PointFrequency <= 0.0)
+    {
+      btkErrorMacro("The point frequency must be set to compute the inverse dynamics.");
+      return;
+    }
+    WrenchCollection::Pointer wrenches = this->GetWrenchInput();
+    const int numFrames = input->GetFrontItem()->GetFrameNumber();
+    const char* suffixes[4] = {"O", "A", "L", "P"};
+    std::map<std::string, Point::ConstPointer> points;
+    for (PointCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+    {
+      if ((*it)->GetFrameNumber() == numFrames)
+        points[(*it)->GetLabel()] = *it;
+    }
+    
+    // Segments found in the input
+    std::vector<InverseDynamicsJob> jobs;
+    std::map<std::string, int> indices;
+    for (std::list<Segment>::const_iterator it = this->m_Segments.begin() ; it != this->m_Segments.end() ; ++it)
+    {
+      InverseDynamicsJob job;
+      job.segment = &(*it);
+      bool found = true;
+      for (int i = 0 ; i < 4 ; ++i)
+      {
+        std::map<std::string, Point::ConstPointer>::const_iterator itP = points.find(it->Label + suffixes[i]);
+        if (itP == points.end())
+        {
+          btkWarningMacro("Missing or invalid point " + it->Label + suffixes[i] + ". The segment " + it->Label + " is not used.");
+          found = false;
+          break;
+        }
+        job.frame[i] = itP->second;
+      }
+      if (!found)
+        continue;
+      if (!it->JointCenter.empty())
+      {
+        std::map<std::string, Point::ConstPointer>::const_iterator itP = points.find(it->JointCenter);
+        if (itP == points.end())
+        {
+          btkWarningMacro("Missing or invalid joint center " + it->JointCenter + ". The origin of the segment " + it->Label + " is used.");
+        }
+        else
+          job.center = itP->second;
+      }
+      for (size_t i = 0 ; i < it->Wrenches.size() ; ++i)
+      {
+        Wrench::Pointer wrench = (wrenches && (it->Wrenches[i] >= 0) && (it->Wrenches[i] < wrenches->GetItemNumber())) ? wrenches->GetItem(it->Wrenches[i]) : Wrench::Pointer();
+        if (!wrench)
+        {
+          btkWarningMacro("Missing external wrench for the segment " + it->Label + ".");
+          continue;
+        }
+        const int n = wrench->GetForce()->GetFrameNumber();
+        if ((n < numFrames) || ((n % numFrames) != 0))
+        {
+          btkWarningMacro("The number of frames of an external wrench is not a multiple of the number of frames of the points. It is not used for the segment " + it->Label + ".");
+          continue;
+        }
+        InverseDynamicsWrench components;
+        components.position = wrench->GetPosition();
+        components.force = wrench->GetForce();
+        components.moment = wrench->GetMoment();
+        job.wrenches.push_back(components);
+      }
+      job.parent = -1;
+      job.height = 0;
+      indices[it->Label] = static_cast<int>(jobs.size());
+      jobs.push_back(job);
+    }
+    const int num = static_cast<int>(jobs.size());
+    // Chains
+    for (int i = 0 ; i < num ; ++i)
+    {
+      if (jobs[i].segment->Proximal.empty())
+        continue;
+      std::map<std::string, int>::const_iterator it = indices.find(jobs[i].segment->Proximal);
+      if (it == indices.end())
+      {
+        btkWarningMacro("Unknown proximal segment " + jobs[i].segment->Proximal + " for the segment " + jobs[i].segment->Label + ".");
+        continue;
+      }
+      jobs[i].parent = it->second;
+      jobs[it->second].children.push_back(i);
+    }
+    int maxHeight = 0;
+    for (int i = 0 ; i < num ; ++i)
+    {
+      int p = jobs[i].parent, h = 1;
+      while ((p != -1) && (h <= num))
+      {
+        jobs[p].height = std::max(jobs[p].height, h++);
+        p = jobs[p].parent;
+      }
+      if (h > num)
+      {
+        btkErrorMacro("The segments contain a closed loop. Impossible to compute the inverse dynamics.");
+        return;
+      }
+      maxHeight = std::max(maxHeight, h - 1);
+    }
+    
+    // Kinematics
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0 ; i < num ; ++i)
+      ComputeInverseDynamicsKinematics(&(jobs[i]), this->m_PointFrequency);
+    
+    // Dynamics: from the distal segments to the proximal ones
+    for (int h = 0 ; h <= maxHeight ; ++h)
+    {
+      std::vector<int> level;
+      for (int i = 0 ; i < num ; ++i)
+      {
+        if (jobs[i].height == h)
+          level.push_back(i);
+      }
+      const int numLevel = static_cast<int>(level.size());
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (int i = 0 ; i < numLevel ; ++i)
+        ComputeInverseDynamicsLoads(&(jobs[level[i]]), jobs, this->m_Gravity, this->m_PointUnitScale);
+    }
+    
+    // Outputs
+    for (int i = 0 ; i < num ; ++i)
+    {
+      const InverseDynamicsJob& job = jobs[i];
+      const std::string& label = job.segment->Joint;
+      if (label.empty())
+        continue;
+      const InverseDynamicsJob* parent = (job.parent != -1) ? &(jobs[job.parent]) : 0;
+      Point::Pointer force = Point::New(label + "Force", numFrames, Point::Force);
+      Point::Pointer moment = Point::New(label + "Moment", numFrames, Point::Moment);
+      Point::Pointer power = Point::New(label + "Power", numFrames, Point::Power);
+      if (this->m_ExpressionFrame == Distal)
+      {
+        force->GetValues() = InverseDynamicsToLocal(job.axes, job.force);
+        moment->GetValues() = InverseDynamicsToLocal(job.axes, job.moment);
+      }
+      else if ((this->m_ExpressionFrame == Proximal) && parent)
+      {
+        force->GetValues() = InverseDynamicsToLocal(parent->axes, job.force);
+        moment->GetValues() = InverseDynamicsToLocal(parent->axes, job.moment);
+      }
+      else
+      {
+        force->GetValues() = job.force;
+        moment->GetValues() = job.moment;
+      }
+      const InverseDynamicsSeries omega = parent ? InverseDynamicsSeries(job.omega - parent->omega) : job.omega;
+      power->GetValues().setZero();
+      power->GetValues().col(2) = job.moment.cwiseProduct(omega).rowwise().sum() * this->m_PointUnitScale;
+      for (int f = 0 ; f < numFrames ; ++f)
+      {
+        const bool valid = job.valid[f] && (!parent || parent->valid[f]);
+        const double residual = valid ? 0.0 : -1.0;
+        force->GetResiduals().coeffRef(f) = residual;
+        moment->GetResiduals().coeffRef(f) = residual;
+        power->GetResiduals().coeffRef(f) = residual;
+        if (!valid)
+        {
+          force->GetValues().row(f).setZero();
+          moment->GetValues().row(f).setZero();
+          power->GetValues().row(f).setZero();
+        }
+      }
+      output->InsertItem(force);
+      output->InsertItem(moment);
+      output->InsertItem(power);
+    }
+  };
+};
@@ -0,0 +1,118 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkInverseDynamicsFilter_h
+#define __btkInverseDynamicsFilter_h
+
+#include "btkProcessObject.h"
+#include "btkPointCollection.h"
+#include "btkWrenchCollection.h"
+
+#include <Eigen/Core>
+
+#include <list>
+#include <string>
+#include <vector>
+
+namespace btk
+{
+  class InverseDynamicsFilter : public ProcessObject
+  {
+  public:
+    typedef enum {Global = 0, Proximal, Distal} ExpressionFrame;
+    
+    struct Segment
+    {
+      Segment(const std::string& label, const std::string& proximal, const std::string& joint, double mass, const Eigen::Matrix<double, 3, 1>& com, const Eigen::Matrix<double, 3, 3>& inertia)
+      : Label(label), Proximal(proximal), Joint(joint), JointCenter(), Mass(mass), CenterOfMass(com), Inertia(inertia), Wrenches()
+      {};
+      std::string Label;
+      std::string Proximal;
+      std::string Joint;
+      std::string JointCenter;
+      double Mass;
+      Eigen::Matrix<double, 3, 1> CenterOfMass;
+      Eigen::Matrix<double, 3, 3> Inertia;
+      std::vector<int> Wrenches;
+    };
+    
+    typedef btkSharedPtr<InverseDynamicsFilter> Pointer;
+    typedef btkSharedPtr<const InverseDynamicsFilter> ConstPointer;
+    
+    static Pointer New() {return Pointer(new InverseDynamicsFilter());};
+    
+    // ~InverseDynamicsFilter(); // Implicit
+    
+    PointCollection::Pointer GetInput() {return this->GetInput(0);};
+    void SetInput(PointCollection::Pointer input) {this->SetNthInput(0, input);};
+    WrenchCollection::Pointer GetWrenchInput() {return static_pointer_cast<WrenchCollection>(this->GetNthInput(1));};
+    void SetWrenchInput(WrenchCollection::Pointer input) {this->SetNthInput(1, input);};
+    PointCollection::Pointer GetOutput() {return this->GetOutput(0);};
+    
+    BTK_BASICFILTERS_EXPORT void AppendSegment(const Segment& segment);
+    BTK_BASICFILTERS_EXPORT void SetSegments(const std::list<Segment>& segments);
+    const std::list<Segment>& GetSegments() const {return this->m_Segments;};
+    BTK_BASICFILTERS_EXPORT void ClearSegments();
+    
+    double GetPointFrequency() const {return this->m_PointFrequency;};
+    BTK_BASICFILTERS_EXPORT void SetPointFrequency(double freq);
+    double GetPointUnitScale() const {return this->m_PointUnitScale;};
+    BTK_BASICFILTERS_EXPORT void SetPointUnitScale(double scale = 0.001);
+    const Eigen::Matrix<double, 3, 1>& GetGravity() const {return this->m_Gravity;};
+    BTK_BASICFILTERS_EXPORT void SetGravity(const Eigen::Matrix<double, 3, 1>& g);
+    ExpressionFrame GetExpressionFrame() const {return this->m_ExpressionFrame;};
+    BTK_BASICFILTERS_EXPORT void SetExpressionFrame(ExpressionFrame frame);
+    
+  protected:
+    BTK_BASICFILTERS_EXPORT InverseDynamicsFilter();
+    
+    PointCollection::Pointer GetInput(int idx) {return static_pointer_cast<PointCollection>(this->GetNthInput(idx));};
+    PointCollection::Pointer GetOutput(int idx) {return static_pointer_cast<PointCollection>(this->GetNthOutput(idx));};
+    BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
+    BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    
+  private:
+    InverseDynamicsFilter(const InverseDynamicsFilter& ); // Not implemented.
+    InverseDynamicsFilter& operator=(const InverseDynamicsFilter& ); // Not implemented.
+    
+    std::list<Segment> m_Segments;
+    double m_PointFrequency;
+    double m_PointUnitScale;
+    Eigen::Matrix<double, 3, 1> m_Gravity;
+    ExpressionFrame m_ExpressionFrame;
+  };
+};
+
+#endif // __btkInverseDynamicsFilter_h
@@ -0,0 +1,410 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkJointAngleFilter.h"
+
+#include <cmath>
+#include <map>
+#include <vector>
+
+#ifndef M_PI
+  #define M_PI 3.14159265358979323846
+#endif
+
+namespace btk
+{
+  struct JointAngleJob
+  {
+    Point::ConstPointer proximal[4]; // Origin and 3 axes. Null for the global frame. Read only: a segment can be shared by several joints
+    Point::ConstPointer distal[4];
+    JointAngleFilter::Sequence sequence;
+    Point::Pointer angle;
+  };
+  
+  // Unit axes (columns of the rotation matrix) of a segment for every frame.
+  static void ExtractSegmentAxes(Eigen::Matrix<double, Eigen::Dynamic, 3>* axes, const Point::ConstPointer frame[4], int numFrames)
+  {
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      if (!frame[0])
+      {
+        axes[i].setZero(numFrames, 3);
+        axes[i].col(i).setOnes();
+      }
+      else
+      {
+        axes[i] = frame[i+1]->GetValues() - frame[0]->GetValues();
+        const Eigen::Array<double, Eigen::Dynamic, 1> norm = axes[i].rowwise().norm().array();
+        for (int j = 0 ; j < 3 ; ++j)
+          axes[i].col(j).array() /= (norm > 0.0).select(norm, 1.0);
+      }
+    }
+  };
+  
+  // Joint angles (degrees) extracted from the rotation of the distal segment relative to the proximal segment.
+  // The relative rotation is computed for all the frames at once, only the trigonometric functions are evaluated frame by frame.
+  static void ComputeJointAngle(JointAngleJob* job)
+  {
+    const int numFrames = job->angle->GetFrameNumber();
+    Eigen::Matrix<double, Eigen::Dynamic, 3> p[3], d[3];
+    ExtractSegmentAxes(p, job->proximal, numFrames);
+    ExtractSegmentAxes(d, job->distal, numFrames);
+    // R = Rp^T * Rd: R(a,b) = dot(proximal axis a, distal axis b)
+    Eigen::Matrix<double, Eigen::Dynamic, 9> R(numFrames, 9);
+    for (int a = 0 ; a < 3 ; ++a)
+      for (int b = 0 ; b < 3 ; ++b)
+        R.col(3*a+b) = p[a].cwiseProduct(d[b]).rowwise().sum();
+    // Residuals: maximum of the residuals of the points defining the segments
+    Point::Residuals& residuals = job->angle->GetResiduals();
+    residuals.setZero();
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+      if (job->proximal[i])
+        residuals = residuals.cwiseMax(job->proximal[i]->GetResiduals());
+      if (job->distal[i])
+        residuals = residuals.cwiseMax(job->distal[i]->GetResiduals());
+    }
+    // Occluded as soon as one of the points is occluded
+    OcclusionMask visible(numFrames);
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+      if (job->proximal[i])
+        visible &= job->proximal[i]->GetOcclusionMask();
+      if (job->distal[i])
+        visible &= job->distal[i]->GetOcclusionMask();
+    }
+    visible.FillOccluded(residuals, -1.0);
+    // Axes of the sequence
+    static const int axes[12][3] = {{0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0},
+                                    {0,1,0}, {0,2,0}, {1,0,1}, {1,2,1}, {2,0,2}, {2,1,2}};
+    const int i = axes[job->sequence][0], j = axes[job->sequence][1];
+    const bool cardan = (axes[job->sequence][2] != i);
+    const int k = 3 - i - j;
+    const double s = (((j - i + 3) % 3) == 1) ? 1.0 : -1.0; // Parity of the permutation (i,j,k)
+    const double radToDeg = 180.0 / M_PI;
+    Point::Values& values = job->angle->GetValues();
+    for (int f = 0 ; f < numFrames ; ++f)
+    {
+      if (residuals.coeff(f) < 0.0)
+      {
+        values.row(f).setZero();
+        continue;
+      }
+      const Eigen::Matrix<double, 1, 9> r = R.row(f);
+      if (cardan)
+      {
+        const double sb = s * r.coeff(3*i+k);
+        values.coeffRef(f,0) = std::atan2(-s * r.coeff(3*j+k), r.coeff(3*k+k));
+        values.coeffRef(f,1) = std::asin(sb < -1.0 ? -1.0 : (sb > 1.0 ? 1.0 : sb));
+        values.coeffRef(f,2) = std::atan2(-s * r.coeff(3*i+j), r.coeff(3*i+i));
+      }
+      else
+      {
+        const double cb = r.coeff(3*i+i);
+        values.coeffRef(f,0) = std::atan2(r.coeff(3*j+i), -s * r.coeff(3*k+i));
+        values.coeffRef(f,1) = std::acos(cb < -1.0 ? -1.0 : (cb > 1.0 ? 1.0 : cb));
+        values.coeffRef(f,2) = std::atan2(r.coeff(3*i+j), s * r.coeff(3*i+k));
+      }
+    }
+    values *= radToDeg;
+  };
+  
+  /**
+   * @class JointAngleFilter btkJointAngleFilter.h
+   * @brief Computes the Euler/Cardan angles between pairs of segments.
+   *
+   * The segments are given as virtual reference frames in the input (see RigidBodyPoseFilter): 
+   * a segment labeled "RTI" corresponds to the points RTIO (origin), RTIA (first axis), RTIL (second axis) and RTIP (third axis).
+   * An empty label for the proximal segment corresponds to the global frame (i.e. absolute angles of the distal segment).
+   *
+   * For each joint, the rotation of the distal segment relative to the proximal segment is decomposed with the 
+   * chosen sequence of rotations around the mobile axes (intrinsic rotations). The Cardan sequences (XYZ, XZY, YXZ, YZX, ZXY, ZYX) 
+   * give a second angle between -90 and 90 degrees, the Euler sequences (XYX, XZX, YXY, YZY, ZXZ, ZYZ) between 0 and 180 degrees.
+   *
+   * The output contains one point of type Point::Angle for each joint, expressed in degrees. The residuals of an angle are set 
+   * to the maximum residuals of the points defining its segments, or to -1 if one of them is occluded.
+   *
+   * The joints are processed in parallel when OpenMP is enabled.
+   *
+   * @ingroup BTKBasicFilters
+   */
+  /**
+   * @var JointAngleFilter::Sequence JointAngleFilter::XYZ
+   * Cardan sequence X, Y', Z''.
+   */
+  /**
+   * @var JointAngleFilter::Sequence JointAngleFilter::XZY
+   * Cardan sequence X, Z', Y''.
+   */
+  /**
+   * @var JointAngleFilter::Sequence JointAngleFilter::YXZ
+   * Cardan sequence Y, X', Z''.
+   */
+  /**
+   * @var JointAngleFilter::Sequence JointAngleFilter::YZX
+   * Cardan sequence Y, Z', X''.
+   */
+  /**
+   * @var JointAngleFilter::Sequence JointAngleFilter::ZXY
+   * Cardan sequence Z, X', Y''.
+   */
+  /**
+   * @var JointAngleFilter::Sequence JointAngleFilter::ZYX
+   * Cardan sequence Z, Y', X''.
+   */
+  /**
+   * @var JointAngleFilter::Sequence JointAngleFilter::XYX
+   * Euler sequence X, Y', X''.
+   */
+  /**
+   * @var JointAngleFilter::Sequence JointAngleFilter::XZX
+   * Euler sequence X, Z', X''.
+   */
+  /**
+   * @var JointAngleFilter::Sequence JointAngleFilter::YXY
+   * Euler sequence Y, X', Y''.
+   */
+  /**
+   * @var JointAngleFilter::Sequence JointAngleFilter::YZY
+   * Euler sequence Y, Z', Y''.
+   */
+  /**
+   * @var JointAngleFilter::Sequence JointAngleFilter::ZXZ
+   * Euler sequence Z, X', Z''.
+   */
+  /**
+   * @var JointAngleFilter::Sequence JointAngleFilter::ZYZ
+   * Euler sequence Z, Y', Z''.
+   */
+  
+  /**
+   * @struct JointAngleFilter::Joint
+   * @brief Definition of a joint.
+   */
+  /**
+   * @var std::string JointAngleFilter::Joint::Label
+   * Label of the output angle.
+   */
+  /**
+   * @var std::string JointAngleFilter::Joint::Proximal
+   * Label of the proximal segment (empty for the global frame).
+   */
+  /**
+   * @var std::string JointAngleFilter::Joint::Distal
+   * Label of the distal segment.
+   */
+  /**
+   * @var JointAngleFilter::Sequence JointAngleFilter::Joint::RotationSequence
+   * Sequence of rotations used to decompose the relative rotation.
+   */
+  /**
+   * @fn JointAngleFilter::Joint::Joint(const std::string& label, const std::string& proximal, const std::string& distal, Sequence seq = XYZ)
+   * Constructor.
+   */
+  /**
+   * @fn bool JointAngleFilter::Joint::operator==(const Joint& lhs, const Joint& rhs)
+   * Equal operator.
+   */
+  
+  /**
+   * @typedef JointAngleFilter::Pointer
+   * Smart pointer associated with a JointAngleFilter object.
+   */
+  
+  /**
+   * @typedef JointAngleFilter::ConstPointer
+   * Smart pointer associated with a const JointAngleFilter object.
+   */
+  
+  /**
+   * @fn static Pointer JointAngleFilter::New();
+   * Creates a smart pointer associated with a JointAngleFilter object.
+   */
+  
+  /**
+   * @fn PointCollection::Pointer JointAngleFilter::GetInput()
+   * Gets the input registered with this process.
+   */
+
+  /**
+   * @fn void JointAngleFilter::SetInput(PointCollection::Pointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn PointCollection::Pointer JointAngleFilter::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * @fn void JointAngleFilter::AppendJoint(const std::string& label, const std::string& proximal, const std::string& distal, Sequence seq = XYZ)
+   * Convenient method to append a joint.
+   */
+  
+  /**
+   * Appends a joint. A joint with the same definition is not appended twice.
+   */
+  void JointAngleFilter::AppendJoint(const Joint& joint)
+  {
+    if (joint.Distal.empty())
+    {
+      btkErrorMacro("The distal segment of a joint cannot be the global frame.");
+      return;
+    }
+    for (std::list<Joint>::const_iterator it = this->m_Joints.begin() ; it != this->m_Joints.end() ; ++it)
+    {
+      if (*it == joint)
+        return;
+    }
+    this->m_Joints.push_back(joint);
+    this->Modified();
+  };
+  
+  /**
+   * Sets the list of joints.
+   */
+  void JointAngleFilter::SetJoints(const std::list<Joint>& joints)
+  {
+    if (this->m_Joints == joints)
+      return;
+    this->m_Joints.clear();
+    for (std::list<Joint>::const_iterator it = joints.begin() ; it != joints.end() ; ++it)
+      this->AppendJoint(*it);
+    this->Modified();
+  };
+  
+  /**
+   * @fn const std::list<Joint>& JointAngleFilter::GetJoints() const
+   * Returns the list of joints.
+   */
+  
+  /**
+   * Removes all the joints.
+   */
+  void JointAngleFilter::ClearJoints()
+  {
+    if (this->m_Joints.empty())
+      return;
+    this->m_Joints.clear();
+    this->Modified();
+  };
+  
+  /**
+   * Constructor. 
+   * Sets the number of inputs and outputs to 1.
+   */
+  JointAngleFilter::JointAngleFilter()
+  : ProcessObject(), m_Joints()
+  {
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+  };
+  
+  /**
+   * @fn PointCollection::Pointer JointAngleFilter::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn PointCollection::Pointer JointAngleFilter::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates a PointCollection:Pointer object and return it as a DataObject::Pointer.
+   */
+  DataObject::Pointer JointAngleFilter::MakeOutput(int /* idx */)
+  {
+    return PointCollection::New();
+  };
+  
+  /**
+   * Generates the outputs' data.
+   */
+  void JointAngleFilter::GenerateData()
+  {
+    PointCollection::Pointer output = this->GetOutput();
+    output->Clear();
+    PointCollection::Pointer input = this->GetInput();
+    if (!input || input->IsEmpty())
+      return;
+    const int numFrames = input->GetFrontItem()->GetFrameNumber();
+    const char* suffixes[4] = {"O", "A", "L", "P"};
+    // The points are only read with the const accessors.
+    std::map<std::string, Point::ConstPointer> points;
+    for (PointCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+      points[(*it)->GetLabel()] = *it;
+    
+    std::vector<JointAngleJob> jobs;
+    for (std::list<Joint>::const_iterator it = this->m_Joints.begin() ; it != this->m_Joints.end() ; ++it)
+    {
+      JointAngleJob job;
+      bool found = true;
+      for (int s = 0 ; s < 2 ; ++s)
+      {
+        const std::string& segment = (s == 0) ? it->Proximal : it->Distal;
+        Point::ConstPointer* frame = (s == 0) ? job.proximal : job.distal;
+        if (segment.empty())
+          continue;
+        for (int i = 0 ; i < 4 ; ++i)
+        {
+          std::map<std::string, Point::ConstPointer>::const_iterator itP = points.find(segment + suffixes[i]);
+          if ((itP == points.end()) || (itP->second->GetFrameNumber() != numFrames))
+          {
+            btkWarningMacro("Missing or invalid point " + segment + suffixes[i] + ". The joint " + it->Label + " is not computed.");
+            found = false;
+            break;
+          }
+          frame[i] = itP->second;
+        }
+        if (!found)
+          break;
+      }
+      if (!found)
+        continue;
+      job.sequence = it->RotationSequence;
+      job.angle = Point::New(it->Label, numFrames, Point::Angle);
+      output->InsertItem(job.angle);
+      jobs.push_back(job);
+    }
+    
+    const int num = static_cast<int>(jobs.size());
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0 ; i < num ; ++i)
+      ComputeJointAngle(&(jobs[i]));
+  };
+};
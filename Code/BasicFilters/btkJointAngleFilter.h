@@ -0,0 +1,103 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkJointAngleFilter_h
+#define __btkJointAngleFilter_h
+
+#include "btkProcessObject.h"
+#include "btkPointCollection.h"
+
+#include <list>
+#include <string>
+
+namespace btk
+{
+  class JointAngleFilter : public ProcessObject
+  {
+  public:
+    typedef enum {XYZ = 0, XZY, YXZ, YZX, ZXY, ZYX, XYX, XZX, YXY, YZY, ZXZ, ZYZ} Sequence;
+    
+    struct Joint
+    {
+      Joint(const std::string& label, const std::string& proximal, const std::string& distal, Sequence seq = XYZ)
+      : Label(label), Proximal(proximal), Distal(distal), RotationSequence(seq)
+      {};
+      friend bool operator==(const Joint& lhs, const Joint& rhs)
+      {
+        return ((lhs.Label.compare(rhs.Label) == 0)
+                && (lhs.Proximal.compare(rhs.Proximal) == 0)
+                && (lhs.Distal.compare(rhs.Distal) == 0)
+                && (lhs.RotationSequence == rhs.RotationSequence));
+      };
+      std::string Label;
+      std::string Proximal;
+      std::string Distal;
+      Sequence RotationSequence;
+    };
+    
+    typedef btkSharedPtr<JointAngleFilter> Pointer;
+    typedef btkSharedPtr<const JointAngleFilter> ConstPointer;
+    
+    static Pointer New() {return Pointer(new JointAngleFilter());};
+    
+    // ~JointAngleFilter(); // Implicit
+    
+    PointCollection::Pointer GetInput() {return this->GetInput(0);};
+    void SetInput(PointCollection::Pointer input) {this->SetNthInput(0, input);};
+    PointCollection::Pointer GetOutput() {return this->GetOutput(0);};
+    
+    void AppendJoint(const std::string& label, const std::string& proximal, const std::string& distal, Sequence seq = XYZ) {this->AppendJoint(Joint(label, proximal, distal, seq));};
+    BTK_BASICFILTERS_EXPORT void AppendJoint(const Joint& joint);
+    BTK_BASICFILTERS_EXPORT void SetJoints(const std::list<Joint>& joints);
+    const std::list<Joint>& GetJoints() const {return this->m_Joints;};
+    BTK_BASICFILTERS_EXPORT void ClearJoints();
+    
+  protected:
+    BTK_BASICFILTERS_EXPORT JointAngleFilter();
+    
+    PointCollection::Pointer GetInput(int idx) {return static_pointer_cast<PointCollection>(this->GetNthInput(idx));};
+    PointCollection::Pointer GetOutput(int idx) {return static_pointer_cast<PointCollection>(this->GetNthOutput(idx));};
+    BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
+    BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    
+  private:
+    JointAngleFilter(const JointAngleFilter& ); // Not implemented.
+    JointAngleFilter& operator=(const JointAngleFilter& ); // Not implemented.
+    
+    std::list<Joint> m_Joints;
+  };
+};
+
+#endif // __btkJointAngleFilter_h
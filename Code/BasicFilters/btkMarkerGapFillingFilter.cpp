@@ -0,0 +1,551 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkMarkerGapFillingFilter.h"
+#include "btkConvert.h"
+
+#include <btkEigen/Interpolation/Interp1.h>
+#include <Eigen/LU>
+#include <Eigen/SVD>
+
+#include <algorithm>
+
+namespace btk
+{
+  // Maximum number of valid frames used on each side of a gap to compute the cubic and PCHIP interpolations.
+  static const int MarkerGapFillingSupport = 4;
+  
+  struct MarkerGapFillingJob
+  {
+    Point::Pointer point;
+    std::vector<OcclusionMask::Range> gaps;
+    std::vector<int> clusters; // Indices of the clusters containing this marker
+    int interpolated;
+    int reconstructed;
+  };
+  
+  // Natural cubic spline (second derivative equal to 0 at the endpoints).
+  static void InterpolateNaturalCubicSpline(Eigen::Matrix<double, Eigen::Dynamic, 1>* yi, const Eigen::Matrix<double, Eigen::Dynamic, 1>& x, const Eigen::Matrix<double, Eigen::Dynamic, 1>& y, const Eigen::Matrix<double, Eigen::Dynamic, 1>& xi)
+  {
+    const int n = static_cast<int>(x.rows());
+    // Tridiagonal system solved with the Thomas algorithm
+    Eigen::Matrix<double, Eigen::Dynamic, 1> y2 = Eigen::Matrix<double, Eigen::Dynamic, 1>::Zero(n), u = Eigen::Matrix<double, Eigen::Dynamic, 1>::Zero(n);
+    for (int i = 1 ; i < n - 1 ; ++i)
+    {
+      const double sig = (x.coeff(i) - x.coeff(i-1)) / (x.coeff(i+1) - x.coeff(i-1));
+      const double p = sig * y2.coeff(i-1) + 2.0;
+      y2.coeffRef(i) = (sig - 1.0) / p;
+      u.coeffRef(i) = (y.coeff(i+1) - y.coeff(i)) / (x.coeff(i+1) - x.coeff(i)) - (y.coeff(i) - y.coeff(i-1)) / (x.coeff(i) - x.coeff(i-1));
+      u.coeffRef(i) = (6.0 * u.coeff(i) / (x.coeff(i+1) - x.coeff(i-1)) - sig * u.coeff(i-1)) / p;
+    }
+    y2.coeffRef(n-1) = 0.0;
+    for (int k = n - 2 ; k >= 0 ; --k)
+      y2.coeffRef(k) = y2.coeff(k) * y2.coeff(k+1) + u.coeff(k);
+    yi->resize(xi.rows());
+    int klo = 0;
+    for (int i = 0 ; i < xi.rows() ; ++i)
+    {
+      while ((klo < n - 2) && (xi.coeff(i) > x.coeff(klo+1)))
+        ++klo;
+      const int khi = klo + 1;
+      const double h = x.coeff(khi) - x.coeff(klo);
+      const double a = (x.coeff(khi) - xi.coeff(i)) / h;
+      const double b = (xi.coeff(i) - x.coeff(klo)) / h;
+      yi->coeffRef(i) = a * y.coeff(klo) + b * y.coeff(khi) + ((a * a * a - a) * y2.coeff(klo) + (b * b * b - b) * y2.coeff(khi)) * (h * h) / 6.0;
+    }
+  };
+  
+  // Fill the gaps shorter or equal to maxGap which have valid frames on both sides.
+  static void InterpolateMarkerGaps(MarkerGapFillingJob* job, int maxGap, MarkerGapFillingFilter::InterpolationMethod method)
+  {
+    Point::Values& values = job->point->GetValues();
+    Point::Residuals& residuals = job->point->GetResiduals();
+    const int rows = static_cast<int>(values.rows());
+    const int support = (method == MarkerGapFillingFilter::Linear) ? 1 : MarkerGapFillingSupport;
+    for (size_t g = 0 ; g < job->gaps.size() ; ++g)
+    {
+      const OcclusionMask::Range& gap = job->gaps[g];
+      const int stop = gap.start + gap.length;
+      if ((gap.length > maxGap) || (gap.start == 0) || (stop == rows))
+        continue;
+      // Valid frames around the gap (bounded by the previous and next gaps)
+      const int prevStop = (g == 0) ? 0 : job->gaps[g-1].start + job->gaps[g-1].length;
+      const int nextStart = (g == job->gaps.size() - 1) ? rows : job->gaps[g+1].start;
+      const int before = std::min(support, gap.start - prevStop);
+      const int after = std::min(support, nextStart - stop);
+      Eigen::Matrix<double, Eigen::Dynamic, 1> x(before + after), y(before + after), xi(gap.length), yi;
+      for (int i = 0 ; i < before ; ++i)
+        x.coeffRef(i) = static_cast<double>(gap.start - before + i);
+      for (int i = 0 ; i < after ; ++i)
+        x.coeffRef(before + i) = static_cast<double>(stop + i);
+      for (int i = 0 ; i < gap.length ; ++i)
+        xi.coeffRef(i) = static_cast<double>(gap.start + i);
+      for (int c = 0 ; c < 3 ; ++c)
+      {
+        for (int i = 0 ; i < x.rows() ; ++i)
+          y.coeffRef(i) = values.coeff(static_cast<int>(x.coeff(i)), c);
+        if ((method == MarkerGapFillingFilter::Linear) || (x.rows() < 3))
+        {
+          Eigen::Matrix<double, Eigen::Dynamic, 1> xl(2), yl(2);
+          xl << x.coeff(before - 1), x.coeff(before);
+          yl << y.coeff(before - 1), y.coeff(before);
+          btkEigen::interp1().linear(&yi, xl, yl, xi);
+        }
+        else if (method == MarkerGapFillingFilter::Cubic)
+          InterpolateNaturalCubicSpline(&yi, x, y, xi);
+        else
+          btkEigen::interp1().pchip(&yi, x, y, xi);
+        values.block(gap.start, c, gap.length, 1) = yi;
+      }
+      residuals.segment(gap.start, gap.length).setZero();
+      job->interpolated += gap.length;
+    }
+  };
+  
+  // Rigid transformation (least squares, SVD) mapping the points of src onto the points of dst.
+  static bool ComputeMarkerClusterTransform(Eigen::Matrix<double, 3, 3>* R, Eigen::Matrix<double, 3, 1>* t, const Eigen::Matrix<double, 3, Eigen::Dynamic>& src, const Eigen::Matrix<double, 3, Eigen::Dynamic>& dst)
+  {
+    const Eigen::Matrix<double, 3, 1> cs = src.rowwise().mean();
+    const Eigen::Matrix<double, 3, 1> cd = dst.rowwise().mean();
+    const Eigen::Matrix<double, 3, 3> H = (src.colwise() - cs) * (dst.colwise() - cd).transpose();
+    Eigen::JacobiSVD< Eigen::Matrix<double, 3, 3> > svd(H, Eigen::ComputeFullU | Eigen::ComputeFullV);
+    if (svd.singularValues().coeff(1) <= 1e-9 * svd.singularValues().coeff(0)) // Aligned markers
+      return false;
+    Eigen::Matrix<double, 3, 3> D = Eigen::Matrix<double, 3, 3>::Identity();
+    D.coeffRef(2,2) = ((svd.matrixV() * svd.matrixU().transpose()).determinant() < 0.0) ? -1.0 : 1.0;
+    *R = svd.matrixV() * D * svd.matrixU().transpose();
+    *t = cd - *R * cs;
+    return true;
+  };
+  
+  // Reconstruct the remaining occluded frames of the marker from the other markers of its clusters.
+  // Only the frames valid in 'visible' are read (others markers) and only the occluded frames of the marker are written.
+  // The other markers are only read with the const accessors: they can be shared with the input or reconstructed by another thread.
+  static void ReconstructMarkerGaps(MarkerGapFillingJob* job, const std::vector< std::vector<int> >& clusters, const std::vector<Point::ConstPointer>& points, const std::vector<OcclusionMask>& visible, int index)
+  {
+    Point::Values& values = job->point->GetValues();
+    const int rows = static_cast<int>(values.rows());
+    const OcclusionMask& own = visible[index];
+    const std::vector<OcclusionMask::Range>& gaps = own.GetGaps();
+    for (std::vector<OcclusionMask::Range>::const_iterator it = gaps.begin() ; it != gaps.end() ; ++it)
+    {
+      for (int f = it->start ; f < it->start + it->length ; ++f)
+      {
+        for (size_t c = 0 ; c < job->clusters.size() ; ++c)
+        {
+          const std::vector<int>& cluster = clusters[job->clusters[c]];
+          std::vector<int> markers;
+          for (size_t m = 0 ; m < cluster.size() ; ++m)
+          {
+            if ((cluster[m] != index) && visible[cluster[m]].IsValid(f))
+              markers.push_back(cluster[m]);
+          }
+          if (markers.size() < 3)
+            continue;
+          // Closest frame where the marker and at least 3 of these markers are visible
+          bool found = false;
+          for (int d = 1 ; !found && ((f - d >= 0) || (f + d < rows)) ; ++d)
+          {
+            for (int s = -1 ; !found && (s <= 1) ; s += 2)
+            {
+              const int r = f + s * d;
+              if ((r < 0) || (r >= rows) || own.IsOccluded(r))
+                continue;
+              std::vector<int> common;
+              for (size_t m = 0 ; m < markers.size() ; ++m)
+              {
+                if (visible[markers[m]].IsValid(r))
+                  common.push_back(markers[m]);
+              }
+              if (common.size() < 3)
+                continue;
+              Eigen::Matrix<double, 3, Eigen::Dynamic> src(3, common.size()), dst(3, common.size());
+              for (size_t m = 0 ; m < common.size() ; ++m)
+              {
+                src.col(m) = points[common[m]]->GetValues().row(r).transpose();
+                dst.col(m) = points[common[m]]->GetValues().row(f).transpose();
+              }
+              Eigen::Matrix<double, 3, 3> R;
+              Eigen::Matrix<double, 3, 1> t;
+              if (!ComputeMarkerClusterTransform(&R, &t, src, dst))
+                continue;
+              values.row(f) = (R * values.row(r).transpose() + t).transpose();
+              job->point->GetResiduals().coeffRef(f) = 0.0;
+              ++job->reconstructed;
+              found = true;
+            }
+          }
+          if (found)
+            break;
+        }
+      }
+    }
+  };
+  
+  /**
+   * @class MarkerGapFillingFilter btkMarkerGapFillingFilter.h
+   * @brief Fill the gaps (occluded frames) of the markers.
+   *
+   * The occluded frames of a marker are detected by a negative residual. The residuals of all the markers 
+   * are scanned once to build the list of their gaps. Then, two methods are used to fill them:
+   *  - The gaps with a length lower or equal to the maximum gap (see SetMaxGap()) and with valid frames on both sides 
+   *    are interpolated. The interpolation method can be linear, cubic (natural spline) or PCHIP (see SetInterpolationMethod()).
+   *    The cubic and PCHIP interpolations use up to 4 valid frames on each side of the gap.
+   *  - The remaining occluded frames are reconstructed from the other markers of the clusters (see AddCluster()), 
+   *    if any. The rigid transformation of at least 3 markers of the cluster between the occluded frame and the closest 
+   *    frame where the marker is visible is applied to the marker.
+   *
+   * The filled frames have a residual set to 0. The numbers of filled frames are available after the update 
+   * (see GetFilledFrameNumber(), GetInterpolatedFrameNumber(), GetReconstructedFrameNumber()).
+   *
+   * Only the points of type Point::Marker are processed. The markers without gap are shared with the input. 
+   * The other ones are cloned, except if the in-place mode is enabled (see SetInPlace()). 
+   * When BTK is compiled with OpenMP (option BTK_USE_OPENMP), the markers are processed in parallel.
+   *
+   * @ingroup BTKBasicFilters
+   */
+  
+  /**
+   * @enum MarkerGapFillingFilter::InterpolationMethod
+   * Method used to interpolate the gaps.
+   */
+  /**
+   * @var MarkerGapFillingFilter::InterpolationMethod MarkerGapFillingFilter::Linear
+   * Linear interpolation between the frames surrounding the gap.
+   */
+  /**
+   * @var MarkerGapFillingFilter::InterpolationMethod MarkerGapFillingFilter::Cubic
+   * Natural cubic spline.
+   */
+  /**
+   * @var MarkerGapFillingFilter::InterpolationMethod MarkerGapFillingFilter::PCHIP
+   * Piecewise Cubic Hermite Interpolating Polynomial (no overshoot).
+   */
+  
+  /**
+   * @typedef MarkerGapFillingFilter::Pointer
+   * Smart pointer associated with a MarkerGapFillingFilter object.
+   */
+  
+  /**
+   * @typedef MarkerGapFillingFilter::ConstPointer
+   * Smart pointer associated with a const MarkerGapFillingFilter object.
+   */
+  
+  /**
+   * @fn static Pointer MarkerGapFillingFilter::New();
+   * Creates a smart pointer associated with a MarkerGapFillingFilter object.
+   */
+  
+  /**
+   * @fn Acquisition::Pointer MarkerGapFillingFilter::GetInput()
+   * Gets the input registered with this process.
+   */
+
+  /**
+   * @fn void MarkerGapFillingFilter::SetInput(Acquisition::Pointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn Acquisition::Pointer MarkerGapFillingFilter::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * @fn InterpolationMethod MarkerGapFillingFilter::GetInterpolationMethod() const
+   * Returns the method used to interpolate the gaps.
+   */
+  
+  /**
+   * Sets the method used to interpolate the gaps (PCHIP by default).
+   */
+  void MarkerGapFillingFilter::SetInterpolationMethod(InterpolationMethod method)
+  {
+    if (this->m_Method == method)
+      return;
+    this->m_Method = method;
+    this->Modified();
+  };
+  
+  /**
+   * @fn int MarkerGapFillingFilter::GetMaxGap() const
+   * Returns the maximum number of frames of the gaps to interpolate. The value -1 means the maximum interpolation gap of the input.
+   */
+  
+  /**
+   * Sets the maximum number of frames of the gaps to interpolate. 
+   * The value -1 (default) means the maximum interpolation gap of the input (see Acquisition::GetMaxInterpolationGap()).
+   */
+  void MarkerGapFillingFilter::SetMaxGap(int gap)
+  {
+    if (gap < -1)
+    {
+      btkErrorMacro("Invalid maximum gap.");
+      return;
+    }
+    if (this->m_MaxGap == gap)
+      return;
+    this->m_MaxGap = gap;
+    this->Modified();
+  };
+  
+  /**
+   * @fn const std::list< std::vector<std::string> >& MarkerGapFillingFilter::GetClusters() const
+   * Returns the clusters of markers used to reconstruct the occluded frames.
+   */
+  
+  /**
+   * Adds a cluster of markers assumed to move as a rigid body. The remaining occluded frames of each marker are 
+   * reconstructed from the other markers of the cluster. A cluster must contain at least 4 markers.
+   */
+  void MarkerGapFillingFilter::AddCluster(const std::vector<std::string>& labels)
+  {
+    if (labels.size() < 4)
+    {
+      btkErrorMacro("A cluster must contain at least 4 markers.");
+      return;
+    }
+    this->m_Clusters.push_back(labels);
+    this->Modified();
+  };
+  
+  /**
+   * Removes all the clusters.
+   */
+  void MarkerGapFillingFilter::ClearClusters()
+  {
+    if (this->m_Clusters.empty())
+      return;
+    this->m_Clusters.clear();
+    this->Modified();
+  };
+  
+  /**
+   * @fn bool MarkerGapFillingFilter::GetInPlace() const
+   * Returns the state of the in-place mode.
+   */
+  
+  /**
+   * Enables or disables the in-place mode (disabled by default). 
+   * When enabled, the markers of the input are directly filled instead of being cloned.
+   */
+  void MarkerGapFillingFilter::SetInPlace(bool enabled)
+  {
+    if (this->m_InPlace == enabled)
+      return;
+    this->m_InPlace = enabled;
+    this->Modified();
+  };
+  
+  /**
+   * @fn int MarkerGapFillingFilter::GetInterpolatedFrameNumber() const
+   * Returns the number of frames interpolated during the last update (all the markers).
+   */
+  
+  /**
+   * @fn int MarkerGapFillingFilter::GetReconstructedFrameNumber() const
+   * Returns the number of frames reconstructed from the clusters during the last update (all the markers).
+   */
+  
+  /**
+   * @fn int MarkerGapFillingFilter::GetFilledFrameNumber() const
+   * Returns the number of frames filled during the last update (all the markers).
+   */
+  
+  /**
+   * Returns the number of frames filled during the last update for the marker with the given @a label.
+   */
+  int MarkerGapFillingFilter::GetFilledFrameNumber(const std::string& label) const
+  {
+    std::map<std::string, int>::const_iterator it = this->m_FilledFrameNumbers.find(label);
+    return (it != this->m_FilledFrameNumbers.end()) ? it->second : 0;
+  };
+  
+  /**
+   * Constructor. 
+   * Sets the number of inputs and outputs to 1.
+   */
+  MarkerGapFillingFilter::MarkerGapFillingFilter()
+  : ProcessObject(), m_Clusters(), m_FilledFrameNumbers()
+  {
+    this->m_Method = PCHIP;
+    this->m_MaxGap = -1;
+    this->m_InPlace = false;
+    this->m_InterpolatedFrameNumber = 0;
+    this->m_ReconstructedFrameNumber = 0;
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+  };
+  
+  /**
+   * @fn Acquisition::Pointer MarkerGapFillingFilter::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn Acquisition::Pointer MarkerGapFillingFilter::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates an Acquisition:Pointer object and return it as a DataObject::Pointer.
+   */
+  DataObject::Pointer MarkerGapFillingFilter::MakeOutput(int /* idx */)
+  {
+    return Acquisition::New();
+  };
+  
+  /**
+   * Generates the outputs' data.
+   */
+  void MarkerGapFillingFilter::GenerateData()
+  {
+    Acquisition::Pointer output = this->GetOutput();
+    output->Reset();
+    this->m_InterpolatedFrameNumber = 0;
+    this->m_ReconstructedFrameNumber = 0;
+    this->m_FilledFrameNumbers.clear();
+    
+    Acquisition::Pointer input = this->GetInput();
+    if (!input)
+      return;
+    const int maxGap = (this->m_MaxGap == -1) ? input->GetMaxInterpolationGap() : this->m_MaxGap;
+    
+    // Gaps of each marker
+    PointCollection::Pointer points = this->m_InPlace ? input->GetPoints() : PointCollection::New();
+    std::vector<Point::ConstPointer> markers;
+    std::vector<MarkerGapFillingJob> jobs;
+    std::map<std::string, int> indices; // Label -> index in 'markers'
+    for (Acquisition::PointIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it)
+    {
+      Point::Pointer point = *it;
+      if (point->GetType() == Point::Marker)
+      {
+        MarkerGapFillingJob job;
+        job.gaps = point->GetOcclusionMask().GetGaps();
+        if (!job.gaps.empty())
+        {
+          if (!this->m_InPlace)
+            point = point->Clone();
+          // Detached from the input and unpacked before the parallel regions: the jobs then only write in their own values.
+          point->GetValues();
+          point->GetResiduals();
+          job.point = point;
+          job.interpolated = 0;
+          job.reconstructed = 0;
+          jobs.push_back(job);
+          markers.push_back(point);
+        }
+        else
+          markers.push_back(point);
+        indices[point->GetLabel()] = static_cast<int>(markers.size()) - 1;
+      }
+      if (!this->m_InPlace)
+        points->InsertItem(point);
+    }
+    
+    // Interpolation
+    const int num = static_cast<int>(jobs.size());
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0 ; i < num ; ++i)
+      InterpolateMarkerGaps(&(jobs[i]), maxGap, this->m_Method);
+    
+    // Reconstruction with the clusters
+    if (!this->m_Clusters.empty() && (num != 0))
+    {
+      std::vector< std::vector<int> > clusters;
+      for (std::list< std::vector<std::string> >::const_iterator it = this->m_Clusters.begin() ; it != this->m_Clusters.end() ; ++it)
+      {
+        std::vector<int> cluster;
+        for (size_t m = 0 ; m < it->size() ; ++m)
+        {
+          std::map<std::string, int>::const_iterator itI = indices.find((*it)[m]);
+          if (itI != indices.end())
+            cluster.push_back(itI->second);
+          else
+          {
+            btkWarningMacro("Unknown marker in a cluster: " + (*it)[m]);
+          }
+        }
+        clusters.push_back(cluster);
+      }
+      // Visible frames after the interpolation. Not modified during the reconstruction.
+      std::vector<OcclusionMask> visible;
+      visible.reserve(markers.size());
+      for (size_t m = 0 ; m < markers.size() ; ++m)
+        visible.push_back(markers[m]->GetOcclusionMask());
+      std::vector<int> jobIndices(num);
+      for (int i = 0 ; i < num ; ++i)
+      {
+        jobIndices[i] = indices[jobs[i].point->GetLabel()];
+        for (size_t c = 0 ; c < clusters.size() ; ++c)
+        {
+          if (std::find(clusters[c].begin(), clusters[c].end(), jobIndices[i]) != clusters[c].end())
+            jobs[i].clusters.push_back(static_cast<int>(c));
+        }
+      }
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+      for (int i = 0 ; i < num ; ++i)
+      {
+        if (!jobs[i].clusters.empty())
+          ReconstructMarkerGaps(&(jobs[i]), clusters, markers, visible, jobIndices[i]);
+      }
+    }
+    
+    for (int i = 0 ; i < num ; ++i)
+    {
+      this->m_InterpolatedFrameNumber += jobs[i].interpolated;
+      this->m_ReconstructedFrameNumber += jobs[i].reconstructed;
+      this->m_FilledFrameNumbers[jobs[i].point->GetLabel()] = jobs[i].interpolated + jobs[i].reconstructed;
+    }
+    
+    output->SetFirstFrame(input->GetFirstFrame());
+    output->SetPointFrequency(input->GetPointFrequency());
+    output->SetAnalogResolution(input->GetAnalogResolution());
+    output->SetPointUnits(input->GetPointUnits());
+    output->SetMaxInterpolationGap(input->GetMaxInterpolationGap());
+    output->SetEvents(input->GetEvents());
+    output->SetMetaData(input->GetMetaData());
+    output->SetPoints(points);
+    output->SetAnalogs(input->GetAnalogs());
+    // To set internal variables
+    output->Resize(input->GetPointNumber(), input->GetPointFrameNumber(), input->GetAnalogNumber(), input->GetNumberAnalogSamplePerFrame());
+  };
+};
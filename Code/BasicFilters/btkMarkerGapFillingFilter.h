@@ -0,0 +1,104 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkMarkerGapFillingFilter_h
+#define __btkMarkerGapFillingFilter_h
+
+#include "btkProcessObject.h"
+#include "btkAcquisition.h"
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace btk
+{
+  class MarkerGapFillingFilter : public ProcessObject
+  {
+  public:
+    typedef enum {Linear = 0, Cubic, PCHIP} InterpolationMethod;
+    
+    typedef btkSharedPtr<MarkerGapFillingFilter> Pointer;
+    typedef btkSharedPtr<const MarkerGapFillingFilter> ConstPointer;
+    
+    static Pointer New() {return Pointer(new MarkerGapFillingFilter());};
+    
+    // ~MarkerGapFillingFilter(); // Implicit
+    
+    Acquisition::Pointer GetInput() {return this->GetInput(0);};
+    void SetInput(Acquisition::Pointer input) {this->SetNthInput(0, input);};
+    Acquisition::Pointer GetOutput() {return this->GetOutput(0);};
+    
+    InterpolationMethod GetInterpolationMethod() const {return this->m_Method;};
+    BTK_BASICFILTERS_EXPORT void SetInterpolationMethod(InterpolationMethod method);
+    int GetMaxGap() const {return this->m_MaxGap;};
+    BTK_BASICFILTERS_EXPORT void SetMaxGap(int gap = -1);
+    
+    const std::list< std::vector<std::string> >& GetClusters() const {return this->m_Clusters;};
+    BTK_BASICFILTERS_EXPORT void AddCluster(const std::vector<std::string>& labels);
+    BTK_BASICFILTERS_EXPORT void ClearClusters();
+    
+    bool GetInPlace() const {return this->m_InPlace;};
+    BTK_BASICFILTERS_EXPORT void SetInPlace(bool enabled);
+    
+    int GetInterpolatedFrameNumber() const {return this->m_InterpolatedFrameNumber;};
+    int GetReconstructedFrameNumber() const {return this->m_ReconstructedFrameNumber;};
+    int GetFilledFrameNumber() const {return this->m_InterpolatedFrameNumber + this->m_ReconstructedFrameNumber;};
+    BTK_BASICFILTERS_EXPORT int GetFilledFrameNumber(const std::string& label) const;
+    
+  protected:
+    BTK_BASICFILTERS_EXPORT MarkerGapFillingFilter();
+    
+    Acquisition::Pointer GetInput(int idx) {return static_pointer_cast<Acquisition>(this->GetNthInput(idx));};
+    Acquisition::Pointer GetOutput(int idx) {return static_pointer_cast<Acquisition>(this->GetNthOutput(idx));};
+    BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
+    BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    
+  private:
+    MarkerGapFillingFilter(const MarkerGapFillingFilter& ); // Not implemented.
+    MarkerGapFillingFilter& operator=(const MarkerGapFillingFilter& ); // Not implemented.
+    
+    InterpolationMethod m_Method;
+    int m_MaxGap;
+    std::list< std::vector<std::string> > m_Clusters;
+    bool m_InPlace;
+    int m_InterpolatedFrameNumber;
+    int m_ReconstructedFrameNumber;
+    std::map<std::string, int> m_FilledFrameNumbers;
+  };
+};
+
+#endif // __btkMarkerGapFillingFilter_h
@@ -219,7 +219,7 @@ namespace btk
     int inc = 0;
     for (typename Collection<T>::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
     {
-      output->GetValues().row(inc) = (*it)->GetValues().row(index);
+      output->GetValues().row(inc) = static_cast<const T*>(it->get())->GetValues().row(index); // Read-only access to not copy the shared values
       ++inc;
     }
   };  
@@ -522,17 +522,20 @@ namespace btk
     else
       startFrame = output->GetFirstFrame() - 1;
     
+    // The input is only read with the const accessors to not copy the values shared with other objects.
     for (Acquisition::PointIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it)
     {
-      Point::Pointer p = *(output->FindPoint((*it)->GetLabel()));
-      p->GetValues().block(startFrame, 0, oldInputNumFrames, 3) = (*it)->GetValues().block(startFrame, 0, oldInputNumFrames, 3);
-      p->GetResiduals().block(startFrame, 0, oldInputNumFrames, 1) = (*it)->GetResiduals().block(startFrame, 0, oldInputNumFrames, 1);
+      Point::ConstPointer in = *it;
+      Point::Pointer p = *(output->FindPoint(in->GetLabel()));
+      p->GetValues().block(startFrame, 0, oldInputNumFrames, 3) = in->GetValues().block(startFrame, 0, oldInputNumFrames, 3);
+      p->GetResiduals().block(startFrame, 0, oldInputNumFrames, 1) = in->GetResiduals().block(startFrame, 0, oldInputNumFrames, 1);
     }
     // Analog
     for (Acquisition::AnalogIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
     {
-      Analog::Pointer ac = *(output->FindAnalog((*it)->GetLabel()));
-      ac->GetValues().block(startFrame * input->GetNumberAnalogSamplePerFrame(), 0, oldInputNumFrames * input->GetNumberAnalogSamplePerFrame(), 1) = (*it)->GetValues().block(startFrame * input->GetNumberAnalogSamplePerFrame(), 0, oldInputNumFrames * input->GetNumberAnalogSamplePerFrame(), 1);
+      Analog::ConstPointer in = *it;
+      Analog::Pointer ac = *(output->FindAnalog(in->GetLabel()));
+      ac->GetValues().block(startFrame * input->GetNumberAnalogSamplePerFrame(), 0, oldInputNumFrames * input->GetNumberAnalogSamplePerFrame(), 1) = in->GetValues().block(startFrame * input->GetNumberAnalogSamplePerFrame(), 0, oldInputNumFrames * input->GetNumberAnalogSamplePerFrame(), 1);
     }
   };
   
@@ -0,0 +1,279 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkPolyphaseResampler.h"
+#include "btkLogger.h"
+
+#include <Eigen/Core>
+
+#include <cmath>
+
+#ifndef M_PI
+  #define M_PI 3.14159265358979323846
+#endif
+
+namespace btk
+{
+  // Greatest common divisor.
+  static int ComputeResamplerGCD(int a, int b)
+  {
+    while (b != 0)
+    {
+      int r = a % b;
+      a = b;
+      b = r;
+    }
+    return a;
+  };
+  
+  // Modified Bessel function of the first kind (order 0) used by the Kaiser window.
+  static double ComputeResamplerBesselI0(double x)
+  {
+    double sum = 1.0, term = 1.0;
+    const double y = x * x / 4.0;
+    for (int k = 1 ; k < 50 ; ++k)
+    {
+      term *= y / static_cast<double>(k * k);
+      sum += term;
+      if (term < sum * 1.0e-16)
+        break;
+    }
+    return sum;
+  };
+  
+  /**
+   * @class PolyphaseResampler btkPolyphaseResampler.h
+   * @brief Rational resampling (up/down) of sampled signals with a polyphase anti-aliasing FIR filter.
+   *
+   * The resampler is the equivalent of an upsampling by the factor @a up (zero insertion), 
+   * followed by a lowpass FIR filter and a downsampling by the factor @a down.
+   * Only the non-null products are computed using the polyphase decomposition of the filter. 
+   * The output has then a sample frequency equals to <tt>input frequency * up / down</tt>.
+   *
+   * The FIR filter is a windowed sinc (Kaiser window, beta = 5) with a cutoff frequency equals to the 
+   * smallest Nyquist frequency (input or output) and a half length of <tt>10 * max(up, down)</tt> samples 
+   * at the upsampled frequency. The group delay of the filter is compensated: the first output sample 
+   * is aligned on the first input sample.
+   * 
+   * The filter is designed only once, when the factors are set. Each phase of the filter is stored 
+   * reversed and padded to the same number of taps, so the inner loop is a dot product between two 
+   * contiguous arrays computed (and vectorized) by Eigen.
+   * The signal is extended at both ends by repeating its first and last value to limit the edge effects.
+   *
+   * When BTK is compiled with OpenMP (option BTK_USE_OPENMP), the channels given to the method 
+   * Apply(const std::vector<const double*>&, const std::vector<int>&, const std::vector<double*>&) are resampled in parallel.
+   *
+   * @ingroup BTKBasicFilters
+   */
+  
+  /**
+   * Constructor. The factors @a up and @a down are reduced by their greatest common divisor.
+   * If they are not valid (i.e. null or negative), then the resampler is set as identity (1/1).
+   */
+  PolyphaseResampler::PolyphaseResampler(int up, int down)
+  : m_Bank()
+  {
+    this->m_Up = 1;
+    this->m_Down = 1;
+    this->m_HalfLength = 0;
+    this->m_TapNumber = 1;
+    this->m_TapPerPhaseNumber = 1;
+    this->m_Bank.resize(1, 1.0);
+    this->SetFactors(up, down);
+  };
+  
+  /**
+   * @fn int PolyphaseResampler::GetUpFactor() const
+   * Returns the (reduced) upsampling factor.
+   */
+  
+  /**
+   * @fn int PolyphaseResampler::GetDownFactor() const
+   * Returns the (reduced) downsampling factor.
+   */
+  
+  /**
+   * Sets the upsampling and downsampling factors and designs the filter.
+   * Both factors are reduced by their greatest common divisor.
+   * Returns false (and does not modify the resampler) if one of the factors is null or negative.
+   */
+  bool PolyphaseResampler::SetFactors(int up, int down)
+  {
+    if ((up <= 0) || (down <= 0))
+    {
+      btkErrorMacro("The resampling factors must be strictly positive.");
+      return false;
+    }
+    const int gcd = ComputeResamplerGCD(up, down);
+    up /= gcd;
+    down /= gcd;
+    if ((this->m_Up == up) && (this->m_Down == down))
+      return true;
+    this->m_Up = up;
+    this->m_Down = down;
+    this->Design();
+    return true;
+  };
+  
+  /**
+   * @fn int PolyphaseResampler::GetTapNumber() const
+   * Returns the number of coefficients of the anti-aliasing filter (before its polyphase decomposition).
+   */
+  
+  /**
+   * Returns the number of samples produced for a signal with @a inputSampleNumber samples 
+   * (i.e. <tt>ceil(inputSampleNumber * up / down)</tt>).
+   */
+  int PolyphaseResampler::GetOutputSampleNumber(int inputSampleNumber) const
+  {
+    if (inputSampleNumber <= 0)
+      return 0;
+    const long long num = static_cast<long long>(inputSampleNumber) * this->m_Up;
+    return static_cast<int>((num + this->m_Down - 1) / this->m_Down);
+  };
+  
+  /**
+   * Resamples the signal @a input which contains @a inputSampleNumber samples.
+   * The array @a output must be already allocated with the number of samples given by GetOutputSampleNumber().
+   */
+  void PolyphaseResampler::Apply(const double* input, int inputSampleNumber, double* output) const
+  {
+    const int outputSampleNumber = this->GetOutputSampleNumber(inputSampleNumber);
+    if (outputSampleNumber == 0)
+      return;
+    if ((this->m_Up == 1) && (this->m_Down == 1))
+    {
+      for (int i = 0 ; i < inputSampleNumber ; ++i)
+        output[i] = input[i];
+      return;
+    }
+    const int taps = this->m_TapPerPhaseNumber;
+    // Extended signal: the index of the last input sample used by the last output sample gives the right padding.
+    const long long lastIndex = (static_cast<long long>(outputSampleNumber - 1) * this->m_Down + this->m_HalfLength) / this->m_Up;
+    const int padLeft = taps - 1;
+    const int padRight = (lastIndex > inputSampleNumber - 1) ? static_cast<int>(lastIndex - (inputSampleNumber - 1)) : 0;
+    std::vector<double> extended(padLeft + inputSampleNumber + padRight);
+    for (int i = 0 ; i < padLeft ; ++i)
+      extended[i] = input[0];
+    for (int i = 0 ; i < inputSampleNumber ; ++i)
+      extended[padLeft + i] = input[i];
+    for (int i = 0 ; i < padRight ; ++i)
+      extended[padLeft + inputSampleNumber + i] = input[inputSampleNumber - 1];
+    const double* bank = &(this->m_Bank[0]);
+    const double* signal = &(extended[0]);
+    long long t = this->m_HalfLength;
+    for (int n = 0 ; n < outputSampleNumber ; ++n)
+    {
+      const int phase = static_cast<int>(t % this->m_Up);
+      const long long base = t / this->m_Up; // Index of the most recent input sample (without padding).
+      const double* coefs = bank + phase * taps;
+      const double* samples = signal + base; // (base + padLeft) - (taps - 1)
+      output[n] = Eigen::Map<const Eigen::VectorXd>(coefs, taps).dot(Eigen::Map<const Eigen::VectorXd>(samples, taps));
+      t += this->m_Down;
+    }
+  };
+  
+  /**
+   * Resamples several signals (one by element of @a inputs). The number of samples of each signal is given by @a inputSampleNumbers.
+   * Each output must be already allocated with the number of samples given by GetOutputSampleNumber().
+   * The three vectors must have the same size.
+   */
+  void PolyphaseResampler::Apply(const std::vector<const double*>& inputs, const std::vector<int>& inputSampleNumbers, const std::vector<double*>& outputs) const
+  {
+    if ((inputs.size() != inputSampleNumbers.size()) || (inputs.size() != outputs.size()))
+    {
+      btkErrorMacro("The number of inputs, sample numbers and outputs must be the same.");
+      return;
+    }
+    const int num = static_cast<int>(inputs.size());
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0 ; i < num ; ++i)
+      this->Apply(inputs[i], inputSampleNumbers[i], outputs[i]);
+  };
+  
+  /**
+   * Designs the windowed sinc filter and stores its polyphase decomposition.
+   */
+  void PolyphaseResampler::Design()
+  {
+    if ((this->m_Up == 1) && (this->m_Down == 1))
+    {
+      this->m_HalfLength = 0;
+      this->m_TapNumber = 1;
+      this->m_TapPerPhaseNumber = 1;
+      this->m_Bank.assign(1, 1.0);
+      return;
+    }
+    const int maxFactor = (this->m_Up > this->m_Down) ? this->m_Up : this->m_Down;
+    const double beta = 5.0;
+    const double fc = 1.0 / static_cast<double>(maxFactor); // Relative to the Nyquist frequency of the upsampled signal.
+    this->m_HalfLength = 10 * maxFactor;
+    this->m_TapNumber = 2 * this->m_HalfLength + 1;
+    std::vector<double> h(this->m_TapNumber);
+    const double i0Beta = ComputeResamplerBesselI0(beta);
+    for (int k = 0 ; k < this->m_TapNumber ; ++k)
+    {
+      const double x = static_cast<double>(k - this->m_HalfLength);
+      const double r = x / static_cast<double>(this->m_HalfLength);
+      const double window = ComputeResamplerBesselI0(beta * std::sqrt(1.0 - r * r)) / i0Beta;
+      const double arg = M_PI * fc * x;
+      const double sinc = (k == this->m_HalfLength) ? 1.0 : std::sin(arg) / arg;
+      h[k] = fc * sinc * window;
+    }
+    // Polyphase decomposition: the phase p uses the coefficients h[p + j * up] with the input samples x[base - j].
+    // Each phase is reversed and padded with zeros at its beginning. 
+    // Each phase is also normalized to have a unit gain at DC, so a constant signal is kept exactly.
+    this->m_TapPerPhaseNumber = (this->m_TapNumber + this->m_Up - 1) / this->m_Up;
+    this->m_Bank.assign(this->m_Up * this->m_TapPerPhaseNumber, 0.0);
+    for (int p = 0 ; p < this->m_Up ; ++p)
+    {
+      double* phase = &(this->m_Bank[p * this->m_TapPerPhaseNumber]);
+      double sum = 0.0;
+      for (int j = 0 ; j < this->m_TapPerPhaseNumber ; ++j)
+      {
+        const int k = p + j * this->m_Up;
+        if (k < this->m_TapNumber)
+        {
+          phase[this->m_TapPerPhaseNumber - 1 - j] = h[k];
+          sum += h[k];
+        }
+      }
+      for (int j = 0 ; j < this->m_TapPerPhaseNumber ; ++j)
+        phase[j] /= sum;
+    }
+  };
+};
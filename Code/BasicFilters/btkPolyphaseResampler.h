@@ -0,0 +1,74 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkPolyphaseResampler_h
+#define __btkPolyphaseResampler_h
+
+#include "btkConfigure.h"
+
+#include <vector>
+
+namespace btk
+{
+  class PolyphaseResampler
+  {
+  public:
+    BTK_BASICFILTERS_EXPORT PolyphaseResampler(int up = 1, int down = 1);
+    // ~PolyphaseResampler(); // Implicit
+    // PolyphaseResampler(const PolyphaseResampler& toCopy); // Implicit
+    // PolyphaseResampler& operator=(const PolyphaseResampler& toCopy); // Implicit
+    
+    int GetUpFactor() const {return this->m_Up;};
+    int GetDownFactor() const {return this->m_Down;};
+    BTK_BASICFILTERS_EXPORT bool SetFactors(int up, int down);
+    int GetTapNumber() const {return this->m_TapNumber;};
+    
+    BTK_BASICFILTERS_EXPORT int GetOutputSampleNumber(int inputSampleNumber) const;
+    BTK_BASICFILTERS_EXPORT void Apply(const double* input, int inputSampleNumber, double* output) const;
+    BTK_BASICFILTERS_EXPORT void Apply(const std::vector<const double*>& inputs, const std::vector<int>& inputSampleNumbers, const std::vector<double*>& outputs) const;
+    
+  private:
+    void Design();
+    
+    int m_Up;
+    int m_Down;
+    int m_HalfLength;
+    int m_TapNumber;
+    int m_TapPerPhaseNumber;
+    std::vector<double> m_Bank;
+  };
+};
+
+#endif // __btkPolyphaseResampler_h
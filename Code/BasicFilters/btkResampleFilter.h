@@ -0,0 +1,506 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkResampleFilter_h
+#define __btkResampleFilter_h
+
+#include "btkProcessObject.h"
+#include "btkCollection.h"
+#include "btkLogger.h"
+#include "btkAnalogCollection.h"
+#include "btkPointCollection.h"
+#include "btkWrenchCollection.h"
+#include "btkPolyphaseResampler.h"
+
+#include <vector>
+#include <list>
+#include <algorithm>
+
+namespace btk
+{
+  template <class T>
+  class ResampleFilter : public ProcessObject
+  {
+  public:
+    typedef btkSharedPtr<ResampleFilter> Pointer;
+    typedef btkSharedPtr<const ResampleFilter> ConstPointer;
+       
+    typedef typename T::Pointer ItemPointer;
+    typedef typename T::ConstPointer ItemConstPointer;    
+    
+    static Pointer New() {return Pointer(new ResampleFilter());};
+    
+    virtual ~ResampleFilter() {};
+    
+    ItemPointer GetInput() {return this->GetInput(0);};
+    void SetInput(ItemPointer input) {this->SetNthInput(0, input);};
+    ItemPointer GetOutput() {return this->GetOutput(0);};
+    
+    int GetUpFactor() const {return this->m_Resampler.GetUpFactor();};
+    int GetDownFactor() const {return this->m_Resampler.GetDownFactor();};
+    void SetFactors(int up, int down);
+    
+  protected:
+    ResampleFilter();
+    
+    ItemPointer GetInput(int idx) {return static_pointer_cast<T>(this->GetNthInput(idx));};
+    ItemPointer GetOutput(int idx) {return static_pointer_cast<T>(this->GetNthOutput(idx));};
+    virtual DataObject::Pointer MakeOutput(int idx);
+    virtual void GenerateData();
+    
+  private:
+    ResampleFilter(const ResampleFilter& ); // Not implemented.
+    ResampleFilter& operator=(const ResampleFilter& ); // Not implemented.
+    
+    PolyphaseResampler m_Resampler;
+  };
+  
+  /**
+   * @class ResampleFilter btkResampleFilter.h
+   * @brief Resample data stored in the given input with a rational ratio (up/down).
+   * @tparam T Must be a class inheriting of btk::DataObject
+   *
+   * To resample data, you need to set the upsampling and downsampling factors using the method SetFactors().
+   * The sample frequency of the output is then equal to <tt>input frequency * up / down</tt>. For example, 
+   * to resample analog channels recorded at 2000 Hz to 120 Hz, you can use the factors 120 and 2000 (reduced internally to 3/50).
+   * The number of frames of the output is <tt>ceil(input frame number * up / down)</tt> and its first frame is aligned on the first frame of the input.
+   *
+   * Contrary to the class DownsampleFilter, the signals are lowpass filtered before to be decimated to avoid aliasing. 
+   * The anti-aliasing filter is designed only once for all the channels (see the class PolyphaseResampler for the details).
+   * When BTK is compiled with OpenMP (option BTK_USE_OPENMP), the channels of a collection are resampled in parallel.
+   *
+   * For the points, the residuals are not filtered. The residual of an output frame is the residual of the nearest input frame 
+   * and the frame is set as occluded (residual equals to -1 and null coordinates) if one of its two surrounding input frames is occluded. 
+   * To not pull the frames next to a gap toward the null coordinates of the occluded frames, each gap is linearly interpolated 
+   * (in a copy of the coordinates) before the filtering. A gap at the beginning or at the end of the point is filled with the nearest visible frame.
+   * The interpolated frames are only used by the filter and stay occluded in the output. To really fill the gaps, 
+   * use the class MarkerGapFillingFilter before to resample the points.
+   *
+   * Note: This class require specialization for each kind of class. At this moment, only the specialization of the following classes are implemented:
+   *         - btk::Analog
+   *         - btk::AnalogCollection
+   *         - btk::Point
+   *         - btk::PointCollection
+   *         - btk::Wrench
+   *         - btk::WrenchCollection
+   *
+   * @ingroup BTKBasicFilters
+   */
+  
+  /**
+   * @typedef ResampleFilter<T>::Pointer
+   * Smart pointer associated with a ResampleFilter object.
+   */
+  
+  /**
+   * @typedef ResampleFilter<T>::ConstPointer
+   * Smart pointer associated with a const ResampleFilter object.
+   */
+  
+  /**
+   * @typedef ResampleFilter<T>::ItemPointer
+   * Smart pointer associated with a T object.
+   */
+  
+  /**
+   * @typedef ResampleFilter<T>::ItemConstPointer
+   * Smart const pointer associated with a T object.
+   */
+  
+  /**
+   * @fn template <class T> static Pointer ResampleFilter<T>::New();
+   * Creates a smart pointer associated with a ResampleFilter<T> object.
+   */
+  
+  /**
+   * @fn template <class T> virtual ResampleFilter<T>::~ResampleFilter()
+   * Empty destructor.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer ResampleFilter<T>::GetInput()
+   * Gets the input registered with this process.
+   */
+  
+  /**
+   * @fn template <class T> void ResampleFilter<T>::SetInput(ItemPointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer ResampleFilter<T>::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * @fn template <class T> int ResampleFilter<T>::GetUpFactor() const
+   * Gets the (reduced) upsampling factor.
+   */
+  
+  /**
+   * @fn template <class T> int ResampleFilter<T>::GetDownFactor() const
+   * Gets the (reduced) downsampling factor.
+   */
+  
+  /**
+   * Sets the upsampling and downsampling factors. Both are reduced by their greatest common divisor.
+   * Null or negative factors are rejected with an error message.
+   */
+  template <class T>
+  void ResampleFilter<T>::SetFactors(int up, int down)
+  {
+    const int oldUp = this->m_Resampler.GetUpFactor();
+    const int oldDown = this->m_Resampler.GetDownFactor();
+    if (!this->m_Resampler.SetFactors(up, down))
+      return;
+    if ((oldUp == this->m_Resampler.GetUpFactor()) && (oldDown == this->m_Resampler.GetDownFactor()))
+      return;
+    this->Modified();
+  };
+  
+  /**
+   * Constructor. Sets the number of inputs and outputs to 1.
+   */
+  template <class T>
+  ResampleFilter<T>::ResampleFilter()
+  : ProcessObject(), m_Resampler(1, 1)
+  {
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+  };
+  
+  /**
+   * @fn template <class T> ItemPointer ResampleFilter<T>::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn template <class T> ItemPointer ResampleFilter<T>::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates a T:Pointer object and return it as a DataObject::Pointer.
+   */
+  template <class T>
+  DataObject::Pointer ResampleFilter<T>::MakeOutput(int /* idx */)
+  {
+    return T::New();
+  };
+  
+  /**
+   * Generates the outputs' data.
+   */
+  template <class T>
+  void ResampleFilter<T>::GenerateData()
+  {
+    ItemPointer input = this->GetInput();
+    if (!input)
+      return;
+    ResampleData(this->m_Resampler, input, this->GetOutput());
+    this->GetOutput()->Modified();
+  };
+  
+  // Columns of measures to resample with the same PolyphaseResampler.
+  struct ResampleJobs
+  {
+    std::vector<const double*> inputs;
+    std::vector<int> sampleNumbers;
+    std::vector<double*> outputs;
+    std::list<Point::Values> buffers; // Copies of the points with gaps
+  };
+  
+  /**
+   * Generic method to register the columns to resample. Does nothing.
+   */
+  template <class T>
+  inline void PrepareResampleData(const PolyphaseResampler& resampler, btkSharedPtr<T> input, btkSharedPtr<T> output, ResampleJobs* jobs)
+  {
+    btkNotUsed(resampler);
+    btkNotUsed(input);
+    btkNotUsed(output);
+    btkNotUsed(jobs);
+    btkErrorMacro("Generic method. Please specialize it.");
+  };
+  
+  /**
+   * Generic method to finalize the resampled data. Does nothing.
+   */
+  template <class T>
+  inline void FinalizeResampleData(const PolyphaseResampler& resampler, btkSharedPtr<T> input, btkSharedPtr<T> output)
+  {
+    btkNotUsed(resampler);
+    btkNotUsed(input);
+    btkNotUsed(output);
+  };
+  
+  /**
+   * Generic method to resample data. The columns are registered with the function PrepareResampleData() 
+   * and resampled at once. The point residuals are computed by the function FinalizeResampleData().
+   */
+  template <class T>
+  inline void ResampleData(const PolyphaseResampler& resampler, btkSharedPtr<T> input, btkSharedPtr<T> output)
+  {
+    ResampleJobs jobs;
+    PrepareResampleData<T>(resampler, input, output, &jobs);
+    resampler.Apply(jobs.inputs, jobs.sampleNumbers, jobs.outputs);
+    FinalizeResampleData<T>(resampler, input, output);
+  };
+  
+  /**
+   * Registers the @a columnNumber columns of the matrix @a input (with @a inputFrameNumber rows) to be resampled in @a output.
+   */
+  inline void AppendResampleJobs(const PolyphaseResampler& resampler, const double* input, int inputFrameNumber, int columnNumber, double* output, ResampleJobs* jobs)
+  {
+    const int outputFrameNumber = resampler.GetOutputSampleNumber(inputFrameNumber);
+    for (int i = 0 ; i < columnNumber ; ++i)
+    {
+      jobs->inputs.push_back(input + i * inputFrameNumber);
+      jobs->sampleNumbers.push_back(inputFrameNumber);
+      jobs->outputs.push_back(output + i * outputFrameNumber);
+    }
+  };
+  
+  /**
+   * Specialized version to prepare the resampling of an analog channel.
+   */
+  template <>
+  inline void PrepareResampleData<Analog>(const PolyphaseResampler& resampler, Analog::Pointer input, Analog::Pointer output, ResampleJobs* jobs)
+  {
+    const int inFrameNumber = input->GetFrameNumber();
+    output->SetLabel(input->GetLabel());
+    output->SetDescription(input->GetDescription());
+    output->SetUnit(input->GetUnit());
+    output->SetGain(input->GetGain());
+    output->SetOffset(input->GetOffset());
+    output->SetScale(input->GetScale());
+    output->SetFrameNumber(resampler.GetOutputSampleNumber(inFrameNumber));
+    AppendResampleJobs(resampler, Analog::ConstPointer(input)->GetValues().data(), inFrameNumber, 1, output->GetValues().data(), jobs); // Read-only access to not copy the shared values
+  };
+  
+  /**
+   * Linearly interpolates the coordinates of the occluded frames given by @a mask. 
+   * The gaps at the beginning and at the end are filled with the nearest visible frame.
+   * The mask must have at least one visible frame.
+   */
+  inline void FillResampleGaps(const OcclusionMask& mask, Point::Values* values)
+  {
+    const int frameNumber = mask.GetFrameNumber();
+    const std::vector<OcclusionMask::Range>& gaps = mask.GetGaps();
+    for (std::vector<OcclusionMask::Range>::const_iterator it = gaps.begin() ; it != gaps.end() ; ++it)
+    {
+      const int before = it->start - 1;
+      const int after = it->start + it->length;
+      for (int i = 0 ; i < it->length ; ++i)
+      {
+        if (before < 0)
+          values->row(it->start + i) = values->row(after);
+        else if (after >= frameNumber)
+          values->row(it->start + i) = values->row(before);
+        else
+        {
+          const double w = static_cast<double>(i + 1) / static_cast<double>(it->length + 1);
+          values->row(it->start + i) = (1.0 - w) * values->row(before) + w * values->row(after);
+        }
+      }
+    }
+  };
+  
+  /**
+   * Specialized version to prepare the resampling of a point.
+   * The gaps are linearly interpolated in a copy of the coordinates to not be used by the filter.
+   */
+  template <>
+  inline void PrepareResampleData<Point>(const PolyphaseResampler& resampler, Point::Pointer input, Point::Pointer output, ResampleJobs* jobs)
+  {
+    Point::ConstPointer in = input; // Read-only access to not copy the shared values
+    const int inFrameNumber = in->GetFrameNumber();
+    output->SetLabel(in->GetLabel());
+    output->SetDescription(in->GetDescription());
+    output->SetType(in->GetType());
+    output->SetFrameNumber(resampler.GetOutputSampleNumber(inFrameNumber));
+    const double* values = in->GetValues().data();
+    const OcclusionMask& mask = in->GetOcclusionMask();
+    if ((mask.GetOccludedFrameNumber() != 0) && (mask.GetValidFrameNumber() != 0))
+    {
+      jobs->buffers.push_back(in->GetValues());
+      FillResampleGaps(mask, &(jobs->buffers.back()));
+      values = jobs->buffers.back().data();
+    }
+    AppendResampleJobs(resampler, values, inFrameNumber, 3, output->GetValues().data(), jobs);
+  };
+  
+  /**
+   * Specialized version to set the residuals of a resampled point.
+   */
+  template <>
+  inline void FinalizeResampleData<Point>(const PolyphaseResampler& resampler, Point::Pointer input, Point::Pointer output)
+  {
+    Point::ConstPointer in = input; // Read-only access to not copy the shared values
+    const int inFrameNumber = in->GetFrameNumber();
+    const int outFrameNumber = output->GetFrameNumber();
+    const double* inResiduals = in->GetResiduals().data();
+    double* outResiduals = output->GetResiduals().data();
+    Point::Values& outValues = output->GetValues();
+    const int up = resampler.GetUpFactor();
+    const int down = resampler.GetDownFactor();
+    for (int i = 0 ; i < outFrameNumber ; ++i)
+    {
+      const long long t = static_cast<long long>(i) * down;
+      const int prev = static_cast<int>(t / up);
+      const int next = (t % up == 0) ? prev : std::min(prev + 1, inFrameNumber - 1);
+      if ((inResiduals[prev] < 0.0) || (inResiduals[next] < 0.0))
+      {
+        outResiduals[i] = -1.0;
+        outValues.row(i).setZero();
+      }
+      else
+        outResiduals[i] = (2 * (t % up) <= up) ? inResiduals[prev] : inResiduals[next];
+    }
+  };
+  
+  /**
+   * Specialized version to prepare the resampling of a wrench.
+   */
+  template <>
+  inline void PrepareResampleData<Wrench>(const PolyphaseResampler& resampler, Wrench::Pointer input, Wrench::Pointer output, ResampleJobs* jobs)
+  {
+    PrepareResampleData<Point>(resampler, input->GetPosition(), output->GetPosition(), jobs);
+    PrepareResampleData<Point>(resampler, input->GetForce(), output->GetForce(), jobs);
+    PrepareResampleData<Point>(resampler, input->GetMoment(), output->GetMoment(), jobs);
+  };
+  
+  /**
+   * Specialized version to set the residuals of a resampled wrench.
+   */
+  template <>
+  inline void FinalizeResampleData<Wrench>(const PolyphaseResampler& resampler, Wrench::Pointer input, Wrench::Pointer output)
+  {
+    FinalizeResampleData<Point>(resampler, input->GetPosition(), output->GetPosition());
+    FinalizeResampleData<Point>(resampler, input->GetForce(), output->GetForce());
+    FinalizeResampleData<Point>(resampler, input->GetMoment(), output->GetMoment());
+  };
+  
+  /**
+   * Specialized version to prepare the resampling of a collection of analog channels.
+   */
+  template <>
+  inline void PrepareResampleData<AnalogCollection>(const PolyphaseResampler& resampler, AnalogCollection::Pointer input, AnalogCollection::Pointer output, ResampleJobs* jobs)
+  {
+    output->SetItemNumber(input->GetItemNumber());
+    AnalogCollection::Iterator itIn = input->Begin();
+    AnalogCollection::Iterator itOut = output->Begin();
+    while (itIn != input->End())
+    {
+      if (*itOut == Analog::Null)
+        *itOut = Analog::New();
+      PrepareResampleData<Analog>(resampler, *itIn, *itOut, jobs);
+      ++itIn;
+      ++itOut;
+    }
+  };
+  
+  /**
+   * Specialized version to prepare the resampling of a collection of points.
+   */
+  template <>
+  inline void PrepareResampleData<PointCollection>(const PolyphaseResampler& resampler, PointCollection::Pointer input, PointCollection::Pointer output, ResampleJobs* jobs)
+  {
+    output->SetItemNumber(input->GetItemNumber());
+    PointCollection::Iterator itIn = input->Begin();
+    PointCollection::Iterator itOut = output->Begin();
+    while (itIn != input->End())
+    {
+      if (*itOut == Point::Null)
+        *itOut = Point::New();
+      PrepareResampleData<Point>(resampler, *itIn, *itOut, jobs);
+      ++itIn;
+      ++itOut;
+    }
+  };
+  
+  /**
+   * Specialized version to set the residuals of a collection of resampled points.
+   */
+  template <>
+  inline void FinalizeResampleData<PointCollection>(const PolyphaseResampler& resampler, PointCollection::Pointer input, PointCollection::Pointer output)
+  {
+    PointCollection::Iterator itIn = input->Begin();
+    PointCollection::Iterator itOut = output->Begin();
+    while (itIn != input->End())
+    {
+      FinalizeResampleData<Point>(resampler, *itIn, *itOut);
+      ++itIn;
+      ++itOut;
+    }
+  };
+  
+  /**
+   * Specialized version to prepare the resampling of a collection of wrenches.
+   */
+  template <>
+  inline void PrepareResampleData<WrenchCollection>(const PolyphaseResampler& resampler, WrenchCollection::Pointer input, WrenchCollection::Pointer output, ResampleJobs* jobs)
+  {
+    output->SetItemNumber(input->GetItemNumber());
+    WrenchCollection::Iterator itIn = input->Begin();
+    WrenchCollection::Iterator itOut = output->Begin();
+    while (itIn != input->End())
+    {
+      if (*itOut == Wrench::Null)
+        *itOut = Wrench::New((*itIn)->GetPosition()->GetLabel());
+      PrepareResampleData<Wrench>(resampler, *itIn, *itOut, jobs);
+      ++itIn;
+      ++itOut;
+    }
+  };
+  
+  /**
+   * Specialized version to set the residuals of a collection of resampled wrenches.
+   */
+  template <>
+  inline void FinalizeResampleData<WrenchCollection>(const PolyphaseResampler& resampler, WrenchCollection::Pointer input, WrenchCollection::Pointer output)
+  {
+    WrenchCollection::Iterator itIn = input->Begin();
+    WrenchCollection::Iterator itOut = output->Begin();
+    while (itIn != input->End())
+    {
+      FinalizeResampleData<Wrench>(resampler, *itIn, *itOut);
+      ++itIn;
+      ++itOut;
+    }
+  };
+};
+
+#endif // __btkResampleFilter_h
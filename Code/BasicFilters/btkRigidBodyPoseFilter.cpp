@@ -0,0 +1,431 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkRigidBodyPoseFilter.h"
+
+#include <Eigen/Eigenvalues>
+#include <Eigen/Geometry>
+
+#include <cmath>
+#include <map>
+
+namespace btk
+{
+  struct RigidBodyPoseJob
+  {
+    std::vector<Point::ConstPointer> markers; // Read only: a marker can be shared by several segments
+    Eigen::Matrix<double, 3, Eigen::Dynamic> local; // One column per marker (centered on the segment's origin)
+    Point::Pointer frame[4]; // Origin and 3 axes
+    bool valid;
+  };
+  
+  // Computes for every frame the least-squares rigid transformation mapping the local coordinates on the visible markers.
+  // The weighted sums are vectorized over the frames, only the final 3x3/4x4 kernels are computed frame by frame.
+  static void ComputeRigidBodyPose(RigidBodyPoseJob* job, double axisLength)
+  {
+    const int numFrames = job->frame[0]->GetFrameNumber();
+    const int numMarkers = static_cast<int>(job->markers.size());
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+      job->frame[i]->GetValues().setZero();
+      job->frame[i]->GetResiduals().setConstant(-1.0);
+    }
+    if (!job->valid)
+      return;
+    // Weights (1: visible, 0: occluded), centroids and cross-covariance terms (local x global) for every frame
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> w(numFrames, numMarkers);
+    Eigen::Matrix<double, Eigen::Dynamic, 3> cg = Eigen::Matrix<double, Eigen::Dynamic, 3>::Zero(numFrames, 3);
+    Eigen::Matrix<double, Eigen::Dynamic, 9> s = Eigen::Matrix<double, Eigen::Dynamic, 9>::Zero(numFrames, 9);
+    for (int j = 0 ; j < numMarkers ; ++j)
+    {
+      const Point::Values& values = job->markers[j]->GetValues();
+      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>::ColXpr wj = w.col(j);
+      wj.setOnes();
+      job->markers[j]->GetOcclusionMask().FillOccluded(wj, 0.0);
+      for (int b = 0 ; b < 3 ; ++b)
+      {
+        const Eigen::Array<double, Eigen::Dynamic, 1> wp = w.col(j).array() * values.col(b).array();
+        cg.col(b).array() += wp;
+        for (int a = 0 ; a < 3 ; ++a)
+          s.col(3*a+b).array() += job->local.coeff(a,j) * wp;
+      }
+    }
+    const Eigen::Matrix<double, Eigen::Dynamic, 1> count = w.rowwise().sum();
+    const Eigen::Matrix<double, Eigen::Dynamic, 3> cl = w * job->local.transpose();
+    
+    Point::Values& origin = job->frame[0]->GetValues();
+    for (int f = 0 ; f < numFrames ; ++f)
+    {
+      const double n = count.coeff(f);
+      if (n < 3.0)
+        continue;
+      const Eigen::Matrix<double, 3, 1> cgf = cg.row(f).transpose() / n;
+      const Eigen::Matrix<double, 3, 1> clf = cl.row(f).transpose() / n;
+      Eigen::Matrix<double, 3, 3> S;
+      for (int a = 0 ; a < 3 ; ++a)
+        for (int b = 0 ; b < 3 ; ++b)
+          S.coeffRef(a,b) = s.coeff(f, 3*a+b);
+      S -= n * clf * cgf.transpose();
+      // Horn's quaternion method
+      Eigen::Matrix<double, 4, 4> N;
+      N << S(0,0) + S(1,1) + S(2,2), S(1,2) - S(2,1), S(2,0) - S(0,2), S(0,1) - S(1,0),
+           S(1,2) - S(2,1), S(0,0) - S(1,1) - S(2,2), S(0,1) + S(1,0), S(2,0) + S(0,2),
+           S(2,0) - S(0,2), S(0,1) + S(1,0), -S(0,0) + S(1,1) - S(2,2), S(1,2) + S(2,1),
+           S(0,1) - S(1,0), S(2,0) + S(0,2), S(1,2) + S(2,1), -S(0,0) - S(1,1) + S(2,2);
+      Eigen::SelfAdjointEigenSolver< Eigen::Matrix<double, 4, 4> > eig(N);
+      const Eigen::Matrix<double, 4, 1>& ev = eig.eigenvalues(); // Increasing order
+      if ((ev.coeff(3) - ev.coeff(2)) <= 1e-9 * std::fabs(ev.coeff(3))) // Aligned markers: rotation not unique
+        continue;
+      const Eigen::Matrix<double, 4, 1> q = eig.eigenvectors().col(3);
+      const Eigen::Matrix<double, 3, 3> R = Eigen::Quaternion<double>(q.coeff(0), q.coeff(1), q.coeff(2), q.coeff(3)).toRotationMatrix();
+      const Eigen::Matrix<double, 3, 1> t = cgf - R * clf;
+      // Fitting error (RMS) of the visible markers
+      double err = 0.0;
+      for (int j = 0 ; j < numMarkers ; ++j)
+      {
+        if (w.coeff(f,j) != 0.0)
+          err += (R * job->local.col(j) + t - job->markers[j]->GetValues().row(f).transpose()).squaredNorm();
+      }
+      err = std::sqrt(err / n);
+      origin.row(f) = t.transpose();
+      job->frame[0]->GetResiduals().coeffRef(f) = err;
+      for (int i = 0 ; i < 3 ; ++i)
+      {
+        job->frame[i+1]->GetValues().row(f) = (t + axisLength * R.col(i)).transpose();
+        job->frame[i+1]->GetResiduals().coeffRef(f) = err;
+      }
+    }
+  };
+  
+  /**
+   * @class RigidBodyPoseFilter btkRigidBodyPoseFilter.h
+   * @brief Computes the pose of rigid segments from clusters of markers.
+   *
+   * Each segment is defined by a label and the labels of at least 3 markers assumed to move as a rigid body.
+   * For each frame, the pose of the segment is the least-squares rigid transformation (Horn's quaternion method)
+   * mapping the local coordinates of the markers on their measured positions. Only the visible markers 
+   * (positive residual) are used, so the pose remains available as long as 3 non-aligned markers are visible.
+   *
+   * The local coordinates of the markers can be given with the segment. Otherwise, they are extracted from 
+   * the reference frame (see SetReferenceFrame()): the origin of the segment is then the centroid of its markers
+   * and its axes are aligned with the global axes in this frame.
+   *
+   * The output is a collection of virtual reference frames using the same convention than the Plug-in Gait model.
+   * For each segment, 4 points are created: <label>O (origin), <label>A (first axis), <label>L (second axis)
+   * and <label>P (third axis). The axis points are located at the distance set by SetAxisLength() from the origin.
+   * The residuals of these points contain the RMS fitting error of the markers (-1 when the pose cannot be computed).
+   *
+   * The segments are processed in parallel when OpenMP is enabled.
+   *
+   * @ingroup BTKBasicFilters
+   */
+  
+  /**
+   * @struct RigidBodyPoseFilter::Segment
+   * @brief Definition of a rigid segment.
+   */
+  /**
+   * @var std::string RigidBodyPoseFilter::Segment::Label
+   * Label of the segment used as prefix for the generated points.
+   */
+  /**
+   * @var std::vector<std::string> RigidBodyPoseFilter::Segment::Markers
+   * Labels of the markers attached to the segment.
+   */
+  /**
+   * @var Eigen::Matrix<double, 3, Eigen::Dynamic> RigidBodyPoseFilter::Segment::LocalCoordinates
+   * Coordinates of the markers in the segment's frame (one column per marker). Empty to use the reference frame.
+   */
+  /**
+   * @fn RigidBodyPoseFilter::Segment::Segment(const std::string& label, const std::vector<std::string>& markers)
+   * Constructor. The local coordinates will be extracted from the reference frame.
+   */
+  /**
+   * @fn RigidBodyPoseFilter::Segment::Segment(const std::string& label, const std::vector<std::string>& markers, const Eigen::Matrix<double, 3, Eigen::Dynamic>& local)
+   * Constructor with the local coordinates of the markers.
+   */
+  
+  /**
+   * @typedef RigidBodyPoseFilter::Pointer
+   * Smart pointer associated with a RigidBodyPoseFilter object.
+   */
+  
+  /**
+   * @typedef RigidBodyPoseFilter::ConstPointer
+   * Smart pointer associated with a const RigidBodyPoseFilter object.
+   */
+  
+  /**
+   * @fn static Pointer RigidBodyPoseFilter::New();
+   * Creates a smart pointer associated with a RigidBodyPoseFilter object.
+   */
+  
+  /**
+   * @fn PointCollection::Pointer RigidBodyPoseFilter::GetInput()
+   * Gets the input registered with this process.
+   */
+
+  /**
+   * @fn void RigidBodyPoseFilter::SetInput(PointCollection::Pointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn PointCollection::Pointer RigidBodyPoseFilter::GetOutput()
+   * Gets the output created with this process.
+   */
+  
+  /**
+   * @fn void RigidBodyPoseFilter::AppendSegment(const std::string& label, const std::vector<std::string>& markers)
+   * Convenient method to append a segment which local coordinates are extracted from the reference frame.
+   */
+  
+  /**
+   * Appends a segment. The segment must contain at least 3 markers. If local coordinates are given,
+   * they must have one column per marker.
+   */
+  void RigidBodyPoseFilter::AppendSegment(const Segment& segment)
+  {
+    if (segment.Markers.size() < 3)
+    {
+      btkErrorMacro("A segment must contain at least 3 markers.");
+      return;
+    }
+    if ((segment.LocalCoordinates.cols() != 0) && (segment.LocalCoordinates.cols() != static_cast<int>(segment.Markers.size())))
+    {
+      btkErrorMacro("The number of local coordinates doesn't correspond to the number of markers.");
+      return;
+    }
+    this->m_Segments.push_back(segment);
+    this->Modified();
+  };
+  
+  /**
+   * Sets the list of segments. Invalid segments are rejected (see AppendSegment()).
+   */
+  void RigidBodyPoseFilter::SetSegments(const std::list<Segment>& segments)
+  {
+    this->m_Segments.clear();
+    for (std::list<Segment>::const_iterator it = segments.begin() ; it != segments.end() ; ++it)
+      this->AppendSegment(*it);
+    this->Modified();
+  };
+  
+  /**
+   * @fn const std::list<Segment>& RigidBodyPoseFilter::GetSegments() const
+   * Returns the list of segments.
+   */
+  
+  /**
+   * Removes all the segments.
+   */
+  void RigidBodyPoseFilter::ClearSegments()
+  {
+    if (this->m_Segments.empty())
+      return;
+    this->m_Segments.clear();
+    this->Modified();
+  };
+  
+  /**
+   * @fn int RigidBodyPoseFilter::GetReferenceFrame() const
+   * Returns the index of the frame used to extract the local coordinates of the markers. The value -1 means the first frame where all the markers of the segment are visible.
+   */
+  
+  /**
+   * Sets the index (starting at 0) of the frame used to extract the local coordinates of the markers. 
+   * The value -1 (default) means the first frame where all the markers of the segment are visible.
+   */
+  void RigidBodyPoseFilter::SetReferenceFrame(int frame)
+  {
+    if (frame < -1)
+    {
+      btkErrorMacro("Invalid reference frame.");
+      return;
+    }
+    if (this->m_ReferenceFrame == frame)
+      return;
+    this->m_ReferenceFrame = frame;
+    this->Modified();
+  };
+  
+  /**
+   * @fn double RigidBodyPoseFilter::GetAxisLength() const
+   * Returns the distance between the origin of the segments and their axis points.
+   */
+  
+  /**
+   * Sets the distance between the origin of the segments and their axis points (100 by default, expressed in the units of the markers).
+   */
+  void RigidBodyPoseFilter::SetAxisLength(double length)
+  {
+    if (length <= 0.0)
+    {
+      btkErrorMacro("The length of the axes must be strictly positive.");
+      return;
+    }
+    if (this->m_AxisLength == length)
+      return;
+    this->m_AxisLength = length;
+    this->Modified();
+  };
+  
+  /**
+   * Constructor. 
+   * Sets the number of inputs and outputs to 1.
+   */
+  RigidBodyPoseFilter::RigidBodyPoseFilter()
+  : ProcessObject(), m_Segments()
+  {
+    this->m_ReferenceFrame = -1;
+    this->m_AxisLength = 100.0;
+    this->SetInputNumber(1);
+    this->SetOutputNumber(1);
+  };
+  
+  /**
+   * @fn PointCollection::Pointer RigidBodyPoseFilter::GetInput(int idx)
+   * Returns the input at the index @a idx.
+   */
+  
+  /**
+   * @fn PointCollection::Pointer RigidBodyPoseFilter::GetOutput(int idx)
+   * Returns the output at the index @a idx.
+   */
+  
+  /**
+   * Creates a PointCollection:Pointer object and return it as a DataObject::Pointer.
+   */
+  DataObject::Pointer RigidBodyPoseFilter::MakeOutput(int /* idx */)
+  {
+    return PointCollection::New();
+  };
+  
+  /**
+   * Generates the outputs' data.
+   */
+  void RigidBodyPoseFilter::GenerateData()
+  {
+    PointCollection::Pointer output = this->GetOutput();
+    output->Clear();
+    PointCollection::Pointer input = this->GetInput();
+    if (!input || input->IsEmpty())
+      return;
+    const int numFrames = input->GetFrontItem()->GetFrameNumber();
+    const char* suffixes[4] = {"O", "A", "L", "P"};
+    const char* descs[4] = {"Origin", "First axis", "Second axis", "Third axis"};
+    
+    // The markers are only read with the const accessors.
+    std::map<std::string, Point::ConstPointer> markers;
+    for (PointCollection::ConstIterator it = input->Begin() ; it != input->End() ; ++it)
+      markers[(*it)->GetLabel()] = *it;
+    
+    std::vector<RigidBodyPoseJob> jobs(this->m_Segments.size());
+    int inc = 0;
+    for (std::list<Segment>::const_iterator it = this->m_Segments.begin() ; it != this->m_Segments.end() ; ++it)
+    {
+      RigidBodyPoseJob& job = jobs[inc++];
+      std::vector<int> columns;
+      for (size_t m = 0 ; m < it->Markers.size() ; ++m)
+      {
+        std::map<std::string, Point::ConstPointer>::const_iterator itP = markers.find(it->Markers[m]);
+        if (itP == markers.end())
+        {
+          btkWarningMacro("Unknown marker in the segment " + it->Label + ": " + it->Markers[m]);
+        }
+        else if (itP->second->GetFrameNumber() != numFrames)
+        {
+          btkWarningMacro("The marker " + it->Markers[m] + " doesn't have the same number of frames than the other points. Not used in the segment " + it->Label + ".");
+        }
+        else
+        {
+          job.markers.push_back(itP->second);
+          columns.push_back(static_cast<int>(m));
+        }
+      }
+      job.valid = (job.markers.size() >= 3);
+      job.local.resize(3, job.markers.size());
+      if (!job.valid)
+      {
+        btkWarningMacro("Not enough markers to compute the pose of the segment " + it->Label + ".");
+      }
+      else if (it->LocalCoordinates.cols() != 0)
+      {
+        for (size_t m = 0 ; m < columns.size() ; ++m)
+          job.local.col(m) = it->LocalCoordinates.col(columns[m]);
+      }
+      else
+      {
+        int ref = this->m_ReferenceFrame;
+        // Frames where all the markers are visible
+        OcclusionMask visible(numFrames);
+        for (size_t m = 0 ; m < job.markers.size() ; ++m)
+          visible &= job.markers[m]->GetOcclusionMask();
+        if (ref == -1)
+        {
+          const std::vector<OcclusionMask::Range> ranges = visible.GetValidRanges();
+          if (!ranges.empty())
+            ref = ranges.front().start;
+        }
+        else if ((ref >= numFrames) || visible.IsOccluded(ref))
+          ref = -1;
+        if (ref == -1)
+        {
+          btkWarningMacro("No reference frame with all the markers visible for the segment " + it->Label + ".");
+          job.valid = false;
+        }
+        else
+        {
+          for (size_t m = 0 ; m < job.markers.size() ; ++m)
+            job.local.col(m) = job.markers[m]->GetValues().row(ref).transpose();
+          const Eigen::Matrix<double, 3, 1> centroid = job.local.rowwise().mean();
+          job.local.colwise() -= centroid;
+        }
+      }
+      for (int i = 0 ; i < 4 ; ++i)
+      {
+        job.frame[i] = Point::New(it->Label + suffixes[i], numFrames, Point::Marker, std::string(descs[i]) + " of the segment " + it->Label);
+        output->InsertItem(job.frame[i]);
+      }
+    }
+    
+    const int num = static_cast<int>(jobs.size());
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0 ; i < num ; ++i)
+      ComputeRigidBodyPose(&(jobs[i]), this->m_AxisLength);
+  };
+};
@@ -0,0 +1,106 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkRigidBodyPoseFilter_h
+#define __btkRigidBodyPoseFilter_h
+
+#include "btkProcessObject.h"
+#include "btkPointCollection.h"
+
+#include <Eigen/Core>
+
+#include <list>
+#include <string>
+#include <vector>
+
+namespace btk
+{
+  class RigidBodyPoseFilter : public ProcessObject
+  {
+  public:
+    struct Segment
+    {
+      Segment(const std::string& label, const std::vector<std::string>& markers)
+      : Label(label), Markers(markers), LocalCoordinates()
+      {};
+      Segment(const std::string& label, const std::vector<std::string>& markers, const Eigen::Matrix<double, 3, Eigen::Dynamic>& local)
+      : Label(label), Markers(markers), LocalCoordinates(local)
+      {};
+      std::string Label;
+      std::vector<std::string> Markers;
+      Eigen::Matrix<double, 3, Eigen::Dynamic> LocalCoordinates;
+    };
+    
+    typedef btkSharedPtr<RigidBodyPoseFilter> Pointer;
+    typedef btkSharedPtr<const RigidBodyPoseFilter> ConstPointer;
+    
+    static Pointer New() {return Pointer(new RigidBodyPoseFilter());};
+    
+    // ~RigidBodyPoseFilter(); // Implicit
+    
+    PointCollection::Pointer GetInput() {return this->GetInput(0);};
+    void SetInput(PointCollection::Pointer input) {this->SetNthInput(0, input);};
+    PointCollection::Pointer GetOutput() {return this->GetOutput(0);};
+    
+    void AppendSegment(const std::string& label, const std::vector<std::string>& markers) {this->AppendSegment(Segment(label, markers));};
+    BTK_BASICFILTERS_EXPORT void AppendSegment(const Segment& segment);
+    BTK_BASICFILTERS_EXPORT void SetSegments(const std::list<Segment>& segments);
+    const std::list<Segment>& GetSegments() const {return this->m_Segments;};
+    BTK_BASICFILTERS_EXPORT void ClearSegments();
+    
+    int GetReferenceFrame() const {return this->m_ReferenceFrame;};
+    BTK_BASICFILTERS_EXPORT void SetReferenceFrame(int frame = -1);
+    double GetAxisLength() const {return this->m_AxisLength;};
+    BTK_BASICFILTERS_EXPORT void SetAxisLength(double length = 100.0);
+    
+  protected:
+    BTK_BASICFILTERS_EXPORT RigidBodyPoseFilter();
+    
+    PointCollection::Pointer GetInput(int idx) {return static_pointer_cast<PointCollection>(this->GetNthInput(idx));};
+    PointCollection::Pointer GetOutput(int idx) {return static_pointer_cast<PointCollection>(this->GetNthOutput(idx));};
+    BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
+    BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    
+  private:
+    RigidBodyPoseFilter(const RigidBodyPoseFilter& ); // Not implemented.
+    RigidBodyPoseFilter& operator=(const RigidBodyPoseFilter& ); // Not implemented.
+    
+    std::list<Segment> m_Segments;
+    int m_ReferenceFrame;
+    double m_AxisLength;
+  };
+};
+
+#endif // __btkRigidBodyPoseFilter_h
@@ -0,0 +1,397 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkSpectralAnalysisFilter.h"
+
+#include <btkEigen/SignalProcessing/FFT.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#ifndef M_PI
+  #define M_PI 3.14159265358979323846
+#endif
+
+namespace btk
+{
+  // One segment of one channel. Each job computes one periodogram (column of the matrix of the channel).
+  struct SpectralAnalysisJob
+  {
+    const double* values;
+    double* periodogram;
+  };
+  
+  static void ProcessSpectralAnalysisJob(const SpectralAnalysisJob& job, const Eigen::Matrix<double, Eigen::Dynamic, 1>& window, const Eigen::Matrix<double, Eigen::Dynamic, 1>& scales, bool detrend, btkEigen::FFT<double>* fft)
+  {
+    const int len = static_cast<int>(window.rows());
+    Eigen::Matrix<double, Eigen::Dynamic, 1> segment = Eigen::Map<const Eigen::Matrix<double, Eigen::Dynamic, 1> >(job.values, len);
+    if (detrend)
+      segment.array() -= segment.mean();
+    segment.array() *= window.array();
+    Eigen::Map< Eigen::Matrix<double, Eigen::Dynamic, 1> >(job.periodogram, scales.rows()) = fft->rfwd(segment).cwiseAbs2().cwiseProduct(scales);
+  };
+  
+  // Frequency below which half of the power is contained (linear interpolation between the bins).
+  static double ComputeMedianFrequency(const double* p, int num, double df)
+  {
+    double total = 0.0;
+    for (int i = 0 ; i < num ; ++i)
+      total += p[i];
+    if (total <= 0.0)
+      return 0.0;
+    const double half = total / 2.0;
+    double cumul = 0.0;
+    for (int i = 0 ; i < num ; ++i)
+    {
+      if (cumul + p[i] >= half)
+        return std::max(0.0, (static_cast<double>(i) - 0.5 + (half - cumul) / p[i]) * df); // Each bin covers [f-df/2,f+df/2]
+      cumul += p[i];
+    }
+    return static_cast<double>(num - 1) * df;
+  };
+  
+  static bool IsSpectralAnalysisLabelSelected(const std::list<std::string>& labels, const std::string& label)
+  {
+    return labels.empty() || (std::find(labels.begin(), labels.end(), label) != labels.end());
+  };
+  
+  /**
+   * @class SpectralAnalysisFilter btkSpectralAnalysisFilter.h
+   * @brief Computes the power spectral density (PSD) and spectral features of the analog channels of an acquisition.
+   *
+   * The PSD is estimated with the Welch's method: the signal is split in segments (256 samples by default, see SetSegmentLength()) 
+   * overlapping by 50% (see SetOverlap()), each segment is detrended (mean removed, see SetDetrend()) and weighted by a periodic Hann window.
+   * The periodograms of the segments are averaged. The PSD is one-sided and scaled as a density (unit^2/Hz). 
+   * The integral of the PSD over the frequencies is then the variance of the signal. These are the default options of the 
+   * function @c pwelch in Matlab or @c scipy.signal.welch in Python. If the signal is shorter than the segment length, 
+   * only one segment with the length of the signal is used.
+   *
+   * The periodogram of each segment is also used to compute the following sliding window features:
+   *  - the mean frequency (MNF), i.e. the frequency weighted by the power;
+   *  - the median frequency (MDF), i.e. the frequency dividing the power in two equal parts;
+   *  - the power in the band given by SetBandFrequencies() (BP).
+   *
+   * The transforms are computed with the FFT implemented in btkEigen (radix-2 for power of two lengths, Bluestein's algorithm otherwise). 
+   * The twiddle factors are computed only once for all the segments.
+   * The segments of all the selected channels are processed in parallel when OpenMP is enabled.
+   *
+   * The first output (index PSD) is a collection of analog channels where each sample corresponds to the frequency given by GetFrequencies().
+   * The second output (index Features) is an acquisition containing the analog channels <label>.MNF, <label>.MDF and <label>.BP. Its analog 
+   * frequency is the analog frequency of the input divided by the number of samples between two segments and its first sample corresponds 
+   * to the first segment.
+   *
+   * Only the analog channels given by SetLabels() are processed (all of them if the list is empty).
+   *
+   * @ingroup BTKBasicFilters
+   */
+  /**
+   * @var SpectralAnalysisFilter::OutputIndex SpectralAnalysisFilter::PSD
+   * Index of the output containing the power spectral densities.
+   */
+  /**
+   * @var SpectralAnalysisFilter::OutputIndex SpectralAnalysisFilter::Features
+   * Index of the output containing the spectral features.
+   */
+  
+  /**
+   * @typedef SpectralAnalysisFilter::Pointer
+   * Smart pointer associated with a SpectralAnalysisFilter object.
+   */
+  
+  /**
+   * @typedef SpectralAnalysisFilter::ConstPointer
+   * Smart pointer associated with a const SpectralAnalysisFilter object.
+   */
+  
+  /**
+   * @fn static Pointer SpectralAnalysisFilter::New();
+   * Creates a smart pointer associated with a SpectralAnalysisFilter object.
+   */
+  
+  /**
+   * @fn Acquisition::Pointer SpectralAnalysisFilter::GetInput()
+   * Gets the input registered with this process.
+   */
+
+  /**
+   * @fn void SpectralAnalysisFilter::SetInput(Acquisition::Pointer input)
+   * Sets the input required with this process.
+   */
+  
+  /**
+   * @fn AnalogCollection::Pointer SpectralAnalysisFilter::GetOutput()
+   * Gets the power spectral densities computed by this process.
+   */
+  
+  /**
+   * @fn Acquisition::Pointer SpectralAnalysisFilter::GetFeatureOutput()
+   * Gets the spectral features computed by this process.
+   */
+  
+  /**
+   * @fn const std::list<std::string>& SpectralAnalysisFilter::GetLabels() const
+   * Returns the labels of the analog channels to process. An empty list means all the analog channels.
+   */
+  
+  /**
+   * Sets the labels of the analog channels to process. An empty list (default) means all the analog channels.
+   */
+  void SpectralAnalysisFilter::SetLabels(const std::list<std::string>& labels)
+  {
+    if (this->m_Labels == labels)
+      return;
+    this->m_Labels = labels;
+    this->Modified();
+  };
+  
+  /**
+   * @fn int SpectralAnalysisFilter::GetSegmentLength() const
+   * Returns the number of samples of each segment.
+   */
+  
+  /**
+   * Sets the number of samples of each segment (256 by default). A power of two is faster.
+   */
+  void SpectralAnalysisFilter::SetSegmentLength(int length)
+  {
+    if (length < 2)
+    {
+      btkErrorMacro("The segment length must contain at least 2 samples.");
+      return;
+    }
+    if (this->m_SegmentLength == length)
+      return;
+    this->m_SegmentLength = length;
+    this->Modified();
+  };
+  
+  /**
+   * @fn double SpectralAnalysisFilter::GetOverlap() const
+   * Returns the ratio of samples shared by two consecutive segments.
+   */
+  
+  /**
+   * Sets the ratio of samples shared by two consecutive segments (0.5 by default). The ratio must be in the interval [0,1[.
+   */
+  void SpectralAnalysisFilter::SetOverlap(double ratio)
+  {
+    if ((ratio < 0.0) || (ratio >= 1.0))
+    {
+      btkErrorMacro("The overlap must be in the interval [0,1[.");
+      return;
+    }
+    if (this->m_Overlap == ratio)
+      return;
+    this->m_Overlap = ratio;
+    this->Modified();
+  };
+  
+  /**
+   * @fn bool SpectralAnalysisFilter::GetDetrend() const
+   * Returns true if the mean of each segment is removed before the transform.
+   */
+  
+  /**
+   * Enables/disables the removal of the mean of each segment before the transform (enabled by default).
+   */
+  void SpectralAnalysisFilter::SetDetrend(bool enabled)
+  {
+    if (this->m_Detrend == enabled)
+      return;
+    this->m_Detrend = enabled;
+    this->Modified();
+  };
+  
+  /**
+   * @fn const double* SpectralAnalysisFilter::GetBandFrequencies() const
+   * Returns the lower and upper frequencies of the band used to compute the band power.
+   */
+  
+  /**
+   * Sets the lower and upper frequencies of the band used to compute the band power. 
+   * An upper frequency set to 0 (default) corresponds to the Nyquist frequency.
+   */
+  void SpectralAnalysisFilter::SetBandFrequencies(double fLow, double fHigh)
+  {
+    if ((fLow < 0.0) || (fHigh < 0.0) || ((fHigh != 0.0) && (fHigh <= fLow)))
+    {
+      btkErrorMacro("Invalid band frequencies.");
+      return;
+    }
+    if ((this->mp_BandFrequencies[0] == fLow) && (this->mp_BandFrequencies[1] == fHigh))
+      return;
+    this->mp_BandFrequencies[0] = fLow;
+    this->mp_BandFrequencies[1] = fHigh;
+    this->Modified();
+  };
+  
+  /**
+   * @fn const Analog::Values& SpectralAnalysisFilter::GetFrequencies() const
+   * Returns the frequencies associated with the samples of the power spectral densities (computed during the last update).
+   */
+  
+  /**
+   * Constructor. Sets the number of inputs and outputs.
+   */
+  SpectralAnalysisFilter::SpectralAnalysisFilter()
+  : ProcessObject(), m_Labels(), m_Frequencies()
+  {
+    this->m_SegmentLength = 256;
+    this->m_Overlap = 0.5;
+    this->m_Detrend = true;
+    this->mp_BandFrequencies[0] = 0.0;
+    this->mp_BandFrequencies[1] = 0.0;
+    this->SetInputNumber(1);
+    this->SetOutputNumber(2);
+  };
+  
+  /**
+   * Creates an AnalogCollection::Pointer object (index PSD) or an Acquisition::Pointer object (index Features) and return it as a DataObject::Pointer.
+   */
+  DataObject::Pointer SpectralAnalysisFilter::MakeOutput(int idx)
+  {
+    if (idx == PSD)
+      return AnalogCollection::New();
+    return Acquisition::New();
+  };
+  
+  /**
+   * Generates the outputs' data.
+   */
+  void SpectralAnalysisFilter::GenerateData()
+  {
+    AnalogCollection::Pointer output = this->GetOutput();
+    Acquisition::Pointer features = this->GetFeatureOutput();
+    output->Clear();
+    features->Reset();
+    this->m_Frequencies.resize(0);
+    
+    Acquisition::Pointer input = this->GetInput();
+    if (!input)
+      return;
+    const int samples = input->GetAnalogFrameNumber();
+    const double fs = input->GetAnalogFrequency();
+    if ((samples < 2) || (fs <= 0.0))
+      return;
+    
+    // Segments
+    const int len = std::min(this->m_SegmentLength, samples);
+    const int step = std::max(1, len - static_cast<int>(std::floor(this->m_Overlap * len)));
+    const int segments = (samples - len) / step + 1;
+    const int bins = len / 2 + 1;
+    const double df = fs / static_cast<double>(len);
+    Eigen::Matrix<double, Eigen::Dynamic, 1> window(len);
+    for (int i = 0 ; i < len ; ++i)
+      window.coeffRef(i) = 0.5 - 0.5 * std::cos(2.0 * M_PI * static_cast<double>(i) / static_cast<double>(len)); // Periodic Hann window
+    Eigen::Matrix<double, Eigen::Dynamic, 1> scales = Eigen::Matrix<double, Eigen::Dynamic, 1>::Constant(bins, 2.0 / (fs * window.squaredNorm()));
+    scales.coeffRef(0) /= 2.0;
+    if ((len % 2) == 0)
+      scales.coeffRef(bins - 1) /= 2.0;
+    this->m_Frequencies.resize(bins);
+    for (int i = 0 ; i < bins ; ++i)
+      this->m_Frequencies.coeffRef(i) = static_cast<double>(i) * df;
+    
+    // Periodograms of all the segments of all the channels
+    std::vector<Analog::ConstPointer> channels; // Read-only access to not copy the shared values
+    for (Acquisition::AnalogIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
+    {
+      if (IsSpectralAnalysisLabelSelected(this->m_Labels, (*it)->GetLabel()))
+        channels.push_back(*it);
+    }
+    const int num = static_cast<int>(channels.size());
+    std::vector< Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> > periodograms(num, Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>(bins, segments));
+    std::vector<SpectralAnalysisJob> jobs(num * segments);
+    for (int c = 0 ; c < num ; ++c)
+    {
+      for (int s = 0 ; s < segments ; ++s)
+      {
+        jobs[c * segments + s].values = channels[c]->GetValues().data() + s * step;
+        jobs[c * segments + s].periodogram = periodograms[c].data() + s * bins;
+      }
+    }
+    const int numJobs = static_cast<int>(jobs.size());
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+    {
+      btkEigen::FFT<double> fft; // Twiddle factors computed once by thread
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic)
+#endif
+      for (int i = 0 ; i < numJobs ; ++i)
+        ProcessSpectralAnalysisJob(jobs[i], window, scales, this->m_Detrend, &fft);
+    }
+    
+    // Band
+    const double nyquist = fs / 2.0;
+    const double fLow = this->mp_BandFrequencies[0];
+    const double fHigh = (this->mp_BandFrequencies[1] == 0.0) ? nyquist : std::min(this->mp_BandFrequencies[1], nyquist);
+    const int bLow = std::min(bins, static_cast<int>(std::ceil(fLow / df)));
+    const int bHigh = std::min(bins - 1, static_cast<int>(std::floor(fHigh / df)));
+    
+    // Welch's average and features
+    features->Init(0, segments, 3 * num, 1);
+    features->SetFirstFrame(1);
+    features->SetPointFrequency(fs / static_cast<double>(step));
+    for (int c = 0 ; c < num ; ++c)
+    {
+      const Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>& p = periodograms[c];
+      const std::string& label = channels[c]->GetLabel();
+      const std::string& unit = channels[c]->GetUnit();
+      Analog::Pointer psd = Analog::New(label, bins);
+      psd->SetDescription(channels[c]->GetDescription());
+      if (!unit.empty())
+        psd->SetUnit(unit + "^2/Hz");
+      psd->GetValues() = p.rowwise().sum() / static_cast<double>(segments);
+      output->InsertItem(psd);
+      
+      Analog::Pointer mnf = features->GetAnalog(3 * c);
+      Analog::Pointer mdf = features->GetAnalog(3 * c + 1);
+      Analog::Pointer bp = features->GetAnalog(3 * c + 2);
+      mnf->SetLabel(label + ".MNF"); mnf->SetUnit("Hz");
+      mdf->SetLabel(label + ".MDF"); mdf->SetUnit("Hz");
+      bp->SetLabel(label + ".BP"); bp->SetUnit(unit.empty() ? "" : unit + "^2");
+      const Eigen::Matrix<double, 1, Eigen::Dynamic> total = p.colwise().sum();
+      const Eigen::Matrix<double, 1, Eigen::Dynamic> moment = this->m_Frequencies.transpose() * p;
+      for (int s = 0 ; s < segments ; ++s)
+      {
+        mnf->GetValues().coeffRef(s) = (total.coeff(s) > 0.0) ? moment.coeff(s) / total.coeff(s) : 0.0;
+        mdf->GetValues().coeffRef(s) = ComputeMedianFrequency(p.col(s).data(), bins, df);
+        bp->GetValues().coeffRef(s) = (bHigh >= bLow) ? p.col(s).segment(bLow, bHigh - bLow + 1).sum() * df : 0.0;
+      }
+    }
+  };
+};
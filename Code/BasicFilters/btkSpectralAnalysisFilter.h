@@ -0,0 +1,98 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkSpectralAnalysisFilter_h
+#define __btkSpectralAnalysisFilter_h
+
+#include "btkProcessObject.h"
+#include "btkAcquisition.h"
+#include "btkAnalogCollection.h"
+
+#include <list>
+#include <string>
+
+namespace btk
+{
+  class SpectralAnalysisFilter : public ProcessObject
+  {
+  public:
+    typedef enum {PSD = 0, Features} OutputIndex;
+    
+    typedef btkSharedPtr<SpectralAnalysisFilter> Pointer;
+    typedef btkSharedPtr<const SpectralAnalysisFilter> ConstPointer;
+    
+    static Pointer New() {return Pointer(new SpectralAnalysisFilter());};
+    
+    // ~SpectralAnalysisFilter(); // Implicit
+    
+    Acquisition::Pointer GetInput() {return static_pointer_cast<Acquisition>(this->GetNthInput(0));};
+    void SetInput(Acquisition::Pointer input) {this->SetNthInput(0, input);};
+    AnalogCollection::Pointer GetOutput() {return static_pointer_cast<AnalogCollection>(this->GetNthOutput(PSD));};
+    Acquisition::Pointer GetFeatureOutput() {return static_pointer_cast<Acquisition>(this->GetNthOutput(Features));};
+    
+    const std::list<std::string>& GetLabels() const {return this->m_Labels;};
+    BTK_BASICFILTERS_EXPORT void SetLabels(const std::list<std::string>& labels);
+    
+    int GetSegmentLength() const {return this->m_SegmentLength;};
+    BTK_BASICFILTERS_EXPORT void SetSegmentLength(int length);
+    double GetOverlap() const {return this->m_Overlap;};
+    BTK_BASICFILTERS_EXPORT void SetOverlap(double ratio);
+    bool GetDetrend() const {return this->m_Detrend;};
+    BTK_BASICFILTERS_EXPORT void SetDetrend(bool enabled);
+    const double* GetBandFrequencies() const {return this->mp_BandFrequencies;};
+    BTK_BASICFILTERS_EXPORT void SetBandFrequencies(double fLow, double fHigh);
+    
+    const Analog::Values& GetFrequencies() const {return this->m_Frequencies;};
+    
+  protected:
+    BTK_BASICFILTERS_EXPORT SpectralAnalysisFilter();
+    
+    BTK_BASICFILTERS_EXPORT virtual DataObject::Pointer MakeOutput(int idx);
+    BTK_BASICFILTERS_EXPORT virtual void GenerateData();
+    
+  private:
+    SpectralAnalysisFilter(const SpectralAnalysisFilter& ); // Not implemented.
+    SpectralAnalysisFilter& operator=(const SpectralAnalysisFilter& ); // Not implemented.
+    
+    std::list<std::string> m_Labels;
+    int m_SegmentLength;
+    double m_Overlap;
+    bool m_Detrend;
+    double mp_BandFrequencies[2];
+    Analog::Values m_Frequencies;
+  };
+};
+
+#endif // __btkSpectralAnalysisFilter_h
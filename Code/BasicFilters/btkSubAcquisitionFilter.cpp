@@ -303,8 +303,9 @@ namespace btk
         point->SetDescription((*it)->GetDescription());
         point->SetType((*it)->GetType());
         point->SetFrameNumber(numFrames);
-        point->SetValues((*it)->GetValues().block(bounds[0],0,numFrames,3));
-        point->SetResiduals((*it)->GetResiduals().block(bounds[0],0,numFrames,1));
+        Point::ConstPointer source = *it; // Read-only access to not copy the shared values
+        point->SetValues(source->GetValues().block(bounds[0],0,numFrames,3));
+        point->SetResiduals(source->GetResiduals().block(bounds[0],0,numFrames,1));
         points->InsertItem(point);
       }
       out->SetPoints(points);
@@ -351,7 +352,8 @@ namespace btk
         analog->SetOffset((*it)->GetOffset());
         analog->SetScale((*it)->GetScale());
         analog->SetFrameNumber(numFrames);
-        analog->SetValues((*it)->GetValues().block(bounds[0]*in->GetNumberAnalogSamplePerFrame(),0,numFrames,1));
+        Analog::ConstPointer source = *it; // Read-only access to not copy the shared values
+        analog->SetValues(source->GetValues().block(bounds[0]*in->GetNumberAnalogSamplePerFrame(),0,numFrames,1));
         analogs->InsertItem(analog);
       }
       out->SetAnalogs(analogs);
@@ -269,7 +269,8 @@ namespace btk
       if (this->m_FrameRate >= 0.0)
         t = 1.0 / this->m_FrameRate;
       int r = 0, c = 0, num = ub-lb;
-      Eigen::Matrix<double,Eigen::Dynamic,1> fz = (*it)->GetForce()->GetValues().col(2).block(lb,0,num+1,1);
+      Point::ConstPointer force = (*it)->GetForce(); // Read-only access to not copy the shared values
+      Eigen::Matrix<double,Eigen::Dynamic,1> fz = force->GetValues().col(2).block(lb,0,num+1,1);
       if (fz.maxCoeff(&r, &c) > this->m_Threshold)
       {
         int incr = r;
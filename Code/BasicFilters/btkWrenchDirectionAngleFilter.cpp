@@ -132,13 +132,17 @@ namespace btk
       {
         int numFrames = (*it)->GetForce()->GetFrameNumber();
         Point::Pointer dirAngle = Point::New((*it)->GetPosition()->GetLabel() + ".DA", numFrames, Point::Angle);
+        const OcclusionMask mask = (*it)->GetPosition()->GetOcclusionMask();
+        // Read-only access to not copy the values shared with other objects
+        Point::ConstPointer force = (*it)->GetForce();
+        const Point::Values& f = force->GetValues();
         for (int i = 0 ; i < numFrames ; ++i)
         {
-          if ((*it)->GetPosition()->GetResiduals().coeff(i) >= 0)
+          if (mask.IsValid(i))
           {
-            dirAngle->GetValues().coeffRef(i,0) = atan2(-(*it)->GetForce()->GetValues().coeff(i,2), -(*it)->GetForce()->GetValues().coeff(i,1)) * radToDeg + 180.0;
-            dirAngle->GetValues().coeffRef(i,1) = atan2(-(*it)->GetForce()->GetValues().coeff(i,2), -(*it)->GetForce()->GetValues().coeff(i,0)) * radToDeg + 180.0;
-            dirAngle->GetValues().coeffRef(i,2) = atan2(-(*it)->GetForce()->GetValues().coeff(i,1), -(*it)->GetForce()->GetValues().coeff(i,0)) * radToDeg + 180.0;
+            dirAngle->GetValues().coeffRef(i,0) = atan2(-f.coeff(i,2), -f.coeff(i,1)) * radToDeg + 180.0;
+            dirAngle->GetValues().coeffRef(i,1) = atan2(-f.coeff(i,2), -f.coeff(i,0)) * radToDeg + 180.0;
+            dirAngle->GetValues().coeffRef(i,2) = atan2(-f.coeff(i,1), -f.coeff(i,0)) * radToDeg + 180.0;
           }
           else
           {
@@ -37,6 +37,9 @@
 #include "btkException.h"
 #include "btkConvert.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace btk
 {
   /**
@@ -881,7 +884,8 @@ namespace btk
    * frame. The analog part has @a analogNumber analog channels and their number of frames
    * corresponds to the integer factor @a analogSampleNumberPerPointFrame multiplied by @a frameNumber.
    *
-   * This method has the same behavior than the method Init(), but does not label added points and analog channels
+   * This method has the same behavior than the method Init(), but does not label added points and analog channels.
+   * The frames appended with the method AppendFrames() are committed before to resize the acquisition.
    */
   void Acquisition::Resize(int pointNumber, int frameNumber,
                            int analogNumber, int analogSampleNumberPerPointFrame)
@@ -891,6 +895,7 @@ namespace btk
       btkWarningMacro("Impossible to set the analog sample number to 0. The numbers of analog samples per point frame is now equals to 1.");
       analogSampleNumberPerPointFrame = 1;
     }
+    this->CommitFrames();
     this->m_AnalogSampleNumberPerPointFrame = analogSampleNumberPerPointFrame;
     this->ResizeFrameNumber(frameNumber);
     this->ResizePointNumber(pointNumber);
@@ -902,9 +907,11 @@ namespace btk
    * Resize the number of points.
    * Using this method will set the object as modified even if the given number of points is the same than in the acquisition.
    * This method forces the analog channels to have this object (the acquisition) as their parent.
+   * The frames appended with the method AppendFrames() are committed before to resize the acquisition.
    */
   void Acquisition::ResizePointNumber(int pointNumber)
   {
+    this->CommitFrames();
     // Reduce the number of items if necessary
     if (pointNumber < this->GetPointNumber())
       this->m_Points->SetItemNumber(pointNumber);
@@ -927,9 +934,11 @@ namespace btk
    * Resize the number of analog channels.
    * Using this method will set the object as modified even if the given number of analog channels is the same than in the acquisition.
    * This method forces the analog channels to have this object (the acquisition) as their parent.
+   * The frames appended with the method AppendFrames() are committed before to resize the acquisition.
    */
   void Acquisition::ResizeAnalogNumber(int analogNumber)
   {
+    this->CommitFrames();
     // Reduce the number of items if necessary
     if (analogNumber < this->GetAnalogNumber())
       this->m_Analogs->SetItemNumber(analogNumber);
@@ -950,9 +959,11 @@ namespace btk
   
   /**
    * Resize the number of frames.
+   * The frames appended with the method AppendFrames() are committed before to resize the acquisition.
    */
   void Acquisition::ResizeFrameNumber(int frameNumber)
   {
+    this->CommitFrames();
     if (frameNumber == this->m_PointFrameNumber)
       return;
     this->SetPointFrameNumber(frameNumber);
@@ -963,25 +974,29 @@ namespace btk
   /**
    * Resize the number of frames by adding the new frames at the beginning of the acquisition and 
    * set automatically the new first frame index.
+   * The frames appended with the method AppendFrames() are committed before to resize the acquisition.
    */
   void Acquisition::ResizeFrameNumberFromEnd(int frameNumber)
   {
+    this->CommitFrames();
     if (frameNumber == this->m_PointFrameNumber)
       return;
       
     if (frameNumber < this->m_PointFrameNumber)
     {
       int startRow = this->m_PointFrameNumber - frameNumber;
+      // The values are read with the const accessors and then replaced, to not copy the values shared with other objects.
       for (PointIterator it = this->BeginPoint() ; it != this->EndPoint() ; ++it)
       {
-        Point::Values v = (*it)->GetValues().block(startRow,0,frameNumber,3);
+        Point::ConstPointer p = *it;
+        Point::Values v = p->GetValues().block(startRow,0,frameNumber,3);
+        Point::Residuals r = p->GetResiduals().block(startRow,0,frameNumber,1);
         (*it)->SetValues(v);
-        Point::Residuals r = (*it)->GetResiduals().block(startRow,0,frameNumber,1);
         (*it)->SetResiduals(r);
       }
       for (AnalogIterator it = this->BeginAnalog() ; it != this->EndAnalog() ; ++it)
       {
-        Analog::Values v = (*it)->GetValues().block(startRow * this->m_AnalogSampleNumberPerPointFrame, 0, frameNumber * this->m_AnalogSampleNumberPerPointFrame, 1);
+        Analog::Values v = Analog::ConstPointer(*it)->GetValues().block(startRow * this->m_AnalogSampleNumberPerPointFrame, 0, frameNumber * this->m_AnalogSampleNumberPerPointFrame, 1);
         (*it)->SetValues(v);
       } 
       this->m_FirstFrame = startRow + 1;
@@ -992,18 +1007,18 @@ namespace btk
       int actualFrameNumber = this->m_PointFrameNumber;
       for (PointIterator it = this->BeginPoint() ; it != this->EndPoint() ; ++it)
       {
+        Point::ConstPointer p = *it;
         Point::Values v = Point::Values::Zero(frameNumber, 3);
-        v.block(startRow,0, actualFrameNumber,3) = (*it)->GetValues();
-        (*it)->SetValues(v);
-
+        v.block(startRow,0, actualFrameNumber,3) = p->GetValues();
         Point::Residuals r = Point::Residuals::Zero(frameNumber, 1);
-        r.block(startRow,0,actualFrameNumber,1) = (*it)->GetResiduals();
+        r.block(startRow,0,actualFrameNumber,1) = p->GetResiduals();
+        (*it)->SetValues(v);
         (*it)->SetResiduals(r);
       }
       for (AnalogIterator it = this->BeginAnalog() ; it != this->EndAnalog() ; ++it)
       {
         Analog::Values v = Analog::Values::Zero(frameNumber * this->m_AnalogSampleNumberPerPointFrame, 1);
-        v.block(startRow * this->m_AnalogSampleNumberPerPointFrame, 0, actualFrameNumber * this->m_AnalogSampleNumberPerPointFrame, 1) = (*it)->GetValues();
+        v.block(startRow * this->m_AnalogSampleNumberPerPointFrame, 0, actualFrameNumber * this->m_AnalogSampleNumberPerPointFrame, 1) = Analog::ConstPointer(*it)->GetValues();
         (*it)->SetValues(v);
       }
       this->m_FirstFrame = this->m_FirstFrame - frameNumber + this->m_PointFrameNumber;
@@ -1030,9 +1045,11 @@ namespace btk
    *
    * To re-populate this acquisition, you need to re-use the Init() method 
    * to set the point and analog number and their frame number.
+   * The frames appended with the method AppendFrames() and not yet committed are discarded.
    */
   void Acquisition::Reset()
   {
+    this->mp_FrameBuffer.reset();
     this->m_Events->SetItemNumber(0);
     this->m_Points->SetItemNumber(0);
     this->m_Analogs->SetItemNumber(0);
@@ -1054,6 +1071,240 @@ namespace btk
     this->m_MaxInterpolationGap = 10;
     this->Modified();
   };
+  
+  /**
+   * Stores the values (and the residuals) of the points and analog channels in single precision.
+   * This halves the memory footprint of the acquisition, for example when a lot of trials must be kept in memory.
+   * The single precision values are the storage of the measures until they are accessed for modification or unpacked (see MeasureData::PackValues()).
+   * @note The single precision is enough for data stored in 16-bit integers or 32-bit floats as in the C3D format.
+   */
+  void Acquisition::PackValues()
+  {
+    for (PointIterator it = this->BeginPoint() ; it != this->EndPoint() ; ++it)
+      (*it)->PackValues();
+    for (AnalogIterator it = this->BeginAnalog() ; it != this->EndAnalog() ; ++it)
+      (*it)->PackValues();
+  };
+  
+  /**
+   * Converts the values (and the residuals) of the points and analog channels back in double precision.
+   */
+  void Acquisition::UnpackValues()
+  {
+    for (PointIterator it = this->BeginPoint() ; it != this->EndPoint() ; ++it)
+      (*it)->UnpackValues();
+    for (AnalogIterator it = this->BeginAnalog() ; it != this->EndAnalog() ; ++it)
+      (*it)->UnpackValues();
+  };
+  
+  /**
+   * Internal storage used by AppendFrames() to collect the frames not yet committed.
+   * The frames are stored as given to AppendFrames() (frame by frame), in vectors which grow geometrically.
+   * In ring mode, @a dropped counts the appended frames already removed from the front of the buffer.
+   */
+  struct Acquisition::FrameBuffer
+  {
+    int pointNumber;
+    int analogNumber;
+    int ratio;
+    int size;
+    int dropped;
+    std::vector<double> points;
+    std::vector<double> residuals;
+    std::vector<double> analogs;
+    
+    void Append(std::vector<double>& buffer, const double* values, int num)
+    {
+      if (values)
+        buffer.insert(buffer.end(), values, values + num);
+      else
+        buffer.resize(buffer.size() + num, 0.0);
+    };
+    
+    void RemoveFront(int frameNumber)
+    {
+      this->points.erase(this->points.begin(), this->points.begin() + 3 * this->pointNumber * frameNumber);
+      this->residuals.erase(this->residuals.begin(), this->residuals.begin() + this->pointNumber * frameNumber);
+      this->analogs.erase(this->analogs.begin(), this->analogs.begin() + this->analogNumber * this->ratio * frameNumber);
+      this->size -= frameNumber;
+      this->dropped += frameNumber;
+    };
+  };
+  
+  /**
+   * @fn double Acquisition::GetRingBufferDuration() const
+   * Returns the duration (in seconds) kept by the ring buffer used by the method AppendFrames().
+   * A null duration (default) means that all the appended frames are kept.
+   */
+  
+  /**
+   * Sets the duration (in seconds) kept by the ring buffer used by the method AppendFrames().
+   * Once full, each committed frame replaces the oldest one and the first frame of the acquisition 
+   * is incremented accordingly. A null (or negative) duration disables the ring buffer.
+   * The frames already appended are committed (see CommitFrames()) before to apply the new duration.
+   */
+  void Acquisition::SetRingBufferDuration(double duration)
+  {
+    if (duration < 0.0)
+      duration = 0.0;
+    if (this->m_RingBufferDuration == duration)
+      return;
+    this->CommitFrames();
+    this->m_RingBufferDuration = duration;
+    this->Modified();
+  };
+  
+  /**
+   * Appends @a frameNumber frames to the points and analog channels, for example to 
+   * collect the data sent by a real-time capture system.
+   *
+   * The input arrays are stored frame by frame:
+   *  - @a points: X, Y, Z coordinates of each point (@a frameNumber x GetPointNumber() x 3 values) ;
+   *  - @a residuals: residual of each point (@a frameNumber x GetPointNumber() values) ;
+   *  - @a analogs: each sample of each analog channel (@a frameNumber x GetNumberAnalogSamplePerFrame() x GetAnalogNumber() values).
+   * A null pointer sets the corresponding values to 0.
+   *
+   * The frames are kept in an internal buffer until the method CommitFrames() is called. This 
+   * buffer only contains the frames appended since the last commit: the points and analog channels 
+   * stay the storage of the committed frames. If a ring buffer duration is set (see SetRingBufferDuration()), 
+   * only the last frames are kept.
+   *
+   * The number of points, analog channels and analog samples per frame must not be modified directly 
+   * (i.e. without the methods Init() or Resize*()) between two appends. These methods commit the 
+   * appended frames before to resize the acquisition. The method Reset() discards them.
+   */
+  void Acquisition::AppendFrames(int frameNumber, const double* points, const double* residuals, const double* analogs)
+  {
+    if (frameNumber <= 0)
+      return;
+    const int capacity = this->GetRingBufferCapacity();
+    if (capacity == 0)
+    {
+      btkErrorMacro("Impossible to use a ring buffer without point frequency.");
+      return;
+    }
+    if (!this->mp_FrameBuffer)
+    {
+      FrameBuffer* fb = new FrameBuffer;
+      fb->pointNumber = this->GetPointNumber();
+      fb->analogNumber = this->GetAnalogNumber();
+      fb->ratio = this->m_AnalogSampleNumberPerPointFrame;
+      fb->size = 0;
+      fb->dropped = 0;
+      this->mp_FrameBuffer = btkSharedPtr<FrameBuffer>(fb);
+    }
+    else if ((this->mp_FrameBuffer->pointNumber != this->GetPointNumber())
+             || (this->mp_FrameBuffer->analogNumber != this->GetAnalogNumber())
+             || (this->mp_FrameBuffer->ratio != this->m_AnalogSampleNumberPerPointFrame))
+    {
+      btkErrorMacro("The number of points or analog channels was modified since the last appended frames. The method CommitFrames() must be called before.");
+      return;
+    }
+    FrameBuffer* fb = this->mp_FrameBuffer.get();
+    fb->Append(fb->points, points, 3 * fb->pointNumber * frameNumber);
+    fb->Append(fb->residuals, residuals, fb->pointNumber * frameNumber);
+    fb->Append(fb->analogs, analogs, fb->analogNumber * fb->ratio * frameNumber);
+    fb->size += frameNumber;
+    // Ring: the frames which cannot be committed are removed once they use as much memory as the kept ones.
+    if ((capacity > 0) && (fb->size > 2 * capacity))
+      fb->RemoveFront(fb->size - capacity);
+  };
+  
+  /**
+   * Returns the number of frames stored in the acquisition once the appended frames are committed.
+   */
+  int Acquisition::GetBufferedFrameNumber() const
+  {
+    if (!this->mp_FrameBuffer)
+      return this->m_PointFrameNumber;
+    const int num = this->m_PointFrameNumber + this->mp_FrameBuffer->size;
+    const int capacity = this->GetRingBufferCapacity();
+    return (capacity > 0) ? std::min(num, capacity) : num;
+  };
+  
+  /**
+   * Copies the frames collected by the method AppendFrames() at the end of the points and analog channels.
+   * Only the appended frames are copied from the buffer, which is then emptied. The measures store them with a capacity 
+   * larger than their number of frames, grown geometrically (see MeasureData::AppendValues()), so that a commit does not copy 
+   * the frames already committed. The values are copied back in a matrix with one row per frame when they are accessed 
+   * (the references to the values obtained before a commit must then be requested again).
+   *
+   * In ring mode, the oldest frames are removed to keep the duration set by SetRingBufferDuration(). Once the acquisition 
+   * contains this duration, the new frames replace the oldest ones in place. The first frame is incremented by the number of removed frames 
+   * and the events set before the new first frame are removed. The other events are not modified.
+   */
+  void Acquisition::CommitFrames()
+  {
+    if (!this->mp_FrameBuffer)
+      return;
+    btkSharedPtr<FrameBuffer> fb = this->mp_FrameBuffer;
+    this->mp_FrameBuffer.reset();
+    const int capacity = this->GetRingBufferCapacity();
+    const int oldNumber = this->m_PointFrameNumber;
+    const int total = oldNumber + fb->size;
+    const int num = (capacity > 0) ? std::min(total, capacity) : total;
+    const int removed = total - num;
+    const int newStart = std::max(0, removed - oldNumber); // Appended frames removed
+    const int count = fb->size - newStart;
+    const int ratio = fb->ratio;
+    const int pointNumber = std::min(fb->pointNumber, this->GetPointNumber());
+    const int analogNumber = std::min(fb->analogNumber, this->GetAnalogNumber());
+    // The measures keep spare capacity (or are used as a ring buffer): only the appended frames are copied.
+    int inc = 0;
+    for (PointIterator it = this->BeginPoint() ; it != this->EndPoint() ; ++it, ++inc)
+    {
+      if ((*it)->GetFrameNumber() != oldNumber)
+        (*it)->SetFrameNumber(oldNumber);
+      if (!(*it)->GetData())
+        (*it)->SetData(Point::Data::New(0));
+      const bool used = (inc < pointNumber) && (count > 0);
+      (*it)->GetData()->AppendValues(used ? &(fb->points[(newStart * fb->pointNumber + inc) * 3]) : 0, 3 * fb->pointNumber,
+                                     used ? &(fb->residuals[newStart * fb->pointNumber + inc]) : 0, fb->pointNumber,
+                                     count, (capacity > 0) ? capacity : -1);
+      (*it)->Modified();
+    }
+    inc = 0;
+    for (AnalogIterator it = this->BeginAnalog() ; it != this->EndAnalog() ; ++it, ++inc)
+    {
+      if ((*it)->GetFrameNumber() != oldNumber * ratio)
+        (*it)->SetFrameNumber(oldNumber * ratio);
+      if (!(*it)->GetData())
+        (*it)->SetData(Analog::Data::New(0));
+      const bool used = (inc < analogNumber) && (count > 0);
+      (*it)->GetData()->AppendValues(used ? &(fb->analogs[newStart * ratio * fb->analogNumber + inc]) : 0, fb->analogNumber,
+                                     count * ratio, (capacity > 0) ? capacity * ratio : -1);
+      (*it)->Modified();
+    }
+    this->m_PointFrameNumber = num;
+    const int shift = removed + fb->dropped;
+    if (shift != 0)
+    {
+      this->m_FirstFrame += shift;
+      const double firstTime = (this->m_PointFrequency > 0.0) ? static_cast<double>(this->m_FirstFrame - 1) / this->m_PointFrequency : 0.0;
+      EventIterator it = this->BeginEvent();
+      while (it != this->EndEvent())
+      {
+        if (((*it)->GetFrame() >= 0) ? ((*it)->GetFrame() < this->m_FirstFrame) : ((*it)->GetTime() < firstTime))
+          it = this->m_Events->RemoveItem(it);
+        else
+          ++it;
+      }
+    }
+    this->Modified();
+  };
+  
+  /**
+   * Returns the number of frames kept by the ring buffer (see SetRingBufferDuration()), -1 if the ring buffer is not used 
+   * and 0 if it cannot be computed as the point frequency is not set.
+   */
+  int Acquisition::GetRingBufferCapacity() const
+  {
+    if (this->m_RingBufferDuration <= 0.0)
+      return -1;
+    if (this->m_PointFrequency <= 0.0)
+      return 0;
+    return std::max(1, static_cast<int>(std::ceil(this->m_RingBufferDuration * this->m_PointFrequency)));
+  };
 
   /**
    * @fn double Acquisition::GetDuration() const
@@ -1243,7 +1494,9 @@ namespace btk
   
   /**
    * @fn Pointer Acquisition::Clone() const
-   * Returns a deep copy of this object.
+   * Returns a deep copy of this object. The values of the measures and the metadata 
+   * are implicitly shared with the copy until one of them is modified (copy-on-write).
+   * The frames appended with the method AppendFrames() and not yet committed are not copied.
    */
     
   /**
@@ -1270,6 +1523,7 @@ namespace btk
     this->m_Units[Point::Scalar] = "mm";
     // this->m_Units[Point::Reaction] = "";
     this->m_MaxInterpolationGap = 10;
+    this->m_RingBufferDuration = 0.0;
   };
   
   /**
@@ -1324,5 +1578,6 @@ namespace btk
     this->m_AnalogSampleNumberPerPointFrame = toCopy.m_AnalogSampleNumberPerPointFrame;
     this->m_AnalogResolution = toCopy.m_AnalogResolution;
     this->m_MaxInterpolationGap = toCopy.m_MaxInterpolationGap;
+    this->m_RingBufferDuration = toCopy.m_RingBufferDuration;
   };
 }
@@ -156,6 +156,13 @@ namespace btk
     BTK_COMMON_EXPORT void ResizeFrameNumber(int frameNumber);
     BTK_COMMON_EXPORT void ResizeFrameNumberFromEnd(int frameNumber);
     BTK_COMMON_EXPORT void Reset();
+    BTK_COMMON_EXPORT void PackValues();
+    BTK_COMMON_EXPORT void UnpackValues();
+    double GetRingBufferDuration() const {return this->m_RingBufferDuration;};
+    BTK_COMMON_EXPORT void SetRingBufferDuration(double duration);
+    BTK_COMMON_EXPORT void AppendFrames(int frameNumber, const double* points, const double* residuals = 0, const double* analogs = 0);
+    BTK_COMMON_EXPORT int GetBufferedFrameNumber() const;
+    BTK_COMMON_EXPORT void CommitFrames();
     double GetDuration() const {return ((this->m_PointFrequency == 0) ? 0 : 1 / this->m_PointFrequency * this->m_PointFrameNumber);};
     int GetFirstFrame() const {return this->m_FirstFrame;};
     BTK_COMMON_EXPORT void SetFirstFrame(int num, bool adaptEvents=false);
@@ -189,6 +196,9 @@ namespace btk
     BTK_COMMON_EXPORT Acquisition(const Acquisition& toCopy);
     Acquisition& operator=(const Acquisition& ); // Not implemented.
     
+    struct FrameBuffer;
+    int GetRingBufferCapacity() const;
+    
     MetaData::Pointer mp_MetaData;
     EventCollection::Pointer m_Events;
     PointCollection::Pointer m_Points;
@@ -200,6 +210,8 @@ namespace btk
     AnalogResolution m_AnalogResolution;
     std::vector<std::string> m_Units;
     int m_MaxInterpolationGap;
+    double m_RingBufferDuration;
+    btkSharedPtr<FrameBuffer> mp_FrameBuffer;
   };
 };
 
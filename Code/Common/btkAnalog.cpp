@@ -273,7 +273,8 @@ namespace btk
 
   /**
    * @fn Pointer Analog::Clone() const
-   * Deep copy of the current object.
+   * Deep copy of the current object. The values are implicitly shared with the copy until one of them is modified.
+   * @warning The references to the values obtained before the copy must not be used anymore (see MeasureData).
    */
 
   /**
@@ -321,6 +322,11 @@ namespace btk
    * @struct MeasureTraits<Analog> btkAnalog.h
    * Specialized template for the information related to the data stored in a btk::Analog object.
    */
+  
+  /**
+   * @typedef MeasureTraits<Analog>::PackedValues
+   * Analog's values stored in single precision (see MeasureData::PackValues()).
+   */
  
   /**
    * @typedef MeasureTraits<Analog>::Data::Pointer
@@ -361,7 +367,7 @@ namespace btk
   
   /**
    * @fn MeasureTraits<Analog>::Data::Pointer MeasureTraits<Analog>::Data::Clone() const
-   * Deep copy of the current object.
+   * Copy of the current object. The values are shared with the current object until one of them is modified.
    */
 }
 
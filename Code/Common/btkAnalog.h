@@ -46,6 +46,7 @@ namespace btk
   struct MeasureTraits<Analog>
   {
     typedef Eigen::Matrix<double, Eigen::Dynamic, 1> Values; ///< Analog's  values along the time with 1 components (1 column).
+    typedef Eigen::Matrix<float, Eigen::Dynamic, 1> PackedValues; ///< Analog's values stored in single precision.
     
    /**
     * @class Data
@@ -132,15 +133,14 @@ namespace btk
   
   inline void MeasureTraits<Analog>::Data::Resize(int frameNumber)
   {
-    if (frameNumber > this->m_Values.rows())
-    {
-      Values v = Values::Zero(frameNumber,Values::ColsAtCompileTime);
-      if (this->m_Values.data() != 0)
-        v.block(0,0,this->m_Values.rows(),Values::ColsAtCompileTime) = this->m_Values;
-      this->m_Values = v;
-    }
+    // The values are replaced (and not modified) to not affect the objects sharing them. Packed values stay packed.
+    if (this->mp_Stream)
+      this->UnpackValues();
+    this->mp_UnpackedValues.reset();
+    if (this->mp_PackedValues)
+      this->mp_PackedValues = ResizeMatrix(*(this->mp_PackedValues), frameNumber);
     else
-      this->m_Values.conservativeResize(frameNumber);
+      this->mp_Values = ResizeMatrix(*(this->mp_Values), frameNumber);
   };
 };
 
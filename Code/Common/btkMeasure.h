@@ -38,8 +38,10 @@
 
 #include "btkDataObject.h"
 #include "btkLogger.h"
+#include "btkException.h"
 
 #include <Eigen/Core>
+#include <algorithm>
 #include <string>
 
 namespace btk
@@ -47,24 +49,98 @@ namespace btk
   template <typename Derived>
   struct MeasureTraits;
   
+  /**
+   * Scoped lock used by the const accessors of the measures to convert their packed values only once, even if they are read by several threads.
+   */
+  struct MeasureDataLock_p
+  {
+    BTK_COMMON_EXPORT MeasureDataLock_p();
+    BTK_COMMON_EXPORT ~MeasureDataLock_p();
+  };
+  
+  /**
+   * Storage with a capacity larger than the number of frames, used by the measures to append frames (see MeasureData::AppendValues()).
+   * The frame @a k is stored in the row (@a head + @a k) modulo the capacity, so that a ring buffer only overwrites its oldest frames.
+   */
+  template <typename M>
+  struct MeasureStream_p
+  {
+    MeasureStream_p() : buffer(), head(0), size(0) {};
+    void Append(const double* values, int stride, int frameNumber, int maxFrameNumber);
+    void Reallocate(int capacity);
+    void CopyFrames(M& m, int first, int num) const;
+    M GetFrames() const {M m(this->size, this->buffer.cols()); this->CopyFrames(m, 0, this->size); return m;};
+    
+    M buffer;
+    int head;
+    int size;
+  };
+  
   template <typename Derived>
   class MeasureData : public DataObject
   {
   public:
     typedef typename MeasureTraits<Derived>::Values Values; ///< Measures' values along the time.
+    typedef typename MeasureTraits<Derived>::PackedValues PackedValues; ///< Measures' values stored in single precision.
     
     /**
-     * Returns values of the measure. The exact output type depend of the Derived class
+     * Returns values of the measure to modify them. The exact output type depend of the Derived class
+     * If the values are shared with another object (see IsValuesShared()), they are detached (copied) before to be returned.
+     * Use the const method to only read them. The returned reference must not be used after a copy of this object (see the class' description).
+     * If the values are packed (see PackValues()) or were appended (see AppendValues()), they are unpacked (see UnpackValues()) before to be returned.
      */
-    Values& GetValues() {return this->m_Values;};
+    Values& GetValues() {this->UnpackValues(); this->DetachValues(); return *(this->mp_Values);};
     /**
      * Returns values of the measure. The exact output type depend of the Derived class
+     * If the values are packed, a conversion in double precision is returned. It is built by the first call and kept with the packed values 
+     * until they are modified, unpacked or packed again (see PackValues()). The appended values (see AppendValues()) are read the same way, 
+     * with a copy built by the first call following the last append.
+     */
+    const Values& GetValues() const;
+    /**
+     * Returns a copy of the values in double precision, packed or not. The object is not modified.
      */
-    const Values& GetValues() const {return this->m_Values;};
+    Values CopyValues() const {return this->mp_Stream ? this->mp_Stream->GetFrames() : (this->mp_PackedValues ? Values(this->mp_PackedValues->template cast<double>()) : *(this->mp_Values));};
     /**
      * Sets values for the measure. The exact input type depend of the Derived class
      */
     void SetValues(const Values& v);
+    /**
+     * Returns true if the values are shared with another object (i.e. a copy not yet modified).
+     */
+    bool IsValuesShared() const {return this->mp_Stream ? (this->mp_Stream.use_count() > 1) : (this->mp_PackedValues ? (this->mp_PackedValues.use_count() > 1) : (this->mp_Values.use_count() > 1));};
+    /**
+     * Converts the values in single precision to halve their memory footprint.
+     * If the values are already packed, the conversion in double precision kept by the const method GetValues() is released.
+     */
+    void PackValues();
+    /**
+     * Converts packed values back in double precision and releases the single precision values.
+     * The appended values (see AppendValues()) are also copied back in a matrix with exactly one row per frame.
+     */
+    void UnpackValues();
+    /**
+     * Returns true if the values are stored in single precision.
+     */
+    bool IsValuesPacked() const {return (this->mp_PackedValues.get() != 0);};
+    /**
+     * Returns the values stored in single precision or a null pointer if they are not packed.
+     */
+    const PackedValues* GetPackedValues() const {return this->mp_PackedValues.get();};
+    /**
+     * Appends @a frameNumber frames to the values. The components of the frame @a i are read from @a values + @a i * @a stride (the frames are set to 0 if @a values is null).
+     * If @a maxFrameNumber is positive or null, only the last @a maxFrameNumber frames are kept (ring buffer).
+     */
+    void AppendValues(const double* values, int stride, int frameNumber, int maxFrameNumber = -1);
+    /**
+     * Returns the number of frames without converting packed values.
+     */
+    int GetFrameNumber() const {return this->mp_Stream ? this->mp_Stream->size : static_cast<int>(this->mp_PackedValues ? this->mp_PackedValues->rows() : this->mp_Values->rows());};
+    /**
+     * Returns the number of frames which can be stored before to reallocate the appended values (see AppendValues()).
+     * If no frame was appended since the values were last set or modified, this number corresponds to the number of frames.
+     */
+    int GetFrameCapacity() const {return this->mp_Stream ? static_cast<int>(this->mp_Stream->buffer.rows()) : this->GetFrameNumber();};
     
   protected:
     /**
@@ -80,8 +156,27 @@ namespace btk
      * Simply set the new values
      */
     MeasureData& operator=(const MeasureData& ); // Not implemented.
+    /**
+     * Copies the values if they are shared with another object.
+     */
+    void DetachValues();
+    /**
+     * Returns a resized copy of the matrix @a m. The new rows are set to 0.
+     */
+    template <typename M> static btkSharedPtr<M> ResizeMatrix(const M& m, int frameNumber);
+    /**
+     * Appends frames to the storage @a stream, created from the matrix @a m (then released) if it does not exist.
+     */
+    template <typename M> static void AppendMatrix(btkSharedPtr< MeasureStream_p<M> >& stream, btkSharedPtr<M>& m, const double* values, int stride, int frameNumber, int maxFrameNumber);
+    /**
+     * Returns a matrix with the frames of @a stream.
+     */
+    template <typename M> static btkSharedPtr<M> UnstreamMatrix(const MeasureStream_p<M>& stream) {return btkSharedPtr<M>(new M(stream.GetFrames()));};
     
-    typename MeasureData<Derived>::Values m_Values; ///< Values of the measure.
+    btkSharedPtr<typename MeasureData<Derived>::Values> mp_Values; ///< Values of the measure in double precision (shared between the copies until one of them is modified, null if packed).
+    btkSharedPtr<typename MeasureData<Derived>::PackedValues> mp_PackedValues; ///< Values of the measure in single precision (null if not packed).
+    mutable btkSharedPtr<typename MeasureData<Derived>::Values> mp_UnpackedValues; ///< Conversion of the packed or appended values read by the const method GetValues() (null if not packed or not yet read).
+    btkSharedPtr< MeasureStream_p<typename MeasureData<Derived>::Values> > mp_Stream; ///< Appended values (shared between the copies until one of them appends new frames, null if the values are not appended).
   };
   
   template <class Derived>
@@ -119,6 +214,27 @@ namespace btk
      */
     void SetFrameNumber(int frameNumber);
     
+    /**
+     * Returns a copy of the values in double precision, packed or not.
+     * @warning This method tries to access directly to data's values even if no data has been set.
+     */
+    Values CopyValues() const;
+    
+    /**
+     * Stores the values (and the other measures of the data, like the residuals of a point) in single precision.
+     * The values stay packed until they are accessed with the non-const method GetValues() or unpacked with UnpackValues(). This method does nothing if no data exists.
+     * If the values are already packed, their conversions kept by the const accessors are released.
+     */
+    void PackValues();
+    /**
+     * Converts the values (and the other measures of the data) back in double precision. This method does nothing if no data exists or if the values are not packed.
+     */
+    void UnpackValues();
+    /**
+     * Returns true if the values are stored in single precision.
+     */
+    bool IsValuesPacked() const {return (this->mp_Data ? this->mp_Data->IsValuesPacked() : false);};
+    
     /**
      * Returns the data associated to this measure.
      */
@@ -174,9 +290,16 @@ namespace btk
    const typename Measure<Derived>::Values& Measure<Derived>::GetValues() const
    {
      assert(this->mp_Data != Measure<Derived>::Data::Null);
-     return this->mp_Data->GetValues();
+     return static_cast<const typename Measure<Derived>::Data*>(this->mp_Data.get())->GetValues();
    };
   
+  template <class Derived>
+  typename Measure<Derived>::Values Measure<Derived>::CopyValues() const
+  {
+    assert(this->mp_Data != Measure<Derived>::Data::Null);
+    return this->mp_Data->CopyValues();
+  };
+  
   template <class Derived>
   void Measure<Derived>::SetValues(const typename Measure<Derived>::Values& v)
   {
@@ -191,7 +314,7 @@ namespace btk
   {
     if (!this->mp_Data)
       return 0;
-    return static_cast<int>(this->mp_Data->GetValues().rows());
+    return this->mp_Data->GetFrameNumber();
   };
  
   template <class Derived>
@@ -213,6 +336,26 @@ namespace btk
     this->Modified();
   };
 
+  template <class Derived>
+  void Measure<Derived>::PackValues()
+  {
+    if (!this->mp_Data)
+      return;
+    const bool packed = this->mp_Data->IsValuesPacked();
+    this->mp_Data->PackValues();
+    if (!packed)
+      this->Modified();
+  };
+  
+  template <class Derived>
+  void Measure<Derived>::UnpackValues()
+  {
+    if (!this->mp_Data || !this->mp_Data->IsValuesPacked())
+      return;
+    this->mp_Data->UnpackValues();
+    this->Modified();
+  };
+
   template <class Derived>
   void Measure<Derived>::SetData(typename Measure<Derived>::Data::Pointer data, bool parenting)
   {
@@ -266,24 +409,223 @@ namespace btk
    * Currently this class store a matrix defined by the given number of frames. The template @a Derived used by this class gives the number of columns (components) of the measure.
    *
    * To add a new type of data (for example for 2D pressure mat or insole), you have to inherit from this class and add the method Resize(int frameNumber). You can also add other informations in inherited classes, like btk::Point::Data which contains reconstruction residuals.
+   *
+   * The values are implicitly shared (copy-on-write): the copy constructor (and then the method Clone() of the inherited classes) 
+   * only shares the values with the copied object. They are copied the first time one of the objects accesses them 
+   * with the non-const method GetValues(). Reading the values from a const object never copies them: the code which only reads 
+   * the values (writers, filters reading their input, etc.) must use a const object (for example a ConstPointer) to keep them shared.
+   * @warning A reference (or a pointer to the coefficients) obtained with GetValues() is only valid until the next copy of this object 
+   * (or of the object sharing its values). After a copy, the reference still points to the shared storage: a modification done through 
+   * it is visible in both objects and, once one of them has detached its values, the reference can point to the storage of the other object. 
+   * The values must then be requested again with GetValues() after each copy. A reference is also invalidated by the methods 
+   * SetValues(), Resize(), PackValues() and UnpackValues().
+   *
+   * The values can also be packed in single precision (see PackValues()) to halve their memory footprint, for example when 
+   * a lot of acquisitions are kept in memory. The single precision matrix is then the only storage of the values: 
+   * it is read with GetPackedValues() or converted in a copy with CopyValues(), without modifying the object. 
+   * The packed values are converted back in double precision only by the non-const method GetValues() (to modify them) 
+   * or explicitly by UnpackValues(). The const method GetValues() returns a conversion of the packed values which is built 
+   * the first time it is called and then kept with them (the memory saving is lost until the values are packed again). 
+   * This conversion is protected by a lock, so that a packed object can be read concurrently by several threads.
+   *
+   * The frames added with the method AppendValues() (for example by Acquisition::CommitFrames()) are stored with a capacity larger 
+   * than their number (see GetFrameCapacity()), grown geometrically, so that each append only copies the new frames. If a maximum 
+   * number of frames is given, the storage is used as a ring buffer and the new frames replace the oldest ones in place. 
+   * The appended values are copied in a matrix by the accessors GetValues() the same way as the packed values: 
+   * the non-const accessor releases the appended storage, while the const accessor keeps a copy until the next append.
    */
   
   template <class Derived>
   MeasureData<Derived>::MeasureData(int frameNumber)
-  : DataObject(), m_Values(MeasureData::Values::Zero(frameNumber,Derived::Values::ColsAtCompileTime))
+  : DataObject(), mp_Values(new typename MeasureData<Derived>::Values(MeasureData::Values::Zero(frameNumber,Derived::Values::ColsAtCompileTime)))
   {};
   
  template <class Derived>
   MeasureData<Derived>::MeasureData(const MeasureData& toCopy)
-  : DataObject(toCopy), m_Values(toCopy.m_Values)
+  : DataObject(toCopy), mp_Values(toCopy.mp_Values), mp_PackedValues(toCopy.mp_PackedValues), mp_Stream(toCopy.mp_Stream)
   {};
   
+  template <class Derived>
+  const typename MeasureData<Derived>::Values& MeasureData<Derived>::GetValues() const
+  {
+    if (!this->mp_PackedValues && !this->mp_Stream)
+      return *(this->mp_Values);
+    MeasureDataLock_p lock;
+    if (!this->mp_UnpackedValues)
+    {
+      if (this->mp_Stream)
+        this->mp_UnpackedValues = UnstreamMatrix(*(this->mp_Stream));
+      else
+        this->mp_UnpackedValues = btkSharedPtr<typename MeasureData<Derived>::Values>(new typename MeasureData<Derived>::Values(this->mp_PackedValues->template cast<double>()));
+    }
+    return *(this->mp_UnpackedValues);
+  };
+  
   template <class Derived>
   void MeasureData<Derived>::SetValues(const typename MeasureData::Values& v)
   {
-    this->m_Values = v;
+    this->mp_PackedValues.reset();
+    this->mp_UnpackedValues.reset();
+    this->mp_Stream.reset();
+    if (!this->mp_Values || (this->mp_Values.use_count() > 1))
+      this->mp_Values = btkSharedPtr<typename MeasureData<Derived>::Values>(new typename MeasureData<Derived>::Values(v));
+    else
+      *(this->mp_Values) = v;
     this->Modified();
   };
+  
+  template <class Derived>
+  void MeasureData<Derived>::DetachValues()
+  {
+    if (this->IsValuesShared())
+      this->mp_Values = btkSharedPtr<typename MeasureData<Derived>::Values>(new typename MeasureData<Derived>::Values(*(this->mp_Values)));
+  };
+  
+  template <class Derived>
+  void MeasureData<Derived>::PackValues()
+  {
+    if (this->mp_PackedValues)
+    {
+      this->mp_UnpackedValues.reset();
+      return;
+    }
+    this->UnpackValues(); // Appended values
+    // The values shared with other objects are not modified: only this object uses the new storage.
+    this->mp_PackedValues = btkSharedPtr<typename MeasureData<Derived>::PackedValues>(new typename MeasureData<Derived>::PackedValues(this->mp_Values->template cast<float>()));
+    this->mp_Values.reset();
+  };
+  
+  template <class Derived>
+  void MeasureData<Derived>::UnpackValues()
+  {
+    if (!this->mp_PackedValues && !this->mp_Stream)
+      return;
+    if (this->mp_UnpackedValues)
+      this->mp_Values = this->mp_UnpackedValues;
+    else if (this->mp_Stream)
+      this->mp_Values = UnstreamMatrix(*(this->mp_Stream));
+    else
+      this->mp_Values = btkSharedPtr<typename MeasureData<Derived>::Values>(new typename MeasureData<Derived>::Values(this->mp_PackedValues->template cast<double>()));
+    this->mp_UnpackedValues.reset();
+    this->mp_PackedValues.reset();
+    this->mp_Stream.reset();
+  };
+  
+  template <class Derived>
+  void MeasureData<Derived>::AppendValues(const double* values, int stride, int frameNumber, int maxFrameNumber)
+  {
+    if (this->mp_PackedValues)
+      this->UnpackValues();
+    this->mp_UnpackedValues.reset();
+    AppendMatrix(this->mp_Stream, this->mp_Values, values, stride, frameNumber, maxFrameNumber);
+    this->Modified();
+  };
+  
+  template <class Derived>
+  template <typename M>
+  btkSharedPtr<M> MeasureData<Derived>::ResizeMatrix(const M& m, int frameNumber)
+  {
+    if (frameNumber <= m.rows())
+      return btkSharedPtr<M>(new M(m.topRows(frameNumber)));
+    btkSharedPtr<M> r(new M(M::Zero(frameNumber, M::ColsAtCompileTime)));
+    if (m.data() != 0)
+      r->topRows(m.rows()) = m;
+    return r;
+  };
+  
+  template <class Derived>
+  template <typename M>
+  void MeasureData<Derived>::AppendMatrix(btkSharedPtr< MeasureStream_p<M> >& stream, btkSharedPtr<M>& m, const double* values, int stride, int frameNumber, int maxFrameNumber)
+  {
+    if (!stream)
+    {
+      stream = btkSharedPtr< MeasureStream_p<M> >(new MeasureStream_p<M>);
+      // The matrix is reused as storage if it is not shared with another object.
+      if (m.use_count() == 1)
+        stream->buffer.swap(*m);
+      else
+        stream->buffer = *m;
+      stream->size = static_cast<int>(stream->buffer.rows());
+      m.reset();
+    }
+    else if (stream.use_count() > 1)
+      stream = btkSharedPtr< MeasureStream_p<M> >(new MeasureStream_p<M>(*stream));
+    stream->Append(values, stride, frameNumber, maxFrameNumber);
+  };
+  
+  // ----------------------------------------------------------------------- //
+  
+  /**
+   * @struct MeasureStream_p btkMeasure.h
+   * @brief Storage of the frames appended to a measure.
+   *
+   * @tparam M Type of matrix used to store the frames (one row per frame).
+   */
+  
+  /**
+   * Appends @a frameNumber frames read from @a values with a step of @a stride values between two frames (0 if @a values is null).
+   * The capacity is at least doubled when the frames do not fit in it. If @a maxFrameNumber is positive or null, the capacity is bounded 
+   * to this number and the new frames then replace the oldest ones.
+   */
+  template <typename M>
+  void MeasureStream_p<M>::Append(const double* values, int stride, int frameNumber, int maxFrameNumber)
+  {
+    if ((maxFrameNumber >= 0) && (frameNumber > maxFrameNumber))
+    {
+      if (values != 0)
+        values += (frameNumber - maxFrameNumber) * stride;
+      frameNumber = maxFrameNumber;
+    }
+    const int rows = static_cast<int>(this->buffer.rows());
+    int capacity = rows;
+    if (this->size + frameNumber > rows)
+      capacity = std::max(this->size + frameNumber, 2 * rows);
+    if ((maxFrameNumber >= 0) && (capacity > maxFrameNumber))
+      capacity = maxFrameNumber;
+    if (capacity != rows)
+      this->Reallocate(capacity);
+    const int cols = static_cast<int>(this->buffer.cols());
+    for (int i = 0 ; i < frameNumber ; ++i)
+    {
+      const int row = (this->head + this->size) % capacity;
+      for (int j = 0 ; j < cols ; ++j)
+        this->buffer.coeffRef(row, j) = (values != 0) ? values[i * stride + j] : 0.0;
+      if (this->size < capacity)
+        ++this->size;
+      else
+        this->head = (this->head + 1) % capacity;
+    }
+  };
+  
+  /**
+   * Moves the frames in a storage of @a capacity frames, starting at its first row. Only the last frames are kept if they do not fit.
+   */
+  template <typename M>
+  void MeasureStream_p<M>::Reallocate(int capacity)
+  {
+    const int num = std::min(this->size, capacity);
+    M b(capacity, this->buffer.cols());
+    this->CopyFrames(b, this->size - num, num);
+    this->buffer.swap(b);
+    this->head = 0;
+    this->size = num;
+  };
+  
+  /**
+   * Copies the frames from @a first to @a first + @a num - 1 in the first rows of @a m.
+   */
+  template <typename M>
+  void MeasureStream_p<M>::CopyFrames(M& m, int first, int num) const
+  {
+    if (num <= 0)
+      return;
+    const int rows = static_cast<int>(this->buffer.rows());
+    const int start = (this->head + first) % rows;
+    const int n = std::min(num, rows - start);
+    m.topRows(n) = this->buffer.middleRows(start, n);
+    if (n < num)
+      m.middleRows(n, num - n) = this->buffer.topRows(num - n);
+  };
 };
 
 #endif // __btkMeasure_h
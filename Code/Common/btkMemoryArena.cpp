@@ -0,0 +1,365 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkMemoryArena.h"
+#include "btkCriticalSection_p.h"
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <map>
+
+#if defined(_MSC_VER)
+  #define BTK_THREAD_LOCAL_P __declspec(thread)
+#else
+  #define BTK_THREAD_LOCAL_P __thread
+#endif
+
+namespace btk
+{
+  struct MemoryArenaStorage_p
+  {
+    std::vector<char*> blocks;
+    char* current; // Next free byte of the current block
+    size_t remaining; // Free bytes in the current block
+    char* last; // Start of the last allocation done in the current block (including its padding)
+    size_t usedSize;
+    int allocations;
+    bool closed; // No more allocation (the arena object is destroyed)
+  };
+  
+  struct MemoryArenaBlock_p
+  {
+    size_t size;
+    MemoryArenaStorage_p* storage;
+  };
+  
+  // All the blocks of the arenas, to find the arena of a pointer released by any thread.
+  static critical_section_p memoryArenaLock;
+  static std::map<const char*, MemoryArenaBlock_p> memoryArenaBlocks;
+  static volatile int memoryArenaBlockNumber = 0; // Read without the lock to not slow down the heap allocations
+  // Arena used by the current thread (see MemoryArena::Scope)
+  static BTK_THREAD_LOCAL_P MemoryArena* memoryArenaCurrent = 0;
+  
+  // Must be called with the lock acquired.
+  static std::map<const char*, MemoryArenaBlock_p>::iterator MemoryArenaFindBlock_p(const void* ptr)
+  {
+    const char* p = static_cast<const char*>(ptr);
+    std::map<const char*, MemoryArenaBlock_p>::iterator it = memoryArenaBlocks.upper_bound(p);
+    if (it == memoryArenaBlocks.begin())
+      return memoryArenaBlocks.end();
+    --it;
+    return (p < it->first + it->second.size) ? it : memoryArenaBlocks.end();
+  };
+  
+  // Must be called with the lock acquired.
+  static char* MemoryArenaNewBlock_p(MemoryArenaStorage_p* storage, size_t size)
+  {
+    char* block = static_cast<char*>(std::malloc(size));
+    if (block == 0)
+      throw std::bad_alloc();
+    storage->blocks.push_back(block);
+    MemoryArenaBlock_p b = {size, storage};
+    memoryArenaBlocks[block] = b;
+    ++memoryArenaBlockNumber;
+    return block;
+  };
+  
+  // Must be called with the lock acquired.
+  static void MemoryArenaFreeStorage_p(MemoryArenaStorage_p* storage)
+  {
+    for (size_t i = 0 ; i < storage->blocks.size() ; ++i)
+    {
+      memoryArenaBlocks.erase(storage->blocks[i]);
+      --memoryArenaBlockNumber;
+      std::free(storage->blocks[i]);
+    }
+    delete storage;
+  };
+  
+  /**
+   * @class MemoryArena btkMemoryArena.h
+   * @brief Monotonic memory buffer used to allocate the coefficients of many small matrices at once.
+   *
+   * The memory is requested by blocks (64 KB by default) and given sequentially by the method Allocate(). 
+   * It is not reused when an allocation is released (except the last one, like a stack): all the blocks 
+   * are freed in one shot once the arena is destroyed and all its allocations are released.
+   * The blocks can then outlive the arena object, for example when a measure is kept after the destruction 
+   * of the acquisition which contains it.
+   *
+   * The arena is used by the Eigen matrices (and then by the values of the measures) created by a thread 
+   * in the lifetime of a MemoryArena::Scope object. The allocations of Eigen are redirected by a plugin 
+   * (see btkEigen/Plugin/MemoryAddons.h and Utilities/eigen3/README.BTK) which is enabled by the header btkConfigure.h.
+   * @warning The code which modifies or destroys matrices allocated in an arena must be compiled with this plugin, 
+   * that is, it must include a BTK header before the Eigen headers.
+   *
+   * For example, the reader of acquisition files uses an arena for each read acquisition when the method 
+   * AcquisitionFileReader::SetMemoryArenaUsed() is enabled.
+   *
+   * The allocations and the releases are protected by a lock shared by all the arenas, but an arena should 
+   * be used by only one thread at a time.
+   *
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * @class MemoryArena::Scope btkMemoryArena.h
+   * @brief Uses a memory arena for the Eigen allocations of the current thread.
+   *
+   * The arena is used from the construction of this object to its destruction. The arena used before is then restored.
+   */
+  
+  /**
+   * Sets @a arena as the arena used by the current thread. A null pointer keeps the arena currently used (if any).
+   */
+  MemoryArena::Scope::Scope(MemoryArena::Pointer arena)
+  : mp_Arena(arena)
+  {
+    this->mp_Previous = memoryArenaCurrent;
+    if (this->mp_Arena)
+      memoryArenaCurrent = this->mp_Arena.get();
+  };
+  
+  /**
+   * Restores the arena used by the current thread before the construction of this object.
+   */
+  MemoryArena::Scope::~Scope()
+  {
+    memoryArenaCurrent = this->mp_Previous;
+  };
+  
+  /**
+   * @typedef MemoryArena::Pointer
+   * Smart pointer associated with a MemoryArena object.
+   */
+  
+  /**
+   * @typedef MemoryArena::ConstPointer
+   * Smart pointer associated with a const MemoryArena object.
+   */
+  
+  /**
+   * @typedef MemoryArena::NullPointer
+   * Special null pointer associated with a MemoryArena object.
+   */
+  
+  /**
+   * @fn static Pointer MemoryArena::New(size_t blockSize = 65536)
+   * Creates a smart pointer associated with a MemoryArena object. The memory will be requested by blocks of @a blockSize bytes.
+   */
+  
+  /**
+   * @fn static NullPointer MemoryArena::Null()
+   * Returns a null pointer associated with a MemoryArena object.
+   */
+  
+  /**
+   * Destructor. Frees all the blocks if all the allocations were released. Otherwise, they are freed with the last allocation.
+   */
+  MemoryArena::~MemoryArena()
+  {
+    memoryArenaLock.Lock();
+    this->mp_Storage->closed = true;
+    if (this->mp_Storage->allocations == 0)
+      MemoryArenaFreeStorage_p(this->mp_Storage);
+    memoryArenaLock.Unlock();
+  };
+  
+  /**
+   * @fn size_t MemoryArena::GetBlockSize() const
+   * Returns the size of the blocks requested by the arena.
+   */
+  
+  /**
+   * Returns the number of blocks allocated by the arena.
+   */
+  int MemoryArena::GetBlockNumber() const
+  {
+    memoryArenaLock.Lock();
+    const int num = static_cast<int>(this->mp_Storage->blocks.size());
+    memoryArenaLock.Unlock();
+    return num;
+  };
+  
+  /**
+   * Returns the number of bytes given by the method Allocate() (including the padding used for the alignment).
+   */
+  size_t MemoryArena::GetUsedSize() const
+  {
+    memoryArenaLock.Lock();
+    const size_t size = this->mp_Storage->usedSize;
+    memoryArenaLock.Unlock();
+    return size;
+  };
+  
+  /**
+   * Returns the number of allocations not yet released.
+   */
+  int MemoryArena::GetAllocationNumber() const
+  {
+    memoryArenaLock.Lock();
+    const int num = this->mp_Storage->allocations;
+    memoryArenaLock.Unlock();
+    return num;
+  };
+  
+  /**
+   * Returns a pointer on @a size bytes aligned on 16 bytes (as required by Eigen).
+   * A request bigger than the quarter of the block size uses its own block.
+   * Throws std::bad_alloc if the memory cannot be allocated.
+   */
+  void* MemoryArena::Allocate(size_t size)
+  {
+    const size_t alignment = 16;
+    if (size == 0)
+      size = 1;
+    memoryArenaLock.Lock();
+    MemoryArenaStorage_p* s = this->mp_Storage;
+    void* ptr = 0;
+    try
+    {
+      if (size + alignment > this->m_BlockSize / 4)
+      {
+        // Dedicated block: the current block is kept for the next requests.
+        char* block = MemoryArenaNewBlock_p(s, size + alignment);
+        const size_t padding = static_cast<size_t>(-reinterpret_cast<ptrdiff_t>(block)) & (alignment - 1);
+        s->usedSize += padding + size;
+        ptr = block + padding;
+      }
+      else
+      {
+        size_t padding = static_cast<size_t>(-reinterpret_cast<ptrdiff_t>(s->current)) & (alignment - 1);
+        if ((s->current == 0) || (padding + size > s->remaining))
+        {
+          s->current = MemoryArenaNewBlock_p(s, this->m_BlockSize);
+          s->remaining = this->m_BlockSize;
+          padding = static_cast<size_t>(-reinterpret_cast<ptrdiff_t>(s->current)) & (alignment - 1);
+        }
+        s->last = s->current;
+        ptr = s->current + padding;
+        s->current += padding + size;
+        s->remaining -= padding + size;
+        s->usedSize += padding + size;
+      }
+    }
+    catch (std::bad_alloc& )
+    {
+      memoryArenaLock.Unlock();
+      throw;
+    }
+    ++(s->allocations);
+    memoryArenaLock.Unlock();
+    return ptr;
+  };
+  
+  /**
+   * Releases the allocation @a ptr if it belongs to an arena and returns true. Otherwise, returns false.
+   * The memory of the last allocation done in the current block of the arena is reused.
+   */
+  bool MemoryArena::Release(void* ptr)
+  {
+    if ((ptr == 0) || (memoryArenaBlockNumber == 0))
+      return false;
+    memoryArenaLock.Lock();
+    std::map<const char*, MemoryArenaBlock_p>::iterator it = MemoryArenaFindBlock_p(ptr);
+    if (it == memoryArenaBlocks.end())
+    {
+      memoryArenaLock.Unlock();
+      return false;
+    }
+    MemoryArenaStorage_p* s = it->second.storage;
+    if ((s->last != 0) && (static_cast<char*>(ptr) >= s->last) && (static_cast<char*>(ptr) < s->current))
+    {
+      s->remaining += s->current - s->last;
+      s->current = s->last;
+      s->last = 0;
+    }
+    if ((--(s->allocations) == 0) && s->closed)
+      MemoryArenaFreeStorage_p(s);
+    memoryArenaLock.Unlock();
+    return true;
+  };
+  
+  /**
+   * Returns true if @a ptr was allocated in an arena.
+   */
+  bool MemoryArena::Contains(const void* ptr)
+  {
+    if ((ptr == 0) || (memoryArenaBlockNumber == 0))
+      return false;
+    memoryArenaLock.Lock();
+    const bool found = (MemoryArenaFindBlock_p(ptr) != memoryArenaBlocks.end());
+    memoryArenaLock.Unlock();
+    return found;
+  };
+  
+  /**
+   * Constructor.
+   */
+  MemoryArena::MemoryArena(size_t blockSize)
+  {
+    this->m_BlockSize = (blockSize < 1024) ? 1024 : blockSize;
+    this->mp_Storage = new MemoryArenaStorage_p;
+    this->mp_Storage->current = 0;
+    this->mp_Storage->remaining = 0;
+    this->mp_Storage->last = 0;
+    this->mp_Storage->usedSize = 0;
+    this->mp_Storage->allocations = 0;
+    this->mp_Storage->closed = false;
+  };
+};
+
+// Functions declared by the Eigen plugin btkEigen/Plugin/MemoryAddons.h
+namespace Eigen
+{
+  namespace internal
+  {
+    void* plugin_aligned_malloc(size_t size)
+    {
+      btk::MemoryArena* arena = btk::memoryArenaCurrent;
+      return (arena != 0) ? arena->Allocate(size) : 0;
+    };
+    
+    bool plugin_aligned_free(void* ptr)
+    {
+      return btk::MemoryArena::Release(ptr);
+    };
+    
+    bool plugin_aligned_realloc_is_generic(void* ptr)
+    {
+      return (btk::memoryArenaCurrent != 0) || btk::MemoryArena::Contains(ptr);
+    };
+  };
+};
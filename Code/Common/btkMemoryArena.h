@@ -0,0 +1,94 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkMemoryArena_h
+#define __btkMemoryArena_h
+
+#include "btkSharedPtr.h"
+#include "btkNullPtr.h"
+
+#include <cstddef> // size_t
+
+namespace btk
+{
+  struct MemoryArenaStorage_p;
+  
+  class MemoryArena
+  {
+  public:
+    typedef btkSharedPtr<MemoryArena> Pointer;
+    typedef btkSharedPtr<const MemoryArena> ConstPointer;
+    typedef btkNullPtr<MemoryArena> NullPointer;
+    
+    class Scope
+    {
+    public:
+      BTK_COMMON_EXPORT Scope(MemoryArena::Pointer arena);
+      BTK_COMMON_EXPORT ~Scope();
+    private:
+      Scope(const Scope& ); // Not implemented.
+      Scope& operator=(const Scope& ); // Not implemented.
+      
+      MemoryArena::Pointer mp_Arena;
+      MemoryArena* mp_Previous;
+    };
+    
+    static Pointer New(size_t blockSize = 65536) {return Pointer(new MemoryArena(blockSize));};
+    static NullPointer Null() {return NullPointer();};
+    
+    BTK_COMMON_EXPORT ~MemoryArena();
+    
+    size_t GetBlockSize() const {return this->m_BlockSize;};
+    BTK_COMMON_EXPORT int GetBlockNumber() const;
+    BTK_COMMON_EXPORT size_t GetUsedSize() const;
+    BTK_COMMON_EXPORT int GetAllocationNumber() const;
+    BTK_COMMON_EXPORT void* Allocate(size_t size);
+    
+    BTK_COMMON_EXPORT static bool Release(void* ptr);
+    BTK_COMMON_EXPORT static bool Contains(const void* ptr);
+    
+  protected:
+    BTK_COMMON_EXPORT MemoryArena(size_t blockSize);
+    
+  private:
+    MemoryArena(const MemoryArena& ); // Not implemented.
+    MemoryArena& operator=(const MemoryArena& ); // Not implemented.
+    
+    size_t m_BlockSize;
+    MemoryArenaStorage_p* mp_Storage;
+  };
+};
+
+#endif // __btkMemoryArena_h
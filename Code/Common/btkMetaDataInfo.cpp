@@ -52,6 +52,9 @@ namespace btk
    * - btk::MetaDataInfo::Integer: Signed integer type stored only on 16 bit. Possible values between -32767 and 32768;
    * - btk::MetaDataInfo::Real: Float type. Precision limited to 1e-5.
    *
+   * The values are implicitly shared (copy-on-write): a copy (see Clone()) shares the values of the 
+   * copied object until one of them is modified. The values are then copied before the modification.
+   *
    * @ingroup BTKCommon
    */
   
@@ -164,9 +167,7 @@ namespace btk
    */
 
   MetaDataInfo::~MetaDataInfo()
-  {
-    Clear_p(this->m_Format, this->m_Values);
-  }
+  {}
 
   /**
    * @fn Format MetaDataInfo::GetFormat() const
@@ -179,7 +180,7 @@ namespace btk
   std::string MetaDataInfo::GetFormatAsString() const
   {
     std::string format = "";
-    switch(this->m_Format)
+    switch(this->mp_Storage->format)
     {
       case Byte:
         format = "Byte";
@@ -203,20 +204,21 @@ namespace btk
    */
   void MetaDataInfo::SetFormat(Format format)
   {
-    if (this->m_Format == format)
+    if (this->mp_Storage->format == format)
       return;
+    this->Detach();
     
-    std::vector<void*> oldValues = this->m_Values;
+    std::vector<void*> oldValues = this->mp_Storage->values;
     
-    this->m_Values = Convertify_p(this->m_Format, format, this->m_Values);
-    Clear_p(this->m_Format, oldValues);
+    this->mp_Storage->values = Convertify_p(this->mp_Storage->format, format, this->mp_Storage->values);
+    Clear_p(this->mp_Storage->format, oldValues);
     
-    if (this->m_Format == Char)
+    if (this->mp_Storage->format == Char)
       this->m_Dims.erase(this->m_Dims.begin());
-    else if ((format == Char) && (this->m_Values.size() != 0))
-      this->m_Dims.insert(this->m_Dims.begin(), static_cast<uint8_t>(static_cast<std::string*>(this->m_Values[0])->length()));
+    else if ((format == Char) && (this->mp_Storage->values.size() != 0))
+      this->m_Dims.insert(this->m_Dims.begin(), static_cast<uint8_t>(static_cast<std::string*>(this->mp_Storage->values[0])->length()));
     
-    this->m_Format = format;
+    this->mp_Storage->format = format;
   };
 
   /**
@@ -243,23 +245,24 @@ namespace btk
     }
     if (this->m_Dims[idx] == val)
       return;
+    this->Detach();
     int oldProd = this->GetDimensionsProduct();
     uint8_t oldValue = this->m_Dims[idx];
     this->m_Dims[idx] = val;
     int prod = this->GetDimensionsProduct();
-    if (this->m_Format == Char)
+    if (this->mp_Storage->format == Char)
     {
       if (idx == 0)
       {
-        std::vector<void*>::iterator it = this->m_Values.begin();
-        while (it != this->m_Values.end())
+        std::vector<void*>::iterator it = this->mp_Storage->values.begin();
+        while (it != this->mp_Storage->values.end())
         {
           (static_cast<std::string*>(*it))->resize(val, ' ');
           ++it;
         }
       }
     }
-    if ( (this->m_Format != Char) || (idx != 0) )
+    if ( (this->mp_Storage->format != Char) || (idx != 0) )
     {
       int diffNb = val - oldValue;
       int repeat = this->GetDimensionsProduct(idx + 1);
@@ -267,17 +270,17 @@ namespace btk
       {
         int inc = 1;
         int step = prod / repeat;
-        if (this->m_Format == Char)
+        if (this->mp_Storage->format == Char)
           step = step / this->m_Dims[0];
         int elts = step / val;
         diffNb = diffNb * (-1);
         while(inc <= repeat)
         {
-          std::vector<void*>::iterator itStart = this->m_Values.begin();
-          std::vector<void*>::iterator itEnd = this->m_Values.begin();
+          std::vector<void*>::iterator itStart = this->mp_Storage->values.begin();
+          std::vector<void*>::iterator itEnd = this->mp_Storage->values.begin();
           std::advance(itStart, step * inc);
           std::advance(itEnd, step * inc + diffNb * elts);
-          Erase_p(this->m_Format, this->m_Values, itStart, itEnd);
+          Erase_p(this->mp_Storage->format, this->mp_Storage->values, itStart, itEnd);
           ++inc;
         }   
       }
@@ -285,14 +288,14 @@ namespace btk
       {
         int inc = repeat;
         int step = oldProd / repeat;
-        if (this->m_Format == Char)
+        if (this->mp_Storage->format == Char)
           step = step / this->m_Dims[0];
         int elts = step / oldValue;
         while(inc > 0)
         {
-          std::vector<void*>::iterator it = this->m_Values.begin();
+          std::vector<void*>::iterator it = this->mp_Storage->values.begin();
           std::advance(it, step * inc);
-          Insert_p(this->m_Format, this->m_Values, it, diffNb * elts);
+          Insert_p(this->mp_Storage->format, this->mp_Storage->values, it, diffNb * elts);
           --inc;
         }
       }
@@ -325,20 +328,21 @@ namespace btk
   {
     if (this->m_Dims == dims)
       return;
+    this->Detach();
     this->m_Dims = dims;
     if (dims.empty())
-      Resize_p(this->m_Format, this->m_Values, 1);
+      Resize_p(this->mp_Storage->format, this->mp_Storage->values, 1);
     else
     {
-      if (this->m_Format == Char)
+      if (this->mp_Storage->format == Char)
       {
         int prod = this->GetDimensionsProduct(1);
-        Resize_p(this->m_Values, prod, std::string(this->m_Dims[0], ' '));
+        Resize_p(this->mp_Storage->values, prod, std::string(this->m_Dims[0], ' '));
         for (int i = 0 ; i < prod ; ++i)
-          static_cast<std::string*>(this->m_Values[i])->resize(this->m_Dims[0], ' ');
+          static_cast<std::string*>(this->mp_Storage->values[i])->resize(this->m_Dims[0], ' ');
       }
       else
-        Resize_p(this->m_Format, this->m_Values, this->GetDimensionsProduct());
+        Resize_p(this->mp_Storage->format, this->mp_Storage->values, this->GetDimensionsProduct());
     }
   };
 
@@ -351,15 +355,16 @@ namespace btk
   {
     if (nb == static_cast<int>(this->m_Dims.size()))
       return;
+    this->Detach();
     if (nb < static_cast<int>(this->m_Dims.size()))
     {
       this->m_Dims.resize(nb, 1);    
       int inc = 0;
-      if (this->m_Format == Char)
+      if (this->mp_Storage->format == Char)
         inc = 1;
-      Resize_p(this->m_Format, this->m_Values, this->GetDimensionsProduct(inc));
-      if (this->m_Format == Char && nb == 0)
-        static_cast<std::string*>(this->m_Values[0])->resize(1, ' ');
+      Resize_p(this->mp_Storage->format, this->mp_Storage->values, this->GetDimensionsProduct(inc));
+      if (this->mp_Storage->format == Char && nb == 0)
+        static_cast<std::string*>(this->mp_Storage->values[0])->resize(1, ' ');
     }
     else
       this->m_Dims.resize(nb, 1);
@@ -368,16 +373,17 @@ namespace btk
 
   /**
    * Returns the value for the given @a idx or 0 if @a idx is out of range.
+   * @warning The returned value can be shared with copies of this object. Use the method SetValue() to modify it.
    */
   void* MetaDataInfo::GetValue(int idx) const
   {
-    if (idx >= static_cast<int>(this->m_Values.size()))
+    if (idx >= static_cast<int>(this->mp_Storage->values.size()))
     {
       btkErrorMacro("Out of range");
       return 0;
     }
     else
-      return this->m_Values[idx];
+      return this->mp_Storage->values[idx];
   };
 
   /**
@@ -387,14 +393,15 @@ namespace btk
    */
   void MetaDataInfo::SetValue(int idx, int8_t val)
   {
-    if (idx >= static_cast<int>(this->m_Values.size()))
+    if (idx >= static_cast<int>(this->mp_Storage->values.size()))
     {
       btkErrorMacro("Out of range");
       return;
     }
+    this->Detach();
     
-    Delete_p(this->m_Format, this->m_Values[idx]);
-    this->m_Values[idx] = Convertify_p(this->m_Format, val);
+    Delete_p(this->mp_Storage->format, this->mp_Storage->values[idx]);
+    this->mp_Storage->values[idx] = Convertify_p(this->mp_Storage->format, val);
   };
 
   /**
@@ -404,14 +411,15 @@ namespace btk
    */
   void MetaDataInfo::SetValue(int idx, int16_t val)
   {
-    if (idx >= static_cast<int>(this->m_Values.size()))
+    if (idx >= static_cast<int>(this->mp_Storage->values.size()))
     {
       btkErrorMacro("Out of range");
       return;
     }
+    this->Detach();
     
-    Delete_p(this->m_Format, this->m_Values[idx]);
-    this->m_Values[idx] = Convertify_p(this->m_Format, val);
+    Delete_p(this->mp_Storage->format, this->mp_Storage->values[idx]);
+    this->mp_Storage->values[idx] = Convertify_p(this->mp_Storage->format, val);
   };
 
   /**
@@ -421,14 +429,15 @@ namespace btk
    */
   void MetaDataInfo::SetValue(int idx, float val)
   {
-    if (idx >= static_cast<int>(this->m_Values.size()))
+    if (idx >= static_cast<int>(this->mp_Storage->values.size()))
     {
       btkErrorMacro("Out of range");
       return;
     }
+    this->Detach();
     
-    Delete_p(this->m_Format, this->m_Values[idx]);
-    this->m_Values[idx] = Convertify_p(this->m_Format, val);
+    Delete_p(this->mp_Storage->format, this->mp_Storage->values[idx]);
+    this->mp_Storage->values[idx] = Convertify_p(this->mp_Storage->format, val);
   };
 
   /**
@@ -439,22 +448,23 @@ namespace btk
    */
   void MetaDataInfo::SetValue(int idx, const std::string& val)
   {
-    if (idx >= static_cast<int>(this->m_Values.size()))
+    if (idx >= static_cast<int>(this->mp_Storage->values.size()))
     {
       btkErrorMacro("Out of range");
       return;
     }
+    this->Detach();
     
-    Delete_p(this->m_Format, this->m_Values[idx]);    
-    this->m_Values[idx] = Convertify_p(this->m_Format, val);
+    Delete_p(this->mp_Storage->format, this->mp_Storage->values[idx]);    
+    this->mp_Storage->values[idx] = Convertify_p(this->mp_Storage->format, val);
 
-    if (this->m_Format == Char)
+    if (this->mp_Storage->format == Char)
     {
       int len = static_cast<int>(val.length());
       if (len > this->m_Dims[0])
         this->m_Dims[0] = len;
       for (int i = 0 ; i < this->GetDimensionsProduct(1) ; ++i)
-        static_cast<std::string*>(this->m_Values[i])->resize(this->m_Dims[0], ' ');
+        static_cast<std::string*>(this->mp_Storage->values[i])->resize(this->m_Dims[0], ' ');
     }
   };
   
@@ -465,13 +475,14 @@ namespace btk
    */
   void MetaDataInfo::SetValue(int idx, int val)
   {
-    if (idx >= static_cast<int>(this->m_Values.size()))
+    if (idx >= static_cast<int>(this->mp_Storage->values.size()))
     {
       btkErrorMacro("Out of range");
       return;
     }
-    Delete_p(this->m_Format, this->m_Values[idx]);
-    this->m_Values[idx] = Convertify_p(this->m_Format, val);
+    this->Detach();
+    Delete_p(this->mp_Storage->format, this->mp_Storage->values[idx]);
+    this->mp_Storage->values[idx] = Convertify_p(this->mp_Storage->format, val);
   };
   
   /**
@@ -481,13 +492,14 @@ namespace btk
    */
   void MetaDataInfo::SetValue(int idx, double val)
   {
-    if (idx >= static_cast<int>(this->m_Values.size()))
+    if (idx >= static_cast<int>(this->mp_Storage->values.size()))
     {
       btkErrorMacro("Out of range");
       return;
     }
-    Delete_p(this->m_Format, this->m_Values[idx]);
-    this->m_Values[idx] = Convertify_p(this->m_Format, val);
+    this->Detach();
+    Delete_p(this->mp_Storage->format, this->mp_Storage->values[idx]);
+    this->mp_Storage->values[idx] = Convertify_p(this->mp_Storage->format, val);
   };
   
   /**
@@ -495,6 +507,11 @@ namespace btk
    * Returns if there is or not some data.
    */
   
+  /**
+   * @fn bool MetaDataInfo::IsValuesShared() const
+   * Returns true if the values are shared with another object (i.e. a copy not yet modified).
+   */
+  
   /**
    * @fn const std::vector<std::string>& MetaDataInfo::GetValues() const
    * Returns the values as a vector of strings.
@@ -546,12 +563,12 @@ namespace btk
    */
    void MetaDataInfo::SetValues(const std::vector<std::string>& val)
    {
-     Clear_p(this->m_Format, this->m_Values);
+     // New storage: the previous values could be shared with another object.
+     this->mp_Storage = btkSharedPtr<Storage>(new Storage(Char));
      this->FillDimensions(val);
-     this->m_Format = Char;
      std::vector<std::string> values = val;
      this->FillSource(values);
-     Voidify_p(values, this->m_Values);
+     Voidify_p(values, this->mp_Storage->values);
    };
 
    /**
@@ -563,10 +580,9 @@ namespace btk
    */
    void MetaDataInfo::SetValues(const std::vector<uint8_t>& dims, const std::vector<int8_t>& val)
    {
-     Clear_p(this->m_Format, this->m_Values);
+     this->mp_Storage = btkSharedPtr<Storage>(new Storage(Byte));
      this->m_Dims = dims;
-     this->m_Format = Byte;
-     Voidify_p(this->GetDimensionsProduct(), val, this->m_Values);
+     Voidify_p(this->GetDimensionsProduct(), val, this->mp_Storage->values);
    };
 
    /**
@@ -578,10 +594,9 @@ namespace btk
    */
    void MetaDataInfo::SetValues(const std::vector<uint8_t>& dims, const std::vector<int16_t>& val)
    {
-     Clear_p(this->m_Format, this->m_Values);
+     this->mp_Storage = btkSharedPtr<Storage>(new Storage(Integer));
      this->m_Dims = dims;
-     this->m_Format = Integer;
-     Voidify_p(this->GetDimensionsProduct(), val, this->m_Values);
+     Voidify_p(this->GetDimensionsProduct(), val, this->mp_Storage->values);
 
    };
    
@@ -594,10 +609,9 @@ namespace btk
    */
    void MetaDataInfo::SetValues(const std::vector<uint8_t>& dims, const std::vector<float>& val)
    {
-     Clear_p(this->m_Format, this->m_Values);
+     this->mp_Storage = btkSharedPtr<Storage>(new Storage(Real));
      this->m_Dims = dims;
-     this->m_Format = Real;
-     Voidify_p(this->GetDimensionsProduct(), val, this->m_Values);
+     Voidify_p(this->GetDimensionsProduct(), val, this->mp_Storage->values);
    };
    
    /**
@@ -611,17 +625,17 @@ namespace btk
    */
    void MetaDataInfo::SetValues(const std::vector<uint8_t>& dims, const std::vector<std::string>& val)
    {
-     Clear_p(this->m_Format, this->m_Values);
+     this->mp_Storage = btkSharedPtr<Storage>(new Storage(Char));
      this->m_Dims = dims;
-     this->m_Format = Char;
      std::vector<std::string> values = val;
      this->FillSource(values);
-     Voidify_p(values, this->m_Values);
+     Voidify_p(values, this->mp_Storage->values);
    };
 
   /**
    * @fn MetaDataInfo::Pointer MetaDataInfo::Clone() const
-   * Returns a deep copy of the object as a smart pointer.
+   * Returns a deep copy of the object as a smart pointer. 
+   * The values are implicitly shared with the copy until one of the objects is modified.
    */
 
   /**
@@ -629,7 +643,7 @@ namespace btk
    */
   const std::string MetaDataInfo::ToString(int idx) const
   {
-    return Devoidify_p<std::string>(this->m_Format, this->m_Values, idx, String);
+    return Devoidify_p<std::string>(this->mp_Storage->format, this->mp_Storage->values, idx, String);
   };
 
   /**
@@ -637,7 +651,7 @@ namespace btk
    */
   int8_t MetaDataInfo::ToInt8(int idx) const
   {
-    return Devoidify_p<int8_t>(this->m_Format, this->m_Values, idx, Int8);
+    return Devoidify_p<int8_t>(this->mp_Storage->format, this->mp_Storage->values, idx, Int8);
   };
 
   /**
@@ -645,7 +659,7 @@ namespace btk
    */
   uint8_t MetaDataInfo::ToUInt8(int idx) const
   {
-    return Devoidify_p<uint8_t>(this->m_Format, this->m_Values, idx, UInt8);
+    return Devoidify_p<uint8_t>(this->mp_Storage->format, this->mp_Storage->values, idx, UInt8);
   };
 
   /**
@@ -653,7 +667,7 @@ namespace btk
    */
   int16_t MetaDataInfo::ToInt16(int idx) const
   {
-    return Devoidify_p<int16_t>(this->m_Format, this->m_Values, idx, Int16);
+    return Devoidify_p<int16_t>(this->mp_Storage->format, this->mp_Storage->values, idx, Int16);
   };
 
   /**
@@ -661,7 +675,7 @@ namespace btk
    */
   uint16_t MetaDataInfo::ToUInt16(int idx) const
   {
-    return Devoidify_p<uint16_t>(this->m_Format, this->m_Values, idx, UInt16);
+    return Devoidify_p<uint16_t>(this->mp_Storage->format, this->mp_Storage->values, idx, UInt16);
   };
 
   /**
@@ -669,7 +683,7 @@ namespace btk
    */
   int MetaDataInfo::ToInt(int idx) const
   {
-    return Devoidify_p<int>(this->m_Format, this->m_Values, idx, Int);
+    return Devoidify_p<int>(this->mp_Storage->format, this->mp_Storage->values, idx, Int);
   };
 
   /**
@@ -677,7 +691,7 @@ namespace btk
    */
   unsigned int MetaDataInfo::ToUInt(int idx) const
   {
-    return Devoidify_p<unsigned int>(this->m_Format, this->m_Values, idx, UInt);
+    return Devoidify_p<unsigned int>(this->mp_Storage->format, this->mp_Storage->values, idx, UInt);
   };
 
   /**
@@ -685,7 +699,7 @@ namespace btk
    */
   float MetaDataInfo::ToFloat(int idx) const
   {
-    return Devoidify_p<float>(this->m_Format, this->m_Values, idx, Float);
+    return Devoidify_p<float>(this->mp_Storage->format, this->mp_Storage->values, idx, Float);
   };
 
   /**
@@ -693,7 +707,7 @@ namespace btk
    */
   double MetaDataInfo::ToDouble(int idx) const
   {
-    return Devoidify_p<double>(this->m_Format, this->m_Values, idx, Double);
+    return Devoidify_p<double>(this->mp_Storage->format, this->mp_Storage->values, idx, Double);
   };
 
   /**
@@ -701,7 +715,7 @@ namespace btk
    */
   const std::vector<std::string> MetaDataInfo::ToString() const
   {
-    return Devoidify_p<std::string>(this->m_Format, this->m_Values, String);
+    return Devoidify_p<std::string>(this->mp_Storage->format, this->mp_Storage->values, String);
   };
   
   /**
@@ -709,7 +723,7 @@ namespace btk
    */
   void MetaDataInfo::ToString(std::vector<std::string>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, String);
+    Devoidify_p(this->mp_Storage->format, this->mp_Storage->values, val, String);
   };
 
   /**
@@ -717,7 +731,7 @@ namespace btk
    */
   const std::vector<int8_t> MetaDataInfo::ToInt8() const
   {
-    return Devoidify_p<int8_t>(this->m_Format, this->m_Values, Int8);
+    return Devoidify_p<int8_t>(this->mp_Storage->format, this->mp_Storage->values, Int8);
   };
 
  /**
@@ -725,7 +739,7 @@ namespace btk
    */
    void MetaDataInfo::ToInt8(std::vector<int8_t>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, Int8);
+    Devoidify_p(this->mp_Storage->format, this->mp_Storage->values, val, Int8);
   };
 
   /**
@@ -733,7 +747,7 @@ namespace btk
    */
   const std::vector<uint8_t> MetaDataInfo::ToUInt8() const
   {
-    return Devoidify_p<uint8_t>(this->m_Format, this->m_Values, UInt8);
+    return Devoidify_p<uint8_t>(this->mp_Storage->format, this->mp_Storage->values, UInt8);
   };
 
   /**
@@ -741,7 +755,7 @@ namespace btk
    */
   void MetaDataInfo::ToUInt8(std::vector<uint8_t>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, UInt8);
+    Devoidify_p(this->mp_Storage->format, this->mp_Storage->values, val, UInt8);
   };
 
   /**
@@ -749,7 +763,7 @@ namespace btk
    */
   const std::vector<int16_t> MetaDataInfo::ToInt16() const
   {
-    return Devoidify_p<int16_t>(this->m_Format, this->m_Values, Int16);
+    return Devoidify_p<int16_t>(this->mp_Storage->format, this->mp_Storage->values, Int16);
   };
 
   /**
@@ -757,7 +771,7 @@ namespace btk
    */
   void MetaDataInfo::ToInt16(std::vector<int16_t>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, Int16);
+    Devoidify_p(this->mp_Storage->format, this->mp_Storage->values, val, Int16);
   };
 
   /**
@@ -765,7 +779,7 @@ namespace btk
    */
   const std::vector<uint16_t> MetaDataInfo::ToUInt16() const
   {
-    return Devoidify_p<uint16_t>(this->m_Format, this->m_Values, UInt16);
+    return Devoidify_p<uint16_t>(this->mp_Storage->format, this->mp_Storage->values, UInt16);
   };
 
   /**
@@ -773,7 +787,7 @@ namespace btk
    */
   void MetaDataInfo::ToUInt16(std::vector<uint16_t>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, UInt16);
+    Devoidify_p(this->mp_Storage->format, this->mp_Storage->values, val, UInt16);
   };
 
   /**
@@ -781,7 +795,7 @@ namespace btk
    */
   const std::vector<int> MetaDataInfo::ToInt() const
   {
-    return Devoidify_p<int>(this->m_Format, this->m_Values, Int);
+    return Devoidify_p<int>(this->mp_Storage->format, this->mp_Storage->values, Int);
   };
 
   /**
@@ -789,7 +803,7 @@ namespace btk
    */
   void MetaDataInfo::ToInt(std::vector<int>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, Int);
+    Devoidify_p(this->mp_Storage->format, this->mp_Storage->values, val, Int);
   };
 
   /**
@@ -797,7 +811,7 @@ namespace btk
    */
   const std::vector<unsigned int> MetaDataInfo::ToUInt() const
   {
-    return Devoidify_p<unsigned int>(this->m_Format, this->m_Values, UInt);
+    return Devoidify_p<unsigned int>(this->mp_Storage->format, this->mp_Storage->values, UInt);
   };
 
   /**
@@ -805,7 +819,7 @@ namespace btk
    */
   void MetaDataInfo::ToUInt(std::vector<unsigned int>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, UInt);
+    Devoidify_p(this->mp_Storage->format, this->mp_Storage->values, val, UInt);
   };
 
   /**
@@ -813,7 +827,7 @@ namespace btk
    */
   const std::vector<float> MetaDataInfo::ToFloat() const 
   {
-    return Devoidify_p<float>(this->m_Format, this->m_Values, Float);
+    return Devoidify_p<float>(this->mp_Storage->format, this->mp_Storage->values, Float);
   };
 
   /**
@@ -821,7 +835,7 @@ namespace btk
    */
   void MetaDataInfo::ToFloat(std::vector<float>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, Float);
+    Devoidify_p(this->mp_Storage->format, this->mp_Storage->values, val, Float);
   };
 
   /**
@@ -829,7 +843,7 @@ namespace btk
    */
   const std::vector<double> MetaDataInfo::ToDouble() const 
   {
-    return Devoidify_p<double>(this->m_Format, this->m_Values, Double);
+    return Devoidify_p<double>(this->mp_Storage->format, this->mp_Storage->values, Double);
   };
 
   /**
@@ -837,7 +851,7 @@ namespace btk
    */
   void MetaDataInfo::ToDouble(std::vector<double>& val) const
   {
-    Devoidify_p(this->m_Format, this->m_Values, val, Double);
+    Devoidify_p(this->mp_Storage->format, this->mp_Storage->values, val, Double);
   };
 
   
@@ -846,24 +860,24 @@ namespace btk
    */
   bool operator==(const MetaDataInfo& rLHS, const MetaDataInfo& rRHS)
   {
-    if (rLHS.m_Format != rRHS.m_Format) 
+    if (rLHS.mp_Storage->format != rRHS.mp_Storage->format) 
       return false;
     if (rLHS.m_Dims != rRHS.m_Dims) 
       return false;
     bool equal = false;
-    switch (rLHS.m_Format)
+    switch (rLHS.mp_Storage->format)
     {
     case MetaDataInfo::Char:
-      equal = OperatorEqual_p<std::string>(rLHS.m_Values, rRHS.m_Values);
+      equal = OperatorEqual_p<std::string>(rLHS.mp_Storage->values, rRHS.mp_Storage->values);
       break;
     case MetaDataInfo::Byte:
-      equal = OperatorEqual_p<char>(rLHS.m_Values, rRHS.m_Values);
+      equal = OperatorEqual_p<char>(rLHS.mp_Storage->values, rRHS.mp_Storage->values);
       break;
     case MetaDataInfo::Integer:
-      equal = OperatorEqual_p<int16_t>(rLHS.m_Values, rRHS.m_Values);
+      equal = OperatorEqual_p<int16_t>(rLHS.mp_Storage->values, rRHS.mp_Storage->values);
       break;
     case MetaDataInfo::Real:
-      equal = OperatorEqual_p<float>(rLHS.m_Values, rRHS.m_Values);
+      equal = OperatorEqual_p<float>(rLHS.mp_Storage->values, rRHS.mp_Storage->values);
       break;
     }
     return equal;
@@ -879,10 +893,9 @@ namespace btk
    * The dimension's value is equal to the size of @a val.
    */
   MetaDataInfo::MetaDataInfo(const std::string& val)
-  : m_Dims(std::vector<uint8_t>(1,static_cast<uint8_t>(val.length())))
+  : m_Dims(std::vector<uint8_t>(1,static_cast<uint8_t>(val.length()))), mp_Storage(new Storage(Char))
   {
-    this->m_Format = Char;
-    Voidify_p(std::vector<std::string>(1, val), this->m_Values);
+    Voidify_p(std::vector<std::string>(1, val), this->mp_Storage->values);
   };
 
   /**
@@ -890,12 +903,12 @@ namespace btk
    * @warning The number of values must be lower than 256 and the maximum length for the strings is equal to 255.
    */
   MetaDataInfo::MetaDataInfo(const std::vector<std::string>& val)
+  : m_Dims(), mp_Storage(new Storage(Char))
   {
     std::vector<std::string> values = val;
     this->FillDimensions(values);
     this->FillSource(values);
-    this->m_Format = Char;
-    Voidify_p(values, this->m_Values);
+    Voidify_p(values, this->mp_Storage->values);
   };
 
   /**
@@ -905,10 +918,9 @@ namespace btk
    * @warning Each dimension must be lower than 256.
    */
   MetaDataInfo::MetaDataInfo(const std::vector<uint8_t>& dims, const std::vector<int8_t>& val)
-  : m_Dims(dims)
+  : m_Dims(dims), mp_Storage(new Storage(Byte))
   {
-    this->m_Format = Byte;
-    Voidify_p(this->GetDimensionsProduct(), val, this->m_Values);
+    Voidify_p(this->GetDimensionsProduct(), val, this->mp_Storage->values);
   };
   
   /**
@@ -918,10 +930,9 @@ namespace btk
    * @warning Each dimension must be lower than 256.
    */
   MetaDataInfo::MetaDataInfo(const std::vector<uint8_t>& dims, const std::vector<int16_t>& val)
-  : m_Dims(dims)
+  : m_Dims(dims), mp_Storage(new Storage(Integer))
   {
-    this->m_Format = Integer;
-    Voidify_p(this->GetDimensionsProduct(), val, this->m_Values);
+    Voidify_p(this->GetDimensionsProduct(), val, this->mp_Storage->values);
   };
 
   /**
@@ -931,10 +942,9 @@ namespace btk
    * @warning Each dimension must be lower than 256.
    */
   MetaDataInfo::MetaDataInfo(const std::vector<uint8_t>& dims, const std::vector<float>& val)
-  : m_Dims(dims)
+  : m_Dims(dims), mp_Storage(new Storage(Real))
   {
-    this->m_Format = Real;
-    Voidify_p(this->GetDimensionsProduct(), val, this->m_Values);
+    Voidify_p(this->GetDimensionsProduct(), val, this->mp_Storage->values);
   };
 
   /**
@@ -946,22 +956,38 @@ namespace btk
    * @warning Each dimension must be lower than 256.
    */
   MetaDataInfo::MetaDataInfo(const std::vector<uint8_t>& dims, const std::vector<std::string>& val)
-  : m_Dims(dims)
+  : m_Dims(dims), mp_Storage(new Storage(Char))
   {
-    this->m_Format = Char;
     std::vector<std::string> values = val;  
     this->FillSource(values);
-    Voidify_p(values, this->m_Values);
+    Voidify_p(values, this->mp_Storage->values);
   };
    
   /**
-   * Copy constructor
+   * Copy constructor. The values are shared with @a toCopy until one of the objects is modified.
    */
   MetaDataInfo::MetaDataInfo(const MetaDataInfo& toCopy)
-  : m_Dims(toCopy.m_Dims)
+  : m_Dims(toCopy.m_Dims), mp_Storage(toCopy.mp_Storage)
+  {};
+  
+  /*
+   * Copies the values if they are shared with another object.
+   */
+  void MetaDataInfo::Detach()
+  {
+    if (!this->IsValuesShared())
+      return;
+    Storage* storage = new Storage(this->mp_Storage->format);
+    Copy_p(storage->format, this->mp_Storage->values, storage->values);
+    this->mp_Storage = btkSharedPtr<Storage>(storage);
+  };
+  
+  /*
+   * Delete the values.
+   */
+  MetaDataInfo::Storage::~Storage()
   {
-    this->m_Format = toCopy.m_Format;
-    Copy_p(this->m_Format, toCopy.m_Values, this->m_Values);
+    Clear_p(this->format, this->values);
   };
 
   /*
@@ -76,7 +76,7 @@ namespace btk
 
     BTK_COMMON_EXPORT ~MetaDataInfo();
     
-    Format GetFormat() const {return this->m_Format;};
+    Format GetFormat() const {return this->mp_Storage->format;};
     BTK_COMMON_EXPORT std::string GetFormatAsString() const;
     BTK_COMMON_EXPORT void SetFormat(Format format);
     BTK_COMMON_EXPORT uint8_t GetDimension(int idx) const;
@@ -92,8 +92,9 @@ namespace btk
     BTK_COMMON_EXPORT void SetValue(int idx, const std::string& val);
     BTK_COMMON_EXPORT void SetValue(int idx, int val);
     BTK_COMMON_EXPORT void SetValue(int idx, double val);
-    bool HasValues() const {return !this->m_Values.empty();};
-    const std::vector<void*>& GetValues() const {return this->m_Values;};
+    bool HasValues() const {return !this->mp_Storage->values.empty();};
+    bool IsValuesShared() const {return (this->mp_Storage.use_count() > 1);};
+    const std::vector<void*>& GetValues() const {return this->mp_Storage->values;};
     void SetValues(int8_t val) {this->SetValues(std::vector<uint8_t>(0), std::vector<int8_t>(1, val));};
     void SetValues(int16_t val) {this->SetValues(std::vector<uint8_t>(0), std::vector<int16_t>(1, val));};
     void SetValues(float val) {this->SetValues(std::vector<uint8_t>(0), std::vector<float>(1, val));};
@@ -156,10 +157,19 @@ namespace btk
 
     void FillDimensions(const std::vector<std::string>& val);
     void FillSource(std::vector<std::string>& val) const;
+    void Detach();
+    
+    // Values (and their format) shared between the copies until one of them is modified.
+    struct Storage
+    {
+      Storage(Format f) : format(f), values() {};
+      ~Storage();
+      Format format;
+      std::vector<void*> values;
+    };
 
     std::vector<uint8_t> m_Dims;
-    Format m_Format;
-    std::vector<void*> m_Values;
+    btkSharedPtr<Storage> mp_Storage;
   };
 };
 
@@ -0,0 +1,232 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+ 
+#include "btkOcclusionMask.h"
+#include "btkLogger.h"
+
+#include <algorithm>
+
+namespace btk
+{
+  /**
+   * @class OcclusionMask btkOcclusionMask.h
+   * @brief Compact validity mask of a point along the time, with the index of its gaps.
+   *
+   * A frame is occluded when the residual of the point is negative, and valid otherwise (see Point::GetResiduals()).
+   * The validity of each frame is stored in one bit (see GetWords()) and the consecutive occluded frames are 
+   * indexed as gaps (see GetGaps()). So, the number of gaps, the longest gap or the valid frame ranges 
+   * are known without scanning the residuals.
+   *
+   * The masks of several points can be combined with the operators &= (frames valid for all the points) 
+   * and |= (frames valid for at least one point). The method FillOccluded() sets the occluded frames 
+   * of a matrix, gap by gap.
+   *
+   * The mask of a point is given by the method Point::GetOcclusionMask().
+   *
+   * @ingroup BTKCommon
+   */
+  
+  /**
+   * @typedef OcclusionMask::Word
+   * Integer type used to store the validity of 64 frames.
+   */
+  
+  /**
+   * @struct OcclusionMask::Range
+   * Consecutive frames (gap or valid frames) starting at the index @a start and lasting @a length frames.
+   */
+  
+  /**
+   * @fn OcclusionMask::OcclusionMask(int frameNumber = 0)
+   * Constructor with @a frameNumber valid frames.
+   */
+  
+  /**
+   * @fn OcclusionMask::OcclusionMask(const double* residuals, int frameNumber)
+   * Constructor from the @a frameNumber first @a residuals. Negative residuals correspond to occluded frames.
+   * The other residuals (including NaN) correspond to valid frames.
+   */
+  
+  /**
+   * @fn OcclusionMask::OcclusionMask(const float* residuals, int frameNumber)
+   * Constructor from the @a frameNumber first @a residuals stored in single precision.
+   */
+  
+  /**
+   * @fn int OcclusionMask::GetFrameNumber() const
+   * Returns the number of frames.
+   */
+  
+  /**
+   * @fn bool OcclusionMask::IsValid(int frame) const
+   * Returns true if the frame with the index @a frame is valid. The index is not checked.
+   */
+  
+  /**
+   * @fn bool OcclusionMask::IsOccluded(int frame) const
+   * Returns true if the frame with the index @a frame is occluded. The index is not checked.
+   */
+  
+  /**
+   * @fn int OcclusionMask::GetValidFrameNumber() const
+   * Returns the number of valid frames.
+   */
+  
+  /**
+   * @fn int OcclusionMask::GetOccludedFrameNumber() const
+   * Returns the number of occluded frames.
+   */
+  
+  /**
+   * @fn int OcclusionMask::GetGapNumber() const
+   * Returns the number of gaps (consecutive occluded frames).
+   */
+  
+  /**
+   * @fn const std::vector<Range>& OcclusionMask::GetGaps() const
+   * Returns the gaps sorted by their first frame.
+   */
+  
+  /**
+   * @fn int OcclusionMask::GetLongestGap() const
+   * Returns the length of the longest gap (0 if there is no gap).
+   */
+  
+  /**
+   * Returns the ranges of consecutive valid frames, i.e. the frames between the gaps.
+   */
+  std::vector<OcclusionMask::Range> OcclusionMask::GetValidRanges() const
+  {
+    std::vector<Range> ranges;
+    ranges.reserve(this->m_Gaps.size() + 1);
+    int start = 0;
+    for (std::vector<Range>::const_iterator it = this->m_Gaps.begin() ; it != this->m_Gaps.end() ; ++it)
+    {
+      if (it->start > start)
+      {
+        Range r = {start, it->start - start};
+        ranges.push_back(r);
+      }
+      start = it->start + it->length;
+    }
+    if (start < this->m_FrameNumber)
+    {
+      Range r = {start, this->m_FrameNumber - start};
+      ranges.push_back(r);
+    }
+    return ranges;
+  };
+  
+  /**
+   * @fn const std::vector<Word>& OcclusionMask::GetWords() const
+   * Returns the validity bits. The bit @a f % 64 of the word @a f / 64 is set if the frame @a f is valid.
+   * The bits after the last frame are not set.
+   */
+  
+  /**
+   * Keeps only the frames valid in this mask and in @a rhs (e.g. the frames where all the markers of a segment are visible).
+   * Both masks must have the same number of frames.
+   */
+  OcclusionMask& OcclusionMask::operator&=(const OcclusionMask& rhs)
+  {
+    if (this->m_FrameNumber != rhs.m_FrameNumber)
+    {
+      btkErrorMacro("Impossible to combine occlusion masks with a different number of frames.");
+      return *this;
+    }
+    for (size_t i = 0 ; i < this->m_Words.size() ; ++i)
+      this->m_Words[i] &= rhs.m_Words[i];
+    this->Index();
+    return *this;
+  };
+  
+  /**
+   * Sets the frames valid in this mask or in @a rhs as valid.
+   * Both masks must have the same number of frames.
+   */
+  OcclusionMask& OcclusionMask::operator|=(const OcclusionMask& rhs)
+  {
+    if (this->m_FrameNumber != rhs.m_FrameNumber)
+    {
+      btkErrorMacro("Impossible to combine occlusion masks with a different number of frames.");
+      return *this;
+    }
+    for (size_t i = 0 ; i < this->m_Words.size() ; ++i)
+      this->m_Words[i] |= rhs.m_Words[i];
+    this->Index();
+    return *this;
+  };
+  
+  /**
+   * @fn template <typename Derived> void OcclusionMask::FillOccluded(Eigen::MatrixBase<Derived>& m, double value) const
+   * Sets the rows of the matrix @a m corresponding to occluded frames to @a value (e.g. -1.0 for residuals).
+   * The number of rows of @a m must be equal to the number of frames.
+   */
+  
+  /**
+   * Builds the index of the gaps from the validity bits. The words of 64 valid (or occluded) frames are skipped at once.
+   */
+  void OcclusionMask::Index()
+  {
+    const Word full = ~static_cast<Word>(0);
+    const int num = this->m_FrameNumber;
+    this->m_Gaps.clear();
+    this->m_OccludedFrameNumber = 0;
+    this->m_LongestGap = 0;
+    int f = 0;
+    while (f < num)
+    {
+      if (((f & 63) == 0) && (f + 64 <= num) && (this->m_Words[f >> 6] == full))
+        f += 64;
+      else if (this->IsValid(f))
+        ++f;
+      else
+      {
+        Range gap = {f, 0};
+        while ((f < num) && this->IsOccluded(f))
+        {
+          if (((f & 63) == 0) && (f + 64 <= num) && (this->m_Words[f >> 6] == 0))
+            f += 64;
+          else
+            ++f;
+        }
+        gap.length = f - gap.start;
+        this->m_Gaps.push_back(gap);
+        this->m_OccludedFrameNumber += gap.length;
+        this->m_LongestGap = std::max(this->m_LongestGap, gap.length);
+      }
+    }
+  };
+};
@@ -0,0 +1,125 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkOcclusionMask_h
+#define __btkOcclusionMask_h
+
+#include "btkConfigure.h"
+
+#include <Eigen/Core>
+#include <vector>
+
+#ifdef _MSC_VER
+  #include "Utilities/stdint.h"
+#else
+  #include <stdint.h>
+#endif
+
+namespace btk
+{
+  class OcclusionMask
+  {
+  public:
+    typedef uint64_t Word;
+    
+    struct Range
+    {
+      int start;
+      int length;
+    };
+    
+    explicit OcclusionMask(int frameNumber = 0) {this->Assign(static_cast<const double*>(0), frameNumber);};
+    OcclusionMask(const double* residuals, int frameNumber) {this->Assign(residuals, frameNumber);};
+    OcclusionMask(const float* residuals, int frameNumber) {this->Assign(residuals, frameNumber);};
+    // ~OcclusionMask(); // Implicit.
+    // OcclusionMask(const OcclusionMask& ); // Implicit.
+    // OcclusionMask& operator=(const OcclusionMask& ); // Implicit.
+    
+    int GetFrameNumber() const {return this->m_FrameNumber;};
+    bool IsValid(int frame) const {return ((this->m_Words[frame >> 6] >> (frame & 63)) & 1) != 0;};
+    bool IsOccluded(int frame) const {return !this->IsValid(frame);};
+    int GetValidFrameNumber() const {return this->m_FrameNumber - this->m_OccludedFrameNumber;};
+    int GetOccludedFrameNumber() const {return this->m_OccludedFrameNumber;};
+    
+    int GetGapNumber() const {return static_cast<int>(this->m_Gaps.size());};
+    const std::vector<Range>& GetGaps() const {return this->m_Gaps;};
+    int GetLongestGap() const {return this->m_LongestGap;};
+    BTK_COMMON_EXPORT std::vector<Range> GetValidRanges() const;
+    
+    const std::vector<Word>& GetWords() const {return this->m_Words;};
+    
+    BTK_COMMON_EXPORT OcclusionMask& operator&=(const OcclusionMask& rhs);
+    BTK_COMMON_EXPORT OcclusionMask& operator|=(const OcclusionMask& rhs);
+    
+    template <typename Derived> void FillOccluded(Eigen::MatrixBase<Derived>& m, double value) const;
+    
+  private:
+    template <typename T> void Assign(const T* residuals, int frameNumber);
+    BTK_COMMON_EXPORT void Index();
+    
+    int m_FrameNumber;
+    int m_OccludedFrameNumber;
+    int m_LongestGap;
+    std::vector<Word> m_Words;
+    std::vector<Range> m_Gaps;
+  };
+  
+  template <typename Derived>
+  void OcclusionMask::FillOccluded(Eigen::MatrixBase<Derived>& m, double value) const
+  {
+    for (std::vector<Range>::const_iterator it = this->m_Gaps.begin() ; it != this->m_Gaps.end() ; ++it)
+      m.middleRows(it->start, it->length).setConstant(value);
+  };
+  
+  template <typename T>
+  void OcclusionMask::Assign(const T* residuals, int frameNumber)
+  {
+    this->m_FrameNumber = (frameNumber < 0) ? 0 : frameNumber;
+    this->m_Words.assign((this->m_FrameNumber + 63) / 64, 0);
+    if (residuals == 0)
+    {
+      for (int f = 0 ; f < this->m_FrameNumber ; ++f)
+        this->m_Words[f >> 6] |= static_cast<Word>(1) << (f & 63);
+    }
+    else
+    {
+      for (int f = 0 ; f < this->m_FrameNumber ; ++f)
+        this->m_Words[f >> 6] |= static_cast<Word>(!(residuals[f] < static_cast<T>(0))) << (f & 63); // Only the negative residuals are occluded (not NaN)
+    }
+    this->Index();
+  };
+};
+
+#endif // __btkOcclusionMask_h
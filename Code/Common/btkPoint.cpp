@@ -184,7 +184,17 @@ namespace btk
   const Point::Residuals& Point::GetResiduals() const
   {
     assert(this->mp_Data != Point::Data::Null);
-    return this->mp_Data->GetResiduals();
+    return static_cast<const Point::Data*>(this->mp_Data.get())->GetResiduals();
+  };
+  
+  /**
+   * Convenient method to return a copy of the residuals in double precision, packed or not (see MeasureTraits<Point>::Data::CopyResiduals()).
+   * @warning This method tries to access directly to data's residuals even if no data has been set. Use this method carefully or use GetData() to access to point's data. 
+   */
+  Point::Residuals Point::CopyResiduals() const
+  {
+    assert(this->mp_Data != Point::Data::Null);
+    return this->mp_Data->CopyResiduals();
   };
 
   /**
@@ -197,6 +207,16 @@ namespace btk
     this->mp_Data->SetResiduals(r);
     this->Modified();
   };
+  
+  /**
+   * Convenient method to return the occlusion mask built from the residuals (see MeasureTraits<Point>::Data::GetOcclusionMask()).
+   * @warning This method tries to access directly to data's residuals even if no data has been set. Use this method carefully or use GetData() to access to point's data. 
+   */
+  const OcclusionMask& Point::GetOcclusionMask() const
+  {
+    assert(this->mp_Data != Point::Data::Null);
+    return static_cast<const Point::Data*>(this->mp_Data.get())->GetOcclusionMask();
+  };
 
   /**
    * @fn Type Point::GetType() const
@@ -216,7 +236,8 @@ namespace btk
   
   /**
    * @fn Pointer Point::Clone() const
-   * Returns a deep copy of this object.
+   * Returns a deep copy of this object. The values and the residuals are implicitly shared with the copy until one of them is modified.
+   * @warning The references to the values and residuals obtained before the copy must not be used anymore (see MeasureData).
    */
 
   /**
@@ -263,6 +284,16 @@ namespace btk
    * @typedef MeasureTraits<Point>::Residuals
    * Vector of double representing the residuals associated with each frames (if applicable).
    */
+  
+  /**
+   * @typedef MeasureTraits<Point>::PackedValues
+   * Point' values stored in single precision (see MeasureTraits<Point>::Data::PackValues()).
+   */
+  
+  /**
+   * @typedef MeasureTraits<Point>::PackedResiduals
+   * Point' residuals stored in single precision (see MeasureTraits<Point>::Data::PackValues()).
+   */
    
   /**
    * @typedef MeasureTraits<Point>::Data::Pointer
@@ -304,11 +335,21 @@ namespace btk
   /**
    * @fn MeasureTraits<Point>::Data::Residuals& MeasureTraits<Point>::Data::GetResiduals()
    * Returns the residuals for to this data.
+   * If the residuals are shared with another object (see IsResidualsShared()), they are detached (copied) before to be returned.
+   * If the residuals are packed, they are converted back in double precision before to be returned.
+   * Use the const method to only read them. As for the values, the returned reference must not be used after a copy of this object (see MeasureData).
    */
   
   /**
    * @fn const MeasureTraits<Point>::Data::Residuals& MeasureTraits<Point>::Data::GetResiduals() const
    * Returns the residuals for to this data.
+   * If the residuals are packed, a conversion in double precision is returned. It is built by the first call and kept 
+   * until the residuals are modified, unpacked or packed again (see MeasureData::GetValues() const).
+   */
+  
+  /**
+   * @fn MeasureTraits<Point>::Data::Residuals MeasureTraits<Point>::Data::CopyResiduals() const
+   * Returns a copy of the residuals in double precision, packed or not. The object is not modified.
    */
   
   /**
@@ -316,8 +357,46 @@ namespace btk
    * Sets the residuals for to this data.
    */
  
+  /**
+   * @fn bool MeasureTraits<Point>::Data::IsResidualsShared() const
+   * Returns true if the residuals are shared with another object (i.e. a copy not yet modified).
+   */
+  
+  /**
+   * @fn const OcclusionMask& MeasureTraits<Point>::Data::GetOcclusionMask() const
+   * Returns the validity of each frame (negative residual for an occluded frame) and the index of the gaps.
+   * The mask is built from the residuals (packed or not) the first time it is requested and kept until the residuals are 
+   * accessed for modification (non-const GetResiduals(), SetResiduals(), Resize(), AppendValues()), which invalidates the returned reference. 
+   * A modification done through a reference to the residuals obtained before the last call to this method is not detected: 
+   * the residuals must be requested again with the non-const method GetResiduals() before reading the mask.
+   */
+  
+  /**
+   * @fn void MeasureTraits<Point>::Data::PackValues()
+   * Converts the values and the residuals in single precision. They stay packed until they are accessed for modification 
+   * (non-const GetValues() or GetResiduals(), which convert them separately) or until UnpackValues() is called.
+   * If they are already packed, their conversions kept by the const accessors are released.
+   */
+  
+  /**
+   * @fn void MeasureTraits<Point>::Data::UnpackValues()
+   * Converts the values and the residuals back in double precision.
+   */
+  
+  /**
+   * @fn void MeasureTraits<Point>::Data::AppendValues(const double* values, int stride, const double* residuals, int residualStride, int frameNumber, int maxFrameNumber = -1)
+   * Appends @a frameNumber frames to the values and the residuals. The coordinates and the residual of the frame @a i are read 
+   * from @a values + @a i * @a stride and @a residuals + @a i * @a residualStride (null pointers set the frames to 0).
+   * If @a maxFrameNumber is positive or null, only the last @a maxFrameNumber frames are kept (see MeasureData::AppendValues()).
+   */
+  
+  /**
+   * @fn const MeasureTraits<Point>::PackedResiduals* MeasureTraits<Point>::Data::GetPackedResiduals() const
+   * Returns the residuals stored in single precision or a null pointer if they are not packed.
+   */
+ 
   /**
    * @fn MeasureTraits<Point>::Data::Pointer MeasureTraits<Point>::Data::Clone() const
-   * Deep copy of the current object.
+   * Copy of the current object. The values and the residuals are shared with the current object until one of them is modified.
    */
 }
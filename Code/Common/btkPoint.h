@@ -37,6 +37,7 @@
 #define __btkPoint_h
 
 #include "btkMeasure.h"
+#include "btkOcclusionMask.h"
 
 namespace btk
 {
@@ -47,6 +48,8 @@ namespace btk
   {
     typedef Eigen::Matrix<double, Eigen::Dynamic, 3> Values; ///< Point' values along the time with 3 components (3 columns).
     typedef Eigen::Matrix<double, Eigen::Dynamic, 1> Residuals; ///< Vector of double representing the residuals associated with each frames (if applicable).
+    typedef Eigen::Matrix<float, Eigen::Dynamic, 3> PackedValues; ///< Point' values stored in single precision.
+    typedef Eigen::Matrix<float, Eigen::Dynamic, 1> PackedResiduals; ///< Point' residuals stored in single precision.
     
     /**
      * @class Data
@@ -67,18 +70,32 @@ namespace btk
       
       void Resize(int frameNumber);
       
-      Residuals& GetResiduals() {return this->m_Residuals;};
-      const Residuals& GetResiduals() const {return this->m_Residuals;};
-      void SetResiduals(const Residuals& r) {this->m_Residuals = r; this->Modified();};
+      Residuals& GetResiduals() {this->UnpackResiduals(); this->DetachResiduals(); this->mp_OcclusionMask.reset(); return *(this->mp_Residuals);};
+      const Residuals& GetResiduals() const;
+      Residuals CopyResiduals() const {return this->mp_ResidualsStream ? this->mp_ResidualsStream->GetFrames() : (this->mp_PackedResiduals ? Residuals(this->mp_PackedResiduals->cast<double>()) : *(this->mp_Residuals));};
+      void SetResiduals(const Residuals& r);
+      bool IsResidualsShared() const {return this->mp_ResidualsStream ? (this->mp_ResidualsStream.use_count() > 1) : (this->mp_PackedResiduals ? (this->mp_PackedResiduals.use_count() > 1) : (this->mp_Residuals.use_count() > 1));};
+      const OcclusionMask& GetOcclusionMask() const;
+      
+      void PackValues();
+      void UnpackValues();
+      void AppendValues(const double* values, int stride, const double* residuals, int residualStride, int frameNumber, int maxFrameNumber = -1);
+      const PackedResiduals* GetPackedResiduals() const {return this->mp_PackedResiduals.get();};
       
       Pointer Clone() const {return Pointer(new Data(*this));}
       
     private:
-      Data(int frameNumber) : MeasureData<Point>(frameNumber), m_Residuals(Residuals::Zero(frameNumber,MeasureTraits<Point>::Residuals::ColsAtCompileTime)) {};
-      Data(const Data& toCopy) : MeasureData<Point>(toCopy), m_Residuals(toCopy.m_Residuals) {};
+      Data(int frameNumber) : MeasureData<Point>(frameNumber), mp_Residuals(new Residuals(Residuals::Zero(frameNumber,MeasureTraits<Point>::Residuals::ColsAtCompileTime))) {};
+      Data(const Data& toCopy) : MeasureData<Point>(toCopy), mp_Residuals(toCopy.mp_Residuals), mp_PackedResiduals(toCopy.mp_PackedResiduals), mp_ResidualsStream(toCopy.mp_ResidualsStream) {};
       Data& operator=(const Data& ); // Not implemented.
+      void DetachResiduals();
+      void UnpackResiduals();
       
-      Residuals m_Residuals;
+      btkSharedPtr<Residuals> mp_Residuals;
+      btkSharedPtr<PackedResiduals> mp_PackedResiduals;
+      mutable btkSharedPtr<Residuals> mp_UnpackedResiduals;
+      btkSharedPtr< MeasureStream_p<Residuals> > mp_ResidualsStream;
+      mutable btkSharedPtr<OcclusionMask> mp_OcclusionMask;
     };
   };
 
@@ -105,7 +122,9 @@ namespace btk
     
     BTK_COMMON_EXPORT Residuals& GetResiduals();
     BTK_COMMON_EXPORT const Residuals& GetResiduals() const;
+    BTK_COMMON_EXPORT Residuals CopyResiduals() const;
     BTK_COMMON_EXPORT void SetResiduals(const Residuals& r);
+    BTK_COMMON_EXPORT const OcclusionMask& GetOcclusionMask() const;
     
     Type GetType() const {return this->m_Type;};
     BTK_COMMON_EXPORT void SetType(Point::Type t);
@@ -135,26 +154,118 @@ namespace btk
   
   inline void MeasureTraits<Point>::Data::Resize(int frameNumber)
   {
-    // Values
-    if (frameNumber > this->m_Values.rows())
+    // The values and residuals are replaced (and not modified) to not affect the objects sharing them. Packed values stay packed.
+    if (this->mp_Stream)
+      this->UnpackValues();
+    this->mp_UnpackedValues.reset();
+    this->mp_UnpackedResiduals.reset();
+    this->mp_OcclusionMask.reset();
+    if (this->mp_PackedValues)
+      this->mp_PackedValues = ResizeMatrix(*(this->mp_PackedValues), frameNumber);
+    else
+      this->mp_Values = ResizeMatrix(*(this->mp_Values), frameNumber);
+    if (this->mp_PackedResiduals)
+      this->mp_PackedResiduals = ResizeMatrix(*(this->mp_PackedResiduals), frameNumber);
+    else
+      this->mp_Residuals = ResizeMatrix(*(this->mp_Residuals), frameNumber);
+  };
+  
+  inline void MeasureTraits<Point>::Data::SetResiduals(const Residuals& r)
+  {
+    this->mp_PackedResiduals.reset();
+    this->mp_UnpackedResiduals.reset();
+    this->mp_ResidualsStream.reset();
+    this->mp_OcclusionMask.reset();
+    if (!this->mp_Residuals || (this->mp_Residuals.use_count() > 1))
+      this->mp_Residuals = btkSharedPtr<Residuals>(new Residuals(r));
+    else
+      *(this->mp_Residuals) = r;
+    this->Modified();
+  };
+  
+  inline const OcclusionMask& MeasureTraits<Point>::Data::GetOcclusionMask() const
+  {
+    MeasureDataLock_p lock;
+    if (!this->mp_OcclusionMask)
     {
-      Values v = Values::Zero(frameNumber,Values::ColsAtCompileTime);
-      if (this->m_Values.data() != 0)
-        v.block(0,0,this->m_Values.rows(),Values::ColsAtCompileTime) = this->m_Values;
-      this->m_Values = v;
+      // Built from the packed residuals if any, to not convert them back in double precision.
+      if (this->mp_PackedResiduals)
+        this->mp_OcclusionMask = btkSharedPtr<OcclusionMask>(new OcclusionMask(this->mp_PackedResiduals->data(), static_cast<int>(this->mp_PackedResiduals->rows())));
+      else if (this->mp_ResidualsStream)
+      {
+        const Residuals r = this->mp_ResidualsStream->GetFrames();
+        this->mp_OcclusionMask = btkSharedPtr<OcclusionMask>(new OcclusionMask(r.data(), static_cast<int>(r.rows())));
+      }
+      else
+        this->mp_OcclusionMask = btkSharedPtr<OcclusionMask>(new OcclusionMask(this->mp_Residuals->data(), static_cast<int>(this->mp_Residuals->rows())));
     }
-    else
-      this->m_Values.conservativeResize(frameNumber,Values::ColsAtCompileTime);
-    // Residuals
-    if (frameNumber > this->m_Residuals.rows())
+    return *(this->mp_OcclusionMask);
+  };
+  
+  inline const MeasureTraits<Point>::Data::Residuals& MeasureTraits<Point>::Data::GetResiduals() const
+  {
+    if (!this->mp_PackedResiduals && !this->mp_ResidualsStream)
+      return *(this->mp_Residuals);
+    MeasureDataLock_p lock;
+    if (!this->mp_UnpackedResiduals)
     {
-      Residuals r = Residuals::Zero(frameNumber, Residuals::ColsAtCompileTime);
-      if (this->m_Residuals.data() != 0)
-        r.block(0,0,this->m_Residuals.rows(),Residuals::ColsAtCompileTime) = this->m_Residuals;
-      this->m_Residuals = r;
+      if (this->mp_ResidualsStream)
+        this->mp_UnpackedResiduals = UnstreamMatrix(*(this->mp_ResidualsStream));
+      else
+        this->mp_UnpackedResiduals = btkSharedPtr<Residuals>(new Residuals(this->mp_PackedResiduals->cast<double>()));
     }
+    return *(this->mp_UnpackedResiduals);
+  };
+  
+  inline void MeasureTraits<Point>::Data::DetachResiduals()
+  {
+    if (this->IsResidualsShared())
+      this->mp_Residuals = btkSharedPtr<Residuals>(new Residuals(*(this->mp_Residuals)));
+  };
+  
+  inline void MeasureTraits<Point>::Data::PackValues()
+  {
+    this->MeasureData<Point>::PackValues();
+    if (this->mp_PackedResiduals)
+    {
+      this->mp_UnpackedResiduals.reset();
+      return;
+    }
+    this->UnpackResiduals(); // Appended residuals
+    this->mp_PackedResiduals = btkSharedPtr<PackedResiduals>(new PackedResiduals(this->mp_Residuals->cast<float>()));
+    this->mp_Residuals.reset();
+    this->mp_OcclusionMask.reset(); // The smallest negative residuals become null in single precision
+  };
+  
+  inline void MeasureTraits<Point>::Data::UnpackValues()
+  {
+    this->MeasureData<Point>::UnpackValues();
+    this->UnpackResiduals();
+  };
+  
+  inline void MeasureTraits<Point>::Data::AppendValues(const double* values, int stride, const double* residuals, int residualStride, int frameNumber, int maxFrameNumber)
+  {
+    this->MeasureData<Point>::AppendValues(values, stride, frameNumber, maxFrameNumber);
+    if (this->mp_PackedResiduals)
+      this->UnpackResiduals();
+    this->mp_UnpackedResiduals.reset();
+    this->mp_OcclusionMask.reset();
+    AppendMatrix(this->mp_ResidualsStream, this->mp_Residuals, residuals, residualStride, frameNumber, maxFrameNumber);
+  };
+  
+  inline void MeasureTraits<Point>::Data::UnpackResiduals()
+  {
+    if (!this->mp_PackedResiduals && !this->mp_ResidualsStream)
+      return;
+    if (this->mp_UnpackedResiduals)
+      this->mp_Residuals = this->mp_UnpackedResiduals;
+    else if (this->mp_ResidualsStream)
+      this->mp_Residuals = UnstreamMatrix(*(this->mp_ResidualsStream));
     else
-      this->m_Residuals.conservativeResize(frameNumber);
+      this->mp_Residuals = btkSharedPtr<Residuals>(new Residuals(this->mp_PackedResiduals->cast<double>()));
+    this->mp_UnpackedResiduals.reset();
+    this->mp_PackedResiduals.reset();
+    this->mp_ResidualsStream.reset();
   };
 };
 
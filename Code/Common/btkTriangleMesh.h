@@ -87,7 +87,7 @@ namespace btk
       friend class TriangleMesh;
       int m_Id;
       int m_RelativeId;
-      Point::Pointer mp_Point;
+      Point::ConstPointer mp_Point; // Read only, to not copy the values shared with other objects
       int* mp_CurrentFrame;
     };
     
@@ -35,6 +35,7 @@
 
 #include "btkANBFileIO.h"
 #include "btkMotionAnalysisFileIOUtils_p.h"
+#include "btkDeinterleave_p.h"
 #include "btkMetaDataUtils.h"
 #include "btkConvert.h"
 #include "btkLogger.h"
@@ -234,13 +235,10 @@ namespace btk
         */
         
         // Read analog channel values
-        for(int i = 0 ; i < static_cast<int>(frameNumber) ; ++i)
-        {
-          for (AnalogCollection::Iterator it = output->BeginAnalog() ; it != output->EndAnalog() ; ++it)
-          {
-            (*it)->GetValues().coeffRef(i) = static_cast<double>(bifs.ReadI16()) * (*it)->GetScale();
-          }
-        }
+        std::vector<double> scales, offsets(channelNumber, 0.0);
+        for (AnalogCollection::Iterator it = output->BeginAnalog() ; it != output->EndAnalog() ; ++it)
+          scales.push_back((*it)->GetScale());
+        ReadInterleavedAnalogs_p<int16_t>(&bifs, output, scales, offsets);
       }
     }
     catch (BinaryFileStreamFailure& )
@@ -410,9 +408,11 @@ namespace btk
       // Key 0x8100: Number of words for the data
       uint32_t dataSize = input->GetAnalogFrameNumber() * input->GetAnalogNumber() / 2 + 3;
       this->WriteKeyValue(&bofs, 0x8100, dataSize);
+      // Read-only access to not copy the values shared with other objects
+      const std::vector<Analog::ConstPointer> analogs(input->BeginAnalog(), input->EndAnalog());
       for (int frame = 0 ; frame < input->GetAnalogFrameNumber() ; ++frame)
       {
-        for (AnalogCollection::ConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
+        for (std::vector<Analog::ConstPointer>::const_iterator it = analogs.begin() ; it != analogs.end() ; ++it)
           bofs.Write(static_cast<int16_t>((*it)->GetValues().coeff(frame) / (*it)->GetScale()));
       };
     }
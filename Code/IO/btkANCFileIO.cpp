@@ -38,8 +38,8 @@
 #include "btkMotionAnalysisFileIOUtils_p.h"
 #include "btkConvert.h"
 #include "btkLogger.h"
+#include "btkFileStream.h"
 
-#include <fstream>
 #include <algorithm>
 #include <cctype>
 #include <iostream>
@@ -102,7 +102,7 @@ namespace btk
    */
   bool ANCFileIO::CanReadFile(const std::string& filename)
   {
-    std::ifstream ifs(filename.c_str());
+    ifilestream ifs(filename.c_str());
     char c[42] = {0};
     ifs.read(c, 41); c[41] = '\0';
     ifs.close();
@@ -132,7 +132,7 @@ namespace btk
   {
     output->Reset();
     // Open the stream
-    std::ifstream ifs;
+    ifilestream ifs;
     ifs.exceptions(std::ios_base::eofbit | std::ios_base::failbit | std::ios_base::badbit);
     try
     {
@@ -275,7 +275,7 @@ namespace btk
       btkErrorMacro("Impossible to write a null input into a file.");
       return;
     }
-    std::ofstream ofs(filename.c_str());
+    ofilestream ofs(filename.c_str());
     if (!ofs)
       throw(ANCFileIOException("Invalid file path."));
     // Frequency
@@ -335,11 +335,13 @@ namespace btk
     {
       btkWarningMacro(filename, "The scale factors used in the ANC file do not correspond to these of the acquisition. Some of the data might be scaled. In case of force platform data, you have to create a calibration file (CAL) to restore exactly the data.");
     }
+    // Read-only access to not copy the values shared with other objects
+    const std::vector<Analog::ConstPointer> analogs(input->BeginAnalog(), input->EndAnalog());
     for (int frame = 0 ; frame < input->GetAnalogFrameNumber() ; ++frame)
     {
       ofs.precision(6);
       ofs << std::endl << time << static_cast<std::string>("\t");
-      for (AnalogCollection::ConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
+      for (std::vector<Analog::ConstPointer>::const_iterator it = analogs.begin() ; it != analogs.end() ; ++it)
         ofs << static_cast<int>((*it)->GetValues().coeff(frame) / (*it)->GetScale()) << static_cast<std::string>("\t");
       time += stepTime;
     };
@@ -448,10 +448,12 @@ namespace btk
         double t = 0.0;
         if (input->GetAnalogFrequency() != 0.0)
           t = 1.0 / input->GetAnalogFrequency();
+        // Read-only access to not copy the values shared with other objects
+        const std::vector<Analog::ConstPointer> analogs(input->BeginAnalog(), input->EndAnalog());
         for (int i = ffi ; i < lfi ; ++i)
         {
           ofs << static_cast<double>(i + (input->GetFirstFrame()-1) * input->GetNumberAnalogSamplePerFrame()) * t;
-          for (btk::AnalogCollection::ConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
+          for (std::vector<Analog::ConstPointer>::const_iterator it = analogs.begin() ; it != analogs.end() ; ++it)
             ofs << this->m_Separator << (*it)->GetValues().coeff(i);
           ofs << std::endl;
         }
@@ -499,12 +501,19 @@ namespace btk
       t = 1.0 / acq->GetPointFrequency();
     int ffi = ff - acq->GetFirstFrame();
     int lfi = lf - acq->GetFirstFrame();
+    // Read-only access to not copy the values shared with other objects
+    const std::vector<Point::ConstPointer> readOnlyPoints(points->Begin(), points->End());
+    std::vector<OcclusionMask> masks;
+    masks.reserve(points->GetItemNumber());
+    for (btk::PointCollection::ConstIterator it = points->Begin() ; it != points->End() ; ++it)
+      masks.push_back((*it)->GetOcclusionMask());
     for (int i = ffi ; i <= lfi ; ++i)
     {
       *ofs << static_cast<double>(i + acq->GetFirstFrame() - 1) * t;
-      for (btk::PointCollection::ConstIterator it = points->Begin() ; it != points->End() ; ++it)
+      std::vector<OcclusionMask>::const_iterator itM = masks.begin();
+      for (std::vector<Point::ConstPointer>::const_iterator it = readOnlyPoints.begin() ; it != readOnlyPoints.end() ; ++it, ++itM)
       {
-        if ((*it)->GetResiduals().coeff(i) >= 0.0)
+        if (itM->IsValid(i))
           *ofs << this->m_Separator << (*it)->GetValues().coeff(i,0) << this->m_Separator << (*it)->GetValues().coeff(i,1) << this->m_Separator << (*it)->GetValues().coeff(i,2);
         else
           *ofs << this->m_Separator << 0 << this->m_Separator << 0 << this->m_Separator << 0;
@@ -0,0 +1,221 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkAcquisitionFileBatchReader.h"
+#include "btkAcquisitionFileReader.h"
+#include "btkFileReadAhead_p.h"
+
+namespace btk
+{
+  /**
+   * @class AcquisitionFileBatchReader btkAcquisitionFileBatchReader.h
+   * @brief Reads sequentially a list of acquisition files while the next ones are loaded in memory.
+   *
+   * With an AcquisitionFileReader object, each file is read from the disk and then decoded by the same thread. 
+   * This class overlaps both steps: a dedicated I/O thread loads in memory the content of the next files 
+   * of the list while the current one is decoded by the method ReadNext(). Then, the decoding is done 
+   * on a memory buffer (see AcquisitionFileReader::SetInputBuffer()) and the throughput of a batch 
+   * approaches the bandwidth of the disk.
+   *
+   * The memory used by the prefetched files is bounded by two options: the number of files loaded in advance 
+   * (SetReadAheadNumber(), 4 by default) and the number of bytes loaded but not yet decoded (SetMaxInFlightSize(), 
+   * 256 MB by default). A file larger than this budget is loaded only when no other file is in flight.
+   * If BTK is compiled without thread support, the files are loaded when they are decoded.
+   *
+   * @code
+   * btk::AcquisitionFileBatchReader::Pointer batch = btk::AcquisitionFileBatchReader::New();
+   * batch->SetFilenames(filenames);
+   * while (!batch->AtEnd())
+   * {
+   *   btk::Acquisition::Pointer acq = batch->ReadNext();
+   *   // ...
+   * }
+   * @endcode
+   *
+   * @ingroup BTKIO
+   */
+  
+  /**
+   * @typedef AcquisitionFileBatchReader::Pointer
+   * Smart pointer associated with an AcquisitionFileBatchReader object.
+   */
+  
+  /**
+   * @typedef AcquisitionFileBatchReader::ConstPointer
+   * Smart pointer associated with a const AcquisitionFileBatchReader object.
+   */
+  
+  /**
+   * @fn static AcquisitionFileBatchReader::Pointer AcquisitionFileBatchReader::New()
+   * Creates a smart pointer associated with an AcquisitionFileBatchReader object.
+   */
+  
+  /**
+   * Destructor. Stops the I/O thread.
+   */
+  AcquisitionFileBatchReader::~AcquisitionFileBatchReader()
+  {
+    delete this->mp_ReadAhead;
+  };
+  
+  /**
+   * @fn const std::vector<std::string>& AcquisitionFileBatchReader::GetFilenames() const
+   * Returns the list of files to read.
+   */
+  
+  /**
+   * Sets the list of files to read. The reading restarts from the first file.
+   */
+  void AcquisitionFileBatchReader::SetFilenames(const std::vector<std::string>& filenames)
+  {
+    this->m_Filenames = filenames;
+    this->Rewind();
+  };
+  
+  /**
+   * Appends the file @a filename to the list of files to read. The reading restarts from the first file.
+   */
+  void AcquisitionFileBatchReader::AddFilename(const std::string& filename)
+  {
+    this->m_Filenames.push_back(filename);
+    this->Rewind();
+  };
+  
+  /**
+   * @fn int AcquisitionFileBatchReader::GetFileNumber() const
+   * Returns the number of files to read.
+   */
+  
+  /**
+   * @fn int AcquisitionFileBatchReader::GetReadAheadNumber() const
+   * Returns the maximum number of files loaded in advance.
+   */
+  
+  /**
+   * Sets the maximum number of files loaded in advance (at least 1). The reading restarts from the first file.
+   */
+  void AcquisitionFileBatchReader::SetReadAheadNumber(int num)
+  {
+    this->m_ReadAheadNumber = (num > 0) ? num : 1;
+    this->Rewind();
+  };
+  
+  /**
+   * @fn size_t AcquisitionFileBatchReader::GetMaxInFlightSize() const
+   * Returns the maximum number of bytes loaded in advance.
+   */
+  
+  /**
+   * Sets the maximum number of bytes loaded in advance. The reading restarts from the first file.
+   */
+  void AcquisitionFileBatchReader::SetMaxInFlightSize(size_t size)
+  {
+    this->m_MaxInFlightSize = size;
+    this->Rewind();
+  };
+  
+  /**
+   * Returns the number of bytes currently loaded in advance.
+   */
+  size_t AcquisitionFileBatchReader::GetInFlightSize() const
+  {
+    return (this->mp_ReadAhead != 0) ? this->mp_ReadAhead->GetInFlightSize() : 0;
+  };
+  
+  /**
+   * Reads the next file of the list and returns its content. Returns a null pointer if all the files were read.
+   * 
+   * The exceptions thrown by the AcquisitionFileReader object (file not found, format not supported, etc.) are forwarded. 
+   * In this case, the file is skipped and the next call reads the following file.
+   */
+  Acquisition::Pointer AcquisitionFileBatchReader::ReadNext()
+  {
+    if (this->AtEnd())
+      return Acquisition::Pointer();
+    if (this->mp_ReadAhead == 0)
+    {
+      this->mp_ReadAhead = new FileReadAhead_p(this->m_Filenames, this->m_ReadAheadNumber, this->m_MaxInFlightSize);
+      this->mp_ReadAhead->Start();
+    }
+    ++this->m_CurrentIndex;
+    this->m_CurrentFilename = this->m_Filenames[this->m_CurrentIndex];
+    std::vector<char> content;
+    AcquisitionFileReader::Pointer reader = AcquisitionFileReader::New();
+    reader->SetFilename(this->m_CurrentFilename);
+    // A file which cannot be loaded is read directly to report the same error than the AcquisitionFileReader class.
+    if (this->mp_ReadAhead->Acquire(this->m_CurrentIndex, &content) && !content.empty())
+      reader->SetInputBuffer(&content[0], content.size());
+    reader->Update();
+    return reader->GetOutput();
+  };
+  
+  /**
+   * @fn bool AcquisitionFileBatchReader::AtEnd() const
+   * Returns true if all the files were read.
+   */
+  
+  /**
+   * @fn int AcquisitionFileBatchReader::GetCurrentIndex() const
+   * Returns the index of the file read by the last call of ReadNext() (-1 before the first call).
+   */
+  
+  /**
+   * @fn const std::string& AcquisitionFileBatchReader::GetCurrentFilename() const
+   * Returns the name of the file read by the last call of ReadNext().
+   */
+  
+  /**
+   * Stops the loading of the files and restarts the reading from the first file.
+   */
+  void AcquisitionFileBatchReader::Rewind()
+  {
+    delete this->mp_ReadAhead;
+    this->mp_ReadAhead = 0;
+    this->m_CurrentIndex = -1;
+    this->m_CurrentFilename.clear();
+  };
+  
+  /**
+   * Constructor.
+   */
+  AcquisitionFileBatchReader::AcquisitionFileBatchReader()
+  : m_Filenames(), m_CurrentFilename()
+  {
+    this->m_ReadAheadNumber = 4;
+    this->m_MaxInFlightSize = 256 * 1024 * 1024;
+    this->m_CurrentIndex = -1;
+    this->mp_ReadAhead = 0;
+  };
+};
@@ -0,0 +1,92 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkAcquisitionFileBatchReader_h
+#define __btkAcquisitionFileBatchReader_h
+
+#include "btkAcquisition.h"
+#include "btkSharedPtr.h"
+
+#include <string>
+#include <vector>
+
+namespace btk
+{
+  class FileReadAhead_p;
+  
+  class AcquisitionFileBatchReader
+  {
+  public:
+    typedef btkSharedPtr<AcquisitionFileBatchReader> Pointer;
+    typedef btkSharedPtr<const AcquisitionFileBatchReader> ConstPointer;
+    
+    static Pointer New() {return Pointer(new AcquisitionFileBatchReader());};
+    
+    BTK_IO_EXPORT virtual ~AcquisitionFileBatchReader();
+    
+    const std::vector<std::string>& GetFilenames() const {return this->m_Filenames;};
+    BTK_IO_EXPORT void SetFilenames(const std::vector<std::string>& filenames);
+    BTK_IO_EXPORT void AddFilename(const std::string& filename);
+    int GetFileNumber() const {return static_cast<int>(this->m_Filenames.size());};
+    
+    int GetReadAheadNumber() const {return this->m_ReadAheadNumber;};
+    BTK_IO_EXPORT void SetReadAheadNumber(int num);
+    size_t GetMaxInFlightSize() const {return this->m_MaxInFlightSize;};
+    BTK_IO_EXPORT void SetMaxInFlightSize(size_t size);
+    BTK_IO_EXPORT size_t GetInFlightSize() const;
+    
+    BTK_IO_EXPORT Acquisition::Pointer ReadNext();
+    bool AtEnd() const {return (this->m_CurrentIndex + 1 >= static_cast<int>(this->m_Filenames.size()));};
+    int GetCurrentIndex() const {return this->m_CurrentIndex;};
+    const std::string& GetCurrentFilename() const {return this->m_CurrentFilename;};
+    BTK_IO_EXPORT void Rewind();
+    
+  protected:
+    BTK_IO_EXPORT AcquisitionFileBatchReader();
+    
+  private:
+    std::vector<std::string> m_Filenames;
+    int m_ReadAheadNumber;
+    size_t m_MaxInFlightSize;
+    int m_CurrentIndex;
+    std::string m_CurrentFilename;
+    FileReadAhead_p* mp_ReadAhead;
+    
+    AcquisitionFileBatchReader(const AcquisitionFileBatchReader& ); // Not implemented.
+    AcquisitionFileBatchReader& operator=(const AcquisitionFileBatchReader& ); // Not implemented.
+  };
+};
+
+#endif // __btkAcquisitionFileBatchReader_h
@@ -0,0 +1,534 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkAcquisitionFileCache.h"
+#include "btkBCAFileIOUtils_p.h"
+#include "btkBinaryFileStream.h"
+#include "btkLogger.h"
+#include "btkException.h"
+#include "btkCriticalSection_p.h"
+
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <sys/stat.h>
+#if defined(_WIN32)
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <windows.h>
+#endif
+
+namespace btk
+{
+  static const uint32_t CacheSnapshotKey = 0x1A534342; // "BCS\x1A"
+  static const uint32_t CacheSnapshotVersion = 1;
+  
+  // The snapshots are only read on the computer which wrote them: the values are stored in the native byte order.
+  static void WriteCacheDouble(BinaryFileStream* bofs, double value)
+  {
+    bofs->Write(8, reinterpret_cast<const uint8_t*>(&value));
+  };
+  
+  static double ReadCacheDouble(BinaryFileStream* bifs)
+  {
+    double value = 0.0;
+    bifs->ReadU8(8, reinterpret_cast<uint8_t*>(&value));
+    return value;
+  };
+  
+  static void WriteCacheColumn(BinaryFileStream* bofs, const double* values, size_t num)
+  {
+    if (num != 0)
+      bofs->Write(num * sizeof(double), reinterpret_cast<const uint8_t*>(values));
+  };
+  
+  // One block copy from the file (memory mapped if possible) to the storage of the measure.
+  static void ReadCacheColumn(BinaryFileStream* bifs, double* values, size_t num)
+  {
+    if (num != 0)
+      bifs->ReadU8(num * sizeof(double), reinterpret_cast<uint8_t*>(values));
+  };
+  
+  /**
+   * @class AcquisitionFileCache btkAcquisitionFileCache.h
+   * @brief On-disk cache of the acquisitions read from files.
+   *
+   * Reading some file formats (C3D, ...) requires to parse their header and to scale the integer data 
+   * each time the file is opened. When the same files are read several times (e.g. by the successive 
+   * stages of an analysis), this cache stores a decoded snapshot of the acquisition the first time 
+   * and loads it directly the next times.
+   *
+   * Each entry is a snapshot stored in the cache directory. Its header contains the acquisition's parameters, 
+   * the metadata (serialized as in the BCA format), the events, the description of the points and analog channels 
+   * and the properties of the IO used to read the original file. The data follow, already scaled and stored 
+   * as uncompressed doubles in the native byte order, with the same column-major layout than the measures. 
+   * Then, loading an entry reads each column with a single block copy from the file, which is memory mapped 
+   * when the platform supports it (see BinaryFileStream).
+   * An entry is associated with the path, the modification time (with the resolution of the file system, 
+   * up to the nanosecond) and the size of the original file. 
+   * Then, an entry is automatically invalidated when its original file is modified.
+   *
+   * This cache is opt-in. It is used by an AcquisitionFileReader object when it is set with 
+   * the method AcquisitionFileReader::SetCache(). The same cache can be shared by several readers, 
+   * even used in different threads.
+   * The number of hits and misses are available with the methods GetHitNumber() and GetMissNumber().
+   *
+   * @ingroup BTKIO
+   */
+  
+  /**
+   * @typedef AcquisitionFileCache::Pointer
+   * Smart pointer associated with an AcquisitionFileCache object.
+   */
+  
+  /**
+   * @typedef AcquisitionFileCache::ConstPointer
+   * Smart pointer associated with a const AcquisitionFileCache object.
+   */
+  
+  /**
+   * @fn static AcquisitionFileCache::Pointer AcquisitionFileCache::New(const std::string& directory = "")
+   * Creates a smart pointer associated with an AcquisitionFileCache object which stores its entries in @a directory.
+   * The directory must already exist.
+   */
+  
+  /**
+   * Destructor.
+   */
+  AcquisitionFileCache::~AcquisitionFileCache()
+  {
+    delete this->mp_StatisticsLock;
+  };
+  
+  /**
+   * @fn const std::string& AcquisitionFileCache::GetDirectory() const
+   * Returns the directory where the entries are stored.
+   */
+  
+  /**
+   * Sets the directory where the entries are stored. The directory must already exist.
+   * An empty directory disables the cache.
+   */
+  void AcquisitionFileCache::SetDirectory(const std::string& directory)
+  {
+    this->m_Directory = directory;
+    if (!this->m_Directory.empty() && (*(this->m_Directory.rbegin()) != '/') && (*(this->m_Directory.rbegin()) != '\\'))
+      this->m_Directory += '/';
+  };
+  
+  /**
+   * Returns the number of acquisitions loaded from the cache.
+   */
+  int AcquisitionFileCache::GetHitNumber() const
+  {
+    this->mp_StatisticsLock->Lock();
+    const int num = this->m_HitNumber;
+    this->mp_StatisticsLock->Unlock();
+    return num;
+  };
+  
+  /**
+   * Returns the number of requests for which no valid entry was found in the cache.
+   */
+  int AcquisitionFileCache::GetMissNumber() const
+  {
+    this->mp_StatisticsLock->Lock();
+    const int num = this->m_MissNumber;
+    this->mp_StatisticsLock->Unlock();
+    return num;
+  };
+  
+  /**
+   * Sets the number of hits and misses to 0.
+   */
+  void AcquisitionFileCache::ResetStatistics()
+  {
+    this->mp_StatisticsLock->Lock();
+    this->m_HitNumber = 0;
+    this->m_MissNumber = 0;
+    this->mp_StatisticsLock->Unlock();
+  };
+  
+  /**
+   * Loads in @a output the entry associated with the file @a filename.
+   * If @a io is set, its generic properties (file type, byte order, storage format and number of frames 
+   * given by the header of the file) are set as if it had read the original file. The properties specific 
+   * to an IO (e.g. the scales of C3DFileIO) are not stored in the cache and keep their default values.
+   * Returns false (and count a miss) if there is no valid entry for this file. 
+   * In this case, the content of @a output is undefined and the original file has to be read.
+   */
+  bool AcquisitionFileCache::Load(const std::string& filename, Acquisition::Pointer output, AcquisitionFileIO::Pointer io)
+  {
+    std::string key, entry;
+    if (!this->GenerateEntry(filename, &key, &entry))
+    {
+      this->CountRequest(false);
+      return false;
+    }
+    // The key file is compared to the current state of the original file.
+    std::ifstream ifs((entry + ".key").c_str(), std::ios_base::in | std::ios_base::binary);
+    if (!ifs.is_open())
+    {
+      this->CountRequest(false);
+      return false;
+    }
+    std::ostringstream oss;
+    oss << ifs.rdbuf();
+    ifs.close();
+    if (oss.str().compare(key) != 0)
+    {
+      this->CountRequest(false);
+      return false;
+    }
+    try
+    {
+      this->ReadSnapshot(entry + ".bcs", output, io);
+    }
+    catch (std::exception& e)
+    {
+      btkWarningMacro(filename, "Invalid cache entry: " + std::string(e.what()));
+      this->CountRequest(false);
+      return false;
+    }
+    this->CountRequest(true);
+    return true;
+  };
+  
+  /**
+   * Stores the acquisition @a input as the entry associated with the file @a filename.
+   * The generic properties of @a io (if set) are stored with the acquisition.
+   * An existing entry for this file is replaced. Returns false if the entry cannot be stored.
+   */
+  bool AcquisitionFileCache::Store(const std::string& filename, Acquisition::Pointer input, AcquisitionFileIO::Pointer io)
+  {
+    std::string key, entry;
+    if (!this->GenerateEntry(filename, &key, &entry))
+      return false;
+    // The key is removed first and written last. Then an interrupted storage gives an invalid entry.
+    std::remove((entry + ".key").c_str());
+    try
+    {
+      this->WriteSnapshot(entry + ".bcs", input, io);
+    }
+    catch (std::exception& e)
+    {
+      btkWarningMacro(filename, "Impossible to store the acquisition in the cache: " + std::string(e.what()));
+      std::remove((entry + ".bcs").c_str());
+      return false;
+    }
+    std::ofstream ofs((entry + ".key").c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    if (!ofs.is_open())
+      return false;
+    ofs << key;
+    ofs.close();
+    return !ofs.fail();
+  };
+  
+  /**
+   * Removes the entry associated with the file @a filename (if any).
+   */
+  void AcquisitionFileCache::Remove(const std::string& filename)
+  {
+    if (this->m_Directory.empty())
+      return;
+    std::string key, entry;
+    this->GenerateEntry(filename, &key, &entry);
+    std::remove((entry + ".key").c_str());
+    std::remove((entry + ".bcs").c_str());
+  };
+  
+  /**
+   * Constructor.
+   */
+  AcquisitionFileCache::AcquisitionFileCache(const std::string& directory)
+  : m_Directory()
+  {
+    this->SetDirectory(directory);
+    this->m_HitNumber = 0;
+    this->m_MissNumber = 0;
+    this->mp_StatisticsLock = new critical_section_p;
+  };
+  
+  /**
+   * Counts a hit or a miss. The statistics can be updated by several readers at the same time.
+   */
+  void AcquisitionFileCache::CountRequest(bool hit)
+  {
+    this->mp_StatisticsLock->Lock();
+    if (hit)
+      ++this->m_HitNumber;
+    else
+      ++this->m_MissNumber;
+    this->mp_StatisticsLock->Unlock();
+  };
+  
+  /**
+   * Writes the snapshot @a filename of the acquisition @a input (and of the properties of @a io).
+   * Throws an exception if the snapshot cannot be written.
+   */
+  void AcquisitionFileCache::WriteSnapshot(const std::string& filename, Acquisition::Pointer input, AcquisitionFileIO::Pointer io) const
+  {
+    NativeBinaryFileStream bofs;
+    bofs.SetExceptions(BinaryFileStream::FailBit | BinaryFileStream::BadBit);
+    bofs.Open(filename, BinaryFileStream::Out | BinaryFileStream::Truncate);
+    bofs.Write(CacheSnapshotKey);
+    bofs.Write(CacheSnapshotVersion);
+    // IO's properties
+    bofs.Write(static_cast<int32_t>(io ? io->GetFileType() : AcquisitionFileIO::TypeNotApplicable));
+    bofs.Write(static_cast<int32_t>(io ? io->GetByteOrder() : AcquisitionFileIO::OrderNotApplicable));
+    bofs.Write(static_cast<int32_t>(io ? io->GetStorageFormat() : AcquisitionFileIO::StorageNotApplicable));
+    bofs.Write(static_cast<int32_t>(io ? io->GetHeaderFrameNumber() : -1));
+    // Acquisition's parameters
+    const int numFrames = input->GetPointFrameNumber();
+    const int numAnalogFrames = input->GetAnalogFrameNumber();
+    bofs.Write(static_cast<int32_t>(input->GetFirstFrame()));
+    WriteCacheDouble(&bofs, input->GetPointFrequency());
+    bofs.Write(static_cast<int32_t>(numFrames));
+    bofs.Write(static_cast<int32_t>(input->GetNumberAnalogSamplePerFrame()));
+    bofs.Write(static_cast<int32_t>(input->GetAnalogResolution()));
+    bofs.Write(static_cast<int32_t>(input->GetMaxInterpolationGap()));
+    const std::vector<std::string>& units = input->GetPointUnits();
+    bofs.Write(static_cast<int32_t>(units.size()));
+    for (size_t i = 0 ; i < units.size() ; ++i)
+      WriteBCAString_p(&bofs, units[i]);
+    WriteBCAMetaData_p(&bofs, input->GetMetaData());
+    bofs.Write(static_cast<int32_t>(input->GetEventNumber()));
+    for (Acquisition::EventConstIterator it = input->BeginEvent() ; it != input->EndEvent() ; ++it)
+    {
+      WriteBCAString_p(&bofs, (*it)->GetLabel());
+      WriteBCAString_p(&bofs, (*it)->GetContext());
+      WriteBCAString_p(&bofs, (*it)->GetSubject());
+      WriteBCAString_p(&bofs, (*it)->GetDescription());
+      WriteCacheDouble(&bofs, (*it)->GetTime());
+      bofs.Write(static_cast<int32_t>((*it)->GetFrame()));
+      bofs.Write(static_cast<int32_t>((*it)->GetDetectionFlags()));
+      bofs.Write(static_cast<int32_t>((*it)->GetId()));
+    }
+    bofs.Write(static_cast<int32_t>(input->GetPointNumber()));
+    for (Acquisition::PointConstIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it)
+    {
+      if ((*it)->GetFrameNumber() != numFrames)
+        throw(LogicError("The point " + (*it)->GetLabel() + " has not the number of frames of the acquisition."));
+      WriteBCAString_p(&bofs, (*it)->GetLabel());
+      WriteBCAString_p(&bofs, (*it)->GetDescription());
+      bofs.Write(static_cast<int32_t>((*it)->GetType()));
+    }
+    bofs.Write(static_cast<int32_t>(input->GetAnalogNumber()));
+    for (Acquisition::AnalogConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
+    {
+      if ((*it)->GetFrameNumber() != numAnalogFrames)
+        throw(LogicError("The analog channel " + (*it)->GetLabel() + " has not the number of frames of the acquisition."));
+      WriteBCAString_p(&bofs, (*it)->GetLabel());
+      WriteBCAString_p(&bofs, (*it)->GetDescription());
+      WriteBCAString_p(&bofs, (*it)->GetUnit());
+      bofs.Write(static_cast<int32_t>((*it)->GetGain()));
+      WriteCacheDouble(&bofs, (*it)->GetOffset());
+      WriteCacheDouble(&bofs, (*it)->GetScale());
+    }
+    // Data (column-major layout of the measures)
+    for (Acquisition::PointConstIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it)
+    {
+      Point::ConstPointer pt = *it;
+      if (numFrames == 0)
+        continue;
+      // Packed values are converted in a copy: the input is not modified.
+      if (pt->IsValuesPacked())
+        WriteCacheColumn(&bofs, pt->CopyValues().data(), 3 * numFrames);
+      else
+        WriteCacheColumn(&bofs, pt->GetValues().data(), 3 * numFrames);
+      if (pt->GetData()->GetPackedResiduals() != 0)
+        WriteCacheColumn(&bofs, pt->CopyResiduals().data(), numFrames);
+      else
+        WriteCacheColumn(&bofs, pt->GetResiduals().data(), numFrames);
+    }
+    for (Acquisition::AnalogConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
+    {
+      Analog::ConstPointer an = *it;
+      if (numAnalogFrames == 0)
+        continue;
+      if (an->IsValuesPacked())
+        WriteCacheColumn(&bofs, an->CopyValues().data(), numAnalogFrames);
+      else
+        WriteCacheColumn(&bofs, an->GetValues().data(), numAnalogFrames);
+    }
+    bofs.Close();
+  };
+  
+  /**
+   * Reads the snapshot @a filename in @a output and sets the properties of @a io (if any).
+   * Throws an exception if the snapshot is invalid.
+   */
+  void AcquisitionFileCache::ReadSnapshot(const std::string& filename, Acquisition::Pointer output, AcquisitionFileIO::Pointer io) const
+  {
+    output->Reset();
+    NativeBinaryFileStream bifs;
+    bifs.SetExceptions(BinaryFileStream::EndFileBit | BinaryFileStream::FailBit | BinaryFileStream::BadBit);
+    bifs.Open(filename, BinaryFileStream::In);
+    if ((bifs.ReadU32() != CacheSnapshotKey) || (bifs.ReadU32() != CacheSnapshotVersion))
+      throw(LogicError("Invalid header or unsupported version."));
+    // IO's properties
+    const int32_t fileType = bifs.ReadI32();
+    const int32_t byteOrder = bifs.ReadI32();
+    const int32_t storageFormat = bifs.ReadI32();
+    const int32_t headerFrameNumber = bifs.ReadI32();
+    // Acquisition's parameters
+    const int32_t firstFrame = bifs.ReadI32();
+    const double pointFrequency = ReadCacheDouble(&bifs);
+    const int32_t numFrames = ReadBCANumber_p(&bifs);
+    const int32_t numSamplesPerFrame = bifs.ReadI32();
+    const int32_t resolution = bifs.ReadI32();
+    const int32_t maxInterpolationGap = bifs.ReadI32();
+    if (numSamplesPerFrame <= 0)
+      throw(LogicError("Invalid acquisition's parameters."));
+    std::vector<std::string> units(ReadBCANumber_p(&bifs));
+    for (size_t i = 0 ; i < units.size() ; ++i)
+      units[i] = ReadBCAString_p(&bifs);
+    MetaData::Pointer root = ReadBCAMetaData_p(&bifs);
+    std::vector<Event::Pointer> events(ReadBCANumber_p(&bifs));
+    for (size_t i = 0 ; i < events.size() ; ++i)
+    {
+      const std::string label = ReadBCAString_p(&bifs);
+      const std::string context = ReadBCAString_p(&bifs);
+      const std::string subject = ReadBCAString_p(&bifs);
+      const std::string desc = ReadBCAString_p(&bifs);
+      const double time = ReadCacheDouble(&bifs);
+      const int32_t frame = bifs.ReadI32();
+      const int32_t flags = bifs.ReadI32();
+      const int32_t id = bifs.ReadI32();
+      events[i] = Event::New(label, time, frame, context, flags, subject, desc, id);
+    }
+    output->Init(ReadBCANumber_p(&bifs), numFrames, 0, numSamplesPerFrame);
+    for (Acquisition::PointIterator it = output->BeginPoint() ; it != output->EndPoint() ; ++it)
+    {
+      (*it)->SetLabel(ReadBCAString_p(&bifs));
+      (*it)->SetDescription(ReadBCAString_p(&bifs));
+      const int32_t type = bifs.ReadI32();
+      if ((type < Point::Marker) || (type > Point::Reaction))
+        throw(LogicError("Unknown type for the point " + (*it)->GetLabel() + "."));
+      (*it)->SetType(static_cast<Point::Type>(type));
+    }
+    output->ResizeAnalogNumber(ReadBCANumber_p(&bifs));
+    for (Acquisition::AnalogIterator it = output->BeginAnalog() ; it != output->EndAnalog() ; ++it)
+    {
+      (*it)->SetLabel(ReadBCAString_p(&bifs));
+      (*it)->SetDescription(ReadBCAString_p(&bifs));
+      (*it)->SetUnit(ReadBCAString_p(&bifs));
+      (*it)->SetGain(static_cast<Analog::Gain>(bifs.ReadI32()));
+      (*it)->SetOffset(ReadCacheDouble(&bifs));
+      (*it)->SetScale(ReadCacheDouble(&bifs));
+    }
+    // Data
+    if (numFrames != 0)
+    {
+      for (Acquisition::PointIterator it = output->BeginPoint() ; it != output->EndPoint() ; ++it)
+      {
+        ReadCacheColumn(&bifs, (*it)->GetValues().data(), 3 * numFrames);
+        ReadCacheColumn(&bifs, (*it)->GetResiduals().data(), numFrames);
+      }
+      for (Acquisition::AnalogIterator it = output->BeginAnalog() ; it != output->EndAnalog() ; ++it)
+        ReadCacheColumn(&bifs, (*it)->GetValues().data(), numFrames * numSamplesPerFrame);
+    }
+    bifs.Close();
+    // Acquisition's parameters and IO's properties set only for a complete snapshot
+    MetaData::Pointer md = output->GetMetaData();
+    for (MetaData::Iterator it = root->Begin() ; it != root->End() ; ++it)
+      md->AppendChild(*it);
+    output->SetPointFrequency(pointFrequency);
+    output->SetFirstFrame(firstFrame);
+    output->SetAnalogResolution(static_cast<Acquisition::AnalogResolution>(resolution));
+    output->SetMaxInterpolationGap(maxInterpolationGap);
+    if (units.size() == output->GetPointUnits().size())
+      output->SetPointUnits(units);
+    for (size_t i = 0 ; i < events.size() ; ++i)
+      output->AppendEvent(events[i]);
+    if (io)
+    {
+      io->SetFileType(static_cast<AcquisitionFileIO::FileType>(fileType));
+      io->SetByteOrder(static_cast<AcquisitionFileIO::ByteOrder>(byteOrder));
+      io->SetStorageFormat(static_cast<AcquisitionFileIO::StorageFormat>(storageFormat));
+      io->m_HeaderFrameNumber = headerFrameNumber;
+    }
+  };
+  
+  /**
+   * Generates the key of the file @a filename (path, modification time, size) and 
+   * the path (without suffix) of its entry in the cache. The name of the entry is a hash of the path, 
+   * so a modified file replaces its previous entry.
+   * Returns false if the cache is disabled or if the file does not exist.
+   */
+  bool AcquisitionFileCache::GenerateEntry(const std::string& filename, std::string* key, std::string* entry) const
+  {
+    // FNV-1a hash of the path
+    uint32_t hash[2] = {2166136261u, 2166136261u};
+    for (std::string::const_iterator it = filename.begin() ; it != filename.end() ; ++it)
+    {
+      hash[0] = (hash[0] ^ static_cast<uint8_t>(*it)) * 16777619u;
+      hash[1] = (hash[1] ^ static_cast<uint8_t>(*it)) * 16777619u;
+      hash[1] = (hash[1] << 7) | (hash[1] >> 25);
+    }
+    std::ostringstream oss;
+    oss << std::hex;
+    oss.width(8); oss.fill('0'); oss << hash[0];
+    oss.width(8); oss.fill('0'); oss << hash[1];
+    *entry = this->m_Directory + oss.str();
+    if (this->m_Directory.empty())
+      return false;
+    // The modification time is stored with the resolution of the file system. A file rewritten with the 
+    // same size in the same second is then detected.
+    int64_t mtime = 0, size = 0;
+#if defined(_WIN32)
+    WIN32_FILE_ATTRIBUTE_DATA info;
+    if (!GetFileAttributesExA(filename.c_str(), GetFileExInfoStandard, &info))
+      return false;
+    mtime = (static_cast<int64_t>(info.ftLastWriteTime.dwHighDateTime) << 32) | info.ftLastWriteTime.dwLowDateTime; // 100 ns
+    size = (static_cast<int64_t>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+#else
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0)
+      return false;
+  #if defined(__APPLE__)
+    mtime = static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+  #else
+    mtime = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+  #endif
+    size = static_cast<int64_t>(info.st_size);
+#endif
+    std::ostringstream keyss;
+    keyss << filename << "\n" << mtime << "\n" << size;
+    *key = keyss.str();
+    return true;
+  };
+};
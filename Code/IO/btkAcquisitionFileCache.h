@@ -0,0 +1,89 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkAcquisitionFileCache_h
+#define __btkAcquisitionFileCache_h
+
+#include "btkAcquisition.h"
+#include "btkAcquisitionFileIO.h"
+#include "btkSharedPtr.h"
+
+#include <string>
+
+namespace btk
+{
+  class critical_section_p;
+  
+  class AcquisitionFileCache
+  {
+  public:
+    typedef btkSharedPtr<AcquisitionFileCache> Pointer;
+    typedef btkSharedPtr<const AcquisitionFileCache> ConstPointer;
+    
+    static Pointer New(const std::string& directory = "") {return Pointer(new AcquisitionFileCache(directory));};
+    
+    BTK_IO_EXPORT virtual ~AcquisitionFileCache();
+    
+    const std::string& GetDirectory() const {return this->m_Directory;};
+    BTK_IO_EXPORT void SetDirectory(const std::string& directory);
+    
+    BTK_IO_EXPORT int GetHitNumber() const;
+    BTK_IO_EXPORT int GetMissNumber() const;
+    BTK_IO_EXPORT void ResetStatistics();
+    
+    BTK_IO_EXPORT bool Load(const std::string& filename, Acquisition::Pointer output, AcquisitionFileIO::Pointer io = AcquisitionFileIO::Pointer());
+    BTK_IO_EXPORT bool Store(const std::string& filename, Acquisition::Pointer input, AcquisitionFileIO::Pointer io = AcquisitionFileIO::Pointer());
+    BTK_IO_EXPORT void Remove(const std::string& filename);
+    
+  protected:
+    BTK_IO_EXPORT AcquisitionFileCache(const std::string& directory);
+    
+  private:
+    void CountRequest(bool hit);
+    bool GenerateEntry(const std::string& filename, std::string* key, std::string* entry) const;
+    void WriteSnapshot(const std::string& filename, Acquisition::Pointer input, AcquisitionFileIO::Pointer io) const;
+    void ReadSnapshot(const std::string& filename, Acquisition::Pointer output, AcquisitionFileIO::Pointer io) const;
+    
+    std::string m_Directory;
+    int m_HitNumber;
+    int m_MissNumber;
+    critical_section_p* mp_StatisticsLock;
+    
+    AcquisitionFileCache(const AcquisitionFileCache& ); // Not implemented.
+    AcquisitionFileCache& operator=(const AcquisitionFileCache& ); // Not implemented.
+  };
+};
+
+#endif // __btkAcquisitionFileCache_h
@@ -34,6 +34,11 @@
  */
 
 #include "btkAcquisitionFileIO.h"
+#include "btkFileStream.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
 
 namespace btk
 {
@@ -102,6 +107,14 @@ namespace btk
   * @var AcquisitionFileIO::m_InternalsUpdate
   * Configuration used to update file format internals when an acquisition is writed.
   */
+  /**
+   * @var AcquisitionFileIO::m_ReadingMode
+   * Reading mode (full reading or header only).
+   */
+  /**
+   * @var AcquisitionFileIO::m_HeaderFrameNumber
+   * Number of frames declared in the last file read (-1 if not provided by the file format).
+   */
   
   /**
    * @typedef AcquisitionFileIO::Pointer
@@ -195,6 +208,22 @@ namespace btk
    * enum {MyFirstOption = AcquisitionFileIO::FileFormatOption, MySecondOption = 2*AcquisitionFileIO::FileFormatOption};
    * @endcode
    */
+  
+  /**
+   * @enum AcquisitionFileIO::ReadingMode
+   * Enums used to specify the parts of the file extracted by the method Read().
+   */
+  /**
+   * @var AcquisitionFileIO::ReadingMode AcquisitionFileIO::FullReading
+   * The header, the metadata and the data are extracted (default).
+   */
+  /**
+   * @var AcquisitionFileIO::ReadingMode AcquisitionFileIO::HeaderOnly
+   * Only the header and the metadata are extracted. The points and analog channels are created with their 
+   * labels, descriptions, units, etc. but without any frame: the data section is not read and no data matrix is allocated.
+   * The number of frames declared in the file is given by the method GetHeaderFrameNumber().
+   * File formats which don't support this mode read the complete file.
+   */
     
   /** 
    * @fn static bool AcquisitionFileIO::HasReadOperation()
@@ -301,6 +330,23 @@ namespace btk
   * @fn bool AcquisitionFileIO::HasInternalsUpdateOption(int option) const
   * Returns true if the given @a option is used or false if not.
   */
+  
+  /**
+   * @fn ReadingMode AcquisitionFileIO::GetReadingMode() const
+   * Returns the parts of the file extracted by the method Read() (see AcquisitionFileIO::ReadingMode).
+   */
+  
+  /**
+   * @fn void AcquisitionFileIO::SetReadingMode(ReadingMode m)
+   * Sets the parts of the file extracted by the method Read(). Only the C3D and TRC file formats support
+   * the mode AcquisitionFileIO::HeaderOnly. The other file formats are read completely.
+   */
+  
+  /**
+   * @fn int AcquisitionFileIO::GetHeaderFrameNumber() const
+   * Returns the number of frames declared in the last file read or -1 if the file format doesn't provide it.
+   * This value is useful in the mode AcquisitionFileIO::HeaderOnly as the extracted acquisition has no frame.
+   */
     
  /**
   * @fn virtual bool AcquisitionFileIO::CanReadFile(const std::string& filename) = 0
@@ -324,6 +370,64 @@ namespace btk
    * @fn virtual void AcquisitionFileIO::Write(const std::string& filename, Acquisition::Pointer input) = 0
    * Write the file designated by @a filename with the content of @a input.
    */
+  
+  /**
+   * Read the content of a file already loaded in memory (@a data of size @a size) and fill @a output.
+   * The buffer is registered under a virtual filename (see MemoryFile) which is given to the method Read().
+   * No temporary file is created and the buffer is not copied.
+   */
+  void AcquisitionFileIO::ReadBuffer(const char* data, size_t size, Acquisition::Pointer output)
+  {
+    MemoryFile file(data, size, this->GetMemoryFileSuffix());
+    this->Read(file.GetFilename(), output);
+  };
+  
+  /**
+   * Read the remaining content of the stream @a is and fill @a output.
+   * The content is first extracted into a memory buffer and then given to the method ReadBuffer().
+   */
+  void AcquisitionFileIO::ReadStream(std::istream& is, Acquisition::Pointer output)
+  {
+    std::vector<char> data((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    this->ReadBuffer(data.empty() ? 0 : &data[0], data.size(), output);
+  };
+  
+  /**
+   * Write the content of @a input into the memory @a buffer (its previous content is replaced).
+   * The buffer is registered under a virtual filename (see MemoryFile) which is given to the method Write().
+   */
+  void AcquisitionFileIO::WriteBuffer(std::vector<char>* buffer, Acquisition::Pointer input)
+  {
+    MemoryFile file(buffer, this->GetMemoryFileSuffix());
+    this->Write(file.GetFilename(), input);
+  };
+  
+  /**
+   * Write the content of @a input into the stream @a os.
+   * The file is first encoded into a memory buffer using the method WriteBuffer().
+   */
+  void AcquisitionFileIO::WriteStream(std::ostream& os, Acquisition::Pointer input)
+  {
+    std::vector<char> buffer;
+    this->WriteBuffer(&buffer, input);
+    if (!buffer.empty())
+      os.write(&buffer[0], buffer.size());
+  };
+  
+  /**
+   * Returns the suffix given to the virtual filenames used by the methods ReadBuffer() and WriteBuffer().
+   * It corresponds to the first supported extension (in lower case) as some file formats are detected with it.
+   */
+  std::string AcquisitionFileIO::GetMemoryFileSuffix() const
+  {
+    const Extensions& extensions = this->GetSupportedExtensions();
+    if (extensions.GetSize() == 0)
+      return "";
+    std::string suffix = "." + extensions.Begin()->name;
+    std::replace(suffix.begin(), suffix.end(), '*', '1'); // GR* -> GR1
+    std::transform(suffix.begin(), suffix.end(), suffix.begin(), tolower);
+    return suffix;
+  };
    
   /**
    * Constructor.
@@ -334,6 +438,8 @@ namespace btk
     this->m_ByteOrder = b;
     this->m_StorageFormat = s;
     this->m_InternalsUpdate = internalsUpdate;
+    this->m_ReadingMode = FullReading;
+    this->m_HeaderFrameNumber = -1;
   };
   
   /**
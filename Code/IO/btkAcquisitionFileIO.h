@@ -38,7 +38,10 @@
 
 #include "btkAcquisition.h"
 
+#include <istream>
+#include <ostream>
 #include <string>
+#include <vector>
 
 namespace btk
 {
@@ -57,6 +60,7 @@ namespace btk
     typedef enum {OrderNotApplicable = 0, IEEE_LittleEndian, VAX_LittleEndian, IEEE_BigEndian} ByteOrder;
     typedef enum {StorageNotApplicable = 0, Float = -1, Integer = 1} StorageFormat;
     typedef enum {UpdateNotApplicable = 0, NoUpdate = UpdateNotApplicable, DataBasedUpdate = 1, MetaDataBasedUpdate = 2, FileFormatOption = 512} InternalsUpdateOption;
+    typedef enum {FullReading = 0, HeaderOnly} ReadingMode;
     
     virtual const Extensions& GetSupportedExtensions() const = 0;
 
@@ -73,12 +77,21 @@ namespace btk
     int GetInternalsUpdateOptions() const {return this->m_InternalsUpdate;};
     void SetInternalsUpdateOptions(int options) {this->m_InternalsUpdate = options;};
     bool HasInternalsUpdateOption(int option) const {return ((this->m_InternalsUpdate & option) == option);};
+    
+    ReadingMode GetReadingMode() const {return this->m_ReadingMode;};
+    void SetReadingMode(ReadingMode m) {this->m_ReadingMode = m;};
+    int GetHeaderFrameNumber() const {return this->m_HeaderFrameNumber;};
 
     virtual bool CanReadFile(const std::string& filename) = 0;
     virtual bool CanWriteFile(const std::string& filename) = 0;
     virtual void Read(const std::string& filename, Acquisition::Pointer output) = 0;
     virtual void Write(const std::string& filename, Acquisition::Pointer input) = 0;
     
+    BTK_IO_EXPORT void ReadBuffer(const char* data, size_t size, Acquisition::Pointer output);
+    BTK_IO_EXPORT void ReadStream(std::istream& is, Acquisition::Pointer output);
+    BTK_IO_EXPORT void WriteBuffer(std::vector<char>* buffer, Acquisition::Pointer input);
+    BTK_IO_EXPORT void WriteStream(std::ostream& os, Acquisition::Pointer input);
+    
     class Extension
     {
     public:
@@ -112,13 +125,18 @@ namespace btk
     virtual ~AcquisitionFileIO() {};
     
     void SetFileType(FileType f) {this->m_FileType = f;};
+    BTK_IO_EXPORT std::string GetMemoryFileSuffix() const;
         
     FileType m_FileType;
     ByteOrder m_ByteOrder;
     StorageFormat m_StorageFormat;
     int m_InternalsUpdate;
+    ReadingMode m_ReadingMode;
+    int m_HeaderFrameNumber;
     
   private:
+    friend class AcquisitionFileCache; // Sets the properties of an IO when its acquisition is loaded from the cache.
+    
     enum {ReadOp = 1, WriteOp = 1};
     
     AcquisitionFileIO(const AcquisitionFileIO& ); // Not implemented.
@@ -44,6 +44,8 @@
 
 // C3D File IO
 #include "btkC3DFileIO.h"
+// BTK
+#include "btkBCAFileIO.h"
 // AMTI
 #include "btkBSFFileIO.h"
 // Codamotion
@@ -89,6 +91,8 @@ namespace btk
     // This macro creates a handle for the given file IO and insert it into the factory.
 
     BTK_REGISTER_ACQUISITION_FILE_IO(C3DFileIO)
+    
+    BTK_REGISTER_ACQUISITION_FILE_IO(BCAFileIO)
 
     BTK_REGISTER_ACQUISITION_FILE_IO(ANBFileIO)
     BTK_REGISTER_ACQUISITION_FILE_IO(ANCFileIO)
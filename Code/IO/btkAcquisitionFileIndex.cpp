@@ -0,0 +1,441 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkAcquisitionFileIndex.h"
+#include "btkAcquisitionFileIOFactory.h"
+#include "btkMetaDataUtils.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sys/stat.h>
+
+#if defined(_MSC_VER)
+  #include <windows.h>
+#else
+  #include <dirent.h>
+#endif
+
+#if defined(_OPENMP)
+  #include <omp.h>
+#endif
+
+namespace btk
+{
+  // Escapes the characters used as separators in the index (tabulation, new line and backslash).
+  static std::string EscapeIndexString(const std::string& str)
+  {
+    std::string escaped;
+    escaped.reserve(str.length());
+    for (std::string::const_iterator it = str.begin() ; it != str.end() ; ++it)
+    {
+      switch (*it)
+      {
+      case '\t':
+        escaped += "\\t";
+        break;
+      case '\n':
+        escaped += "\\n";
+        break;
+      case '\r':
+        escaped += "\\r";
+        break;
+      case '\\':
+        escaped += "\\\\";
+        break;
+      default:
+        escaped += *it;
+      }
+    }
+    return escaped;
+  };
+  
+  template <typename T>
+  static void WriteIndexList(std::ostream& os, const std::vector<T>& values)
+  {
+    os << "\t";
+    for (size_t i = 0 ; i < values.size() ; ++i)
+    {
+      if (i != 0)
+        os << ",";
+      os << values[i];
+    }
+  };
+  
+  // Compares the extension of the file (case insensitive) with the extension of a file format. 
+  // The extension of the file format can finish with the wildcard '*' (e.g. GR*).
+  static bool MatchIndexExtension(const std::string& extension, const std::string& pattern)
+  {
+    size_t num = pattern.length();
+    if (!pattern.empty() && (pattern[num - 1] == '*'))
+    {
+      --num;
+      if (extension.length() <= num)
+        return false;
+    }
+    else if (extension.length() != num)
+      return false;
+    for (size_t i = 0 ; i < num ; ++i)
+    {
+      if (toupper(extension[i]) != toupper(pattern[i]))
+        return false;
+    }
+    return true;
+  };
+  
+  static bool IsIndexedFile(const std::string& filename, const AcquisitionFileIO::Extensions& extensions)
+  {
+    std::string::size_type pos = filename.find_last_of('.');
+    if (pos == std::string::npos)
+      return false;
+    const std::string extension = filename.substr(pos + 1);
+    for (AcquisitionFileIO::Extensions::ConstIterator it = extensions.Begin() ; it != extensions.End() ; ++it)
+    {
+      if (MatchIndexExtension(extension, it->name))
+        return true;
+    }
+    return false;
+  };
+  
+  static void ListIndexDirectory(const std::string& directory, bool recursive, const AcquisitionFileIO::Extensions& extensions, std::vector<std::string>* files)
+  {
+    std::vector<std::string> subdirectories;
+#if defined(_MSC_VER)
+    WIN32_FIND_DATAA data;
+    HANDLE handle = FindFirstFileA((directory + "*").c_str(), &data);
+    if (handle == INVALID_HANDLE_VALUE)
+      return;
+    do
+    {
+      const std::string name = data.cFileName;
+      if ((name.compare(".") == 0) || (name.compare("..") == 0))
+        continue;
+      if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+        subdirectories.push_back(directory + name + "/");
+      else if (IsIndexedFile(name, extensions))
+        files->push_back(directory + name);
+    }
+    while (FindNextFileA(handle, &data) != 0);
+    FindClose(handle);
+#else
+    DIR* dir = opendir(directory.c_str());
+    if (dir == 0)
+      return;
+    struct dirent* item = 0;
+    while ((item = readdir(dir)) != 0)
+    {
+      const std::string name = item->d_name;
+      if ((name.compare(".") == 0) || (name.compare("..") == 0))
+        continue;
+      struct stat info;
+      if (stat((directory + name).c_str(), &info) != 0)
+        continue;
+      if (S_ISDIR(info.st_mode))
+        subdirectories.push_back(directory + name + "/");
+      else if (S_ISREG(info.st_mode) && IsIndexedFile(name, extensions))
+        files->push_back(directory + name);
+    }
+    closedir(dir);
+#endif
+    if (recursive)
+    {
+      for (size_t i = 0 ; i < subdirectories.size() ; ++i)
+        ListIndexDirectory(subdirectories[i], recursive, extensions, files);
+    }
+  };
+  
+  /**
+   * @class AcquisitionFileIndex btkAcquisitionFileIndex.h
+   * @brief Catalogue of the content of acquisition files built without reading their data.
+   *
+   * For each file added with the methods AddFile() or AddDirectory(), the method Update() extracts 
+   * a summary of the acquisition: labels and units of the points and analog channels, sampling rates, 
+   * first frame and number of frames, events and configuration of the force platforms 
+   * (metadata FORCE_PLATFORM:TYPE, CHANNEL, CORNERS and ORIGIN).
+   *
+   * Files are read with the mode AcquisitionFileIO::HeaderOnly. Then, only their header and their 
+   * parameter section are parsed for the file formats supporting this mode (C3D, TRC) and no data matrix 
+   * is allocated. The other file formats are completely read but only the summary is kept.
+   * When BTK is compiled with OpenMP (option BTK_USE_OPENMP), the files are indexed in parallel. 
+   * The number of threads can be set with the method SetThreadNumber().
+   *
+   * An error during the reading of a file does not stop the indexation. Its message is stored 
+   * in the field Entry::error and the number of failed files is given by the method GetErrorNumber().
+   *
+   * The method Write() exports the index as a compact tab-separated text. Each file starts with 
+   * a line beginning by the tag F, followed by the lines P (points), A (analog channels), E (events), 
+   * FP (force platforms) or X (error).
+   *
+   * @ingroup BTKIO
+   */
+  
+  /**
+   * @class AcquisitionFileIndex::EventEntry btkAcquisitionFileIndex.h
+   * @brief Label, context, frame and time of an event stored in the index.
+   */
+  
+  /**
+   * @class AcquisitionFileIndex::ForcePlateEntry btkAcquisitionFileIndex.h
+   * @brief Type, analog channels (1-based indices), corners and origin of a force platform stored in the index.
+   */
+  
+  /**
+   * @class AcquisitionFileIndex::Entry btkAcquisitionFileIndex.h
+   * @brief Summary of an acquisition file.
+   *
+   * The field @a format contains the first extension of the file format used to read the file. 
+   * It is empty if the file is not supported. The field @a error is not empty if the file cannot be read.
+   */
+  
+  /**
+   * @typedef AcquisitionFileIndex::Pointer
+   * Smart pointer associated with an AcquisitionFileIndex object.
+   */
+  
+  /**
+   * @typedef AcquisitionFileIndex::ConstPointer
+   * Smart pointer associated with a const AcquisitionFileIndex object.
+   */
+  
+  /**
+   * @fn static AcquisitionFileIndex::Pointer AcquisitionFileIndex::New()
+   * Creates a smart pointer associated with an AcquisitionFileIndex object.
+   */
+  
+  /**
+   * @fn AcquisitionFileIndex::~AcquisitionFileIndex()
+   * Empty destructor.
+   */
+  
+  /**
+   * Adds the file @a filename to the index. Its content is extracted by the method Update().
+   */
+  void AcquisitionFileIndex::AddFile(const std::string& filename)
+  {
+    this->m_Entries.push_back(Entry(filename));
+  };
+  
+  /**
+   * Adds the files contained in @a directory (and its subdirectories if @a recursive is true) 
+   * with an extension supported by the AcquisitionFileIOFactory. The files are sorted by path.
+   * Returns the number of added files.
+   */
+  int AcquisitionFileIndex::AddDirectory(const std::string& directory, bool recursive)
+  {
+    std::string path = directory;
+    if (path.empty())
+      path = "./";
+    else if ((*(path.rbegin()) != '/') && (*(path.rbegin()) != '\\'))
+      path += '/';
+    std::vector<std::string> files;
+    ListIndexDirectory(path, recursive, AcquisitionFileIOFactory::GetSupportedReadExtensions(), &files);
+    std::sort(files.begin(), files.end());
+    for (size_t i = 0 ; i < files.size() ; ++i)
+      this->AddFile(files[i]);
+    return static_cast<int>(files.size());
+  };
+  
+  /**
+   * @fn void AcquisitionFileIndex::Clear()
+   * Removes all the entries.
+   */
+  
+  /**
+   * @fn int AcquisitionFileIndex::GetThreadNumber() const
+   * Returns the number of threads used to index the files. 
+   */
+  
+  /**
+   * @fn void AcquisitionFileIndex::SetThreadNumber(int num)
+   * Sets the number of threads used to index the files. A value lower or equal to 0 (default) 
+   * uses the default number of threads of OpenMP. This option has no effect if BTK is compiled without OpenMP.
+   */
+  
+  /**
+   * Extracts the content of each file added in the index.
+   */
+  void AcquisitionFileIndex::Update()
+  {
+    // The registered file formats are initialized before the parallel loop.
+    AcquisitionFileIOFactory::GetSupportedReadExtensions();
+    const int num = static_cast<int>(this->m_Entries.size());
+#if defined(_OPENMP)
+    const int threads = (this->m_ThreadNumber > 0) ? this->m_ThreadNumber : omp_get_max_threads();
+#pragma omp parallel for schedule(dynamic) num_threads(threads)
+#endif
+    for (int i = 0 ; i < num ; ++i)
+      this->FillEntry(&(this->m_Entries[i]));
+    this->m_ErrorNumber = 0;
+    for (int i = 0 ; i < num ; ++i)
+    {
+      if (!this->m_Entries[i].error.empty())
+        ++this->m_ErrorNumber;
+    }
+  };
+  
+  /**
+   * @fn const std::vector<Entry>& AcquisitionFileIndex::GetEntries() const
+   * Returns the entries of the index.
+   */
+  
+  /**
+   * @fn int AcquisitionFileIndex::GetEntryNumber() const
+   * Returns the number of files in the index.
+   */
+  
+  /**
+   * @fn int AcquisitionFileIndex::GetErrorNumber() const
+   * Returns the number of files which cannot be read during the last update.
+   */
+  
+  /**
+   * Writes the index in the stream @a os.
+   */
+  void AcquisitionFileIndex::Write(std::ostream& os) const
+  {
+    os << "# BTK acquisition index\n";
+    for (std::vector<Entry>::const_iterator it = this->m_Entries.begin() ; it != this->m_Entries.end() ; ++it)
+    {
+      os << "F\t" << EscapeIndexString(it->filename) << "\t" << it->format << "\t" << it->firstFrame << "\t" << it->frameNumber 
+         << "\t" << it->pointFrequency << "\t" << it->analogFrequency << "\n";
+      if (!it->error.empty())
+      {
+        os << "X\t" << EscapeIndexString(it->error) << "\n";
+        continue;
+      }
+      for (size_t i = 0 ; i < it->pointLabels.size() ; ++i)
+        os << "P\t" << EscapeIndexString(it->pointLabels[i]) << "\t" << it->pointTypes[i] << "\t" << EscapeIndexString(it->pointUnits[i]) << "\n";
+      for (size_t i = 0 ; i < it->analogLabels.size() ; ++i)
+        os << "A\t" << EscapeIndexString(it->analogLabels[i]) << "\t" << EscapeIndexString(it->analogUnits[i]) << "\n";
+      for (size_t i = 0 ; i < it->events.size() ; ++i)
+        os << "E\t" << EscapeIndexString(it->events[i].label) << "\t" << EscapeIndexString(it->events[i].context) << "\t" << it->events[i].frame << "\t" << it->events[i].time << "\n";
+      for (size_t i = 0 ; i < it->forcePlates.size() ; ++i)
+      {
+        os << "FP\t" << it->forcePlates[i].type;
+        WriteIndexList(os, it->forcePlates[i].channels);
+        WriteIndexList(os, it->forcePlates[i].corners);
+        WriteIndexList(os, it->forcePlates[i].origin);
+        os << "\n";
+      }
+    }
+  };
+  
+  /**
+   * Constructor.
+   */
+  AcquisitionFileIndex::AcquisitionFileIndex()
+  : m_Entries()
+  {
+    this->m_ThreadNumber = 0;
+    this->m_ErrorNumber = 0;
+  };
+  
+  /**
+   * Reads the file of the entry @a entry with the mode AcquisitionFileIO::HeaderOnly and fills its summary.
+   * This method can be called concurrently on different entries.
+   */
+  void AcquisitionFileIndex::FillEntry(Entry* entry) const
+  {
+    const std::string filename = entry->filename;
+    *entry = Entry(filename);
+    try
+    {
+      AcquisitionFileIO::Pointer io = AcquisitionFileIOFactory::CreateAcquisitionIO(filename, AcquisitionFileIOFactory::ReadMode);
+      if (!io)
+      {
+        entry->error = "File format not supported.";
+        return;
+      }
+      if (io->GetSupportedExtensions().Begin() != io->GetSupportedExtensions().End())
+        entry->format = io->GetSupportedExtensions().Begin()->name;
+      io->SetReadingMode(AcquisitionFileIO::HeaderOnly);
+      Acquisition::Pointer acq = Acquisition::New();
+      io->Read(filename, acq);
+      entry->firstFrame = acq->GetFirstFrame();
+      entry->frameNumber = (io->GetHeaderFrameNumber() >= 0) ? io->GetHeaderFrameNumber() : acq->GetPointFrameNumber();
+      entry->pointFrequency = acq->GetPointFrequency();
+      entry->analogFrequency = acq->GetAnalogFrequency();
+      for (Acquisition::PointConstIterator it = acq->BeginPoint() ; it != acq->EndPoint() ; ++it)
+      {
+        entry->pointLabels.push_back((*it)->GetLabel());
+        entry->pointTypes.push_back(static_cast<int>((*it)->GetType()));
+        entry->pointUnits.push_back(acq->GetPointUnit((*it)->GetType()));
+      }
+      for (Acquisition::AnalogConstIterator it = acq->BeginAnalog() ; it != acq->EndAnalog() ; ++it)
+      {
+        entry->analogLabels.push_back((*it)->GetLabel());
+        entry->analogUnits.push_back((*it)->GetUnit());
+      }
+      for (Acquisition::EventConstIterator it = acq->BeginEvent() ; it != acq->EndEvent() ; ++it)
+      {
+        EventEntry event;
+        event.label = (*it)->GetLabel();
+        event.context = (*it)->GetContext();
+        event.frame = (*it)->GetFrame();
+        event.time = (*it)->GetTime();
+        entry->events.push_back(event);
+      }
+      MetaData::ConstIterator itFP = acq->GetMetaData()->FindChild("FORCE_PLATFORM");
+      if (itFP != acq->GetMetaData()->End())
+      {
+        MetaData::ConstIterator itUsed = (*itFP)->FindChild("USED");
+        const int used = ((itUsed != (*itFP)->End()) && (*itUsed)->HasInfo()) ? (*itUsed)->GetInfo()->ToInt(0) : 0;
+        std::vector<int> types, channels;
+        std::vector<double> corners, origins;
+        MetaDataCollapseChildrenValues(types, *itFP, "TYPE", used, 0);
+        MetaDataCollapseChildrenValues(channels, *itFP, "CHANNEL");
+        MetaDataCollapseChildrenValues(corners, *itFP, "CORNERS", 12 * used, 0.0);
+        MetaDataCollapseChildrenValues(origins, *itFP, "ORIGIN", 3 * used, 0.0);
+        const int channelNumber = (used != 0) ? static_cast<int>(channels.size()) / used : 0;
+        for (int i = 0 ; i < used ; ++i)
+        {
+          ForcePlateEntry fp;
+          fp.type = types[i];
+          fp.channels.assign(channels.begin() + i * channelNumber, channels.begin() + (i + 1) * channelNumber);
+          fp.corners.assign(corners.begin() + 12 * i, corners.begin() + 12 * (i + 1));
+          fp.origin.assign(origins.begin() + 3 * i, origins.begin() + 3 * (i + 1));
+          entry->forcePlates.push_back(fp);
+        }
+      }
+    }
+    catch (std::exception& e)
+    {
+      entry->error = e.what();
+    }
+    catch (...)
+    {
+      entry->error = "Unexpected exception.";
+    }
+  };
+};
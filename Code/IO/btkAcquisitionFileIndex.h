@@ -0,0 +1,128 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkAcquisitionFileIndex_h
+#define __btkAcquisitionFileIndex_h
+
+#include "btkAcquisition.h"
+#include "btkSharedPtr.h"
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+namespace btk
+{
+  class AcquisitionFileIndex
+  {
+  public:
+    typedef btkSharedPtr<AcquisitionFileIndex> Pointer;
+    typedef btkSharedPtr<const AcquisitionFileIndex> ConstPointer;
+    
+    class EventEntry
+    {
+    public:
+      EventEntry() : label(), context(), frame(-1), time(-1.0) {};
+      std::string label;
+      std::string context;
+      int frame;
+      double time;
+    };
+    
+    class ForcePlateEntry
+    {
+    public:
+      ForcePlateEntry() : type(0), channels(), corners(), origin() {};
+      int type;
+      std::vector<int> channels;
+      std::vector<double> corners;
+      std::vector<double> origin;
+    };
+    
+    class Entry
+    {
+    public:
+      Entry(const std::string& f = "") : filename(f), format(), error(), firstFrame(1), frameNumber(0), pointFrequency(0.0), analogFrequency(0.0) {};
+      std::string filename;
+      std::string format;
+      std::string error;
+      int firstFrame;
+      int frameNumber;
+      double pointFrequency;
+      double analogFrequency;
+      std::vector<std::string> pointLabels;
+      std::vector<int> pointTypes;
+      std::vector<std::string> pointUnits;
+      std::vector<std::string> analogLabels;
+      std::vector<std::string> analogUnits;
+      std::vector<EventEntry> events;
+      std::vector<ForcePlateEntry> forcePlates;
+    };
+    
+    static Pointer New() {return Pointer(new AcquisitionFileIndex());};
+    
+    virtual ~AcquisitionFileIndex() {};
+    
+    BTK_IO_EXPORT void AddFile(const std::string& filename);
+    BTK_IO_EXPORT int AddDirectory(const std::string& directory, bool recursive = true);
+    void Clear() {this->m_Entries.clear(); this->m_ErrorNumber = 0;};
+    
+    int GetThreadNumber() const {return this->m_ThreadNumber;};
+    void SetThreadNumber(int num) {this->m_ThreadNumber = num;};
+    
+    BTK_IO_EXPORT void Update();
+    
+    const std::vector<Entry>& GetEntries() const {return this->m_Entries;};
+    int GetEntryNumber() const {return static_cast<int>(this->m_Entries.size());};
+    int GetErrorNumber() const {return this->m_ErrorNumber;};
+    
+    BTK_IO_EXPORT void Write(std::ostream& os) const;
+    
+  protected:
+    BTK_IO_EXPORT AcquisitionFileIndex();
+    
+  private:
+    void FillEntry(Entry* entry) const;
+    
+    std::vector<Entry> m_Entries;
+    int m_ThreadNumber;
+    int m_ErrorNumber;
+    
+    AcquisitionFileIndex(const AcquisitionFileIndex& ); // Not implemented.
+    AcquisitionFileIndex& operator=(const AcquisitionFileIndex& ); // Not implemented.
+  };
+};
+
+#endif // __btkAcquisitionFileIndex_h
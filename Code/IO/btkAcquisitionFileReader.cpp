@@ -35,8 +35,10 @@
 
 #include "btkAcquisitionFileReader.h"
 #include "btkAcquisitionFileIOFactory.h"
-
-#include <fstream>
+#include "btkBCAFileIO.h"
+#include "btkFileStream.h"
+#include "btkMemoryArena.h"
+#include "btkSharedPtr.h"
 
 namespace btk
 {
@@ -69,6 +71,21 @@ namespace btk
    *
    * Note: Internally, this class use the AcquisitionFileIOFactory class for the automatic mode.
    *
+   * An on-disk cache can be set with the method AcquisitionFileReader::SetCache() to avoid to decode 
+   * several times the same file (see AcquisitionFileCache). The cache is used only in the automatic mode, 
+   * as the options of an AcquisitionFileIO set manually (frames, labels, ...) could give a different acquisition.
+   * When the acquisition is loaded from the cache, the IO found automatically does not read the file: only its 
+   * generic properties (file type, byte order, storage format) are set (see AcquisitionFileCache::Load()).
+   *
+   * The content of a file already loaded in memory (received from the network, extracted from an archive, ...)
+   * can be read without any temporary file by using the method SetInputBuffer(). In this case, the filename
+   * is optional and only its extension is used to help the detection of the file format.
+   *
+   * When many small files are read, the allocation of the measures can be a significant part of the reading time. 
+   * The method SetMemoryArenaUsed() gives to each read acquisition its own MemoryArena, used for the coefficients 
+   * of the matrices allocated by the AcquisitionFileIO (values and residuals of the points, values of the analog channels, ...). 
+   * The arena is freed in one shot with the last of these matrices.
+   *
    * @ingroup BTKIO 
    */
   /**
@@ -79,6 +96,18 @@ namespace btk
    * @var AcquisitionFileReader::m_AcquisitionIO
    * AcquisitionFileIO helper class to read the acquisition data and fill an Acquisition object.
    */
+  /**
+   * @var AcquisitionFileReader::m_Cache
+   * Optional cache used to store and load the decoded acquisitions.
+   */
+  /**
+   * @var AcquisitionFileReader::mp_InputBuffer
+   * Optional memory buffer read instead of the file.
+   */
+  /**
+   * @var AcquisitionFileReader::m_InputBufferSize
+   * Size of the memory buffer read instead of the file.
+   */
   
   /**
    * @typedef AcquisitionFileReader::Pointer
@@ -132,6 +161,32 @@ namespace btk
     }
   };
   
+  /**
+   * @fn const char* AcquisitionFileReader::GetInputBuffer() const
+   * Returns the memory buffer read instead of the file (null by default).
+   */
+  
+  /**
+   * @fn size_t AcquisitionFileReader::GetInputBufferSize() const
+   * Returns the size of the memory buffer read instead of the file.
+   */
+  
+  /**
+   * Specifies a memory buffer containing the content of the file to read. 
+   * The buffer is not copied and must remain valid until the update of this reader.
+   * The filename (if set) is only used for its extension as some AcquisitionFileIO use it to detect the file format.
+   * Set a null buffer to read again the file given by the filename.
+   */
+  void AcquisitionFileReader::SetInputBuffer(const char* data, size_t size)
+  {
+    if ((this->mp_InputBuffer != data) || (this->m_InputBufferSize != size))
+    {
+      this->mp_InputBuffer = data;
+      this->m_InputBufferSize = (data != 0) ? size : 0;
+      this->Modified();
+    }
+  };
+  
   /**
    * @fn AcquisitionFileIO::Pointer AcquisitionFileReader::GetAcquisitionIO()
    * Returns a Poiner associated with the AcquisitionIO helper class used to read the file.
@@ -153,18 +208,65 @@ namespace btk
     if (this->m_AcquisitionIO != io ) 
     {
       this->m_AcquisitionIO = io;
+      this->m_AcquisitionIOAutomatic = false;
       this->Modified(); 
     }
   };
   
+  /**
+   * @fn AcquisitionFileCache::Pointer AcquisitionFileReader::GetCache()
+   * Returns the cache used by this reader (null by default).
+   */
+  
+  /**
+   * @fn AcquisitionFileCache::ConstPointer AcquisitionFileReader::GetCache() const
+   * Returns the cache used by this reader (null by default).
+   */
+  
+  /**
+   * Sets the cache used to store and load the decoded acquisitions. 
+   * Without argument, the cache is disabled.
+   */
+  void AcquisitionFileReader::SetCache(AcquisitionFileCache::Pointer cache)
+  {
+    if (this->m_Cache != cache)
+    {
+      this->m_Cache = cache;
+      this->Modified();
+    }
+  };
+  
+  /**
+   * @fn bool AcquisitionFileReader::GetMemoryArenaUsed() const
+   * Returns true if the matrices of the read acquisition are allocated in a MemoryArena (false by default).
+   */
+  
+  /**
+   * Enables or disables the use of a MemoryArena to allocate the matrices of the read acquisition.
+   * A new arena is created for each read. It is not used when the acquisition is loaded from the cache.
+   * @warning The code which modifies or destroys the read acquisition must include a BTK header before the Eigen headers (see MemoryArena).
+   */
+  void AcquisitionFileReader::SetMemoryArenaUsed(bool used)
+  {
+    if (this->m_MemoryArenaUsed != used)
+    {
+      this->m_MemoryArenaUsed = used;
+      this->Modified();
+    }
+  };
+  
   /**
    * Constructor. Sets the number of outputs equal to one. No input.
    */
   AcquisitionFileReader::AcquisitionFileReader()
-  : m_AcquisitionIO(), m_Filename()
+  : m_AcquisitionIO(), m_Filename(), m_Cache()
   {
+    this->mp_InputBuffer = 0;
+    this->m_InputBufferSize = 0;
     this->SetOutputNumber(1);
     this->m_FilenameExtensionDisabled = false;
+    this->m_AcquisitionIOAutomatic = false;
+    this->m_MemoryArenaUsed = false;
   };
   
   /**
@@ -183,35 +285,59 @@ namespace btk
   
   /**
    * Check the file integrety, find a AcquisitionIO helper class if no one has
-   * been specified and finally read the file.
+   * been specified and finally read the file. If a cache is set (and the AcquisitionIO 
+   * was found automatically), the acquisition is loaded from the cache when possible 
+   * or stored in it after the reading.
    */
   void AcquisitionFileReader::GenerateData()
   {
-    if (this->m_Filename.empty())
+    std::string filename = this->m_Filename;
+    btkSharedPtr<MemoryFile> buffer;
+    // The content of the file is already in memory.
+    if (this->mp_InputBuffer != 0)
     {
-      if (!this->m_FilenameExtensionDisabled)
-        throw AcquisitionFileReaderException("Filename must be specified");
-      else
-        return;
+      buffer.reset(new MemoryFile(this->mp_InputBuffer, this->m_InputBufferSize, MemoryFile::ExtractSuffix(this->m_Filename)));
+      filename = buffer->GetFilename();
+    }
+    else
+    {
+      if (this->m_Filename.empty())
+      {
+        if (!this->m_FilenameExtensionDisabled)
+          throw AcquisitionFileReaderException("Filename must be specified");
+        else
+          return;
+      }
+      
+      ifilestream ifs;
+      ifs.open(this->m_Filename.c_str());
+      // check if the file exists
+      if (!ifs.is_open())
+        throw AcquisitionFileReaderException("File doesn't exist\nFilename: " + this->m_Filename);
+      // check if the file is not read only
+      if(ifs.fail())
+        throw AcquisitionFileReaderException("File can't be opened. Have you the permission to read this file?\nFilename: " + this->m_Filename);
+      ifs.close();
     }
-    
-    std::ifstream ifs;
-    ifs.open(this->m_Filename.c_str());
-    // check if the file exists
-    if (!ifs.is_open())
-      throw AcquisitionFileReaderException("File doesn't exist\nFilename: " + this->m_Filename);
-    // check if the file is not read only
-    if(ifs.fail())
-      throw AcquisitionFileReaderException("File can't be opened. Have you the permission to read this file?\nFilename: " + this->m_Filename);
-    ifs.close();
     
     if (this->m_AcquisitionIO.get() == 0)
     {
-      this->m_AcquisitionIO = AcquisitionFileIOFactory::CreateAcquisitionIO(this->m_Filename.c_str(), AcquisitionFileIOFactory::ReadMode);
+      this->m_AcquisitionIO = AcquisitionFileIOFactory::CreateAcquisitionIO(filename.c_str(), AcquisitionFileIOFactory::ReadMode);
       if (this->m_AcquisitionIO.get() == 0)
         throw AcquisitionFileReaderException("No IO found, the file is not supported or valid or the file suffix is misspelled (Some IO use it to verify they can read the file)\nFilename: " + this->m_Filename);
+      this->m_AcquisitionIOAutomatic = true;
     }
     
-    this->m_AcquisitionIO->Read(this->m_Filename, this->GetOutput());
+    // A BCA file is already a decoded snapshot and a memory buffer has no stable key.
+    const bool cached = (this->m_Cache.get() != 0) && this->m_AcquisitionIOAutomatic && (buffer.get() == 0) && (dynamic_cast<BCAFileIO*>(this->m_AcquisitionIO.get()) == 0);
+    if (cached && this->m_Cache->Load(this->m_Filename, this->GetOutput(), this->m_AcquisitionIO))
+      return;
+    {
+      // The arena is kept alive by the matrices allocated in it.
+      MemoryArena::Scope scope(this->m_MemoryArenaUsed ? MemoryArena::New() : MemoryArena::Pointer());
+      this->m_AcquisitionIO->Read(filename, this->GetOutput());
+    }
+    if (cached)
+      this->m_Cache->Store(this->m_Filename, this->GetOutput(), this->m_AcquisitionIO);
   };
 };
@@ -40,6 +40,7 @@
 #include "btkProcessObject.h"
 #include "btkAcquisition.h"
 #include "btkAcquisitionFileIO.h"
+#include "btkAcquisitionFileCache.h"
 
 namespace btk
 {
@@ -69,9 +70,17 @@ namespace btk
     void SetDisableFilenameExceptionState(bool s) {this->m_FilenameExtensionDisabled = s;};
     const std::string& GetFilename() const {return this->m_Filename;};
     BTK_IO_EXPORT void SetFilename(const std::string& filename);
+    const char* GetInputBuffer() const {return this->mp_InputBuffer;};
+    size_t GetInputBufferSize() const {return this->m_InputBufferSize;};
+    BTK_IO_EXPORT void SetInputBuffer(const char* data, size_t size);
     AcquisitionFileIO::Pointer GetAcquisitionIO() {return this->m_AcquisitionIO;};
     AcquisitionFileIO::ConstPointer GetAcquisitionIO() const {return this->m_AcquisitionIO;};
     BTK_IO_EXPORT void SetAcquisitionIO(AcquisitionFileIO::Pointer io = AcquisitionFileIO::Pointer());
+    AcquisitionFileCache::Pointer GetCache() {return this->m_Cache;};
+    AcquisitionFileCache::ConstPointer GetCache() const {return this->m_Cache;};
+    BTK_IO_EXPORT void SetCache(AcquisitionFileCache::Pointer cache = AcquisitionFileCache::Pointer());
+    bool GetMemoryArenaUsed() const {return this->m_MemoryArenaUsed;};
+    BTK_IO_EXPORT void SetMemoryArenaUsed(bool used);
   
   protected:
     BTK_IO_EXPORT AcquisitionFileReader();
@@ -82,12 +91,17 @@ namespace btk
     
     AcquisitionFileIO::Pointer m_AcquisitionIO;
     std::string m_Filename;
+    AcquisitionFileCache::Pointer m_Cache;
+    const char* mp_InputBuffer;
+    size_t m_InputBufferSize;
     
   private:
     AcquisitionFileReader(const AcquisitionFileReader& ); // Not implemented.
     AcquisitionFileReader& operator=(const AcquisitionFileReader& ); // Not implemented.
 
     bool m_FilenameExtensionDisabled;
+    bool m_AcquisitionIOAutomatic;
+    bool m_MemoryArenaUsed;
   };
 };
 
@@ -35,8 +35,8 @@
 
 #include "btkAcquisitionFileWriter.h"
 #include "btkAcquisitionFileIOFactory.h"
-
-#include <fstream>
+#include "btkFileStream.h"
+#include "btkSharedPtr.h"
 
 namespace btk
 {
@@ -82,6 +82,10 @@ namespace btk
    * writer->Update();
    * @endcode
    *
+   * The file can also be encoded into memory (to be sent over the network, stored in a database, ...) without 
+   * any temporary file by using the method SetOutputBuffer(). In this case, the filename is only used for its extension
+   * to select the file format (unless an AcquisitionIO is set).
+   *
    * @ingroup BTKIO
    */
   /**
@@ -92,6 +96,10 @@ namespace btk
    * @var AcquisitionFileWriter::m_AcquisitionIO
    * AcquisitionFileIO helper class to read the acquisition data and fill an Acquisition object.
    */
+  /**
+   * @var AcquisitionFileWriter::mp_OutputBuffer
+   * Optional memory buffer written instead of the file.
+   */
   
   /**
    * @typedef AcquisitionFileWriter::Pointer
@@ -140,6 +148,25 @@ namespace btk
     }
   };
   
+  /**
+   * @fn std::vector<char>* AcquisitionFileWriter::GetOutputBuffer() const
+   * Returns the memory buffer written instead of the file (null by default).
+   */
+  
+  /**
+   * Specifies a memory buffer where the content of the file is written. Its previous content is replaced.
+   * The buffer must remain valid until the update of this writer.
+   * Set a null buffer to write again the file given by the filename.
+   */
+  void AcquisitionFileWriter::SetOutputBuffer(std::vector<char>* buffer)
+  {
+    if (this->mp_OutputBuffer != buffer)
+    {
+      this->mp_OutputBuffer = buffer;
+      this->Modified();
+    }
+  };
+  
   /**
    * @fn AcquisitionFileIO::Pointer AcquisitionFileWriter::GetAcquisitionIO()
    * Returns a Pointer associated with the AcquisitionIO helper class
@@ -171,6 +198,7 @@ namespace btk
   AcquisitionFileWriter::AcquisitionFileWriter()
   : m_AcquisitionIO(), m_Filename()
   {
+    this->mp_OutputBuffer = 0;
     this->SetInputNumber(1);
   };
   
@@ -194,22 +222,35 @@ namespace btk
    */
   void AcquisitionFileWriter::GenerateData()
   {
-    if (this->m_Filename.empty())
-      throw AcquisitionFileWriterException("Filename must be specified.");
-    
-    std::ofstream ofs(this->m_Filename.c_str());
-    // check if the file exists
-    if (!ofs)
-      throw AcquisitionFileWriterException("File can't be opened. Have you the permission to write this file?\nFilename: " + this->m_Filename);
-    ofs.close();
+    std::string filename = this->m_Filename;
+    btkSharedPtr<MemoryFile> buffer;
+    // The content of the file is written in memory.
+    if (this->mp_OutputBuffer != 0)
+    {
+      if (this->m_Filename.empty() && (this->m_AcquisitionIO.get() == 0))
+        throw AcquisitionFileWriterException("Filename or AcquisitionIO must be specified to select the format of the file written in memory.");
+      buffer.reset(new MemoryFile(this->mp_OutputBuffer, MemoryFile::ExtractSuffix(this->m_Filename)));
+      filename = buffer->GetFilename();
+    }
+    else
+    {
+      if (this->m_Filename.empty())
+        throw AcquisitionFileWriterException("Filename must be specified.");
+      
+      ofilestream ofs(this->m_Filename.c_str());
+      // check if the file exists
+      if (!ofs)
+        throw AcquisitionFileWriterException("File can't be opened. Have you the permission to write this file?\nFilename: " + this->m_Filename);
+      ofs.close();
+    }
     
     if (this->m_AcquisitionIO.get() == 0)
     {
-      this->m_AcquisitionIO = AcquisitionFileIOFactory::CreateAcquisitionIO(this->m_Filename.c_str(), AcquisitionFileIOFactory::WriteMode);
+      this->m_AcquisitionIO = AcquisitionFileIOFactory::CreateAcquisitionIO(filename.c_str(), AcquisitionFileIOFactory::WriteMode);
       if (this->m_AcquisitionIO.get() == 0)
         throw AcquisitionFileWriterException("No IO found, the file is not supported or the file suffix is misspelled (IOs use it to verify they can write the file)\nFilename: " + this->m_Filename);
     }
     
-    this->m_AcquisitionIO->Write(this->m_Filename, this->GetInput());
+    this->m_AcquisitionIO->Write(filename, this->GetInput());
   };
 };
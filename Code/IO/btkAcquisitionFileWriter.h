@@ -41,6 +41,8 @@
 #include "btkAcquisition.h"
 #include "btkAcquisitionFileIO.h"
 
+#include <vector>
+
 namespace btk
 {
   class AcquisitionFileWriterException : public Exception
@@ -67,6 +69,8 @@ namespace btk
     void SetInput(Acquisition::Pointer input) {this->SetNthInput(0, input);};    
     const std::string& GetFilename() const {return this->m_Filename;};
     BTK_IO_EXPORT void SetFilename(const std::string& filename);
+    std::vector<char>* GetOutputBuffer() const {return this->mp_OutputBuffer;};
+    BTK_IO_EXPORT void SetOutputBuffer(std::vector<char>* buffer);
     AcquisitionFileIO::Pointer GetAcquisitionIO() {return this->m_AcquisitionIO;};
     AcquisitionFileIO::ConstPointer GetAcquisitionIO() const {return this->m_AcquisitionIO;};
     BTK_IO_EXPORT void SetAcquisitionIO(AcquisitionFileIO::Pointer io = AcquisitionFileIO::Pointer());
@@ -80,6 +84,7 @@ namespace btk
     
     AcquisitionFileIO::Pointer m_AcquisitionIO;
     std::string m_Filename;
+    std::vector<char>* mp_OutputBuffer;
     
   private:
     AcquisitionFileWriter(const AcquisitionFileWriter& ); // Not implemented.
@@ -0,0 +1,605 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkBCAFileIO.h"
+#include "btkBCAFileIOUtils_p.h"
+#include "btkBinaryFileStream.h"
+#include "btkConvert.h"
+#include "btkLogger.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#if defined(_OPENMP)
+  #include <omp.h>
+#endif
+
+namespace btk
+{
+  static const uint32_t BCAKey = 0x1A414342; // "BCA\x1A"
+  static const uint32_t BCAVersion = 1;
+  static const int BCADefaultChunkSize = 4096;
+  
+  // Chunk of a column (point or analog channel) to decode.
+  struct BCAChunk
+  {
+    double* components[4];
+    int numComponents;
+    int numSamples;
+    int first;
+    int count;
+    size_t offset;
+    size_t size;
+  };
+  
+  // Chunk of a column (point or analog channel) to encode. The values are only read.
+  struct BCAInputChunk
+  {
+    const double* components[4];
+    int numComponents;
+    int numSamples;
+  };
+  
+  /**
+   * @class BCAFileIOException btkBCAFileIO.h
+   * @brief Exception class for the BCAFileIO class.
+   */
+  
+  /**
+   * @fn BCAFileIOException::BCAFileIOException(const std::string& msg)
+   * Constructor.
+   */
+  
+  /**
+   * @fn virtual BCAFileIOException::~BCAFileIOException()
+   * Empty destructor.
+   */
+  
+  /**
+   * @class BCAFileIO btkBCAFileIO.h
+   * @brief Interface to read/write BCA files (BTK Columnar Acquisition).
+   *
+   * The BCA file format is a binary format (little endian) designed to archive acquisitions without 
+   * loss of precision (values stored as double) and with a size smaller than the C3D format.
+   * Each point (coordinates and residuals) and each analog channel is stored as an independent column 
+   * split in chunks of samples (see SetChunkSize()). Each chunk is delta encoded on the bit representation 
+   * of the values, its bytes are gathered by significance (byte shuffling) and then compressed.
+   *
+   * The file is composed of:
+   *  - a header with the acquisition's parameters, the metadata, the events and the description of the columns;
+   *  - an index giving the offset and the size of each chunk;
+   *  - the chunks.
+   *
+   * The index gives a random access to the data. You can then read only some channels (see SetLabelsToRead())
+   * and/or a range of frames (see SetFramesIndex()). The chunks are encoded and decoded independently and in parallel 
+   * when BTK is compiled with OpenMP (option BTK_USE_OPENMP, see SetThreadNumber()).
+   *
+   * @ingroup BTKIO
+   */
+  
+  /**
+   * @typedef BCAFileIO::Pointer
+   * Smart pointer associated with a BCAFileIO object.
+   */
+  
+  /**
+   * @typedef BCAFileIO::ConstPointer
+   * Smart pointer associated with a const BCAFileIO object.
+   */
+  
+  /**
+   * @fn static BCAFileIO::Pointer BCAFileIO::New()
+   * Create a BCAFileIO object an return it as a smart pointer.
+   */
+  
+  /**
+   * @fn int BCAFileIO::GetChunkSize() const
+   * Returns the number of samples stored in each chunk of a column when writing a file.
+   */
+  
+  /**
+   * Sets the number of samples stored in each chunk of a column when writing a file (4096 by default).
+   * Smaller chunks give a finer random access but a lower compression ratio.
+   */
+  void BCAFileIO::SetChunkSize(int size)
+  {
+    if (size <= 0)
+    {
+      btkErrorMacro("The size of the chunks must be strictly positive.");
+      return;
+    }
+    this->m_ChunkSize = size;
+  };
+  
+  /**
+   * @fn const int* BCAFileIO::GetFramesIndex() const
+   * Returns the indices (0-based) of the first and last frames extracted during the reading.
+   * The value -1 means the first (or the last) frame of the file.
+   */
+  
+  /**
+   * Sets the indices (0-based) of the first (@a lb) and last (@a ub) frames to extract during the reading.
+   * The value -1 correspond to the first (for @a lb) or the last (for @a ub) frame of the file.
+   * Only the chunks containing these frames are decoded and only the events inside this range are kept.
+   */
+  void BCAFileIO::SetFramesIndex(int lb, int ub)
+  {
+    if ((lb < -1) || (ub < -1) || ((lb != -1) && (ub != -1) && (lb > ub)))
+    {
+      btkErrorMacro("Invalid frames index.");
+      return;
+    }
+    this->mp_FramesIndex[0] = lb;
+    this->mp_FramesIndex[1] = ub;
+  };
+  
+  /**
+   * @fn const std::list<std::string>& BCAFileIO::GetLabelsToRead() const
+   * Returns the labels of the points and analog channels to extract during the reading. 
+   * An empty list means all the points and analog channels.
+   */
+  
+  /**
+   * @fn void BCAFileIO::SetLabelsToRead(const std::list<std::string>& labels)
+   * Sets the labels of the points and analog channels to extract during the reading.
+   * The chunks of the other columns are not read. An empty list means all the points and analog channels.
+   */
+  
+  /**
+   * @fn int BCAFileIO::GetThreadNumber() const
+   * Returns the number of threads used to encode or decode the chunks (0 by default, i.e. the default number of threads of OpenMP).
+   */
+  
+  /**
+   * @fn void BCAFileIO::SetThreadNumber(int num)
+   * Sets the number of threads used to encode or decode the chunks. A value lower or equal to 0 uses the default number of threads of OpenMP.
+   * This option has no effect if BTK is compiled without OpenMP.
+   */
+  
+  /**
+   * Checks if the first word in the file corresponds to "BCA\x1A".
+   */
+  bool BCAFileIO::CanReadFile(const std::string& filename)
+  {
+    bool isReadable = true;
+    IEEELittleEndianBinaryFileStream ifs(filename, BinaryFileStream::In);
+    if (!ifs.IsOpen() || (ifs.ReadU32() != BCAKey) || !ifs.Good())
+      isReadable = false;
+    ifs.Close();
+    return isReadable;
+  };
+  
+  /**
+   * Checks if the suffix of @a filename is BCA.
+   */
+  bool BCAFileIO::CanWriteFile(const std::string& filename)
+  {
+    std::string lowercase = filename;
+    std::transform(lowercase.begin(), lowercase.end(), lowercase.begin(), tolower);
+    std::string::size_type BCAPos = lowercase.rfind(".bca");
+    if ((BCAPos != std::string::npos) && (BCAPos == lowercase.length() - 4))
+      return true;
+    else
+      return false;
+  };
+  
+  /**
+   * Read the file designated by @a filename and fill @a output.
+   */
+  void BCAFileIO::Read(const std::string& filename, Acquisition::Pointer output)
+  {
+    output->Reset();
+    IEEELittleEndianBinaryFileStream bifs;
+    bifs.SetExceptions(BinaryFileStream::EndFileBit | BinaryFileStream::FailBit | BinaryFileStream::BadBit);
+    try
+    {
+      bifs.Open(filename, BinaryFileStream::In);
+      if (bifs.ReadU32() != BCAKey)
+        throw(BCAFileIOException("Invalid header key."));
+      if (bifs.ReadU32() != BCAVersion)
+        throw(BCAFileIOException("Unsupported version."));
+      // Acquisition's parameters
+      const int32_t firstFrame = bifs.ReadI32();
+      const double pointFrequency = bifs.ReadDouble();
+      const int32_t numFrames = ReadBCANumber_p(&bifs);
+      const int32_t numSamplesPerFrame = bifs.ReadI32();
+      const int32_t resolution = bifs.ReadI32();
+      const int32_t maxInterpolationGap = bifs.ReadI32();
+      const int32_t chunkSize = bifs.ReadI32();
+      if ((numSamplesPerFrame <= 0) || (chunkSize <= 0))
+        throw(BCAFileIOException("Invalid acquisition's parameters."));
+      std::vector<std::string> units(ReadBCANumber_p(&bifs));
+      for (size_t i = 0 ; i < units.size() ; ++i)
+        units[i] = ReadBCAString_p(&bifs);
+      // Metadata
+      MetaData::Pointer root = ReadBCAMetaData_p(&bifs);
+      // Events
+      std::vector<Event::Pointer> events(ReadBCANumber_p(&bifs));
+      for (size_t i = 0 ; i < events.size() ; ++i)
+      {
+        const std::string label = ReadBCAString_p(&bifs);
+        const std::string context = ReadBCAString_p(&bifs);
+        const std::string subject = ReadBCAString_p(&bifs);
+        const std::string desc = ReadBCAString_p(&bifs);
+        const double time = bifs.ReadDouble();
+        const int32_t frame = bifs.ReadI32();
+        const int32_t flags = bifs.ReadI32();
+        const int32_t id = bifs.ReadI32();
+        events[i] = Event::New(label, time, frame, context, flags, subject, desc, id);
+      }
+      // Columns
+      const int32_t numPoints = ReadBCANumber_p(&bifs);
+      std::vector<Point::Pointer> points(numPoints);
+      for (int32_t i = 0 ; i < numPoints ; ++i)
+      {
+        const std::string label = ReadBCAString_p(&bifs);
+        const std::string desc = ReadBCAString_p(&bifs);
+        const int32_t type = bifs.ReadI32();
+        if ((type < Point::Marker) || (type > Point::Reaction))
+          throw(BCAFileIOException("Unknown type for the point " + label + "."));
+        points[i] = Point::New(label, static_cast<Point::Type>(type), desc);
+      }
+      const int32_t numAnalogs = ReadBCANumber_p(&bifs);
+      std::vector<Analog::Pointer> analogs(numAnalogs);
+      for (int32_t i = 0 ; i < numAnalogs ; ++i)
+      {
+        const std::string label = ReadBCAString_p(&bifs);
+        const std::string desc = ReadBCAString_p(&bifs);
+        analogs[i] = Analog::New(label, desc);
+        analogs[i]->SetUnit(ReadBCAString_p(&bifs));
+        analogs[i]->SetGain(static_cast<Analog::Gain>(bifs.ReadI32()));
+        analogs[i]->SetOffset(bifs.ReadDouble());
+        analogs[i]->SetScale(bifs.ReadDouble());
+      }
+      // Chunks' index
+      const int32_t numAnalogFrames = numFrames * numSamplesPerFrame;
+      const int32_t numPointChunks = (numFrames + chunkSize - 1) / chunkSize;
+      const int32_t numAnalogChunks = (numAnalogFrames + chunkSize - 1) / chunkSize;
+      std::vector<uint32_t> index = bifs.ReadU32(2 * (numPoints * numPointChunks + numAnalogs * numAnalogChunks));
+      const BinaryFileStream::StreamPosition dataOffset = bifs.TellRead();
+      
+      // Frames to extract
+      int lb = (this->mp_FramesIndex[0] == -1) ? 0 : this->mp_FramesIndex[0];
+      int ub = (this->mp_FramesIndex[1] == -1) ? numFrames - 1 : this->mp_FramesIndex[1];
+      if ((numFrames != 0) && ((lb >= numFrames) || (ub >= numFrames)))
+        throw(BCAFileIOException("The frames index exceeds the number of frames in the file."));
+      const int numFramesFinal = (numFrames != 0) ? ub - lb + 1 : 0;
+      
+      // Init the output
+      output->Init(0, numFramesFinal, 0, numSamplesPerFrame);
+      MetaData::Pointer md = output->GetMetaData();
+      for (MetaData::Iterator it = root->Begin() ; it != root->End() ; ++it)
+        md->AppendChild(*it);
+      output->SetPointFrequency(pointFrequency);
+      output->SetFirstFrame(firstFrame + lb);
+      output->SetAnalogResolution(static_cast<Acquisition::AnalogResolution>(resolution));
+      output->SetMaxInterpolationGap(maxInterpolationGap);
+      if (units.size() == output->GetPointUnits().size())
+        output->SetPointUnits(units);
+      for (size_t i = 0 ; i < events.size() ; ++i)
+      {
+        const int frame = events[i]->GetFrame();
+        if ((frame < 0) || ((frame >= firstFrame + lb) && (frame <= firstFrame + ub)))
+          output->AppendEvent(events[i]);
+      }
+      
+      // Selection of the columns and of their chunks
+      std::vector<BCAChunk> chunks;
+      size_t bufferSize = 0;
+      for (int32_t i = 0 ; i < numPoints + numAnalogs ; ++i)
+      {
+        const bool isPoint = (i < numPoints);
+        const std::string& label = isPoint ? points[i]->GetLabel() : analogs[i - numPoints]->GetLabel();
+        if (!this->IsLabelSelected(label))
+          continue;
+        const int numSamples = isPoint ? numFrames : numAnalogFrames;
+        const int ratio = isPoint ? 1 : numSamplesPerFrame;
+        const int begin = lb * ratio;
+        const int end = begin + numFramesFinal * ratio;
+        const int numChunks = isPoint ? numPointChunks : numAnalogChunks;
+        const size_t indexOffset = isPoint ? (2 * i * numPointChunks) : (2 * (numPoints * numPointChunks + (i - numPoints) * numAnalogChunks));
+        double* components[4];
+        int numComponents;
+        if (isPoint)
+        {
+          Point::Pointer p = points[i];
+          p->SetFrameNumber(numFramesFinal);
+          output->AppendPoint(p);
+          if (numFramesFinal == 0)
+            continue;
+          components[0] = p->GetValues().data();
+          components[1] = components[0] + numFramesFinal;
+          components[2] = components[1] + numFramesFinal;
+          components[3] = p->GetResiduals().data();
+          numComponents = 4;
+        }
+        else
+        {
+          Analog::Pointer a = analogs[i - numPoints];
+          a->SetFrameNumber(numFramesFinal * numSamplesPerFrame);
+          output->AppendAnalog(a);
+          if (numFramesFinal == 0)
+            continue;
+          components[0] = a->GetValues().data();
+          numComponents = 1;
+        }
+        for (int c = 0 ; c < numChunks ; ++c)
+        {
+          const int chunkBegin = c * chunkSize;
+          const int chunkEnd = std::min(chunkBegin + chunkSize, numSamples);
+          const int first = std::max(begin, chunkBegin);
+          const int last = std::min(end, chunkEnd);
+          if (first >= last)
+            continue;
+          BCAChunk chunk;
+          for (int k = 0 ; k < numComponents ; ++k)
+            chunk.components[k] = components[k] + (first - begin);
+          chunk.numComponents = numComponents;
+          chunk.numSamples = chunkEnd - chunkBegin;
+          chunk.first = first - chunkBegin;
+          chunk.count = last - first;
+          chunk.offset = index[indexOffset + 2 * c];
+          chunk.size = index[indexOffset + 2 * c + 1];
+          chunks.push_back(chunk);
+          bufferSize += chunk.size;
+        }
+      }
+      
+      // Read the selected chunks (sequentially)
+      std::vector<uint8_t> buffer(bufferSize);
+      size_t inc = 0;
+      for (size_t j = 0 ; j < chunks.size() ; ++j)
+      {
+        bifs.SeekRead(dataOffset + static_cast<BinaryFileStream::StreamOffset>(chunks[j].offset), BinaryFileStream::Begin);
+        if (chunks[j].size != 0)
+          bifs.ReadU8(chunks[j].size, &(buffer[inc]));
+        chunks[j].offset = inc;
+        inc += chunks[j].size;
+      }
+      bifs.Close();
+      
+      // Decode them (in parallel if possible)
+      const int numChunks = static_cast<int>(chunks.size());
+      std::vector<int> decoded(numChunks, 0);
+#if defined(_OPENMP)
+      const int threads = (this->m_ThreadNumber > 0) ? this->m_ThreadNumber : omp_get_max_threads();
+      #pragma omp parallel for schedule(dynamic) num_threads(threads)
+#endif
+      for (int j = 0 ; j < numChunks ; ++j)
+      {
+        const BCAChunk& chunk = chunks[j];
+        const uint8_t* input = (chunk.size != 0) ? &(buffer[chunk.offset]) : 0;
+        decoded[j] = DecodeBCAChunk_p(input, chunk.size, chunk.numComponents, chunk.numSamples, chunk.first, chunk.count, chunk.components) ? 1 : 0;
+      }
+      if (std::find(decoded.begin(), decoded.end(), 0) != decoded.end())
+        throw(BCAFileIOException("Corrupted data."));
+    }
+    catch (BinaryFileStreamFailure& )
+    {
+      std::string excmsg; 
+      if (bifs.EndFile())
+        excmsg = "Unexpected end of file.";
+      else if (!bifs.IsOpen())
+        excmsg = "Invalid file path.";
+      else if(bifs.Bad())
+        excmsg = "Loss of integrity of the file stream.";
+      else if(bifs.Fail())
+        excmsg = "Internal logic operation error on the stream associated with the file.";
+      else
+        excmsg = "Unknown error associated with the file stream.";
+      
+      if (bifs.IsOpen()) bifs.Close();
+      throw(BCAFileIOException(excmsg));
+    }
+    catch (BCAFileIOException& )
+    {
+      if (bifs.IsOpen()) bifs.Close();
+      throw;
+    }
+    catch (std::exception& e)
+    {
+      if (bifs.IsOpen()) bifs.Close();
+      throw(BCAFileIOException("Unexpected exception occurred: " + std::string(e.what())));
+    }
+    catch(...)
+    {
+      if (bifs.IsOpen()) bifs.Close();
+      throw(BCAFileIOException("Unknown exception"));
+    }
+  };
+  
+  /**
+   * Write the file designated by @a filename with the content of @a input.
+   */
+  void BCAFileIO::Write(const std::string& filename, Acquisition::Pointer input)
+  {
+    if (!input)
+    {
+      btkErrorMacro("Impossible to write a null input into a file.");
+      return;
+    }
+    IEEELittleEndianBinaryFileStream bofs;
+    try
+    {
+      const int numFrames = input->GetPointFrameNumber();
+      const int numAnalogFrames = input->GetAnalogFrameNumber();
+      const int chunkSize = this->m_ChunkSize;
+      
+      // Split the columns in chunks (points then analog channels)
+      // The measures are read with the const accessors to not copy the values shared with other objects.
+      std::vector<BCAInputChunk> chunks;
+      for (Acquisition::PointIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it)
+      {
+        Point::ConstPointer p = *it;
+        for (int s = 0 ; s < numFrames ; s += chunkSize)
+        {
+          BCAInputChunk chunk;
+          chunk.components[0] = p->GetValues().data() + s;
+          chunk.components[1] = chunk.components[0] + numFrames;
+          chunk.components[2] = chunk.components[1] + numFrames;
+          chunk.components[3] = p->GetResiduals().data() + s;
+          chunk.numComponents = 4;
+          chunk.numSamples = std::min(chunkSize, numFrames - s);
+          chunks.push_back(chunk);
+        }
+      }
+      for (Acquisition::AnalogIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
+      {
+        Analog::ConstPointer a = *it;
+        for (int s = 0 ; s < numAnalogFrames ; s += chunkSize)
+        {
+          BCAInputChunk chunk;
+          chunk.components[0] = a->GetValues().data() + s;
+          chunk.numComponents = 1;
+          chunk.numSamples = std::min(chunkSize, numAnalogFrames - s);
+          chunks.push_back(chunk);
+        }
+      }
+      
+      // Encode them (in parallel if possible)
+      const int numChunks = static_cast<int>(chunks.size());
+      std::vector< std::vector<uint8_t> > encoded(numChunks);
+#if defined(_OPENMP)
+      const int threads = (this->m_ThreadNumber > 0) ? this->m_ThreadNumber : omp_get_max_threads();
+      #pragma omp parallel for schedule(dynamic) num_threads(threads)
+#endif
+      for (int j = 0 ; j < numChunks ; ++j)
+        EncodeBCAChunk_p(chunks[j].components, chunks[j].numComponents, chunks[j].numSamples, &(encoded[j]));
+      
+      // File access
+      bofs.Open(filename, BinaryFileStream::Out | BinaryFileStream::Truncate);
+      if (!bofs.IsOpen())
+        throw(BCAFileIOException("No File access"));
+      
+      // Header
+      bofs.Write(BCAKey);
+      bofs.Write(BCAVersion);
+      // Acquisition's parameters
+      bofs.Write(static_cast<int32_t>(input->GetFirstFrame()));
+      WriteBCADouble_p(&bofs, input->GetPointFrequency());
+      bofs.Write(static_cast<int32_t>(numFrames));
+      bofs.Write(static_cast<int32_t>(input->GetNumberAnalogSamplePerFrame()));
+      bofs.Write(static_cast<int32_t>(input->GetAnalogResolution()));
+      bofs.Write(static_cast<int32_t>(input->GetMaxInterpolationGap()));
+      bofs.Write(static_cast<int32_t>(chunkSize));
+      const std::vector<std::string>& units = input->GetPointUnits();
+      bofs.Write(static_cast<int32_t>(units.size()));
+      for (size_t i = 0 ; i < units.size() ; ++i)
+        WriteBCAString_p(&bofs, units[i]);
+      // Metadata
+      WriteBCAMetaData_p(&bofs, input->GetMetaData());
+      // Events
+      bofs.Write(static_cast<int32_t>(input->GetEventNumber()));
+      for (Acquisition::EventConstIterator it = input->BeginEvent() ; it != input->EndEvent() ; ++it)
+      {
+        WriteBCAString_p(&bofs, (*it)->GetLabel());
+        WriteBCAString_p(&bofs, (*it)->GetContext());
+        WriteBCAString_p(&bofs, (*it)->GetSubject());
+        WriteBCAString_p(&bofs, (*it)->GetDescription());
+        WriteBCADouble_p(&bofs, (*it)->GetTime());
+        bofs.Write(static_cast<int32_t>((*it)->GetFrame()));
+        bofs.Write(static_cast<int32_t>((*it)->GetDetectionFlags()));
+        bofs.Write(static_cast<int32_t>((*it)->GetId()));
+      }
+      // Columns
+      bofs.Write(static_cast<int32_t>(input->GetPointNumber()));
+      for (Acquisition::PointConstIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it)
+      {
+        WriteBCAString_p(&bofs, (*it)->GetLabel());
+        WriteBCAString_p(&bofs, (*it)->GetDescription());
+        bofs.Write(static_cast<int32_t>((*it)->GetType()));
+      }
+      bofs.Write(static_cast<int32_t>(input->GetAnalogNumber()));
+      for (Acquisition::AnalogConstIterator it = input->BeginAnalog() ; it != input->EndAnalog() ; ++it)
+      {
+        WriteBCAString_p(&bofs, (*it)->GetLabel());
+        WriteBCAString_p(&bofs, (*it)->GetDescription());
+        WriteBCAString_p(&bofs, (*it)->GetUnit());
+        bofs.Write(static_cast<int32_t>((*it)->GetGain()));
+        WriteBCADouble_p(&bofs, (*it)->GetOffset());
+        WriteBCADouble_p(&bofs, (*it)->GetScale());
+      }
+      // Chunks' index (offsets relative to the first chunk)
+      uint64_t offset = 0;
+      for (int j = 0 ; j < numChunks ; ++j)
+      {
+        if (offset + encoded[j].size() > 0xFFFFFFFF)
+          throw(BCAFileIOException("The size of the data exceeds the limit of the format (4 GB)."));
+        bofs.Write(static_cast<uint32_t>(offset));
+        bofs.Write(static_cast<uint32_t>(encoded[j].size()));
+        offset += encoded[j].size();
+      }
+      // Chunks
+      for (int j = 0 ; j < numChunks ; ++j)
+        bofs.Write(encoded[j]);
+    }
+    catch (BCAFileIOException& )
+    {
+      if (bofs.IsOpen()) bofs.Close();
+      throw;
+    }
+    catch (std::exception& e)
+    {
+      if (bofs.IsOpen()) bofs.Close();
+      throw(BCAFileIOException("Unexpected exception occurred: " + std::string(e.what())));
+    }
+    catch(...)
+    {
+      if (bofs.IsOpen()) bofs.Close();
+      throw(BCAFileIOException("Unknown exception"));
+    }
+  };
+  
+  /**
+   * Constructor.
+   */
+  BCAFileIO::BCAFileIO()
+  : AcquisitionFileIO(AcquisitionFileIO::Binary, AcquisitionFileIO::IEEE_LittleEndian, AcquisitionFileIO::Float),
+    m_LabelsToRead()
+  {
+    this->m_ChunkSize = BCADefaultChunkSize;
+    this->mp_FramesIndex[0] = -1;
+    this->mp_FramesIndex[1] = -1;
+    this->m_ThreadNumber = 0;
+  };
+  
+  bool BCAFileIO::IsLabelSelected(const std::string& label) const
+  {
+    if (this->m_LabelsToRead.empty())
+      return true;
+    return (std::find(this->m_LabelsToRead.begin(), this->m_LabelsToRead.end(), label) != this->m_LabelsToRead.end());
+  };
+};
@@ -0,0 +1,98 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkBCAFileIO_h
+#define __btkBCAFileIO_h
+
+#include "btkAcquisitionFileIO.h"
+#include "btkException.h"
+
+#include <list>
+
+namespace btk
+{
+  class BCAFileIOException : public Exception
+  {
+  public:
+    explicit BCAFileIOException(const std::string& msg)
+    : Exception(msg)
+    {};
+      
+    virtual ~BCAFileIOException() throw() {};
+  };
+  
+  class BCAFileIO : public AcquisitionFileIO
+  {
+    BTK_FILE_IO_SUPPORTED_EXTENSIONS(Extension("BCA", "BTK Columnar Acquisition"));
+    
+  public:
+    typedef btkSharedPtr<BCAFileIO> Pointer;
+    typedef btkSharedPtr<const BCAFileIO> ConstPointer;
+    
+    static Pointer New() {return Pointer(new BCAFileIO());};
+    
+    // ~BCAFileIO(); // Implicit.
+    
+    int GetChunkSize() const {return this->m_ChunkSize;};
+    BTK_IO_EXPORT void SetChunkSize(int size);
+    const int* GetFramesIndex() const {return this->mp_FramesIndex;};
+    BTK_IO_EXPORT void SetFramesIndex(int lb = -1, int ub = -1);
+    const std::list<std::string>& GetLabelsToRead() const {return this->m_LabelsToRead;};
+    void SetLabelsToRead(const std::list<std::string>& labels) {this->m_LabelsToRead = labels;};
+    int GetThreadNumber() const {return this->m_ThreadNumber;};
+    void SetThreadNumber(int num = 0) {this->m_ThreadNumber = num;};
+    
+    BTK_IO_EXPORT virtual bool CanReadFile(const std::string& filename);
+    BTK_IO_EXPORT virtual bool CanWriteFile(const std::string& filename);
+    BTK_IO_EXPORT virtual void Read(const std::string& filename, Acquisition::Pointer output);
+    BTK_IO_EXPORT virtual void Write(const std::string& filename, Acquisition::Pointer input);
+    
+  protected:
+    BTK_IO_EXPORT BCAFileIO();
+    
+  private:
+    bool IsLabelSelected(const std::string& label) const;
+    
+    BCAFileIO(const BCAFileIO& ); // Not implemented.
+    BCAFileIO& operator=(const BCAFileIO& ); // Not implemented.
+    
+    int m_ChunkSize;
+    int mp_FramesIndex[2];
+    std::list<std::string> m_LabelsToRead;
+    int m_ThreadNumber;
+  };
+};
+
+#endif // __btkBCAFileIO_h
@@ -0,0 +1,340 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkBCAFileIOUtils_p.h"
+#include "btkBCAFileIO.h"
+
+#include <cstring>
+
+namespace btk
+{
+  static const int BCAMinMatch = 4;
+  static const int BCAHashLog = 12;
+  static const size_t BCAMaxOffset = 65535;
+  
+  inline uint32_t ReadBCAU32_p(const uint8_t* p)
+  {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+  };
+  
+  inline void WriteBCALength_p(size_t length, std::vector<uint8_t>* dst)
+  {
+    while (length >= 255)
+    {
+      dst->push_back(255);
+      length -= 255;
+    }
+    dst->push_back(static_cast<uint8_t>(length));
+  };
+  
+  inline bool ReadBCALength_p(const uint8_t* src, size_t srcSize, size_t* ip, size_t* length)
+  {
+    uint8_t b;
+    do
+    {
+      if (*ip >= srcSize)
+        return false;
+      b = src[(*ip)++];
+      *length += b;
+    } while (b == 255);
+    return true;
+  };
+  
+  // A sequence is composed of a token (4 bits for the number of literals, 4 bits for the length of the match), 
+  // the literals, the offset of the match (16 bits) and its length. The last sequence contains only literals.
+  static void WriteBCASequence_p(const uint8_t* literals, size_t numLiterals, size_t offset, size_t matchLength, std::vector<uint8_t>* dst)
+  {
+    const size_t ml = (matchLength != 0) ? matchLength - BCAMinMatch : 0;
+    dst->push_back(static_cast<uint8_t>(((numLiterals < 15 ? numLiterals : 15) << 4) | (ml < 15 ? ml : 15)));
+    if (numLiterals >= 15)
+      WriteBCALength_p(numLiterals - 15, dst);
+    dst->insert(dst->end(), literals, literals + numLiterals);
+    if (matchLength == 0)
+      return;
+    dst->push_back(static_cast<uint8_t>(offset & 0xFF));
+    dst->push_back(static_cast<uint8_t>((offset >> 8) & 0xFF));
+    if (ml >= 15)
+      WriteBCALength_p(ml - 15, dst);
+  };
+  
+  /**
+   * Compress the @a srcSize bytes of @a src and set the result in @a dst.
+   */
+  void CompressBCABytes_p(const uint8_t* src, size_t srcSize, std::vector<uint8_t>* dst)
+  {
+    dst->clear();
+    dst->reserve(srcSize + srcSize / 255 + 16);
+    std::vector<int> table(1 << BCAHashLog, -1);
+    size_t anchor = 0, ip = 0;
+    while (ip + BCAMinMatch <= srcSize)
+    {
+      const uint32_t seq = ReadBCAU32_p(src + ip);
+      const uint32_t h = (seq * 2654435761U) >> (32 - BCAHashLog);
+      const int ref = table[h];
+      table[h] = static_cast<int>(ip);
+      if ((ref >= 0) && (ip - ref <= BCAMaxOffset) && (ReadBCAU32_p(src + ref) == seq))
+      {
+        size_t len = BCAMinMatch;
+        while ((ip + len < srcSize) && (src[ref + len] == src[ip + len]))
+          ++len;
+        WriteBCASequence_p(src + anchor, ip - anchor, ip - ref, len, dst);
+        ip += len;
+        anchor = ip;
+      }
+      else
+        ip += 1 + ((ip - anchor) >> 6); // Skip faster the incompressible data
+    }
+    WriteBCASequence_p(src + anchor, srcSize - anchor, 0, 0, dst);
+  };
+  
+  /**
+   * Decompress the @a srcSize bytes of @a src in @a dst.
+   * Returns false if the compressed data are corrupted or if they do not correspond exactly to @a dstSize bytes.
+   */
+  bool DecompressBCABytes_p(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+  {
+    size_t ip = 0, op = 0;
+    while (ip < srcSize)
+    {
+      const uint8_t token = src[ip++];
+      size_t numLiterals = token >> 4;
+      if ((numLiterals == 15) && !ReadBCALength_p(src, srcSize, &ip, &numLiterals))
+        return false;
+      if ((numLiterals > srcSize - ip) || (numLiterals > dstSize - op))
+        return false;
+      memcpy(dst + op, src + ip, numLiterals);
+      ip += numLiterals;
+      op += numLiterals;
+      if (ip == srcSize)
+        break;
+      if (ip + 2 > srcSize)
+        return false;
+      const size_t offset = static_cast<size_t>(src[ip]) | (static_cast<size_t>(src[ip+1]) << 8);
+      ip += 2;
+      size_t matchLength = token & 0x0F;
+      if ((matchLength == 15) && !ReadBCALength_p(src, srcSize, &ip, &matchLength))
+        return false;
+      matchLength += BCAMinMatch;
+      if ((offset == 0) || (offset > op) || (matchLength > dstSize - op))
+        return false;
+      // The match can overlap the current position (e.g. repetition of the same byte).
+      const uint8_t* match = dst + op - offset;
+      for (size_t i = 0 ; i < matchLength ; ++i)
+        dst[op + i] = match[i];
+      op += matchLength;
+    }
+    return (op == dstSize);
+  };
+  
+  /**
+   * Encode @a numSamples samples of the @a numComponents components of a column.
+   * Each component is delta encoded on the bit representation of its values, then the bytes are 
+   * gathered by significance (byte shuffling) before being compressed. If the compression is not 
+   * efficient, the shuffled bytes are stored as is.
+   */
+  void EncodeBCAChunk_p(const double* const* components, int numComponents, int numSamples, std::vector<uint8_t>* output)
+  {
+    const size_t n = static_cast<size_t>(numSamples);
+    std::vector<uint8_t> shuffled(static_cast<size_t>(numComponents) * 8 * n);
+    for (int k = 0 ; k < numComponents ; ++k)
+    {
+      uint8_t* planes = &(shuffled[k * 8 * n]);
+      uint64_t previous = 0;
+      for (size_t i = 0 ; i < n ; ++i)
+      {
+        uint64_t bits;
+        memcpy(&bits, components[k] + i, 8);
+        const uint64_t delta = bits - previous;
+        previous = bits;
+        for (int b = 0 ; b < 8 ; ++b)
+          planes[b * n + i] = static_cast<uint8_t>(delta >> (8 * b));
+      }
+    }
+    if (shuffled.empty())
+    {
+      output->clear();
+      return;
+    }
+    CompressBCABytes_p(&(shuffled[0]), shuffled.size(), output);
+    if (output->size() >= shuffled.size())
+      output->swap(shuffled);
+  };
+  
+  /**
+   * Decode the chunk @a input of @a numSamples samples and set the samples [first, first+count[ of each component in @a components.
+   */
+  bool DecodeBCAChunk_p(const uint8_t* input, size_t inputSize, int numComponents, int numSamples, int first, int count, double* const* components)
+  {
+    const size_t n = static_cast<size_t>(numSamples);
+    const size_t rawSize = static_cast<size_t>(numComponents) * 8 * n;
+    if ((first < 0) || (count < 0) || (first + count > numSamples))
+      return false;
+    if (rawSize == 0)
+      return (inputSize == 0);
+    std::vector<uint8_t> raw;
+    const uint8_t* shuffled = input;
+    if (inputSize != rawSize)
+    {
+      raw.resize(rawSize);
+      if (!DecompressBCABytes_p(input, inputSize, &(raw[0]), rawSize))
+        return false;
+      shuffled = &(raw[0]);
+    }
+    const size_t last = static_cast<size_t>(first + count);
+    for (int k = 0 ; k < numComponents ; ++k)
+    {
+      const uint8_t* planes = shuffled + k * 8 * n;
+      uint64_t value = 0;
+      for (size_t i = 0 ; i < last ; ++i)
+      {
+        uint64_t delta = 0;
+        for (int b = 0 ; b < 8 ; ++b)
+          delta |= static_cast<uint64_t>(planes[b * n + i]) << (8 * b);
+        value += delta;
+        if (i >= static_cast<size_t>(first))
+          memcpy(components[k] + (i - first), &value, 8);
+      }
+    }
+    return true;
+  };
+
+  void WriteBCAString_p(BinaryFileStream* bofs, const std::string& str)
+  {
+    bofs->Write(static_cast<int32_t>(str.length()));
+    bofs->Write(str);
+  };
+  
+  std::string ReadBCAString_p(BinaryFileStream* bifs)
+  {
+    const int32_t length = bifs->ReadI32();
+    if (length < 0)
+      throw(BCAFileIOException("Invalid length for a string."));
+    return bifs->ReadString(length);
+  };
+  
+  int32_t ReadBCANumber_p(BinaryFileStream* bifs)
+  {
+    const int32_t num = bifs->ReadI32();
+    if (num < 0)
+      throw(BCAFileIOException("Invalid number of elements."));
+    return num;
+  };
+  
+  void WriteBCADouble_p(BinaryFileStream* bofs, double value)
+  {
+    uint64_t bits;
+    memcpy(&bits, &value, 8);
+    bofs->Write(static_cast<uint32_t>(bits & 0xFFFFFFFF));
+    bofs->Write(static_cast<uint32_t>(bits >> 32));
+  };
+  
+  void WriteBCAMetaData_p(BinaryFileStream* bofs, MetaData::ConstPointer md)
+  {
+    WriteBCAString_p(bofs, md->GetLabel());
+    WriteBCAString_p(bofs, md->GetDescription());
+    bofs->Write(static_cast<uint8_t>(md->GetUnlockState() ? 1 : 0));
+    bofs->Write(static_cast<uint8_t>(md->HasInfo() ? 1 : 0));
+    if (md->HasInfo())
+    {
+      MetaDataInfo::ConstPointer info = md->GetInfo();
+      bofs->Write(static_cast<int8_t>(info->GetFormat()));
+      bofs->Write(static_cast<uint8_t>(info->GetDimensions().size()));
+      bofs->Write(info->GetDimensions());
+      bofs->Write(static_cast<int32_t>(info->GetValues().size()));
+      switch (info->GetFormat())
+      {
+      case MetaDataInfo::Char:
+        {
+        std::vector<std::string> values = info->ToString();
+        for (size_t i = 0 ; i < values.size() ; ++i)
+          WriteBCAString_p(bofs, values[i]);
+        break;
+        }
+      case MetaDataInfo::Byte:
+        bofs->Write(info->ToInt8());
+        break;
+      case MetaDataInfo::Integer:
+        bofs->Write(info->ToInt16());
+        break;
+      case MetaDataInfo::Real:
+        bofs->Write(info->ToFloat());
+        break;
+      }
+    }
+    bofs->Write(static_cast<int32_t>(md->GetChildNumber()));
+    for (MetaData::ConstIterator it = md->Begin() ; it != md->End() ; ++it)
+      WriteBCAMetaData_p(bofs, *it);
+  };
+  
+  MetaData::Pointer ReadBCAMetaData_p(BinaryFileStream* bifs)
+  {
+    const std::string label = ReadBCAString_p(bifs);
+    const std::string desc = ReadBCAString_p(bifs);
+    const bool unlocked = (bifs->ReadU8() != 0);
+    MetaData::Pointer md = MetaData::New(label, desc, unlocked);
+    if (bifs->ReadU8() != 0)
+    {
+      const int8_t format = bifs->ReadI8();
+      std::vector<uint8_t> dims = bifs->ReadU8(bifs->ReadU8());
+      const int32_t num = ReadBCANumber_p(bifs);
+      switch (format)
+      {
+      case MetaDataInfo::Char:
+        {
+        std::vector<std::string> values(num);
+        for (int32_t i = 0 ; i < num ; ++i)
+          values[i] = ReadBCAString_p(bifs);
+        md->SetInfo(MetaDataInfo::New(dims, values));
+        break;
+        }
+      case MetaDataInfo::Byte:
+        md->SetInfo(MetaDataInfo::New(dims, bifs->ReadI8(num)));
+        break;
+      case MetaDataInfo::Integer:
+        md->SetInfo(MetaDataInfo::New(dims, bifs->ReadI16(num)));
+        break;
+      case MetaDataInfo::Real:
+        md->SetInfo(MetaDataInfo::New(dims, bifs->ReadFloat(num)));
+        break;
+      default:
+        throw(BCAFileIOException("Unknown format for the metadata " + label + "."));
+      }
+    }
+    const int32_t numChildren = ReadBCANumber_p(bifs);
+    for (int32_t i = 0 ; i < numChildren ; ++i)
+      md->AppendChild(ReadBCAMetaData_p(bifs));
+    return md;
+  };
+};
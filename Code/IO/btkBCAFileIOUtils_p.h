@@ -0,0 +1,70 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkBCAFileIOUtils_p_h
+#define __btkBCAFileIOUtils_p_h
+
+#include "btkBinaryFileStream.h"
+#include "btkMetaData.h"
+
+#ifdef _MSC_VER
+  #include "Utilities/stdint.h"
+#else
+  #include <stdint.h>
+#endif
+
+#include <vector>
+#include <cstddef>
+
+namespace btk
+{
+  // Compression of an array of bytes (LZ77 like codec with 64 KB window).
+  void CompressBCABytes_p(const uint8_t* src, size_t srcSize, std::vector<uint8_t>* dst);
+  bool DecompressBCABytes_p(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+  
+  // Encoding of a chunk of a column (delta + byte shuffle + compression).
+  void EncodeBCAChunk_p(const double* const* components, int numComponents, int numSamples, std::vector<uint8_t>* output);
+  bool DecodeBCAChunk_p(const uint8_t* input, size_t inputSize, int numComponents, int numSamples, int first, int count, double* const* components);
+  
+  // Serialization of the header's elements (also used by the snapshots of AcquisitionFileCache).
+  void WriteBCAString_p(BinaryFileStream* bofs, const std::string& str);
+  std::string ReadBCAString_p(BinaryFileStream* bifs);
+  int32_t ReadBCANumber_p(BinaryFileStream* bifs);
+  void WriteBCADouble_p(BinaryFileStream* bofs, double value);
+  void WriteBCAMetaData_p(BinaryFileStream* bofs, MetaData::ConstPointer md);
+  MetaData::Pointer ReadBCAMetaData_p(BinaryFileStream* bifs);
+};
+
+#endif // __btkBCAFileIOUtils_p_h
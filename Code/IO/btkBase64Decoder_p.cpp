@@ -0,0 +1,189 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkBase64Decoder_p.h"
+
+// The blocks of base64 characters are decoded with SSSE3 instructions. If the library is not
+// compiled with them, the vectorized functions are compiled for SSSE3 only and selected at runtime.
+#if defined(__SSSE3__)
+  #define BTK_BASE64_SSSE3
+  #define BTK_BASE64_SSSE3_TARGET
+  #include <tmmintrin.h>
+#elif (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || (defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))))
+  #define BTK_BASE64_SSSE3
+  #define BTK_BASE64_SSSE3_DISPATCH
+  #define BTK_BASE64_SSSE3_TARGET __attribute__((target("ssse3")))
+  #include <tmmintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  #define BTK_BASE64_SSSE3
+  #define BTK_BASE64_SSSE3_DISPATCH
+  #define BTK_BASE64_SSSE3_TARGET
+  #include <intrin.h>
+#endif
+
+namespace btk
+{
+  // Values of the base64 characters (-1: invalid character, -2: padding).
+  static const signed char Base64Values_p[256] = {
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,62,-1,-1,-1,63, 52,53,54,55,56,57,58,59,60,61,-1,-1,-1,-2,-1,-1,
+    -1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9,10,11,12,13,14, 15,16,17,18,19,20,21,22,23,24,25,-1,-1,-1,-1,-1,
+    -1,26,27,28,29,30,31,32,33,34,35,36,37,38,39,40, 41,42,43,44,45,46,47,48,49,50,51,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,
+    -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1
+  };
+  
+#if defined(BTK_BASE64_SSSE3)
+  // Decode 16 base64 characters in 12 bytes (16 bytes are written).
+  // Returns false (nothing written) if one of the characters is not in the base64 alphabet.
+  // Vectorized lookup from W. Mula and D. Lemire, "Faster Base64 Encoding and Decoding Using AVX2 Instructions" (2018).
+  static inline BTK_BASE64_SSSE3_TARGET bool DecodeBase64Block_p(const char* in, char* out)
+  {
+    const __m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    const __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(input, 4), _mm_set1_epi8(0x0F));
+    const __m128i loNibbles = _mm_and_si128(input, _mm_set1_epi8(0x0F));
+    const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i lo = _mm_shuffle_epi8(lutLo, loNibbles);
+    const __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+    if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0)
+      return false;
+    const __m128i eq2F = _mm_cmpeq_epi8(input, _mm_set1_epi8(0x2F));
+    const __m128i roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(eq2F, hiNibbles));
+    const __m128i values = _mm_add_epi8(input, roll);
+    // Pack the 6-bit values
+    const __m128i mergedAB = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i merged = _mm_madd_epi16(mergedAB, _mm_set1_epi32(0x00011000));
+    const __m128i bytes = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), bytes);
+    return true;
+  };
+  
+  // Decode the successive blocks of 16 base64 characters of @a in until the end or an invalid character.
+  // Returns the number of decoded blocks.
+  static BTK_BASE64_SSSE3_TARGET size_t DecodeBase64Blocks_p(const char* in, size_t len, char* out)
+  {
+    size_t num = 0;
+    while ((len >= 16) && DecodeBase64Block_p(in, out))
+    {
+      in += 16;
+      out += 12;
+      len -= 16;
+      ++num;
+    }
+    return num;
+  };
+  
+#if defined(BTK_BASE64_SSSE3_DISPATCH)
+  static bool DetectSSSE3_p()
+  {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3") != 0;
+#endif
+  };
+  static const bool Base64SSSE3Supported_p = DetectSSSE3_p();
+#else
+  static const bool Base64SSSE3Supported_p = true;
+#endif
+#endif
+  
+  bool Base64Decoder_p::IsVectorizationSupported()
+  {
+#if defined(BTK_BASE64_SSSE3)
+    return Base64SSSE3Supported_p;
+#else
+    return false;
+#endif
+  };
+  
+  /**
+   * Decode @a len characters and write the bytes in @a out (which must contains at least MaxDecodedLength(len) bytes).
+   * The incomplete groups of 4 characters are kept for the next call. Returns the number of decoded bytes.
+   */
+  size_t Base64Decoder_p::Decode(const char* in, size_t len, char* out)
+  {
+    const char* end = in + len;
+    char* begin = out;
+    while (!this->m_Ended && (in != end))
+    {
+#if defined(BTK_BASE64_SSSE3)
+      // Fast path for aligned groups of characters without whitespace
+      if ((this->m_Count == 0) && this->m_Vectorized && Base64SSSE3Supported_p)
+      {
+        const size_t num = DecodeBase64Blocks_p(in, static_cast<size_t>(end - in), out);
+        in += 16 * num;
+        out += 12 * num;
+        if (in == end)
+          break;
+      }
+#endif
+      const signed char v = Base64Values_p[static_cast<unsigned char>(*in++)];
+      if (v == -1) // Whitespace or invalid character
+        continue;
+      if (v == -2) // Padding
+      {
+        if (this->m_Count == 2)
+          *out++ = static_cast<char>(this->m_Quantum >> 4);
+        else if (this->m_Count == 3)
+        {
+          *out++ = static_cast<char>(this->m_Quantum >> 10);
+          *out++ = static_cast<char>(this->m_Quantum >> 2);
+        }
+        this->m_Quantum = 0;
+        this->m_Count = 0;
+        this->m_Ended = true;
+        break;
+      }
+      this->m_Quantum = (this->m_Quantum << 6) | static_cast<unsigned int>(v);
+      if (++this->m_Count == 4)
+      {
+        *out++ = static_cast<char>(this->m_Quantum >> 16);
+        *out++ = static_cast<char>(this->m_Quantum >> 8);
+        *out++ = static_cast<char>(this->m_Quantum);
+        this->m_Quantum = 0;
+        this->m_Count = 0;
+      }
+    }
+    return static_cast<size_t>(out - begin);
+  };
+};
@@ -0,0 +1,66 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkBase64Decoder_p_h
+#define __btkBase64Decoder_p_h
+
+#include "btkConfigure.h"
+
+#include <cstddef>
+
+namespace btk
+{
+  // Streaming base64 decoder (whitespaces and invalid characters are skipped, the padding ends the data).
+  // Blocks of 16 characters are decoded with SSSE3 instructions when the processor supports them
+  // (the scalar decoding can be forced with the argument of the constructor).
+  class Base64Decoder_p
+  {
+  public:
+    Base64Decoder_p(bool vectorized = true) : m_Vectorized(vectorized) {this->Reset();};
+    void Reset() {this->m_Quantum = 0; this->m_Count = 0; this->m_Ended = false;};
+    // Minimum size of the output buffer given to Decode() for @a len characters.
+    static size_t MaxDecodedLength(size_t len) {return 3 * (len / 4 + 1) + 16;};
+    // Returns true if the blocks are decoded with SSSE3 instructions on this processor.
+    BTK_IO_EXPORT static bool IsVectorizationSupported();
+    BTK_IO_EXPORT size_t Decode(const char* in, size_t len, char* out);
+  private:
+    unsigned int m_Quantum;
+    int m_Count;
+    bool m_Ended;
+    bool m_Vectorized;
+  };
+};
+
+#endif // __btkBase64Decoder_p_h
@@ -75,11 +75,14 @@ namespace btk
   public:
     template<class Stream> static int16_t ReadI16(Stream* src);
     template<class Stream> static uint16_t ReadU16(Stream* src);
+    template<class Stream> static void ReadI16(Stream* src, size_t nb, int16_t* values);
+    template<class Stream> static void ReadU16(Stream* src, size_t nb, uint16_t* values);
     template<class Stream> static int32_t ReadI32(Stream* src);
     template<class Stream> static uint32_t ReadU32(Stream* src);
     template<class Stream> static int64_t ReadI64(Stream* src);
     template<class Stream> static uint64_t ReadU64(Stream* src);
     template<class Stream> static float ReadFloat(Stream* src);
+    template<class Stream> static void ReadFloat(Stream* src, size_t nb, float* values);
     template<class Stream> static double ReadDouble(Stream* src);
   
     template<class Stream> static void Write(int16_t val, Stream* dest);
@@ -89,6 +92,7 @@ namespace btk
     template<class Stream> static void Write(int64_t val, Stream* dest);
     template<class Stream> static void Write(uint64_t val, Stream* dest);
     template<class Stream> static void Write(float val, Stream* dest);
+    template<class Stream> static void Write(size_t nb, const float* values, Stream* dest);
   
   private:
     VAXLittleEndianFormat(); // Not implemented.
@@ -102,11 +106,14 @@ namespace btk
   public:
     template<class Stream> static int16_t ReadI16(Stream* src);
     template<class Stream> static uint16_t ReadU16(Stream* src);
+    template<class Stream> static void ReadI16(Stream* src, size_t nb, int16_t* values);
+    template<class Stream> static void ReadU16(Stream* src, size_t nb, uint16_t* values);
     template<class Stream> static int32_t ReadI32(Stream* src);
     template<class Stream> static uint32_t ReadU32(Stream* src);
     template<class Stream> static int64_t ReadI64(Stream* src);
     template<class Stream> static uint64_t ReadU64(Stream* src);
     template<class Stream> static float ReadFloat(Stream* src);
+    template<class Stream> static void ReadFloat(Stream* src, size_t nb, float* values);
     template<class Stream> static double ReadDouble(Stream* src);
   
     template<class Stream> static void Write(int16_t val, Stream* dest);
@@ -116,6 +123,7 @@ namespace btk
     template<class Stream> static void Write(int64_t val, Stream* dest);
     template<class Stream> static void Write(uint64_t val, Stream* dest);
     template<class Stream> static void Write(float val, Stream* dest);
+    template<class Stream> static void Write(size_t nb, const float* values, Stream* dest);
   
   private:
     IEEELittleEndianFormat(); // Not implemented.
@@ -129,11 +137,14 @@ namespace btk
   public:
     template<class Stream> static int16_t ReadI16(Stream* src);
     template<class Stream> static uint16_t ReadU16(Stream* src);
+    template<class Stream> static void ReadI16(Stream* src, size_t nb, int16_t* values);
+    template<class Stream> static void ReadU16(Stream* src, size_t nb, uint16_t* values);
     template<class Stream> static int32_t ReadI32(Stream* src);
     template<class Stream> static uint32_t ReadU32(Stream* src);
     template<class Stream> static int64_t ReadI64(Stream* src);
     template<class Stream> static uint64_t ReadU64(Stream* src);
     template<class Stream> static float ReadFloat(Stream* src);
+    template<class Stream> static void ReadFloat(Stream* src, size_t nb, float* values);
     template<class Stream> static double ReadDouble(Stream* src);
   
     template<class Stream> static void Write(int16_t val, Stream* dest);
@@ -143,6 +154,7 @@ namespace btk
     template<class Stream> static void Write(int64_t val, Stream* dest);
     template<class Stream> static void Write(uint64_t val, Stream* dest);
     template<class Stream> static void Write(float val, Stream* dest);
+    template<class Stream> static void Write(size_t nb, const float* values, Stream* dest);
     
   private:
     IEEEBigEndianFormat(); // Not implemented.
@@ -193,6 +205,36 @@ namespace btk
 #endif
   };
   
+  /** 
+   * Extracts @a nb signed 16-bit integers and set them in the array @a values.
+   * The values are copied in one block from the stream and swapped afterwards if necessary.
+   */
+  template <class Stream>
+  void VAXLittleEndianFormat::ReadI16(Stream* src, size_t nb, int16_t* values)
+  {
+    src->read(reinterpret_cast<char*>(values), nb * 2);
+#if PROCESSOR_TYPE == 3 /* IEEE_BigEndian */
+    uint16_t* words = reinterpret_cast<uint16_t*>(values);
+    for (size_t i = 0 ; i < nb ; ++i)
+      words[i] = static_cast<uint16_t>((words[i] << 8) | (words[i] >> 8));
+#endif
+  };
+  
+  /** 
+   * Extracts @a nb unsigned 16-bit integers and set them in the array @a values.
+   * The values are copied in one block from the stream and swapped afterwards if necessary.
+   */
+  template <class Stream>
+  void VAXLittleEndianFormat::ReadU16(Stream* src, size_t nb, uint16_t* values)
+  {
+    src->read(reinterpret_cast<char*>(values), nb * 2);
+#if PROCESSOR_TYPE == 3 /* IEEE_BigEndian */
+    uint16_t* words = reinterpret_cast<uint16_t*>(values);
+    for (size_t i = 0 ; i < nb ; ++i)
+      words[i] = static_cast<uint16_t>((words[i] << 8) | (words[i] >> 8));
+#endif
+  };
+  
   /** 
    * Extracts one signed 32-bit integer.
    */
@@ -288,6 +330,21 @@ namespace btk
 #endif
   };
   
+  /** 
+   * Extracts @a nb floats and set them in the array @a values.
+   * When the processor uses the same format, the values are copied in one block from the stream.
+   */
+  template <class Stream>
+  void VAXLittleEndianFormat::ReadFloat(Stream* src, size_t nb, float* values)
+  {
+#if PROCESSOR_TYPE == 2 /* VAX_LittleEndian */
+    src->read(reinterpret_cast<char*>(values), nb * 4);
+#else
+    for (size_t i = 0 ; i < nb ; ++i)
+      values[i] = VAXLittleEndianFormat::ReadFloat(src);
+#endif
+  };
+  
   /** 
    * Extracts one double.
    */
@@ -396,6 +453,21 @@ namespace btk
 #endif
   };
   
+  /**
+   * Writes the @a nb floats of the array @a values in the give stream @a dest.
+   * When the processor uses the same format, the values are written in one block.
+   */
+  template <class Stream>
+  void VAXLittleEndianFormat::Write(size_t nb, const float* values, Stream* dest)
+  {
+#if PROCESSOR_TYPE == 2 /* VAX_LittleEndian */
+    dest->write(reinterpret_cast<const char*>(values), nb * 4);
+#else
+    for (size_t i = 0 ; i < nb ; ++i)
+      VAXLittleEndianFormat::Write(values[i], dest);
+#endif
+  };
+  
   // ----------------------------------------------------------------------- //
   
   /** 
@@ -438,6 +510,36 @@ namespace btk
 #endif
   };
   
+  /** 
+   * Extracts @a nb signed 16-bit integers and set them in the array @a values.
+   * The values are copied in one block from the stream and swapped afterwards if necessary.
+   */
+  template <class Stream>
+  void IEEEBigEndianFormat::ReadI16(Stream* src, size_t nb, int16_t* values)
+  {
+    src->read(reinterpret_cast<char*>(values), nb * 2);
+#if PROCESSOR_TYPE != 3 /* IEEE_BigEndian */
+    uint16_t* words = reinterpret_cast<uint16_t*>(values);
+    for (size_t i = 0 ; i < nb ; ++i)
+      words[i] = static_cast<uint16_t>((words[i] << 8) | (words[i] >> 8));
+#endif
+  };
+  
+  /** 
+   * Extracts @a nb unsigned 16-bit integers and set them in the array @a values.
+   * The values are copied in one block from the stream and swapped afterwards if necessary.
+   */
+  template <class Stream>
+  void IEEEBigEndianFormat::ReadU16(Stream* src, size_t nb, uint16_t* values)
+  {
+    src->read(reinterpret_cast<char*>(values), nb * 2);
+#if PROCESSOR_TYPE != 3 /* IEEE_BigEndian */
+    uint16_t* words = reinterpret_cast<uint16_t*>(values);
+    for (size_t i = 0 ; i < nb ; ++i)
+      words[i] = static_cast<uint16_t>((words[i] << 8) | (words[i] >> 8));
+#endif
+  };
+  
   /** 
    * Extracts one signed 32-bit integer.
    */
@@ -533,6 +635,21 @@ namespace btk
 #endif
   };
   
+  /** 
+   * Extracts @a nb floats and set them in the array @a values.
+   * When the processor uses the same format, the values are copied in one block from the stream.
+   */
+  template <class Stream>
+  void IEEEBigEndianFormat::ReadFloat(Stream* src, size_t nb, float* values)
+  {
+#if PROCESSOR_TYPE == 3 /* IEEE_BigEndian */
+    src->read(reinterpret_cast<char*>(values), nb * 4);
+#else
+    for (size_t i = 0 ; i < nb ; ++i)
+      values[i] = IEEEBigEndianFormat::ReadFloat(src);
+#endif
+  };
+  
   /** 
    * Extracts one double.
    */
@@ -641,6 +758,21 @@ namespace btk
 #endif
   };
   
+  /**
+   * Writes the @a nb floats of the array @a values in the give stream @a dest.
+   * When the processor uses the same format, the values are written in one block.
+   */
+  template <class Stream>
+  void IEEEBigEndianFormat::Write(size_t nb, const float* values, Stream* dest)
+  {
+#if PROCESSOR_TYPE == 3 /* IEEE_BigEndian */
+    dest->write(reinterpret_cast<const char*>(values), nb * 4);
+#else
+    for (size_t i = 0 ; i < nb ; ++i)
+      IEEEBigEndianFormat::Write(values[i], dest);
+#endif
+  };
+  
   // ----------------------------------------------------------------------- //
   
   /** 
@@ -683,6 +815,36 @@ namespace btk
 #endif
   };
   
+  /** 
+   * Extracts @a nb signed 16-bit integers and set them in the array @a values.
+   * The values are copied in one block from the stream and swapped afterwards if necessary.
+   */
+  template <class Stream>
+  void IEEELittleEndianFormat::ReadI16(Stream* src, size_t nb, int16_t* values)
+  {
+    src->read(reinterpret_cast<char*>(values), nb * 2);
+#if PROCESSOR_TYPE == 3 /* IEEE_BigEndian */
+    uint16_t* words = reinterpret_cast<uint16_t*>(values);
+    for (size_t i = 0 ; i < nb ; ++i)
+      words[i] = static_cast<uint16_t>((words[i] << 8) | (words[i] >> 8));
+#endif
+  };
+  
+  /** 
+   * Extracts @a nb unsigned 16-bit integers and set them in the array @a values.
+   * The values are copied in one block from the stream and swapped afterwards if necessary.
+   */
+  template <class Stream>
+  void IEEELittleEndianFormat::ReadU16(Stream* src, size_t nb, uint16_t* values)
+  {
+    src->read(reinterpret_cast<char*>(values), nb * 2);
+#if PROCESSOR_TYPE == 3 /* IEEE_BigEndian */
+    uint16_t* words = reinterpret_cast<uint16_t*>(values);
+    for (size_t i = 0 ; i < nb ; ++i)
+      words[i] = static_cast<uint16_t>((words[i] << 8) | (words[i] >> 8));
+#endif
+  };
+  
   /** 
    * Extracts one signed 32-bit integer.
    */
@@ -778,6 +940,21 @@ namespace btk
 #endif
   };
   
+  /** 
+   * Extracts @a nb floats and set them in the array @a values.
+   * When the processor uses the same format, the values are copied in one block from the stream.
+   */
+  template <class Stream>
+  void IEEELittleEndianFormat::ReadFloat(Stream* src, size_t nb, float* values)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    src->read(reinterpret_cast<char*>(values), nb * 4);
+#else
+    for (size_t i = 0 ; i < nb ; ++i)
+      values[i] = IEEELittleEndianFormat::ReadFloat(src);
+#endif
+  };
+  
   /** 
    * Extracts one float.
    */
@@ -883,6 +1060,21 @@ namespace btk
     dest->write(foo, 4);
 #else
     dest->write(byteptr, 4);
+#endif
+  };
+  
+  /**
+   * Writes the @a nb floats of the array @a values in the give stream @a dest.
+   * When the processor uses the same format, the values are written in one block.
+   */
+  template <class Stream>
+  void IEEELittleEndianFormat::Write(size_t nb, const float* values, Stream* dest)
+  {
+#if PROCESSOR_TYPE == 1 /* IEEE_LittleEndian */
+    dest->write(reinterpret_cast<const char*>(values), nb * 4);
+#else
+    for (size_t i = 0 ; i < nb ; ++i)
+      IEEELittleEndianFormat::Write(values[i], dest);
 #endif
   };
 };
@@ -50,8 +50,9 @@ namespace btk
    * @typedef RawFileStream
    * Raw file stream used by the btk::BinaryFileStream class. Depending
    * your configuration, this raw stream will correspond to btk::mmfstream
-   * (default) or std::fstream. The class btk::mmfstream uses the memory 
-   * mapped file mechanism.
+   * (default) or btk::filestream. The class btk::mmfstream uses the memory 
+   * mapped file mechanism. Both accept the virtual filenames registered by 
+   * the class btk::MemoryFile to read/write a buffer instead of a file.
    *
    * @warning It is not adviced to used this class directly. Even if you can 
    * potentially speedup data's reading by accessing directly to the buffer,
@@ -231,16 +232,36 @@ namespace btk
     return *byteptr;
   };
   
+  /** 
+   * Extracts @a nb unsigned 8-bit integers in one block and set them in the array @a values.
+   */
+  void BinaryFileStream::ReadU8(size_t nb, uint8_t* values)
+  {
+    this->mp_Stream->read(reinterpret_cast<char*>(values), nb);
+  };
+  
   /** 
    * @fn int16_t BinaryFileStream::ReadI16() = 0
    * Extracts one signed 16-bit integer.
    */
   
+  /** 
+   * @fn void BinaryFileStream::ReadI16(size_t nb, int16_t* values) = 0
+   * Extracts @a nb signed 16-bit integers and set them in the array @a values.
+   * Inherited classes should read the values in one block when possible.
+   */
+  
   /** 
    * @fn uint16_t BinaryFileStream::ReadU16() = 0
    * Extracts one unsigned 16-bit integer.
    */
   
+  /** 
+   * @fn void BinaryFileStream::ReadU16(size_t nb, uint16_t* values) = 0
+   * Extracts @a nb unsigned 16-bit integers and set them in the array @a values.
+   * Inherited classes should read the values in one block when possible.
+   */
+  
   /** 
    * @fn int32_t BinaryFileStream::ReadI32() = 0
    * Extracts one signed 32-bit integer.
@@ -265,8 +286,14 @@ namespace btk
    * @fn float BinaryFileStream::ReadFloat() = 0
    * Extracts one float.
    */
-  
-  /** 
+
+  /**
+   * @fn void BinaryFileStream::ReadFloat(size_t nb, float* values) = 0
+   * Extracts @a nb floats and set them in the array @a values.
+   * Inherited classes should read the values in one block when possible.
+   */
+
+  /**
    * @fn float BinaryFileStream::ReadDouble() = 0
    * Extracts one double.
    */
@@ -347,6 +374,15 @@ namespace btk
     return 1;
   };
   
+  /** 
+   * Writes in one block the @a nb unsigned 8-bit integers of the array @a values and return their size.
+   */
+  size_t BinaryFileStream::Write(size_t nb, const uint8_t* values)
+  {
+    this->mp_Stream->write(reinterpret_cast<const char*>(values), nb);
+    return nb;
+  };
+  
   /** 
    * @fn size_t BinaryFileStream::Write(int16_t value) = 0
    * Extracts one signed 16-bit integer.
@@ -372,6 +408,12 @@ namespace btk
    * Write one float.
    */
   
+  /**
+   * @fn size_t BinaryFileStream::Write(size_t nb, const float* values) = 0
+   * Writes the @a nb floats of the array @a values in the stream an return their size.
+   * Inherited classes should write the values in one block when possible.
+   */
+  
   /** 
    * Writes the string @a rString in the stream an return its size.
    */
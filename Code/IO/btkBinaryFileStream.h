@@ -47,8 +47,8 @@
   namespace btk {typedef btk::mmfstream RawFileStream;};
 #else
   #define BTK_NO_MEMORY_MAPPED_FILESTREAM
-  #include <fstream>
-  namespace btk {typedef std::fstream RawFileStream;};
+  #include "btkFileStream.h"
+  namespace btk {typedef btk::filestream RawFileStream;};
 #endif
 
 #include <string>
@@ -114,12 +114,15 @@ namespace btk
     using BinaryStream::ReadI8;
     
     BTK_IO_EXPORT uint8_t ReadU8();
+    BTK_IO_EXPORT void ReadU8(size_t nb, uint8_t* values);
     using BinaryStream::ReadU8;
     
     virtual int16_t ReadI16() = 0;
+    virtual void ReadI16(size_t nb, int16_t* values) = 0;
     using BinaryStream::ReadI16;
     
     virtual uint16_t ReadU16() = 0;
+    virtual void ReadU16(size_t nb, uint16_t* values) = 0;
     using BinaryStream::ReadU16;
     
     virtual int32_t ReadI32() = 0;
@@ -135,6 +138,7 @@ namespace btk
     using BinaryStream::ReadU64;
     
     virtual float ReadFloat() = 0;
+    virtual void ReadFloat(size_t nb, float* values) = 0;
     using BinaryStream::ReadFloat;
     
     virtual double ReadDouble() = 0;
@@ -151,11 +155,13 @@ namespace btk
     
     BTK_IO_EXPORT size_t Write(int8_t value);
     BTK_IO_EXPORT size_t Write(uint8_t value);
+    BTK_IO_EXPORT size_t Write(size_t nb, const uint8_t* values);
     virtual size_t Write(int16_t value) = 0;
     virtual size_t Write(uint16_t value) = 0;
     virtual size_t Write(int32_t value) = 0;
     virtual size_t Write(uint32_t value) = 0;
     virtual size_t Write(float value) = 0;
+    virtual size_t Write(size_t nb, const float* values) = 0;
     BTK_IO_EXPORT size_t Write(const std::string& value);
     using BinaryStream::Write;
   
@@ -178,8 +184,10 @@ namespace btk
     ByteOrderBinaryFileStream(const std::string& filename, OpenMode mode) : BinaryFileStream(filename, mode) {};
     // ~ByteOrderBinaryFileStream(); // Implicit.  
     BTK_IO_EXPORT virtual int16_t ReadI16();
+    BTK_IO_EXPORT virtual void ReadI16(size_t nb, int16_t* values);
     using BinaryFileStream::ReadI16;
     BTK_IO_EXPORT virtual uint16_t ReadU16();
+    BTK_IO_EXPORT virtual void ReadU16(size_t nb, uint16_t* values);
     using BinaryFileStream::ReadU16;
     BTK_IO_EXPORT virtual int32_t ReadI32(); 
     using BinaryFileStream::ReadI32;
@@ -190,6 +198,7 @@ namespace btk
     BTK_IO_EXPORT virtual uint64_t ReadU64();
     using BinaryFileStream::ReadU64;
     BTK_IO_EXPORT virtual float ReadFloat();
+    BTK_IO_EXPORT virtual void ReadFloat(size_t nb, float* values);
     using BinaryFileStream::ReadFloat;
     BTK_IO_EXPORT virtual double ReadDouble();
     using BinaryFileStream::ReadDouble;
@@ -198,6 +207,7 @@ namespace btk
     BTK_IO_EXPORT virtual size_t Write(int32_t value);
     BTK_IO_EXPORT virtual size_t Write(uint32_t value);
     BTK_IO_EXPORT virtual size_t Write(float value);
+    BTK_IO_EXPORT virtual size_t Write(size_t nb, const float* values);
     using BinaryFileStream::Write;
   
   private:
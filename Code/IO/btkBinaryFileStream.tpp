@@ -66,6 +66,15 @@ namespace btk
     return Format::ReadI16(this->mp_Stream);
   };
   
+  /** 
+   * Extracts @a nb signed 16-bit integers and set them in the array @a values.
+   */
+  template <class Format>
+  void ByteOrderBinaryFileStream<Format>::ReadI16(size_t nb, int16_t* values)
+  {
+    Format::ReadI16(this->mp_Stream, nb, values);
+  };
+  
   /** 
    * Extracts one unsigned 16-bit integer.
    */
@@ -75,6 +84,15 @@ namespace btk
     return Format::ReadU16(this->mp_Stream);
   };
   
+  /** 
+   * Extracts @a nb unsigned 16-bit integers and set them in the array @a values.
+   */
+  template <class Format>
+  void ByteOrderBinaryFileStream<Format>::ReadU16(size_t nb, uint16_t* values)
+  {
+    Format::ReadU16(this->mp_Stream, nb, values);
+  };
+  
   /** 
    * Extracts one signed 32-bit integer.
    */
@@ -120,6 +138,15 @@ namespace btk
     return Format::ReadFloat(this->mp_Stream);
   };
   
+  /** 
+   * Extracts @a nb floats and set them in the array @a values.
+   */
+  template <class Format>
+  void ByteOrderBinaryFileStream<Format>::ReadFloat(size_t nb, float* values)
+  {
+    Format::ReadFloat(this->mp_Stream, nb, values);
+  };
+  
   /** 
    * Extracts one double.
    */
@@ -178,5 +205,15 @@ namespace btk
     Format::Write(value, this->mp_Stream);
     return 4;
   };
+  
+  /**
+   * Writes the @a nb floats of the array @a values in the stream an return their size.
+   */
+  template <class Format>
+  size_t ByteOrderBinaryFileStream<Format>::Write(size_t nb, const float* values)
+  {
+    Format::Write(nb, values, this->mp_Stream);
+    return nb * 4;
+  };
  
 };
\ No newline at end of file
@@ -34,8 +34,12 @@
  */
 
 #include "btkBinaryFileStream_mmfstream.h"
+#include "btkFileStream.h" // MemoryFile
 #include "btkMacro.h" // btkNotUsed
 
+#include <cstdlib> // malloc, realloc, free
+#include <cstring> // memcpy
+
 #if defined(HAVE_SYS_MMAP)
   #if defined(HAVE_64_BIT)
     #ifndef _LARGEFILE_SOURCE
@@ -77,6 +81,7 @@ namespace btk
   /**
    * Open the file with the given filename @a s and the options @a mode.
    * From the given options, the option binary is everytime append as this buffer is only for binary file.
+   * If @a s is a virtual filename registered by the class MemoryFile, the registered buffer is used instead of a file.
    */
   mmfilebuf* mmfilebuf::open(const char* s, std::ios_base::openmode mode)
   {
@@ -87,6 +92,14 @@ namespace btk
       this->m_Writing = true;
     else
       this->m_Writing = false;
+    // Virtual file?
+    const char* data = 0;
+    size_t size = 0;
+    std::vector<char>* output = 0;
+    if (MemoryFile::Find(s, &data, &size, &output))
+      return this->openmemory(data, size, output, mode);
+    else if (MemoryFile::IsMemoryFile(s))
+      return 0;
     // Open the file and map it into the memory
     // The flags' extraction is inspired by the file fstream.cxx from the Comeau Computing library
 #if defined(HAVE_SYS_MMAP) // POSIX
@@ -198,6 +211,22 @@ namespace btk
   {
     if (!this->is_open())
       return 0;
+    
+    // Virtual file: the content wrote is given to the registered output.
+    if (this->m_Memory)
+    {
+      if (this->m_Writing)
+      {
+        this->mp_Output->assign(this->mp_Buffer, this->mp_Buffer + this->m_LogicalSize);
+        free(this->mp_Buffer);
+      }
+      this->m_Memory = false;
+      this->mp_Output = 0;
+      this->mp_Buffer = 0;
+      this->m_BufferSize = 0;
+      this->m_LogicalSize = 0;
+      return this;
+    }
 
 #if defined(HAVE_SYS_MMAP)
     bool err = !(::munmap(this->mp_Buffer, this->m_BufferSize) == 0);
@@ -342,6 +371,48 @@ namespace btk
     return n;
   };
   
+  /**
+   * Use the memory as the content of the file. In read mode, the buffer @a data (or the content of @a output if not null)
+   * is read directly. In write mode, a growing buffer is used and its content is copied into @a output by the method close().
+   * @return Returns 0 if an error occured.
+   */
+  mmfilebuf* mmfilebuf::openmemory(const char* data, size_t size, std::vector<char>* output, std::ios_base::openmode mode)
+  {
+    if (output != 0)
+    {
+      data = output->empty() ? 0 : &(*output)[0];
+      size = output->size();
+    }
+    if (this->m_Writing)
+    {
+      if (output == 0)
+        return 0;
+      // The previous content is kept only if the file is opened in read/write mode without truncation.
+      if ((mode & std::ios_base::trunc) || !(mode & (std::ios_base::in | std::ios_base::app)))
+        size = 0;
+      this->m_LogicalSize = size;
+      this->m_BufferSize = size + mmfilebuf::granularity();
+      if ((this->mp_Buffer = static_cast<char*>(malloc(this->m_BufferSize))) == 0)
+        return 0;
+      if (size != 0)
+        memcpy(this->mp_Buffer, data, size);
+      this->mp_Output = output;
+    }
+    else
+    {
+      this->mp_Buffer = const_cast<char*>(data);
+      this->m_BufferSize = this->m_LogicalSize = size;
+    }
+    this->m_Memory = true;
+    this->m_Position = 0;
+    if ((mode & (std::ios_base::ate | std::ios_base::app)) && (this->seekoff(0, std::ios_base::end, mode) == std::streampos(std::streamoff(-1))))
+    {
+      this->close();
+      return 0;
+    }
+    return this;
+  };
+  
   /**
    * Try to map the file into the memory.
    * @return Returns 0 if an error occured.
@@ -377,6 +448,17 @@ namespace btk
   {
     if (!this->is_open() || !this->m_Writing)
       return 0;
+    // Virtual file: geometric growth of the buffer.
+    if (this->m_Memory)
+    {
+      std::streamsize newBufferSize = 2 * this->m_BufferSize;
+      char* buffer = static_cast<char*>(realloc(this->mp_Buffer, newBufferSize));
+      if (buffer == 0)
+        return 0;
+      this->mp_Buffer = buffer;
+      this->m_BufferSize = newBufferSize;
+      return this;
+    }
     std::streamsize newBufferSize = this->m_BufferSize + this->granularity();
 #if defined(_MSC_VER)
     if ((::UnmapViewOfFile(this->mp_Buffer) == 0) || (::CloseHandle(this->m_Map) == 0))
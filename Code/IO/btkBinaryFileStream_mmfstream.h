@@ -50,6 +50,7 @@
 #endif
 
 #include <ios>
+#include <vector>
 
 namespace btk
 {
@@ -60,7 +61,7 @@ namespace btk
     ~mmfilebuf() {this->close();};
     
     BTK_IO_EXPORT mmfilebuf* open(const char* s, std::ios_base::openmode mode);
-    bool is_open() const {return !(this->m_File == BTK_MMFILEBUF_NO_FILE);};
+    bool is_open() const {return this->m_Memory || !(this->m_File == BTK_MMFILEBUF_NO_FILE);};
     BTK_IO_EXPORT mmfilebuf* close();
 
     bool writemode() const {return this->m_Writing;};
@@ -77,6 +78,7 @@ namespace btk
     BTK_IO_EXPORT std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which = std::ios_base::in | std::ios_base::out);
     BTK_IO_EXPORT std::streampos seekpos(std::streampos pos, std::ios_base::openmode which = std::ios_base::in | std::ios_base::out );
     
+    BTK_IO_EXPORT mmfilebuf* openmemory(const char* data, size_t size, std::vector<char>* output, std::ios_base::openmode mode);
     BTK_IO_EXPORT mmfilebuf* mapfile();
     BTK_IO_EXPORT mmfilebuf* resizemap();
     
@@ -94,6 +96,8 @@ namespace btk
 #endif
     std::streamoff m_Position;
     bool m_Writing;
+    bool m_Memory;
+    std::vector<char>* mp_Output;
   };
   
   class mmfstream
@@ -157,6 +161,8 @@ namespace btk
 #endif
     this->m_Position = -1;
     this->m_Writing = false;
+    this->m_Memory = false;
+    this->mp_Output = 0;
   };
   
   // ------------------------------------------------------------ //
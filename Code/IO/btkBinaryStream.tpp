@@ -216,7 +216,7 @@ namespace btk
   {
     if (values.empty())
       return;
-    this->ReadU8(values.size(), &(values[0]));
+    static_cast<Derived*>(this)->ReadU8(values.size(), &(values[0]));
   };
   
   /**
@@ -257,7 +257,7 @@ namespace btk
   {
     if (values.empty())
       return;
-    this->ReadI16(values.size(), &(values[0]));
+    static_cast<Derived*>(this)->ReadI16(values.size(), &(values[0]));
   };
   
   /**
@@ -298,7 +298,7 @@ namespace btk
   {
     if (values.empty())
       return;
-    this->ReadU16(values.size(), &(values[0]));
+    static_cast<Derived*>(this)->ReadU16(values.size(), &(values[0]));
   };
   
   /**
@@ -504,7 +504,7 @@ namespace btk
   {
     if (values.empty())
       return;
-    this->ReadFloat(values.size(), &(values[0]));
+    static_cast<Derived*>(this)->ReadFloat(values.size(), &(values[0]));
   };
   
   /**
@@ -617,10 +617,9 @@ namespace btk
   template <class Derived>
   size_t BinaryStream<Derived>::Write(const std::vector<uint8_t>& values)
   {
-    size_t inc = 0;
-    while (inc < values.size())
-      static_cast<Derived*>(this)->Write(values[inc++]);
-    return values.size() * 1;
+    if (values.empty())
+      return 0;
+    return static_cast<Derived*>(this)->Write(values.size(), &(values[0]));
   };
   
   /** 
@@ -677,10 +676,9 @@ namespace btk
   template <class Derived>
   size_t BinaryStream<Derived>::Write(const std::vector<float>& values)
   {
-    size_t inc = 0;
-    while (inc < values.size())
-      static_cast<Derived*>(this)->Write(values[inc++]);
-    return values.size() * 4;
+    if (values.empty())
+      return 0;
+    return static_cast<Derived*>(this)->Write(values.size(), &(values[0]));
   };
   
   /** 
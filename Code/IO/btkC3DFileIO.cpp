@@ -43,6 +43,10 @@
 #include <iostream>
 #include <cmath>
 
+#if defined(_OPENMP)
+  #include <omp.h>
+#endif
+
 namespace btk
 {
   /**
@@ -81,6 +85,9 @@ namespace btk
    *
    * To write a C3D file with a given processor architecture (called byte order in BTK), you have to use the method C3DFileIO::SetByteOrder().
    *
+   * As each frame of the data section has the same size, large files can be decoded by several threads, each one working 
+   * on a range of frames with its own stream (see SetThreadNumber()). This requires BTK to be compiled with OpenMP (option BTK_USE_OPENMP).
+   *
    * For more informations on this file's format: http:://www.c3d.org
    *
    * @ingroup BTKIO
@@ -179,6 +186,18 @@ namespace btk
    * @fn void C3DFileIO::SetAnalogUniversalScale(double s)
    * Sets Returns the universal scale factor used to scale analog channels.
    */
+  
+  /**
+   * @fn int C3DFileIO::GetThreadNumber() const
+   * Returns the number of threads used to decode the data section (1 by default).
+   */
+  
+  /**
+   * @fn void C3DFileIO::SetThreadNumber(int num)
+   * Sets the number of threads used to decode the data section. A value lower or equal to 0 uses the default number of threads of OpenMP.
+   * The data section is split in ranges of at least 1024 frames, so small files are always decoded by one thread. 
+   * Truncated files are also decoded by one thread. This option has no effect if BTK is compiled without OpenMP.
+   */
 
   /**
    * Checks if the first byte of the file corresponds to C3D header.
@@ -209,10 +228,12 @@ namespace btk
   
   /**
    * Read the file designated by @a filename and fill @a output.
+   * In the mode AcquisitionFileIO::HeaderOnly, only the header and the parameter section are parsed.
    */
   void C3DFileIO::Read(const std::string& filename, Acquisition::Pointer output)
   {
     output->Reset();
+    this->m_HeaderFrameNumber = -1;
     // Open the stream
     BinaryFileStream* ibfs = new NativeBinaryFileStream();
     Format* fdf = 0; // C3D file data format
@@ -752,52 +773,87 @@ namespace btk
           }
         }
         this->m_PointScale = fabs(pointScaleFactor);
-        if (pointScaleFactor > 0) // integer
+        this->m_StorageFormat = (pointScaleFactor > 0) ? Integer : Float;
+        fdf = this->NewFormat(ibfs);
+        int frameNumber = lastFrame - output->GetFirstFrame() + 1;
+        this->m_HeaderFrameNumber = frameNumber;
+        // Header only: the points and analog channels are created without frame and the data section is not read.
+        if (this->m_ReadingMode == HeaderOnly)
+          frameNumber = 0;
+        output->Init(pointNumber, frameNumber, analogNumber, numberSamplesPerAnalogChannel);
+        output->SetPointFrequency(pointFrameRate);
+        // The samples are decoded directly in the storage of the measures.
+        std::vector<double*> points, residuals, analogs;
+        for (Acquisition::PointIterator it = output->BeginPoint() ; (frameNumber != 0) && (it != output->EndPoint()) ; ++it)
         {
-          this->m_StorageFormat = Integer; 
-          if (this->m_AnalogIntegerFormat == Unsigned)
-            fdf = new IntegerFormatUnsignedAnalog(ibfs);
-          else
-            fdf = new IntegerFormatSignedAnalog(ibfs);
+          points.push_back((*it)->GetValues().data());
+          residuals.push_back((*it)->GetResiduals().data());
         }
-        else // float
+        for (Acquisition::AnalogIterator it = output->BeginAnalog() ; (frameNumber != 0) && (it != output->EndAnalog()) ; ++it)
+          analogs.push_back((*it)->GetValues().data());
+#if defined(_OPENMP)
+        // Number of frame ranges decoded concurrently
+        int rangeNumber = (this->m_ThreadNumber > 0) ? this->m_ThreadNumber : omp_get_max_threads();
+        rangeNumber = std::min(rangeNumber, frameNumber / 1024);
+        const BinaryFileStream::StreamOffset dataStart = 512 * (dataFirstBlock - 1);
+        const size_t frameSize = (4 * pointNumber + totalAnalogSamplesPer3dFrame) * ((this->m_StorageFormat == Integer) ? 2 : 4);
+        if (rangeNumber > 1)
         {
-          this->m_StorageFormat = Float;
-          fdf = new FloatFormat(ibfs);
+          // A truncated file is decoded sequentially to extract the available frames.
+          ibfs->SeekRead(0, BinaryFileStream::End);
+          if (static_cast<size_t>(ibfs->TellRead()) < static_cast<size_t>(dataStart) + frameSize * frameNumber)
+            rangeNumber = 1;
+          ibfs->SeekRead(dataStart, BinaryFileStream::Begin);
         }
-        int frameNumber = lastFrame - output->GetFirstFrame() + 1;
-        output->Init(pointNumber, frameNumber, analogNumber, numberSamplesPerAnalogChannel);
-        output->SetPointFrequency(pointFrameRate);
-        try
+        if (rangeNumber > 1)
         {
-          for (int frame = 0 ; frame < frameNumber ; ++frame)
+          // Each range is decoded with its own stream opened on the same file.
+          std::vector<int> status(rangeNumber, 0);
+#pragma omp parallel for schedule(static) num_threads(rangeNumber)
+          for (int i = 0 ; i < rangeNumber ; ++i)
           {
-            Acquisition::PointIterator itM = output->BeginPoint(); 
-            while (itM != output->EndPoint())
+            const int first = static_cast<int>(static_cast<int64_t>(frameNumber) * i / rangeNumber);
+            const int last = static_cast<int>(static_cast<int64_t>(frameNumber) * (i + 1) / rangeNumber);
+            BinaryFileStream* rbfs = 0;
+            switch (this->GetByteOrder())
             {
-              Point* point = itM->get();
-              fdf->ReadPoint(&(point->GetValues().data()[frame]),
-                             &(point->GetValues().data()[frame + frameNumber]),
-                             &(point->GetValues().data()[frame + 2*frameNumber]),
-                             &(point->GetResiduals().data()[frame]),
-                             this->m_PointScale);
-              ++itM;
+              case VAX_LittleEndian :
+                rbfs = new VAXLittleEndianBinaryFileStream();
+                break;
+              case IEEE_BigEndian :
+                rbfs = new IEEEBigEndianBinaryFileStream();
+                break;
+              default :
+                rbfs = new IEEELittleEndianBinaryFileStream();
+                break;
             }
-            unsigned inc = 0, incChannel = 0, analogFrame = numberSamplesPerAnalogChannel * frame;
-            Acquisition::AnalogIterator itA = output->BeginAnalog();
-            while (itA != output->EndAnalog())
+            Format* rfdf = this->NewFormat(rbfs);
+            try
             {
-              (*itA)->GetValues().data()[analogFrame] = (fdf->ReadAnalog() - this->m_AnalogZeroOffset[incChannel]) * this->m_AnalogChannelScale[incChannel] * this->m_AnalogUniversalScale;
-              ++itA; ++incChannel;
-              if ((itA == output->EndAnalog()) && (inc < static_cast<unsigned>(numberSamplesPerAnalogChannel - 1)))
-              {
-                itA = output->BeginAnalog();
-                incChannel = 0;
-                ++inc; ++analogFrame;
-              }
+              rbfs->SetExceptions(BinaryFileStream::EndFileBit | BinaryFileStream::FailBit | BinaryFileStream::BadBit);
+              rbfs->Open(filename, BinaryFileStream::In);
+              rbfs->SeekRead(dataStart + static_cast<BinaryFileStream::StreamOffset>(frameSize) * first, BinaryFileStream::Begin);
+              this->ReadFrames(rfdf, points, residuals, analogs, first, last, frameNumber, numberSamplesPerAnalogChannel);
             }
+            catch (...)
+            {
+              status[i] = 1;
+            }
+            delete rfdf;
+            delete rbfs;
+          }
+          for (int i = 0 ; i < rangeNumber ; ++i)
+          {
+            if (status[i] != 0)
+              throw(C3DFileIOException("Error during the decoding of the frames in parallel."));
           }
         }
+        else
+#endif
+        try
+        {
+          this->ReadFrames(fdf, points, residuals, analogs, 0, frameNumber, frameNumber, numberSamplesPerAnalogChannel);
+        }
         catch (BinaryFileStreamFailure& )
         {
           // Let's try to continue even if the file is corrupted
@@ -960,7 +1016,8 @@ namespace btk
       }
       else if (lastFrame != 0)
       {
-        output->Init(0, lastFrame - output->GetFirstFrame() + 1);
+        this->m_HeaderFrameNumber = lastFrame - output->GetFirstFrame() + 1;
+        output->Init(0, (this->m_ReadingMode == HeaderOnly) ? 0 : this->m_HeaderFrameNumber);
         output->SetPointFrequency(pointFrameRate);
       }  
     }
@@ -1262,7 +1319,7 @@ namespace btk
           Acquisition::PointConstIterator itM = input->BeginPoint();
           while (itM != input->EndPoint())
           {
-            Point* point = itM->get();
+            const Point* point = itM->get(); // Read-only access to not copy the values shared with other objects
             fdf->WritePoint(point->GetValues().data()[frame],
                             point->GetValues().data()[frame + frameNumber],
                             point->GetValues().data()[frame + 2*frameNumber],
@@ -1275,8 +1332,9 @@ namespace btk
           Acquisition::AnalogConstIterator itA = input->BeginAnalog();
           while (itA != input->EndAnalog())
           {
+            const Analog* analog = itA->get();
             fdf->WriteAnalog(
-                (*itA)->GetValues().data()[analogFrame]
+                analog->GetValues().data()[analogFrame]
                 / this->m_AnalogChannelScale[incChannel]
                 / this->m_AnalogUniversalScale
                 + this->m_AnalogZeroOffset[incChannel]);
@@ -1330,6 +1388,43 @@ namespace btk
     this->m_PointScale = 0.1;
     this->m_AnalogUniversalScale = 1.0;
     this->m_AnalogIntegerFormat = Signed;
+    this->m_ThreadNumber = 1;
+  };
+  
+  /*
+   * Creates the object decoding/encoding the samples from/to the stream @a bfs 
+   * with the current storage format and analog integer format.
+   */
+  C3DFileIO::Format* C3DFileIO::NewFormat(BinaryFileStream* bfs) const
+  {
+    if (this->m_StorageFormat == Integer)
+    {
+      if (this->m_AnalogIntegerFormat == Unsigned)
+        return new IntegerFormatUnsignedAnalog(bfs);
+      else
+        return new IntegerFormatSignedAnalog(bfs);
+    }
+    return new FloatFormat(bfs);
+  };
+  
+  /*
+   * Decodes the frames [@a first, @a last[ from the current position of the stream used by @a fdf.
+   * The samples are stored in the (column-major) values of the points and analog channels.
+   */
+  void C3DFileIO::ReadFrames(Format* fdf, const std::vector<double*>& points, const std::vector<double*>& residuals, const std::vector<double*>& analogs, int first, int last, int frameNumber, int numberSamplesPerAnalogChannel) const
+  {
+    const size_t analogNumber = analogs.size();
+    for (int frame = first ; frame < last ; ++frame)
+    {
+      for (size_t i = 0 ; i < points.size() ; ++i)
+        fdf->ReadPoint(points[i] + frame, points[i] + frame + frameNumber, points[i] + frame + 2 * frameNumber, residuals[i] + frame, this->m_PointScale);
+      const int analogFrame = numberSamplesPerAnalogChannel * frame;
+      for (int inc = 0 ; inc < numberSamplesPerAnalogChannel ; ++inc)
+      {
+        for (size_t i = 0 ; i < analogNumber ; ++i)
+          analogs[i][analogFrame + inc] = (fdf->ReadAnalog() - this->m_AnalogZeroOffset[i]) * this->m_AnalogChannelScale[i] * this->m_AnalogUniversalScale;
+      }
+    }
   };
 
   /*
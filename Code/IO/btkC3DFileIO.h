@@ -79,6 +79,8 @@ namespace btk
     void SetAnalogZeroOffset(const std::vector<double>& s) {this->m_AnalogZeroOffset = s;};
     double GetAnalogUniversalScale() const {return this->m_AnalogUniversalScale;};
     void SetAnalogUniversalScale(double s) {this->m_AnalogUniversalScale = s;};
+    int GetThreadNumber() const {return this->m_ThreadNumber;};
+    void SetThreadNumber(int num) {this->m_ThreadNumber = num;};
     
     BTK_IO_EXPORT virtual bool CanReadFile(const std::string& filename);
     BTK_IO_EXPORT virtual bool CanWriteFile(const std::string& filename);
@@ -99,6 +101,10 @@ namespace btk
     C3DFileIO(const C3DFileIO& ); // Not implemented.
     C3DFileIO& operator=(const C3DFileIO& ); // Not implemented.
     
+    class Format;
+    Format* NewFormat(BinaryFileStream* bfs) const;
+    void ReadFrames(Format* fdf, const std::vector<double*>& points, const std::vector<double*>& residuals, const std::vector<double*>& analogs, int first, int last, int frameNumber, int numberSamplesPerAnalogChannel) const;
+    
     // Interface
     class Format
     {
@@ -218,6 +224,7 @@ namespace btk
     std::vector<double> m_AnalogZeroOffset;
     double m_AnalogUniversalScale;
     AnalogIntegerFormat m_AnalogIntegerFormat;
+    int m_ThreadNumber;
   };
 };
 
@@ -102,7 +102,7 @@ namespace btk
    */
   bool CALForcePlateFileIO::CanReadFile(const std::string& filename)
   {
-    std::ifstream ifs(filename.c_str(), std::ios_base::in);
+    ifilestream ifs(filename.c_str(), std::ios_base::in);
     int index = 0;
     bool ok = true;
     if (!(ifs >> index))
@@ -135,7 +135,7 @@ namespace btk
   {
     output->Reset();
     // Open the stream
-    std::ifstream ifs;
+    ifilestream ifs;
     //ifs.exceptions(std::ios_base::eofbit | std::ios_base::failbit | std::ios_base::badbit);
     try
     {
@@ -378,7 +378,7 @@ namespace btk
       btkErrorMacro("Impossible to write a null input into a file.");
       return;
     }
-    std::ofstream ofs(filename.c_str());
+    ofilestream ofs(filename.c_str());
     if (!ofs) 
       throw(CALForcePlateFileIOException("Invalid file path."));
       
@@ -553,7 +553,7 @@ namespace btk
   : AcquisitionFileIO(AcquisitionFileIO::ASCII)
   {};
 
-  bool CALForcePlateFileIO::ExtractValues(double* values, int num, std::ifstream* ifs)
+  bool CALForcePlateFileIO::ExtractValues(double* values, int num, ifilestream* ifs)
   {
     std::string line;
     std::getline(*ifs, line);
@@ -38,8 +38,8 @@
 
 #include "btkAcquisitionFileIO.h"
 #include "btkException.h"
+#include "btkFileStream.h"
 
-#include <fstream>
 
 namespace btk
 {
@@ -74,7 +74,7 @@ namespace btk
     BTK_IO_EXPORT CALForcePlateFileIO();
     
   private:
-    bool ExtractValues(double* values, int num, std::ifstream* ifs);
+    bool ExtractValues(double* values, int num, ifilestream* ifs);
     void ExtractCalibrationMatrix(Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>* cal, MetaDataInfo::Pointer data, int i);
     
     CALForcePlateFileIO(const CALForcePlateFileIO& ); // Not implemented.
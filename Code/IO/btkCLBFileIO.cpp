@@ -35,6 +35,7 @@
 
 #include "btkCLBFileIO.h"
 #include "btkBinaryFileStream.h"
+#include "btkDeinterleave_p.h"
 #include "btkMetaDataUtils.h"
 #include "btkLogger.h"
 
@@ -187,8 +188,7 @@ namespace btk
         double minimumScaleValue = bifs.ReadFloat();
         double rangeValue = maximumScaleValue - minimumScaleValue;
         bifs.SeekRead(4, BinaryFileStream::Current); //  What is this block of bytes? Option?
-        for (int i = 0 ; i < frameNumber ; ++i)
-          (*it)->GetValues().coeffRef(i) = static_cast<double>(bifs.ReadU16()) * rangeValue / res + minimumScaleValue;
+        ReadAnalogChannel_p<uint16_t>(&bifs, (*it)->GetValues().data(), frameNumber, rangeValue / res, minimumScaleValue);
         switch(range)
         {
         case 0: // -10V -- 10V
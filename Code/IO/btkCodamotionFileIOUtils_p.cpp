@@ -38,38 +38,89 @@
 
 namespace btk
 {
-  void FillAcquisitionFromOpen3DMotion_p(Acquisition::Pointer output, const std::string& filename, std::ifstream& ifs,
-                                          Open3DMotion::MotionFileHandler& handler, const Open3DMotion::MotionFileFormatList& formatlist)
+  // Decoder reading the samples from the time sequences built by Open3DMotion.
+  class Open3DMotionDecoder_p : public CodamotionDecoder_p
   {
-    std::auto_ptr<Open3DMotion::TreeValue> trialcontents(handler.Read(ifs, formatlist));
-    // Build trial
-    std::auto_ptr<Open3DMotion::Trial> trial(new Open3DMotion::Trial);
-    trial->FromTree(trialcontents.get());
-    // Retrieve sequences (analog & marker)
-    std::vector<const Open3DMotion::TimeSequence*> o3dm_markers;
-    std::vector<const Open3DMotion::TimeSequence*> o3dm_analogs;
-    trial->Acq.GetTSGroup(o3dm_markers, Open3DMotion::TrialSectionAcq::TSGroupMarker);
-    trial->Acq.GetTSGroup(o3dm_analogs, Open3DMotion::TrialSectionAcq::TSGroupAnalog);
+  public:
+    Open3DMotionDecoder_p(const std::vector<const Open3DMotion::TimeSequence*>& markers, const std::vector<const Open3DMotion::TimeSequence*>& analogs)
+    : m_Markers(markers), m_Analogs(analogs)
+    {};
+    
+    virtual void DecodeMarker(size_t idx, Point::Values& values, Point::Residuals& residuals)
+    {
+      // Get sequence & iterator (may throw exception if missing fields)
+      Open3DMotion::TSOccVector3ConstIter iter_ts(*(this->m_Markers[idx]));
+      for (size_t j = 0 ; j < this->m_Markers[idx]->NumFrames() ; ++j, iter_ts.Next())
+      {
+        values.coeffRef(j,0) = iter_ts.Value()[0];
+        values.coeffRef(j,1) = iter_ts.Value()[1];
+        values.coeffRef(j,2) = iter_ts.Value()[2];
+        residuals.coeffRef(j) = iter_ts.Occluded() ? -1.0 : 0.0;
+      }
+    };
+    
+    virtual void DecodeAnalog(size_t idx, double* samples, size_t num)
+    {
+      // Get sequence & iterator (may throw exception if missing fields)
+      Open3DMotion::TSScalarConstIter iter_ts(*(this->m_Analogs[idx]));
+      for (size_t j = 0 ; j < num ; ++j, iter_ts.Next())
+        samples[j] = iter_ts.Value();
+    };
     
+  private:
+    const std::vector<const Open3DMotion::TimeSequence*>& m_Markers;
+    const std::vector<const Open3DMotion::TimeSequence*>& m_Analogs;
+  };
+  
+  /**
+   * Extract the description of the time sequences read by Open3DMotion.
+   */
+  void ConvertOpen3DMotionSequences_p(std::vector<CodamotionChannel_p>* channels, const std::vector<const Open3DMotion::TimeSequence*>& sequences)
+  {
+    channels->resize(sequences.size());
+    for (size_t i = 0 ; i < sequences.size() ; ++i)
+    {
+      const Open3DMotion::TimeSequence* ts = sequences[i];
+      CodamotionChannel_p& channel = (*channels)[i];
+      channel.Label = ts->Channel.Value();
+      channel.Unit = ts->Units.Value();
+      channel.Rate = ts->Rate;
+      channel.Start = ts->Start;
+      channel.Frames = ts->NumFrames();
+      channel.HardwareID = ts->HardwareID.IsSet() ? ts->HardwareID.Value() : -1;
+      channel.Offset = ts->Offset.Value();
+      channel.Scale = ts->Scale.Value();
+    }
+  };
+  
+  /**
+   * Fill the acquisition @a output from the description of the markers, analog channels and force platforms 
+   * stored in a Codamotion file. The points and analog channels are allocated once with their final size and
+   * their samples are written directly in their storage by the @a decoder.
+   */
+  void FillAcquisitionFromCodamotion_p(Acquisition::Pointer output, const std::string& filename,
+                                       const std::vector<CodamotionChannel_p>& o3dm_markers, const std::vector<CodamotionChannel_p>& o3dm_analogs,
+                                       const std::vector<const Open3DMotion::ForcePlate*>& o3dm_forcePlates, CodamotionDecoder_p* decoder)
+  {
     // As Open3DMotion gives the possibility for each marker to have its own sample rate,
     // but not within BTK, it is needed to check that all markers were recorded at the same
     // frequency. The number of frames can be different too. In this second case, the maximum
     // number of frames is taken and the extra frame for some markers will be set as invalid
     // NOTE: From the code of Open3DMotion, it seems that unit for markers is the millimeter.
-    size_t numPointFrames = (o3dm_markers.size() == 0) ? 0 : o3dm_markers[0]->NumFrames();
-    double pointFrequency = (o3dm_markers.size() == 0) ? 0.0 : o3dm_markers[0]->Rate;
-    int firstFrame = (o3dm_markers.size() == 0) ? 1 : (static_cast<int>(o3dm_markers[0]->Start * o3dm_markers[0]->Rate) + 1);
-    double pointStart = (o3dm_markers.size() == 0) ? 0.0 : o3dm_markers[0]->Start;
+    size_t numPointFrames = (o3dm_markers.size() == 0) ? 0 : o3dm_markers[0].Frames;
+    double pointFrequency = (o3dm_markers.size() == 0) ? 0.0 : o3dm_markers[0].Rate;
+    int firstFrame = (o3dm_markers.size() == 0) ? 1 : (static_cast<int>(o3dm_markers[0].Start * o3dm_markers[0].Rate) + 1);
+    double pointStart = (o3dm_markers.size() == 0) ? 0.0 : o3dm_markers[0].Start;
     bool mixedNumFrames = false;
     for (size_t i = 0 ; i < o3dm_markers.size() ; ++i)
     {
-      if (fabs(o3dm_markers[i]->Rate - pointFrequency) > 1e-6)
+      if (fabs(o3dm_markers[i].Rate - pointFrequency) > 1e-6)
         throw(CodamotionFileIOException("The sample rate of at least one marker is not the same than the other markers."));
-      if ((static_cast<int>(o3dm_markers[i]->Start * o3dm_markers[i]->Rate) + 1) != firstFrame)
+      if ((static_cast<int>(o3dm_markers[i].Start * o3dm_markers[i].Rate) + 1) != firstFrame)
         throw(CodamotionFileIOException("The first frame of at least one marker is not the same than the other markers."));
-      if (numPointFrames != o3dm_markers[i]->NumFrames())
+      if (numPointFrames != o3dm_markers[i].Frames)
       {
-        numPointFrames = numPointFrames > o3dm_markers[i]->NumFrames() ? numPointFrames : o3dm_markers[i]->NumFrames();
+        numPointFrames = numPointFrames > o3dm_markers[i].Frames ? numPointFrames : o3dm_markers[i].Frames;
         mixedNumFrames = true;
       }
     }
@@ -80,12 +131,12 @@ namespace btk
     // In case there is no marker the number of frames is set to 0. We need to check the number of frames of the analog channels.
     if (numPointFrames == 0)
     {
-      numPointFrames = (o3dm_analogs.size() == 0) ? 0 : o3dm_analogs[0]->NumFrames();
+      numPointFrames = (o3dm_analogs.size() == 0) ? 0 : o3dm_analogs[0].Frames;
       for (size_t i = 0 ; i < o3dm_analogs.size() ; ++i)
       {
-        if (numPointFrames != o3dm_analogs[i]->NumFrames())
+        if (numPointFrames != o3dm_analogs[i].Frames)
         {
-          numPointFrames = numPointFrames > o3dm_analogs[i]->NumFrames() ? numPointFrames : o3dm_analogs[i]->NumFrames();
+          numPointFrames = numPointFrames > o3dm_analogs[i].Frames ? numPointFrames : o3dm_analogs[i].Frames;
           mixedNumFrames = true;
         }
       }
@@ -97,7 +148,7 @@ namespace btk
     // For analog channels, this is the same. The number of frames must be a multiple of the
     // number of video frames (i.e. the analogs' frequency must be a multiple of the markers' frequency)
     // If it is not the case, then the data are interpolated.
-    double analogStart = (o3dm_analogs.size() == 0) ? pointStart : o3dm_analogs[0]->Start;
+    double analogStart = (o3dm_analogs.size() == 0) ? pointStart : o3dm_analogs[0].Start;
     if (fabs(pointStart - analogStart) > 1e-6)
       throw(CodamotionFileIOException("Analog data are not synchronized with marker data."));
     double commonAnalogFrequency = 0.0;
@@ -109,7 +160,7 @@ namespace btk
       // Rates across all analog channels
       std::vector<double> all_rates(o3dm_analogs.size() + 1);
       for (size_t i = 0; i < o3dm_analogs.size(); i++)
-        all_rates[i] = o3dm_analogs[i]->Rate;
+        all_rates[i] = o3dm_analogs[i].Rate;
       // Include marker rate (or zero if not present)
       all_rates.back() = pointFrequency;
       // Choose lowest common multiple across all analog rates, and common marker rate
@@ -150,59 +201,58 @@ namespace btk
     int numAnalogSamplesPerFrame = static_cast<int>(commonAnalogFrequency / pointFrequency);
     size_t numAnalogFrames = numPointFrames * numAnalogSamplesPerFrame;
     
+    // Allocate the points and analog channels with their final size
+    output->Resize(static_cast<int>(o3dm_markers.size()), static_cast<int>(numPointFrames), static_cast<int>(o3dm_analogs.size()), numAnalogSamplesPerFrame);
+    
     // Store the markers data in the BTK Acquisition object
-    PointCollection::Pointer points = output->GetPoints();
     for (size_t i = 0 ; i < o3dm_markers.size() ; ++i)
     {
-      btk::Point::Pointer pt = btk::Point::New(o3dm_markers[i]->Channel, o3dm_markers[i]->NumFrames());
-      // Get sequence & iterator (may throw exception if missing fields)
-      const Open3DMotion::TimeSequence* ts = o3dm_markers[i];
-      Open3DMotion::TSOccVector3ConstIter iter_ts(*ts);
-      for (size_t j = 0 ; j < o3dm_markers[i]->NumFrames() ; ++j, iter_ts.Next())
-        pt->SetDataSlice((int)j, iter_ts.Value()[0], iter_ts.Value()[1], iter_ts.Value()[2], iter_ts.Occluded() ? -1.0 : 0.0);
-      for (size_t j = o3dm_markers[i]->NumFrames() ; j < numPointFrames ; ++j)
-        pt->SetDataSlice((int)j, 0.0, 0.0, 0.0, -1.0); // Invalid
-      points->InsertItem(pt);
+      Point::Pointer pt = output->GetPoint(static_cast<int>(i));
+      pt->SetLabel(o3dm_markers[i].Label);
+      decoder->DecodeMarker(i, pt->GetValues(), pt->GetResiduals());
+      const int numExtraFrames = static_cast<int>(numPointFrames - o3dm_markers[i].Frames);
+      pt->GetValues().bottomRows(numExtraFrames).setZero();
+      pt->GetResiduals().tail(numExtraFrames).setConstant(-1.0); // Invalid
     }
-
+    
     // Store the analogs data in the BTK Acquisition object
-    AnalogCollection::Pointer analogs = output->GetAnalogs();
     for (size_t i = 0 ; i < o3dm_analogs.size() ; ++i)
     {
-      size_t numFrames = numAnalogFrames < o3dm_analogs[i]->NumFrames() ? numAnalogFrames : o3dm_analogs[i]->NumFrames();
-      btk::Analog::Pointer an = btk::Analog::New(o3dm_analogs[i]->Channel, static_cast<int>(numAnalogFrames));
-      double offset = o3dm_analogs[i]->Offset.Value();
-      double scale = o3dm_analogs[i]->Scale.Value();
+      Analog::Pointer an = output->GetAnalog(static_cast<int>(i));
+      double offset = o3dm_analogs[i].Offset;
+      double scale = o3dm_analogs[i].Scale;
+      an->SetLabel(o3dm_analogs[i].Label);
       an->SetOffset(offset);
       an->SetScale(scale);
-      an->SetUnit(o3dm_analogs[i]->Units.Value());
-      // Get sequence & iterator (may throw exception if missing fields)
-      const Open3DMotion::TimeSequence* ts = o3dm_analogs[i];
-      Open3DMotion::TSScalarConstIter iter_ts(*ts);
-      /// Extract data (without or with the need of interpolation)
-      if (analogs_subsample[i] == 1)
-      {
-         for (size_t j = 0 ; j < numFrames ; ++j, iter_ts.Next())
-           an->SetDataSlice((int)j, (iter_ts.Value() - offset) * scale);
-      }
-      else if (numFrames > 0)
+      an->SetUnit(o3dm_analogs[i].Unit);
+      Analog::Values& values = an->GetValues();
+      values.setZero();
+      const size_t subsample = static_cast<size_t>(analogs_subsample[i]);
+      // Number of samples stored in the file which fit in the acquisition
+      size_t numFrames = o3dm_analogs[i].Frames;
+      if (numAnalogFrames == 0)
+        numFrames = 0;
+      else if (numFrames > (numAnalogFrames - 1) / subsample + 1)
+        numFrames = (numAnalogFrames - 1) / subsample + 1;
+      if (numFrames == 0)
+        continue;
+      decoder->DecodeAnalog(i, values.data(), numFrames);
+      values.head(numFrames) = (values.head(numFrames).array() - offset) * scale;
+      // Linear interpolation (done in place from the last sample to not overwrite the samples not yet used)
+      if (subsample != 1)
       {
-        double val0 = (iter_ts.Value() - offset) * scale; an->SetDataSlice(0, val0); iter_ts.Next();
-        for (size_t j = 1 ; j < numFrames ; ++j, iter_ts.Next())
+        double* data = values.data();
+        for (size_t j = numFrames - 1 ; j > 0 ; --j)
         {
-          double val1 = (iter_ts.Value() - offset) * scale;
-          an->SetDataSlice(static_cast<int>(j * analogs_subsample[i]), val1);
-          // Linear interpolation
-          for (int k = 1 ; k < analogs_subsample[i] ; ++k)
+          const double val0 = data[j-1], val1 = data[j];
+          data[j * subsample] = val1;
+          for (size_t k = 1 ; k < subsample ; ++k)
           {
-            int frame = static_cast<int>(j-1) * analogs_subsample[i] + k;
-            double lambda = static_cast<double>(frame % analogs_subsample[i]) / static_cast<double>(analogs_subsample[i]);
-            an->SetDataSlice(frame, (1.0-lambda) * val0 + lambda * val1);
+            const double lambda = static_cast<double>(k) / static_cast<double>(subsample);
+            data[(j-1) * subsample + k] = (1.0-lambda) * val0 + lambda * val1;
           }
-          val0 = val1;
         }
       }
-      analogs->InsertItem(an);
     }
     
     // Set the configuration of the force platforms
@@ -212,9 +262,9 @@ namespace btk
     bool hasCalibrationMatrix = false;
     // - Determine some internal format for the force platforms
     std::vector<int16_t> typeData;
-    for (size_t i = 0 ; i < trial->Acq.ForcePlates.NumElements(); ++i)
+    for (size_t i = 0 ; i < o3dm_forcePlates.size() ; ++i)
     {
-      const Open3DMotion::ForcePlate* fpm = &(trial->Acq.ForcePlates[i]);
+      const Open3DMotion::ForcePlate* fpm = o3dm_forcePlates[i];
       // AMTI
       if (fpm->Type.Value().compare(Open3DMotion::ForcePlate::TypeAMTI) == 0)
       {
@@ -282,7 +332,7 @@ namespace btk
         int hardwareID = (*it)->Channels[i];
         for (int analogindex_zerobased = 0 ; analogindex_zerobased < static_cast<int>(o3dm_analogs.size()) ; ++analogindex_zerobased)
         {
-          if (o3dm_analogs[analogindex_zerobased]->HardwareID.IsSet() && o3dm_analogs[analogindex_zerobased]->HardwareID == hardwareID)
+          if ((o3dm_analogs[analogindex_zerobased].HardwareID != -1) && (o3dm_analogs[analogindex_zerobased].HardwareID == hardwareID))
           {
             channelData[inc*numChannelPerPlatform + i] = static_cast<int16_t>(analogindex_zerobased + 1);
             Analog::Pointer ch = output->GetAnalog(analogindex_zerobased);
@@ -357,8 +407,32 @@ namespace btk
     output->GetMetaData()->AppendChild(forcePlatform);
     
     // Finalize the acquisition
-    output->Resize(points->GetItemNumber(), numPointFrames, analogs->GetItemNumber(), numAnalogSamplesPerFrame);
     output->SetPointFrequency(pointFrequency);
     output->SetFirstFrame(firstFrame);
   };
+  
+  /**
+   * Fill the acquisition @a output from the content read by Open3DMotion (complete tree of time sequences).
+   */
+  void FillAcquisitionFromOpen3DMotion_p(Acquisition::Pointer output, const std::string& filename, std::istream& ifs,
+                                          Open3DMotion::MotionFileHandler& handler, const Open3DMotion::MotionFileFormatList& formatlist)
+  {
+    btkSharedPtr<Open3DMotion::TreeValue> trialcontents(handler.Read(ifs, formatlist));
+    // Build trial
+    btkSharedPtr<Open3DMotion::Trial> trial(new Open3DMotion::Trial);
+    trial->FromTree(trialcontents.get());
+    // Retrieve sequences (analog & marker)
+    std::vector<const Open3DMotion::TimeSequence*> o3dm_markers;
+    std::vector<const Open3DMotion::TimeSequence*> o3dm_analogs;
+    trial->Acq.GetTSGroup(o3dm_markers, Open3DMotion::TrialSectionAcq::TSGroupMarker);
+    trial->Acq.GetTSGroup(o3dm_analogs, Open3DMotion::TrialSectionAcq::TSGroupAnalog);
+    std::vector<CodamotionChannel_p> markers, analogs;
+    ConvertOpen3DMotionSequences_p(&markers, o3dm_markers);
+    ConvertOpen3DMotionSequences_p(&analogs, o3dm_analogs);
+    std::vector<const Open3DMotion::ForcePlate*> forcePlates(trial->Acq.ForcePlates.NumElements());
+    for (size_t i = 0 ; i < forcePlates.size() ; ++i)
+      forcePlates[i] = &(trial->Acq.ForcePlates[i]);
+    Open3DMotionDecoder_p decoder(o3dm_markers, o3dm_analogs);
+    FillAcquisitionFromCodamotion_p(output, filename, markers, analogs, forcePlates, &decoder);
+  };
 };
@@ -37,8 +37,11 @@
 #define __btkCodamotionFileIOUtils_h
 
 #include "btkAcquisition.h"
+#include "btkBase64Decoder_p.h"
 #include "btkException.h"
+#include "btkFileStream.h"
 #include "btkMetaDataUtils.h"
+#include "btkSharedPtr.h"
 
 #include "Open3DMotion/MotionFile/MotionFileFormat.h"
 #include "Open3DMotion/MotionFile/MotionFileFormatList.h"
@@ -46,8 +49,10 @@
 #include "Open3DMotion/OpenORM/TreeValue.h"
 #include "Open3DMotion/OpenORM/Mappings/RichBinary/BinMemFactoryDefault.h"
 #include "Open3DMotion/Biomechanics/Trial/TSFactory.h"
+#include "Open3DMotion/Biomechanics/Trial/Trial.h"
 
-#include <fstream>
+#include <string>
+#include <vector>
 
 namespace btk
 {
@@ -61,7 +66,37 @@ namespace btk
     virtual ~CodamotionFileIOException() throw() {};
   };
   
-  void FillAcquisitionFromOpen3DMotion_p(Acquisition::Pointer output, const std::string& filename, std::ifstream& ifs,
+  // Description of a marker or an analog channel independent of the way its samples are decoded.
+  struct CodamotionChannel_p
+  {
+    std::string Label;
+    std::string Unit;
+    double Rate;
+    double Start;
+    size_t Frames;
+    int HardwareID; // -1 if not set
+    double Offset;
+    double Scale;
+  };
+  
+  // Decodes the samples of the channels directly in the storage of the acquisition.
+  class CodamotionDecoder_p
+  {
+  public:
+    virtual ~CodamotionDecoder_p() {};
+    // Fill the first frames of the values and residuals (-1 for occluded frames) of the marker #idx.
+    virtual void DecodeMarker(size_t idx, Point::Values& values, Point::Residuals& residuals) = 0;
+    // Fill the @a num first raw samples (offset and scale not applied) of the analog channel #idx.
+    virtual void DecodeAnalog(size_t idx, double* samples, size_t num) = 0;
+  };
+  
+  void ConvertOpen3DMotionSequences_p(std::vector<CodamotionChannel_p>* channels, const std::vector<const Open3DMotion::TimeSequence*>& sequences);
+  
+  void FillAcquisitionFromCodamotion_p(Acquisition::Pointer output, const std::string& filename,
+                                       const std::vector<CodamotionChannel_p>& markers, const std::vector<CodamotionChannel_p>& analogs,
+                                       const std::vector<const Open3DMotion::ForcePlate*>& forcePlates, CodamotionDecoder_p* decoder);
+  
+  void FillAcquisitionFromOpen3DMotion_p(Acquisition::Pointer output, const std::string& filename, std::istream& ifs,
                                           Open3DMotion::MotionFileHandler& handler, const Open3DMotion::MotionFileFormatList& formatlist);
 };
 
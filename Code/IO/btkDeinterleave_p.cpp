@@ -0,0 +1,142 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkDeinterleave_p.h"
+
+#include <cstring> // memcpy
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+  #define BTK_DEINTERLEAVE_SSE2
+  #include <emmintrin.h>
+#endif
+
+namespace btk
+{
+#if defined(BTK_DEINTERLEAVE_SSE2)
+  // Load two consecutive samples and convert them in doubles.
+  static inline __m128d LoadSamplePair_p(const int16_t* raw)
+  {
+    int32_t pair;
+    memcpy(&pair, raw, 4);
+    const __m128i words = _mm_cvtsi32_si128(pair);
+    return _mm_cvtepi32_pd(_mm_srai_epi32(_mm_unpacklo_epi16(words, words), 16)); // Sign extension
+  };
+  
+  static inline __m128d LoadSamplePair_p(const uint16_t* raw)
+  {
+    int32_t pair;
+    memcpy(&pair, raw, 4);
+    return _mm_cvtepi32_pd(_mm_unpacklo_epi16(_mm_cvtsi32_si128(pair), _mm_setzero_si128()));
+  };
+  
+  static inline __m128d LoadSamplePair_p(const float* raw)
+  {
+    return _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(raw))));
+  };
+#endif
+  
+  template <typename T>
+  static void Deinterleave_p(const T* raw, size_t frames, size_t channels, double* const* columns, const double* scales, const double* offsets)
+  {
+    size_t c = 0;
+#if defined(BTK_DEINTERLEAVE_SSE2)
+    if (channels == 1)
+    {
+      // Consecutive samples: only the conversion is vectorized.
+      const __m128d scale = _mm_set1_pd(scales[0]);
+      const __m128d offset = _mm_set1_pd(offsets[0]);
+      double* column = columns[0];
+      size_t i = 0;
+      for ( ; i + 1 < frames ; i += 2)
+        _mm_storeu_pd(column + i, _mm_add_pd(_mm_mul_pd(LoadSamplePair_p(raw + i), scale), offset));
+      for ( ; i < frames ; ++i)
+        column[i] = static_cast<double>(raw[i]) * scales[0] + offsets[0];
+      return;
+    }
+    // Pairs of channels are transposed by blocks of 2x2 samples.
+    for ( ; c + 1 < channels ; c += 2)
+    {
+      const __m128d scale = _mm_loadu_pd(scales + c);
+      const __m128d offset = _mm_loadu_pd(offsets + c);
+      double* column0 = columns[c];
+      double* column1 = columns[c+1];
+      const T* sample = raw + c;
+      size_t i = 0;
+      for ( ; i + 1 < frames ; i += 2)
+      {
+        const __m128d frame0 = _mm_add_pd(_mm_mul_pd(LoadSamplePair_p(sample), scale), offset);
+        const __m128d frame1 = _mm_add_pd(_mm_mul_pd(LoadSamplePair_p(sample + channels), scale), offset);
+        _mm_storeu_pd(column0 + i, _mm_unpacklo_pd(frame0, frame1));
+        _mm_storeu_pd(column1 + i, _mm_unpackhi_pd(frame0, frame1));
+        sample += 2 * channels;
+      }
+      for ( ; i < frames ; ++i)
+      {
+        column0[i] = static_cast<double>(sample[0]) * scales[c] + offsets[c];
+        column1[i] = static_cast<double>(sample[1]) * scales[c+1] + offsets[c+1];
+        sample += channels;
+      }
+    }
+#endif
+    // Remaining channel(s)
+    for ( ; c < channels ; ++c)
+    {
+      const double scale = scales[c];
+      const double offset = offsets[c];
+      double* column = columns[c];
+      const T* sample = raw + c;
+      for (size_t i = 0 ; i < frames ; ++i)
+      {
+        column[i] = static_cast<double>(*sample) * scale + offset;
+        sample += channels;
+      }
+    }
+  };
+  
+  void DeinterleaveSamples_p(const int16_t* raw, size_t frames, size_t channels, double* const* columns, const double* scales, const double* offsets)
+  {
+    Deinterleave_p(raw, frames, channels, columns, scales, offsets);
+  };
+  
+  void DeinterleaveSamples_p(const uint16_t* raw, size_t frames, size_t channels, double* const* columns, const double* scales, const double* offsets)
+  {
+    Deinterleave_p(raw, frames, channels, columns, scales, offsets);
+  };
+  
+  void DeinterleaveSamples_p(const float* raw, size_t frames, size_t channels, double* const* columns, const double* scales, const double* offsets)
+  {
+    Deinterleave_p(raw, frames, channels, columns, scales, offsets);
+  };
+};
@@ -0,0 +1,105 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkDeinterleave_p_h
+#define __btkDeinterleave_p_h
+
+#include "btkAcquisition.h"
+#include "btkBinaryFileStream.h"
+
+#include <vector>
+#include <algorithm>
+
+namespace btk
+{
+  // Transpose @a frames x @a channels samples stored frame by frame in @a raw into the arrays @a columns (one per channel).
+  // Each sample is converted as: columns[c][i] = raw[i * channels + c] * scales[c] + offsets[c].
+  // The conversion and the transposition are done with SSE2 instructions when the library is compiled with them.
+  void DeinterleaveSamples_p(const int16_t* raw, size_t frames, size_t channels, double* const* columns, const double* scales, const double* offsets);
+  void DeinterleaveSamples_p(const uint16_t* raw, size_t frames, size_t channels, double* const* columns, const double* scales, const double* offsets);
+  void DeinterleaveSamples_p(const float* raw, size_t frames, size_t channels, double* const* columns, const double* scales, const double* offsets);
+  
+  inline void ReadRawSamples_p(BinaryFileStream* bifs, size_t nb, int16_t* values) {bifs->ReadI16(nb, values);};
+  inline void ReadRawSamples_p(BinaryFileStream* bifs, size_t nb, uint16_t* values) {bifs->ReadU16(nb, values);};
+  inline void ReadRawSamples_p(BinaryFileStream* bifs, size_t nb, float* values) {bifs->ReadFloat(nb, values);};
+  
+  // Number of samples read at once by the functions below.
+  static const size_t DeinterleaveBlockSize_p = 65536;
+  
+  // Read the samples of all the analog channels of @a output stored frame by frame (one sample per channel) as values of type T.
+  // The vectors @a scales and @a offsets must contain one value per analog channel.
+  // The samples are read by blocks to bound the size of the temporary buffer.
+  template <typename T>
+  void ReadInterleavedAnalogs_p(BinaryFileStream* bifs, Acquisition::Pointer output, const std::vector<double>& scales, const std::vector<double>& offsets)
+  {
+    const size_t channels = static_cast<size_t>(output->GetAnalogNumber());
+    const size_t frames = static_cast<size_t>(output->GetAnalogFrameNumber());
+    if ((channels == 0) || (frames == 0))
+      return;
+    std::vector<double*> columns;
+    columns.reserve(channels);
+    for (Acquisition::AnalogIterator it = output->BeginAnalog() ; it != output->EndAnalog() ; ++it)
+      columns.push_back((*it)->GetValues().data());
+    const size_t blockFrames = std::min(frames, std::max(static_cast<size_t>(1), DeinterleaveBlockSize_p / channels));
+    std::vector<T> raw(blockFrames * channels);
+    for (size_t i = 0 ; i < frames ; i += blockFrames)
+    {
+      const size_t num = std::min(blockFrames, frames - i);
+      ReadRawSamples_p(bifs, num * channels, &(raw[0]));
+      DeinterleaveSamples_p(&(raw[0]), num, channels, &(columns[0]), &(scales[0]), &(offsets[0]));
+      for (size_t c = 0 ; c < channels ; ++c)
+        columns[c] += num;
+    }
+  };
+  
+  // Read the @a frames consecutive samples of one channel stored as values of type T.
+  template <typename T>
+  void ReadAnalogChannel_p(BinaryFileStream* bifs, double* column, size_t frames, double scale, double offset)
+  {
+    if (frames == 0)
+      return;
+    const size_t blockFrames = std::min(frames, DeinterleaveBlockSize_p);
+    std::vector<T> raw(blockFrames);
+    for (size_t i = 0 ; i < frames ; i += blockFrames)
+    {
+      const size_t num = std::min(blockFrames, frames - i);
+      ReadRawSamples_p(bifs, num, &(raw[0]));
+      DeinterleaveSamples_p(&(raw[0]), num, 1, &column, &scale, &offset);
+      column += num;
+    }
+  };
+};
+
+#endif // __btkDeinterleave_p_h
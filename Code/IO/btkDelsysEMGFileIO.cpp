@@ -35,6 +35,7 @@
 
 #include "btkDelsysEMGFileIO.h"
 #include "btkBinaryFileStream.h"
+#include "btkDeinterleave_p.h"
 #include "btkMetaDataUtils.h"
 #include "btkLogger.h"
 
@@ -155,11 +156,8 @@ namespace btk
         if (this->m_Version == 1)
         {
           this->SetStorageFormat(AcquisitionFileIO::Float);
-          for (int i = 0 ; i < numberOfSamples ; ++i)
-          {
-            for (Acquisition::AnalogIterator it = output->BeginAnalog() ; it != output->EndAnalog() ; ++it)
-              (*it)->GetValues().coeffRef(i) = bifs.ReadFloat();
-          }
+          std::vector<double> scales(numberOfChannels, 1.0), offsets(numberOfChannels, 0.0);
+          ReadInterleavedAnalogs_p<float>(&bifs, output, scales, offsets);
           // Based on the format for the version 2 of this file format, the scaling value, offset and gain are assumed.
           for (Acquisition::AnalogIterator it = output->BeginAnalog() ; it != output->EndAnalog() ; ++it)
           {
@@ -171,11 +169,9 @@ namespace btk
         else
         {
           this->SetStorageFormat(AcquisitionFileIO::Integer);
-          for (int i = 0 ; i < numberOfSamples ; ++i)
-          {
-            for (Acquisition::AnalogIterator it = output->BeginAnalog() ; it != output->EndAnalog() ; ++it)
-              (*it)->GetValues().coeffRef(i) = (static_cast<double>(bifs.ReadI16()) * scale - 5.0) / 1000.0;
-          }
+          // (raw * scale - 5.0) / 1000.0
+          std::vector<double> scales(numberOfChannels, scale / 1000.0), offsets(numberOfChannels, -5.0 / 1000.0);
+          ReadInterleavedAnalogs_p<int16_t>(&bifs, output, scales, offsets);
           // Set the analog channel infos
           for (Acquisition::AnalogIterator it = output->BeginAnalog() ; it != output->EndAnalog() ; ++it)
           {
@@ -254,16 +250,14 @@ namespace btk
           (*it)->SetOffset(offsets[inc] / gains[inc]);
           ++inc;
         }
-        // Data
-        for (int i = 0 ; i < numberOfSamples ; ++i)
+        // Data: (raw * resolution - offset) / gain
+        std::vector<double> scales(numberOfChannels), shifts(numberOfChannels);
+        for (int i = 0 ; i < numberOfChannels ; ++i)
         {
-          inc = 0;
-          for (Acquisition::AnalogIterator it = output->BeginAnalog() ; it != output->EndAnalog() ; ++it)
-          {
-            (*it)->GetValues().coeffRef(i) = (static_cast<double>(bifs.ReadI16()) * resolutions[inc] - offsets[inc]) / gains[inc];
-            ++inc;
-          }
+          scales[i] = resolutions[i] / gains[i];
+          shifts[i] = -1.0 * offsets[i] / gains[i];
         }
+        ReadInterleavedAnalogs_p<int16_t>(&bifs, output, scales, shifts);
       }
       else
       {
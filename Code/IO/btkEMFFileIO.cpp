@@ -37,8 +37,8 @@
 #include "btkConvert.h"
 #include "btkMetaDataUtils.h"
 #include "btkLogger.h"
+#include "btkFileStream.h"
 
-#include <fstream>
 #include <algorithm>
 #include <cctype>
 #include <string>
@@ -92,7 +92,7 @@ namespace btk
    */
   bool EMFFileIO::CanReadFile(const std::string& filename)
   {
-    std::ifstream ifs(filename.c_str());
+    ifilestream ifs(filename.c_str());
     char c[43] = {0};
     ifs.read(c, 42); c[42] = '\0';
     ifs.close();
@@ -108,7 +108,7 @@ namespace btk
   {
     output->Reset();
     // Open the stream
-    std::ifstream ifs;
+    ifilestream ifs;
     ifs.exceptions(std::ios_base::eofbit | std::ios_base::failbit | std::ios_base::badbit);
     try
     {
@@ -0,0 +1,255 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkFileReadAhead_p.h"
+
+#include <cstdio>
+#include <sys/stat.h>
+#if !defined(_MSC_VER)
+  #include <fcntl.h>
+#endif
+
+namespace btk
+{
+  // Returns the size of the file or 0 if it does not exist.
+  static size_t FileReadAheadSize(const std::string& filename)
+  {
+#if defined(_MSC_VER)
+    struct _stat64 info;
+    if (_stat64(filename.c_str(), &info) != 0)
+      return 0;
+#else
+    struct stat info;
+    if (stat(filename.c_str(), &info) != 0)
+      return 0;
+#endif
+    return static_cast<size_t>(info.st_size);
+  };
+  
+  FileReadAhead_p::FileReadAhead_p(const std::vector<std::string>& filenames, int readAhead, size_t maxInFlight)
+  : m_Filenames(filenames), m_Slots(filenames.size())
+  {
+    this->m_Started = false;
+    this->m_Stopped = false;
+    this->m_ReadAhead = (readAhead > 0) ? readAhead : 1;
+    this->m_MaxInFlight = maxInFlight;
+    this->m_LoadedNumber = 0;
+    this->m_InFlight = 0;
+#if defined(HAVE_WIN32_THREADS)
+    InitializeCriticalSection(&(this->m_Mutex));
+    InitializeConditionVariable(&(this->m_Condition));
+#elif defined(HAVE_PTHREADS)
+    pthread_mutex_init(&(this->m_Mutex), NULL);
+    pthread_cond_init(&(this->m_Condition), NULL);
+#endif
+  };
+  
+  FileReadAhead_p::~FileReadAhead_p()
+  {
+    this->Stop();
+#if defined(HAVE_WIN32_THREADS)
+    DeleteCriticalSection(&(this->m_Mutex));
+#elif defined(HAVE_PTHREADS)
+    pthread_cond_destroy(&(this->m_Condition));
+    pthread_mutex_destroy(&(this->m_Mutex));
+#endif
+  };
+  
+  // Launches the I/O thread. Does nothing if the threads are not supported.
+  void FileReadAhead_p::Start()
+  {
+    if (this->m_Started || this->m_Filenames.empty())
+      return;
+#if defined(HAVE_WIN32_THREADS)
+    this->m_Thread = CreateThread(NULL, 0, &FileReadAhead_p::ThreadFunction, this, 0, NULL);
+    this->m_Started = (this->m_Thread != NULL);
+#elif defined(HAVE_PTHREADS)
+    this->m_Started = (pthread_create(&(this->m_Thread), NULL, &FileReadAhead_p::ThreadFunction, this) == 0);
+#endif
+  };
+  
+  // Stops the I/O thread. The file currently loaded is finished before.
+  void FileReadAhead_p::Stop()
+  {
+    if (!this->m_Started)
+      return;
+    this->Lock();
+    this->m_Stopped = true;
+    this->Signal();
+    this->Unlock();
+#if defined(HAVE_WIN32_THREADS)
+    WaitForSingleObject(this->m_Thread, INFINITE);
+    CloseHandle(this->m_Thread);
+#elif defined(HAVE_PTHREADS)
+    pthread_join(this->m_Thread, NULL);
+#endif
+    this->m_Started = false;
+  };
+  
+  // Gives the content of the file at the index 'idx' (waits until it is loaded).
+  // The files must be acquired in the order of the list. Returns false if the file cannot be loaded.
+  bool FileReadAhead_p::Acquire(int idx, std::vector<char>* content)
+  {
+    content->clear();
+    if (!this->m_Started)
+      return FileReadAhead_p::LoadFile(this->m_Filenames[idx], content);
+    this->Lock();
+    Slot& slot = this->m_Slots[idx];
+    while ((slot.State == Pending) && !this->m_Stopped)
+      this->Wait();
+    bool loaded = (slot.State == Loaded);
+    if ((slot.State == Loaded) || (slot.State == Failed))
+    {
+      content->swap(slot.Content);
+      slot.State = Acquired;
+      this->m_InFlight -= content->size();
+      --this->m_LoadedNumber;
+      this->Signal();
+    }
+    this->Unlock();
+    return loaded;
+  };
+  
+  // Returns the number of bytes loaded but not yet acquired.
+  size_t FileReadAhead_p::GetInFlightSize()
+  {
+    this->Lock();
+    size_t size = this->m_InFlight;
+    this->Unlock();
+    return size;
+  };
+  
+  // Reads the whole content of the file in one block.
+  bool FileReadAhead_p::LoadFile(const std::string& filename, std::vector<char>* content)
+  {
+    std::FILE* file = std::fopen(filename.c_str(), "rb");
+    if (file == 0)
+      return false;
+#if defined(POSIX_FADV_SEQUENTIAL)
+    posix_fadvise(fileno(file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    const size_t size = FileReadAheadSize(filename);
+    content->resize(size);
+    size_t read = 0;
+    if (size != 0)
+      read = std::fread(&((*content)[0]), 1, size, file);
+    std::fclose(file);
+    if (read != size)
+    {
+      content->clear();
+      return false;
+    }
+    return true;
+  };
+  
+  void FileReadAhead_p::Lock()
+  {
+#if defined(HAVE_WIN32_THREADS)
+    EnterCriticalSection(&(this->m_Mutex));
+#elif defined(HAVE_PTHREADS)
+    pthread_mutex_lock(&(this->m_Mutex));
+#endif
+  };
+  
+  void FileReadAhead_p::Unlock()
+  {
+#if defined(HAVE_WIN32_THREADS)
+    LeaveCriticalSection(&(this->m_Mutex));
+#elif defined(HAVE_PTHREADS)
+    pthread_mutex_unlock(&(this->m_Mutex));
+#endif
+  };
+  
+  // Must be called with the mutex locked.
+  void FileReadAhead_p::Wait()
+  {
+#if defined(HAVE_WIN32_THREADS)
+    SleepConditionVariableCS(&(this->m_Condition), &(this->m_Mutex), INFINITE);
+#elif defined(HAVE_PTHREADS)
+    pthread_cond_wait(&(this->m_Condition), &(this->m_Mutex));
+#endif
+  };
+  
+  // Wakes up the I/O thread and the consumer.
+  void FileReadAhead_p::Signal()
+  {
+#if defined(HAVE_WIN32_THREADS)
+    WakeAllConditionVariable(&(this->m_Condition));
+#elif defined(HAVE_PTHREADS)
+    pthread_cond_broadcast(&(this->m_Condition));
+#endif
+  };
+  
+  // Loop of the I/O thread.
+  void FileReadAhead_p::Run()
+  {
+    for (size_t i = 0 ; i < this->m_Filenames.size() ; ++i)
+    {
+      const size_t size = FileReadAheadSize(this->m_Filenames[i]);
+      this->Lock();
+      // A file larger than the budget is loaded only when no other file is in flight.
+      while (!this->m_Stopped 
+             && ((this->m_LoadedNumber >= this->m_ReadAhead) || ((this->m_InFlight != 0) && (this->m_InFlight + size > this->m_MaxInFlight))))
+        this->Wait();
+      const bool stopped = this->m_Stopped;
+      this->Unlock();
+      if (stopped)
+        return;
+      std::vector<char> content;
+      const bool loaded = FileReadAhead_p::LoadFile(this->m_Filenames[i], &content);
+      this->Lock();
+      this->m_Slots[i].Content.swap(content);
+      this->m_Slots[i].State = loaded ? Loaded : Failed;
+      this->m_InFlight += this->m_Slots[i].Content.size();
+      ++this->m_LoadedNumber;
+      this->Signal();
+      this->Unlock();
+    }
+  };
+  
+#if defined(HAVE_WIN32_THREADS)
+  DWORD WINAPI FileReadAhead_p::ThreadFunction(LPVOID arg)
+  {
+    static_cast<FileReadAhead_p*>(arg)->Run();
+    return 0;
+  };
+#elif defined(HAVE_PTHREADS)
+  void* FileReadAhead_p::ThreadFunction(void* arg)
+  {
+    static_cast<FileReadAhead_p*>(arg)->Run();
+    return 0;
+  };
+#endif
+};
@@ -0,0 +1,112 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkFileReadAhead_p_h
+#define __btkFileReadAhead_p_h
+
+#include "btkConfigure.h"
+
+#if defined(HAVE_WIN32_THREADS)
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <windows.h>
+#elif defined(HAVE_PTHREADS)
+  #include <pthread.h>
+#endif
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace btk
+{
+  // Loads in memory the content of a list of files with a dedicated thread, in the order of the list.
+  // At most 'readAhead' files (and 'maxInFlight' bytes) are loaded but not yet acquired by the consumer.
+  // Without thread support, the files are loaded when they are acquired.
+  class FileReadAhead_p
+  {
+  public:
+    FileReadAhead_p(const std::vector<std::string>& filenames, int readAhead, size_t maxInFlight);
+    ~FileReadAhead_p();
+    
+    void Start();
+    void Stop();
+    bool Acquire(int idx, std::vector<char>* content);
+    size_t GetInFlightSize();
+    
+    static bool LoadFile(const std::string& filename, std::vector<char>* content);
+    
+  private:
+    enum {Pending = 0, Loaded, Failed, Acquired};
+    struct Slot
+    {
+      Slot() : State(Pending), Content() {};
+      int State;
+      std::vector<char> Content;
+    };
+    
+    void Lock();
+    void Unlock();
+    void Wait();
+    void Signal();
+    void Run();
+    
+#if defined(HAVE_WIN32_THREADS)
+    static DWORD WINAPI ThreadFunction(LPVOID arg);
+    HANDLE m_Thread;
+    CRITICAL_SECTION m_Mutex;
+    CONDITION_VARIABLE m_Condition;
+#elif defined(HAVE_PTHREADS)
+    static void* ThreadFunction(void* arg);
+    pthread_t m_Thread;
+    pthread_mutex_t m_Mutex;
+    pthread_cond_t m_Condition;
+#endif
+    bool m_Started;
+    bool m_Stopped;
+    std::vector<std::string> m_Filenames;
+    std::vector<Slot> m_Slots;
+    int m_ReadAhead;
+    size_t m_MaxInFlight;
+    int m_LoadedNumber;
+    size_t m_InFlight;
+    
+    FileReadAhead_p(const FileReadAhead_p& ); // Not implemented.
+    FileReadAhead_p& operator=(const FileReadAhead_p& ); // Not implemented.
+  };
+};
+
+#endif // __btkFileReadAhead_p_h
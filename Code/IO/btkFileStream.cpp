@@ -0,0 +1,349 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "btkFileStream.h"
+#include "btkCriticalSection_p.h"
+
+#include <map>
+#include <cstring> // strncmp
+
+namespace btk
+{
+  // ------------------------------------------------------------ //
+  //                  Memory file registry                        //
+  // ------------------------------------------------------------ //
+  
+  struct MemoryFileEntry_p
+  {
+    const char* data;
+    size_t size;
+    std::vector<char>* output;
+  };
+  
+  static const char btk_memory_file_prefix[] = "btkmem://";
+  static critical_section_p btk_memory_file_lock;
+  static std::map<std::string, MemoryFileEntry_p> btk_memory_file_registry;
+  static unsigned long btk_memory_file_counter = 0;
+  
+  /**
+   * @class MemoryFile btkFileStream.h
+   * @brief Register a memory buffer under a virtual filename.
+   *
+   * As long as this object exists, the filename returned by the method GetFilename()
+   * can be given to the classes BinaryFileStream, filestream, ifilestream and
+   * ofilestream, and then to every acquisition IO. The content is read from 
+   * (or written into) the buffer instead of the disk.
+   *
+   * The virtual filename ends with the given suffix (for example ".c3d") as some
+   * acquisition IOs use the file extension to detect the format.
+   *
+   * @warning The data given to the first constructor must remain valid during the 
+   * lifetime of this object. Companion files (for example the ".emg" file of an 
+   * Elite acquisition) cannot be resolved from the memory.
+   *
+   * @ingroup BTKIO
+   */
+  
+  /**
+   * Register the input buffer @a data with the size @a size. The buffer can only be read.
+   */
+  MemoryFile::MemoryFile(const char* data, size_t size, const std::string& suffix)
+  : m_Filename()
+  {
+    this->Register(data, size, 0, suffix);
+  };
+  
+  /**
+   * Register the output buffer @a output. The content written in the virtual file
+   * is copied into @a output when the stream is closed. Once written, the 
+   * content can also be read.
+   */
+  MemoryFile::MemoryFile(std::vector<char>* output, const std::string& suffix)
+  : m_Filename()
+  {
+    this->Register(0, 0, output, suffix);
+  };
+  
+  /**
+   * Unregister the virtual filename.
+   */
+  MemoryFile::~MemoryFile()
+  {
+    btk_memory_file_lock.Lock();
+    btk_memory_file_registry.erase(this->m_Filename);
+    btk_memory_file_lock.Unlock();
+  };
+  
+  /**
+   * @fn const std::string& MemoryFile::GetFilename() const
+   * Returns the virtual filename associated with the buffer.
+   */
+  
+  /**
+   * Extract the extension of the given @a filename (dot included). Returns an empty string if there is no extension.
+   * This static method is a convenient way to give a format hint to the constructors of this class.
+   */
+  std::string MemoryFile::ExtractSuffix(const std::string& filename)
+  {
+    std::string::size_type dot = filename.rfind('.');
+    std::string::size_type sep = filename.find_last_of("/\\");
+    if ((dot == std::string::npos) || ((sep != std::string::npos) && (sep > dot)))
+      return "";
+    return filename.substr(dot);
+  };
+  
+  /**
+   * Check if the given @a filename uses the prefix of the virtual filenames.
+   */
+  bool MemoryFile::IsMemoryFile(const char* filename)
+  {
+    return (filename != 0) && (strncmp(filename, btk_memory_file_prefix, sizeof(btk_memory_file_prefix) - 1) == 0);
+  };
+  
+  /**
+   * Find the buffers associated with the virtual @a filename. 
+   * @return False if the filename is not registered.
+   */
+  bool MemoryFile::Find(const char* filename, const char** data, size_t* size, std::vector<char>** output)
+  {
+    if (!MemoryFile::IsMemoryFile(filename))
+      return false;
+    bool found = false;
+    btk_memory_file_lock.Lock();
+    std::map<std::string, MemoryFileEntry_p>::const_iterator it = btk_memory_file_registry.find(filename);
+    if (it != btk_memory_file_registry.end())
+    {
+      *data = it->second.data;
+      *size = it->second.size;
+      *output = it->second.output;
+      found = true;
+    }
+    btk_memory_file_lock.Unlock();
+    return found;
+  };
+  
+  void MemoryFile::Register(const char* data, size_t size, std::vector<char>* output, const std::string& suffix)
+  {
+    MemoryFileEntry_p entry = {data, size, output};
+    btk_memory_file_lock.Lock();
+    std::ostringstream oss;
+    oss << btk_memory_file_prefix << ++btk_memory_file_counter << suffix;
+    this->m_Filename = oss.str();
+    btk_memory_file_registry[this->m_Filename] = entry;
+    btk_memory_file_lock.Unlock();
+  };
+  
+  // ------------------------------------------------------------ //
+  //                      Memory buffer                           //
+  // ------------------------------------------------------------ //
+  
+  /**
+   * @class memorybuf btkFileStream.h
+   * @brief Read-only stream buffer over an existing memory block (no copy).
+   */
+  
+  /**
+   * Constructor. The content of @a data is not copied.
+   */
+  memorybuf::memorybuf(const char* data, size_t size)
+  : std::streambuf()
+  {
+    char* p = const_cast<char*>(data);
+    this->setg(p, p, p + size);
+  };
+  
+  /**
+   * Sets the reading position relative to @a way.
+   */
+  memorybuf::pos_type memorybuf::seekoff(off_type off, std::ios_base::seekdir way, std::ios_base::openmode which)
+  {
+    if (!(which & std::ios_base::in))
+      return pos_type(off_type(-1));
+    off_type pos = 0;
+    if (way == std::ios_base::beg)
+      pos = off;
+    else if (way == std::ios_base::cur)
+      pos = (this->gptr() - this->eback()) + off;
+    else if (way == std::ios_base::end)
+      pos = (this->egptr() - this->eback()) + off;
+    else
+      return pos_type(off_type(-1));
+    if ((pos < 0) || (pos > (this->egptr() - this->eback())))
+      return pos_type(off_type(-1));
+    this->setg(this->eback(), this->eback() + pos, this->egptr());
+    return pos_type(pos);
+  };
+  
+  /**
+   * Sets the reading position to the absolute position @a pos.
+   */
+  memorybuf::pos_type memorybuf::seekpos(pos_type pos, std::ios_base::openmode which)
+  {
+    return this->seekoff(off_type(pos), std::ios_base::beg, which);
+  };
+  
+  // ------------------------------------------------------------ //
+  //                        File stream                           //
+  // ------------------------------------------------------------ //
+  
+  /**
+   * @class filestream btkFileStream.h
+   * @brief Drop-in replacement of std::fstream accepting the virtual filenames of MemoryFile.
+   *
+   * A regular filename is opened with a std::filebuf. A virtual filename is opened
+   * with a memory buffer: in read mode the registered data are read without copy,
+   * in write mode the content is copied into the registered output when the stream is closed.
+   *
+   * @sa ifilestream, ofilestream
+   * @ingroup BTKIO
+   */
+  
+  /**
+   * @class ifilestream btkFileStream.h
+   * @brief Drop-in replacement of std::ifstream accepting the virtual filenames of MemoryFile.
+   * @ingroup BTKIO
+   */
+  
+  /**
+   * @class ofilestream btkFileStream.h
+   * @brief Drop-in replacement of std::ofstream accepting the virtual filenames of MemoryFile.
+   * @ingroup BTKIO
+   */
+  
+  /**
+   * Constructor. No file is opened.
+   */
+  filestream::filestream()
+  : std::iostream(0), m_File(), mp_Memory(0), mp_Output(0)
+  {
+    this->rdbuf(&this->m_File);
+  };
+  
+  /**
+   * Constructor which opens the file @a s with the options @a mode.
+   */
+  filestream::filestream(const char* s, std::ios_base::openmode mode)
+  : std::iostream(0), m_File(), mp_Memory(0), mp_Output(0)
+  {
+    this->rdbuf(&this->m_File);
+    this->open(s, mode);
+  };
+  
+  /**
+   * Destructor. Close the file if necessary. No exception is thrown.
+   */
+  filestream::~filestream()
+  {
+    if (this->mp_Output != 0)
+    {
+      std::string content = static_cast<std::stringbuf*>(this->mp_Memory)->str();
+      this->mp_Output->assign(content.begin(), content.end());
+    }
+    delete this->mp_Memory;
+  };
+  
+  /**
+   * Open the file (or the virtual file) @a s with the options @a mode.
+   * The failbit is set in case of error.
+   */
+  void filestream::open(const char* s, std::ios_base::openmode mode)
+  {
+    if (this->is_open())
+    {
+      this->setstate(std::ios_base::failbit);
+      return;
+    }
+    const char* data = 0;
+    size_t size = 0;
+    std::vector<char>* output = 0;
+    if (MemoryFile::Find(s, &data, &size, &output))
+    {
+      if (mode & (std::ios_base::out | std::ios_base::app))
+      {
+        if (output == 0)
+        {
+          this->setstate(std::ios_base::failbit);
+          return;
+        }
+        std::string content;
+        if (((mode & std::ios_base::in) && !(mode & std::ios_base::trunc)) || (mode & std::ios_base::app))
+          content.assign(output->begin(), output->end());
+        std::stringbuf* buf = new std::stringbuf(content, std::ios_base::in | std::ios_base::out);
+        if (mode & (std::ios_base::ate | std::ios_base::app))
+          buf->pubseekoff(0, std::ios_base::end, std::ios_base::out);
+        this->mp_Memory = buf;
+        this->mp_Output = output;
+      }
+      else if (output != 0)
+        this->mp_Memory = new memorybuf(output->empty() ? 0 : &(*output)[0], output->size());
+      else
+        this->mp_Memory = new memorybuf(data, size);
+      this->rdbuf(this->mp_Memory);
+    }
+    else if (MemoryFile::IsMemoryFile(s) || !this->m_File.open(s, mode))
+      this->setstate(std::ios_base::failbit);
+    else
+      this->clear();
+  };
+  
+  /**
+   * @fn bool filestream::is_open() const
+   * Returns true if a file (or a virtual file) is opened.
+   */
+  
+  /**
+   * Close the file. For a virtual file opened in write mode, the content is copied into the registered output.
+   * The failbit is set in case of error.
+   */
+  void filestream::close()
+  {
+    if (this->mp_Memory != 0)
+    {
+      if (this->mp_Output != 0)
+      {
+        std::string content = static_cast<std::stringbuf*>(this->mp_Memory)->str();
+        this->mp_Output->assign(content.begin(), content.end());
+      }
+      delete this->mp_Memory;
+      this->mp_Memory = 0;
+      this->mp_Output = 0;
+      std::ios_base::iostate state = this->rdstate();
+      this->rdbuf(&this->m_File);
+      this->clear(state);
+    }
+    else if (!this->m_File.close())
+      this->setstate(std::ios_base::failbit);
+  };
+};
@@ -0,0 +1,123 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkFileStream_h
+#define __btkFileStream_h
+
+#include "btkConfigure.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace btk
+{
+  class MemoryFile
+  {
+  public:
+    BTK_IO_EXPORT MemoryFile(const char* data, size_t size, const std::string& suffix = "");
+    BTK_IO_EXPORT MemoryFile(std::vector<char>* output, const std::string& suffix = "");
+    BTK_IO_EXPORT ~MemoryFile();
+    
+    const std::string& GetFilename() const {return this->m_Filename;};
+    
+    BTK_IO_EXPORT static std::string ExtractSuffix(const std::string& filename);
+    BTK_IO_EXPORT static bool IsMemoryFile(const char* filename);
+    BTK_IO_EXPORT static bool Find(const char* filename, const char** data, size_t* size, std::vector<char>** output);
+    
+  private:
+    MemoryFile(const MemoryFile& ); // Not implemented.
+    MemoryFile& operator=(const MemoryFile& ); // Not implemented.
+    
+    void Register(const char* data, size_t size, std::vector<char>* output, const std::string& suffix);
+    
+    std::string m_Filename;
+  };
+  
+  class memorybuf : public std::streambuf
+  {
+  public:
+    BTK_IO_EXPORT memorybuf(const char* data, size_t size);
+    
+  protected:
+    BTK_IO_EXPORT virtual pos_type seekoff(off_type off, std::ios_base::seekdir way, std::ios_base::openmode which = std::ios_base::in | std::ios_base::out);
+    BTK_IO_EXPORT virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which = std::ios_base::in | std::ios_base::out);
+    
+  private:
+    memorybuf(const memorybuf& ); // Not implemented.
+    memorybuf& operator=(const memorybuf& ); // Not implemented.
+  };
+  
+  class filestream : public std::iostream
+  {
+  public:
+    typedef std::ios_base::failure failure;
+    
+    BTK_IO_EXPORT filestream();
+    BTK_IO_EXPORT filestream(const char* s, std::ios_base::openmode mode = std::ios_base::in | std::ios_base::out);
+    BTK_IO_EXPORT virtual ~filestream();
+    
+    BTK_IO_EXPORT void open(const char* s, std::ios_base::openmode mode = std::ios_base::in | std::ios_base::out);
+    bool is_open() const {return (this->mp_Memory != 0) || this->m_File.is_open();};
+    BTK_IO_EXPORT void close();
+    
+  private:
+    filestream(const filestream& ); // Not implemented.
+    filestream& operator=(const filestream& ); // Not implemented.
+    
+    std::filebuf m_File;
+    std::streambuf* mp_Memory;
+    std::vector<char>* mp_Output;
+  };
+  
+  class ifilestream : public filestream
+  {
+  public:
+    ifilestream() : filestream() {};
+    ifilestream(const char* s, std::ios_base::openmode mode = std::ios_base::in) : filestream(s, mode | std::ios_base::in) {};
+    void open(const char* s, std::ios_base::openmode mode = std::ios_base::in) {this->filestream::open(s, mode | std::ios_base::in);};
+  };
+  
+  class ofilestream : public filestream
+  {
+  public:
+    ofilestream() : filestream() {};
+    ofilestream(const char* s, std::ios_base::openmode mode = std::ios_base::out) : filestream(s, mode | std::ios_base::out) {};
+    void open(const char* s, std::ios_base::openmode mode = std::ios_base::out) {this->filestream::open(s, mode | std::ios_base::out);};
+  };
+};
+
+#endif // __btkFileStream_h
@@ -37,8 +37,8 @@
 #include "btkBinaryFileStream.h"
 #include "btkMetaDataUtils.h"
 #include "btkWrench.h"
+#include "btkFileStream.h"
 
-#include <fstream>
 #include <algorithm>
 #include <cctype>
 
@@ -94,7 +94,7 @@ namespace btk
     std::string::size_type GRxPos = lowercase.substr(0,lowercase.length()-1).rfind(".gr");
     if ((GRxPos != std::string::npos) && (GRxPos == lowercase.length() - 4) && (*(lowercase.rbegin()) >= 0x31) && (*(lowercase.rbegin()) <= 0x39))
     {
-      std::ifstream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+      ifilestream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
       if (!ifs)
         return false;
       ifs.close();
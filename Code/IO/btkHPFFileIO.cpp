@@ -40,6 +40,7 @@
 #include "btkLogger.h"
 
 #include <limits>
+#include <vector>
 
 #include <pugixml.hpp>
 
@@ -53,6 +54,14 @@ struct btk_hpf_chunk_info
   int32_t group;
 };
 
+struct btk_hpf_channel_data
+{
+  size_t position;
+  int64_t start;
+  int32_t numFrames;
+  int channel;
+};
+
 namespace btk
 {
   /**
@@ -257,6 +266,8 @@ namespace btk
       if (!errmsg.empty())
         throw HPFFileIOException(errmsg);
       // Extract the data
+      // - First, the location of the data of each channel is extracted to allocate the analog channels only once.
+      std::vector<btk_hpf_channel_data> channelData;
       int64_t maxFrameNumber = 0;
       for (std::list<btk_hpf_chunk_info>::iterator it = chunks.begin() ; it != chunks.end() ; ++it)
       {
@@ -273,25 +284,37 @@ namespace btk
         // - If for some reason the the number of channels is greater than in the configuration, the value is bounded.
         if (channelDataCount > numAnalogChannels)
           channelDataCount = numAnalogChannels;
-        int32_t* channelDescriptor = new int32_t[2*channelDataCount];
-        bifs.ReadI32(2*channelDataCount, channelDescriptor);
-        // Read data
-        Acquisition::AnalogIterator itA = output->BeginAnalog();
+        std::vector<int32_t> channelDescriptor(static_cast<size_t>(2*channelDataCount));
+        if (channelDataCount != 0)
+          bifs.ReadI32(2*channelDataCount, &(channelDescriptor[0]));
         for (int i = 0 ; i < channelDataCount ; ++i)
         {
-          bifs.SeekRead(it->position + channelDescriptor[i*2], BinaryFileStream::Begin);
-          int32_t numFrames = channelDescriptor[i*2+1] / 4;
-          maxFrameNumber = std::max(maxFrameNumber, dataStartIndex + numFrames);
-          if ((*itA)->GetFrameNumber() < static_cast<int>(maxFrameNumber))
-            (*itA)->SetFrameNumber(static_cast<int>(maxFrameNumber));
-          for (int j = 0 ; j < numFrames ; ++j)
-            (*itA)->SetDataSlice(static_cast<int>(dataStartIndex+j), bifs.ReadFloat());
-          ++itA;
+          btk_hpf_channel_data cd;
+          cd.position = it->position + channelDescriptor[i*2];
+          cd.start = dataStartIndex;
+          cd.numFrames = channelDescriptor[i*2+1] / 4;
+          cd.channel = i;
+          maxFrameNumber = std::max(maxFrameNumber, dataStartIndex + cd.numFrames);
+          channelData.push_back(cd);
         }
       }
-      // Finalize the acquisition configuration
+      // - Then, the samples are read by blocks directly in the analog channels.
       output->SetPointFrequency(analogFrequency);
       output->Resize(0, static_cast<int>(maxFrameNumber), numAnalogChannels);
+      std::vector<float> samples;
+      for (size_t i = 0 ; i < channelData.size() ; ++i)
+      {
+        const btk_hpf_channel_data& cd = channelData[i];
+        if (cd.numFrames <= 0)
+          continue;
+        samples.resize(cd.numFrames);
+        bifs.SeekRead(cd.position, BinaryFileStream::Begin);
+        bifs.ReadFloat(cd.numFrames, &(samples[0]));
+        Analog::Values& values = output->GetAnalog(cd.channel)->GetValues();
+        for (int32_t j = 0 ; j < cd.numFrames ; ++j)
+          values.coeffRef(static_cast<int>(cd.start + j)) = static_cast<double>(samples[j]);
+      }
+      // Finalize the acquisition configuration
       // The ADC resolution is not stored. It is assumed that it is a 16-bit ADC card.
       output->SetAnalogResolution(Acquisition::Bit16);
       // Add a metadata to notify that the first frame was not set.
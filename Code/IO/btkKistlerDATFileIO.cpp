@@ -35,6 +35,7 @@
 
 #include "btkKistlerDATFileIO.h"
 #include "btkBinaryFileStream.h"
+#include "btkDeinterleave_p.h"
 #include "btkMetaDataUtils.h"
 
 namespace btk
@@ -253,8 +254,7 @@ namespace btk
       {
         (*it)->SetLabel(labels[inc++]);
         (*it)->SetUnit("N");
-        for (int i = 0 ; i < numberOfFrames ; ++i)
-          (*it)->GetValues().coeffRef(i) = -1.0 * bifs.ReadFloat(); // -1.0: BTK stores the reaction.
+        ReadAnalogChannel_p<float>(&bifs, (*it)->GetValues().data(), numberOfFrames, -1.0, 0.0); // -1.0: BTK stores the reaction.
       }
       
       // Compute the origin and the coordinates of the corners
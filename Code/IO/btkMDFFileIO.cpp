@@ -38,9 +38,319 @@
 #include "btkConfigure.h"
 
 #include "Open3DMotion/MotionFile/Formats/MDF/FileFormatMDF.h"
+#include "Open3DMotion/MotionFile/Formats/MDF/FileFormatOptionsMDF.h"
+#include "Open3DMotion/MotionFile/Formats/MDF/ForcePlateMDF.h"
+#include "Open3DMotion/MotionFile/Formats/MDF/MDFDescriptor.h"
+#include "Open3DMotion/MotionFile/Formats/MDF/MDFVarTypes.h"
+
+#include <cstring> // memcpy
+#include <map>
 
 namespace btk
 {
+  typedef std::map<size_t, std::vector< std::vector<Open3DMotion::UInt8> >, std::less<size_t> > MDFData_p;
+  typedef std::map<size_t, size_t, std::less<size_t> > MDFElementSize_p;
+  
+  // Location of the samples of one channel in the file.
+  struct MDFSection_p
+  {
+    std::streamoff Position;
+    size_t Bytes;
+  };
+  
+  // Decoder reading the samples of the markers and EMG channels directly from the file (one channel at a time).
+  // The force channels are decoded from the sections already loaded (they are needed to configure AMTI force platforms).
+  class MDFDecoder_p : public CodamotionDecoder_p
+  {
+  public:
+    MDFDecoder_p(std::istream& is, const MDFData_p& data, int version)
+    : mr_Stream(is), mr_Data(data), m_Version(version), m_MarkerSections(), m_MarkerScales(), m_AnalogSections(), m_ForceChannels(), m_Buffer()
+    {};
+    
+    virtual void DecodeMarker(size_t idx, Point::Values& values, Point::Residuals& residuals)
+    {
+      const MDFSection_p& section = this->m_MarkerSections[idx];
+      this->ReadSection(section);
+      const size_t elementSize = (this->m_Version == Open3DMotion::FileFormatOptionsMDF::VERSION2) ? 6 : 12;
+      const size_t numFrames = section.Bytes / elementSize;
+      const float scale = this->m_MarkerScales[idx];
+      const Open3DMotion::UInt8* data = this->m_Buffer.empty() ? 0 : &(this->m_Buffer[0]);
+      for (size_t j = 0 ; j < numFrames ; ++j, data += elementSize)
+      {
+        if (this->m_Version == Open3DMotion::FileFormatOptionsMDF::VERSION2) // Scaled 16-bit integers
+        {
+          Open3DMotion::Int16 pos[3];
+          memcpy(pos, data, 6);
+          values.coeffRef(j,0) = pos[0] * scale;
+          values.coeffRef(j,1) = pos[1] * scale;
+          values.coeffRef(j,2) = pos[2] * scale;
+        }
+        else // Floating point
+        {
+          float pos[3];
+          memcpy(pos, data, 12);
+          values.coeffRef(j,0) = static_cast<double>(pos[0]);
+          values.coeffRef(j,1) = static_cast<double>(pos[1]);
+          values.coeffRef(j,2) = static_cast<double>(pos[2]);
+        }
+      }
+      // Each bit of the in-view flags (big endian words) corresponds to one frame. Missing flags are considered as visible.
+      const MDFData_p::const_iterator inview = this->mr_Data.find(Open3DMotion::VAR_FLAG_IN_VIEW);
+      const std::vector<Open3DMotion::UInt8>* flags = ((inview != this->mr_Data.end()) && (idx < inview->second.size())) ? &(inview->second[idx]) : 0;
+      for (size_t j = 0 ; j < numFrames ; ++j)
+      {
+        const size_t word = 2 * (j >> 4);
+        if ((flags == 0) || (word + 1 >= flags->size()))
+          residuals.coeffRef(j) = 0.0;
+        else
+        {
+          const Open3DMotion::UInt16 wInView = static_cast<Open3DMotion::UInt16>(((*flags)[word] << 8) | (*flags)[word+1]);
+          residuals.coeffRef(j) = (wInView & (0x8000 >> (j & 0xF))) ? 0.0 : -1.0;
+        }
+      }
+    };
+    
+    virtual void DecodeAnalog(size_t idx, double* samples, size_t num)
+    {
+      const Open3DMotion::UInt8* data = 0;
+      if (idx < this->m_AnalogSections.size()) // EMG
+      {
+        this->ReadSection(this->m_AnalogSections[idx]);
+        data = this->m_Buffer.empty() ? 0 : &(this->m_Buffer[0]);
+      }
+      else // Force
+        data = &(this->mr_Data.find(Open3DMotion::VAR_ANALOGUE_FORCE)->second[this->m_ForceChannels[idx - this->m_AnalogSections.size()]][0]);
+      for (size_t j = 0 ; j < num ; ++j, data += 2)
+      {
+        Open3DMotion::Int16 value;
+        memcpy(&value, data, 2);
+        samples[j] = static_cast<double>(value);
+      }
+    };
+    
+    void AppendMarker(const MDFSection_p& section, float scale)
+    {
+      this->m_MarkerSections.push_back(section);
+      this->m_MarkerScales.push_back(scale);
+    };
+    void AppendEMG(const MDFSection_p& section) {this->m_AnalogSections.push_back(section);};
+    void AppendForce(size_t channel) {this->m_ForceChannels.push_back(channel);};
+    
+  private:
+    void ReadSection(const MDFSection_p& section)
+    {
+      this->m_Buffer.resize(section.Bytes);
+      this->mr_Stream.seekg(section.Position, std::ios::beg);
+      if (section.Bytes != 0)
+        this->mr_Stream.read(reinterpret_cast<char*>(&(this->m_Buffer[0])), section.Bytes);
+    };
+    
+    std::istream& mr_Stream;
+    const MDFData_p& mr_Data;
+    int m_Version;
+    std::vector<MDFSection_p> m_MarkerSections;
+    std::vector<float> m_MarkerScales;
+    std::vector<MDFSection_p> m_AnalogSections;
+    std::vector<size_t> m_ForceChannels;
+    std::vector<Open3DMotion::UInt8> m_Buffer;
+  };
+  
+  static std::string DecodeMDFString_p(const std::vector<Open3DMotion::UInt8>& element)
+  {
+    size_t size = element.size();
+    // Discard last byte if it's a null terminator
+    if ((size > 0) && (element[size-1] == '\0'))
+      --size;
+    return (size > 0) ? std::string(reinterpret_cast<const char*>(&element[0]), size) : std::string();
+  };
+  
+  template <typename T>
+  static T ReadMDFValue_p(const std::vector<Open3DMotion::UInt8>& element)
+  {
+    T value = T();
+    if (element.size() >= sizeof(T))
+      memcpy(&value, &element[0], sizeof(T));
+    return value;
+  };
+  
+  // Read the MDF sections without Open3DMotion's time sequences. The markers and EMG samples are only located
+  // during the parsing of the file and decoded later directly in the points and analog channels. 
+  // The calculated data (MDR) and the video are skipped. Open3DMotion is only used to configure the force platforms.
+  static void ReadMDFDirectly_p(Acquisition::Pointer output, const std::string& filename, std::istream& is, int version)
+  {
+    // Header
+    is.seekg(6, std::ios::beg);
+    Open3DMotion::UInt16 numEntries = 0;
+    is.read(reinterpret_cast<char*>(&numEntries), 2);
+    std::vector<size_t> types(numEntries), channels(numEntries), elementSizes(numEntries);
+    for (size_t i = 0 ; i < numEntries ; ++i)
+    {
+      Open3DMotion::UInt16 wType = 0xFFFF, wChannels = 0;
+      is.read(reinterpret_cast<char*>(&wType), 2);
+      is.read(reinterpret_cast<char*>(&wChannels), 2);
+      types[i] = wType & 0xFF;
+      channels[i] = wChannels;
+      if (types[i] == Open3DMotion::VAR_VIDEO_AVI)
+        elementSizes[i] = 256;
+      else if (types[i] == Open3DMotion::VAR_FORCE_PLATE_TYPE)
+        elementSizes[i] = 32;
+      else
+        elementSizes[i] = (wType & 0x0F00) >> 8;
+    }
+    // Sections
+    MDFData_p data;
+    MDFElementSize_p elementsize;
+    for (size_t t = 0 ; t <= Open3DMotion::VAR_FORCE_SEGMENT ; ++t)
+      data[t]; // All the known types are expected by the parser of the force platforms
+    std::vector<MDFSection_p> markerSections, emgSections;
+    for (size_t i = 0 ; i < numEntries ; ++i)
+    {
+      const size_t type = types[i];
+      const bool streamed = (type == Open3DMotion::VAR_POSITION_MARKER) || (type == Open3DMotion::VAR_ANALOGUE_EMG);
+      const bool skipped = (type == Open3DMotion::VAR_VIDEO_AVI) || (type >= Open3DMotion::DataMarker);
+      if (!skipped)
+      {
+        elementsize[type] = elementSizes[i];
+        data[type].resize(channels[i]);
+      }
+      for (size_t j = 0 ; j < channels[i] ; ++j)
+      {
+        Open3DMotion::UInt16 wElements = 0;
+        is.read(reinterpret_cast<char*>(&wElements), 2);
+        const size_t bytes = static_cast<size_t>(wElements) * elementSizes[i];
+        if (streamed)
+        {
+          MDFSection_p section = {static_cast<std::streamoff>(is.tellg()), bytes};
+          (type == Open3DMotion::VAR_POSITION_MARKER ? markerSections : emgSections).push_back(section);
+        }
+        if (streamed || skipped)
+          is.seekg(static_cast<std::streamoff>(bytes), std::ios::cur);
+        else
+        {
+          data[type][j].resize(bytes);
+          if (bytes != 0)
+            is.read(reinterpret_cast<char*>(&(data[type][j][0])), bytes);
+        }
+      }
+    }
+    
+    MDFDecoder_p decoder(is, data, version);
+    std::vector<CodamotionChannel_p> markers(markerSections.size()), analogs;
+    
+    // Markers
+    const size_t markerElementSize = (version == Open3DMotion::FileFormatOptionsMDF::VERSION2) ? 6 : 12;
+    if (!markers.empty() && (elementsize[Open3DMotion::VAR_POSITION_MARKER] != markerElementSize))
+      throw(MDFFileIOException("Unexpected element size for markers"));
+    const std::vector< std::vector<Open3DMotion::UInt8> >& markerRates = data[Open3DMotion::VAR_TIME_RESOLUTION_MARKER];
+    for (size_t i = 0 ; i < markers.size() ; ++i)
+    {
+      if ((i >= markerRates.size()) || (markerRates[i].size() != 2))
+        throw(MDFFileIOException("Unknown frame rate for marker"));
+      float scale = 1.0f;
+      if (i < data[Open3DMotion::VAR_POSITION_RESOLUTION_MARKER].size())
+        scale = 1e-3f * ReadMDFValue_p<Open3DMotion::Int16>(data[Open3DMotion::VAR_POSITION_RESOLUTION_MARKER][i]);
+      std::string name;
+      if (i < data[Open3DMotion::VAR_MARKER_NAMES].size())
+      {
+        name = DecodeMDFString_p(data[Open3DMotion::VAR_MARKER_NAMES][i]);
+        // Enforce unique names (as done by Open3DMotion)
+        for (size_t k = 0 ; k < i ; ++k)
+        {
+          if (markers[k].Label == name)
+          {
+            name.clear();
+            break;
+          }
+        }
+      }
+      if (name.empty())
+        name = "Marker" + ToString(i+1);
+      // Hardware number (zero-based in MDF files, only 99 unique identifiers are supported by Open3DMotion)
+      Open3DMotion::Int32 hardware = static_cast<Open3DMotion::Int32>(i);
+      if (i < data[Open3DMotion::VAR_MARKER_NUMBER_HARDWARE].size())
+        hardware = ReadMDFValue_p<Open3DMotion::UInt16>(data[Open3DMotion::VAR_MARKER_NUMBER_HARDWARE][i]);
+      hardware = hardware % 100;
+      CodamotionChannel_p& marker = markers[i];
+      marker.Label = name;
+      marker.Unit = "mm";
+      marker.Rate = static_cast<double>(ReadMDFValue_p<Open3DMotion::UInt16>(markerRates[i]));
+      marker.Start = 0.000172 * hardware; // Standard time offset from one marker to the next in MDF files
+      marker.Frames = markerSections[i].Bytes / markerElementSize;
+      marker.HardwareID = hardware + 1;
+      marker.Offset = 0.0;
+      marker.Scale = 1.0;
+      decoder.AppendMarker(markerSections[i], scale);
+    }
+    
+    // EMG
+    if (!emgSections.empty() && (elementsize[Open3DMotion::VAR_ANALOGUE_EMG] != 2))
+      throw(MDFFileIOException("Unexpected element size for EMG data"));
+    for (size_t i = 0 ; i < emgSections.size() ; ++i)
+    {
+      CodamotionChannel_p emg;
+      if (i < data[Open3DMotion::VAR_TIME_RESOLUTION_EMG].size())
+        emg.Rate = ReadMDFValue_p<Open3DMotion::UInt16>(data[Open3DMotion::VAR_TIME_RESOLUTION_EMG][i]);
+      else if (!markerRates.empty())
+        emg.Rate = ReadMDFValue_p<Open3DMotion::UInt16>(markerRates[0]);
+      else
+        throw(MDFFileIOException("Unknown frame rate for EMG"));
+      emg.Scale = (i < data[Open3DMotion::VAR_EMG_RESOLUTION].size()) ? ReadMDFValue_p<float>(data[Open3DMotion::VAR_EMG_RESOLUTION][i]) : 1.84; // Old scaling constant
+      if (i < data[Open3DMotion::VAR_ANALOGUE_EMG_NAMES].size())
+        emg.Label = DecodeMDFString_p(data[Open3DMotion::VAR_ANALOGUE_EMG_NAMES][i]);
+      else
+        emg.Label = "EMG" + ToString(i+1);
+      emg.Unit = "mV";
+      emg.Start = 0.0;
+      emg.Frames = emgSections[i].Bytes / 2;
+      emg.HardwareID = static_cast<int>(i + 1);
+      emg.Offset = 0.0;
+      analogs.push_back(emg);
+      decoder.AppendEMG(emgSections[i]);
+    }
+    // The channel count of the EMG is used by Open3DMotion to set the channels of the force platforms.
+    data[Open3DMotion::VAR_ANALOGUE_EMG].resize(emgSections.size());
+    
+    // Force platforms
+    const size_t numPlates = Open3DMotion::ForcePlateMDF::NumPlates(data, elementsize);
+    if (data[Open3DMotion::VAR_ANALOGUE_FORCE].size() < 8 * numPlates)
+      throw(MDFFileIOException("Missing force channels"));
+    std::vector<Open3DMotion::ForcePlateMDF> plates(numPlates);
+    std::vector<const Open3DMotion::ForcePlate*> forcePlates(numPlates);
+    for (size_t iplate = 0 ; iplate < numPlates ; ++iplate)
+    {
+      plates[iplate].ParseMDF(data, elementsize, iplate);
+      forcePlates[iplate] = &(plates[iplate]);
+      for (size_t ichannel = 0 ; ichannel < 8 ; ++ichannel)
+      {
+        // MDF uses 8 channels per plate, even for 6-channel AMTI
+        const size_t mdfChannel = plates[iplate].RuntimeChannelToMDFChannel(ichannel);
+        const size_t index = 8 * iplate + mdfChannel;
+        CodamotionChannel_p force;
+        if (!data[Open3DMotion::VAR_TIME_RESOLUTION_FORCE].empty())
+          force.Rate = ReadMDFValue_p<Open3DMotion::UInt16>(data[Open3DMotion::VAR_TIME_RESOLUTION_FORCE][0]);
+        else if (!markerRates.empty())
+          force.Rate = ReadMDFValue_p<Open3DMotion::UInt16>(markerRates[0]);
+        else
+          throw(MDFFileIOException("Unknown frame rate for force"));
+        force.Scale = (index < data[Open3DMotion::VAR_FORCE_RESOLUTION].size()) ? ReadMDFValue_p<float>(data[Open3DMotion::VAR_FORCE_RESOLUTION][index]) : 0.05; // Old scaling constant
+        force.Scale *= plates[iplate].MDFChannelScale(mdfChannel);
+        if (index < data[Open3DMotion::VAR_ANALOGUE_FORCE_NAMES].size())
+          force.Label = DecodeMDFString_p(data[Open3DMotion::VAR_ANALOGUE_FORCE_NAMES][index]);
+        else
+          force.Label = "Force" + ToString(index+1);
+        force.Unit = "ADC";
+        force.Start = 0.0;
+        force.Frames = data[Open3DMotion::VAR_ANALOGUE_FORCE][index].size() / 2;
+        force.HardwareID = static_cast<int>(emgSections.size() + 8 * iplate + ichannel + 1);
+        force.Offset = 0.0;
+        analogs.push_back(force);
+        decoder.AppendForce(index);
+      }
+    }
+    
+    FillAcquisitionFromCodamotion_p(output, filename, markers, analogs, forcePlates, &decoder);
+  };
+  
   /**
    * @class MDFFileIOException btkMDFFileIO.h
    * @brief Exception class for the MDFFileIO class.
@@ -64,6 +374,12 @@ namespace btk
    *
    * This class uses internally the code of the library Open3DMotion (http://github.com/Open3DMotionGroup/Open3DMotion).
    *
+   * By default (see SetDecodingMode()), the sections of the file are decoded directly in the points and analog channels 
+   * of the acquisition. The samples of the markers and EMG channels are read channel by channel from the file and the 
+   * calculated data (MDR) are skipped. Open3DMotion is then only used to configure the force platforms. The mode 
+   * Open3DMotionDecoding builds first the complete trial with Open3DMotion (time sequences) and copies it in the acquisition. 
+   * It requires about twice the memory and is kept for comparison purpose.
+   *
    * @ingroup BTKIO
    */
   
@@ -77,11 +393,30 @@ namespace btk
    * Smart pointer associated with a const MDFFileIO object.
    */
   
+  /**
+   * @var MDFFileIO::DecodingMode MDFFileIO::DirectDecoding
+   * The sections of the file are decoded directly in the acquisition (default).
+   */
+  /**
+   * @var MDFFileIO::DecodingMode MDFFileIO::Open3DMotionDecoding
+   * The file is first converted in an Open3DMotion trial and then copied in the acquisition.
+   */
+  
   /**
    * @fn static MDFFileIO::Pointer MDFFileIO::New()
    * Create a MDFFileIO object an return it as a smart pointer.
    */
   
+  /**
+   * @fn DecodingMode MDFFileIO::GetDecodingMode() const
+   * Returns the way the file is decoded.
+   */
+  
+  /**
+   * @fn void MDFFileIO::SetDecodingMode(DecodingMode mode)
+   * Sets the way the file is decoded (DirectDecoding by default).
+   */
+  
   /**
    * Checks if the header corresponds to a MDF file
    */
@@ -89,7 +424,7 @@ namespace btk
   {
     Open3DMotion::MotionFileHandler handler("Biomechanical ToolKit", BTK_VERSION_STRING);
     Open3DMotion::TreeValue* readoptions = NULL;
-    std::ifstream ifs(filename.c_str(), std::ios::binary);
+    ifilestream ifs(filename.c_str(), std::ios::binary);
     Open3DMotion::FileFormatMDF ff;
     return (ifs.is_open() && ff.Probe(handler, readoptions, ifs));
   };
@@ -100,15 +435,29 @@ namespace btk
   void MDFFileIO::Read(const std::string& filename, Acquisition::Pointer output)
   {
     output->Reset();
-    std::ifstream ifs(filename.c_str(), std::ios::binary);
+    ifilestream ifs(filename.c_str(), std::ios::binary);
     ifs.exceptions(std::ios::badbit | std::ios::eofbit | std::ios::failbit);
     try
     {
       // Read data
       Open3DMotion::MotionFileHandler handler("Biomechanical ToolKit", BTK_VERSION_STRING);
-      Open3DMotion::MotionFileFormatList reduced_list;
-      reduced_list.Register(new Open3DMotion::FileFormatMDF);
-      FillAcquisitionFromOpen3DMotion_p(output, filename, ifs, handler, reduced_list);
+      if (this->m_DecodingMode == Open3DMotionDecoding)
+      {
+        Open3DMotion::MotionFileFormatList reduced_list;
+        reduced_list.Register(new Open3DMotion::FileFormatMDF);
+        FillAcquisitionFromOpen3DMotion_p(output, filename, ifs, handler, reduced_list);
+      }
+      else
+      {
+        Open3DMotion::TreeValue* readoptions = NULL;
+        if (!Open3DMotion::FileFormatMDF().Probe(handler, readoptions, ifs))
+          throw(MDFFileIOException("Invalid header key."));
+        btkSharedPtr<Open3DMotion::TreeValue> options(readoptions);
+        Open3DMotion::FileFormatOptionsMDF mdf_options;
+        mdf_options.FromTree(options.get());
+        const int version = (mdf_options.FormatVersion == Open3DMotion::FileFormatOptionsMDF::VERSION2) ? Open3DMotion::FileFormatOptionsMDF::VERSION2 : Open3DMotion::FileFormatOptionsMDF::VERSION3;
+        ReadMDFDirectly_p(output, filename, ifs, version);
+      }
     }
     catch (std::ios::failure& )
     {
@@ -160,5 +509,7 @@ namespace btk
    */
   MDFFileIO::MDFFileIO()
   : AcquisitionFileIO(AcquisitionFileIO::Binary, AcquisitionFileIO::IEEE_LittleEndian, AcquisitionFileIO::Float)
-  {};
+  {
+    this->m_DecodingMode = DirectDecoding;
+  };
 };
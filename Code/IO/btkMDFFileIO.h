@@ -57,6 +57,8 @@ namespace btk
     BTK_FILE_IO_ONLY_READ_OPERATION;
     
   public:
+    typedef enum {DirectDecoding = 0, Open3DMotionDecoding} DecodingMode;
+    
     typedef btkSharedPtr<MDFFileIO> Pointer;
     typedef btkSharedPtr<const MDFFileIO> ConstPointer;
     
@@ -64,6 +66,9 @@ namespace btk
     
     // ~MDFFileIO(); // Implicit.
     
+    DecodingMode GetDecodingMode() const {return this->m_DecodingMode;};
+    void SetDecodingMode(DecodingMode mode) {this->m_DecodingMode = mode;};
+    
     BTK_IO_EXPORT virtual bool CanReadFile(const std::string& filename);
     BTK_IO_EXPORT virtual void Read(const std::string& filename, Acquisition::Pointer output);
     
@@ -73,6 +78,8 @@ namespace btk
   private:
     MDFFileIO(const MDFFileIO& ); // Not implemented.
     MDFFileIO& operator=(const MDFFileIO& ); // Not implemented. 
+    
+    DecodingMode m_DecodingMode;
    };
 };
 
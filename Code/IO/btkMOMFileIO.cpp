@@ -35,6 +35,7 @@
 
 #include "btkMOMFileIO.h"
 #include "btkEliteFileIOUtils_p.h"
+#include "btkFileStream.h"
 
 #include <algorithm>
 #include <cctype>
@@ -95,7 +96,7 @@ namespace btk
     std::string::size_type MOMPos = lowercase.rfind(".mom");
     if ((MOMPos != std::string::npos) && (MOMPos == lowercase.length() - 4))
     {
-      std::ifstream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+      ifilestream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
       if (!ifs)
         return false;
       ifs.close();
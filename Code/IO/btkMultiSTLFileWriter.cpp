@@ -37,8 +37,41 @@
 #include "btkBinaryFileStream.h"
 #include "btkConvert.h"
 
+#include <cstring>
+#include <cmath>
+
 namespace btk
 {
+  // Little endian encoding independent of the host (IEEE 754 floats expected).
+  static inline void EncodeSTLInteger(int32_t value, uint8_t* data)
+  {
+    const uint32_t u = static_cast<uint32_t>(value);
+    data[0] = static_cast<uint8_t>(u);
+    data[1] = static_cast<uint8_t>(u >> 8);
+    data[2] = static_cast<uint8_t>(u >> 16);
+    data[3] = static_cast<uint8_t>(u >> 24);
+  };
+  
+  static inline void EncodeSTLFloat(float value, uint8_t* data)
+  {
+    int32_t i;
+    memcpy(&i, &value, 4);
+    EncodeSTLInteger(i, data);
+  };
+  
+  // coords: normal (3 values, computed) followed by the coordinates of the 3 vertices.
+  static inline void ComputeSTLNormal(float* coords)
+  {
+    const float u[3] = {coords[6] - coords[3], coords[7] - coords[4], coords[8] - coords[5]};
+    const float v[3] = {coords[9] - coords[3], coords[10] - coords[4], coords[11] - coords[5]};
+    float n[3] = {u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0]};
+    const float norm = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    const float scale = (norm > 0.0f) ? 1.0f / norm : 0.0f;
+    coords[0] = n[0] * scale;
+    coords[1] = n[1] * scale;
+    coords[2] = n[2] * scale;
+  };
+  
   /**
    * @class MultiSTLFileWriterException btkMultiSTLFileWriter.h
    * @brief Exception class for the MultiSTLFileWriter class.
@@ -66,6 +99,11 @@ namespace btk
    * will generate the following files: '/Users/jdoe/Data/FaceScan_1.stl' ... '/Users/jdoe/Data/FaceScan_30.stl'
    *
    * You can export only a subset of the acquisition by specifying the frames of interest using the method SetFramesOfInterest().
+   * By default, the normal of each face is set to 0 and computed by the viewer program. Use the method SetNormalsComputed() 
+   * to store the normals in the files.
+   *
+   * Each frame is encoded in a memory buffer and written in one block. When BTK is compiled with OpenMP 
+   * (option BTK_USE_OPENMP), the frames are exported in parallel.
    *
    * @ingroup BTKIO
    */
@@ -153,6 +191,23 @@ namespace btk
     }
   };
   
+  /**
+   * @fn bool MultiSTLFileWriter::GetNormalsComputed() const
+   * Returns true if the normal of the faces are computed and stored in the files.
+   */
+  
+  /**
+   * Sets the computation of the normal of the faces (disabled by default). When disabled, the normals are set to 0.
+   */
+  void MultiSTLFileWriter::SetNormalsComputed(bool computed)
+  {
+    if (this->m_NormalsComputed != computed)
+    {
+      this->m_NormalsComputed = computed;
+      this->Modified();
+    }
+  };
+  
   /**
    * Constructor. Sets the number of outputs equal to one. No input.
    */
@@ -161,6 +216,7 @@ namespace btk
   {
     this->m_FOI[0] = -1;
     this->m_FOI[1] = -1;
+    this->m_NormalsComputed = false;
     this->SetInputNumber(1);
   };
   
@@ -209,51 +265,93 @@ namespace btk
     if (!mesh->ConnectPoints(acquisition->GetPoints()))
       throw MultiSTLFileWriterException("Marker index out of range.");
     
+    // Gather the coordinates of the vertices and the vertices of the faces.
+    // The frames are then encoded independently of the current frame of the mesh.
+    std::vector<const double*> values(mesh->GetVertexNumber());
+    std::vector<const double*> residuals(mesh->GetVertexNumber());
+    std::vector<Point::ConstPointer> points(acquisition->BeginPoint(), acquisition->EndPoint()); // Read-only access to not copy the shared values
+    for (TriangleMesh::VertexConstIterator it = mesh->BeginVertex() ; it != mesh->EndVertex() ; ++it)
+    {
+      values[it->GetRelativeId()] = points[it->GetId()]->GetValues().data();
+      residuals[it->GetRelativeId()] = points[it->GetId()]->GetResiduals().data();
+    }
+    std::vector<int> faces;
+    faces.reserve(3 * mesh->GetFaceNumber());
+    for (TriangleMesh::FaceConstIterator it = mesh->BeginFace() ;  it != mesh->EndFace() ; ++it)
+    {
+      faces.push_back(it->GetVertex1()->GetRelativeId());
+      faces.push_back(it->GetVertex2()->GetRelativeId());
+      faces.push_back(it->GetVertex3()->GetRelativeId());
+    }
+    const int faceNumber = static_cast<int>(faces.size() / 3);
+    const int rows = acquisition->GetPointFrameNumber();
+    
     int num = btkNumberOfDigits(lf);
+    std::string header = "STL binary file generated by BTK " + std::string(BTK_VERSION_STRING);
+    header.resize(80);
+    // Frames not written (0: written, 1: no file access, 2: error during the writing).
+    std::vector<int> status(lf - ff + 1, 0);
     try
-    { 
-      IEEELittleEndianBinaryFileStream obfs;
-      for (int i = ff ; i <= lf ; ++i)
+    {
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
       {
-        std::stringstream filename("");
-        filename << this->m_FilePrefix << std::setw(num) << std::setfill('0') << i << ".stl";
-        obfs.Open(filename.str(), BinaryFileStream::Out | BinaryFileStream::Truncate);
-        if (!obfs.IsOpen())
-          throw(MultiSTLFileWriterException("No File access. Are you sure of the path? Have you the right privileges?"));
-        std::string header = "STL binary file generated by BTK " + std::string(BTK_VERSION_STRING);
-        header.resize(80);
-        obfs.Write(header);
-        obfs.Write((int32_t)0); // Fake number of triangles
-        mesh->SetCurrentFrameIndex(i - acquisition->GetFirstFrame());
-        int32_t validFaceNumber = 0;
-        for (TriangleMesh::FaceConstIterator it = mesh->BeginFace() ;  it != mesh->EndFace() ; ++it)
+        // Each thread has its own buffer and its own stream.
+        std::vector<uint8_t> buffer;
+        IEEELittleEndianBinaryFileStream obfs;
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic)
+#endif
+        for (int i = ff ; i <= lf ; ++i)
         {
-          if (!it->IsValid())
+          const int frame = i - acquisition->GetFirstFrame();
+          buffer.resize(84 + 50 * faceNumber);
+          uint8_t* data = &buffer[0] + 84;
+          int32_t validFaceNumber = 0;
+          for (int j = 0 ; j < faceNumber ; ++j)
+          {
+            const int* ids = &faces[3*j];
+            if ((residuals[ids[0]][frame] < 0.0) || (residuals[ids[1]][frame] < 0.0) || (residuals[ids[2]][frame] < 0.0))
+              continue;
+            float coords[12];
+            for (int k = 0 ; k < 3 ; ++k)
+            {
+              for (int c = 0 ; c < 3 ; ++c)
+                coords[3+3*k+c] = static_cast<float>(values[ids[k]][frame + c * rows]);
+            }
+            if (this->m_NormalsComputed)
+              ComputeSTLNormal(coords);
+            else // Normal vector: set to 0 => Will be computed by the viewer program
+              coords[0] = coords[1] = coords[2] = 0.0f;
+            for (int k = 0 ; k < 12 ; ++k)
+              EncodeSTLFloat(coords[k], data + 4*k);
+            data[48] = 0; data[49] = 0; // Attribute byte count
+            data += 50;
+            ++validFaceNumber;
+          }
+          std::copy(header.begin(), header.end(), buffer.begin());
+          EncodeSTLInteger(validFaceNumber, &buffer[80]);
+          std::stringstream filename("");
+          filename << this->m_FilePrefix << std::setw(num) << std::setfill('0') << i << ".stl";
+          obfs.Open(filename.str(), BinaryFileStream::Out | BinaryFileStream::Truncate);
+          if (!obfs.IsOpen())
+          {
+            status[i - ff] = 1;
             continue;
-          // Normal vector: set to 0 => Will be computed by the viewer program
-          obfs.Write(0.0f);
-          obfs.Write(0.0f);
-          obfs.Write(0.0f);
-          // Vertex 1
-          obfs.Write(static_cast<float>(it->GetVertex1()->GetCoordinateX()));
-          obfs.Write(static_cast<float>(it->GetVertex1()->GetCoordinateY()));
-          obfs.Write(static_cast<float>(it->GetVertex1()->GetCoordinateZ()));
-          // Vertex 2
-          obfs.Write(static_cast<float>(it->GetVertex2()->GetCoordinateX()));
-          obfs.Write(static_cast<float>(it->GetVertex2()->GetCoordinateY()));
-          obfs.Write(static_cast<float>(it->GetVertex2()->GetCoordinateZ()));
-          // Vertex 3
-          obfs.Write(static_cast<float>(it->GetVertex3()->GetCoordinateX()));
-          obfs.Write(static_cast<float>(it->GetVertex3()->GetCoordinateY()));
-          obfs.Write(static_cast<float>(it->GetVertex3()->GetCoordinateZ()));
-          // Attribute byte count
-          obfs.Write((uint16_t)0);
-          ++validFaceNumber;
+          }
+          obfs.Write(84 + 50 * validFaceNumber, &buffer[0]);
+          if (!obfs.Good())
+            status[i - ff] = 2;
+          obfs.Close();
         }
-        // Write the true number of triangles
-        obfs.SeekRead(80, BinaryFileStream::Begin);
-        obfs.Write(validFaceNumber);
-        obfs.Close();
+      }
+      for (size_t i = 0 ; i < status.size() ; ++i)
+      {
+        if (status[i] == 1)
+          throw(MultiSTLFileWriterException("No File access. Are you sure of the path? Have you the right privileges?"));
+        else if (status[i] == 2)
+          throw(MultiSTLFileWriterException("Error during the writing of the frame #" + ToString(ff + i) + "."));
       }
     }
     catch (MultiSTLFileWriterException& )
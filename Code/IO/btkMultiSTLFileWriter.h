@@ -75,6 +75,9 @@ namespace btk
     const int* GetFramesOfInterest() const {return this->m_FOI;};
     void GetFramesOfInterest(int& ff, int& lf) const {ff = this->m_FOI[0]; lf = this->m_FOI[1];};
     BTK_IO_EXPORT void SetFramesOfInterest(int ff = -1, int lf = -1);
+    
+    bool GetNormalsComputed() const {return this->m_NormalsComputed;};
+    BTK_IO_EXPORT void SetNormalsComputed(bool computed);
   
   protected:
     BTK_IO_EXPORT MultiSTLFileWriter();
@@ -88,6 +91,7 @@ namespace btk
     
     std::string m_FilePrefix;
     int m_FOI[2];
+    bool m_NormalsComputed;
   };
 };
 
@@ -35,6 +35,7 @@
 
 #include "btkPWRFileIO.h"
 #include "btkEliteFileIOUtils_p.h"
+#include "btkFileStream.h"
 
 #include <algorithm>
 #include <cctype>
@@ -91,7 +92,7 @@ namespace btk
     std::string::size_type PWRPos = lowercase.rfind(".pwr");
     if ((PWRPos != std::string::npos) && (PWRPos == lowercase.length() - 4))
     {
-      std::ifstream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+      ifilestream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
       if (!ifs)
         return false;
       ifs.close();
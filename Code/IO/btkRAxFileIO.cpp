@@ -35,6 +35,7 @@
 
 #include "btkRAxFileIO.h"
 #include "btkEliteFileIOUtils_p.h"
+#include "btkFileStream.h"
 
 #include <algorithm>
 #include <cctype>
@@ -90,7 +91,7 @@ namespace btk
     std::string::size_type RAxPos = lowercase.rfind(".ra");
     if ((RAxPos != std::string::npos) && (RAxPos == lowercase.length() - 4)  && ((*(lowercase.rbegin()) == 'h') || (*(lowercase.rbegin()) == 'w')))
     {
-      std::ifstream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+      ifilestream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
       if (!ifs)
         return false;
       ifs.close();
@@ -36,6 +36,7 @@
 #include "btkRICFileIO.h"
 #include "btkEliteFileIOUtils_p.h"
 #include "btkLogger.h"
+#include "btkFileStream.h"
 
 #include <algorithm>
 #include <cctype>
@@ -91,7 +92,7 @@ namespace btk
     std::string::size_type RIxPos = lowercase.substr(0,lowercase.length()-1).rfind(".ri");
     if ((RIxPos != std::string::npos) && (RIxPos == lowercase.length() - 4) && ((*(lowercase.rbegin()) == 'c') || (*(lowercase.rbegin()) == 'f')))
     {
-      std::ifstream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+      ifilestream ifs(filename.c_str(), std::ios_base::in | std::ios_base::binary);
       if (!ifs)
         return false;
       ifs.close();
@@ -46,6 +46,140 @@ namespace btk
 {
   static const uint32_t TDFKey[4] = {0x41604B82, 0xCA8411D3, 0xACB60060, 0x080C6816};
   
+  // Only the following blocks are extracted from the TDF format:
+  enum {
+    MarkerBlockId = 5,         // - block ID #5: Markers data
+    PlatformDataBlockId = 9,   // - block ID #9: Force platform data
+    PlatformConfigBlockId = 7, // - block ID #7: Force platform configuration (corners)
+    EMGBlockId = 11            // - block ID #11: EMG data
+  };
+  // The block "Force3D" (ID 12) is not extracted as its content can be reconstructed using force platform filters 
+  
+  typedef Eigen::Map<const Eigen::Matrix<float,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > TDFSamples;
+  
+  // Read in one block @a numSamples samples composed each of @a numComponents floats.
+  static const float* TDFReadSamples(IEEELittleEndianBinaryFileStream* bifs, int numSamples, int numComponents, std::vector<float>* buffer)
+  {
+    if ((numSamples <= 0) || (numComponents <= 0))
+      return 0;
+    buffer->resize(numSamples * numComponents);
+    bifs->ReadFloat(buffer->size(), &((*buffer)[0]));
+    return &((*buffer)[0]);
+  };
+  
+  // Read the description of the segments (first frame and number of frames of each segment).
+  // The segments come from the file and must be contained in the @a numFrames frames of the block.
+  static std::vector<int32_t> TDFReadSegments(IEEELittleEndianBinaryFileStream* bifs, int32_t numFrames)
+  {
+    int32_t numSegments = bifs->ReadI32();
+    bifs->SeekRead(4, BinaryFileStream::Current);
+    if (numSegments < 0)
+      throw(TDFFileIOException("Invalid number of segments."));
+    std::vector<int32_t> segments = bifs->ReadI32(2*numSegments);
+    for (size_t i = 0 ; i < segments.size() ; i+=2)
+    {
+      if ((segments[i] < 0) || (segments[i+1] < 0) || (segments[i+1] > numFrames - segments[i]))
+        throw(TDFFileIOException("Invalid segment. Its frames are out of the block."));
+    }
+    return segments;
+  };
+  
+  // De-interleave @a numSamples samples into the given analog channels starting at the frame @a offset.
+  static void TDFDispatchSamples(const float* samples, int numSamples, const std::vector<Analog::Pointer>& channels, int offset)
+  {
+    if (numSamples <= 0)
+      return;
+    const int numChannels = static_cast<int>(channels.size());
+    TDFSamples data(samples, numSamples, numChannels);
+    for (int i = 0 ; i < numChannels ; ++i)
+      channels[i]->GetValues().segment(offset, numSamples) = data.col(i).cast<double>();
+  };
+  
+  typedef Eigen::Map<Eigen::Matrix<float,Eigen::Dynamic,Eigen::Dynamic,Eigen::RowMajor> > TDFOutputSamples;
+  
+  // The lengths are stored in meters and the moments in newton meters.
+  static float TDFUnitScale(const std::string& unit)
+  {
+    return ((unit == "mm") || (unit == "Nmm")) ? 0.001f : 1.0f;
+  };
+  
+  // Write a label on 256 bytes (null terminated).
+  static size_t TDFWriteLabel(IEEELittleEndianBinaryFileStream* bofs, const std::string& label)
+  {
+    std::string str = label.substr(0, 255);
+    str.resize(256, 0x00);
+    return bofs->Write(str);
+  };
+  
+  // Write the segments' description (number of segments, padding, first frame and number of frames of each segment).
+  static size_t TDFWriteSegments(IEEELittleEndianBinaryFileStream* bofs, const std::vector<int32_t>& segments)
+  {
+    bofs->Write(static_cast<int32_t>(segments.size() / 2));
+    bofs->Fill(4);
+    bofs->Write(segments);
+    return 8 + 4 * segments.size();
+  };
+  
+  // Extract the analog channels of the force platforms of type I in the order used in the TDF format (PX, PY, FX, FY, FZ, MZ) and their corners (in meters).
+  static void TDFExtractForcePlatforms(const std::string& filename, Acquisition::Pointer input, const std::vector<Analog::ConstPointer>& analogs, std::vector<Analog::ConstPointer>* channels, std::vector<float>* corners, std::vector<bool>* assigned)
+  {
+    MetaData::ConstIterator itFP = input->GetMetaData()->FindChild("FORCE_PLATFORM");
+    if (itFP == input->GetMetaData()->End())
+      return;
+    MetaData::ConstIterator itUsed = (*itFP)->FindChild("USED");
+    if ((itUsed == (*itFP)->End()) || !(*itUsed)->HasInfo())
+      return;
+    const int numPFs = (*itUsed)->GetInfo()->ToInt(0);
+    MetaData::ConstIterator itChannel = (*itFP)->FindChild("CHANNEL");
+    if ((itChannel == (*itFP)->End()) || !(*itChannel)->HasInfo() || ((*itChannel)->GetInfo()->GetDimensions().size() != 2))
+    {
+      if (numPFs != 0)
+      {
+        btkWarningMacro(filename, "Wrong format for the FORCE_PLATFORM::CHANNEL entry. The channels of the force platforms are exported as EMG channels.");
+      }
+      return;
+    }
+    const int step = (*itChannel)->GetInfo()->GetDimension(0);
+    std::vector<int> channelsIndex = (*itChannel)->GetInfo()->ToInt();
+    std::vector<int> types(numPFs, 1);
+    MetaData::ConstIterator itType = (*itFP)->FindChild("TYPE");
+    if ((itType != (*itFP)->End()) && (*itType)->HasInfo())
+      (*itType)->GetInfo()->ToInt(types);
+    std::vector<float> cornersData;
+    MetaData::ConstIterator itCorners = (*itFP)->FindChild("CORNERS");
+    if ((itCorners != (*itFP)->End()) && (*itCorners)->HasInfo())
+      (*itCorners)->GetInfo()->ToFloat(cornersData);
+    const float scale = TDFUnitScale(input->GetPointUnit(Point::Marker));
+    // Index of the channels FX, FY, FZ, PX, PY, MZ (type I) in the order used in the TDF format.
+    static const int order[6] = {3, 4, 0, 1, 2, 5};
+    for (int i = 0 ; i < numPFs ; ++i)
+    {
+      bool valid = (i < static_cast<int>(types.size())) && (types[i] == 1) && (step >= 6) && (static_cast<int>(channelsIndex.size()) >= (i + 1) * step);
+      int indices[6];
+      for (int c = 0 ; valid && (c < 6) ; ++c)
+      {
+        indices[c] = channelsIndex[i * step + order[c]] - 1;
+        valid = (indices[c] >= 0) && (indices[c] < static_cast<int>(analogs.size())) && !(*assigned)[indices[c]];
+      }
+      if (!valid)
+      {
+        btkWarningMacro(filename, "Only the force platforms of type I can be exported in a TDF file. The channels of the force platform #" + ToString(i + 1) + " are exported as EMG channels.");
+        continue;
+      }
+      for (int c = 0 ; c < 6 ; ++c)
+      {
+        channels->push_back(analogs[indices[c]]);
+        (*assigned)[indices[c]] = true;
+      }
+      // The corners are not in the same order than the one used in BTK (rotation of 180 degrees).
+      for (int j = 0 ; j < 12 ; ++j)
+      {
+        const int idx = i * 12 + (j + 6) % 12;
+        corners->push_back((idx < static_cast<int>(cornersData.size())) ? cornersData[idx] * scale : 0.0f);
+      }
+    }
+  };
+  
   /**
    * @class TDFFileIOException btkTDFFileIO.h
    * @brief Exception class for the TDFFileIO class.
@@ -63,11 +197,44 @@ namespace btk
   
   /**
    * @class TDFFileIO btkTDFFileIO.h
-   * @brief Interface to read/write ANG files.
+   * @brief Interface to read/write TDF files.
    *
+   * The data of each block are read in one step (segment by segment or for all the frames) 
+   * and then de-interleaved directly in the analog channels and points of the acquisition.
+   *
+   * The writer exports the markers (block ID #5), the force platforms of type I (blocks ID #7 and #9) 
+   * and the other analog channels (block ID #11). The content of each block is interleaved in memory 
+   * and written in one step. The coordinates and the lengths are converted in meters.
+   *
+   * By default, all the supported blocks are read. You can use the method SetBlocksToRead() to 
+   * extract only some of them (e.g. only the EMG block). The other blocks are not parsed.
    *
    * @ingroup BTKIO
    */
+  /**
+   * @enum TDFFileIO::Block
+   * Blocks which can be extracted from a TDF file.
+   */
+  /**
+   * @var TDFFileIO::Block TDFFileIO::MarkerBlock
+   * Markers data (block ID #5).
+   */
+  /**
+   * @var TDFFileIO::Block TDFFileIO::PlatformConfigBlock
+   * Force platform configuration (block ID #7).
+   */
+  /**
+   * @var TDFFileIO::Block TDFFileIO::PlatformDataBlock
+   * Force platform data (block ID #9).
+   */
+  /**
+   * @var TDFFileIO::Block TDFFileIO::EMGBlock
+   * EMG data (block ID #11).
+   */
+  /**
+   * @var TDFFileIO::Block TDFFileIO::AllBlocks
+   * All the supported blocks.
+   */
   
   /**
    * @typedef TDFFileIO::Pointer
@@ -84,6 +251,16 @@ namespace btk
    * Create a TDFFileIO object an return it as a smart pointer.
    */
   
+  /**
+   * @fn int TDFFileIO::GetBlocksToRead() const
+   * Returns the blocks extracted during the reading (combination of TDFFileIO::Block values).
+   */
+  
+  /**
+   * @fn void TDFFileIO::SetBlocksToRead(int blocks)
+   * Sets the blocks to extract during the reading (combination of TDFFileIO::Block values).
+   */
+  
   /**
    * Only check if the file extension correspond to ANG.
    */
@@ -97,6 +274,20 @@ namespace btk
     return isReadable;
   };
   
+  /**
+   * Checks if the suffix of @a filename is TDF.
+   */
+  bool TDFFileIO::CanWriteFile(const std::string& filename)
+  {
+    std::string lowercase = filename;
+    std::transform(lowercase.begin(), lowercase.end(), lowercase.begin(), tolower);
+    std::string::size_type TDFPos = lowercase.rfind(".tdf");
+    if ((TDFPos != std::string::npos) && (TDFPos == lowercase.length() - 4))
+      return true;
+    else
+      return false;
+  };
+  
   /**
    * Read the file designated by @a filename and fill @a output.
    */
@@ -125,19 +316,12 @@ namespace btk
         be.format = bifs.ReadU32();
         be.offset = bifs.ReadI32();
         be.size = bifs.ReadI32();
-        blockEntries.push_back(be);
+        // Only the selected blocks are kept. The others are never parsed.
+        if (this->IsBlockSelected(be.type))
+          blockEntries.push_back(be);
         nextEntryOffset = 272; // 16 + 256
       }
       
-      // Only the following blocks are extracted from the TDF format:
-      enum {
-        MarkerBlockId = 5,         // - block ID #5: Markers data
-        PlatformDataBlockId = 9,   // - block ID #9: Force platform data
-        PlatformConfigBlockId = 7, // - block ID #7: Force platform configuration (corners)
-        EMGBlockId = 11,           // - block ID #11: EMG data
-      };
-      // The block "Force3D" (ID 12) is not extracted as its content can be reconstructed using force platform filters 
-      
       // Check if the acquisition's data are consistent between them, and initialize the output
       bool MarkerBlockFound = false;
       bool FPBlockFound = false;
@@ -258,6 +442,7 @@ namespace btk
       // ------------------------------------------------------------------- //
       //                              Markers
       // ------------------------------------------------------------------- //
+      std::vector<float> buffer;
       if ((be = this->SeekToBlock(&bifs, &blockEntries, MarkerBlockId)) != 0)
       {
         // No need to read the header?
@@ -283,21 +468,17 @@ namespace btk
             // Extract label
             std::string label = bifs.ReadString(256);
             (*it)->SetLabel(this->CleanLabel(label));
-            // Extract data
-            int32_t numSegments = bifs.ReadI32();
-            bifs.SeekRead(4, BinaryFileStream::Current);
-            std::vector<int32_t> segments = bifs.ReadI32(2*numSegments);
-            
+            // Extract data (one contiguous block of coordinates by segment)
+            std::vector<int32_t> segments = TDFReadSegments(&bifs, numMarkerFrames);
             for (size_t i = 0 ; i < segments.size() ; i+=2)
             {
               const int32_t shift = segments[i] + markerFirstframe - firstframe;
-              for (int32_t j = 0 ; j < segments[i+1] ; ++j)
-              {
-                double x = bifs.ReadFloat();
-                double y = bifs.ReadFloat();
-                double z = bifs.ReadFloat();
-                (*it)->SetDataSlice(j + shift, x, y, z); // Residual is set to 0 by default.
-              }
+              const float* samples = TDFReadSamples(&bifs, segments[i+1], 3, &buffer);
+              const int32_t num = std::min(segments[i+1], numFrames - shift);
+              if (num <= 0)
+                continue;
+              (*it)->GetValues().block(shift, 0, num, 3) = TDFSamples(samples, segments[i+1], 3).topRows(num).cast<double>();
+              (*it)->GetResiduals().segment(shift, num).setZero();
             }
           }
         }
@@ -310,20 +491,19 @@ namespace btk
             std::string label = bifs.ReadString(256);
             (*it)->SetLabel(this->CleanLabel(label));
           }
-          // Extract data
-          for (int i = 0 ; i < numMarkerFrames ; ++i)
+          // Extract data (all the frames in one block)
+          const float* samples = TDFReadSamples(&bifs, numMarkerFrames, numMarkers * 3, &buffer);
+          const int32_t shift = markerFirstframe - firstframe;
+          const int32_t num = std::min(numMarkerFrames, numFrames - shift);
+          int inc = 0;
+          for (Acquisition::PointIterator it = output->BeginPoint() ; it != output->EndPoint() ; ++it)
           {
-            const int32_t idx = i + markerFirstframe - firstframe;
-            for (Acquisition::PointIterator it = output->BeginPoint() ; it != output->EndPoint() ; ++it)
-            {
-              double x = bifs.ReadFloat();
-              double y = bifs.ReadFloat();
-              double z = bifs.ReadFloat();
-              if ((x == 0.0) && (y == 0.0) && (z == 0.0))
-                (*it)->SetDataSlice(idx, x, y, z, -1.0);
-              else
-                (*it)->SetDataSlice(idx, x, y, z);
-            }
+            Eigen::Map<const Eigen::Matrix<float,Eigen::Dynamic,3,Eigen::RowMajor>, Eigen::Unaligned, Eigen::OuterStride<> > coords(samples + inc, num, 3, Eigen::OuterStride<>(numMarkers * 3));
+            (*it)->GetValues().block(shift, 0, num, 3) = coords.cast<double>();
+            Point::Residuals& res = (*it)->GetResiduals();
+            for (int32_t i = 0 ; i < num ; ++i)
+              res.coeffRef(i + shift) = (coords.row(i).array() == 0.0f).all() ? -1.0 : 0.0;
+            inc += 3;
           }
         }
         // - Unknown
@@ -340,284 +520,80 @@ namespace btk
         // No need to extract the number of platform, the sample frequency, the start time and the number of samples.
         bifs.SeekRead(16, BinaryFileStream::Current); 
         bifs.SeekRead(numPFs*2, BinaryFileStream::Current); // Need of the map?
-        // Data
-        const int32_t shift = (FPFirstframe - firstframe) * analogSampleNumberPerPointFrame;
-        // One force platform - by analog channels
-        if ((be->format == 1) || (be->format == 3))
+        // Description of the format:
+        //  - 1, 3, 5, 7: By analog channels (force platform by force platform)
+        //  - 2, 4, 6, 8: By frames
+        //  - 3, 4, 7, 8: With the label of the force platforms
+        //  - 5, 6, 7, 8: Two wrenches by force platform
+        if ((be->format < 1) || (be->format > 8))
+          throw(TDFFileIOException("Unknown format for the PlatformData block"));
+        const bool byChannels = ((be->format % 2) == 1);
+        const bool withLabels = ((be->format == 3) || (be->format == 4) || (be->format == 7) || (be->format == 8));
+        FPDoubleFormat = (be->format >= 5);
+        if ((be->format == 5) || (be->format == 7))
         {
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            // Label of the force plateform (skipped)
-            if (be->format == 3)
-              bifs.SeekRead(256, BinaryFileStream::Current);
-            // Label for each analog channel
-            // Map the analog channels to fit with the force platform type I
-            std::list<Analog::Pointer> analogMap;
-            Acquisition::AnalogIterator it = output->BeginAnalog();
-            std::advance(it, p*6);
-            std::string strIdx = ToString(p+1);
-            (*it)->SetLabel("PX" + strIdx); (*it)->SetUnit("m"); analogMap.push_back(*it); ++it;
-            (*it)->SetLabel("PY" + strIdx); (*it)->SetUnit("m"); analogMap.push_back(*it); ++it;
-            (*it)->SetLabel("FX" + strIdx); (*it)->SetUnit("N"); analogMap.push_back(*it); ++it;
-            (*it)->SetLabel("FY" + strIdx); (*it)->SetUnit("N"); analogMap.push_back(*it); ++it;
-            (*it)->SetLabel("FZ" + strIdx); (*it)->SetUnit("N"); analogMap.push_back(*it); ++it;
-            (*it)->SetLabel("MZ" + strIdx); (*it)->SetUnit("Nm"); analogMap.push_back(*it); ++it;
-            // Extract data
-            int32_t numSegments = bifs.ReadI32();
-            bifs.SeekRead(4, BinaryFileStream::Current);
-            std::vector<int32_t> segments = bifs.ReadI32(2*numSegments);
-            for (size_t i = 0 ; i < segments.size() ; i+=2)
-            {
-              for (int32_t j = segments[i] ; j < segments[i]+segments[i+1] ; ++j)
-              {
-                std::vector<float> data = bifs.ReadFloat(6);
-                if (j + shift < numAnalogFrames)
-                {
-                  int k = 0;
-                  for (Acquisition::AnalogIterator it = analogMap.begin() ; it != analogMap.end() ; ++it)
-                    (*it)->SetDataSlice(j + shift, data[k++]);
-                }
-              }
-            }
-          }
+          btkWarningMacro(filename, "The use of two wrenches by force platform is partially supported. Please contact the developers to improve this part.");
         }
-        // One force platform - by frames
-        else if ((be->format == 2) || (be->format == 4))
+        else if ((be->format == 6) || (be->format == 8))
         {
-          // Label of the force plateform (skipped)
-          if (be->format == 4)
-            bifs.SeekRead(numPFs * 256, BinaryFileStream::Current);
-          // Label for each analog channel
-          // Map the analog channels to fit with the force platform type I
-          std::list<Analog::Pointer> analogMap;
-          Acquisition::AnalogIterator it;
-          it = output->BeginAnalog();
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("PX" + ToString(p+1));
-            (*it)->SetUnit("m"); 
-            analogMap.push_back(*it);
-            std::advance(it, 6);
-          }
-          it = output->BeginAnalog(); std::advance(it, 1);
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("PY" + ToString(p+1));
-            (*it)->SetUnit("m"); 
-            analogMap.push_back(*it);
-            std::advance(it, 6);
-          }
-          it = output->BeginAnalog(); std::advance(it, 2);
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("FX" + ToString(p+1));
-            (*it)->SetUnit("N"); 
-            analogMap.push_back(*it);
-            std::advance(it, 6);
-          }
-          it = output->BeginAnalog(); std::advance(it, 3);
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("FY" + ToString(p+1));
-            (*it)->SetUnit("N"); 
-            analogMap.push_back(*it);
-            std::advance(it, 6);
-          }
-          it = output->BeginAnalog(); std::advance(it, 4);
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("FZ" + ToString(p+1));
-            (*it)->SetUnit("N"); 
-            analogMap.push_back(*it);
-            std::advance(it, 6);
-          }
-          it = output->BeginAnalog(); std::advance(it, 5);
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("MZ" + ToString(p+1));
-            (*it)->SetUnit("Nm"); 
-            analogMap.push_back(*it);
-            std::advance(it, 6);
-          }
-          // Extract data
-          const int32_t shift = (FPFirstframe - firstframe) * analogSampleNumberPerPointFrame;
-          int32_t numPFFramesFinal = numPFFrames - shift;
-          numPFFramesFinal = (numPFFramesFinal >= numAnalogFrames) ? numAnalogFrames : numPFFramesFinal;
-          for (int i = 0 ; i < numPFFramesFinal ; ++i)
+          btkErrorMacro("The use of two wrenches by force platform is partially supported. Please contact the developers to improve this part.");
+        }
+        // Label for each analog channel
+        // Map the analog channels to fit with the force platform type I
+        static const char* labels[6] = {"PX", "PY", "FX", "FY", "FZ", "MZ"};
+        static const char* units[6] = {"m", "m", "N", "N", "N", "Nm"};
+        const int numComponents = FPDoubleFormat ? 12 : 6;
+        std::vector<Analog::Pointer> analogs(numPFs * numComponents);
+        Acquisition::AnalogIterator it = output->BeginAnalog();
+        for (int p = 0 ; p < numPFs ; ++p)
+        {
+          std::string strIdx = ToString(p+1);
+          if (FPDoubleFormat)
+            strIdx = (byChannels ? ToString(p*2+1) : strIdx) + "a";
+          for (int c = 0 ; c < numComponents ; ++c)
           {
-            for (Acquisition::AnalogIterator it = analogMap.begin() ; it != analogMap.end() ; ++it)
-              (*it)->SetDataSlice(i + shift, bifs.ReadFloat());
+            if (c == 6)
+              strIdx[strIdx.length()-1] = 'b';
+            (*it)->SetLabel(labels[c % 6] + strIdx);
+            (*it)->SetUnit(units[c % 6]);
+            analogs[p * numComponents + c] = *it;
+            ++it;
           }
         }
-        // Two force platforms - by analog channels
-        else if ((be->format == 5) || (be->format == 7))
+        // Extract data
+        const int32_t shift = (FPFirstframe - firstframe) * analogSampleNumberPerPointFrame;
+        if (byChannels)
         {
-          btkWarningMacro(filename, "The use of two wrenches by force platform is partially supported. Please contact the developers to improve this part.");
-          FPDoubleFormat = true;
           for (int p = 0 ; p < numPFs ; ++p)
           {
             // Label of the force plateform (skipped)
-            if (be->format == 7)
+            if (withLabels)
               bifs.SeekRead(256, BinaryFileStream::Current);
-            // Label for each analog channel
-            // Map the analog channels to fit with the force platform type I
-            std::list<Analog::Pointer> analogMap;
-            Acquisition::AnalogIterator it = output->BeginAnalog();
-            std::advance(it, p*12);
-            std::string strIdx = ToString(p*2+1) + "a";
-            (*it)->SetLabel("PX" + strIdx); (*it)->SetUnit("m"); analogMap.push_back(*it); ++it;
-            (*it)->SetLabel("PY" + strIdx); (*it)->SetUnit("m"); analogMap.push_back(*it); ++it;
-            (*it)->SetLabel("FX" + strIdx); (*it)->SetUnit("N"); analogMap.push_back(*it); ++it;
-            (*it)->SetLabel("FY" + strIdx); (*it)->SetUnit("N"); analogMap.push_back(*it); ++it;
-            (*it)->SetLabel("FZ" + strIdx); (*it)->SetUnit("N"); analogMap.push_back(*it); ++it;
-            (*it)->SetLabel("MZ" + strIdx); (*it)->SetUnit("Nm"); analogMap.push_back(*it); ++it;
-            strIdx[strIdx.length()-1] = 'b';
-            (*it)->SetLabel("PX" + strIdx); (*it)->SetUnit("m"); analogMap.push_back(*it); ++it;
-            (*it)->SetLabel("PY" + strIdx); (*it)->SetUnit("m"); analogMap.push_back(*it); ++it;
-            (*it)->SetLabel("FX" + strIdx); (*it)->SetUnit("N"); analogMap.push_back(*it); ++it;
-            (*it)->SetLabel("FY" + strIdx); (*it)->SetUnit("N"); analogMap.push_back(*it); ++it;
-            (*it)->SetLabel("FZ" + strIdx); (*it)->SetUnit("N"); analogMap.push_back(*it); ++it;
-            (*it)->SetLabel("MZ" + strIdx); (*it)->SetUnit("Nm"); analogMap.push_back(*it); ++it;
-            // Extract data
-            int32_t numSegments = bifs.ReadI32();
-            bifs.SeekRead(4, BinaryFileStream::Current);
-            std::vector<int32_t> segments = bifs.ReadI32(2*numSegments);
+            std::vector<Analog::Pointer> channels(analogs.begin() + p * numComponents, analogs.begin() + (p + 1) * numComponents);
+            std::vector<int32_t> segments = TDFReadSegments(&bifs, numPFFrames);
             for (size_t i = 0 ; i < segments.size() ; i+=2)
             {
-              for (int32_t j = segments[i] ; j < segments[i]+segments[i+1] ; ++j)
-              {
-                std::vector<float> data = bifs.ReadFloat(12);
-                if (j + shift < output->GetAnalogFrameNumber())
-                {
-                  int k = 0;
-                  for (Acquisition::AnalogIterator it = analogMap.begin() ; it != analogMap.end() ; ++it)
-                    (*it)->SetDataSlice(j + shift, data[k++]);
-                }
-              }
+              const float* samples = TDFReadSamples(&bifs, segments[i+1], numComponents, &buffer);
+              TDFDispatchSamples(samples, std::min(segments[i+1], numAnalogFrames - segments[i] - shift), channels, segments[i] + shift);
             }
           }
         }
-        // Two force platforms - by frames
-        else if ((be->format == 6) || (be->format == 8))
+        else
         {
-          btkErrorMacro("The use of two wrenches by force platform is partially supported. Please contact the developers to improve this part.");
-          FPDoubleFormat = true;
           // Label of the force plateform (skipped)
-          if (be->format == 8)
+          if (withLabels)
             bifs.SeekRead(numPFs * 256, BinaryFileStream::Current);
-          // Label for each analog channel
-          // Map the analog channels to fit with the force platform type I
-          std::list<Analog::Pointer> analogMap;
-          Acquisition::AnalogIterator it;
-          it = output->BeginAnalog();
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("PX" + ToString(p+1) + "a");
-            (*it)->SetUnit("m");
-            analogMap.push_back(*it);
-            std::advance(it, 12);
-          }
-          it = output->BeginAnalog(); std::advance(it, 1);
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("PY" + ToString(p+1) + "a");
-            (*it)->SetUnit("m");
-            analogMap.push_back(*it);
-            std::advance(it, 12);
-          }
-          it = output->BeginAnalog(); std::advance(it, 2);
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("FX" + ToString(p+1) + "a");
-            (*it)->SetUnit("N");
-            analogMap.push_back(*it);
-            std::advance(it, 12);
-          }
-          it = output->BeginAnalog(); std::advance(it, 3);
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("FY" + ToString(p+1) + "a");
-            (*it)->SetUnit("N");
-            analogMap.push_back(*it);
-            std::advance(it, 12);
-          }
-          it = output->BeginAnalog(); std::advance(it, 4);
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("FZ" + ToString(p+1) + "a");
-            (*it)->SetUnit("N");
-            analogMap.push_back(*it);
-            std::advance(it, 12);
-          }
-          it = output->BeginAnalog(); std::advance(it, 5);
-          for (int p = 0 ; p < numPFs ; ++p)
+          // The samples are ordered by component and then by force platform
+          std::vector<Analog::Pointer> channels(analogs.size());
+          for (int c = 0 ; c < numComponents ; ++c)
           {
-            (*it)->SetLabel("MZ" + ToString(p+1) + "a");
-            (*it)->SetUnit("Nm");
-            analogMap.push_back(*it);
-            std::advance(it, 12);
-          }
-          it = output->BeginAnalog(); std::advance(it, 6);
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("PX" + ToString(p+1) + "b");
-            (*it)->SetUnit("m");
-            analogMap.push_back(*it);
-            std::advance(it, 12);
-          }
-          it = output->BeginAnalog(); std::advance(it, 7);
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("PY" + ToString(p+1) + "b");
-            (*it)->SetUnit("m");
-            analogMap.push_back(*it);
-            std::advance(it, 12);
-          }
-          it = output->BeginAnalog(); std::advance(it, 8);
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("FX" + ToString(p+1) + "b");
-            (*it)->SetUnit("N");
-            analogMap.push_back(*it);
-            std::advance(it, 12);
-          }
-          it = output->BeginAnalog(); std::advance(it, 9);
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("FY" + ToString(p+1) + "b");
-            (*it)->SetUnit("N");
-            analogMap.push_back(*it);
-            std::advance(it, 12);
-          }
-          it = output->BeginAnalog(); std::advance(it, 10);
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("FZ" + ToString(p+1) + "b");
-            (*it)->SetUnit("N");
-            analogMap.push_back(*it);
-            std::advance(it, 12);
-          }
-          it = output->BeginAnalog(); std::advance(it, 11);
-          for (int p = 0 ; p < numPFs ; ++p)
-          {
-            (*it)->SetLabel("MZ" + ToString(p+1) + "b");
-            (*it)->SetUnit("Nm");
-            analogMap.push_back(*it);
-            std::advance(it, 12);
-          }
-          // Extract data
-          const int32_t shift = (FPFirstframe - firstframe) * analogSampleNumberPerPointFrame;
-          int32_t numPFFramesFinal = numPFFrames - shift;
-          numPFFramesFinal = (numPFFramesFinal >= numAnalogFrames) ? numAnalogFrames : numPFFramesFinal;
-          for (int i = 0 ; i < numPFFramesFinal ; ++i)
-          {
-            for (Acquisition::AnalogIterator it = analogMap.begin() ; it != analogMap.end() ; ++it)
-              (*it)->SetDataSlice(i + shift, bifs.ReadFloat());
+            for (int p = 0 ; p < numPFs ; ++p)
+              channels[c * numPFs + p] = analogs[p * numComponents + c];
           }
+          const int32_t numPFFramesFinal = std::min(numPFFrames, numAnalogFrames - shift);
+          const float* samples = TDFReadSamples(&bifs, numPFFramesFinal, static_cast<int>(channels.size()), &buffer);
+          TDFDispatchSamples(samples, numPFFramesFinal, channels, shift);
         }
-        // - Unknown
-        else
-          throw(TDFFileIOException("Unknown format for the PlatformData block"));
           
         // Revert the data for the forces and moments as the acquisition should contain the raw signal of the force platform and not the reaction.
         const int numPlatforms = FPDoubleFormat ? numPFs * 2 : numPFs;
@@ -723,58 +699,45 @@ namespace btk
         bifs.SeekRead(numEMGChannels*2, BinaryFileStream::Current); // Need of the map?
         
         // Data
+        std::vector<Analog::Pointer> channels;
+        Acquisition::AnalogIterator it = output->BeginAnalog();
+        std::advance(it, numPFChannels);
+        for ( ; it != output->EndAnalog() ; ++it)
+          channels.push_back(*it);
+        const int32_t shift = (EMGFirstframe - firstframe) * analogSampleNumberPerPointFrame;
+        const int32_t numEMGFramesFinal = std::min(numEMGFrames, numAnalogFrames - shift);
         // - By channels
         if (be->format == 1)
         {
-          Acquisition::AnalogIterator it = output->BeginAnalog();
-          std::advance(it, numPFChannels);
-          while (it != output->EndAnalog())
+          for (size_t c = 0 ; c < channels.size() ; ++c)
           {
             Analog::Values val = Analog::Values::Zero(numEMGFrames,1);
             // Extract label
             std::string label = bifs.ReadString(256);
-            (*it)->SetLabel(this->CleanLabel(label));
-            // Extract data
-            int32_t numSegments = bifs.ReadI32();
-            bifs.SeekRead(4, BinaryFileStream::Current);
-            std::vector<int32_t> segments = bifs.ReadI32(2*numSegments);
+            channels[c]->SetLabel(this->CleanLabel(label));
+            // Extract data (one contiguous block of samples by segment)
+            std::vector<int32_t> segments = TDFReadSegments(&bifs, numEMGFrames);
             for (size_t i = 0 ; i < segments.size() ; i+=2)
             {
-              for (int32_t j = segments[i] ; j < segments[i]+segments[i+1] ; ++j)
-                val.data()[j] = bifs.ReadFloat();
+              const float* samples = TDFReadSamples(&bifs, segments[i+1], 1, &buffer);
+              val.segment(segments[i], segments[i+1]) = Eigen::Map<const Eigen::VectorXf>(samples, segments[i+1]).cast<double>();
             }
-            const int32_t shift = (EMGFirstframe - firstframe) * analogSampleNumberPerPointFrame;
-            const int32_t numEMGFramesFinal = numEMGFrames - shift;
-            memcpy((*it)->GetValues().data() + shift, val.data(), (numEMGFramesFinal >= numAnalogFrames) ? numAnalogFrames : numEMGFramesFinal);
-            ++it;
+            if (numEMGFramesFinal > 0)
+              channels[c]->GetValues().segment(shift, numEMGFramesFinal) = val.head(numEMGFramesFinal);
           }
         }
         // - By frame
         else if (be->format == 2)
         {
           // Extract label
-          Acquisition::AnalogIterator it = output->BeginAnalog();
-          std::advance(it, numPFChannels);
-          while (it != output->EndAnalog())
+          for (size_t c = 0 ; c < channels.size() ; ++c)
           {
             std::string label = bifs.ReadString(256);
-            (*it)->SetLabel(this->CleanLabel(label));
-            ++it;
-          }
-          // Extract data
-          const int32_t shift = (EMGFirstframe - firstframe) * analogSampleNumberPerPointFrame;
-          int32_t numEMGFramesFinal = numEMGFrames - shift;
-          numEMGFramesFinal = (numEMGFramesFinal >= numAnalogFrames) ? numAnalogFrames : numEMGFramesFinal;
-          for (int i = 0 ; i < numEMGFramesFinal ; ++i)
-          {
-            it = output->BeginAnalog();
-            std::advance(it, numPFChannels);
-            while (it != output->EndAnalog())
-            {
-              (*it)->SetDataSlice(i + shift, bifs.ReadFloat());
-              ++it;
-            }
+            channels[c]->SetLabel(this->CleanLabel(label));
           }
+          // Extract data (all the frames in one block)
+          const float* samples = TDFReadSamples(&bifs, numEMGFramesFinal, numEMGChannels, &buffer);
+          TDFDispatchSamples(samples, numEMGFramesFinal, channels, shift);
         }
         // - Unknown
         else
@@ -824,12 +787,286 @@ namespace btk
     }
   };
   
+  /**
+   * Write the file designated by @a filename with the content of @a input.
+   *
+   * Only the points of type Point::Marker are exported. The frames with a negative residual are considered as invalid and are not stored.
+   * The analog channels of the force platforms of type I are exported in the force platform blocks while the others are exported in the EMG block.
+   */
+  void TDFFileIO::Write(const std::string& filename, Acquisition::Pointer input)
+  {
+    if (!input)
+    {
+      btkErrorMacro("Impossible to write a null input into a file.");
+      return;
+    }
+    IEEELittleEndianBinaryFileStream bofs;
+    try
+    {
+      int32_t pointFrequency = static_cast<int32_t>(input->GetPointFrequency() + 0.5);
+      if (pointFrequency <= 0)
+      {
+        btkWarningMacro(filename, "Acquisition frequency cannot be null and is set to 50 Hz.");
+        pointFrequency = 50; // Hz
+      }
+      const int32_t analogFrequency = pointFrequency * input->GetNumberAnalogSamplePerFrame();
+      const int32_t numFrames = input->GetPointFrameNumber();
+      const int32_t numAnalogFrames = input->GetAnalogFrameNumber();
+      const float startTime = static_cast<float>(input->GetFirstFrame() - 1) / static_cast<float>(pointFrequency);
+      
+      // Markers: only the valid frames (residual greater or equal to 0) are stored.
+      // The measures are only read with the const accessors to not copy the values shared with other objects.
+      std::vector<Point::ConstPointer> markers;
+      std::vector< std::vector<int32_t> > markersSegments;
+      std::vector<int32_t> markersSamples;
+      int32_t markerBlockSize = 80;
+      for (Acquisition::PointConstIterator it = input->BeginPoint() ; it != input->EndPoint() ; ++it)
+      {
+        Point::ConstPointer marker = *it;
+        if (marker->GetType() != Point::Marker)
+          continue;
+        std::vector<int32_t> segments;
+        int32_t numSamples = 0;
+        const Point::Residuals& res = marker->GetResiduals();
+        for (int32_t i = 0 ; i < numFrames ; ++i)
+        {
+          if (res.coeff(i) < 0.0)
+            continue;
+          if (segments.empty() || (segments[segments.size()-2] + segments.back() != i))
+          {
+            segments.push_back(i);
+            segments.push_back(0);
+          }
+          ++segments.back();
+          ++numSamples;
+        }
+        markers.push_back(marker);
+        markersSegments.push_back(segments);
+        markersSamples.push_back(numSamples);
+        markerBlockSize += 256 + 8 + 4 * static_cast<int32_t>(segments.size()) + 12 * numSamples;
+      }
+      const int32_t numMarkers = static_cast<int32_t>(markers.size());
+      // Force platforms and EMG
+      std::vector<Analog::ConstPointer> analogs(input->BeginAnalog(), input->EndAnalog());
+      std::vector<bool> assigned(analogs.size(), false);
+      std::vector<Analog::ConstPointer> platformChannels;
+      std::vector<float> corners;
+      TDFExtractForcePlatforms(filename, input, analogs, &platformChannels, &corners, &assigned);
+      const int32_t numPFs = static_cast<int32_t>(platformChannels.size() / 6);
+      std::vector<Analog::ConstPointer> EMGChannels;
+      for (size_t i = 0 ; i < analogs.size() ; ++i)
+      {
+        if (!assigned[i])
+          EMGChannels.push_back(analogs[i]);
+      }
+      const int32_t numEMGChannels = static_cast<int32_t>(EMGChannels.size());
+      const int32_t segmentSize = (numAnalogFrames > 0) ? 8 : 0; // One segment for all the analog samples
+      
+      // Block entries
+      std::list<BlockEntry> blockEntries;
+      BlockEntry be;
+      be.offset = 0;
+      if (numMarkers != 0)
+      {
+        be.type = MarkerBlockId; be.format = 2; be.size = markerBlockSize;
+        blockEntries.push_back(be);
+      }
+      if (numPFs != 0)
+      {
+        be.type = PlatformConfigBlockId; be.format = 1; be.size = 8 + numPFs * (2 + 256 + 8 + 48);
+        blockEntries.push_back(be);
+        be.type = PlatformDataBlockId; be.format = 1; be.size = 16 + numPFs * (2 + 8 + segmentSize + 24 * numAnalogFrames);
+        blockEntries.push_back(be);
+      }
+      if (numEMGChannels != 0)
+      {
+        be.type = EMGBlockId; be.format = 1; be.size = 16 + numEMGChannels * (2 + 256 + 8 + segmentSize + 4 * numAnalogFrames);
+        blockEntries.push_back(be);
+      }
+      int32_t offset = 64 + 288 * static_cast<int32_t>(blockEntries.size());
+      for (std::list<BlockEntry>::iterator it = blockEntries.begin() ; it != blockEntries.end() ; ++it)
+      {
+        it->offset = offset;
+        offset += it->size;
+      }
+      
+      // File access
+      bofs.Open(filename, BinaryFileStream::Out | BinaryFileStream::Truncate);
+      if (!bofs.IsOpen())
+        throw(TDFFileIOException("No File access"));
+      
+      // Header
+      bofs.Write(TDFKey[0]); bofs.Write(TDFKey[1]); bofs.Write(TDFKey[2]); bofs.Write(TDFKey[3]);
+      bofs.Write(static_cast<uint32_t>(1)); // Version
+      bofs.Write(static_cast<int32_t>(blockEntries.size()));
+      bofs.Fill(40); // Reserved and dates
+      for (std::list<BlockEntry>::const_iterator it = blockEntries.begin() ; it != blockEntries.end() ; ++it)
+      {
+        bofs.Write(it->type);
+        bofs.Write(it->format);
+        bofs.Write(it->offset);
+        bofs.Write(it->size);
+        bofs.Fill(272); // Reserved and comment
+      }
+      
+      // ------------------------------------------------------------------- //
+      //                              Markers
+      // ------------------------------------------------------------------- //
+      std::vector<float> buffer;
+      if (numMarkers != 0)
+      {
+        bofs.Write(numFrames);
+        bofs.Write(pointFrequency);
+        bofs.Write(startTime);
+        bofs.Write(numMarkers);
+        // Calibration volume (size, rotation matrix, translation) and flags
+        static const float rotation[9] = {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+        bofs.Fill(12);
+        bofs.Write(9, rotation);
+        bofs.Fill(16);
+        // Data by markers (format 2: without links)
+        const double scale = TDFUnitScale(input->GetPointUnit(Point::Marker));
+        for (int32_t m = 0 ; m < numMarkers ; ++m)
+        {
+          TDFWriteLabel(&bofs, markers[m]->GetLabel());
+          const std::vector<int32_t>& segments = markersSegments[m];
+          TDFWriteSegments(&bofs, segments);
+          buffer.resize(markersSamples[m] * 3);
+          int32_t inc = 0;
+          for (size_t i = 0 ; i < segments.size() ; i+=2)
+          {
+            TDFOutputSamples(&(buffer[inc * 3]), segments[i+1], 3) = (markers[m]->GetValues().block(segments[i], 0, segments[i+1], 3) * scale).cast<float>();
+            inc += segments[i+1];
+          }
+          bofs.Write(buffer);
+        }
+      }
+      // ------------------------------------------------------------------- //
+      //                          Platform config
+      // ------------------------------------------------------------------- //
+      if (numPFs != 0)
+      {
+        bofs.Write(numPFs);
+        bofs.Fill(4);
+        for (int32_t p = 0 ; p < numPFs ; ++p)
+          bofs.Write(static_cast<int16_t>(p));
+        for (int32_t p = 0 ; p < numPFs ; ++p)
+        {
+          const float* c = &(corners[p * 12]);
+          float size[2];
+          size[0] = (Eigen::Map<const Eigen::Vector3f>(c) - Eigen::Map<const Eigen::Vector3f>(c + 3)).norm();
+          size[1] = (Eigen::Map<const Eigen::Vector3f>(c + 3) - Eigen::Map<const Eigen::Vector3f>(c + 6)).norm();
+          TDFWriteLabel(&bofs, "");
+          bofs.Write(2, size);
+          bofs.Write(12, c);
+        }
+      }
+      // ------------------------------------------------------------------- //
+      //                            Platform data
+      // ------------------------------------------------------------------- //
+      if (numPFs != 0)
+      {
+        bofs.Write(numPFs);
+        bofs.Write(analogFrequency);
+        bofs.Write(startTime);
+        bofs.Write(numAnalogFrames);
+        for (int32_t p = 0 ; p < numPFs ; ++p)
+          bofs.Write(static_cast<int16_t>(p));
+        // Data by channels (format 1: without labels). The forces and moments are stored as reaction.
+        static const double sign[6] = {1.0, 1.0, -1.0, -1.0, -1.0, -1.0};
+        std::vector<int32_t> segments;
+        if (numAnalogFrames > 0)
+        {
+          segments.push_back(0);
+          segments.push_back(numAnalogFrames);
+        }
+        buffer.resize(numAnalogFrames * 6);
+        for (int32_t p = 0 ; p < numPFs ; ++p)
+        {
+          TDFWriteSegments(&bofs, segments);
+          if (numAnalogFrames <= 0)
+            continue;
+          TDFOutputSamples samples(&(buffer[0]), numAnalogFrames, 6);
+          for (int c = 0 ; c < 6 ; ++c)
+          {
+            const Analog::ConstPointer& channel = platformChannels[p * 6 + c];
+            samples.col(c) = (channel->GetValues() * (sign[c] * TDFUnitScale(channel->GetUnit()))).cast<float>();
+          }
+          bofs.Write(buffer);
+        }
+      }
+      // ------------------------------------------------------------------- //
+      //                                EMG
+      // ------------------------------------------------------------------- //
+      if (numEMGChannels != 0)
+      {
+        bofs.Write(numEMGChannels);
+        bofs.Write(analogFrequency);
+        bofs.Write(startTime);
+        bofs.Write(numAnalogFrames);
+        for (int32_t c = 0 ; c < numEMGChannels ; ++c)
+          bofs.Write(static_cast<int16_t>(c));
+        // Data by channels (format 1)
+        std::vector<int32_t> segments;
+        if (numAnalogFrames > 0)
+        {
+          segments.push_back(0);
+          segments.push_back(numAnalogFrames);
+        }
+        buffer.resize(numAnalogFrames);
+        for (int32_t c = 0 ; c < numEMGChannels ; ++c)
+        {
+          TDFWriteLabel(&bofs, EMGChannels[c]->GetLabel());
+          TDFWriteSegments(&bofs, segments);
+          if (numAnalogFrames <= 0)
+            continue;
+          Eigen::Map<Eigen::VectorXf>(&(buffer[0]), numAnalogFrames) = EMGChannels[c]->GetValues().cast<float>();
+          bofs.Write(buffer);
+        }
+      }
+    }
+    catch (TDFFileIOException& )
+    {
+      if (bofs.IsOpen()) bofs.Close();
+      throw;
+    }
+    catch (std::exception& e)
+    {
+      if (bofs.IsOpen()) bofs.Close();
+      throw(TDFFileIOException("Unexpected exception occurred: " + std::string(e.what())));
+    }
+    catch(...)
+    {
+      if (bofs.IsOpen()) bofs.Close();
+      throw(TDFFileIOException("Unknown exception"));
+    }
+  };
+  
   /**
    * Constructor.
    */
   TDFFileIO::TDFFileIO()
   : AcquisitionFileIO(AcquisitionFileIO::Binary, AcquisitionFileIO::IEEE_LittleEndian, AcquisitionFileIO::Float)
-  {};
+  {
+    this->m_BlocksToRead = AllBlocks;
+  };
+  
+  bool TDFFileIO::IsBlockSelected(uint32_t id) const
+  {
+    switch (id)
+    {
+    case MarkerBlockId:
+      return (this->m_BlocksToRead & MarkerBlock) == MarkerBlock;
+    case PlatformConfigBlockId:
+      return (this->m_BlocksToRead & PlatformConfigBlock) == PlatformConfigBlock;
+    case PlatformDataBlockId:
+      return (this->m_BlocksToRead & PlatformDataBlock) == PlatformDataBlock;
+    case EMGBlockId:
+      return (this->m_BlocksToRead & EMGBlock) == EMGBlock;
+    default:
+      return false;
+    }
+  };
   
   const TDFFileIO::BlockEntry* TDFFileIO::SeekToBlock(IEEELittleEndianBinaryFileStream* bifs, const std::list<BlockEntry>* blockEntries, unsigned int id) const
   {
@@ -58,9 +58,10 @@ namespace btk
   class TDFFileIO : public AcquisitionFileIO
   {
     BTK_FILE_IO_SUPPORTED_EXTENSIONS("TDF");
-    BTK_FILE_IO_ONLY_READ_OPERATION;
     
   public:
+    typedef enum {MarkerBlock = 0x01, PlatformConfigBlock = 0x02, PlatformDataBlock = 0x04, EMGBlock = 0x08, AllBlocks = 0x0F} Block;
+    
     typedef btkSharedPtr<TDFFileIO> Pointer;
     typedef btkSharedPtr<const TDFFileIO> ConstPointer;
     
@@ -68,8 +69,13 @@ namespace btk
     
     // ~TDFFileIO(); // Implicit.
     
+    int GetBlocksToRead() const {return this->m_BlocksToRead;};
+    void SetBlocksToRead(int blocks) {this->m_BlocksToRead = blocks;};
+    
     BTK_IO_EXPORT virtual bool CanReadFile(const std::string& filename);
+    BTK_IO_EXPORT virtual bool CanWriteFile(const std::string& filename);
     BTK_IO_EXPORT virtual void Read(const std::string& filename, Acquisition::Pointer output);
+    BTK_IO_EXPORT virtual void Write(const std::string& filename, Acquisition::Pointer input);
     
   protected:
     BTK_IO_EXPORT TDFFileIO();
@@ -84,10 +90,13 @@ namespace btk
     };
     
     const BlockEntry* SeekToBlock(IEEELittleEndianBinaryFileStream* bifs, const std::list<BlockEntry>* blockEntries, unsigned int id) const;
+    bool IsBlockSelected(uint32_t id) const;
     std::string& CleanLabel(std::string& label) const;
     
     TDFFileIO(const TDFFileIO& ); // Not implemented.
     TDFFileIO& operator=(const TDFFileIO& ); // Not implemented. 
+    
+    int m_BlocksToRead;
    };
    
    inline std::string& TDFFileIO::CleanLabel(std::string& label) const
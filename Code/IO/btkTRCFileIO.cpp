@@ -36,8 +36,8 @@
 #include "btkTRCFileIO.h"
 #include "btkConvert.h"
 #include "btkLogger.h"
+#include "btkFileStream.h"
 
-#include <fstream>
 #include <algorithm>
 #include <cctype>
 #include <iostream>
@@ -90,7 +90,7 @@ namespace btk
    */
   bool TRCFileIO::CanReadFile(const std::string& filename)
   {
-    std::ifstream ifs(filename.c_str());
+    ifilestream ifs(filename.c_str());
     char c[13] = {0};
     ifs.read(c, 12); c[12] = '\0';
     ifs.close();
@@ -115,12 +115,14 @@ namespace btk
   
   /**
    * Read the file designated by @a filename and fill @a output.
+   * In the mode AcquisitionFileIO::HeaderOnly, only the header lines are parsed.
    */
   void TRCFileIO::Read(const std::string& filename, Acquisition::Pointer output)
   {
     output->Reset();
+    this->m_HeaderFrameNumber = -1;
     // Open the stream
-    std::ifstream ifs;
+    ifilestream ifs;
     ifs.exceptions(std::ios_base::eofbit | std::ios_base::failbit | std::ios_base::badbit);
     try
     {
@@ -193,6 +195,10 @@ namespace btk
           numberOfPoints = numberOfLabels;
         }
         std::getline(ifs, line); // Coordinate's label (X1, Y1, Z1, ...)
+        this->m_HeaderFrameNumber = numberOfFrames;
+        // Header only: the points are created without frame and the data are not read.
+        if (this->m_ReadingMode == HeaderOnly)
+          numberOfFrames = 0;
         output->Init(numberOfPoints, numberOfFrames);
         std::list<std::string>::const_iterator itLabel = labels.begin();
         for (PointCollection::Iterator it = output->BeginPoint() ; it != output->EndPoint() ; ++it)
@@ -215,8 +221,14 @@ namespace btk
         }
       }
       // In case there is only unlabel markers in the TRC file (see issue #70 - https://code.google.com/p/b-tk/issues/detail?id=70)
+      else if ((numberOfFrames != 0) && (this->m_ReadingMode == HeaderOnly))
+      {
+        this->m_HeaderFrameNumber = numberOfFrames;
+        output->Init(0, 0);
+      }
       else if (numberOfFrames != 0)
       {
+        this->m_HeaderFrameNumber = numberOfFrames;
         btkWarningMacro(filename, "Number of point is null but the number of frames. Trying to find values for unlabeled markers...")
         output->Init(0, numberOfFrames); 
         std::getline(ifs, line); // Frame#, Time and normaly markers' labels
@@ -301,7 +313,7 @@ namespace btk
       btkErrorMacro("Impossible to write a null input into a file.");
       return;
     }
-    std::ofstream ofs(filename.c_str());
+    ofilestream ofs(filename.c_str());
     if (!ofs) 
       throw(TRCFileIOException("Invalid file path."));
     PointCollection::Pointer markers = PointCollection::New();
@@ -348,13 +360,15 @@ namespace btk
     }
     ofs << "\n";
     double time = 0.0;
+    // Read-only access to not copy the values shared with other objects
+    const std::vector<Point::ConstPointer> readOnlyMarkers(markers->Begin(), markers->End());
     for (int frame = 0 ; frame < input->GetPointFrameNumber() ; ++frame)
     {
       ofs.precision(3);
       ofs << std::endl << frame + 1 << "\t" << time;
       ofs.precision(5);
 
-      for (PointCollection::ConstIterator it = markers->Begin() ; it != markers->End() ; ++it)
+      for (std::vector<Point::ConstPointer>::const_iterator it = readOnlyMarkers.begin() ; it != readOnlyMarkers.end() ; ++it)
       {
         if ((*it)->GetValues().row(frame).isZero() && ((*it)->GetResiduals().coeff(frame) == -1))
           ofs << "\t\t\t";
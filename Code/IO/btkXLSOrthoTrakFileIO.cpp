@@ -37,8 +37,8 @@
 #include "btkMetaDataUtils.h"
 #include "btkConvert.h"
 #include "btkLogger.h"
+#include "btkFileStream.h"
 
-#include <fstream>
 #include <algorithm>
 #include <cctype>
 #include <iostream>
@@ -93,7 +93,7 @@ namespace btk
    */
   bool XLSOrthoTrakFileIO::CanReadFile(const std::string& filename)
   {
-    std::ifstream ifs(filename.c_str());
+    ifilestream ifs(filename.c_str());
     bool canBeRead = true;
     std::string line;
     std::getline(ifs, line);
@@ -114,7 +114,7 @@ namespace btk
     output->Reset();
     double* values = 0;
     // Open the stream
-    std::ifstream ifs;
+    ifilestream ifs;
     try
     {
       std::string line;
@@ -38,9 +38,208 @@
 #include "btkConfigure.h"
 
 #include "Open3DMotion/MotionFile/Formats/XMove/FileFormatXMove.h"
+#include "Open3DMotion/MotionFile/Formats/XMove/FileFormatOptionsXMove.h"
+#include "Open3DMotion/MotionFile/Formats/XMove/XMLReadingMachineLegacy.h"
+#include "Open3DMotion/OpenORM/IO/XML/XMLReadingMachine.h"
+
+#include <pugixml.hpp>
+
+#include <cstring> // memcpy, strlen
 
 namespace btk
 {
+  // Decoder converting the base64 text of each time sequence directly in the points and analog channels.
+  // The text is decoded by chunks, only a few frames of binary data are stored at a time.
+  class XMOVEDecoder_p : public CodamotionDecoder_p
+  {
+  public:
+    XMOVEDecoder_p()
+    : m_Markers(), m_MarkerTexts(), m_Analogs(), m_AnalogTexts(), m_Base64(), m_Buffer()
+    {};
+    
+    virtual void DecodeMarker(size_t idx, Point::Values& values, Point::Residuals& residuals)
+    {
+      const Open3DMotion::TimeSequence* ts = this->m_Markers[idx];
+      const Open3DMotion::BinaryFieldSpec* value = 0, *occluded = 0;
+      size_t valueOffset = 0, occludedOffset = 0;
+      ts->DataStructure().GetFieldOffset(value, valueOffset, "value");
+      ts->DataStructure().GetFieldOffset(occluded, occludedOffset, "occluded");
+      if ((value->Dimension.Value() != 3) || (occluded->Bytes.Value() != 1))
+        throw(XMOVEFileIOException("Unexpected binary structure for marker '" + ts->Channel.Value() + "'."));
+      const bool singlePrecision = (value->Bytes.Value() == 3 * static_cast<int>(sizeof(float)));
+      
+      size_t j = 0;
+      const size_t frameSize = this->Begin(ts, this->m_MarkerTexts[idx]);
+      const char* frame = 0;
+      while ((j < ts->NumFrames()) && ((frame = this->Next(frameSize)) != 0))
+      {
+        for (int k = 0 ; k < 3 ; ++k)
+          values.coeffRef(j,k) = singlePrecision ? Extract<float>(frame + valueOffset, k) : Extract<double>(frame + valueOffset, k);
+        residuals.coeffRef(j) = frame[occludedOffset] ? -1.0 : 0.0;
+        ++j;
+      }
+      if (j != ts->NumFrames())
+        throw(XMOVEFileIOException("Missing data for marker '" + ts->Channel.Value() + "'."));
+    };
+    
+    virtual void DecodeAnalog(size_t idx, double* samples, size_t num)
+    {
+      const Open3DMotion::TimeSequence* ts = this->m_Analogs[idx];
+      const Open3DMotion::BinaryFieldSpec* value = 0;
+      size_t valueOffset = 0;
+      ts->DataStructure().GetFieldOffset(value, valueOffset, "value");
+      if (value->Dimension.Value() != 1)
+        throw(XMOVEFileIOException("Unexpected binary structure for analog channel '" + ts->Channel.Value() + "'."));
+      const bool singlePrecision = (value->Bytes.Value() == static_cast<int>(sizeof(float)));
+      
+      size_t j = 0;
+      const size_t frameSize = this->Begin(ts, this->m_AnalogTexts[idx]);
+      const char* frame = 0;
+      while ((j < num) && ((frame = this->Next(frameSize)) != 0))
+        samples[j++] = singlePrecision ? Extract<float>(frame + valueOffset, 0) : Extract<double>(frame + valueOffset, 0);
+      if (j != num)
+        throw(XMOVEFileIOException("Missing data for analog channel '" + ts->Channel.Value() + "'."));
+    };
+    
+    void AppendMarker(const Open3DMotion::TimeSequence* ts, const char* text)
+    {
+      this->m_Markers.push_back(ts);
+      this->m_MarkerTexts.push_back(text);
+    };
+    void AppendAnalog(const Open3DMotion::TimeSequence* ts, const char* text)
+    {
+      this->m_Analogs.push_back(ts);
+      this->m_AnalogTexts.push_back(text);
+    };
+    
+  private:
+    template <typename T>
+    static double Extract(const char* field, int k)
+    {
+      T v;
+      memcpy(&v, field + k * sizeof(T), sizeof(T));
+      return static_cast<double>(v);
+    };
+    
+    size_t Begin(const Open3DMotion::TimeSequence* ts, const char* text)
+    {
+      const size_t frameSize = ts->DataStructure().TotalBytes();
+      if (frameSize == 0)
+        throw(XMOVEFileIOException("Invalid binary structure for the channel '" + ts->Channel.Value() + "'."));
+      this->m_Base64.Reset();
+      this->mp_Text = text;
+      this->m_TextLength = strlen(text);
+      this->m_Buffer.resize(frameSize + Base64Decoder_p::MaxDecodedLength(ChunkLength));
+      this->m_Begin = this->m_End = 0;
+      return frameSize;
+    };
+    
+    // Returns the next frame or null if there is no more data.
+    const char* Next(size_t frameSize)
+    {
+      while (this->m_End - this->m_Begin < frameSize)
+      {
+        if (this->m_TextLength == 0)
+          return 0;
+        // Move the remaining bytes at the beginning of the buffer and decode the next chunk of text
+        memmove(&(this->m_Buffer[0]), &(this->m_Buffer[0]) + this->m_Begin, this->m_End - this->m_Begin);
+        this->m_End -= this->m_Begin;
+        this->m_Begin = 0;
+        const size_t len = std::min(this->m_TextLength, static_cast<size_t>(ChunkLength));
+        this->m_End += this->m_Base64.Decode(this->mp_Text, len, &(this->m_Buffer[0]) + this->m_End);
+        this->mp_Text += len;
+        this->m_TextLength -= len;
+      }
+      const char* frame = &(this->m_Buffer[0]) + this->m_Begin;
+      this->m_Begin += frameSize;
+      return frame;
+    };
+    
+    std::vector<const Open3DMotion::TimeSequence*> m_Markers;
+    std::vector<const char*> m_MarkerTexts;
+    std::vector<const Open3DMotion::TimeSequence*> m_Analogs;
+    std::vector<const char*> m_AnalogTexts;
+    enum {ChunkLength = 4096}; // Number of characters decoded at once
+    Base64Decoder_p m_Base64;
+    const char* mp_Text;
+    size_t m_TextLength;
+    std::vector<char> m_Buffer;
+    size_t m_Begin;
+    size_t m_End;
+  };
+  
+  // Read the XML document and give only its metadata to Open3DMotion. The base64 text of the time sequences 
+  // stored in the acquisition section is detached from the document before its conversion in a trial and 
+  // decoded later directly in the points and analog channels. The calculated section is discarded.
+  static void ReadXMOVEDirectly_p(Acquisition::Pointer output, const std::string& filename, std::istream& is, bool legacy)
+  {
+    pugi::xml_document doc;
+    pugi::xml_parse_result result = doc.load(is);
+    if (!result)
+      throw(XMOVEFileIOException(result.description()));
+    pugi::xml_node xmove = doc.child("xmove");
+    if (!xmove)
+      throw(XMOVEFileIOException("XML missing xmove section"));
+    // Detach the binary data
+    std::vector<const char*> texts;
+    for (pugi::xml_node sequence = xmove.child("Acq").child("Sequences").first_child() ; sequence ; sequence = sequence.next_sibling())
+    {
+      if (sequence.type() != pugi::node_element)
+        continue;
+      const char* text = "";
+      pugi::xml_node data = sequence.child("Data");
+      for (pugi::xml_node child = data.first_child() ; child ; child = child.next_sibling())
+      {
+        if (child.type() == pugi::node_pcdata)
+        {
+          text = child.value(); // The text is owned by the document and not by the node.
+          break;
+        }
+      }
+      texts.push_back(text);
+      sequence.remove_child(data);
+    }
+    // The calculated data are not loaded. Removing them avoids their conversion by Open3DMotion.
+    xmove.remove_child("Calc");
+    // Metadata
+    Open3DMotion::BinMemFactoryDefault memfactory;
+    btkSharedPtr<Open3DMotion::XMLReadingMachine> reader;
+    if (legacy)
+      reader.reset(new Open3DMotion::XMLReadingMachineLegacy(memfactory));
+    else
+      reader.reset(new Open3DMotion::XMLReadingMachine(memfactory));
+    btkSharedPtr<Open3DMotion::TreeValue> trialcontents(reader->ReadValue(xmove));
+    btkSharedPtr<Open3DMotion::Trial> trial(new Open3DMotion::Trial);
+    trial->FromTree(trialcontents.get());
+    const Open3DMotion::MapArrayCompound<Open3DMotion::TimeSequence>& sequences = trial->Acq.TimeSequences;
+    if (sequences.NumElements() != texts.size())
+      throw(XMOVEFileIOException("Invalid time sequences."));
+    // Markers and analog channels
+    XMOVEDecoder_p decoder;
+    std::vector<const Open3DMotion::TimeSequence*> o3dm_markers, o3dm_analogs;
+    for (size_t i = 0 ; i < sequences.NumElements() ; ++i)
+    {
+      const Open3DMotion::TimeSequence* ts = &(sequences[i]);
+      if (ts->Group.Value().compare(Open3DMotion::TrialSectionAcq::TSGroupMarker) == 0)
+      {
+        o3dm_markers.push_back(ts);
+        decoder.AppendMarker(ts, texts[i]);
+      }
+      else if (ts->Group.Value().compare(Open3DMotion::TrialSectionAcq::TSGroupAnalog) == 0)
+      {
+        o3dm_analogs.push_back(ts);
+        decoder.AppendAnalog(ts, texts[i]);
+      }
+    }
+    std::vector<CodamotionChannel_p> markers, analogs;
+    ConvertOpen3DMotionSequences_p(&markers, o3dm_markers);
+    ConvertOpen3DMotionSequences_p(&analogs, o3dm_analogs);
+    std::vector<const Open3DMotion::ForcePlate*> forcePlates(trial->Acq.ForcePlates.NumElements());
+    for (size_t i = 0 ; i < forcePlates.size() ; ++i)
+      forcePlates[i] = &(trial->Acq.ForcePlates[i]);
+    FillAcquisitionFromCodamotion_p(output, filename, markers, analogs, forcePlates, &decoder);
+  };
+  
   /**
    * @class XMOVEFileIOException btkXMOVEFileIO.h
    * @brief Exception class for the XMOVEFileIO class.
@@ -64,6 +263,11 @@ namespace btk
    *
    * This class uses internally the code of the library Open3DMotion (http://github.com/Open3DMotionGroup/Open3DMotion).
    *
+   * By default (see SetDecodingMode()), Open3DMotion is only used to read the metadata of the file. The base64 text 
+   * of the markers and analog channels is decoded directly in the points and analog channels of the acquisition.
+   * The mode Open3DMotionDecoding builds first the complete trial with Open3DMotion (time sequences) and copies it 
+   * in the acquisition. It requires about twice the memory and is kept for comparison purpose.
+   *
    * @ingroup BTKIO
    */
   
@@ -77,11 +281,30 @@ namespace btk
    * Smart pointer associated with a const XMOVEFileIO object.
    */
   
+  /**
+   * @var XMOVEFileIO::DecodingMode XMOVEFileIO::DirectDecoding
+   * The binary data of the file are decoded directly in the acquisition (default).
+   */
+  /**
+   * @var XMOVEFileIO::DecodingMode XMOVEFileIO::Open3DMotionDecoding
+   * The file is first converted in an Open3DMotion trial and then copied in the acquisition.
+   */
+  
   /**
    * @fn static XMOVEFileIO::Pointer XMOVEFileIO::New()
    * Create a XMOVEFileIO object an return it as a smart pointer.
    */
   
+  /**
+   * @fn DecodingMode XMOVEFileIO::GetDecodingMode() const
+   * Returns the way the file is decoded.
+   */
+  
+  /**
+   * @fn void XMOVEFileIO::SetDecodingMode(DecodingMode mode)
+   * Sets the way the file is decoded (DirectDecoding by default).
+   */
+  
   /**
    * Checks if the header corresponds to a XMOVE file
    */
@@ -89,7 +312,7 @@ namespace btk
   {
     Open3DMotion::MotionFileHandler handler("Biomechanical ToolKit", BTK_VERSION_STRING);
     Open3DMotion::TreeValue* readoptions = NULL;
-    std::ifstream ifs(filename.c_str(), std::ios::binary);
+    ifilestream ifs(filename.c_str(), std::ios::binary);
     Open3DMotion::FileFormatXMove ff;
     return (ifs.is_open() && ff.Probe(handler, readoptions, ifs));
   };
@@ -100,15 +323,29 @@ namespace btk
   void XMOVEFileIO::Read(const std::string& filename, Acquisition::Pointer output)
   {
     output->Reset();
-    std::ifstream ifs(filename.c_str(), std::ios::binary);
+    ifilestream ifs(filename.c_str(), std::ios::binary);
     ifs.exceptions(std::ios::badbit | std::ios::eofbit | std::ios::failbit);
     try
     {
       // Read data
       Open3DMotion::MotionFileHandler handler("Biomechanical ToolKit", BTK_VERSION_STRING);
-      Open3DMotion::MotionFileFormatList reduced_list;
-      reduced_list.Register(new Open3DMotion::FileFormatXMove);
-      FillAcquisitionFromOpen3DMotion_p(output, filename, ifs, handler, reduced_list);
+      if (this->m_DecodingMode == Open3DMotionDecoding)
+      {
+        Open3DMotion::MotionFileFormatList reduced_list;
+        reduced_list.Register(new Open3DMotion::FileFormatXMove);
+        FillAcquisitionFromOpen3DMotion_p(output, filename, ifs, handler, reduced_list);
+      }
+      else
+      {
+        Open3DMotion::TreeValue* readoptions = NULL;
+        if (!Open3DMotion::FileFormatXMove().Probe(handler, readoptions, ifs))
+          throw(XMOVEFileIOException("Invalid header key."));
+        btkSharedPtr<Open3DMotion::TreeValue> options(readoptions);
+        Open3DMotion::FileFormatOptionsXMove xmove_options;
+        xmove_options.FromTree(options.get());
+        ifs.seekg(0, std::ios::beg);
+        ReadXMOVEDirectly_p(output, filename, ifs, xmove_options.LegacyCompoundNames);
+      }
     }
     catch (std::ios::failure& )
     {
@@ -160,5 +397,7 @@ namespace btk
    */
   XMOVEFileIO::XMOVEFileIO()
   : AcquisitionFileIO()
-  {};
+  {
+    this->m_DecodingMode = DirectDecoding;
+  };
 };
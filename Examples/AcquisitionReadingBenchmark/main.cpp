@@ -0,0 +1,121 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <btkAcquisitionFileReader.h>
+#include <btkLogger.h>
+#include <btkMacro.h> // btkStripPathMacro
+
+#include <iostream> // std::cout, std::cerr
+#include <cstdlib> // std::atoi
+#include <ctime> // std::clock
+#include <vector>
+#include <string>
+
+// Read all the files @a repeat times and keep the acquisitions of each pass in memory (bulk reading).
+// Returns the elapsed time (in seconds) or -1.0 if a file cannot be read.
+static double ReadCorpus(const std::vector<std::string>& filenames, int repeat, bool arenaUsed)
+{
+  std::clock_t start = std::clock();
+  for (int r = 0 ; r < repeat ; ++r)
+  {
+    std::vector<btk::Acquisition::Pointer> acquisitions;
+    acquisitions.reserve(filenames.size());
+    for (size_t i = 0 ; i < filenames.size() ; ++i)
+    {
+      btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+      reader->SetFilename(filenames[i]);
+      reader->SetMemoryArenaUsed(arenaUsed);
+      try
+      {
+        reader->Update();
+      }
+      catch(std::exception& e)
+      {
+        std::cerr << "Exception while reading '" << filenames[i] << "': " << e.what() << std::endl;
+        return -1.0;
+      }
+      acquisitions.push_back(reader->GetOutput());
+    }
+    // The acquisitions (and their arena) are released here.
+  }
+  return static_cast<double>(std::clock() - start) / static_cast<double>(CLOCKS_PER_SEC);
+};
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "No enough input arguments.\n\n"
+              << "Usage: " << btkStripPathMacro(argv[0]) << " [-n repeat] file1 [file2 ...]\n\n"
+              << "Read a corpus of acquisition files (e.g. small C3D trials) several times, with and without\n"
+              << "a memory arena for the measures, and report the reading time of each mode."
+              << std::endl;
+    return -1;
+  }
+  
+  int repeat = 10;
+  std::vector<std::string> filenames;
+  for (int i = 1 ; i < argc ; ++i)
+  {
+    std::string arg = argv[i];
+    if ((arg == "-n") && (i + 1 < argc))
+      repeat = std::atoi(argv[++i]);
+    else
+      filenames.push_back(arg);
+  }
+  if ((repeat <= 0) || filenames.empty())
+  {
+    std::cerr << "At least one file and a positive number of repetitions are required." << std::endl;
+    return -1;
+  }
+  
+  btk::Logger::SetVerboseMode(btk::Logger::Quiet);
+  // Warm up (file system cache)
+  if (ReadCorpus(filenames, 1, false) < 0.0)
+    return -2;
+  
+  const double heap = ReadCorpus(filenames, repeat, false);
+  const double arena = ReadCorpus(filenames, repeat, true);
+  if ((heap < 0.0) || (arena < 0.0))
+    return -2;
+  
+  const double reads = static_cast<double>(filenames.size() * repeat);
+  std::cout << "Files: " << filenames.size() << " (read " << repeat << " times)\n"
+            << "Heap:  " << heap << " s (" << (heap > 0.0 ? reads / heap : 0.0) << " files/s)\n"
+            << "Arena: " << arena << " s (" << (arena > 0.0 ? reads / arena : 0.0) << " files/s)\n";
+  if (arena > 0.0)
+    std::cout << "Speedup: " << heap / arena << std::endl;
+  return 0;
+};
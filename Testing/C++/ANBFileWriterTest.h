@@ -211,6 +211,41 @@ CXXTEST_SUITE(ANBFileWriterTest)
       }
     }
   };
+  
+  CXXTEST_TEST(NewAcquisitionLarge)
+  {
+    // Several blocks of interleaved samples with an odd number of channels
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0,30002,5);
+    acq->SetPointFrequency(1000.0);
+    acq->SetAnalogResolution(btk::Acquisition::Bit16);
+    const double scale = 20.0 / 65536.0;
+    for (int i = 0 ; i < 5 ; ++i)
+    {
+      acq->GetAnalog(i)->SetGain(btk::Analog::PlusMinus10);
+      acq->GetAnalog(i)->SetScale(scale);
+      for (int j = 0 ; j < 30002 ; ++j)
+        acq->GetAnalog(i)->GetValues().coeffRef(j) = 4.0 * std::sin(0.001 * j + i) - 0.5 * i;
+    }
+    
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    writer->SetInput(acq);
+    writer->SetFilename(ANBFilePathOUT + "new_acquisition_large.anb");
+    writer->Update();
+    
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(ANBFilePathOUT + "new_acquisition_large.anb");
+    reader->Update();
+    btk::Acquisition::Pointer acq2 = reader->GetOutput();
+    
+    TS_ASSERT_EQUALS(acq2->GetAnalogNumber(), 5);
+    TS_ASSERT_EQUALS(acq2->GetAnalogFrameNumber(), 30002);
+    for (int i = 0 ; i < 5 ; ++i)
+    {
+      TS_ASSERT_DELTA(acq2->GetAnalog(i)->GetScale(), scale, 1e-5);
+      TS_ASSERT_EIGEN_DELTA(acq->GetAnalog(i)->GetValues(), acq2->GetAnalog(i)->GetValues(), scale);
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(ANBFileWriterTest)
@@ -221,4 +256,5 @@ CXXTEST_TEST_REGISTRATION(ANBFileWriterTest, Gait_rewrited)
 CXXTEST_TEST_REGISTRATION(ANBFileWriterTest, Gait_from_c3d)  
 CXXTEST_TEST_REGISTRATION(ANBFileWriterTest, NewAcquisition)
 CXXTEST_TEST_REGISTRATION(ANBFileWriterTest, NewAcquisitionBis)
+CXXTEST_TEST_REGISTRATION(ANBFileWriterTest, NewAcquisitionLarge)
 #endif
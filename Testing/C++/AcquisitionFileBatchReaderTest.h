@@ -0,0 +1,114 @@
+#ifndef AcquisitionFileBatchReaderTest_h
+#define AcquisitionFileBatchReaderTest_h
+
+#include <btkAcquisitionFileBatchReader.h>
+#include <btkAcquisitionFileReader.h>
+#include <btkAcquisitionFileWriter.h>
+#include <btkConvert.h>
+
+#include <fstream>
+
+btk::Acquisition::Pointer btk_batch_acquisition(int i)
+{
+  btk::Acquisition::Pointer acq = btk::Acquisition::New();
+  acq->Init(2, 30 + 10 * i, 1, 2);
+  acq->SetPointFrequency(100.0);
+  for (int j = 0 ; j < acq->GetPointFrameNumber() ; ++j)
+  {
+    acq->GetPoint(0)->GetValues().row(j) << 1.0 * j, 2.0 * i, 3.0;
+    acq->GetPoint(1)->GetValues().row(j) << -1.0 * j, 0.5 * i, 1.0;
+  }
+  acq->GetAnalog(0)->GetValues().setConstant(0.25 * i);
+  return acq;
+};
+
+std::vector<std::string> btk_batch_files(int num)
+{
+  std::vector<std::string> filenames;
+  for (int i = 0 ; i < num ; ++i)
+  {
+    filenames.push_back(C3DFilePathOUT + "BatchReader" + btk::ToString(i) + ".c3d");
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    writer->SetInput(btk_batch_acquisition(i));
+    writer->SetFilename(filenames.back());
+    writer->Update();
+  }
+  return filenames;
+};
+
+CXXTEST_SUITE(AcquisitionFileBatchReaderTest)
+{
+  CXXTEST_TEST(NoFile)
+  {
+    btk::AcquisitionFileBatchReader::Pointer batch = btk::AcquisitionFileBatchReader::New();
+    TS_ASSERT_EQUALS(batch->AtEnd(), true);
+    TS_ASSERT(batch->ReadNext().get() == 0);
+    TS_ASSERT_EQUALS(batch->GetCurrentIndex(), -1);
+    TS_ASSERT_EQUALS(batch->GetInFlightSize(), 0u);
+  };
+  
+  CXXTEST_TEST(Sequence)
+  {
+    std::vector<std::string> filenames = btk_batch_files(6);
+    btk::AcquisitionFileBatchReader::Pointer batch = btk::AcquisitionFileBatchReader::New();
+    batch->SetFilenames(filenames);
+    batch->SetReadAheadNumber(2);
+    TS_ASSERT_EQUALS(batch->GetFileNumber(), 6);
+    int num = 0;
+    while (!batch->AtEnd())
+    {
+      btk::Acquisition::Pointer acq = batch->ReadNext();
+      btk::Acquisition::Pointer ref = btk_batch_acquisition(num);
+      TS_ASSERT_EQUALS(batch->GetCurrentIndex(), num);
+      TS_ASSERT_EQUALS(batch->GetCurrentFilename(), filenames[num]);
+      TS_ASSERT_EQUALS(acq->GetPointFrameNumber(), ref->GetPointFrameNumber());
+      TS_ASSERT_EIGEN_DELTA(acq->GetPoint(1)->GetValues(), ref->GetPoint(1)->GetValues(), 1e-4);
+      TS_ASSERT_EIGEN_DELTA(acq->GetAnalog(0)->GetValues(), ref->GetAnalog(0)->GetValues(), 1e-4);
+      ++num;
+    }
+    TS_ASSERT_EQUALS(num, 6);
+    TS_ASSERT(batch->ReadNext().get() == 0);
+    TS_ASSERT_EQUALS(batch->GetInFlightSize(), 0u);
+    
+    batch->Rewind();
+    TS_ASSERT_EQUALS(batch->ReadNext()->GetPointFrameNumber(), 30);
+  };
+  
+  CXXTEST_TEST(SmallBudget)
+  {
+    std::vector<std::string> filenames = btk_batch_files(4);
+    btk::AcquisitionFileBatchReader::Pointer batch = btk::AcquisitionFileBatchReader::New();
+    batch->SetFilenames(filenames);
+    batch->SetMaxInFlightSize(1); // Each file is larger: only one file in flight
+    std::ifstream ifs(filenames.back().c_str(), std::ios_base::in | std::ios_base::binary);
+    ifs.seekg(0, std::ios_base::end);
+    const size_t largest = static_cast<size_t>(ifs.tellg());
+    ifs.close();
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+      TS_ASSERT_EQUALS(batch->ReadNext()->GetPointFrameNumber(), 30 + 10 * i);
+      TS_ASSERT(batch->GetInFlightSize() <= largest);
+    }
+    TS_ASSERT_EQUALS(batch->AtEnd(), true);
+  };
+  
+  CXXTEST_TEST(MissingFile)
+  {
+    std::vector<std::string> filenames = btk_batch_files(2);
+    filenames.insert(filenames.begin() + 1, C3DFilePathOUT + "BatchReaderMissing.c3d");
+    btk::AcquisitionFileBatchReader::Pointer batch = btk::AcquisitionFileBatchReader::New();
+    batch->SetFilenames(filenames);
+    TS_ASSERT_EQUALS(batch->ReadNext()->GetPointFrameNumber(), 30);
+    TS_ASSERT_THROWS_EQUALS(batch->ReadNext(), const btk::AcquisitionFileReaderException &e, e.what(), "File doesn't exist\nFilename: " + filenames[1]);
+    TS_ASSERT_EQUALS(batch->GetCurrentIndex(), 1);
+    TS_ASSERT_EQUALS(batch->ReadNext()->GetPointFrameNumber(), 40);
+    TS_ASSERT_EQUALS(batch->AtEnd(), true);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(AcquisitionFileBatchReaderTest)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileBatchReaderTest, NoFile)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileBatchReaderTest, Sequence)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileBatchReaderTest, SmallBudget)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileBatchReaderTest, MissingFile)
+#endif
@@ -0,0 +1,175 @@
+#ifndef AcquisitionFileCacheTest_h
+#define AcquisitionFileCacheTest_h
+
+#include <btkAcquisitionFileReader.h>
+#include <btkAcquisitionFileCache.h>
+#include <btkC3DFileIO.h>
+
+#include <fstream>
+#if !defined(_WIN32)
+  #include <fcntl.h>
+  #include <sys/stat.h>
+#endif
+
+CXXTEST_SUITE(AcquisitionFileCacheTest)
+{
+  CXXTEST_TEST(Disabled)
+  {
+    btk::AcquisitionFileCache::Pointer cache = btk::AcquisitionFileCache::New();
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    TS_ASSERT_EQUALS(cache->Store(C3DFilePathIN + "others/Gait.c3d", acq), false);
+    TS_ASSERT_EQUALS(cache->Load(C3DFilePathIN + "others/Gait.c3d", acq), false);
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 0);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 1);
+  };
+  
+  CXXTEST_TEST(Gait)
+  {
+    btk::AcquisitionFileCache::Pointer cache = btk::AcquisitionFileCache::New(CacheFilePathOUT);
+    cache->Remove(C3DFilePathIN + "others/Gait.c3d");
+    
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(C3DFilePathIN + "others/Gait.c3d");
+    reader->SetCache(cache);
+    reader->Update();
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 0);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 1);
+    
+    btk::AcquisitionFileReader::Pointer reader2 = btk::AcquisitionFileReader::New();
+    reader2->SetFilename(C3DFilePathIN + "others/Gait.c3d");
+    reader2->SetCache(cache);
+    reader2->Update();
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 1);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 1);
+    
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    btk::Acquisition::Pointer acq2 = reader2->GetOutput();
+    TS_ASSERT_EQUALS(acq->GetFirstFrame(), acq2->GetFirstFrame());
+    TS_ASSERT_EQUALS(acq->GetPointFrequency(), acq2->GetPointFrequency());
+    TS_ASSERT_EQUALS(acq->GetPointNumber(), acq2->GetPointNumber());
+    TS_ASSERT_EQUALS(acq->GetAnalogNumber(), acq2->GetAnalogNumber());
+    TS_ASSERT_EQUALS(acq->GetEventNumber(), acq2->GetEventNumber());
+    TS_ASSERT(*(acq->GetMetaData()) == *(acq2->GetMetaData()));
+    for (int i = 0 ; i < acq->GetPointNumber() ; ++i)
+      TS_ASSERT(acq->GetPoint(i)->GetValues() == acq2->GetPoint(i)->GetValues());
+    for (int i = 0 ; i < acq->GetAnalogNumber() ; ++i)
+      TS_ASSERT(acq->GetAnalog(i)->GetValues() == acq2->GetAnalog(i)->GetValues());
+  };
+  
+  CXXTEST_TEST(Snapshot)
+  {
+    // Any existing file can be used as the original file of an entry.
+    const std::string original = CacheFilePathOUT + "Snapshot.txt";
+    std::ofstream ofs(original.c_str());
+    ofs << "Snapshot";
+    ofs.close();
+    btk::AcquisitionFileCache::Pointer cache = btk::AcquisitionFileCache::New(CacheFilePathOUT);
+    cache->Remove(original);
+    
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(2, 10, 3, 2);
+    acq->SetFirstFrame(5);
+    acq->SetPointFrequency(100.0);
+    acq->GetPoint(0)->SetLabel("RHEE");
+    acq->GetPoint(1)->SetType(btk::Point::Angle);
+    for (int i = 0 ; i < 10 ; ++i)
+    {
+      acq->GetPoint(0)->SetDataSlice(i, i, 2.0 * i, 3.0 * i, (i == 4) ? -1.0 : 0.5);
+      acq->GetPoint(1)->SetDataSlice(i, -1.0 * i, 0.25, 1.0 / (i + 1.0));
+    }
+    for (int i = 0 ; i < 3 ; ++i)
+      acq->GetAnalog(i)->GetValues().setLinSpaced(20, i, i + 1.0);
+    acq->GetAnalog(2)->SetUnit("Nmm");
+    acq->GetAnalog(2)->SetScale(0.5);
+    acq->AppendEvent(btk::Event::New("Foot Strike", 0.07, 8, "Right"));
+    acq->GetMetaData()->AppendChild(btk::MetaData::New("POINT"));
+    acq->GetMetaData()->GetChild(0)->AppendChild(btk::MetaData::New("RATE", static_cast<float>(100.0)));
+    acq->GetPoint(1)->PackValues();
+    btk::C3DFileIO::Pointer io = btk::C3DFileIO::New();
+    io->SetByteOrder(btk::AcquisitionFileIO::IEEE_BigEndian);
+    io->SetStorageFormat(btk::AcquisitionFileIO::Integer);
+    TS_ASSERT_EQUALS(cache->Store(original, acq, io), true);
+    TS_ASSERT_EQUALS(acq->GetPoint(1)->IsValuesPacked(), true);
+    
+    btk::Acquisition::Pointer acq2 = btk::Acquisition::New();
+    btk::C3DFileIO::Pointer io2 = btk::C3DFileIO::New();
+    TS_ASSERT_EQUALS(cache->Load(original, acq2, io2), true);
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 1);
+    TS_ASSERT_EQUALS(io2->GetFileType(), btk::AcquisitionFileIO::Binary);
+    TS_ASSERT_EQUALS(io2->GetByteOrder(), btk::AcquisitionFileIO::IEEE_BigEndian);
+    TS_ASSERT_EQUALS(io2->GetStorageFormat(), btk::AcquisitionFileIO::Integer);
+    TS_ASSERT_EQUALS(acq2->GetFirstFrame(), 5);
+    TS_ASSERT_EQUALS(acq2->GetPointFrequency(), 100.0);
+    TS_ASSERT_EQUALS(acq2->GetPointFrameNumber(), 10);
+    TS_ASSERT_EQUALS(acq2->GetNumberAnalogSamplePerFrame(), 2);
+    TS_ASSERT_EQUALS(acq2->GetPoint(0)->GetLabel(), "RHEE");
+    TS_ASSERT_EQUALS(acq2->GetPoint(1)->GetType(), btk::Point::Angle);
+    TS_ASSERT(acq2->GetPoint(0)->GetValues() == acq->GetPoint(0)->GetValues());
+    TS_ASSERT(acq2->GetPoint(0)->GetResiduals() == acq->GetPoint(0)->GetResiduals());
+    TS_ASSERT(acq2->GetPoint(1)->GetValues() == acq->GetPoint(1)->CopyValues());
+    for (int i = 0 ; i < 3 ; ++i)
+      TS_ASSERT(acq2->GetAnalog(i)->GetValues() == acq->GetAnalog(i)->GetValues());
+    TS_ASSERT_EQUALS(acq2->GetAnalog(2)->GetUnit(), "Nmm");
+    TS_ASSERT_EQUALS(acq2->GetAnalog(2)->GetScale(), 0.5);
+    TS_ASSERT_EQUALS(acq2->GetEventNumber(), 1);
+    TS_ASSERT_EQUALS(acq2->GetEvent(0)->GetFrame(), 8);
+    TS_ASSERT_EQUALS(acq2->GetEvent(0)->GetTime(), 0.07);
+    TS_ASSERT(*(acq->GetMetaData()) == *(acq2->GetMetaData()));
+    
+    // Modified original file: invalid entry
+    ofs.open(original.c_str());
+    ofs << "Modified snapshot";
+    ofs.close();
+    TS_ASSERT_EQUALS(cache->Load(original, acq2, io2), false);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 1);
+  };
+  
+#if !defined(_WIN32)
+  CXXTEST_TEST(RewrittenSameSecond)
+  {
+    const std::string original = CacheFilePathOUT + "RewrittenSameSecond.txt";
+    struct timespec times[2] = {{1000000000, 100}, {1000000000, 100}};
+    std::ofstream ofs(original.c_str());
+    ofs << "Original";
+    ofs.close();
+    utimensat(AT_FDCWD, original.c_str(), times, 0);
+    btk::AcquisitionFileCache::Pointer cache = btk::AcquisitionFileCache::New(CacheFilePathOUT);
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(1, 10);
+    TS_ASSERT_EQUALS(cache->Store(original, acq), true);
+    TS_ASSERT_EQUALS(cache->Load(original, acq), true);
+    
+    // Same size and same second, but a different modification time.
+    ofs.open(original.c_str());
+    ofs << "Modified";
+    ofs.close();
+    times[0].tv_nsec = times[1].tv_nsec = 200;
+    utimensat(AT_FDCWD, original.c_str(), times, 0);
+    TS_ASSERT_EQUALS(cache->Load(original, acq), false);
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 1);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 1);
+  };
+#endif
+  
+  CXXTEST_TEST(ManualIO)
+  {
+    btk::AcquisitionFileCache::Pointer cache = btk::AcquisitionFileCache::New(CacheFilePathOUT);
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(C3DFilePathIN + "others/Gait.c3d");
+    reader->SetAcquisitionIO(btk::C3DFileIO::New());
+    reader->SetCache(cache);
+    reader->Update();
+    TS_ASSERT_EQUALS(cache->GetHitNumber(), 0);
+    TS_ASSERT_EQUALS(cache->GetMissNumber(), 0);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(AcquisitionFileCacheTest)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileCacheTest, Disabled)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileCacheTest, Gait)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileCacheTest, Snapshot)
+#if !defined(_WIN32)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileCacheTest, RewrittenSameSecond)
+#endif
+CXXTEST_TEST_REGISTRATION(AcquisitionFileCacheTest, ManualIO)
+#endif
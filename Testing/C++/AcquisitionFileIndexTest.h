@@ -0,0 +1,198 @@
+#ifndef AcquisitionFileIndexTest_h
+#define AcquisitionFileIndexTest_h
+
+#include <btkAcquisitionFileIndex.h>
+#include <btkAcquisitionFileReader.h>
+#include <btkAcquisitionFileWriter.h>
+#include <btkC3DFileIO.h>
+#include <btkTRCFileIO.h>
+#include <btkMetaDataUtils.h>
+#include <btkConvert.h>
+
+#include <fstream>
+#include <sstream>
+
+btk::Acquisition::Pointer btk_index_acquisition()
+{
+  btk::Acquisition::Pointer acq = btk::Acquisition::New();
+  acq->Init(2, 120, 6, 10);
+  acq->SetFirstFrame(11);
+  acq->SetPointFrequency(100.0);
+  acq->GetPoint(0)->SetLabel("LASI");
+  acq->GetPoint(1)->SetLabel("LHipAngles");
+  acq->GetPoint(1)->SetType(btk::Point::Angle);
+  for (int i = 0 ; i < 2 ; ++i)
+  {
+    for (int j = 0 ; j < 120 ; ++j)
+      acq->GetPoint(i)->GetValues().row(j) << 1.0 * j, 2.0 * i, 3.0;
+  }
+  for (int i = 0 ; i < 6 ; ++i)
+  {
+    acq->GetAnalog(i)->SetLabel("FP1_" + btk::ToString(i + 1));
+    acq->GetAnalog(i)->SetUnit((i < 3) ? "N" : "Nmm");
+    acq->GetAnalog(i)->GetValues().setConstant(0.5 * i);
+  }
+  acq->AppendEvent(btk::Event::New("Foot Strike", 0.35, 36, "Left"));
+  btk::MetaData::Pointer fp = btk::MetaData::New("FORCE_PLATFORM");
+  acq->GetMetaData()->AppendChild(fp);
+  btk::MetaDataCreateChild(fp, "USED", static_cast<int16_t>(1));
+  btk::MetaDataCreateChild(fp, "TYPE", std::vector<int16_t>(1, 2));
+  std::vector<int16_t> channels(6);
+  for (int i = 0 ; i < 6 ; ++i)
+    channels[i] = i + 1;
+  btk::MetaDataCreateChild(fp, "CHANNEL", channels);
+  std::vector<float> corners(12, 0.0f);
+  corners[0] = 464.0f; corners[1] = 254.0f;
+  btk::MetaDataCreateChild(fp, "CORNERS", corners);
+  std::vector<float> origin(3, 0.0f);
+  origin[2] = -40.0f;
+  btk::MetaDataCreateChild(fp, "ORIGIN", origin);
+  return acq;
+};
+
+CXXTEST_SUITE(AcquisitionFileIndexTest)
+{
+  CXXTEST_TEST(C3DHeaderOnly)
+  {
+    btk::Acquisition::Pointer acq = btk_index_acquisition();
+    std::vector<char> buffer;
+    btk::C3DFileIO::New()->WriteBuffer(&buffer, acq);
+
+    btk::C3DFileIO::Pointer io = btk::C3DFileIO::New();
+    TS_ASSERT_EQUALS(io->GetReadingMode(), btk::AcquisitionFileIO::FullReading);
+    io->SetReadingMode(btk::AcquisitionFileIO::HeaderOnly);
+    btk::Acquisition::Pointer output = btk::Acquisition::New();
+    io->ReadBuffer(&buffer[0], buffer.size(), output);
+    TS_ASSERT_EQUALS(io->GetHeaderFrameNumber(), 120);
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 0);
+    TS_ASSERT_EQUALS(output->GetFirstFrame(), 11);
+    TS_ASSERT_EQUALS(output->GetPointFrequency(), 100.0);
+    TS_ASSERT_EQUALS(output->GetAnalogFrequency(), 1000.0);
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 2);
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), 6);
+    TS_ASSERT_EQUALS(output->GetPoint(1)->GetLabel(), "LHipAngles");
+    TS_ASSERT_EQUALS(output->GetPoint(1)->GetType(), btk::Point::Angle);
+    TS_ASSERT_EQUALS(output->GetPoint(1)->GetFrameNumber(), 0);
+    TS_ASSERT_EQUALS(output->GetAnalog(4)->GetUnit(), "Nmm");
+    TS_ASSERT_EQUALS(output->GetAnalog(4)->GetFrameNumber(), 0);
+    TS_ASSERT_EQUALS(output->GetEventNumber(), 1);
+
+    btk::Acquisition::Pointer full = btk::Acquisition::New();
+    btk::C3DFileIO::New()->ReadBuffer(&buffer[0], buffer.size(), full);
+    TS_ASSERT_EQUALS(full->GetPointFrameNumber(), 120);
+    TS_ASSERT(*(full->GetMetaData()) == *(output->GetMetaData()));
+  };
+
+  CXXTEST_TEST(TRCHeaderOnly)
+  {
+    btk::Acquisition::Pointer acq = btk_index_acquisition();
+    std::stringstream ss;
+    btk::TRCFileIO::New()->WriteStream(ss, acq);
+    btk::TRCFileIO::Pointer io = btk::TRCFileIO::New();
+    io->SetReadingMode(btk::AcquisitionFileIO::HeaderOnly);
+    btk::Acquisition::Pointer output = btk::Acquisition::New();
+    io->ReadStream(ss, output);
+    TS_ASSERT_EQUALS(io->GetHeaderFrameNumber(), 120);
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 0);
+    TS_ASSERT_EQUALS(output->GetFirstFrame(), 11);
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 1); // Angles are not exported in TRC
+    TS_ASSERT_EQUALS(output->GetPoint(0)->GetLabel(), "LASI");
+  };
+
+  CXXTEST_TEST(Directory)
+  {
+    btk::Acquisition::Pointer acq = btk_index_acquisition();
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    writer->SetInput(acq);
+    writer->SetFilename(IndexFilePathOUT + "trial1.c3d");
+    writer->Update();
+    writer = btk::AcquisitionFileWriter::New();
+    writer->SetInput(acq);
+    writer->SetFilename(IndexFilePathOUT + "trial2.TRC");
+    writer->Update();
+    std::ofstream ofs((IndexFilePathOUT + "corrupted.c3d").c_str());
+    ofs << "Not a C3D file";
+    ofs.close();
+    std::ofstream txt((IndexFilePathOUT + "notes.txt").c_str());
+    txt << "Ignored";
+    txt.close();
+
+    btk::AcquisitionFileIndex::Pointer index = btk::AcquisitionFileIndex::New();
+    index->SetThreadNumber(2);
+    TS_ASSERT_EQUALS(index->AddDirectory(IndexFilePathOUT, false), 3);
+    index->Update();
+    TS_ASSERT_EQUALS(index->GetEntryNumber(), 3);
+    TS_ASSERT_EQUALS(index->GetErrorNumber(), 1);
+    const std::vector<btk::AcquisitionFileIndex::Entry>& entries = index->GetEntries();
+    TS_ASSERT_EQUALS(entries[0].filename, IndexFilePathOUT + "corrupted.c3d");
+    TS_ASSERT(!entries[0].error.empty());
+
+    const btk::AcquisitionFileIndex::Entry& c3d = entries[1];
+    TS_ASSERT_EQUALS(c3d.error, "");
+    TS_ASSERT_EQUALS(c3d.format, "C3D");
+    TS_ASSERT_EQUALS(c3d.firstFrame, 11);
+    TS_ASSERT_EQUALS(c3d.frameNumber, 120);
+    TS_ASSERT_EQUALS(c3d.pointFrequency, 100.0);
+    TS_ASSERT_EQUALS(c3d.analogFrequency, 1000.0);
+    TS_ASSERT_EQUALS(c3d.pointLabels.size(), 2u);
+    TS_ASSERT_EQUALS(c3d.pointLabels[0], "LASI");
+    TS_ASSERT_EQUALS(c3d.pointTypes[1], static_cast<int>(btk::Point::Angle));
+    TS_ASSERT_EQUALS(c3d.pointUnits[0], "mm");
+    TS_ASSERT_EQUALS(c3d.pointUnits[1], "deg");
+    TS_ASSERT_EQUALS(c3d.analogLabels.size(), 6u);
+    TS_ASSERT_EQUALS(c3d.analogUnits[5], "Nmm");
+    TS_ASSERT_EQUALS(c3d.events.size(), 1u);
+    TS_ASSERT_EQUALS(c3d.events[0].label, "Foot Strike");
+    TS_ASSERT_EQUALS(c3d.events[0].context, "Left");
+    TS_ASSERT_EQUALS(c3d.events[0].frame, 36);
+    TS_ASSERT_EQUALS(c3d.forcePlates.size(), 1u);
+    TS_ASSERT_EQUALS(c3d.forcePlates[0].type, 2);
+    TS_ASSERT_EQUALS(c3d.forcePlates[0].channels.size(), 6u);
+    TS_ASSERT_EQUALS(c3d.forcePlates[0].channels[5], 6);
+    TS_ASSERT_EQUALS(c3d.forcePlates[0].corners.size(), 12u);
+    TS_ASSERT_EQUALS(c3d.forcePlates[0].corners[1], 254.0);
+    TS_ASSERT_EQUALS(c3d.forcePlates[0].origin[2], -40.0);
+
+    const btk::AcquisitionFileIndex::Entry& trc = entries[2];
+    TS_ASSERT_EQUALS(trc.error, "");
+    TS_ASSERT_EQUALS(trc.format, "TRC");
+    TS_ASSERT_EQUALS(trc.frameNumber, 120);
+    TS_ASSERT_EQUALS(trc.pointLabels.size(), 1u);
+
+    std::ostringstream oss;
+    index->Write(oss);
+    const std::string str = oss.str();
+    TS_ASSERT_EQUALS(str.substr(0, 24), "# BTK acquisition index\n");
+    TS_ASSERT(str.find("\nE\tFoot Strike\tLeft\t36\t") != std::string::npos);
+    TS_ASSERT(str.find("\nFP\t2\t1,2,3,4,5,6\t464,254,") != std::string::npos);
+    TS_ASSERT(str.find("\nX\t") != std::string::npos);
+  };
+
+  CXXTEST_TEST(Gait)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(C3DFilePathIN + "others/Gait.c3d");
+    reader->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+
+    btk::AcquisitionFileIndex::Pointer index = btk::AcquisitionFileIndex::New();
+    index->AddFile(C3DFilePathIN + "others/Gait.c3d");
+    index->Update();
+    TS_ASSERT_EQUALS(index->GetErrorNumber(), 0);
+    const btk::AcquisitionFileIndex::Entry& entry = index->GetEntries()[0];
+    TS_ASSERT_EQUALS(entry.firstFrame, acq->GetFirstFrame());
+    TS_ASSERT_EQUALS(entry.frameNumber, acq->GetPointFrameNumber());
+    TS_ASSERT_EQUALS(entry.pointFrequency, acq->GetPointFrequency());
+    TS_ASSERT_EQUALS(entry.analogFrequency, acq->GetAnalogFrequency());
+    TS_ASSERT_EQUALS(static_cast<int>(entry.pointLabels.size()), acq->GetPointNumber());
+    TS_ASSERT_EQUALS(static_cast<int>(entry.analogLabels.size()), acq->GetAnalogNumber());
+    TS_ASSERT_EQUALS(static_cast<int>(entry.events.size()), acq->GetEventNumber());
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(AcquisitionFileIndexTest)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIndexTest, C3DHeaderOnly)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIndexTest, TRCHeaderOnly)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIndexTest, Directory)
+CXXTEST_TEST_REGISTRATION(AcquisitionFileIndexTest, Gait)
+#endif
@@ -158,6 +158,211 @@ CXXTEST_SUITE(AcquisitionTest)
     TS_ASSERT_EQUALS(test->GetPoint(1)->GetParent(), test.get());
     TS_ASSERT_EQUALS(test->GetPoint(2)->GetParent(), test.get());
   }
+  
+  CXXTEST_TEST(PackValues)
+  {
+    btk::Acquisition::Pointer test = btk::Acquisition::New();
+    test->Init(2,10,3,4);
+    test->GetPoint(1)->GetValues().setConstant(1.25);
+    test->GetAnalog(2)->GetValues().setLinSpaced(40, 0.0, 3.9);
+    test->PackValues();
+    TS_ASSERT_EQUALS(test->GetPoint(0)->IsValuesPacked(), true);
+    TS_ASSERT_EQUALS(test->GetPoint(1)->IsValuesPacked(), true);
+    TS_ASSERT_EQUALS(test->GetAnalog(2)->IsValuesPacked(), true);
+    TS_ASSERT_EQUALS(test->GetAnalog(2)->GetFrameNumber(), 40);
+    TS_ASSERT_EQUALS(test->GetAnalog(2)->GetData()->GetPackedValues()->coeff(39), 3.9f);
+    test->ResizeFrameNumber(5);
+    TS_ASSERT_EQUALS(test->GetPoint(1)->GetFrameNumber(), 5);
+    TS_ASSERT_EQUALS(test->GetPoint(1)->IsValuesPacked(), true);
+    test->UnpackValues();
+    TS_ASSERT_EQUALS(test->GetPoint(1)->IsValuesPacked(), false);
+    TS_ASSERT_EQUALS(test->GetAnalog(2)->IsValuesPacked(), false);
+    TS_ASSERT_EQUALS(test->GetPoint(1)->GetValues().coeff(4,2), 1.25);
+    TS_ASSERT_EQUALS(test->GetAnalog(2)->GetFrameNumber(), 20);
+    TS_ASSERT_DELTA(test->GetAnalog(2)->GetValues().coeff(19), 1.9, 1e-6);
+  }
+  
+  CXXTEST_TEST(AppendFrames)
+  {
+    btk::Acquisition::Pointer test = btk::Acquisition::New();
+    test->Init(2,3,1,2);
+    test->GetPoint(0)->GetValues().setConstant(-1.0);
+    double points[6], residuals[2], analogs[2];
+    for (int f = 3 ; f < 1000 ; ++f)
+    {
+      for (int i = 0 ; i < 2 ; ++i)
+      {
+        points[i*3] = f; points[i*3+1] = i; points[i*3+2] = 2.0 * f;
+        residuals[i] = 0.5 * i;
+      }
+      analogs[0] = 2.0 * f; analogs[1] = 2.0 * f + 1.0;
+      test->AppendFrames(1, points, residuals, analogs);
+    }
+    TS_ASSERT_EQUALS(test->GetBufferedFrameNumber(), 1000);
+    TS_ASSERT_EQUALS(test->GetPointFrameNumber(), 3);
+    test->CommitFrames();
+    TS_ASSERT_EQUALS(test->GetPointFrameNumber(), 1000);
+    TS_ASSERT_EQUALS(test->GetAnalogFrameNumber(), 2000);
+    TS_ASSERT_EQUALS(test->GetFirstFrame(), 1);
+    TS_ASSERT_EQUALS(test->GetPoint(0)->GetFrameNumber(), 1000);
+    TS_ASSERT_EQUALS(test->GetPoint(0)->GetValues().coeff(2,0), -1.0);
+    TS_ASSERT_EQUALS(test->GetPoint(0)->GetValues().coeff(999,0), 999.0);
+    TS_ASSERT_EQUALS(test->GetPoint(1)->GetValues().coeff(500,1), 1.0);
+    TS_ASSERT_EQUALS(test->GetPoint(1)->GetValues().coeff(500,2), 1000.0);
+    TS_ASSERT_EQUALS(test->GetPoint(1)->GetResiduals().coeff(500), 0.5);
+    TS_ASSERT_EQUALS(test->GetAnalog(0)->GetValues().coeff(7), 7.0);
+    TS_ASSERT_EQUALS(test->GetAnalog(0)->GetValues().coeff(1999), 1999.0);
+    
+    test->PackValues();
+    test->AppendFrames(2, 0); // Null values
+    test->CommitFrames();
+    TS_ASSERT_EQUALS(test->GetPointFrameNumber(), 1002);
+    TS_ASSERT_EQUALS(test->GetPoint(0)->GetValues().coeff(1001,0), 0.0);
+    TS_ASSERT_EQUALS(test->GetAnalog(0)->GetValues().coeff(1999), 1999.0);
+    TS_ASSERT_EQUALS(test->GetAnalog(0)->GetValues().coeff(2003), 0.0);
+    
+    test->AppendFrames(1, points);
+    test->ResizePointNumber(3); // Commit the appended frame before
+    TS_ASSERT_EQUALS(test->GetPointFrameNumber(), 1003);
+    TS_ASSERT_EQUALS(test->GetPoint(1)->GetValues().coeff(1002,2), 1998.0);
+    TS_ASSERT_EQUALS(test->GetPoint(2)->GetFrameNumber(), 1003);
+    double points3[9] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0};
+    test->AppendFrames(1, points3);
+    TS_ASSERT_EQUALS(test->GetBufferedFrameNumber(), 1004);
+    test->AppendPoint(btk::Point::New("Direct", 1003));
+    test->AppendFrames(1, points3);
+    TS_ASSERT_EQUALS(test->GetBufferedFrameNumber(), 1004); // Rejected
+    test->ResizeFrameNumber(1010); // Commit the appended frame before
+    TS_ASSERT_EQUALS(test->GetPointFrameNumber(), 1010);
+    TS_ASSERT_EQUALS(test->GetPoint(2)->GetValues().coeff(1003,2), 9.0);
+    TS_ASSERT_EQUALS(test->GetPoint(2)->GetValues().coeff(1004,2), 0.0);
+    TS_ASSERT_EQUALS(test->GetPoint(3)->GetFrameNumber(), 1010);
+    TS_ASSERT_EQUALS(test->GetPoint(3)->GetValues().coeff(1003,0), 0.0);
+    
+    test->AppendFrames(1, points3);
+    test->Reset(); // Discard the appended frame
+    TS_ASSERT_EQUALS(test->GetBufferedFrameNumber(), 0);
+    test->CommitFrames();
+    TS_ASSERT_EQUALS(test->GetPointFrameNumber(), 0);
+  };
+  
+  CXXTEST_TEST(AppendFramesRingBuffer)
+  {
+    btk::Acquisition::Pointer test = btk::Acquisition::New();
+    test->Init(1,0,1,1);
+    test->SetFirstFrame(5);
+    test->SetRingBufferDuration(0.5);
+    TS_ASSERT_EQUALS(test->GetRingBufferDuration(), 0.5);
+    test->AppendFrames(1, 0);
+    TS_ASSERT_EQUALS(test->GetBufferedFrameNumber(), 0); // No frequency
+    test->SetPointFrequency(100.0);
+    test->AppendEvent(btk::Event::New("Foot Strike", 150, "Right"));
+    test->AppendEvent(btk::Event::New("Foot Off", 200, "Right"));
+    test->AppendEvent(btk::Event::New("Foot Strike", 1.5, "Left"));
+    test->AppendEvent(btk::Event::New("Foot Off", 2.0, "Left"));
+    double points[30], analogs[10];
+    for (int f = 0 ; f < 23 ; ++f)
+    {
+      for (int i = 0 ; i < 10 ; ++i)
+      {
+        points[i*3] = f * 10 + i; points[i*3+1] = 0.0; points[i*3+2] = 0.0;
+        analogs[i] = -1.0 * (f * 10 + i);
+      }
+      test->AppendFrames(10, points, 0, analogs);
+      if (f == 11)
+        test->CommitFrames();
+    }
+    TS_ASSERT_EQUALS(test->GetBufferedFrameNumber(), 50);
+    test->CommitFrames();
+    TS_ASSERT_EQUALS(test->GetPointFrameNumber(), 50);
+    TS_ASSERT_EQUALS(test->GetFirstFrame(), 185);
+    TS_ASSERT_EQUALS(test->GetPoint(0)->GetValues().coeff(0,0), 180.0);
+    TS_ASSERT_EQUALS(test->GetPoint(0)->GetValues().coeff(49,0), 229.0);
+    TS_ASSERT_EQUALS(test->GetAnalog(0)->GetValues().coeff(49), -229.0);
+    // Events before the new first frame removed
+    TS_ASSERT_EQUALS(test->GetEventNumber(), 2);
+    TS_ASSERT_EQUALS(test->GetEvent(0)->GetFrame(), 200);
+    TS_ASSERT_EQUALS(test->GetEvent(1)->GetTime(), 2.0);
+    // Full ring: the new frames replace the oldest ones in the storage of the measures
+    points[0] = 230.0;
+    test->AppendFrames(1, points);
+    test->CommitFrames();
+    TS_ASSERT_EQUALS(test->GetPoint(0)->GetData()->GetFrameCapacity(), 50);
+    TS_ASSERT_EQUALS(test->GetPointFrameNumber(), 50);
+    TS_ASSERT_EQUALS(test->GetFirstFrame(), 186);
+    TS_ASSERT_EQUALS(test->GetPoint(0)->GetValues().coeff(0,0), 181.0);
+    TS_ASSERT_EQUALS(test->GetPoint(0)->GetValues().coeff(49,0), 230.0);
+    
+    test->SetRingBufferDuration(0.0);
+    test->AppendFrames(1, points);
+    test->CommitFrames();
+    TS_ASSERT_EQUALS(test->GetPointFrameNumber(), 51);
+    TS_ASSERT_EQUALS(test->GetFirstFrame(), 186);
+    TS_ASSERT_EQUALS(test->GetPoint(0)->GetValues().coeff(0,0), 181.0);
+  };
+  
+  CXXTEST_TEST(CommitFramesCapacity)
+  {
+    btk::Acquisition::Pointer test = btk::Acquisition::New();
+    test->Init(1,0,1,2);
+    test->SetPointFrequency(100.0);
+    // Read only (the non-const accessors copy the values in a matrix without spare capacity)
+    btk::Point::ConstPointer point = test->GetPoint(0);
+    btk::Analog::ConstPointer analog = test->GetAnalog(0);
+    double points[3], residuals[1], analogs[2];
+    int capacity = 0, reallocations = 0;
+    for (int f = 0 ; f < 1000 ; ++f)
+    {
+      points[0] = f; points[1] = 0.0; points[2] = -f;
+      residuals[0] = (f % 10 == 0) ? -1.0 : 0.5;
+      analogs[0] = 2.0 * f; analogs[1] = 2.0 * f + 1.0;
+      test->AppendFrames(1, points, residuals, analogs);
+      test->CommitFrames();
+      if (point->GetData()->GetFrameCapacity() != capacity)
+      {
+        capacity = point->GetData()->GetFrameCapacity();
+        ++reallocations;
+      }
+      TS_ASSERT_EQUALS(point->GetValues().coeff(f,2), -f);
+    }
+    TS_ASSERT_EQUALS(point->GetFrameNumber(), 1000);
+    TS_ASSERT_EQUALS(analog->GetFrameNumber(), 2000);
+    TS_ASSERT(capacity < 2000);
+    TS_ASSERT(reallocations <= 11);
+    TS_ASSERT_EQUALS(point->GetValues().coeff(999,0), 999.0);
+    TS_ASSERT_EQUALS(point->GetResiduals().coeff(990), -1.0);
+    TS_ASSERT_EQUALS(point->GetResiduals().coeff(999), 0.5);
+    TS_ASSERT_EQUALS(point->GetOcclusionMask().GetOccludedFrameNumber(), 100);
+    TS_ASSERT_EQUALS(analog->GetValues().coeff(1999), 1999.0);
+    // Ring: the storage is reduced to the duration and then reused
+    test->SetRingBufferDuration(0.5);
+    for (int f = 1000 ; f < 1125 ; ++f)
+    {
+      points[0] = f; points[1] = 0.0; points[2] = -f;
+      analogs[0] = 2.0 * f; analogs[1] = 2.0 * f + 1.0;
+      test->AppendFrames(1, points, residuals, analogs);
+      test->CommitFrames();
+      TS_ASSERT_EQUALS(point->GetData()->GetFrameCapacity(), 50);
+      TS_ASSERT_EQUALS(analog->GetData()->GetFrameCapacity(), 100);
+    }
+    TS_ASSERT_EQUALS(test->GetPointFrameNumber(), 50);
+    TS_ASSERT_EQUALS(test->GetFirstFrame(), 1076);
+    TS_ASSERT_EQUALS(point->GetValues().coeff(0,0), 1075.0);
+    TS_ASSERT_EQUALS(point->GetValues().coeff(49,0), 1124.0);
+    TS_ASSERT_EQUALS(analog->GetValues().coeff(0), 2150.0);
+    TS_ASSERT_EQUALS(analog->GetValues().coeff(99), 2249.0);
+    // Copies share the appended values until one of them is modified
+    btk::Acquisition::Pointer copy = test->Clone();
+    TS_ASSERT(point->GetData()->IsValuesShared());
+    copy->GetPoint(0)->GetValues().coeffRef(0,0) = 0.0;
+    TS_ASSERT(!point->GetData()->IsValuesShared());
+    TS_ASSERT_EQUALS(point->GetValues().coeff(0,0), 1075.0);
+    test->AppendFrames(1, points, residuals, analogs);
+    test->CommitFrames();
+    TS_ASSERT_EQUALS(point->GetValues().coeff(49,0), 1124.0);
+    TS_ASSERT_EQUALS(copy->GetPoint(0)->GetFrameNumber(), 50);
+    TS_ASSERT_EQUALS(copy->GetPoint(0)->GetValues().coeff(1,0), 1076.0);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(AcquisitionTest)
@@ -172,4 +377,8 @@ CXXTEST_TEST_REGISTRATION(AcquisitionTest, ResizeFromEnd)
 CXXTEST_TEST_REGISTRATION(AcquisitionTest, RemoveLastPoint)
 CXXTEST_TEST_REGISTRATION(AcquisitionTest, SetFirstFrameAdaptEvent)
 CXXTEST_TEST_REGISTRATION(AcquisitionTest, ResizeParent)
+CXXTEST_TEST_REGISTRATION(AcquisitionTest, PackValues)
+CXXTEST_TEST_REGISTRATION(AcquisitionTest, AppendFrames)
+CXXTEST_TEST_REGISTRATION(AcquisitionTest, AppendFramesRingBuffer)
+CXXTEST_TEST_REGISTRATION(AcquisitionTest, CommitFramesCapacity)
 #endif
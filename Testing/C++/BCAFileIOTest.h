@@ -0,0 +1,160 @@
+#ifndef BCAFileIOTest_h
+#define BCAFileIOTest_h
+
+#include <btkBCAFileIO.h>
+#include <btkC3DFileIO.h>
+
+#if defined(_OPENMP)
+  #include <omp.h>
+#endif
+
+CXXTEST_SUITE(BCAFileIOTest)
+{
+  CXXTEST_TEST(CanReadFileEmpty)
+  {
+    btk::BCAFileIO::Pointer pt = btk::BCAFileIO::New();
+    TS_ASSERT_EQUALS(pt->CanReadFile(""), false);
+  };
+  
+  CXXTEST_TEST(CanReadFileFail)
+  {
+    btk::BCAFileIO::Pointer pt = btk::BCAFileIO::New();
+    TS_ASSERT_EQUALS(pt->CanReadFile(C3DFilePathIN + "others/Gait.c3d"), false);
+  };
+  
+  CXXTEST_TEST(CanWriteFileEmpty)
+  {
+    btk::BCAFileIO::Pointer pt = btk::BCAFileIO::New();
+    TS_ASSERT_EQUALS(pt->CanWriteFile(""), false);
+  };
+  
+  CXXTEST_TEST(CanWriteFileFail)
+  {
+    btk::BCAFileIO::Pointer pt = btk::BCAFileIO::New();
+    TS_ASSERT_EQUALS(pt->CanWriteFile("test.jpeg"), false);
+  };
+  
+  CXXTEST_TEST(CanWriteFileOk)
+  {
+    btk::BCAFileIO::Pointer pt = btk::BCAFileIO::New();
+    TS_ASSERT_EQUALS(pt->CanWriteFile("test.bca"), true);
+  };
+  
+  CXXTEST_TEST(ChunkSize)
+  {
+    btk::BCAFileIO::Pointer pt = btk::BCAFileIO::New();
+    TS_ASSERT_EQUALS(pt->GetChunkSize(), 4096);
+    pt->SetChunkSize(100);
+    TS_ASSERT_EQUALS(pt->GetChunkSize(), 100);
+    pt->SetChunkSize(0); // Error message and no modification
+    TS_ASSERT_EQUALS(pt->GetChunkSize(), 100);
+  };
+  
+  CXXTEST_TEST(ParallelDecoding)
+  {
+#if !defined(_OPENMP)
+    TS_WARN("BTK is compiled without OpenMP: the chunks are decoded sequentially.");
+#else
+    omp_set_dynamic(0); // The requested number of threads must be used
+#endif
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(3, 5000, 4, 2);
+    acq->SetPointFrequency(200.0);
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      for (int j = 0 ; j < 5000 ; ++j)
+        acq->GetPoint(i)->GetValues().row(j) << 0.1 * j + 0.001 * i, 10.0 * i - 0.05 * j, std::sin(0.01 * j);
+      acq->GetPoint(i)->GetResiduals().segment(100 * (i + 1), 50).setConstant(-1.0);
+    }
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+      for (int j = 0 ; j < 10000 ; ++j)
+        acq->GetAnalog(i)->GetValues().coeffRef(j) = 0.01 * ((j * (i + 3)) % 1000) - 5.0;
+    }
+    btk::BCAFileIO::Pointer writer = btk::BCAFileIO::New();
+    TS_ASSERT_EQUALS(writer->GetThreadNumber(), 0);
+    writer->SetChunkSize(256); // 20 chunks by point and 40 by analog channel
+    writer->SetThreadNumber(4);
+    std::vector<char> buffer;
+    writer->WriteBuffer(&buffer, acq);
+    
+    // Whole acquisition and range of frames
+    for (int r = 0 ; r < 2 ; ++r)
+    {
+      const int lb = (r == 0) ? 0 : 1000;
+      const int num = (r == 0) ? 5000 : 2001;
+      btk::BCAFileIO::Pointer io = btk::BCAFileIO::New();
+      io->SetThreadNumber(4);
+      if (r != 0)
+        io->SetFramesIndex(lb, lb + num - 1);
+      btk::Acquisition::Pointer output = btk::Acquisition::New();
+      io->ReadBuffer(&buffer[0], buffer.size(), output);
+      TS_ASSERT_EQUALS(output->GetPointFrameNumber(), num);
+      TS_ASSERT_EQUALS(output->GetAnalogFrameNumber(), 2 * num);
+      TS_ASSERT_EQUALS(output->GetPointNumber(), 3);
+      TS_ASSERT_EQUALS(output->GetAnalogNumber(), 4);
+      for (int i = 0 ; i < output->GetPointNumber() ; ++i)
+      {
+        TS_ASSERT(output->GetPoint(i)->GetValues() == acq->GetPoint(i)->GetValues().middleRows(lb, num)); // Lossless
+        TS_ASSERT(output->GetPoint(i)->GetResiduals() == acq->GetPoint(i)->GetResiduals().segment(lb, num));
+      }
+      for (int i = 0 ; i < output->GetAnalogNumber() ; ++i)
+        TS_ASSERT(output->GetAnalog(i)->GetValues() == acq->GetAnalog(i)->GetValues().segment(2 * lb, 2 * num));
+    }
+  };  
+  CXXTEST_TEST(SmallerThanC3D)
+  {
+    // Trajectories and analog channels as read from a C3D file (single precision, ADC steps).
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(20, 3000, 8, 10);
+    acq->SetPointFrequency(100.0);
+    for (int i = 0 ; i < 20 ; ++i)
+    {
+      for (int j = 0 ; j < 3000 ; ++j)
+        acq->GetPoint(i)->GetValues().row(j) << static_cast<float>(100.0 * i + 500.0 * std::sin(0.01 * j + i)), 
+                                                static_cast<float>(200.0 * std::cos(0.013 * j)), 
+                                                static_cast<float>(900.0 + 50.0 * std::sin(0.02 * j + 0.3 * i));
+    }
+    for (int i = 0 ; i < 8 ; ++i)
+    {
+      for (int j = 0 ; j < 30000 ; ++j)
+        acq->GetAnalog(i)->GetValues().coeffRef(j) = 0.0048828125 * static_cast<int>(400.0 * std::sin(0.002 * j + i) + ((j * 7919) % 13) - 6);
+    }
+    btk::Acquisition::Pointer cloned = acq->Clone();
+    std::vector<char> bca, c3dFloat, c3dInteger;
+    btk::BCAFileIO::New()->WriteBuffer(&bca, acq);
+    // The writer only reads the values: they are still shared with the clone.
+    for (int i = 0 ; i < 20 ; ++i)
+    {
+      TS_ASSERT_EQUALS(acq->GetPoint(i)->GetData()->IsValuesShared(), true);
+      TS_ASSERT_EQUALS(acq->GetPoint(i)->GetData()->IsResidualsShared(), true);
+    }
+    for (int i = 0 ; i < 8 ; ++i)
+      TS_ASSERT_EQUALS(acq->GetAnalog(i)->GetData()->IsValuesShared(), true);
+    btk::C3DFileIO::Pointer c3d = btk::C3DFileIO::New();
+    c3d->SetStorageFormat(btk::AcquisitionFileIO::Float);
+    c3d->WriteBuffer(&c3dFloat, acq);
+    c3d->SetStorageFormat(btk::AcquisitionFileIO::Integer);
+    c3d->WriteBuffer(&c3dInteger, acq);
+    // Lossless and smaller than the C3D formats (about 1/3 of the float format and 2/3 of the integer format).
+    TS_ASSERT_LESS_THAN(bca.size(), c3dFloat.size() / 2);
+    TS_ASSERT_LESS_THAN(bca.size(), c3dInteger.size());
+    btk::Acquisition::Pointer output = btk::Acquisition::New();
+    btk::BCAFileIO::New()->ReadBuffer(&bca[0], bca.size(), output);
+    for (int i = 0 ; i < 20 ; ++i)
+      TS_ASSERT(output->GetPoint(i)->GetValues() == acq->GetPoint(i)->GetValues());
+    for (int i = 0 ; i < 8 ; ++i)
+      TS_ASSERT(output->GetAnalog(i)->GetValues() == acq->GetAnalog(i)->GetValues());
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(BCAFileIOTest)
+CXXTEST_TEST_REGISTRATION(BCAFileIOTest, CanReadFileEmpty)
+CXXTEST_TEST_REGISTRATION(BCAFileIOTest, CanReadFileFail)
+CXXTEST_TEST_REGISTRATION(BCAFileIOTest, CanWriteFileEmpty)
+CXXTEST_TEST_REGISTRATION(BCAFileIOTest, CanWriteFileFail)
+CXXTEST_TEST_REGISTRATION(BCAFileIOTest, CanWriteFileOk)
+CXXTEST_TEST_REGISTRATION(BCAFileIOTest, ChunkSize)
+CXXTEST_TEST_REGISTRATION(BCAFileIOTest, ParallelDecoding)
+CXXTEST_TEST_REGISTRATION(BCAFileIOTest, SmallerThanC3D)
+#endif
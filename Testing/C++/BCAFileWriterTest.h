@@ -0,0 +1,105 @@
+#ifndef BCAFileWriterTest_h
+#define BCAFileWriterTest_h
+
+#include <btkAcquisitionFileWriter.h>
+#include <btkAcquisitionFileReader.h>
+#include <btkBCAFileIO.h>
+
+CXXTEST_SUITE(BCAFileWriterTest)
+{
+  CXXTEST_TEST(NoFileWithIO)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(C3DFilePathIN + "others/Gait.c3d");
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    btk::BCAFileIO::Pointer io = btk::BCAFileIO::New();
+    writer->SetAcquisitionIO(io);
+    TS_ASSERT_THROWS_EQUALS(writer->Update(), const btk::AcquisitionFileWriterException &e, e.what(), std::string("Filename must be specified."));
+  };
+  
+  CXXTEST_TEST(Gait_from_c3d)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(C3DFilePathIN + "others/Gait.c3d");
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    btk::BCAFileIO::Pointer io = btk::BCAFileIO::New();
+    io->SetChunkSize(100); // Several chunks by channel
+    writer->SetAcquisitionIO(io);
+    writer->SetInput(reader->GetOutput());
+    writer->SetFilename(BCAFilePathOUT + "Gait_from_c3d.bca");
+    writer->Update();
+    
+    btk::AcquisitionFileReader::Pointer reader2 = btk::AcquisitionFileReader::New();
+    reader2->SetFilename(BCAFilePathOUT + "Gait_from_c3d.bca");
+    reader2->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    btk::Acquisition::Pointer acq2 = reader2->GetOutput();
+    
+    TS_ASSERT_EQUALS(acq->GetFirstFrame(), acq2->GetFirstFrame());
+    TS_ASSERT_EQUALS(acq->GetPointFrequency(), acq2->GetPointFrequency());
+    TS_ASSERT_EQUALS(acq->GetPointNumber(), acq2->GetPointNumber());
+    TS_ASSERT_EQUALS(acq->GetPointFrameNumber(), acq2->GetPointFrameNumber());
+    TS_ASSERT_EQUALS(acq->GetAnalogFrequency(), acq2->GetAnalogFrequency());
+    TS_ASSERT_EQUALS(acq->GetAnalogNumber(), acq2->GetAnalogNumber());
+    TS_ASSERT_EQUALS(acq->GetEventNumber(), acq2->GetEventNumber());
+    TS_ASSERT_EQUALS(acq->GetPointUnit(), acq2->GetPointUnit());
+    TS_ASSERT(*(acq->GetMetaData()) == *(acq2->GetMetaData()));
+    
+    for (int i = 0 ; i < acq->GetPointNumber() ; ++i)
+    {
+      TS_ASSERT_EQUALS(acq->GetPoint(i)->GetLabel(), acq2->GetPoint(i)->GetLabel());
+      TS_ASSERT_EQUALS(acq->GetPoint(i)->GetType(), acq2->GetPoint(i)->GetType());
+      TS_ASSERT(acq->GetPoint(i)->GetValues() == acq2->GetPoint(i)->GetValues()); // Lossless
+      TS_ASSERT(acq->GetPoint(i)->GetResiduals() == acq2->GetPoint(i)->GetResiduals());
+    }
+    for (int i = 0 ; i < acq->GetAnalogNumber() ; ++i)
+    {
+      TS_ASSERT_EQUALS(acq->GetAnalog(i)->GetLabel(), acq2->GetAnalog(i)->GetLabel());
+      TS_ASSERT_EQUALS(acq->GetAnalog(i)->GetUnit(), acq2->GetAnalog(i)->GetUnit());
+      TS_ASSERT_EQUALS(acq->GetAnalog(i)->GetScale(), acq2->GetAnalog(i)->GetScale());
+      TS_ASSERT(acq->GetAnalog(i)->GetValues() == acq2->GetAnalog(i)->GetValues());
+    }
+  };
+  
+  CXXTEST_TEST(Gait_from_c3d_partial)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(C3DFilePathIN + "others/Gait.c3d");
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    btk::BCAFileIO::Pointer io = btk::BCAFileIO::New();
+    io->SetChunkSize(100);
+    writer->SetAcquisitionIO(io);
+    writer->SetInput(reader->GetOutput());
+    writer->SetFilename(BCAFilePathOUT + "Gait_from_c3d_partial.bca");
+    writer->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    
+    btk::AcquisitionFileReader::Pointer reader2 = btk::AcquisitionFileReader::New();
+    btk::BCAFileIO::Pointer io2 = btk::BCAFileIO::New();
+    std::list<std::string> labels;
+    labels.push_back(acq->GetPoint(2)->GetLabel());
+    labels.push_back(acq->GetAnalog(1)->GetLabel());
+    io2->SetLabelsToRead(labels);
+    io2->SetFramesIndex(150, 249);
+    reader2->SetAcquisitionIO(io2);
+    reader2->SetFilename(BCAFilePathOUT + "Gait_from_c3d_partial.bca");
+    reader2->Update();
+    btk::Acquisition::Pointer acq2 = reader2->GetOutput();
+    
+    TS_ASSERT_EQUALS(acq2->GetFirstFrame(), acq->GetFirstFrame() + 150);
+    TS_ASSERT_EQUALS(acq2->GetPointFrameNumber(), 100);
+    TS_ASSERT_EQUALS(acq2->GetPointNumber(), 1);
+    TS_ASSERT_EQUALS(acq2->GetAnalogNumber(), 1);
+    TS_ASSERT_EQUALS(acq2->GetPoint(0)->GetLabel(), acq->GetPoint(2)->GetLabel());
+    TS_ASSERT_EQUALS(acq2->GetAnalog(0)->GetLabel(), acq->GetAnalog(1)->GetLabel());
+    int r = acq->GetNumberAnalogSamplePerFrame();
+    TS_ASSERT(acq2->GetPoint(0)->GetValues() == acq->GetPoint(2)->GetValues().block(150, 0, 100, 3));
+    TS_ASSERT(acq2->GetAnalog(0)->GetValues() == acq->GetAnalog(1)->GetValues().block(150 * r, 0, 100 * r, 1));
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(BCAFileWriterTest)
+CXXTEST_TEST_REGISTRATION(BCAFileWriterTest, NoFileWithIO)
+CXXTEST_TEST_REGISTRATION(BCAFileWriterTest, Gait_from_c3d)
+CXXTEST_TEST_REGISTRATION(BCAFileWriterTest, Gait_from_c3d_partial)
+#endif
@@ -0,0 +1,129 @@
+#ifndef Base64DecoderTest_h
+#define Base64DecoderTest_h
+
+#include <btkBase64Decoder_p.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Reference encoder (RFC 4648) with an optional line break every @a lineLength characters.
+static std::string btk_base64_encode(const std::string& data, size_t lineLength = 0)
+{
+  static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string str;
+  for (size_t i = 0 ; i < data.size() ; i += 3)
+  {
+    const size_t num = std::min<size_t>(3, data.size() - i);
+    unsigned int quantum = static_cast<unsigned char>(data[i]) << 16;
+    if (num > 1) quantum |= static_cast<unsigned char>(data[i+1]) << 8;
+    if (num > 2) quantum |= static_cast<unsigned char>(data[i+2]);
+    for (size_t j = 0 ; j < 4 ; ++j)
+    {
+      if ((lineLength != 0) && (str.size() % (lineLength + 1) == lineLength))
+        str += '\n';
+      str += (j <= num) ? alphabet[(quantum >> (18 - 6 * j)) & 0x3F] : '=';
+    }
+  }
+  return str;
+};
+
+// Decode @a str in blocks of @a chunk characters (all the string if 0).
+static std::string btk_base64_decode(const std::string& str, bool vectorized, size_t chunk = 0)
+{
+  btk::Base64Decoder_p decoder(vectorized);
+  std::vector<char> buffer(btk::Base64Decoder_p::MaxDecodedLength(str.size()));
+  size_t num = 0;
+  if (chunk == 0)
+    chunk = str.size();
+  for (size_t i = 0 ; i < str.size() ; i += chunk)
+    num += decoder.Decode(str.data() + i, std::min(chunk, str.size() - i), &(buffer[num]));
+  return std::string(buffer.begin(), buffer.begin() + num);
+};
+
+static std::string btk_base64_random_data(size_t num)
+{
+  std::string data(num, '\0');
+  for (size_t i = 0 ; i < num ; ++i)
+    data[i] = static_cast<char>(rand() & 0xFF);
+  return data;
+};
+
+CXXTEST_SUITE(Base64DecoderTest)
+{
+  CXXTEST_TEST(Padding)
+  {
+    const char* encoded[7] = {"", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+    const char* decoded[7] = {"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+    for (int v = 0 ; v < 2 ; ++v)
+    {
+      for (int i = 0 ; i < 7 ; ++i)
+        TS_ASSERT_EQUALS(btk_base64_decode(encoded[i], v == 1), decoded[i]);
+      // The padding ends the data
+      TS_ASSERT_EQUALS(btk_base64_decode("Zm8=Zm9v", v == 1), "fo");
+      TS_ASSERT_EQUALS(btk_base64_decode("Zg==Zm9vYmFyZm9vYmFyZm9vYmFy", v == 1), "f");
+    }
+  };
+  
+  CXXTEST_TEST(ChunkBoundaries)
+  {
+    // Lengths around the blocks of 16 characters (12 bytes) decoded together.
+    for (size_t num = 0 ; num < 100 ; ++num)
+    {
+      const std::string data = btk_base64_random_data(num);
+      const std::string str = btk_base64_encode(data);
+      for (int v = 0 ; v < 2 ; ++v)
+      {
+        TS_ASSERT_EQUALS(btk_base64_decode(str, v == 1), data);
+        // Chunks not aligned on the groups of 4 characters or on the blocks of 16 characters.
+        const size_t chunks[6] = {1, 3, 15, 16, 17, 33};
+        for (int c = 0 ; c < 6 ; ++c)
+          TS_ASSERT_EQUALS(btk_base64_decode(str, v == 1, chunks[c]), data);
+      }
+    }
+  };
+  
+  CXXTEST_TEST(Whitespaces)
+  {
+    const std::string data = btk_base64_random_data(300);
+    const size_t lineLengths[5] = {4, 15, 16, 17, 76};
+    for (int l = 0 ; l < 5 ; ++l)
+    {
+      const std::string str = btk_base64_encode(data, lineLengths[l]);
+      for (int v = 0 ; v < 2 ; ++v)
+      {
+        TS_ASSERT_EQUALS(btk_base64_decode(str, v == 1), data);
+        TS_ASSERT_EQUALS(btk_base64_decode(str, v == 1, 16), data);
+      }
+    }
+    // Other whitespaces inside a block of 16 characters
+    std::string str = btk_base64_encode(data);
+    str.insert(20, " ");
+    str.insert(5, "\r\n\t");
+    str = "  " + str + "\n";
+    TS_ASSERT_EQUALS(btk_base64_decode(str, false), data);
+    TS_ASSERT_EQUALS(btk_base64_decode(str, true), data);
+  };
+  
+  CXXTEST_TEST(ScalarAndVectorized)
+  {
+    // Without SSSE3 support (see Base64Decoder_p::IsVectorizationSupported()), both decodings are scalar.
+    for (int i = 0 ; i < 200 ; ++i)
+    {
+      const std::string data = btk_base64_random_data(rand() % 2000);
+      const std::string str = btk_base64_encode(data, (i % 2) ? 76 : 0);
+      const size_t chunk = 1 + rand() % 100;
+      const std::string scalar = btk_base64_decode(str, false, chunk);
+      TS_ASSERT_EQUALS(scalar, data);
+      TS_ASSERT_EQUALS(btk_base64_decode(str, true, chunk), scalar);
+    }
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(Base64DecoderTest)
+CXXTEST_TEST_REGISTRATION(Base64DecoderTest, Padding)
+CXXTEST_TEST_REGISTRATION(Base64DecoderTest, ChunkBoundaries)
+CXXTEST_TEST_REGISTRATION(Base64DecoderTest, Whitespaces)
+CXXTEST_TEST_REGISTRATION(Base64DecoderTest, ScalarAndVectorized)
+#endif
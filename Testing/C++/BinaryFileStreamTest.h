@@ -394,6 +394,41 @@ CXXTEST_SUITE(BinaryFileStreamTest)
     TS_ASSERT_THROWS(bfs.ReadI8(), btk::BinaryFileStreamFailure);
   };
   
+  CXXTEST_TEST(ReadBlock16)
+  {
+    std::string filename = C3DFilePathOUT + "block16.bin";
+    btk::IEEELittleEndianBinaryFileStream le(filename, btk::BinaryFileStream::Out);
+    for (int i = 0 ; i < 1001 ; ++i)
+      le.Write(static_cast<int16_t>(37 * i - 18000));
+    le.Close();
+    std::vector<int16_t> i16(1001);
+    std::vector<uint16_t> u16(1001);
+    le.Open(filename, btk::BinaryFileStream::In);
+    le.ReadI16(i16);
+    le.SeekRead(0, btk::BinaryFileStream::Begin);
+    le.ReadU16(1001, &(u16[0]));
+    le.Close();
+    for (int i = 0 ; i < 1001 ; ++i)
+    {
+      TS_ASSERT_EQUALS(i16[i], static_cast<int16_t>(37 * i - 18000));
+      TS_ASSERT_EQUALS(u16[i], static_cast<uint16_t>(37 * i - 18000));
+    }
+    
+    btk::IEEEBigEndianBinaryFileStream be(filename, btk::BinaryFileStream::Out);
+    for (int i = 0 ; i < 1001 ; ++i)
+      be.Write(static_cast<int16_t>(37 * i - 18000));
+    be.Close();
+    be.Open(filename, btk::BinaryFileStream::In);
+    be.SetExceptions(btk::BinaryFileStream::EndFileBit | btk::BinaryFileStream::FailBit | btk::BinaryFileStream::BadBit);
+    TS_ASSERT_EQUALS(be.ReadI16(), -18000);
+    be.ReadI16(1000, &(i16[0]));
+    for (int i = 0 ; i < 1000 ; ++i)
+      TS_ASSERT_EQUALS(i16[i], static_cast<int16_t>(37 * (i + 1) - 18000));
+    be.SeekRead(0, btk::BinaryFileStream::Begin);
+    TS_ASSERT_THROWS(be.ReadU16(1002, &(u16[0])), btk::BinaryFileStreamFailure);
+    TS_ASSERT_EQUALS(be.EndFile(), true);
+  };
+  
   CXXTEST_TEST(Write)
   {
     std::string filename = C3DFilePathOUT + "mmfstream.c3d";
@@ -484,6 +519,7 @@ CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, SeekReadCurrentInvalidForward)
 CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, SeekReadCurrentInvalidBackward)
 CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, SeekReadCurrentInvalidBackwardBis)
 CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, ReadEOFException)
+CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, ReadBlock16)
 CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, Write)
 CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, SeekWrite)
 CXXTEST_TEST_REGISTRATION(BinaryFileStreamTest, SuperSeekWrite)
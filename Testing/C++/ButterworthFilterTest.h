@@ -0,0 +1,164 @@
+#ifndef ButterworthFilterTest_h
+#define ButterworthFilterTest_h
+
+#include <btkButterworthFilter.h>
+#include <btkEigen/SignalProcessing/FiltFilt.h>
+#include <btkEigen/SignalProcessing/IIRFilterDesign.h>
+
+CXXTEST_SUITE(ButterworthFilterTest)
+{
+  CXXTEST_TEST(NoInput)
+  {
+    btk::ButterworthFilter::Pointer filter = btk::ButterworthFilter::New();
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetPointNumber(), 0);
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetAnalogNumber(), 0);
+  };
+  
+  CXXTEST_TEST(LowPass)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(2,200,1,5);
+    acq->SetPointFrequency(100.0);
+    for (int i = 0 ; i < 200 ; ++i)
+    {
+      acq->GetPoint(0)->GetValues().row(i).setConstant(std::sin(0.1 * i) + 0.1 * std::sin(2.5 * i));
+      acq->GetPoint(1)->GetValues().row(i).setConstant(std::cos(0.1 * i) + 0.1 * std::sin(2.5 * i));
+    }
+    for (int i = 0 ; i < 1000 ; ++i)
+      acq->GetAnalog(0)->GetValues().coeffRef(i) = std::sin(0.01 * i) + 0.1 * std::sin(2.5 * i);
+    
+    btk::ButterworthFilter::Pointer filter = btk::ButterworthFilter::New();
+    filter->SetInput(acq);
+    filter->SetCutoffFrequency(6.0);
+    filter->Update();
+    btk::Acquisition::Pointer output = filter->GetOutput();
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 2);
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), 1);
+    TS_ASSERT(output->GetPoint(0) != acq->GetPoint(0));
+    
+    Eigen::Matrix<double, Eigen::Dynamic, 1> b, a;
+    btkEigen::butter(&b, &a, 2, 6.0 / 50.0);
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> values = acq->GetPoint(0)->GetValues();
+    TS_ASSERT_EIGEN_DELTA(output->GetPoint(0)->GetValues(), btkEigen::filtfilt(b, a, values), 1e-10);
+    btkEigen::butter(&b, &a, 2, 6.0 / 250.0);
+    values = acq->GetAnalog(0)->GetValues();
+    TS_ASSERT_EIGEN_DELTA(output->GetAnalog(0)->GetValues(), btkEigen::filtfilt(b, a, values), 1e-10);
+  };
+  
+  CXXTEST_TEST(OccludedFrames)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(1,200);
+    acq->SetPointFrequency(100.0);
+    for (int i = 0 ; i < 200 ; ++i)
+      acq->GetPoint(0)->GetValues().row(i).setConstant(std::sin(0.1 * i) + 0.1 * std::sin(2.5 * i));
+    acq->GetPoint(0)->GetValues().block(100,0,10,3).setZero();
+    acq->GetPoint(0)->GetResiduals().segment(100,10).setConstant(-1.0);
+    acq->GetPoint(0)->GetResiduals().segment(195,2).setConstant(-1.0); // Segments too short to be filtered
+    
+    btk::ButterworthFilter::Pointer filter = btk::ButterworthFilter::New();
+    filter->SetInput(acq);
+    filter->SetCutoffFrequency(6.0);
+    filter->Update();
+    btk::Point::Pointer point = filter->GetOutput()->GetPoint(0);
+    
+    Eigen::Matrix<double, Eigen::Dynamic, 1> b, a;
+    btkEigen::butter(&b, &a, 2, 6.0 / 50.0);
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> values = acq->GetPoint(0)->GetValues().block(0,0,100,3);
+    TS_ASSERT_EIGEN_DELTA(point->GetValues().block(0,0,100,3), btkEigen::filtfilt(b, a, values), 1e-10);
+    values = acq->GetPoint(0)->GetValues().block(110,0,85,3);
+    TS_ASSERT_EIGEN_DELTA(point->GetValues().block(110,0,85,3), btkEigen::filtfilt(b, a, values), 1e-10);
+    TS_ASSERT_EQUALS(point->GetValues().block(100,0,10,3).cwiseAbs().maxCoeff(), 0.0);
+    TS_ASSERT_EIGEN_DELTA(point->GetValues().block(197,0,3,3), acq->GetPoint(0)->GetValues().block(197,0,3,3), 1e-15);
+  };
+  
+  CXXTEST_TEST(BandPassSelectedInPlace)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(2,200,2,10);
+    acq->SetPointFrequency(100.0);
+    acq->GetAnalog(0)->SetLabel("EMG1");
+    acq->GetAnalog(1)->SetLabel("EMG2");
+    for (int i = 0 ; i < 2000 ; ++i)
+    {
+      acq->GetAnalog(0)->GetValues().coeffRef(i) = 1.0 + std::sin(0.5 * i);
+      acq->GetAnalog(1)->GetValues().coeffRef(i) = 1.0 + std::sin(0.5 * i);
+    }
+    btk::Analog::Pointer emg1 = acq->GetAnalog(0);
+    btk::Point::Pointer point = acq->GetPoint(0);
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> values = emg1->GetValues();
+    
+    btk::ButterworthFilter::Pointer filter = btk::ButterworthFilter::New();
+    filter->SetInput(acq);
+    filter->SetBandType(btk::ButterworthFilter::BandPass);
+    filter->SetCutoffFrequencies(20.0, 400.0);
+    filter->SetPointsFiltered(false);
+    filter->SetAnalogLabels(std::list<std::string>(1, "EMG1"));
+    filter->SetInPlace(true);
+    filter->Update();
+    btk::Acquisition::Pointer output = filter->GetOutput();
+    TS_ASSERT_EQUALS(output->GetAnalog(0), emg1);
+    TS_ASSERT_EQUALS(output->GetPoint(0), point);
+    
+    Eigen::Matrix<double, Eigen::Dynamic, 1> b, a;
+    double wn[2] = {20.0 / 500.0, 400.0 / 500.0};
+    btkEigen::butter(&b, &a, 2, wn, btkEigen::BandPass);
+    TS_ASSERT_EIGEN_DELTA(emg1->GetValues(), btkEigen::filtfilt(b, a, values), 1e-10);
+    TS_ASSERT_DELTA(emg1->GetValues().mean(), 0.0, 1e-2); // Offset removed
+    TS_ASSERT_EQUALS(acq->GetAnalog(1)->GetValues().coeff(10), 1.0 + std::sin(5.0));
+  };
+  
+  CXXTEST_TEST(InvalidCutoffFrequency)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(1,200);
+    acq->SetPointFrequency(100.0);
+    for (int i = 0 ; i < 200 ; ++i)
+      acq->GetPoint(0)->GetValues().row(i).setConstant(std::sin(0.1 * i));
+    btk::ButterworthFilter::Pointer filter = btk::ButterworthFilter::New();
+    filter->SetInput(acq);
+    filter->SetCutoffFrequency(60.0);
+    filter->Update();
+    btk::Acquisition::Pointer output = filter->GetOutput();
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 1);
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 200);
+    TS_ASSERT_EIGEN_DELTA(output->GetPoint(0)->GetValues(), acq->GetPoint(0)->GetValues(), 1e-15);
+  };
+  
+  CXXTEST_TEST(InvalidCutoffFrequencyForPointsOnlyInPlace)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(1,200,1,10);
+    acq->SetPointFrequency(100.0);
+    for (int i = 0 ; i < 200 ; ++i)
+      acq->GetPoint(0)->GetValues().row(i).setConstant(std::sin(0.1 * i) + 0.1 * std::sin(2.5 * i));
+    for (int i = 0 ; i < 2000 ; ++i)
+      acq->GetAnalog(0)->GetValues().coeffRef(i) = std::sin(0.01 * i) + 0.1 * std::sin(2.5 * i);
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> points = acq->GetPoint(0)->GetValues();
+    Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic> analogs = acq->GetAnalog(0)->GetValues();
+    
+    btk::ButterworthFilter::Pointer filter = btk::ButterworthFilter::New();
+    filter->SetInput(acq);
+    filter->SetCutoffFrequency(60.0); // Above the Nyquist frequency of the points only
+    filter->SetInPlace(true);
+    filter->Update();
+    btk::Acquisition::Pointer output = filter->GetOutput();
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 1);
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), 1);
+    TS_ASSERT_EIGEN_DELTA(acq->GetPoint(0)->GetValues(), points, 1e-15);
+    
+    Eigen::Matrix<double, Eigen::Dynamic, 1> b, a;
+    btkEigen::butter(&b, &a, 2, 60.0 / 500.0);
+    TS_ASSERT_EIGEN_DELTA(output->GetAnalog(0)->GetValues(), btkEigen::filtfilt(b, a, analogs), 1e-10);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(ButterworthFilterTest)
+CXXTEST_TEST_REGISTRATION(ButterworthFilterTest, NoInput)
+CXXTEST_TEST_REGISTRATION(ButterworthFilterTest, LowPass)
+CXXTEST_TEST_REGISTRATION(ButterworthFilterTest, OccludedFrames)
+CXXTEST_TEST_REGISTRATION(ButterworthFilterTest, BandPassSelectedInPlace)
+CXXTEST_TEST_REGISTRATION(ButterworthFilterTest, InvalidCutoffFrequency)
+CXXTEST_TEST_REGISTRATION(ButterworthFilterTest, InvalidCutoffFrequencyForPointsOnlyInPlace)
+#endif
@@ -3,6 +3,10 @@
 
 #include <btkC3DFileIO.h>
 
+#if defined(_OPENMP)
+  #include <omp.h>
+#endif
+
 CXXTEST_SUITE(C3DFileIOTest)
 {
   CXXTEST_TEST(AvailableOperations)
@@ -52,6 +56,65 @@ CXXTEST_SUITE(C3DFileIOTest)
     btk::C3DFileIO::Pointer pt = btk::C3DFileIO::New();
     TS_ASSERT_EQUALS(pt->CanWriteFile("test.c3d"), true);
   };
+  
+  CXXTEST_TEST(ParallelDecoding)
+  {
+#if !defined(_OPENMP)
+    TS_WARN("BTK is compiled without OpenMP: the frames are decoded sequentially.");
+#else
+    omp_set_dynamic(0); // The requested number of threads must be used
+#endif
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(3, 5000, 4, 2);
+    acq->SetPointFrequency(200.0);
+    for (int i = 0 ; i < 3 ; ++i)
+    {
+      for (int j = 0 ; j < 5000 ; ++j)
+        acq->GetPoint(i)->GetValues().row(j) << 0.1 * j, 10.0 * i - 0.05 * j, (j % 7) - 3.0;
+      acq->GetPoint(i)->GetResiduals().segment(100 * (i + 1), 50).setConstant(-1.0);
+    }
+    for (int i = 0 ; i < 4 ; ++i)
+    {
+      for (int j = 0 ; j < 10000 ; ++j)
+        acq->GetAnalog(i)->GetValues().coeffRef(j) = 0.01 * ((j * (i + 3)) % 1000) - 5.0;
+    }
+    btk::AcquisitionFileIO::StorageFormat formats[2] = {btk::AcquisitionFileIO::Float, btk::AcquisitionFileIO::Integer};
+    btk::AcquisitionFileIO::ByteOrder orders[2] = {btk::AcquisitionFileIO::IEEE_LittleEndian, btk::AcquisitionFileIO::VAX_LittleEndian};
+    for (int f = 0 ; f < 2 ; ++f)
+    {
+      std::vector<char> buffer;
+      btk::C3DFileIO::Pointer writer = btk::C3DFileIO::New();
+      writer->SetStorageFormat(formats[f]);
+      writer->SetByteOrder(orders[f]);
+      writer->WriteBuffer(&buffer, acq);
+      // Complete and truncated data section
+      for (int t = 0 ; t < 2 ; ++t)
+      {
+        const size_t size = buffer.size() - t * 1000;
+        btk::Acquisition::Pointer ref = btk::Acquisition::New();
+        btk::C3DFileIO::New()->ReadBuffer(&buffer[0], size, ref);
+        btk::C3DFileIO::Pointer io = btk::C3DFileIO::New();
+        TS_ASSERT_EQUALS(io->GetThreadNumber(), 1);
+        io->SetThreadNumber(4);
+        btk::Acquisition::Pointer output = btk::Acquisition::New();
+        io->ReadBuffer(&buffer[0], size, output);
+        TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 5000);
+        TS_ASSERT_EQUALS(output->GetAnalogFrameNumber(), 10000);
+        for (int i = 0 ; i < 3 ; ++i)
+        {
+          TS_ASSERT(output->GetPoint(i)->GetValues() == ref->GetPoint(i)->GetValues());
+          TS_ASSERT(output->GetPoint(i)->GetResiduals() == ref->GetPoint(i)->GetResiduals());
+        }
+        for (int i = 0 ; i < 4 ; ++i)
+          TS_ASSERT(output->GetAnalog(i)->GetValues() == ref->GetAnalog(i)->GetValues());
+        if ((f == 0) && (t == 0))
+        {
+          TS_ASSERT_EIGEN_DELTA(output->GetPoint(2)->GetValues(), acq->GetPoint(2)->GetValues(), 1e-4);
+          TS_ASSERT_EIGEN_DELTA(output->GetAnalog(3)->GetValues(), acq->GetAnalog(3)->GetValues(), 1e-5);
+        }
+      }
+    }
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(C3DFileIOTest)
@@ -63,4 +126,5 @@ CXXTEST_TEST_REGISTRATION(C3DFileIOTest, CanReadFileOk)
 CXXTEST_TEST_REGISTRATION(C3DFileIOTest, CanWriteFileEmpty)
 CXXTEST_TEST_REGISTRATION(C3DFileIOTest, CanWriteFileFail)
 CXXTEST_TEST_REGISTRATION(C3DFileIOTest, CanWriteFileOk)
+CXXTEST_TEST_REGISTRATION(C3DFileIOTest, ParallelDecoding)
 #endif
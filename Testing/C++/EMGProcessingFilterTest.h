@@ -0,0 +1,168 @@
+#ifndef EMGProcessingFilterTest_h
+#define EMGProcessingFilterTest_h
+
+#include <btkEMGProcessingFilter.h>
+
+#include <cmath>
+
+// Sine bursts (100 Hz) with an offset on the first channel, constant on the second.
+static btk::Acquisition::Pointer EMGProcessingFilterTest_Acquisition(int numFrames, int first = 0)
+{
+  btk::Acquisition::Pointer acq = btk::Acquisition::New();
+  acq->Init(0, numFrames, 2, 10);
+  acq->SetPointFrequency(100.0);
+  acq->GetAnalog(0)->SetLabel("EMG1");
+  acq->GetAnalog(1)->SetLabel("EMG2");
+  for (int i = 0 ; i < acq->GetAnalogFrameNumber() ; ++i)
+  {
+    const double t = (first + i) / 1000.0;
+    acq->GetAnalog(0)->GetValues().coeffRef(i) = 0.5 + 2.0 * std::sin(2.0 * M_PI * 100.0 * t);
+    acq->GetAnalog(1)->GetValues().coeffRef(i) = 3.0;
+  }
+  return acq;
+};
+
+CXXTEST_SUITE(EMGProcessingFilterTest)
+{
+  CXXTEST_TEST(NoInput)
+  {
+    btk::EMGProcessingFilter::Pointer filter = btk::EMGProcessingFilter::New();
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetAnalogNumber(), 0);
+  };
+  
+  CXXTEST_TEST(RMSEnvelope)
+  {
+    btk::Acquisition::Pointer acq = EMGProcessingFilterTest_Acquisition(200);
+    btk::EMGProcessingFilter::Pointer filter = btk::EMGProcessingFilter::New();
+    filter->SetInput(acq);
+    filter->SetEnvelopeMethod(btk::EMGProcessingFilter::RMSEnvelope);
+    filter->Update();
+    btk::Acquisition::Pointer output = filter->GetOutput();
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), 2);
+    TS_ASSERT_EQUALS(output->GetAnalogFrameNumber(), 2000);
+    TS_ASSERT_DIFFERS(output->GetAnalog(0), acq->GetAnalog(0));
+    // RMS of a sine: amplitude / sqrt(2)
+    TS_ASSERT_DELTA(output->GetAnalog(0)->GetValues().segment(500, 1000).mean(), 2.0 / std::sqrt(2.0), 0.05);
+    TS_ASSERT_DELTA(output->GetAnalog(1)->GetValues().norm(), 0.0, 1e-10);
+    TS_ASSERT_EQUALS(acq->GetAnalog(1)->GetValues().coeff(0), 3.0); // Input not modified
+  };
+  
+  CXXTEST_TEST(LowPassEnvelopeAndNormalization)
+  {
+    btk::Acquisition::Pointer acq = EMGProcessingFilterTest_Acquisition(200);
+    std::list<std::string> labels(1, "EMG1");
+    btk::EMGProcessingFilter::Pointer filter = btk::EMGProcessingFilter::New();
+    filter->SetInput(acq);
+    filter->SetLabels(labels);
+    filter->Update();
+    btk::Acquisition::Pointer output = filter->GetOutput();
+    // Mean of a rectified sine: 2 * amplitude / pi
+    TS_ASSERT_DELTA(output->GetAnalog(0)->GetValues().segment(1000, 1000).mean(), 2.0 * 2.0 / M_PI, 0.05);
+    TS_ASSERT_EQUALS(output->GetAnalog(1), acq->GetAnalog(1));
+    
+    filter->SetNormalizationMethod(btk::EMGProcessingFilter::PeakNormalization);
+    filter->Update();
+    TS_ASSERT_DELTA(output->GetAnalog(0)->GetValues().maxCoeff(), 1.0, 1e-15);
+    
+    const btk::Analog::Values ref = filter->GetOutput()->GetAnalog(0)->GetValues();
+    filter->SetNormalizationMethod(btk::EMGProcessingFilter::ReferenceNormalization);
+    filter->SetNormalizationReference("EMG1", 4.0);
+    TS_ASSERT_EQUALS(filter->GetNormalizationReference("EMG1"), 4.0);
+    TS_ASSERT_EQUALS(filter->GetNormalizationReference("EMG2"), 0.0);
+    filter->Update();
+    filter->SetNormalizationMethod(btk::EMGProcessingFilter::NoNormalization);
+    filter->Update();
+    const btk::Analog::Values raw = filter->GetOutput()->GetAnalog(0)->GetValues();
+    filter->SetNormalizationMethod(btk::EMGProcessingFilter::ReferenceNormalization);
+    filter->Update();
+    TS_ASSERT_EIGEN_DELTA(filter->GetOutput()->GetAnalog(0)->GetValues(), raw / 4.0, 1e-15);
+    TS_ASSERT_EIGEN_DELTA(ref, raw / raw.maxCoeff(), 1e-15);
+  };
+  
+  CXXTEST_TEST(Streaming)
+  {
+    const int numFrames[3] = {50, 7, 143};
+    btk::EMGProcessingFilter::EnvelopeMethod methods[2] = {btk::EMGProcessingFilter::LowPassEnvelope, btk::EMGProcessingFilter::RMSEnvelope};
+    for (int m = 0 ; m < 2 ; ++m)
+    {
+      btk::EMGProcessingFilter::Pointer batch = btk::EMGProcessingFilter::New();
+      batch->SetInput(EMGProcessingFilterTest_Acquisition(200));
+      batch->SetOffsetRemoval(false);
+      batch->SetEnvelopeMethod(methods[m]);
+      batch->SetBandPassOrder(3);
+      batch->Update();
+      const btk::Analog::Values& ref = batch->GetOutput()->GetAnalog(0)->GetValues();
+      btk::EMGProcessingFilter::Pointer stream = btk::EMGProcessingFilter::New();
+      stream->SetOffsetRemoval(false);
+      stream->SetEnvelopeMethod(methods[m]);
+      stream->SetBandPassOrder(3);
+      stream->SetStreaming(true);
+      stream->SetInPlace(true);
+      int first = 0;
+      for (int b = 0 ; b < 3 ; ++b)
+      {
+        btk::Acquisition::Pointer block = EMGProcessingFilterTest_Acquisition(numFrames[b], first);
+        stream->SetInput(block);
+        stream->Update();
+        TS_ASSERT_EQUALS(stream->GetOutput()->GetAnalog(0), block->GetAnalog(0));
+        TS_ASSERT_EIGEN_DELTA(block->GetAnalog(0)->GetValues(), ref.segment(first, numFrames[b] * 10), 1e-10);
+        first += numFrames[b] * 10;
+      }
+      // New stream
+      stream->ResetStreaming();
+      btk::Acquisition::Pointer block = EMGProcessingFilterTest_Acquisition(numFrames[0]);
+      stream->SetInput(block);
+      stream->Update();
+      TS_ASSERT_EIGEN_DELTA(block->GetAnalog(0)->GetValues(), ref.segment(0, numFrames[0] * 10), 1e-10);
+    }
+  };
+  
+  CXXTEST_TEST(StreamingSameLabels)
+  {
+    const int numFrames[3] = {50, 7, 143};
+    btk::EMGProcessingFilter::Pointer batch = btk::EMGProcessingFilter::New();
+    batch->SetInput(EMGProcessingFilterTest_Acquisition(200));
+    batch->SetOffsetRemoval(false);
+    batch->Update();
+    const btk::Analog::Values& ref0 = batch->GetOutput()->GetAnalog(0)->GetValues();
+    const btk::Analog::Values& ref1 = batch->GetOutput()->GetAnalog(1)->GetValues();
+    btk::EMGProcessingFilter::Pointer stream = btk::EMGProcessingFilter::New();
+    stream->SetOffsetRemoval(false);
+    stream->SetStreaming(true);
+    stream->SetInPlace(true);
+    int first = 0;
+    for (int b = 0 ; b < 3 ; ++b)
+    {
+      btk::Acquisition::Pointer block = EMGProcessingFilterTest_Acquisition(numFrames[b], first);
+      block->GetAnalog(1)->SetLabel("EMG1"); // Each channel keeps its own state
+      stream->SetInput(block);
+      stream->Update();
+      TS_ASSERT_EIGEN_DELTA(block->GetAnalog(0)->GetValues(), ref0.segment(first, numFrames[b] * 10), 1e-10);
+      TS_ASSERT_EIGEN_DELTA(block->GetAnalog(1)->GetValues(), ref1.segment(first, numFrames[b] * 10), 1e-10);
+      first += numFrames[b] * 10;
+    }
+  };
+  
+  CXXTEST_TEST(InvalidFrequencies)
+  {
+    btk::Acquisition::Pointer acq = EMGProcessingFilterTest_Acquisition(20);
+    acq->SetPointFrequency(50.0); // Analog frequency: 500 Hz
+    btk::EMGProcessingFilter::Pointer filter = btk::EMGProcessingFilter::New();
+    filter->SetInput(acq);
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetAnalogNumber(), 0);
+    filter->SetBandPassFrequencies(20.0, 0.0); // High-pass only
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetAnalogNumber(), 2);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(EMGProcessingFilterTest)
+CXXTEST_TEST_REGISTRATION(EMGProcessingFilterTest, NoInput)
+CXXTEST_TEST_REGISTRATION(EMGProcessingFilterTest, RMSEnvelope)
+CXXTEST_TEST_REGISTRATION(EMGProcessingFilterTest, LowPassEnvelopeAndNormalization)
+CXXTEST_TEST_REGISTRATION(EMGProcessingFilterTest, Streaming)
+CXXTEST_TEST_REGISTRATION(EMGProcessingFilterTest, StreamingSameLabels)
+CXXTEST_TEST_REGISTRATION(EMGProcessingFilterTest, InvalidFrequencies)
+#endif
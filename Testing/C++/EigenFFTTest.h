@@ -0,0 +1,117 @@
+#ifndef EigenFFTTest_h
+#define EigenFFTTest_h
+
+#include <btkEigen/SignalProcessing/FFT.h>
+
+#ifndef M_PI
+  #define M_PI 3.14159265358979323846
+#endif
+
+static Eigen::Matrix<std::complex<double>,Eigen::Dynamic,1> EigenFFTTest_dft(const Eigen::Matrix<double,Eigen::Dynamic,1>& x)
+{
+  const int n = static_cast<int>(x.rows());
+  Eigen::Matrix<std::complex<double>,Eigen::Dynamic,1> X(n);
+  for (int k = 0 ; k < n ; ++k)
+  {
+    std::complex<double> s(0.0, 0.0);
+    for (int i = 0 ; i < n ; ++i)
+    {
+      const double theta = -2.0 * M_PI * static_cast<double>((static_cast<long long>(k) * i) % n) / static_cast<double>(n);
+      s += x.coeff(i) * std::complex<double>(std::cos(theta), std::sin(theta));
+    }
+    X.coeffRef(k) = s;
+  }
+  return X;
+};
+
+static Eigen::Matrix<double,Eigen::Dynamic,1> EigenFFTTest_signal(int n)
+{
+  Eigen::Matrix<double,Eigen::Dynamic,1> x(n);
+  for (int i = 0 ; i < n ; ++i)
+    x.coeffRef(i) = std::sin(0.3 * i) + 0.5 * std::cos(1.7 * i + 0.2) + 0.01 * static_cast<double>((i * 37) % 11);
+  return x;
+};
+
+CXXTEST_SUITE(EigenFFTTest)
+{
+  CXXTEST_TEST(PowerOfTwo)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> x = EigenFFTTest_signal(64);
+    Eigen::Matrix<std::complex<double>,Eigen::Dynamic,1> X = btkEigen::fft(x);
+    Eigen::Matrix<std::complex<double>,Eigen::Dynamic,1> R = EigenFFTTest_dft(x);
+    TS_ASSERT_EQUALS(X.rows(), 64);
+    TS_ASSERT_DELTA((X - R).cwiseAbs().maxCoeff(), 0.0, 1e-11);
+  };
+  
+  CXXTEST_TEST(AnyLength)
+  {
+    const int lengths[5] = {1, 3, 7, 100, 127};
+    for (int l = 0 ; l < 5 ; ++l)
+    {
+      Eigen::Matrix<double,Eigen::Dynamic,1> x = EigenFFTTest_signal(lengths[l]);
+      Eigen::Matrix<std::complex<double>,Eigen::Dynamic,1> X = btkEigen::fft(x);
+      Eigen::Matrix<std::complex<double>,Eigen::Dynamic,1> R = EigenFFTTest_dft(x);
+      TS_ASSERT_EQUALS(X.rows(), lengths[l]);
+      TS_ASSERT_DELTA((X - R).cwiseAbs().maxCoeff(), 0.0, 1e-10);
+    }
+  };
+  
+  CXXTEST_TEST(Inverse)
+  {
+    const int lengths[3] = {16, 30, 61};
+    for (int l = 0 ; l < 3 ; ++l)
+    {
+      Eigen::Matrix<double,Eigen::Dynamic,1> x = EigenFFTTest_signal(lengths[l]);
+      Eigen::Matrix<std::complex<double>,Eigen::Dynamic,1> y = btkEigen::ifft(btkEigen::fft(x));
+      TS_ASSERT_DELTA((y.real() - x).cwiseAbs().maxCoeff(), 0.0, 1e-12);
+      TS_ASSERT_DELTA(y.imag().cwiseAbs().maxCoeff(), 0.0, 1e-12);
+    }
+  };
+  
+  CXXTEST_TEST(Parseval)
+  {
+    Eigen::Matrix<double,Eigen::Dynamic,1> x = EigenFFTTest_signal(1000);
+    Eigen::Matrix<std::complex<double>,Eigen::Dynamic,1> X = btkEigen::fft(x);
+    TS_ASSERT_DELTA(X.squaredNorm() / 1000.0, x.squaredNorm(), 1e-9);
+  };
+  
+  CXXTEST_TEST(Real)
+  {
+    const int lengths[5] = {2, 9, 64, 100, 255};
+    for (int l = 0 ; l < 5 ; ++l)
+    {
+      const int n = lengths[l];
+      Eigen::Matrix<double,Eigen::Dynamic,1> x = EigenFFTTest_signal(n);
+      Eigen::Matrix<std::complex<double>,Eigen::Dynamic,1> X = btkEigen::rfft(x);
+      Eigen::Matrix<std::complex<double>,Eigen::Dynamic,1> R = btkEigen::fft(x);
+      TS_ASSERT_EQUALS(X.rows(), n / 2 + 1);
+      TS_ASSERT_DELTA((X - R.head(n / 2 + 1)).cwiseAbs().maxCoeff(), 0.0, 1e-10);
+    }
+  };
+  
+  CXXTEST_TEST(CachedTwiddles)
+  {
+    // The same object is used for several signals and lengths: the kept factors must not mix the lengths.
+    btkEigen::FFT<double> fft;
+    const int lengths[6] = {100, 64, 100, 50, 127, 64};
+    for (int l = 0 ; l < 6 ; ++l)
+    {
+      const int n = lengths[l];
+      Eigen::Matrix<double,Eigen::Dynamic,1> x = EigenFFTTest_signal(n) * static_cast<double>(l + 1);
+      Eigen::Matrix<std::complex<double>,Eigen::Dynamic,1> R = EigenFFTTest_dft(x);
+      TS_ASSERT_DELTA((fft.fwd(x) - R).cwiseAbs().maxCoeff(), 0.0, 1e-9);
+      TS_ASSERT_DELTA((fft.rfwd(x) - R.head(n / 2 + 1)).cwiseAbs().maxCoeff(), 0.0, 1e-9);
+      TS_ASSERT_DELTA((fft.inv(R).real() - x).cwiseAbs().maxCoeff(), 0.0, 1e-11);
+    }
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(EigenFFTTest)
+CXXTEST_TEST_REGISTRATION(EigenFFTTest, PowerOfTwo)
+CXXTEST_TEST_REGISTRATION(EigenFFTTest, AnyLength)
+CXXTEST_TEST_REGISTRATION(EigenFFTTest, Inverse)
+CXXTEST_TEST_REGISTRATION(EigenFFTTest, Parseval)
+CXXTEST_TEST_REGISTRATION(EigenFFTTest, Real)
+CXXTEST_TEST_REGISTRATION(EigenFFTTest, CachedTwiddles)
+
+#endif // EigenFFTTest_h
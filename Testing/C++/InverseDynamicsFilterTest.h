@@ -0,0 +1,121 @@
+#ifndef InverseDynamicsFilterTest_h
+#define InverseDynamicsFilterTest_h
+
+#include "_TDDBasicFilters_Segment_Utils.h"
+
+#include <btkInverseDynamicsFilter.h>
+
+CXXTEST_SUITE(InverseDynamicsFilterTest)
+{
+  CXXTEST_TEST(NoInput)
+  {
+    btk::InverseDynamicsFilter::Pointer filter = btk::InverseDynamicsFilter::New();
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItemNumber(), 0);
+  };
+  
+  CXXTEST_TEST(StaticChain)
+  {
+    const int numFrames = 10;
+    std::vector<Eigen::Matrix<double, 3, 3> > R(numFrames, Eigen::Matrix<double, 3, 3>::Identity());
+    std::vector<Eigen::Matrix<double, 3, 1> > tShank(numFrames, Eigen::Matrix<double, 3, 1>(0.0, 0.0, 500.0));
+    std::vector<Eigen::Matrix<double, 3, 1> > tFoot(numFrames, Eigen::Matrix<double, 3, 1>(0.0, 0.0, 100.0));
+    btk::PointCollection::Pointer points = btk::PointCollection::New();
+    btk_segment_frame(points, "RTI", R, tShank);
+    btk_segment_frame(points, "RFO", R, tFoot);
+    // Ground reaction supporting both segments below the center of mass of the foot
+    btk::WrenchCollection::Pointer wrenches = btk::WrenchCollection::New();
+    btk::Wrench::Pointer grw = btk::Wrench::New("GRW", 2 * numFrames);
+    grw->GetPosition()->GetValues().setZero();
+    grw->GetPosition()->GetValues().col(0).setConstant(50.0);
+    grw->GetForce()->GetValues().setZero();
+    grw->GetForce()->GetValues().col(2).setConstant((3.0 + 1.0) * 9.81);
+    grw->GetMoment()->GetValues().setZero();
+    wrenches->InsertItem(grw);
+    
+    btk::InverseDynamicsFilter::Pointer filter = btk::InverseDynamicsFilter::New();
+    filter->SetInput(points);
+    filter->SetWrenchInput(wrenches);
+    filter->SetPointFrequency(100.0);
+    btk::InverseDynamicsFilter::Segment shank("RTI", "", "RKnee", 3.0, Eigen::Matrix<double, 3, 1>(0.0, 0.0, -200.0), Eigen::Matrix<double, 3, 3>::Identity() * 0.04);
+    btk::InverseDynamicsFilter::Segment foot("RFO", "RTI", "RAnkle", 1.0, Eigen::Matrix<double, 3, 1>(50.0, 0.0, -50.0), Eigen::Matrix<double, 3, 3>::Identity() * 0.01);
+    foot.Wrenches.push_back(0);
+    filter->AppendSegment(shank);
+    filter->AppendSegment(foot);
+    filter->Update();
+    btk::PointCollection::Pointer output = filter->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 6);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetLabel(), "RKneeForce");
+    TS_ASSERT_EQUALS(output->GetItem(1)->GetType(), btk::Point::Moment);
+    TS_ASSERT_EQUALS(output->GetItem(5)->GetLabel(), "RAnklePower");
+    TS_ASSERT_EQUALS(output->GetItem(5)->GetType(), btk::Point::Power);
+    // Ankle: supports only the shank (reaction of the ground minus the weight of the foot)
+    // Ground reaction and weight of the foot aligned (50 mm in front of the ankle): M = -50 * 3g around Y
+    TS_ASSERT_EIGEN_DELTA(output->GetItem(3)->GetValues().row(0), Eigen::RowVector3d(0.0, 0.0, -3.0 * 9.81), 1e-8);
+    TS_ASSERT_EIGEN_DELTA(output->GetItem(4)->GetValues().row(0), Eigen::RowVector3d(0.0, 50.0 * 3.0 * 9.81, 0.0), 1e-8);
+    // Knee: nothing to support
+    TS_ASSERT_DELTA(output->GetItem(0)->GetValues().norm(), 0.0, 1e-8);
+    TS_ASSERT_DELTA(output->GetItem(5)->GetValues().norm(), 0.0, 1e-8);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetResiduals().maxCoeff(), 0.0);
+    
+    // Without the ground: weight of the leg
+    filter->SetWrenchInput(btk::WrenchCollection::New());
+    filter->Update();
+    TS_ASSERT_EIGEN_DELTA(output->GetItem(0)->GetValues().row(5), Eigen::RowVector3d(0.0, 0.0, 4.0 * 9.81), 1e-8);
+    // Moment of the weight of the foot around the knee (50 mm in front)
+    TS_ASSERT_EIGEN_DELTA(output->GetItem(1)->GetValues().row(5), Eigen::RowVector3d(0.0, -50.0 * 9.81, 0.0), 1e-8);
+    
+    // Occlusion of the foot: propagated to the knee
+    points->GetItem(4)->GetResiduals().coeffRef(5) = -1.0;
+    points->Modified();
+    filter->Update();
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetResiduals().coeff(2), 0.0);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetResiduals().coeff(3), -1.0);
+    TS_ASSERT_EQUALS(output->GetItem(1)->GetResiduals().coeff(7), -1.0);
+    TS_ASSERT_EQUALS(output->GetItem(3)->GetResiduals().coeff(5), -1.0);
+    TS_ASSERT_EQUALS(output->GetItem(3)->GetValues().row(5).norm(), 0.0);
+    TS_ASSERT_EQUALS(output->GetItem(3)->GetResiduals().coeff(8), 0.0);
+  };
+  
+  CXXTEST_TEST(AngularAcceleration)
+  {
+    // Rotation around the vertical axis with a constant angular acceleration (center of mass on the axis)
+    const int numFrames = 50;
+    const double freq = 200.0, alpha = 3.0, Izz = 0.2, mass = 2.0;
+    std::vector<Eigen::Matrix<double, 3, 3> > R(numFrames);
+    std::vector<Eigen::Matrix<double, 3, 1> > t(numFrames, Eigen::Matrix<double, 3, 1>(10.0, 20.0, 900.0));
+    for (int f = 0 ; f < numFrames ; ++f)
+    {
+      const double time = f / freq;
+      R[f] = Eigen::AngleAxis<double>(0.5 * alpha * time * time, Eigen::Matrix<double, 3, 1>::UnitZ()).toRotationMatrix();
+    }
+    btk::PointCollection::Pointer points = btk::PointCollection::New();
+    btk_segment_frame(points, "SEG", R, t);
+    btk::InverseDynamicsFilter::Pointer filter = btk::InverseDynamicsFilter::New();
+    filter->SetInput(points);
+    filter->SetPointFrequency(freq);
+    filter->SetGravity(Eigen::Matrix<double, 3, 1>::Zero());
+    Eigen::Matrix<double, 3, 3> I = Eigen::Matrix<double, 3, 3>::Identity() * 0.1;
+    I(2,2) = Izz;
+    filter->AppendSegment(btk::InverseDynamicsFilter::Segment("SEG", "", "Joint", mass, Eigen::Matrix<double, 3, 1>::Zero(), I));
+    filter->SetExpressionFrame(btk::InverseDynamicsFilter::Distal);
+    filter->Update();
+    btk::PointCollection::Pointer output = filter->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 3);
+    for (int f = 2 ; f < numFrames - 2 ; ++f)
+    {
+      const double omega = alpha * f / freq;
+      TS_ASSERT_DELTA(output->GetItem(0)->GetValues().row(f).norm(), 0.0, 1e-8);
+      // Izz * alpha in N.m, converted in N.mm
+      TS_ASSERT_DELTA(output->GetItem(1)->GetValues().coeff(f,2), Izz * alpha * 1000.0, 1e-2);
+      TS_ASSERT_DELTA(output->GetItem(1)->GetValues().coeff(f,0), 0.0, 1e-6);
+      TS_ASSERT_DELTA(output->GetItem(2)->GetValues().coeff(f,2), Izz * alpha * omega, 1e-4);
+    }
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(InverseDynamicsFilterTest)
+CXXTEST_TEST_REGISTRATION(InverseDynamicsFilterTest, NoInput)
+CXXTEST_TEST_REGISTRATION(InverseDynamicsFilterTest, StaticChain)
+CXXTEST_TEST_REGISTRATION(InverseDynamicsFilterTest, AngularAcceleration)
+#endif
@@ -0,0 +1,117 @@
+#ifndef JointAngleFilterTest_h
+#define JointAngleFilterTest_h
+
+#include "_TDDBasicFilters_Segment_Utils.h"
+
+#include <btkJointAngleFilter.h>
+
+static Eigen::Matrix<double, 3, 3> JointAngleFilterTest_Rotation(int axis, double angle)
+{
+  return Eigen::AngleAxis<double>(angle, Eigen::Matrix<double, 3, 1>::Unit(axis)).toRotationMatrix();
+};
+
+CXXTEST_SUITE(JointAngleFilterTest)
+{
+  CXXTEST_TEST(NoInput)
+  {
+    btk::JointAngleFilter::Pointer filter = btk::JointAngleFilter::New();
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItemNumber(), 0);
+  };
+  
+  CXXTEST_TEST(Joints)
+  {
+    btk::JointAngleFilter::Pointer filter = btk::JointAngleFilter::New();
+    filter->AppendJoint("RKneeAngles", "RFE", "RTI");
+    filter->AppendJoint("RKneeAngles", "RFE", "RTI");
+    filter->AppendJoint("Invalid", "RFE", "");
+    TS_ASSERT_EQUALS(filter->GetJoints().size(), 1u);
+    filter->AppendJoint("RKneeAngles", "RFE", "RTI", btk::JointAngleFilter::ZXY);
+    TS_ASSERT_EQUALS(filter->GetJoints().size(), 2u);
+    filter->ClearJoints();
+    TS_ASSERT_EQUALS(filter->GetJoints().size(), 0u);
+  };
+  
+  CXXTEST_TEST(Sequences)
+  {
+    const char* labels[12] = {"XYZ", "XZY", "YXZ", "YZX", "ZXY", "ZYX", "XYX", "XZX", "YXY", "YZY", "ZXZ", "ZYZ"};
+    const int axes[12][3] = {{0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0},
+                             {0,1,0}, {0,2,0}, {1,0,1}, {1,2,1}, {2,0,2}, {2,1,2}};
+    const int numFrames = 40;
+    std::vector<Eigen::Matrix<double, 3, 3> > Rp(numFrames);
+    for (int f = 0 ; f < numFrames ; ++f)
+      Rp[f] = Eigen::AngleAxis<double>(0.03 * f, Eigen::Matrix<double, 3, 1>(0.2, -1.0, 0.4).normalized()).toRotationMatrix();
+    for (int s = 0 ; s < 12 ; ++s)
+    {
+      const bool cardan = (s < 6);
+      btk::PointCollection::Pointer points = btk::PointCollection::New();
+      Eigen::Matrix<double, Eigen::Dynamic, 3> ref(numFrames, 3);
+      std::vector<Eigen::Matrix<double, 3, 3> > Rd(numFrames);
+      for (int f = 0 ; f < numFrames ; ++f)
+      {
+        ref.row(f) << -120.0 + 6.0 * f, (cardan ? -80.0 + 4.0 * f : 5.0 + 4.0 * f), 170.0 - 8.0 * f;
+        const Eigen::Matrix<double, 1, 3> rad = ref.row(f) * M_PI / 180.0;
+        Rd[f] = Rp[f] * JointAngleFilterTest_Rotation(axes[s][0], rad(0)) * JointAngleFilterTest_Rotation(axes[s][1], rad(1)) * JointAngleFilterTest_Rotation(axes[s][2], rad(2));
+      }
+      std::vector<Eigen::Matrix<double, 3, 1> > tp(numFrames, Eigen::Matrix<double, 3, 1>(100.0, 200.0, 300.0));
+      std::vector<Eigen::Matrix<double, 3, 1> > td(numFrames, Eigen::Matrix<double, 3, 1>(-10.0, 20.0, 500.0));
+      btk_segment_frame(points, "PRO", Rp, tp, 0.5);
+      btk_segment_frame(points, "DIS", Rd, td, 0.5);
+      btk::JointAngleFilter::Pointer filter = btk::JointAngleFilter::New();
+      filter->SetInput(points);
+      filter->AppendJoint(labels[s], "PRO", "DIS", static_cast<btk::JointAngleFilter::Sequence>(s));
+      filter->Update();
+      btk::PointCollection::Pointer output = filter->GetOutput();
+      TS_ASSERT_EQUALS(output->GetItemNumber(), 1);
+      TS_ASSERT_EQUALS(output->GetItem(0)->GetLabel(), labels[s]);
+      TS_ASSERT_EQUALS(output->GetItem(0)->GetType(), btk::Point::Angle);
+      TS_ASSERT_EIGEN_DELTA(output->GetItem(0)->GetValues(), ref, 1e-8);
+      TS_ASSERT_EQUALS(output->GetItem(0)->GetResiduals().minCoeff(), 0.5);
+    }
+  };
+  
+  CXXTEST_TEST(GlobalFrameAndOcclusion)
+  {
+    const int numFrames = 20;
+    std::vector<Eigen::Matrix<double, 3, 3> > R(numFrames);
+    Eigen::Matrix<double, Eigen::Dynamic, 3> ref(numFrames, 3);
+    for (int f = 0 ; f < numFrames ; ++f)
+    {
+      ref.row(f) << 10.0 + f, -20.0 + 2.0 * f, 30.0 - 3.0 * f;
+      R[f] = JointAngleFilterTest_Rotation(2, ref(f,0) * M_PI / 180.0) * JointAngleFilterTest_Rotation(1, ref(f,1) * M_PI / 180.0) * JointAngleFilterTest_Rotation(0, ref(f,2) * M_PI / 180.0);
+    }
+    btk::PointCollection::Pointer points = btk::PointCollection::New();
+    std::vector<Eigen::Matrix<double, 3, 1> > t(numFrames, Eigen::Matrix<double, 3, 1>(0.0, 0.0, 1000.0));
+    btk_segment_frame(points, "PEL", R, t, 0.5);
+    points->GetItem(2)->GetResiduals().segment(5,3).setConstant(-1.0);
+    points->GetItem(3)->GetResiduals().coeffRef(10) = 2.0;
+    btk::JointAngleFilter::Pointer filter = btk::JointAngleFilter::New();
+    filter->SetInput(points);
+    filter->AppendJoint("PelvisAngles", "", "PEL", btk::JointAngleFilter::ZYX);
+    filter->AppendJoint("Missing", "PEL", "RFE");
+    filter->Update();
+    btk::PointCollection::Pointer output = filter->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 1);
+    btk::Point::Pointer angle = output->GetItem(0);
+    for (int f = 0 ; f < numFrames ; ++f)
+    {
+      if ((f >= 5) && (f < 8))
+      {
+        TS_ASSERT_EQUALS(angle->GetResiduals().coeff(f), -1.0);
+        TS_ASSERT_EQUALS(angle->GetValues().row(f).norm(), 0.0);
+      }
+      else
+      {
+        TS_ASSERT_EQUALS(angle->GetResiduals().coeff(f), (f == 10) ? 2.0 : 0.5);
+        TS_ASSERT_EIGEN_DELTA(angle->GetValues().row(f), ref.row(f), 1e-8);
+      }
+    }
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(JointAngleFilterTest)
+CXXTEST_TEST_REGISTRATION(JointAngleFilterTest, NoInput)
+CXXTEST_TEST_REGISTRATION(JointAngleFilterTest, Joints)
+CXXTEST_TEST_REGISTRATION(JointAngleFilterTest, Sequences)
+CXXTEST_TEST_REGISTRATION(JointAngleFilterTest, GlobalFrameAndOcclusion)
+#endif
@@ -4,6 +4,7 @@
 #include "_TDDIO_Open3DMotion_Utils.h"
 
 #include <btkAcquisitionFileReader.h>
+#include <btkMDFFileIO.h>
 #include <btkConvert.h>
 
 CXXTEST_SUITE(MDFFileReaderTest)
@@ -26,6 +27,11 @@ CXXTEST_SUITE(MDFFileReaderTest)
     btk_o3dm_ADemo1_test(MDFFilePathIN + "gait-bilateral-1997-Kistlerx1.mdf");
   };
   
+  CXXTEST_TEST(Gait_bilateral_1997_Kistlerx1_DirectDecoding)
+  {
+    btk_o3dm_decoding_test<btk::MDFFileIO>(MDFFilePathIN + "gait-bilateral-1997-Kistlerx1.mdf");
+  };
+  
   CXXTEST_TEST(Gait_bilateral_1997_Kistlerx1_MDF_vs_C3D_float)
   {
     Gait_bilateral_1997_Kistlerx1_MDF_vs_C3D(C3DFilePathIN + "others/ADemo1_rewrite_c3d_pc_float.c3d");
@@ -65,6 +71,11 @@ CXXTEST_SUITE(MDFFileReaderTest)
         TS_ASSERT_DELTA(acqMDF->GetAnalog(i)->GetValues()(j), acqC3D->GetAnalog(i)->GetValues()(j), 1e-5);
   };
   
+  CXXTEST_TEST(ADBHL_DirectDecoding)
+  {
+    btk_o3dm_decoding_test<btk::MDFFileIO>(MDFFilePathIN + "ADBHL.mdf");
+  };
+  
   CXXTEST_TEST(ADBHL)
   {
     btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
@@ -86,7 +97,9 @@ CXXTEST_SUITE_REGISTRATION(MDFFileReaderTest)
 CXXTEST_TEST_REGISTRATION(MDFFileReaderTest, NoFile)
 CXXTEST_TEST_REGISTRATION(MDFFileReaderTest, MisspelledFile)
 CXXTEST_TEST_REGISTRATION(MDFFileReaderTest, Gait_bilateral_1997_Kistlerx1)
+CXXTEST_TEST_REGISTRATION(MDFFileReaderTest, Gait_bilateral_1997_Kistlerx1_DirectDecoding)
 CXXTEST_TEST_REGISTRATION(MDFFileReaderTest, Gait_bilateral_1997_Kistlerx1_MDF_vs_C3D_float)
 CXXTEST_TEST_REGISTRATION(MDFFileReaderTest, Gait_bilateral_1997_Kistlerx1_MDF_vs_C3D_integer)
 CXXTEST_TEST_REGISTRATION(MDFFileReaderTest, ADBHL)
+CXXTEST_TEST_REGISTRATION(MDFFileReaderTest, ADBHL_DirectDecoding)
 #endif
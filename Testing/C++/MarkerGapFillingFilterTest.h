@@ -0,0 +1,98 @@
+#ifndef MarkerGapFillingFilterTest_h
+#define MarkerGapFillingFilterTest_h
+
+#include <btkMarkerGapFillingFilter.h>
+
+CXXTEST_SUITE(MarkerGapFillingFilterTest)
+{
+  CXXTEST_TEST(NoInput)
+  {
+    btk::MarkerGapFillingFilter::Pointer filter = btk::MarkerGapFillingFilter::New();
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetPointNumber(), 0);
+    TS_ASSERT_EQUALS(filter->GetFilledFrameNumber(), 0);
+  };
+  
+  CXXTEST_TEST(Interpolation)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(2,100);
+    acq->SetMaxInterpolationGap(10);
+    acq->GetPoint(1)->SetType(btk::Point::Angle);
+    for (int i = 0 ; i < 100 ; ++i)
+    {
+      acq->GetPoint(0)->GetValues().row(i) << 2.0 * i, 3.0 * i + 1.0, -1.0 * i;
+      acq->GetPoint(1)->GetValues().row(i) << 2.0 * i, 3.0 * i + 1.0, -1.0 * i;
+    }
+    btk::Point::Values ref = acq->GetPoint(0)->GetValues();
+    acq->GetPoint(0)->GetValues().block(20,0,5,3).setZero();
+    acq->GetPoint(0)->GetResiduals().segment(20,5).setConstant(-1.0);
+    acq->GetPoint(0)->GetValues().block(40,0,15,3).setZero(); // Too long
+    acq->GetPoint(0)->GetResiduals().segment(40,15).setConstant(-1.0);
+    acq->GetPoint(0)->GetResiduals().segment(0,2).setConstant(-1.0); // At the beginning
+    acq->GetPoint(1)->GetResiduals().segment(20,5).setConstant(-1.0); // Not a marker
+    
+    btk::MarkerGapFillingFilter::InterpolationMethod methods[3] = {btk::MarkerGapFillingFilter::Linear, btk::MarkerGapFillingFilter::Cubic, btk::MarkerGapFillingFilter::PCHIP};
+    for (int m = 0 ; m < 3 ; ++m)
+    {
+      btk::MarkerGapFillingFilter::Pointer filter = btk::MarkerGapFillingFilter::New();
+      filter->SetInput(acq);
+      filter->SetInterpolationMethod(methods[m]);
+      filter->Update();
+      btk::Acquisition::Pointer output = filter->GetOutput();
+      TS_ASSERT_EQUALS(filter->GetFilledFrameNumber(), 5);
+      TS_ASSERT_EQUALS(filter->GetInterpolatedFrameNumber(), 5);
+      TS_ASSERT_EQUALS(filter->GetFilledFrameNumber(acq->GetPoint(0)->GetLabel()), 5);
+      TS_ASSERT_EIGEN_DELTA(output->GetPoint(0)->GetValues().block(20,0,5,3), ref.block(20,0,5,3), 1e-10);
+      TS_ASSERT_EQUALS(output->GetPoint(0)->GetResiduals().segment(20,5).minCoeff(), 0.0);
+      TS_ASSERT_EQUALS(output->GetPoint(0)->GetResiduals().segment(40,15).maxCoeff(), -1.0);
+      TS_ASSERT_EQUALS(output->GetPoint(0)->GetResiduals().coeff(0), -1.0);
+      TS_ASSERT_EQUALS(output->GetPoint(1), acq->GetPoint(1));
+      TS_ASSERT_EQUALS(acq->GetPoint(0)->GetResiduals().coeff(20), -1.0); // Input not modified
+    }
+    
+    btk::MarkerGapFillingFilter::Pointer filter = btk::MarkerGapFillingFilter::New();
+    filter->SetInput(acq);
+    filter->SetMaxGap(15);
+    filter->SetInPlace(true);
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetFilledFrameNumber(), 20);
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetPoint(0), acq->GetPoint(0));
+    TS_ASSERT_EIGEN_DELTA(acq->GetPoint(0)->GetValues().block(40,0,15,3), ref.block(40,0,15,3), 1e-10);
+  };
+  
+  CXXTEST_TEST(ClusterReconstruction)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(4,200);
+    acq->SetMaxInterpolationGap(10);
+    const double local[4][3] = {{0.0, 0.0, 0.0}, {100.0, 0.0, 0.0}, {0.0, 80.0, 0.0}, {10.0, 20.0, 60.0}};
+    for (int i = 0 ; i < 200 ; ++i)
+    {
+      const double a = 0.01 * i;
+      for (int m = 0 ; m < 4 ; ++m)
+        acq->GetPoint(m)->GetValues().row(i) << std::cos(a) * local[m][0] - std::sin(a) * local[m][1] + i, std::sin(a) * local[m][0] + std::cos(a) * local[m][1], local[m][2] + 0.5 * i;
+    }
+    btk::Point::Values ref = acq->GetPoint(1)->GetValues();
+    acq->GetPoint(1)->GetValues().block(100,0,50,3).setZero();
+    acq->GetPoint(1)->GetResiduals().segment(100,50).setConstant(-1.0);
+    
+    btk::MarkerGapFillingFilter::Pointer filter = btk::MarkerGapFillingFilter::New();
+    filter->SetInput(acq);
+    std::vector<std::string> cluster(4);
+    for (int m = 0 ; m < 4 ; ++m)
+      cluster[m] = acq->GetPoint(m)->GetLabel();
+    filter->AddCluster(cluster);
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetInterpolatedFrameNumber(), 0);
+    TS_ASSERT_EQUALS(filter->GetReconstructedFrameNumber(), 50);
+    TS_ASSERT_EIGEN_DELTA(filter->GetOutput()->GetPoint(1)->GetValues(), ref, 1e-8);
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetPoint(1)->GetResiduals().minCoeff(), 0.0);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(MarkerGapFillingFilterTest)
+CXXTEST_TEST_REGISTRATION(MarkerGapFillingFilterTest, NoInput)
+CXXTEST_TEST_REGISTRATION(MarkerGapFillingFilterTest, Interpolation)
+CXXTEST_TEST_REGISTRATION(MarkerGapFillingFilterTest, ClusterReconstruction)
+#endif
@@ -0,0 +1,121 @@
+#ifndef MemoryArenaTest_h
+#define MemoryArenaTest_h
+
+#include <btkMemoryArena.h>
+#include <btkAcquisition.h>
+#include <btkPoint.h>
+
+#include <vector>
+
+CXXTEST_SUITE(MemoryArenaTest)
+{
+  CXXTEST_TEST(Constructor)
+  {
+    btk::MemoryArena::Pointer arena = btk::MemoryArena::New(1024);
+    TS_ASSERT_EQUALS(arena->GetBlockSize(), 1024u);
+    TS_ASSERT_EQUALS(arena->GetBlockNumber(), 0);
+    TS_ASSERT_EQUALS(arena->GetUsedSize(), 0u);
+    TS_ASSERT_EQUALS(arena->GetAllocationNumber(), 0);
+  };
+  
+  CXXTEST_TEST(Allocate)
+  {
+    btk::MemoryArena::Pointer arena = btk::MemoryArena::New(1024);
+    void* a = arena->Allocate(10);
+    void* b = arena->Allocate(10);
+    TS_ASSERT(a != 0);
+    TS_ASSERT(b != 0);
+    TS_ASSERT(a != b);
+    TS_ASSERT_EQUALS(reinterpret_cast<size_t>(a) % 16, 0u);
+    TS_ASSERT_EQUALS(reinterpret_cast<size_t>(b) % 16, 0u);
+    TS_ASSERT_EQUALS(arena->GetBlockNumber(), 1);
+    TS_ASSERT_EQUALS(arena->GetAllocationNumber(), 2);
+    TS_ASSERT(btk::MemoryArena::Contains(a));
+    TS_ASSERT(btk::MemoryArena::Contains(static_cast<char*>(b) + 9));
+    // The last allocation is reused
+    TS_ASSERT(btk::MemoryArena::Release(b));
+    TS_ASSERT_EQUALS(arena->GetAllocationNumber(), 1);
+    TS_ASSERT_EQUALS(arena->Allocate(10), b);
+    void* c = arena->Allocate(2048); // Dedicated block
+    TS_ASSERT_EQUALS(arena->GetBlockNumber(), 2);
+    TS_ASSERT_EQUALS(reinterpret_cast<size_t>(c) % 16, 0u);
+    std::vector<void*> d(200);
+    for (int i = 0 ; i < 200 ; ++i)
+      d[i] = arena->Allocate(8);
+    TS_ASSERT(arena->GetBlockNumber() > 2);
+    int i = 0;
+    TS_ASSERT(!btk::MemoryArena::Contains(&i));
+    TS_ASSERT(!btk::MemoryArena::Release(&i));
+    // The blocks are freed with the arena once all the allocations are released
+    btk::MemoryArena::Release(a);
+    btk::MemoryArena::Release(b);
+    btk::MemoryArena::Release(c);
+    for (int i = 0 ; i < 200 ; ++i)
+      btk::MemoryArena::Release(d[i]);
+    TS_ASSERT_EQUALS(arena->GetAllocationNumber(), 0);
+    TS_ASSERT(btk::MemoryArena::Contains(a));
+    arena.reset();
+    TS_ASSERT(!btk::MemoryArena::Contains(a));
+  };
+  
+  CXXTEST_TEST(EigenStorage)
+  {
+    btk::MemoryArena::Pointer arena = btk::MemoryArena::New();
+    Eigen::Matrix<double, Eigen::Dynamic, 3>* m = 0;
+    {
+      btk::MemoryArena::Scope scope(arena);
+      m = new Eigen::Matrix<double, Eigen::Dynamic, 3>(100, 3);
+      m->setConstant(1.5);
+    }
+    TS_ASSERT(btk::MemoryArena::Contains(m->data()));
+    TS_ASSERT_EQUALS(arena->GetAllocationNumber(), 1);
+    // Reallocated outside the arena
+    m->conservativeResize(200, 3);
+    TS_ASSERT(!btk::MemoryArena::Contains(m->data()));
+    TS_ASSERT_EQUALS(arena->GetAllocationNumber(), 0);
+    TS_ASSERT_EQUALS(m->coeff(99,2), 1.5);
+    // Reallocated in the arena
+    {
+      btk::MemoryArena::Scope scope(arena);
+      m->conservativeResize(300, 3);
+    }
+    TS_ASSERT(btk::MemoryArena::Contains(m->data()));
+    TS_ASSERT_EQUALS(m->coeff(99,2), 1.5);
+    delete m;
+    TS_ASSERT_EQUALS(arena->GetAllocationNumber(), 0);
+    // No arena
+    {
+      btk::MemoryArena::Scope scope(btk::MemoryArena::Pointer());
+      Eigen::Matrix<double, Eigen::Dynamic, 1> v(10);
+      TS_ASSERT(!btk::MemoryArena::Contains(v.data()));
+    }
+  };
+  
+  CXXTEST_TEST(MeasuresOutliveArena)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    btk::MemoryArena::Pointer arena = btk::MemoryArena::New();
+    {
+      btk::MemoryArena::Scope scope(arena);
+      acq->Init(5, 100, 4, 2);
+    }
+    TS_ASSERT_EQUALS(arena->GetAllocationNumber(), 5 * 2 + 4);
+    btk::Point::Pointer p = acq->GetPoint(4);
+    const double* data = p->GetValues().data();
+    TS_ASSERT(btk::MemoryArena::Contains(data));
+    p->GetValues().setConstant(2.0);
+    arena.reset(); // The blocks are kept by the allocations
+    acq.reset();
+    TS_ASSERT(btk::MemoryArena::Contains(data));
+    TS_ASSERT_EQUALS(p->GetValues().coeff(99,0), 2.0);
+    p.reset(); // Last allocation: the blocks are freed
+    TS_ASSERT(!btk::MemoryArena::Contains(data));
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(MemoryArenaTest)
+CXXTEST_TEST_REGISTRATION(MemoryArenaTest, Constructor)
+CXXTEST_TEST_REGISTRATION(MemoryArenaTest, Allocate)
+CXXTEST_TEST_REGISTRATION(MemoryArenaTest, EigenStorage)
+CXXTEST_TEST_REGISTRATION(MemoryArenaTest, MeasuresOutliveArena)
+#endif
@@ -0,0 +1,223 @@
+#ifndef MemoryFileTest_h
+#define MemoryFileTest_h
+
+#include <btkFileStream.h>
+#include <btkBinaryFileStream.h>
+#include <btkAcquisitionFileReader.h>
+#include <btkAcquisitionFileWriter.h>
+#include <btkC3DFileIO.h>
+#include <btkTRCFileIO.h>
+#include <btkConvert.h>
+#include <btkMemoryArena.h>
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+btk::Acquisition::Pointer btk_memory_file_acquisition()
+{
+  btk::Acquisition::Pointer acq = btk::Acquisition::New();
+  acq->Init(3, 50, 2, 2);
+  acq->SetPointFrequency(100.0);
+  for (int i = 0 ; i < 3 ; ++i)
+  {
+    acq->GetPoint(i)->SetLabel("uname*" + btk::ToString(i + 1));
+    for (int j = 0 ; j < 50 ; ++j)
+      acq->GetPoint(i)->GetValues().row(j) << 10.0 * i + j, 2.0 * j, -1.0 * j + 0.5;
+  }
+  for (int i = 0 ; i < 2 ; ++i)
+  {
+    for (int j = 0 ; j < 100 ; ++j)
+      acq->GetAnalog(i)->GetValues().coeffRef(j) = 0.25 * j - i;
+  }
+  return acq;
+};
+
+CXXTEST_SUITE(MemoryFileTest)
+{
+  CXXTEST_TEST(Registration)
+  {
+    std::string filename;
+    {
+      btk::MemoryFile file("abc", 3, ".txt");
+      filename = file.GetFilename();
+      TS_ASSERT_EQUALS(btk::MemoryFile::IsMemoryFile(filename.c_str()), true);
+      TS_ASSERT_EQUALS(btk::MemoryFile::ExtractSuffix(filename), ".txt");
+      btk::ifilestream ifs(filename.c_str());
+      TS_ASSERT_EQUALS(ifs.is_open(), true);
+      std::string content;
+      ifs >> content;
+      TS_ASSERT_EQUALS(content, "abc");
+    }
+    btk::ifilestream ifs(filename.c_str());
+    TS_ASSERT_EQUALS(ifs.is_open(), false);
+    TS_ASSERT_EQUALS(ifs.fail(), true);
+    TS_ASSERT_EQUALS(btk::MemoryFile::ExtractSuffix("foo/bar.c3d"), ".c3d");
+    TS_ASSERT_EQUALS(btk::MemoryFile::ExtractSuffix("foo.d/bar"), "");
+  };
+
+  CXXTEST_TEST(TextStream)
+  {
+    std::vector<char> buffer;
+    btk::MemoryFile file(&buffer, ".txt");
+    btk::ofilestream ofs(file.GetFilename().c_str());
+    ofs << "first " << 42 << "\n" << 1.5;
+    ofs.close();
+    TS_ASSERT_EQUALS(std::string(buffer.begin(), buffer.end()), "first 42\n1.5");
+
+    btk::ifilestream ifs(file.GetFilename().c_str());
+    std::string word; int i = 0; double d = 0.0;
+    ifs >> word >> i;
+    ifs.seekg(-3, std::ios_base::end);
+    ifs >> d;
+    TS_ASSERT_EQUALS(word, "first");
+    TS_ASSERT_EQUALS(i, 42);
+    TS_ASSERT_EQUALS(d, 1.5);
+  };
+
+  CXXTEST_TEST(BinaryStream)
+  {
+    std::vector<char> buffer;
+    btk::MemoryFile file(&buffer, ".bin");
+    btk::IEEEBigEndianBinaryFileStream obfs(file.GetFilename(), btk::BinaryFileStream::Out);
+    TS_ASSERT_EQUALS(obfs.IsOpen(), true);
+    for (int i = 0 ; i < 5000 ; ++i) // Larger than the initial buffer
+      obfs.Write(static_cast<int16_t>(i - 2500));
+    obfs.Write(3.25f);
+    obfs.Close();
+    TS_ASSERT_EQUALS(buffer.size(), 10004u);
+    TS_ASSERT_EQUALS(static_cast<unsigned char>(buffer[0]), 0xF6u); // -2500 = 0xF63C in big endian
+
+    btk::IEEEBigEndianBinaryFileStream ibfs(file.GetFilename(), btk::BinaryFileStream::In);
+    TS_ASSERT_EQUALS(ibfs.IsOpen(), true);
+    TS_ASSERT_EQUALS(ibfs.ReadI16(), -2500);
+    ibfs.SeekRead(9998, btk::BinaryFileStream::Current);
+    TS_ASSERT_EQUALS(ibfs.ReadFloat(), 3.25f);
+
+    btk::MemoryFile input(&buffer[0], 4);
+    btk::IEEEBigEndianBinaryFileStream rbfs(input.GetFilename(), btk::BinaryFileStream::In);
+    TS_ASSERT_EQUALS(rbfs.ReadI16(), -2500);
+    TS_ASSERT_EQUALS(rbfs.ReadI16(), -2499);
+    btk::IEEEBigEndianBinaryFileStream wbfs(input.GetFilename(), btk::BinaryFileStream::Out);
+    TS_ASSERT_EQUALS(wbfs.IsOpen(), false); // Input buffers are read-only
+  };
+
+  CXXTEST_TEST(C3DReaderWriterBuffer)
+  {
+    btk::Acquisition::Pointer acq = btk_memory_file_acquisition();
+    std::vector<char> buffer;
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    writer->SetInput(acq);
+    writer->SetFilename("trial.c3d"); // Only used to select the file format
+    writer->SetOutputBuffer(&buffer);
+    writer->Update();
+    TS_ASSERT(buffer.size() > 512u);
+    TS_ASSERT_EQUALS(buffer[1], 0x50);
+
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetInputBuffer(&buffer[0], buffer.size());
+    reader->Update();
+    btk::Acquisition::Pointer output = reader->GetOutput();
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 50);
+    TS_ASSERT_EQUALS(output->GetPointFrequency(), 100.0);
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 3);
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), 2);
+    TS_ASSERT_EQUALS(output->GetPoint(2)->GetLabel(), "uname*3");
+    for (int i = 0 ; i < 3 ; ++i)
+      TS_ASSERT_EIGEN_DELTA(output->GetPoint(i)->GetValues(), acq->GetPoint(i)->GetValues(), 1e-4);
+    for (int i = 0 ; i < 2 ; ++i)
+      TS_ASSERT_EIGEN_DELTA(output->GetAnalog(i)->GetValues(), acq->GetAnalog(i)->GetValues(), 1e-4);
+  };
+
+  CXXTEST_TEST(C3DReaderBufferMemoryArena)
+  {
+    btk::Acquisition::Pointer acq = btk_memory_file_acquisition();
+    std::vector<char> buffer;
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    writer->SetInput(acq);
+    writer->SetFilename("trial.c3d");
+    writer->SetOutputBuffer(&buffer);
+    writer->Update();
+    
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    TS_ASSERT(!reader->GetMemoryArenaUsed());
+    reader->SetMemoryArenaUsed(true);
+    reader->SetInputBuffer(&buffer[0], buffer.size());
+    reader->Update();
+    btk::Acquisition::Pointer output = reader->GetOutput();
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 3);
+    TS_ASSERT_EQUALS(output->GetAnalogNumber(), 2);
+    const double* data = output->GetPoint(0)->GetValues().data();
+    TS_ASSERT(btk::MemoryArena::Contains(data));
+    TS_ASSERT(btk::MemoryArena::Contains(output->GetAnalog(1)->GetValues().data()));
+    for (int i = 0 ; i < 3 ; ++i)
+      TS_ASSERT_EIGEN_DELTA(output->GetPoint(i)->GetValues(), acq->GetPoint(i)->GetValues(), 1e-4);
+    for (int i = 0 ; i < 2 ; ++i)
+      TS_ASSERT_EIGEN_DELTA(output->GetAnalog(i)->GetValues(), acq->GetAnalog(i)->GetValues(), 1e-4);
+    // The arena is freed with the acquisition
+    reader.reset();
+    output.reset();
+    TS_ASSERT(!btk::MemoryArena::Contains(data));
+  };
+  
+  CXXTEST_TEST(NoFilenameNoIOWithBuffer)
+  {
+    std::vector<char> buffer;
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    writer->SetInput(btk_memory_file_acquisition());
+    writer->SetOutputBuffer(&buffer);
+    TS_ASSERT_THROWS_EQUALS(writer->Update(), const btk::AcquisitionFileWriterException &e, e.what(), std::string("Filename or AcquisitionIO must be specified to select the format of the file written in memory."));
+  };
+
+  CXXTEST_TEST(TRCStream)
+  {
+    btk::Acquisition::Pointer acq = btk_memory_file_acquisition();
+    std::stringstream ss;
+    btk::TRCFileIO::Pointer io = btk::TRCFileIO::New();
+    io->WriteStream(ss, acq);
+    TS_ASSERT_EQUALS(ss.str().substr(0, 12), "PathFileType");
+
+    btk::Acquisition::Pointer output = btk::Acquisition::New();
+    btk::TRCFileIO::New()->ReadStream(ss, output);
+    TS_ASSERT_EQUALS(output->GetPointFrameNumber(), 50);
+    TS_ASSERT_EQUALS(output->GetPointNumber(), 3);
+    for (int i = 0 ; i < 3 ; ++i)
+      TS_ASSERT_EIGEN_DELTA(output->GetPoint(i)->GetValues(), acq->GetPoint(i)->GetValues(), 1e-4);
+  };
+
+  CXXTEST_TEST(Gait)
+  {
+    std::ifstream ifs((C3DFilePathIN + "others/Gait.c3d").c_str(), std::ios_base::in | std::ios_base::binary);
+    TS_ASSERT(ifs.is_open());
+    std::vector<char> data((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    ifs.close();
+
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(C3DFilePathIN + "others/Gait.c3d");
+    reader->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    btk::Acquisition::Pointer acq2 = btk::Acquisition::New();
+    btk::C3DFileIO::New()->ReadBuffer(&data[0], data.size(), acq2);
+
+    TS_ASSERT_EQUALS(acq->GetFirstFrame(), acq2->GetFirstFrame());
+    TS_ASSERT_EQUALS(acq->GetPointNumber(), acq2->GetPointNumber());
+    TS_ASSERT_EQUALS(acq->GetAnalogNumber(), acq2->GetAnalogNumber());
+    TS_ASSERT_EQUALS(acq->GetEventNumber(), acq2->GetEventNumber());
+    TS_ASSERT(*(acq->GetMetaData()) == *(acq2->GetMetaData()));
+    for (int i = 0 ; i < acq->GetPointNumber() ; ++i)
+      TS_ASSERT(acq->GetPoint(i)->GetValues() == acq2->GetPoint(i)->GetValues());
+    for (int i = 0 ; i < acq->GetAnalogNumber() ; ++i)
+      TS_ASSERT(acq->GetAnalog(i)->GetValues() == acq2->GetAnalog(i)->GetValues());
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(MemoryFileTest)
+CXXTEST_TEST_REGISTRATION(MemoryFileTest, Registration)
+CXXTEST_TEST_REGISTRATION(MemoryFileTest, TextStream)
+CXXTEST_TEST_REGISTRATION(MemoryFileTest, BinaryStream)
+CXXTEST_TEST_REGISTRATION(MemoryFileTest, C3DReaderWriterBuffer)
+CXXTEST_TEST_REGISTRATION(MemoryFileTest, C3DReaderBufferMemoryArena)
+CXXTEST_TEST_REGISTRATION(MemoryFileTest, NoFilenameNoIOWithBuffer)
+CXXTEST_TEST_REGISTRATION(MemoryFileTest, TRCStream)
+CXXTEST_TEST_REGISTRATION(MemoryFileTest, Gait)
+#endif
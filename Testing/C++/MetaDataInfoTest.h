@@ -855,6 +855,40 @@ CXXTEST_SUITE(MetaDataInfoTest)
     for (int i = 0 ; i < 5 ; ++i)
       TS_ASSERT_DELTA(val2.at(i), 1.2345, 0.0001);
   };
+  
+  CXXTEST_TEST(CloneShared)
+  {
+    std::vector<int16_t> values(4, 3);
+    btk::MetaDataInfo::Pointer test = btk::MetaDataInfo::New(values);
+    btk::MetaDataInfo::Pointer cloned = test->Clone();
+    TS_ASSERT_EQUALS(test->IsValuesShared(), true);
+    TS_ASSERT_EQUALS(cloned->IsValuesShared(), true);
+    TS_ASSERT_EQUALS(cloned->GetValue(2), test->GetValue(2));
+    TS_ASSERT(*test == *cloned);
+    cloned->SetValue(2, 5);
+    TS_ASSERT_EQUALS(test->IsValuesShared(), false);
+    TS_ASSERT_EQUALS(cloned->IsValuesShared(), false);
+    TS_ASSERT_EQUALS(test->ToInt(2), 3);
+    TS_ASSERT_EQUALS(cloned->ToInt(2), 5);
+    // Format
+    btk::MetaDataInfo::Pointer cloned2 = test->Clone();
+    cloned2->SetFormat(btk::MetaDataInfo::Char);
+    TS_ASSERT_EQUALS(test->GetFormat(), btk::MetaDataInfo::Integer);
+    TS_ASSERT_EQUALS(cloned2->GetFormat(), btk::MetaDataInfo::Char);
+    TS_ASSERT_EQUALS(test->ToInt(1), 3);
+    TS_ASSERT_EQUALS(cloned2->ToString(1), "3");
+    // New values
+    btk::MetaDataInfo::Pointer cloned3 = test->Clone();
+    cloned3->SetValues(std::vector<float>(2, 1.5f));
+    TS_ASSERT_EQUALS(test->GetFormat(), btk::MetaDataInfo::Integer);
+    TS_ASSERT_EQUALS(test->ToInt().size(), 4u);
+    TS_ASSERT_EQUALS(cloned3->ToFloat(1), 1.5f);
+    // Destroy the original
+    btk::MetaDataInfo::Pointer cloned4 = test->Clone();
+    test.reset();
+    TS_ASSERT_EQUALS(cloned4->IsValuesShared(), false);
+    TS_ASSERT_EQUALS(cloned4->ToInt(3), 3);
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(MetaDataInfoTest)
@@ -938,5 +972,6 @@ CXXTEST_TEST_REGISTRATION(MetaDataInfoTest, String2Byte_Number)
 CXXTEST_TEST_REGISTRATION(MetaDataInfoTest, String2Integer_Number)
 CXXTEST_TEST_REGISTRATION(MetaDataInfoTest, String2Real_Number)
 CXXTEST_TEST_REGISTRATION(MetaDataInfoTest, Real2String2Real_Number)
+CXXTEST_TEST_REGISTRATION(MetaDataInfoTest, CloneShared)
 
 #endif
@@ -4,6 +4,7 @@
 #include <btkMultiSTLFileWriter.h>
 #include <btkAcquisitionFileReader.h>
 #include <btkTriangleMesh.h>
+#include <btkBinaryFileStream.h>
 
 #include <fstream>
 
@@ -79,9 +80,56 @@ CXXTEST_SUITE(MultiSTLFileWriterTest)
     
     std::remove(filename.c_str());
   };
+  
+  CXXTEST_TEST(TriangleWithNormals)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(3, 2);
+    acq->GetPoint(0)->GetValues() << 0.0, 0.0, 0.0, 1.0, 1.0, 1.0;
+    acq->GetPoint(1)->GetValues() << 1.0, 0.0, 0.0, 2.0, 1.0, 1.0;
+    acq->GetPoint(2)->GetValues() << 0.0, 1.0, 0.0, 1.0, 2.0, 1.0;
+    acq->GetPoint(2)->GetResiduals().coeffRef(1) = -1.0; // Invalid face in the second frame
+    
+    std::vector<int> m(3);
+    for (int i = 0 ; i < 3 ; ++i)
+      m[i] = i;
+    std::vector<btk::TriangleMesh::VertexLink> l(3);
+    l[0].SetIds(0,1);
+    l[1].SetIds(0,2);
+    l[2].SetIds(1,2);
+    std::vector<btk::TriangleMesh::VertexFace> f(1, btk::TriangleMesh::VertexFace(0,1,2));
+    btk::TriangleMesh::Pointer mesh = btk::TriangleMesh::New(m,l,f);
+    
+    btk::MultiSTLFileWriter::Pointer stlwriter = btk::MultiSTLFileWriter::New();
+    stlwriter->SetInputAcquisition(acq);
+    stlwriter->SetInputMesh(mesh);
+    stlwriter->SetNormalsComputed(true);
+    stlwriter->SetFilePrefix(STLFilePathOUT + "Triangle_");
+    stlwriter->Update();
+    
+    btk::IEEELittleEndianBinaryFileStream ibfs(STLFilePathOUT + "Triangle_1.stl", btk::BinaryFileStream::In);
+    TS_ASSERT(ibfs.IsOpen());
+    ibfs.SeekRead(80, btk::BinaryFileStream::Begin);
+    TS_ASSERT_EQUALS(ibfs.ReadI32(), 1);
+    TS_ASSERT_EQUALS(ibfs.ReadFloat(), 0.0f);
+    TS_ASSERT_EQUALS(ibfs.ReadFloat(), 0.0f);
+    TS_ASSERT_EQUALS(ibfs.ReadFloat(), 1.0f);
+    std::vector<float> coords = ibfs.ReadFloat(9);
+    TS_ASSERT_EQUALS(coords[3], 1.0f);
+    TS_ASSERT_EQUALS(coords[7], 1.0f);
+    TS_ASSERT_EQUALS(ibfs.ReadU16(), 0);
+    ibfs.Close();
+    
+    ibfs.Open(STLFilePathOUT + "Triangle_2.stl", btk::BinaryFileStream::In);
+    TS_ASSERT(ibfs.IsOpen());
+    ibfs.SeekRead(80, btk::BinaryFileStream::Begin);
+    TS_ASSERT_EQUALS(ibfs.ReadI32(), 0);
+    ibfs.Close();
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(MultiSTLFileWriterTest)
 CXXTEST_TEST_REGISTRATION(MultiSTLFileWriterTest, MyCube)
+CXXTEST_TEST_REGISTRATION(MultiSTLFileWriterTest, TriangleWithNormals)
 
 #endif
\ No newline at end of file
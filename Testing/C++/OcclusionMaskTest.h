@@ -0,0 +1,129 @@
+#ifndef OcclusionMaskTest_h
+#define OcclusionMaskTest_h
+
+#include <btkOcclusionMask.h>
+#include <btkPoint.h>
+
+#include <limits>
+
+CXXTEST_SUITE(OcclusionMaskTest)
+{
+  CXXTEST_TEST(Constructor)
+  {
+    btk::OcclusionMask mask;
+    TS_ASSERT_EQUALS(mask.GetFrameNumber(), 0);
+    TS_ASSERT_EQUALS(mask.GetGapNumber(), 0);
+    TS_ASSERT_EQUALS(mask.GetLongestGap(), 0);
+    TS_ASSERT_EQUALS(mask.GetValidRanges().size(), 0u);
+    btk::OcclusionMask mask2(130);
+    TS_ASSERT_EQUALS(mask2.GetFrameNumber(), 130);
+    TS_ASSERT_EQUALS(mask2.GetValidFrameNumber(), 130);
+    TS_ASSERT_EQUALS(mask2.GetGapNumber(), 0);
+    TS_ASSERT_EQUALS(mask2.GetWords().size(), 3u);
+    TS_ASSERT_EQUALS(mask2.GetWords()[2], 3u);
+    TS_ASSERT_EQUALS(mask2.GetValidRanges().size(), 1u);
+    TS_ASSERT_EQUALS(mask2.GetValidRanges()[0].length, 130);
+  };
+  
+  CXXTEST_TEST(Gaps)
+  {
+    std::vector<double> residuals(300, 0.5);
+    for (int i = 0 ; i < 3 ; ++i) residuals[i] = -1.0; // At the beginning
+    residuals[63] = -1.0; residuals[64] = -1.0; // Across two words
+    for (int i = 100 ; i < 250 ; ++i) residuals[i] = -1.0; // Full words
+    residuals[299] = -1.0; // At the end
+    btk::OcclusionMask mask(&residuals[0], 300);
+    TS_ASSERT_EQUALS(mask.GetFrameNumber(), 300);
+    TS_ASSERT_EQUALS(mask.GetOccludedFrameNumber(), 156);
+    TS_ASSERT_EQUALS(mask.GetValidFrameNumber(), 144);
+    TS_ASSERT_EQUALS(mask.GetGapNumber(), 4);
+    TS_ASSERT_EQUALS(mask.GetLongestGap(), 150);
+    const std::vector<btk::OcclusionMask::Range>& gaps = mask.GetGaps();
+    TS_ASSERT_EQUALS(gaps[0].start, 0); TS_ASSERT_EQUALS(gaps[0].length, 3);
+    TS_ASSERT_EQUALS(gaps[1].start, 63); TS_ASSERT_EQUALS(gaps[1].length, 2);
+    TS_ASSERT_EQUALS(gaps[2].start, 100); TS_ASSERT_EQUALS(gaps[2].length, 150);
+    TS_ASSERT_EQUALS(gaps[3].start, 299); TS_ASSERT_EQUALS(gaps[3].length, 1);
+    for (int i = 0 ; i < 300 ; ++i)
+      TS_ASSERT_EQUALS(mask.IsValid(i), residuals[i] >= 0.0);
+    std::vector<btk::OcclusionMask::Range> ranges = mask.GetValidRanges();
+    TS_ASSERT_EQUALS(ranges.size(), 3u);
+    TS_ASSERT_EQUALS(ranges[0].start, 3); TS_ASSERT_EQUALS(ranges[0].length, 60);
+    TS_ASSERT_EQUALS(ranges[1].start, 65); TS_ASSERT_EQUALS(ranges[1].length, 35);
+    TS_ASSERT_EQUALS(ranges[2].start, 250); TS_ASSERT_EQUALS(ranges[2].length, 49);
+    
+    std::vector<float> packed(residuals.begin(), residuals.end());
+    btk::OcclusionMask mask2(&packed[0], 300);
+    TS_ASSERT(mask2.GetWords() == mask.GetWords());
+  };
+  
+  CXXTEST_TEST(Combination)
+  {
+    std::vector<double> r1(100, 0.0), r2(100, 0.0);
+    for (int i = 10 ; i < 20 ; ++i) r1[i] = -1.0;
+    for (int i = 15 ; i < 30 ; ++i) r2[i] = -1.0;
+    btk::OcclusionMask all(&r1[0], 100), any(&r1[0], 100);
+    all &= btk::OcclusionMask(&r2[0], 100);
+    any |= btk::OcclusionMask(&r2[0], 100);
+    TS_ASSERT_EQUALS(all.GetGapNumber(), 1);
+    TS_ASSERT_EQUALS(all.GetGaps()[0].start, 10);
+    TS_ASSERT_EQUALS(all.GetGaps()[0].length, 20);
+    TS_ASSERT_EQUALS(any.GetGapNumber(), 1);
+    TS_ASSERT_EQUALS(any.GetGaps()[0].start, 15);
+    TS_ASSERT_EQUALS(any.GetGaps()[0].length, 5);
+    all &= btk::OcclusionMask(50); // Different number of frames: not combined
+    TS_ASSERT_EQUALS(all.GetOccludedFrameNumber(), 20);
+    
+    btk::Point::Values values = btk::Point::Values::Ones(100, 3);
+    all.FillOccluded(values, 0.0);
+    TS_ASSERT_EQUALS(values.sum(), 240.0);
+    TS_ASSERT_EQUALS(values.coeff(29,2), 0.0);
+    TS_ASSERT_EQUALS(values.coeff(30,2), 1.0);
+  };
+  
+  CXXTEST_TEST(Point)
+  {
+    btk::Point::Pointer pt = btk::Point::New(50);
+    TS_ASSERT_EQUALS(pt->GetOcclusionMask().GetFrameNumber(), 50);
+    TS_ASSERT_EQUALS(pt->GetOcclusionMask().GetGapNumber(), 0);
+    pt->GetResiduals().segment(5, 10).setConstant(-1.0);
+    TS_ASSERT_EQUALS(pt->GetOcclusionMask().GetGapNumber(), 1);
+    TS_ASSERT_EQUALS(pt->GetOcclusionMask().GetLongestGap(), 10);
+    btk::Point::Pointer pt2 = pt->Clone();
+    TS_ASSERT(pt2->GetOcclusionMask().GetWords() == pt->GetOcclusionMask().GetWords());
+    pt2->SetDataSlice(30, 0.0, 0.0, 0.0, -1.0);
+    TS_ASSERT_EQUALS(pt2->GetOcclusionMask().GetGapNumber(), 2);
+    TS_ASSERT_EQUALS(pt->GetOcclusionMask().GetGapNumber(), 1);
+    pt->SetFrameNumber(10);
+    TS_ASSERT_EQUALS(pt->GetOcclusionMask().GetFrameNumber(), 10);
+    TS_ASSERT_EQUALS(pt->GetOcclusionMask().GetOccludedFrameNumber(), 5);
+    pt2->GetData()->PackValues();
+    TS_ASSERT_EQUALS(pt2->GetOcclusionMask().GetOccludedFrameNumber(), 11);
+    TS_ASSERT(pt2->GetData()->GetPackedResiduals() != 0); // Not unpacked
+    btk::Point::Residuals r = btk::Point::Residuals::Constant(10, -1.0);
+    pt->SetResiduals(r);
+    TS_ASSERT_EQUALS(pt->GetOcclusionMask().GetValidFrameNumber(), 0);
+    // Kept until the residuals are accessed for modification
+    const btk::OcclusionMask* mask = &(pt->GetOcclusionMask());
+    TS_ASSERT_EQUALS(&(pt->GetOcclusionMask()), mask);
+    btk::Point::Residuals& res = pt->GetResiduals();
+    res.coeffRef(3) = 0.0;
+    TS_ASSERT_EQUALS(pt->GetOcclusionMask().GetValidFrameNumber(), 1);
+    TS_ASSERT_EQUALS(pt->GetOcclusionMask().IsValid(3), true);
+    // Modification through a reference obtained before the mask: the residuals must be requested again
+    res.coeffRef(4) = 0.0;
+    TS_ASSERT_EQUALS(pt->GetOcclusionMask().GetValidFrameNumber(), 1);
+    pt->GetResiduals();
+    TS_ASSERT_EQUALS(pt->GetOcclusionMask().GetValidFrameNumber(), 2);
+    // Only the negative residuals are occluded
+    pt->GetResiduals().coeffRef(5) = std::numeric_limits<double>::quiet_NaN();
+    TS_ASSERT_EQUALS(pt->GetOcclusionMask().IsValid(5), true);
+    TS_ASSERT_EQUALS(pt->GetOcclusionMask().GetValidFrameNumber(), 3);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(OcclusionMaskTest)
+CXXTEST_TEST_REGISTRATION(OcclusionMaskTest, Constructor)
+CXXTEST_TEST_REGISTRATION(OcclusionMaskTest, Gaps)
+CXXTEST_TEST_REGISTRATION(OcclusionMaskTest, Combination)
+CXXTEST_TEST_REGISTRATION(OcclusionMaskTest, Point)
+#endif
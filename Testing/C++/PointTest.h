@@ -64,6 +64,116 @@ CXXTEST_SUITE(PointTest)
       TS_ASSERT_DELTA(cloned->GetValues().coeff(i),point->GetValues().coeff(i),1e-15);
   };
   
+  CXXTEST_TEST(DataCloneShared)
+  {
+    btk::Point::Pointer point = btk::Point::New("HEEL_R", 5);
+    point->SetValues(Eigen::Matrix<double,Eigen::Dynamic,3>::Random(5,3));
+    point->SetResiduals(Eigen::Matrix<double,Eigen::Dynamic,1>::Constant(5,1,0.5));
+    btk::Point::Pointer cloned = point->Clone();
+    TS_ASSERT_EQUALS(point->GetData()->IsValuesShared(), true);
+    TS_ASSERT_EQUALS(cloned->GetData()->IsValuesShared(), true);
+    TS_ASSERT_EQUALS(cloned->GetData()->IsResidualsShared(), true);
+    btk::Point::ConstPointer constCloned = cloned;
+    TS_ASSERT_EQUALS(constCloned->GetValues().data(), static_cast<btk::Point::ConstPointer>(point)->GetValues().data());
+    TS_ASSERT_EQUALS(constCloned->GetFrameNumber(), 5);
+    TS_ASSERT_EQUALS(cloned->GetData()->IsValuesShared(), true);
+    // Detach on the first modification
+    double value = point->GetValues().coeff(2,1);
+    cloned->GetValues().coeffRef(2,1) = value + 1.0;
+    TS_ASSERT_EQUALS(point->GetData()->IsValuesShared(), false);
+    TS_ASSERT_EQUALS(cloned->GetData()->IsValuesShared(), false);
+    TS_ASSERT_EQUALS(point->GetValues().coeff(2,1), value);
+    TS_ASSERT_EQUALS(cloned->GetValues().coeff(2,1), value + 1.0);
+    // Residuals
+    TS_ASSERT_EQUALS(cloned->GetData()->IsResidualsShared(), true);
+    cloned->GetResiduals().coeffRef(3) = -1.0;
+    TS_ASSERT_EQUALS(point->GetResiduals().coeff(3), 0.5);
+    TS_ASSERT_EQUALS(cloned->GetResiduals().coeff(3), -1.0);
+    // Resize
+    btk::Point::Pointer cloned2 = point->Clone();
+    cloned2->SetFrameNumber(3);
+    TS_ASSERT_EQUALS(point->GetFrameNumber(), 5);
+    TS_ASSERT_EQUALS(cloned2->GetFrameNumber(), 3);
+    TS_ASSERT_EQUALS(cloned2->GetValues().coeff(2,1), value);
+    TS_ASSERT_EQUALS(point->GetData()->IsValuesShared(), false);
+  };
+  
+  CXXTEST_TEST(PackedValues)
+  {
+    btk::Point::Pointer point = btk::Point::New("HEEL_R", 5);
+    point->SetValues(Eigen::Matrix<double,Eigen::Dynamic,3>::Random(5,3));
+    point->SetResiduals(Eigen::Matrix<double,Eigen::Dynamic,1>::Constant(5,1,0.5));
+    btk::Point::Values ref = point->GetValues();
+    btk::Point::Pointer cloned = point->Clone();
+    unsigned long int t = point->GetTimestamp();
+    point->PackValues();
+    TS_ASSERT(point->GetTimestamp() > t);
+    TS_ASSERT_EQUALS(point->IsValuesPacked(), true);
+    TS_ASSERT_EQUALS(cloned->IsValuesPacked(), false);
+    TS_ASSERT_EQUALS(point->GetData()->IsValuesShared(), false);
+    TS_ASSERT_EQUALS(point->GetFrameNumber(), 5);
+    TS_ASSERT_EQUALS(point->IsValuesPacked(), true);
+    TS_ASSERT(point->GetData()->GetPackedValues() != 0);
+    TS_ASSERT_EQUALS(point->GetData()->GetPackedValues()->coeff(2,1), static_cast<float>(ref.coeff(2,1)));
+    TS_ASSERT_EQUALS(point->GetData()->GetPackedResiduals()->coeff(4), 0.5f);
+    // Packed values are shared by the clones
+    btk::Point::Pointer cloned2 = point->Clone();
+    TS_ASSERT_EQUALS(cloned2->IsValuesPacked(), true);
+    TS_ASSERT_EQUALS(cloned2->GetData()->IsValuesShared(), true);
+    // Read without being unpacked
+    btk::Point::ConstPointer constPoint = point;
+    TS_ASSERT_EIGEN_DELTA(constPoint->GetValues(), ref, 1e-6);
+    TS_ASSERT_EQUALS(constPoint->GetResiduals().coeff(4), 0.5);
+    TS_ASSERT_EQUALS(&(constPoint->GetValues()), &(constPoint->GetValues())); // Conversion kept
+    TS_ASSERT_EIGEN_DELTA(constPoint->CopyValues(), ref, 1e-6);
+    TS_ASSERT_EQUALS(constPoint->CopyResiduals().coeff(4), 0.5);
+    TS_ASSERT_EQUALS(point->IsValuesPacked(), true);
+    TS_ASSERT(point->GetData()->GetPackedResiduals() != 0);
+    TS_ASSERT_EQUALS(cloned2->GetData()->IsValuesShared(), true);
+    // The conversion is released when packed again and becomes the values once unpacked
+    point->PackValues();
+    TS_ASSERT_EQUALS(point->IsValuesPacked(), true);
+    btk::Point::Pointer cloned3 = point->Clone();
+    btk::Point::ConstPointer constCloned3 = cloned3;
+    const double* converted = constCloned3->GetValues().data();
+    cloned3->UnpackValues();
+    TS_ASSERT_EQUALS(cloned3->IsValuesPacked(), false);
+    TS_ASSERT_EQUALS(cloned3->GetValues().data(), converted);
+    TS_ASSERT_EIGEN_DELTA(cloned3->GetValues(), ref, 1e-6);
+    TS_ASSERT_EQUALS(point->IsValuesPacked(), true);
+    // Converted back when accessed for modification
+    cloned2->GetValues().coeffRef(0,0) = 10.0;
+    TS_ASSERT_EQUALS(cloned2->IsValuesPacked(), false);
+    TS_ASSERT_EQUALS(cloned2->GetValues().coeff(0,0), 10.0);
+    TS_ASSERT(cloned2->GetData()->GetPackedResiduals() != 0);
+    TS_ASSERT_EQUALS(cloned2->GetResiduals().coeff(4), 0.5);
+    TS_ASSERT(cloned2->GetData()->GetPackedResiduals() == 0);
+    TS_ASSERT_EQUALS(point->IsValuesPacked(), true);
+    TS_ASSERT_EQUALS(point->GetData()->IsValuesShared(), false);
+    TS_ASSERT_EQUALS(point->CopyValues().coeff(0,0), static_cast<double>(static_cast<float>(ref.coeff(0,0))));
+    TS_ASSERT_EQUALS(cloned->GetValues().coeff(0,0), ref.coeff(0,0));
+    // Resize keeps the values packed
+    point->SetFrameNumber(7);
+    TS_ASSERT_EQUALS(point->IsValuesPacked(), true);
+    TS_ASSERT_EQUALS(point->GetFrameNumber(), 7);
+    TS_ASSERT_EQUALS(point->GetData()->GetPackedResiduals()->rows(), 7);
+    TS_ASSERT_EQUALS(point->GetData()->GetPackedResiduals()->coeff(4), 0.5f);
+    TS_ASSERT_EQUALS(point->GetData()->GetPackedValues()->coeff(6,2), 0.0f);
+    point->UnpackValues();
+    TS_ASSERT_EQUALS(point->IsValuesPacked(), false);
+    TS_ASSERT(point->GetData()->GetPackedResiduals() == 0);
+    TS_ASSERT_EQUALS(constPoint->GetResiduals().coeff(4), 0.5);
+    TS_ASSERT_EQUALS(constPoint->GetValues().coeff(6,2), 0.0);
+    // Set packed values
+    point->PackValues();
+    point->SetValues(ref);
+    point->SetResiduals(Eigen::Matrix<double,Eigen::Dynamic,1>::Constant(5,1,-1.0));
+    TS_ASSERT_EQUALS(point->IsValuesPacked(), false);
+    TS_ASSERT(point->GetData()->GetPackedResiduals() == 0);
+    TS_ASSERT_EQUALS(point->GetValues(), ref);
+    TS_ASSERT_EQUALS(point->GetResiduals().coeff(2), -1.0);
+  };
+  
   CXXTEST_TEST(EigenDataFromMap)
   {
     double data[12] = {1.0,2.0,3.0,4.0,5.0,6.0,7.0,8.0,9.0,10.0,11.0,12.0};
@@ -117,6 +227,8 @@ CXXTEST_TEST_REGISTRATION(PointTest, FrameNumber)
 CXXTEST_TEST_REGISTRATION(PointTest, DataWithParent)
 CXXTEST_TEST_REGISTRATION(PointTest, DataWithoutParent)
 CXXTEST_TEST_REGISTRATION(PointTest, DataClone)  
+CXXTEST_TEST_REGISTRATION(PointTest, DataCloneShared)
+CXXTEST_TEST_REGISTRATION(PointTest, PackedValues)
 CXXTEST_TEST_REGISTRATION(PointTest, EigenDataFromMap)
 CXXTEST_TEST_REGISTRATION(PointTest, EigenDataMapCopied)
 CXXTEST_TEST_REGISTRATION(PointTest, EigenDataRowMajorFromMap)
@@ -0,0 +1,251 @@
+#ifndef ResampleFilterTest_h
+#define ResampleFilterTest_h
+
+#include <btkResampleFilter.h>
+#include <btkConvert.h>
+
+CXXTEST_SUITE(ResampleFilterTest)
+{
+  CXXTEST_TEST(Factors)
+  {
+    btk::ResampleFilter<btk::Analog>::Pointer rs = btk::ResampleFilter<btk::Analog>::New();
+    TS_ASSERT_EQUALS(rs->GetUpFactor(), 1);
+    TS_ASSERT_EQUALS(rs->GetDownFactor(), 1);
+    rs->SetFactors(120, 2000);
+    TS_ASSERT_EQUALS(rs->GetUpFactor(), 3);
+    TS_ASSERT_EQUALS(rs->GetDownFactor(), 50);
+    rs->SetFactors(0, 2);
+    TS_ASSERT_EQUALS(rs->GetUpFactor(), 3);
+    TS_ASSERT_EQUALS(rs->GetDownFactor(), 50);
+  };
+  
+  CXXTEST_TEST(AnalogRatioOne)
+  {
+    btk::Analog::Pointer a = btk::Analog::New("Test", 10);
+    a->SetValues(Eigen::Matrix<double,10,1>::Random());
+    a->SetUnit("N");
+    
+    btk::ResampleFilter<btk::Analog>::Pointer rs = btk::ResampleFilter<btk::Analog>::New();
+    rs->SetInput(a);
+    rs->SetFactors(4, 4);
+    rs->Update();
+    TS_ASSERT_EQUALS(rs->GetOutput()->GetFrameNumber(), 10);
+    TS_ASSERT_EQUALS(rs->GetOutput()->GetLabel(), "Test");
+    TS_ASSERT_EQUALS(rs->GetOutput()->GetUnit(), "N");
+    for (int i = 0 ; i < 10 ; ++i)
+      TS_ASSERT_EQUALS(rs->GetOutput()->GetValues()(i), a->GetValues()(i));
+  };
+  
+  CXXTEST_TEST(AnalogConstant)
+  {
+    btk::Analog::Pointer a = btk::Analog::New("Test", 1000);
+    a->GetValues().setConstant(2.5);
+    
+    btk::ResampleFilter<btk::Analog>::Pointer rs = btk::ResampleFilter<btk::Analog>::New();
+    rs->SetInput(a);
+    rs->SetFactors(3, 50);
+    rs->Update();
+    TS_ASSERT_EQUALS(rs->GetOutput()->GetFrameNumber(), 60);
+    for (int i = 0 ; i < 60 ; ++i)
+      TS_ASSERT_DELTA(rs->GetOutput()->GetValues()(i), 2.5, 1e-10);
+  };
+  
+  CXXTEST_TEST(AnalogSineUpsampling)
+  {
+    const double pi = 3.14159265358979323846;
+    btk::Analog::Pointer a = btk::Analog::New("Test", 200);
+    for (int i = 0 ; i < 200 ; ++i)
+      a->GetValues()(i) = std::sin(2.0 * pi * 5.0 * static_cast<double>(i) / 100.0);
+    
+    btk::ResampleFilter<btk::Analog>::Pointer rs = btk::ResampleFilter<btk::Analog>::New();
+    rs->SetInput(a);
+    rs->SetFactors(3, 2); // 100 Hz -> 150 Hz
+    rs->Update();
+    TS_ASSERT_EQUALS(rs->GetOutput()->GetFrameNumber(), 300);
+    // Far from the edges, the resampled sine must be the sine sampled at 150 Hz.
+    for (int i = 50 ; i < 250 ; ++i)
+      TS_ASSERT_DELTA(rs->GetOutput()->GetValues()(i), std::sin(2.0 * pi * 5.0 * static_cast<double>(i) / 150.0), 1e-2);
+  };
+  
+  CXXTEST_TEST(AnalogAntiAliasing)
+  {
+    const double pi = 3.14159265358979323846;
+    btk::Analog::Pointer a = btk::Analog::New("Test", 2000);
+    // 5 Hz component kept and 400 Hz component above the new Nyquist frequency (50 Hz).
+    for (int i = 0 ; i < 2000 ; ++i)
+    {
+      const double t = static_cast<double>(i) / 1000.0;
+      a->GetValues()(i) = std::sin(2.0 * pi * 5.0 * t) + std::sin(2.0 * pi * 400.0 * t);
+    }
+    
+    btk::ResampleFilter<btk::Analog>::Pointer rs = btk::ResampleFilter<btk::Analog>::New();
+    rs->SetInput(a);
+    rs->SetFactors(1, 10);
+    rs->Update();
+    TS_ASSERT_EQUALS(rs->GetOutput()->GetFrameNumber(), 200);
+    for (int i = 20 ; i < 180 ; ++i)
+      TS_ASSERT_DELTA(rs->GetOutput()->GetValues()(i), std::sin(2.0 * pi * 5.0 * static_cast<double>(i) / 100.0), 1e-2);
+  };
+  
+  CXXTEST_TEST(AnalogCollection)
+  {
+    btk::AnalogCollection::Pointer ac = btk::AnalogCollection::New();
+    for (int i = 0 ; i < 5 ; ++i)
+    {
+      btk::Analog::Pointer a = btk::Analog::New("Test" + btk::ToString(i), 500);
+      a->GetValues().setConstant(static_cast<double>(i));
+      ac->InsertItem(a);
+    }
+    
+    btk::ResampleFilter<btk::AnalogCollection>::Pointer rs = btk::ResampleFilter<btk::AnalogCollection>::New();
+    rs->SetInput(ac);
+    rs->SetFactors(2, 5);
+    rs->Update();
+    TS_ASSERT_EQUALS(rs->GetOutput()->GetItemNumber(), 5);
+    for (int j = 0 ; j < 5 ; ++j)
+    {
+      TS_ASSERT_EQUALS(rs->GetOutput()->GetItem(j)->GetLabel(), "Test" + btk::ToString(j));
+      TS_ASSERT_EQUALS(rs->GetOutput()->GetItem(j)->GetFrameNumber(), 200);
+      for (int i = 0 ; i < 200 ; ++i)
+        TS_ASSERT_DELTA(rs->GetOutput()->GetItem(j)->GetValues()(i), static_cast<double>(j), 1e-10);
+    }
+  };
+  
+  CXXTEST_TEST(PointOccluded)
+  {
+    btk::Point::Pointer p = btk::Point::New("Test", 100);
+    for (int i = 0 ; i < 100 ; ++i)
+      p->SetDataSlice(i, 1.0, 2.0, 3.0, 0.5);
+    for (int i = 40 ; i < 50 ; ++i)
+      p->SetDataSlice(i, 0.0, 0.0, 0.0, -1.0);
+    
+    btk::ResampleFilter<btk::Point>::Pointer rs = btk::ResampleFilter<btk::Point>::New();
+    rs->SetInput(p);
+    rs->SetFactors(1, 2);
+    rs->Update();
+    btk::Point::Pointer out = rs->GetOutput();
+    TS_ASSERT_EQUALS(out->GetFrameNumber(), 50);
+    TS_ASSERT_EQUALS(out->GetLabel(), "Test");
+    for (int i = 0 ; i < 50 ; ++i)
+    {
+      if ((i >= 20) && (i < 25))
+      {
+        TS_ASSERT_EQUALS(out->GetResiduals()(i), -1.0);
+        TS_ASSERT_EQUALS(out->GetValues()(i,0), 0.0);
+      }
+      else
+        TS_ASSERT_EQUALS(out->GetResiduals()(i), 0.5);
+    }
+    TS_ASSERT_DELTA(out->GetValues()(5,0), 1.0, 1e-10);
+    TS_ASSERT_DELTA(out->GetValues()(5,1), 2.0, 1e-10);
+    TS_ASSERT_DELTA(out->GetValues()(5,2), 3.0, 1e-10);
+  };
+  
+  CXXTEST_TEST(PointGap)
+  {
+    btk::Point::Pointer p = btk::Point::New("Test", 200);
+    for (int i = 0 ; i < 200 ; ++i)
+      p->SetDataSlice(i, 0.5 * i, 10.0 - 0.25 * i, 3.0, 0.5);
+    btk::Point::Pointer ref = p->Clone();
+    for (int i = 80 ; i < 90 ; ++i)
+      p->SetDataSlice(i, 0.0, 0.0, 0.0, -1.0);
+    
+    btk::ResampleFilter<btk::Point>::Pointer rs = btk::ResampleFilter<btk::Point>::New();
+    rs->SetInput(p);
+    rs->SetFactors(1, 2);
+    rs->Update();
+    btk::Point::Pointer out = rs->GetOutput();
+    btk::ResampleFilter<btk::Point>::Pointer rsRef = btk::ResampleFilter<btk::Point>::New();
+    rsRef->SetInput(ref);
+    rsRef->SetFactors(1, 2);
+    rsRef->Update();
+    TS_ASSERT_EQUALS(out->GetFrameNumber(), 100);
+    // The gap is not used by the filter: the frames next to it are the same than without the gap.
+    for (int i = 30 ; i < 55 ; ++i)
+    {
+      if ((i >= 40) && (i < 45))
+      {
+        TS_ASSERT_EQUALS(out->GetResiduals()(i), -1.0);
+        TS_ASSERT_EQUALS(out->GetValues()(i,0), 0.0);
+      }
+      else
+      {
+        TS_ASSERT_EQUALS(out->GetResiduals()(i), 0.5);
+        TS_ASSERT_DELTA(out->GetValues()(i,0), rsRef->GetOutput()->GetValues()(i,0), 1e-10);
+        TS_ASSERT_DELTA(out->GetValues()(i,1), rsRef->GetOutput()->GetValues()(i,1), 1e-10);
+        TS_ASSERT_DELTA(out->GetValues()(i,2), 3.0, 1e-10);
+      }
+    }
+    TS_ASSERT_DELTA(out->GetValues()(39,0), 39.0, 1e-6);
+    TS_ASSERT_DELTA(out->GetValues()(45,0), 45.0, 1e-6);
+    // The input is not modified.
+    TS_ASSERT_EQUALS(p->GetValues()(85,0), 0.0);
+  };
+  
+  CXXTEST_TEST(PointGapAtTheBeginning)
+  {
+    btk::Point::Pointer p = btk::Point::New("Test", 100);
+    for (int i = 0 ; i < 100 ; ++i)
+      p->SetDataSlice(i, 1.0, 2.0, 3.0, (i < 10) ? -1.0 : 0.5);
+    
+    btk::ResampleFilter<btk::Point>::Pointer rs = btk::ResampleFilter<btk::Point>::New();
+    rs->SetInput(p);
+    rs->SetFactors(1, 2);
+    rs->Update();
+    btk::Point::Pointer out = rs->GetOutput();
+    for (int i = 0 ; i < 5 ; ++i)
+      TS_ASSERT_EQUALS(out->GetResiduals()(i), -1.0);
+    for (int i = 5 ; i < 50 ; ++i)
+    {
+      TS_ASSERT_EQUALS(out->GetResiduals()(i), 0.5);
+      TS_ASSERT_DELTA(out->GetValues()(i,0), 1.0, 1e-10);
+      TS_ASSERT_DELTA(out->GetValues()(i,2), 3.0, 1e-10);
+    }
+  };
+  
+  CXXTEST_TEST(WrenchCollection)
+  {
+    btk::WrenchCollection::Pointer wc = btk::WrenchCollection::New();
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      btk::Wrench::Pointer w = btk::Wrench::New("Test" + btk::ToString(i), 300);
+      w->GetPosition()->GetValues().setConstant(1.0);
+      w->GetForce()->GetValues().setConstant(2.0);
+      w->GetMoment()->GetValues().setConstant(3.0);
+      wc->InsertItem(w);
+    }
+    
+    btk::ResampleFilter<btk::WrenchCollection>::Pointer rs = btk::ResampleFilter<btk::WrenchCollection>::New();
+    rs->SetInput(wc);
+    rs->SetFactors(2, 3);
+    rs->Update();
+    TS_ASSERT_EQUALS(rs->GetOutput()->GetItemNumber(), 2);
+    for (int j = 0 ; j < 2 ; ++j)
+    {
+      btk::Wrench::Pointer w = rs->GetOutput()->GetItem(j);
+      TS_ASSERT_EQUALS(w->GetPosition()->GetFrameNumber(), 200);
+      TS_ASSERT_EQUALS(w->GetForce()->GetFrameNumber(), 200);
+      TS_ASSERT_EQUALS(w->GetMoment()->GetFrameNumber(), 200);
+      TS_ASSERT_EQUALS(w->GetForce()->GetLabel(), wc->GetItem(j)->GetForce()->GetLabel());
+      for (int i = 0 ; i < 200 ; ++i)
+      {
+        TS_ASSERT_DELTA(w->GetPosition()->GetValues()(i,0), 1.0, 1e-10);
+        TS_ASSERT_DELTA(w->GetForce()->GetValues()(i,1), 2.0, 1e-10);
+        TS_ASSERT_DELTA(w->GetMoment()->GetValues()(i,2), 3.0, 1e-10);
+      }
+    }
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(ResampleFilterTest)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, Factors)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, AnalogRatioOne)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, AnalogConstant)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, AnalogSineUpsampling)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, AnalogAntiAliasing)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, AnalogCollection)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, PointOccluded)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, PointGap)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, PointGapAtTheBeginning)
+CXXTEST_TEST_REGISTRATION(ResampleFilterTest, WrenchCollection)
+#endif
@@ -0,0 +1,202 @@
+#ifndef RigidBodyPoseFilterTest_h
+#define RigidBodyPoseFilterTest_h
+
+#include <btkRigidBodyPoseFilter.h>
+
+#include <Eigen/Geometry>
+
+// Markers moving as a rigid body: p(f) = R(f) * l + t(f), with R(0) = I
+static btk::PointCollection::Pointer RigidBodyPoseFilterTest_Cluster(const Eigen::Matrix<double, 3, Eigen::Dynamic>& local, int numFrames, std::vector<Eigen::Matrix<double, 3, 3> >* R, std::vector<Eigen::Matrix<double, 3, 1> >* t)
+{
+  btk::PointCollection::Pointer points = btk::PointCollection::New();
+  for (int j = 0 ; j < local.cols() ; ++j)
+  {
+    btk::Point::Pointer p = btk::Point::New("M" + btk::ToString(j), numFrames);
+    p->GetResiduals().setZero();
+    points->InsertItem(p);
+  }
+  for (int f = 0 ; f < numFrames ; ++f)
+  {
+    R->push_back(Eigen::AngleAxis<double>(0.02 * f, Eigen::Matrix<double, 3, 1>(1.0, 2.0, 0.5).normalized()).toRotationMatrix());
+    t->push_back(Eigen::Matrix<double, 3, 1>(10.0 + 2.0 * f, -5.0 + 0.5 * f, 900.0 - f));
+    for (int j = 0 ; j < local.cols() ; ++j)
+      points->GetItem(j)->GetValues().row(f) = ((*R)[f] * local.col(j) + (*t)[f]).transpose();
+  }
+  return points;
+};
+
+static Eigen::Matrix<double, 3, Eigen::Dynamic> RigidBodyPoseFilterTest_Local()
+{
+  Eigen::Matrix<double, 3, Eigen::Dynamic> local(3,4);
+  local << 50.0, -40.0, -30.0, 20.0,
+           10.0, 60.0, -50.0, -20.0,
+           -5.0, 15.0, 0.0, -10.0;
+  local.colwise() -= local.rowwise().mean();
+  return local;
+};
+
+CXXTEST_SUITE(RigidBodyPoseFilterTest)
+{
+  CXXTEST_TEST(NoInput)
+  {
+    btk::RigidBodyPoseFilter::Pointer filter = btk::RigidBodyPoseFilter::New();
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItemNumber(), 0);
+  };
+  
+  CXXTEST_TEST(InvalidSegment)
+  {
+    btk::RigidBodyPoseFilter::Pointer filter = btk::RigidBodyPoseFilter::New();
+    std::vector<std::string> markers(2);
+    markers[0] = "M0"; markers[1] = "M1";
+    filter->AppendSegment("SEG", markers);
+    TS_ASSERT_EQUALS(filter->GetSegments().size(), 0u);
+    markers.push_back("M2");
+    filter->AppendSegment(btk::RigidBodyPoseFilter::Segment("SEG", markers, Eigen::Matrix<double, 3, Eigen::Dynamic>::Zero(3,2)));
+    TS_ASSERT_EQUALS(filter->GetSegments().size(), 0u);
+    filter->AppendSegment("SEG", markers);
+    TS_ASSERT_EQUALS(filter->GetSegments().size(), 1u);
+    filter->ClearSegments();
+    TS_ASSERT_EQUALS(filter->GetSegments().size(), 0u);
+  };
+  
+  CXXTEST_TEST(ReferenceFrame)
+  {
+    std::vector<Eigen::Matrix<double, 3, 3> > R;
+    std::vector<Eigen::Matrix<double, 3, 1> > t;
+    btk::PointCollection::Pointer points = RigidBodyPoseFilterTest_Cluster(RigidBodyPoseFilterTest_Local(), 50, &R, &t);
+    std::vector<std::string> markers(4);
+    for (int j = 0 ; j < 4 ; ++j)
+      markers[j] = "M" + btk::ToString(j);
+    btk::RigidBodyPoseFilter::Pointer filter = btk::RigidBodyPoseFilter::New();
+    filter->SetInput(points);
+    filter->AppendSegment("SEG", markers);
+    filter->Update();
+    btk::PointCollection::Pointer output = filter->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 4);
+    TS_ASSERT_EQUALS(output->GetItem(0)->GetLabel(), "SEGO");
+    TS_ASSERT_EQUALS(output->GetItem(1)->GetLabel(), "SEGA");
+    TS_ASSERT_EQUALS(output->GetItem(2)->GetLabel(), "SEGL");
+    TS_ASSERT_EQUALS(output->GetItem(3)->GetLabel(), "SEGP");
+    for (int f = 0 ; f < 50 ; ++f)
+    {
+      TS_ASSERT_EIGEN_DELTA(output->GetItem(0)->GetValues().row(f).transpose(), t[f], 1e-8);
+      for (int i = 0 ; i < 3 ; ++i)
+        TS_ASSERT_EIGEN_DELTA(output->GetItem(i+1)->GetValues().row(f).transpose(), (t[f] + 100.0 * R[f].col(i)), 1e-8);
+    }
+    TS_ASSERT(output->GetItem(0)->GetResiduals().minCoeff() >= 0.0);
+    TS_ASSERT_DELTA(output->GetItem(0)->GetResiduals().maxCoeff(), 0.0, 1e-8);
+  };
+  
+  CXXTEST_TEST(OccludedMarkers)
+  {
+    std::vector<Eigen::Matrix<double, 3, 3> > R;
+    std::vector<Eigen::Matrix<double, 3, 1> > t;
+    btk::PointCollection::Pointer points = RigidBodyPoseFilterTest_Cluster(RigidBodyPoseFilterTest_Local(), 50, &R, &t);
+    // Marker 0 occluded during the first frames: reference frame moved to the frame 5
+    points->GetItem(0)->GetValues().block(0,0,5,3).setZero();
+    points->GetItem(0)->GetResiduals().segment(0,5).setConstant(-1.0);
+    // One marker occluded: pose still computed
+    points->GetItem(1)->GetValues().block(10,0,10,3).setZero();
+    points->GetItem(1)->GetResiduals().segment(10,10).setConstant(-1.0);
+    // Two markers occluded: pose not computed
+    points->GetItem(2)->GetValues().block(15,0,3,3).setZero();
+    points->GetItem(2)->GetResiduals().segment(15,3).setConstant(-1.0);
+    std::vector<std::string> markers(4);
+    for (int j = 0 ; j < 4 ; ++j)
+      markers[j] = "M" + btk::ToString(j);
+    markers.push_back("Unknown");
+    btk::RigidBodyPoseFilter::Pointer filter = btk::RigidBodyPoseFilter::New();
+    filter->SetInput(points);
+    filter->AppendSegment("SEG", markers);
+    filter->SetAxisLength(10.0);
+    filter->Update();
+    btk::PointCollection::Pointer output = filter->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 4);
+    // Origin: centroid of the markers, axes: rotation relative to the frame 5
+    for (int f = 0 ; f < 50 ; ++f)
+    {
+      if ((f >= 15) && (f < 18))
+      {
+        TS_ASSERT_EQUALS(output->GetItem(0)->GetResiduals().coeff(f), -1.0);
+        TS_ASSERT_EQUALS(output->GetItem(3)->GetResiduals().coeff(f), -1.0);
+        TS_ASSERT_EQUALS(output->GetItem(0)->GetValues().row(f).norm(), 0.0);
+        continue;
+      }
+      const Eigen::Matrix<double, 3, 3> Rf = R[f] * R[5].transpose();
+      const Eigen::Matrix<double, 3, 1>& tf = t[f];
+      TS_ASSERT_EIGEN_DELTA(output->GetItem(0)->GetValues().row(f).transpose(), tf, 1e-8);
+      for (int i = 0 ; i < 3 ; ++i)
+        TS_ASSERT_EIGEN_DELTA(output->GetItem(i+1)->GetValues().row(f).transpose(), (tf + 10.0 * Rf.col(i)), 1e-8);
+      TS_ASSERT_DELTA(output->GetItem(0)->GetResiduals().coeff(f), 0.0, 1e-8);
+    }
+  };
+  
+  CXXTEST_TEST(LocalCoordinates)
+  {
+    std::vector<Eigen::Matrix<double, 3, 3> > R;
+    std::vector<Eigen::Matrix<double, 3, 1> > t;
+    Eigen::Matrix<double, 3, Eigen::Dynamic> local = RigidBodyPoseFilterTest_Local();
+    local.colwise() += Eigen::Matrix<double, 3, 1>(100.0, 0.0, -20.0); // Origin not at the centroid
+    btk::PointCollection::Pointer points = RigidBodyPoseFilterTest_Cluster(local, 30, &R, &t);
+    std::vector<std::string> markers(4);
+    for (int j = 0 ; j < 4 ; ++j)
+      markers[j] = "M" + btk::ToString(j);
+    // Noise on one marker
+    points->GetItem(3)->GetValues().col(0).array() += 1.0;
+    btk::RigidBodyPoseFilter::Pointer filter = btk::RigidBodyPoseFilter::New();
+    filter->SetInput(points);
+    filter->AppendSegment(btk::RigidBodyPoseFilter::Segment("RTI", markers, local));
+    filter->AppendSegment(btk::RigidBodyPoseFilter::Segment("LTI", markers, local));
+    filter->Update();
+    btk::PointCollection::Pointer output = filter->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 8);
+    TS_ASSERT_EQUALS(output->GetItem(4)->GetLabel(), "LTIO");
+    for (int f = 0 ; f < 30 ; ++f)
+    {
+      TS_ASSERT_EIGEN_DELTA(output->GetItem(0)->GetValues().row(f).transpose(), t[f], 0.5);
+      TS_ASSERT_EIGEN_DELTA(output->GetItem(4)->GetValues().row(f), output->GetItem(0)->GetValues().row(f), 1e-10);
+    }
+    TS_ASSERT(output->GetItem(0)->GetResiduals().minCoeff() > 0.1);
+    TS_ASSERT(output->GetItem(0)->GetResiduals().maxCoeff() < 1.0);
+  };
+  
+  CXXTEST_TEST(SharedPackedMarkers)
+  {
+    std::vector<Eigen::Matrix<double, 3, 3> > R;
+    std::vector<Eigen::Matrix<double, 3, 1> > t;
+    btk::PointCollection::Pointer points = RigidBodyPoseFilterTest_Cluster(RigidBodyPoseFilterTest_Local(), 20, &R, &t);
+    std::vector<std::string> markers(4);
+    for (int j = 0 ; j < 4 ; ++j)
+    {
+      markers[j] = "M" + btk::ToString(j);
+      points->GetItem(j)->PackValues();
+    }
+    btk::Point::Pointer cloned = points->GetItem(0)->Clone();
+    btk::RigidBodyPoseFilter::Pointer filter = btk::RigidBodyPoseFilter::New();
+    filter->SetInput(points);
+    filter->AppendSegment("RTI", markers);
+    filter->AppendSegment("LTI", markers);
+    filter->Update();
+    btk::PointCollection::Pointer output = filter->GetOutput();
+    TS_ASSERT_EQUALS(output->GetItemNumber(), 8);
+    for (int f = 0 ; f < 20 ; ++f)
+    {
+      TS_ASSERT_EIGEN_DELTA(output->GetItem(0)->GetValues().row(f).transpose(), t[f], 1e-3);
+      TS_ASSERT_EIGEN_DELTA(output->GetItem(4)->GetValues().row(f), output->GetItem(0)->GetValues().row(f), 1e-10);
+    }
+    // Input not modified
+    for (int j = 0 ; j < 4 ; ++j)
+      TS_ASSERT_EQUALS(points->GetItem(j)->IsValuesPacked(), true);
+    TS_ASSERT_EQUALS(cloned->GetData()->IsValuesShared(), true);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(RigidBodyPoseFilterTest)
+CXXTEST_TEST_REGISTRATION(RigidBodyPoseFilterTest, NoInput)
+CXXTEST_TEST_REGISTRATION(RigidBodyPoseFilterTest, InvalidSegment)
+CXXTEST_TEST_REGISTRATION(RigidBodyPoseFilterTest, ReferenceFrame)
+CXXTEST_TEST_REGISTRATION(RigidBodyPoseFilterTest, OccludedMarkers)
+CXXTEST_TEST_REGISTRATION(RigidBodyPoseFilterTest, LocalCoordinates)
+CXXTEST_TEST_REGISTRATION(RigidBodyPoseFilterTest, SharedPackedMarkers)
+#endif
@@ -0,0 +1,140 @@
+#ifndef SpectralAnalysisFilterTest_h
+#define SpectralAnalysisFilterTest_h
+
+#include <btkSpectralAnalysisFilter.h>
+
+#ifndef M_PI
+  #define M_PI 3.14159265358979323846
+#endif
+
+CXXTEST_SUITE(SpectralAnalysisFilterTest)
+{
+  CXXTEST_TEST(NoInput)
+  {
+    btk::SpectralAnalysisFilter::Pointer filter = btk::SpectralAnalysisFilter::New();
+    filter->Update();
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItemNumber(), 0);
+    TS_ASSERT_EQUALS(filter->GetFeatureOutput()->GetAnalogNumber(), 0);
+    TS_ASSERT_EQUALS(filter->GetFrequencies().rows(), 0);
+  };
+  
+  CXXTEST_TEST(Sine)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0, 2048, 2, 1);
+    acq->SetPointFrequency(1024.0);
+    for (int i = 0 ; i < 2048 ; ++i)
+    {
+      acq->GetAnalog(0)->GetValues().coeffRef(i) = 1.0 + 2.0 * std::sin(2.0 * M_PI * 48.0 * i / 1024.0); // Offset removed by the detrend
+      acq->GetAnalog(1)->GetValues().coeffRef(i) = 0.5 * std::sin(2.0 * M_PI * 200.0 * i / 1024.0);
+    }
+    acq->GetAnalog(0)->SetUnit("V");
+    
+    btk::SpectralAnalysisFilter::Pointer filter = btk::SpectralAnalysisFilter::New();
+    filter->SetInput(acq);
+    filter->SetBandFrequencies(40.0, 56.0);
+    filter->Update();
+    
+    TS_ASSERT_EQUALS(filter->GetFrequencies().rows(), 129);
+    TS_ASSERT_DELTA(filter->GetFrequencies().coeff(1), 4.0, 1e-12);
+    btk::AnalogCollection::Pointer psd = filter->GetOutput();
+    TS_ASSERT_EQUALS(psd->GetItemNumber(), 2);
+    TS_ASSERT_EQUALS(psd->GetItem(0)->GetLabel(), acq->GetAnalog(0)->GetLabel());
+    TS_ASSERT_EQUALS(psd->GetItem(0)->GetUnit(), "V^2/Hz");
+    TS_ASSERT_EQUALS(psd->GetItem(0)->GetFrameNumber(), 129);
+    int peak = 0;
+    psd->GetItem(0)->GetValues().maxCoeff(&peak);
+    TS_ASSERT_EQUALS(peak, 12);
+    psd->GetItem(1)->GetValues().maxCoeff(&peak);
+    TS_ASSERT_EQUALS(peak, 50);
+    // The integral of the PSD is the variance
+    TS_ASSERT_DELTA(psd->GetItem(0)->GetValues().sum() * 4.0, 2.0, 1e-6);
+    TS_ASSERT_DELTA(psd->GetItem(1)->GetValues().sum() * 4.0, 0.125, 1e-6);
+    
+    btk::Acquisition::Pointer features = filter->GetFeatureOutput();
+    TS_ASSERT_EQUALS(features->GetAnalogNumber(), 6);
+    TS_ASSERT_EQUALS(features->GetAnalogFrameNumber(), 15);
+    TS_ASSERT_DELTA(features->GetAnalogFrequency(), 8.0, 1e-12);
+    TS_ASSERT_EQUALS(features->GetAnalog(0)->GetLabel(), acq->GetAnalog(0)->GetLabel() + ".MNF");
+    TS_ASSERT_EQUALS(features->GetAnalog(4)->GetLabel(), acq->GetAnalog(1)->GetLabel() + ".MDF");
+    TS_ASSERT_EQUALS(features->GetAnalog(2)->GetUnit(), "V^2");
+    for (int s = 0 ; s < 15 ; ++s)
+    {
+      TS_ASSERT_DELTA(features->GetAnalog(0)->GetValues().coeff(s), 48.0, 1e-6);
+      TS_ASSERT_DELTA(features->GetAnalog(1)->GetValues().coeff(s), 48.0, 1e-6);
+      TS_ASSERT_DELTA(features->GetAnalog(2)->GetValues().coeff(s), 2.0, 1e-6);
+      TS_ASSERT_DELTA(features->GetAnalog(3)->GetValues().coeff(s), 200.0, 1e-6);
+      TS_ASSERT_DELTA(features->GetAnalog(5)->GetValues().coeff(s), 0.0, 1e-12);
+    }
+  };
+  
+  CXXTEST_TEST(SlidingFeatures)
+  {
+    // First half at 100 Hz, second half at 300 Hz
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0, 1000, 1, 1);
+    acq->SetPointFrequency(1000.0);
+    for (int i = 0 ; i < 1000 ; ++i)
+      acq->GetAnalog(0)->GetValues().coeffRef(i) = std::sin(2.0 * M_PI * (i < 500 ? 100.0 : 300.0) * i / 1000.0);
+    
+    btk::SpectralAnalysisFilter::Pointer filter = btk::SpectralAnalysisFilter::New();
+    filter->SetInput(acq);
+    filter->SetSegmentLength(100); // Not a power of two
+    filter->SetOverlap(0.0);
+    filter->SetBandFrequencies(200.0, 0.0);
+    filter->Update();
+    
+    TS_ASSERT_EQUALS(filter->GetFrequencies().rows(), 51);
+    btk::Acquisition::Pointer features = filter->GetFeatureOutput();
+    TS_ASSERT_EQUALS(features->GetAnalogFrameNumber(), 10);
+    TS_ASSERT_DELTA(features->GetAnalogFrequency(), 10.0, 1e-12);
+    for (int s = 0 ; s < 10 ; ++s)
+    {
+      TS_ASSERT_DELTA(features->GetAnalog(0)->GetValues().coeff(s), s < 5 ? 100.0 : 300.0, 1e-6);
+      TS_ASSERT_DELTA(features->GetAnalog(1)->GetValues().coeff(s), s < 5 ? 100.0 : 300.0, 1e-6);
+      TS_ASSERT_DELTA(features->GetAnalog(2)->GetValues().coeff(s), s < 5 ? 0.0 : 0.5, 1e-6);
+    }
+  };
+  
+  CXXTEST_TEST(LabelsAndShortSignal)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0, 100, 3, 1);
+    acq->SetPointFrequency(100.0);
+    for (int i = 0 ; i < 100 ; ++i)
+    {
+      acq->GetAnalog(0)->GetValues().coeffRef(i) = std::sin(0.1 * i);
+      acq->GetAnalog(1)->GetValues().coeffRef(i) = std::cos(0.3 * i);
+      acq->GetAnalog(2)->GetValues().coeffRef(i) = std::sin(0.7 * i);
+    }
+    std::list<std::string> labels;
+    labels.push_back(acq->GetAnalog(2)->GetLabel());
+    labels.push_back(acq->GetAnalog(0)->GetLabel());
+    
+    btk::SpectralAnalysisFilter::Pointer filter = btk::SpectralAnalysisFilter::New();
+    filter->SetInput(acq);
+    filter->SetLabels(labels);
+    filter->Update();
+    
+    // Signal shorter than the segment: only one segment
+    TS_ASSERT_EQUALS(filter->GetFrequencies().rows(), 51);
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItemNumber(), 2);
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItem(0)->GetLabel(), acq->GetAnalog(0)->GetLabel());
+    TS_ASSERT_EQUALS(filter->GetOutput()->GetItem(1)->GetLabel(), acq->GetAnalog(2)->GetLabel());
+    TS_ASSERT_EQUALS(filter->GetFeatureOutput()->GetAnalogNumber(), 6);
+    TS_ASSERT_EQUALS(filter->GetFeatureOutput()->GetAnalogFrameNumber(), 1);
+    TS_ASSERT(filter->GetFeatureOutput()->GetAnalog(0)->GetValues().coeff(0) > 0.0);
+    
+    filter->SetSegmentLength(1);
+    TS_ASSERT_EQUALS(filter->GetSegmentLength(), 256);
+    filter->SetOverlap(1.0);
+    TS_ASSERT_EQUALS(filter->GetOverlap(), 0.5);
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(SpectralAnalysisFilterTest)
+CXXTEST_TEST_REGISTRATION(SpectralAnalysisFilterTest, NoInput)
+CXXTEST_TEST_REGISTRATION(SpectralAnalysisFilterTest, Sine)
+CXXTEST_TEST_REGISTRATION(SpectralAnalysisFilterTest, SlidingFeatures)
+CXXTEST_TEST_REGISTRATION(SpectralAnalysisFilterTest, LabelsAndShortSignal)
+#endif
@@ -3,6 +3,10 @@
 
 #include <btkAcquisitionFileReader.h>
 #include <btkTDFFileIO.h>
+#include <btkAcquisitionFileWriter.h>
+
+#include <fstream>
+#include <iterator>
 
 CXXTEST_SUITE(TDFFileReaderTest)
 {
@@ -60,6 +64,88 @@ CXXTEST_SUITE(TDFFileReaderTest)
     TS_ASSERT_EQUALS(acq->GetAnalog(16)->GetUnit(), "V");
     TS_ASSERT_EQUALS(acq->GetAnalog(17)->GetUnit(), "V");
   };
+  
+  CXXTEST_TEST(gait9_EMGBlockOnly)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(TDFFilePathIN + "gait9.tdf");
+    reader->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    
+    btk::TDFFileIO::Pointer io = btk::TDFFileIO::New();
+    io->SetBlocksToRead(btk::TDFFileIO::EMGBlock);
+    btk::AcquisitionFileReader::Pointer reader2 = btk::AcquisitionFileReader::New();
+    reader2->SetFilename(TDFFilePathIN + "gait9.tdf");
+    reader2->SetAcquisitionIO(io);
+    reader2->Update();
+    btk::Acquisition::Pointer acq2 = reader2->GetOutput();
+    
+    TS_ASSERT_EQUALS(acq2->GetPointNumber(), 0);
+    TS_ASSERT_EQUALS(acq2->GetAnalogFrequency(), 1000.0);
+    TS_ASSERT_EQUALS(acq2->GetAnalogNumber(), 6);
+    TS_ASSERT_EQUALS(acq2->GetMetaData()->FindChild("FORCE_PLATFORM"), acq2->GetMetaData()->End());
+    const int num = std::min(acq->GetAnalogFrameNumber(), acq2->GetAnalogFrameNumber());
+    TS_ASSERT(num > 0);
+    for (int i = 0 ; i < 6 ; ++i)
+    {
+      TS_ASSERT_EQUALS(acq2->GetAnalog(i)->GetLabel(), acq->GetAnalog(12+i)->GetLabel());
+      TS_ASSERT_EQUALS(acq2->GetAnalog(i)->GetUnit(), "V");
+      TS_ASSERT_EIGEN_DELTA(acq2->GetAnalog(i)->GetValues().head(num), acq->GetAnalog(12+i)->GetValues().head(num), 1e-5);
+    }
+  };
+  
+  CXXTEST_TEST(gait9_MarkerBlockOnly)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(TDFFilePathIN + "gait9.tdf");
+    reader->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    
+    btk::TDFFileIO::Pointer io = btk::TDFFileIO::New();
+    io->SetBlocksToRead(btk::TDFFileIO::MarkerBlock);
+    btk::AcquisitionFileReader::Pointer reader2 = btk::AcquisitionFileReader::New();
+    reader2->SetFilename(TDFFilePathIN + "gait9.tdf");
+    reader2->SetAcquisitionIO(io);
+    reader2->Update();
+    btk::Acquisition::Pointer acq2 = reader2->GetOutput();
+    
+    TS_ASSERT_EQUALS(acq2->GetPointFrequency(), 250.0);
+    TS_ASSERT_EQUALS(acq2->GetPointNumber(), 30);
+    TS_ASSERT_EQUALS(acq2->GetPointFrameNumber(), 1686);
+    TS_ASSERT_EQUALS(acq2->GetAnalogNumber(), 0);
+    for (int i = 0 ; i < 30 ; ++i)
+    {
+      TS_ASSERT_EQUALS(acq2->GetPoint(i)->GetLabel(), acq->GetPoint(i)->GetLabel());
+      TS_ASSERT_EIGEN_DELTA(acq2->GetPoint(i)->GetValues(), acq->GetPoint(i)->GetValues(), 1e-5);
+      TS_ASSERT_EIGEN_DELTA(acq2->GetPoint(i)->GetResiduals(), acq->GetPoint(i)->GetResiduals(), 1e-5);
+    }
+  };
+  CXXTEST_TEST(InvalidEMGSegment)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(0,20,1,1);
+    acq->SetPointFrequency(100.0);
+    acq->GetAnalog(0)->SetLabel("EMG1");
+    acq->GetAnalog(0)->GetValues().setConstant(1.0);
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    writer->SetInput(acq);
+    writer->SetFilename(TDFFilePathOUT + "InvalidEMGSegment.tdf");
+    writer->Update();
+    
+    // The first frame of the segment is moved after the end of the block.
+    std::fstream file((TDFFilePathOUT + "InvalidEMGSegment.tdf").c_str(), std::ios::in | std::ios::out | std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const size_t pos = content.find("EMG1");
+    TS_ASSERT(pos != std::string::npos);
+    const char start[4] = {0x10, 0x00, 0x00, 0x00};
+    file.seekp(pos + 256 + 8);
+    file.write(start, 4);
+    file.close();
+    
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(TDFFilePathOUT + "InvalidEMGSegment.tdf");
+    TS_ASSERT_THROWS_EQUALS(reader->Update(), const btk::TDFFileIOException &e, e.what(), std::string("Invalid segment. Its frames are out of the block."));
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(TDFFileReaderTest)
@@ -67,4 +153,7 @@ CXXTEST_TEST_REGISTRATION(TDFFileReaderTest, NoFile)
 CXXTEST_TEST_REGISTRATION(TDFFileReaderTest, MisspelledFile)
 CXXTEST_TEST_REGISTRATION(TDFFileReaderTest, FalseFile)
 CXXTEST_TEST_REGISTRATION(TDFFileReaderTest, gait9)
+CXXTEST_TEST_REGISTRATION(TDFFileReaderTest, gait9_EMGBlockOnly)
+CXXTEST_TEST_REGISTRATION(TDFFileReaderTest, gait9_MarkerBlockOnly)
+CXXTEST_TEST_REGISTRATION(TDFFileReaderTest, InvalidEMGSegment)
 #endif
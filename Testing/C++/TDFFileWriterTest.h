@@ -0,0 +1,120 @@
+#ifndef TDFFileWriterTest_h
+#define TDFFileWriterTest_h
+
+#include <btkAcquisitionFileWriter.h>
+#include <btkAcquisitionFileReader.h>
+#include <btkTDFFileIO.h>
+
+CXXTEST_SUITE(TDFFileWriterTest)
+{
+  CXXTEST_TEST(NoFileWithIO)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(TDFFilePathIN + "gait9.tdf");
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    btk::TDFFileIO::Pointer io = btk::TDFFileIO::New();
+    writer->SetAcquisitionIO(io);
+    TS_ASSERT_THROWS_EQUALS(writer->Update(), const btk::AcquisitionFileWriterException &e, e.what(), std::string("Filename must be specified."));
+  };
+  
+  CXXTEST_TEST(gait9_rewrited)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(TDFFilePathIN + "gait9.tdf");
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    writer->SetInput(reader->GetOutput());
+    writer->SetFilename(TDFFilePathOUT + "gait9_rewrited.tdf");
+    writer->Update();
+    
+    btk::AcquisitionFileReader::Pointer reader2 = btk::AcquisitionFileReader::New();
+    reader2->SetFilename(TDFFilePathOUT + "gait9_rewrited.tdf");
+    reader2->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    btk::Acquisition::Pointer acq2 = reader2->GetOutput();
+    
+    TS_ASSERT_EQUALS(acq->GetFirstFrame(), acq2->GetFirstFrame());
+    TS_ASSERT_EQUALS(acq->GetPointFrequency(), acq2->GetPointFrequency());
+    TS_ASSERT_EQUALS(acq->GetPointNumber(), acq2->GetPointNumber());
+    TS_ASSERT_EQUALS(acq->GetPointFrameNumber(), acq2->GetPointFrameNumber());
+    TS_ASSERT_EQUALS(acq->GetAnalogFrequency(), acq2->GetAnalogFrequency());
+    TS_ASSERT_EQUALS(acq->GetAnalogNumber(), acq2->GetAnalogNumber());
+    
+    for (int i = 0 ; i < acq->GetPointNumber() ; ++i)
+    {
+      TS_ASSERT_EQUALS(acq->GetPoint(i)->GetLabel(), acq2->GetPoint(i)->GetLabel());
+      TS_ASSERT_EIGEN_DELTA(acq->GetPoint(i)->GetValues(), acq2->GetPoint(i)->GetValues(), 1e-5);
+      TS_ASSERT_EIGEN_DELTA(acq->GetPoint(i)->GetResiduals(), acq2->GetPoint(i)->GetResiduals(), 1e-5);
+    }
+    for (int i = 0 ; i < acq->GetAnalogNumber() ; ++i)
+    {
+      TS_ASSERT_EQUALS(acq->GetAnalog(i)->GetLabel(), acq2->GetAnalog(i)->GetLabel());
+      TS_ASSERT_EIGEN_DELTA(acq->GetAnalog(i)->GetValues(), acq2->GetAnalog(i)->GetValues(), 1e-5);
+    }
+    
+    btk::MetaData::Pointer fp = acq->GetMetaData()->GetChild("FORCE_PLATFORM");
+    btk::MetaData::Pointer fp2 = acq2->GetMetaData()->GetChild("FORCE_PLATFORM");
+    TS_ASSERT_EQUALS(fp->GetChild("USED")->GetInfo()->ToInt(0), fp2->GetChild("USED")->GetInfo()->ToInt(0));
+    std::vector<float> corners = fp->GetChild("CORNERS")->GetInfo()->ToFloat();
+    std::vector<float> corners2 = fp2->GetChild("CORNERS")->GetInfo()->ToFloat();
+    TS_ASSERT_EQUALS(corners.size(), corners2.size());
+    for (size_t i = 0 ; i < std::min(corners.size(), corners2.size()) ; ++i)
+      TS_ASSERT_DELTA(corners[i], corners2[i], 1e-5);
+  };
+  
+  CXXTEST_TEST(gait9_EMGBlockOnly)
+  {
+    btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+    reader->SetFilename(TDFFilePathIN + "gait9.tdf");
+    btk::TDFFileIO::Pointer io = btk::TDFFileIO::New();
+    io->SetBlocksToRead(btk::TDFFileIO::EMGBlock);
+    reader->SetAcquisitionIO(io);
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    writer->SetInput(reader->GetOutput());
+    writer->SetFilename(TDFFilePathOUT + "gait9_EMGBlockOnly.tdf");
+    writer->Update();
+    
+    btk::AcquisitionFileReader::Pointer reader2 = btk::AcquisitionFileReader::New();
+    reader2->SetFilename(TDFFilePathOUT + "gait9_EMGBlockOnly.tdf");
+    reader2->Update();
+    btk::Acquisition::Pointer acq = reader->GetOutput();
+    btk::Acquisition::Pointer acq2 = reader2->GetOutput();
+    
+    TS_ASSERT_EQUALS(acq2->GetPointNumber(), 0);
+    TS_ASSERT_EQUALS(acq->GetAnalogFrequency(), acq2->GetAnalogFrequency());
+    TS_ASSERT_EQUALS(acq->GetAnalogFrameNumber(), acq2->GetAnalogFrameNumber());
+    TS_ASSERT_EQUALS(acq->GetAnalogNumber(), acq2->GetAnalogNumber());
+    for (int i = 0 ; i < acq->GetAnalogNumber() ; ++i)
+    {
+      TS_ASSERT_EQUALS(acq->GetAnalog(i)->GetLabel(), acq2->GetAnalog(i)->GetLabel());
+      TS_ASSERT_EIGEN_DELTA(acq->GetAnalog(i)->GetValues(), acq2->GetAnalog(i)->GetValues(), 1e-5);
+    }
+  };
+  
+  CXXTEST_TEST(SharedValues)
+  {
+    btk::Acquisition::Pointer acq = btk::Acquisition::New();
+    acq->Init(2, 20, 2, 2);
+    acq->SetPointFrequency(100.0);
+    acq->GetPoint(0)->SetValues(btk::Point::Values::Random(20,3));
+    acq->GetAnalog(1)->SetValues(btk::Analog::Values::Random(40,1));
+    btk::Acquisition::Pointer cloned = acq->Clone();
+    btk::AcquisitionFileWriter::Pointer writer = btk::AcquisitionFileWriter::New();
+    writer->SetInput(acq);
+    writer->SetFilename(TDFFilePathOUT + "SharedValues.tdf");
+    writer->Update();
+    // The writer only reads the values: they are still shared with the clone.
+    for (int i = 0 ; i < 2 ; ++i)
+    {
+      TS_ASSERT_EQUALS(acq->GetPoint(i)->GetData()->IsValuesShared(), true);
+      TS_ASSERT_EQUALS(acq->GetPoint(i)->GetData()->IsResidualsShared(), true);
+      TS_ASSERT_EQUALS(acq->GetAnalog(i)->GetData()->IsValuesShared(), true);
+    }
+  };
+};
+
+CXXTEST_SUITE_REGISTRATION(TDFFileWriterTest)
+CXXTEST_TEST_REGISTRATION(TDFFileWriterTest, NoFileWithIO)
+CXXTEST_TEST_REGISTRATION(TDFFileWriterTest, gait9_rewrited)
+CXXTEST_TEST_REGISTRATION(TDFFileWriterTest, gait9_EMGBlockOnly)
+CXXTEST_TEST_REGISTRATION(TDFFileWriterTest, SharedValues)
+#endif
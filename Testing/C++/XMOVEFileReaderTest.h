@@ -4,6 +4,7 @@
 #include "_TDDIO_Open3DMotion_Utils.h"
 
 #include <btkAcquisitionFileReader.h>
+#include <btkXMOVEFileIO.h>
 #include <btkConvert.h>
 
 CXXTEST_SUITE(XMOVEFileReaderTest)
@@ -25,10 +26,16 @@ CXXTEST_SUITE(XMOVEFileReaderTest)
   {
     btk_o3dm_ADemo1_test(XMOVEFilePathIN + "ADemo1_rewrite_XMove.xml");
   };
+  
+  CXXTEST_TEST(ADemo1_rewrite_XMove_DirectDecoding)
+  {
+    btk_o3dm_decoding_test<btk::XMOVEFileIO>(XMOVEFilePathIN + "ADemo1_rewrite_XMove.xml");
+  };
 };
 
 CXXTEST_SUITE_REGISTRATION(XMOVEFileReaderTest)
 CXXTEST_TEST_REGISTRATION(XMOVEFileReaderTest, NoFile)
 CXXTEST_TEST_REGISTRATION(XMOVEFileReaderTest, MisspelledFile)
 CXXTEST_TEST_REGISTRATION(XMOVEFileReaderTest, ADemo1_rewrite_XMove)
+CXXTEST_TEST_REGISTRATION(XMOVEFileReaderTest, ADemo1_rewrite_XMove_DirectDecoding)
 #endif
@@ -2,15 +2,24 @@
 
 #include "AcquisitionUnitConverterTest.h"
 #include "AnalogOffsetRemoverTest.h"
+#include "ButterworthFilterTest.h"
 #include "DownSampleFilterTest.h"
+#include "EigenFFTTest.h"
+#include "EMGProcessingFilterTest.h"
 #include "ForcePlatformsExtractorTest.h"
 #include "ForcePlatformWrenchFilterTest.h"
 #include "GroundReactionWrenchFilterTest.h"
 #include "IMUsExtractorTest.h"
+#include "InverseDynamicsFilterTest.h"
+#include "JointAngleFilterTest.h"
+#include "MarkerGapFillingFilterTest.h"
 #include "MeasureFrameExtractorTest.h"
 #include "MergeAcquisitionFilterTest.h"
+#include "ResampleFilterTest.h"
+#include "RigidBodyPoseFilterTest.h"
 #include "SeparateKnownVirtualMarkersFilterTest.h"
 #include "SpecializedPointsExtractorTest.h"
+#include "SpectralAnalysisFilterTest.h"
 #include "SubAcquisitionFilterTest.h"
 #include "VerticalGroundReactionForceGaitEventDetectorTest.h"
 #include "WrenchDirectionAngleFilterTest.h"
@@ -0,0 +1,23 @@
+#ifndef _TDDBasicFilters_Segment_Utils_h
+#define _TDDBasicFilters_Segment_Utils_h
+
+#include <btkPointCollection.h>
+
+#include <Eigen/Geometry>
+
+// Virtual reference frame (origin and 3 axes with a length of 100) of a segment with the orientation R(f) and the origin t(f) for every frame.
+static void btk_segment_frame(btk::PointCollection::Pointer points, const std::string& label, const std::vector<Eigen::Matrix<double, 3, 3> >& R, const std::vector<Eigen::Matrix<double, 3, 1> >& t, double residual = 0.0)
+{
+  const int numFrames = static_cast<int>(R.size());
+  const char* suffixes[4] = {"O", "A", "L", "P"};
+  for (int i = 0 ; i < 4 ; ++i)
+  {
+    btk::Point::Pointer p = btk::Point::New(label + suffixes[i], numFrames);
+    p->GetResiduals().setConstant(residual);
+    for (int f = 0 ; f < numFrames ; ++f)
+      p->GetValues().row(f) = (t[f] + ((i == 0) ? Eigen::Matrix<double, 3, 1>::Zero() : Eigen::Matrix<double, 3, 1>(100.0 * R[f].col(i-1)))).transpose();
+    points->InsertItem(p);
+  }
+};
+
+#endif // _TDDBasicFilters_Segment_Utils_h
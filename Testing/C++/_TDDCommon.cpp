@@ -4,7 +4,9 @@
 #include "AnalogTest.h"
 #include "ForcePlatformTypesTest.h"
 #include "IMUTypesTest.h"
+#include "MemoryArenaTest.h"
 #include "NullPtrTest.h"
+#include "OcclusionMaskTest.h"
 #include "PointTest.h"
 #include "PointCollectionTest.h"
 #include "MetaDataInfoTest.h"
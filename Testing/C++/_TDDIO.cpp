@@ -3,6 +3,12 @@
 
 #include "BinaryFileStreamTest.h" // Be the first to test the stream
 
+#include "AcquisitionFileCacheTest.h"
+#include "MemoryFileTest.h"
+#include "Base64DecoderTest.h"
+#include "AcquisitionFileIndexTest.h"
+#include "AcquisitionFileBatchReaderTest.h"
+
 #include "ANBFileIOTest.h"
 #include "ANBFileReaderTest.h"
 #include "ANBFileWriterTest.h"
@@ -11,6 +17,8 @@
 #include "ANCFileWriterTest.h"
 #include "ANGFileIOTest.h"
 #include "ANGFileReaderTest.h"
+#include "BCAFileIOTest.h"
+#include "BCAFileWriterTest.h"
 #include "BSFFileIOTest.h"
 #include "BSFFileReaderTest.h"
 #include "CALForcePlateFileIOTest.h"
@@ -47,6 +55,7 @@
 #include "RICFileReaderTest.h"
 #include "TDFFileIOTest.h"
 #include "TDFFileReaderTest.h"
+#include "TDFFileWriterTest.h"
 #include "TRBFileIOTest.h"
 #include "TRBFileReaderTest.h"
 #include "TRCFileIOTest.h"
@@ -50,4 +50,45 @@ void btk_o3dm_ADemo1_test(const std::string& filename)
   }
 };
 
+template <typename T>
+void btk_o3dm_decoding_test(const std::string& filename)
+{
+  btk::AcquisitionFileReader::Pointer reader = btk::AcquisitionFileReader::New();
+  reader->SetAcquisitionIO(T::New());
+  reader->SetFilename(filename);
+  reader->Update();
+  btk::Acquisition::Pointer acq = reader->GetOutput();
+  
+  typename T::Pointer io = T::New();
+  io->SetDecodingMode(T::Open3DMotionDecoding);
+  btk::AcquisitionFileReader::Pointer readerRef = btk::AcquisitionFileReader::New();
+  readerRef->SetAcquisitionIO(io);
+  readerRef->SetFilename(filename);
+  readerRef->Update();
+  btk::Acquisition::Pointer ref = readerRef->GetOutput();
+  
+  TS_ASSERT_EQUALS(acq->GetFirstFrame(), ref->GetFirstFrame());
+  TS_ASSERT_EQUALS(acq->GetPointFrequency(), ref->GetPointFrequency());
+  TS_ASSERT_EQUALS(acq->GetPointFrameNumber(), ref->GetPointFrameNumber());
+  TS_ASSERT_EQUALS(acq->GetNumberAnalogSamplePerFrame(), ref->GetNumberAnalogSamplePerFrame());
+  TS_ASSERT_EQUALS(acq->GetPointNumber(), ref->GetPointNumber());
+  TS_ASSERT_EQUALS(acq->GetAnalogNumber(), ref->GetAnalogNumber());
+  if ((acq->GetPointNumber() != ref->GetPointNumber()) || (acq->GetAnalogNumber() != ref->GetAnalogNumber()))
+    return;
+  for (int i = 0 ; i < acq->GetPointNumber() ; ++i)
+  {
+    TS_ASSERT_EQUALS(acq->GetPoint(i)->GetLabel(), ref->GetPoint(i)->GetLabel());
+    TS_ASSERT(acq->GetPoint(i)->GetValues().isApprox(ref->GetPoint(i)->GetValues()));
+    TS_ASSERT(acq->GetPoint(i)->GetResiduals().isApprox(ref->GetPoint(i)->GetResiduals()));
+  }
+  for (int i = 0 ; i < acq->GetAnalogNumber() ; ++i)
+  {
+    TS_ASSERT_EQUALS(acq->GetAnalog(i)->GetLabel(), ref->GetAnalog(i)->GetLabel());
+    TS_ASSERT_EQUALS(acq->GetAnalog(i)->GetUnit(), ref->GetAnalog(i)->GetUnit());
+    TS_ASSERT_EQUALS(acq->GetAnalog(i)->GetScale(), ref->GetAnalog(i)->GetScale());
+    TS_ASSERT(acq->GetAnalog(i)->GetValues().isApprox(ref->GetAnalog(i)->GetValues()));
+  }
+  TS_ASSERT(*(acq->GetMetaData()->GetChild("FORCE_PLATFORM")) == *(ref->GetMetaData()->GetChild("FORCE_PLATFORM")));
+};
+
 #endif // _TDDIO_Open3DMotion_Utils_h
\ No newline at end of file
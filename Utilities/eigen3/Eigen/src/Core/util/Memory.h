@@ -206,6 +206,11 @@ inline void check_that_malloc_is_allowed()
 {}
 #endif
 
+// allow to allocate the memory outside Eigen
+#ifdef EIGEN_MEMORY_PLUGIN
+#include EIGEN_MEMORY_PLUGIN
+#endif
+
 /** \internal Allocates \a size bytes. The returned pointer is guaranteed to have 16 bytes alignment.
   * On allocation error, the returned pointer is null, and std::bad_alloc is thrown.
   */
@@ -214,6 +219,10 @@ inline void* aligned_malloc(size_t size)
   check_that_malloc_is_allowed();
 
   void *result;
+  #ifdef EIGEN_MEMORY_PLUGIN
+    if ((result = plugin_aligned_malloc(size)) != 0)
+      return result;
+  #endif
   #if !EIGEN_ALIGN
     result = std::malloc(size);
   #elif EIGEN_MALLOC_ALREADY_ALIGNED
@@ -237,6 +246,10 @@ inline void* aligned_malloc(size_t size)
 /** \internal Frees memory allocated with aligned_malloc. */
 inline void aligned_free(void *ptr)
 {
+  #ifdef EIGEN_MEMORY_PLUGIN
+    if (plugin_aligned_free(ptr))
+      return;
+  #endif
   #if !EIGEN_ALIGN
     std::free(ptr);
   #elif EIGEN_MALLOC_ALREADY_ALIGNED
@@ -262,6 +275,10 @@ inline void* aligned_realloc(void *ptr, size_t new_size, size_t old_size)
   EIGEN_UNUSED_VARIABLE(old_size);
 
   void *result;
+#ifdef EIGEN_MEMORY_PLUGIN
+  if (plugin_aligned_realloc_is_generic(ptr))
+    return generic_aligned_realloc(ptr,new_size,old_size);
+#endif
 #if !EIGEN_ALIGN
   result = std::realloc(ptr,new_size);
 #elif EIGEN_MALLOC_ALREADY_ALIGNED
@@ -0,0 +1,309 @@
+/* 
+ * The Biomechanical ToolKit
+ * Copyright (c) 2009-2014, Arnaud Barré
+ * All rights reserved.
+ * 
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 
+ *     * Redistributions of source code must retain the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer.
+ *     * Redistributions in binary form must reproduce the above
+ *       copyright notice, this list of conditions and the following
+ *       disclaimer in the documentation and/or other materials
+ *       provided with the distribution.
+ *     * Neither the name(s) of the copyright holders nor the names
+ *       of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written
+ *       permission.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __btkEigenFFT_h
+#define __btkEigenFFT_h
+
+#include <Eigen/Core>
+
+#include <complex>
+#include <cmath>
+#include <vector>
+#include <map>
+
+namespace btkEigen
+{
+  using namespace Eigen;
+  
+  namespace internal
+  {
+    inline bool fft_is_power_of_two(int n)
+    {
+      return (n > 0) && ((n & (n - 1)) == 0);
+    };
+    
+    inline int fft_next_power_of_two(int n)
+    {
+      int m = 1;
+      while (m < n)
+        m <<= 1;
+      return m;
+    };
+    
+    // Iterative radix-2 Cooley-Tukey algorithm (decimation in time). The length must be a power of two.
+    // The twiddle factors exp(-2i*pi*k/n) (k < n/2) are given by the array w. The stage of length len uses one factor every n/len.
+    template<typename Scalar>
+    void fft_radix2(std::complex<Scalar>* x, int n, const std::complex<Scalar>* w)
+    {
+      for (int i = 1, j = 0 ; i < n ; ++i)
+      {
+        int bit = n >> 1;
+        for ( ; (j & bit) != 0 ; bit >>= 1)
+          j ^= bit;
+        j ^= bit;
+        if (i < j)
+          std::swap(x[i], x[j]);
+      }
+      for (int len = 2 ; len <= n ; len <<= 1)
+      {
+        const int half = len >> 1;
+        const int stride = n / len;
+        for (int i = 0 ; i < n ; i += len)
+        {
+          for (int k = 0 ; k < half ; ++k)
+          {
+            const std::complex<Scalar> u = x[i+k];
+            const std::complex<Scalar> v = x[i+k+half] * w[k*stride];
+            x[i+k] = u + v;
+            x[i+k+half] = u - v;
+          }
+        }
+      }
+    };
+    
+    // Factors exp(-2i*pi*k/n) for k in [0, num). Each one is computed directly (not by recurrence) to keep the accuracy.
+    template<typename Scalar>
+    void fft_twiddles(std::vector< std::complex<Scalar> >* w, int n, int num)
+    {
+      const Scalar pi = static_cast<Scalar>(3.14159265358979323846);
+      w->resize(num);
+      for (int k = 0 ; k < num ; ++k)
+      {
+        const Scalar theta = -2 * pi * static_cast<Scalar>(k) / static_cast<Scalar>(n);
+        (*w)[k] = std::complex<Scalar>(std::cos(theta), std::sin(theta));
+      }
+    };
+  };
+  
+  /**
+   * Discrete Fourier transforms which keep the twiddle factors computed for each length.
+   *
+   * Power of two lengths are computed with an iterative radix-2 Cooley-Tukey algorithm. 
+   * The other lengths are computed with the Bluestein's algorithm (O(n log n) for any length), 
+   * where the chirp and its spectrum are also kept. Transforming several signals with the same length 
+   * (e.g. the segments of a Welch's periodogram) only computes the trigonometric functions once.
+   *
+   * An object must not be shared between threads (each thread must use its own object).
+   * The functions fft(), ifft() and rfft() use a temporary object.
+   */
+  template<typename Scalar>
+  class FFT
+  {
+  public:
+    typedef std::complex<Scalar> Complex;
+    typedef Matrix<Complex, Dynamic, 1> ComplexVector;
+    
+    FFT() : m_Plans() {};
+    
+    template<typename Derived> ComplexVector fwd(const MatrixBase<Derived>& x);
+    template<typename Derived> ComplexVector inv(const MatrixBase<Derived>& X);
+    template<typename Derived> ComplexVector rfwd(const MatrixBase<Derived>& x);
+    
+    void clear() {this->m_Plans.clear();};
+    
+  private:
+    struct Plan
+    {
+      std::vector<Complex> twiddles; // Radix-2 factors (length n or length of the Bluestein's convolution)
+      std::vector<Complex> chirp; // Bluestein's chirp exp(-i*pi*k^2/n)
+      std::vector<Complex> chirpSpectrum; // FFT of the conjugated chirp (zero padded)
+      std::vector<Complex> work;
+      std::vector<Complex> unpack; // Factors exp(-i*pi*k/n) (k <= n) to separate a packed real transform of length 2n
+    };
+    
+    Plan& plan(int n);
+    void transform(Complex* x, int n);
+    
+    std::map<int, Plan> m_Plans;
+  };
+  
+  template<typename Scalar>
+  typename FFT<Scalar>::Plan& FFT<Scalar>::plan(int n)
+  {
+    Plan& p = this->m_Plans[n];
+    if ((n <= 1) || !p.twiddles.empty())
+      return p;
+    if (internal::fft_is_power_of_two(n))
+    {
+      internal::fft_twiddles(&(p.twiddles), n, n / 2);
+      return p;
+    }
+    const int m = internal::fft_next_power_of_two(2 * n - 1);
+    const Scalar pi = static_cast<Scalar>(3.14159265358979323846);
+    internal::fft_twiddles(&(p.twiddles), m, m / 2);
+    p.chirp.resize(n);
+    p.chirpSpectrum.assign(m, Complex(0, 0));
+    p.work.resize(m);
+    for (int k = 0 ; k < n ; ++k)
+    {
+      // k^2 modulo 2n to keep the accuracy of the angle for long signals
+      const long long k2 = (static_cast<long long>(k) * k) % (2 * static_cast<long long>(n));
+      const Scalar theta = -pi * static_cast<Scalar>(k2) / static_cast<Scalar>(n);
+      p.chirp[k] = Complex(std::cos(theta), std::sin(theta));
+      p.chirpSpectrum[k] = std::conj(p.chirp[k]);
+      if (k != 0)
+        p.chirpSpectrum[m-k] = p.chirpSpectrum[k];
+    }
+    internal::fft_radix2(&(p.chirpSpectrum[0]), m, &(p.twiddles[0]));
+    return p;
+  };
+  
+  // Forward transform in place (not scaled).
+  template<typename Scalar>
+  void FFT<Scalar>::transform(Complex* x, int n)
+  {
+    if (n <= 1)
+      return;
+    Plan& p = this->plan(n);
+    if (p.chirp.empty())
+    {
+      internal::fft_radix2(x, n, &(p.twiddles[0]));
+      return;
+    }
+    // Bluestein's algorithm (chirp z-transform)
+    const int m = static_cast<int>(p.work.size());
+    Complex* a = &(p.work[0]);
+    for (int k = 0 ; k < n ; ++k)
+      a[k] = x[k] * p.chirp[k];
+    for (int k = n ; k < m ; ++k)
+      a[k] = Complex(0, 0);
+    internal::fft_radix2(a, m, &(p.twiddles[0]));
+    // Inverse transform computed as conj(fft(conj(.)))
+    for (int k = 0 ; k < m ; ++k)
+      a[k] = std::conj(a[k] * p.chirpSpectrum[k]);
+    internal::fft_radix2(a, m, &(p.twiddles[0]));
+    for (int k = 0 ; k < n ; ++k)
+      x[k] = std::conj(a[k]) * p.chirp[k] / static_cast<Scalar>(m);
+  };
+  
+  /**
+   * Discrete Fourier transform of a complex (or real) vector.
+   * As in Matlab and NumPy, the forward transform is not scaled.
+   */
+  template<typename Scalar>
+  template<typename Derived>
+  typename FFT<Scalar>::ComplexVector FFT<Scalar>::fwd(const MatrixBase<Derived>& x)
+  {
+    ComplexVector X = x.template cast<Complex>();
+    this->transform(X.data(), static_cast<int>(X.rows()));
+    return X;
+  };
+  
+  /**
+   * Inverse discrete Fourier transform of a complex vector (scaled by 1/n).
+   */
+  template<typename Scalar>
+  template<typename Derived>
+  typename FFT<Scalar>::ComplexVector FFT<Scalar>::inv(const MatrixBase<Derived>& X)
+  {
+    ComplexVector x = X.template cast<Complex>().conjugate();
+    this->transform(x.data(), static_cast<int>(x.rows()));
+    if (x.rows() != 0)
+      x = x.conjugate() / static_cast<Scalar>(x.rows());
+    return x;
+  };
+  
+  /**
+   * Discrete Fourier transform of a real vector. Only the n/2+1 first coefficients are returned 
+   * (the others are the complex conjugates).
+   *
+   * For even lengths, the real signal is packed in a complex signal of half length, transformed, 
+   * and the coefficients are then separated. This is about twice faster than the complex transform.
+   */
+  template<typename Scalar>
+  template<typename Derived>
+  typename FFT<Scalar>::ComplexVector FFT<Scalar>::rfwd(const MatrixBase<Derived>& x)
+  {
+    const int n = static_cast<int>(x.size());
+    if (n == 0)
+      return ComplexVector();
+    ComplexVector X(n / 2 + 1);
+    if ((n % 2) != 0)
+    {
+      ComplexVector full = x.template cast<Complex>();
+      this->transform(full.data(), n);
+      X = full.head(n / 2 + 1);
+      return X;
+    }
+    const int m = n / 2;
+    ComplexVector z(m);
+    for (int k = 0 ; k < m ; ++k)
+      z.coeffRef(k) = Complex(x.coeff(2*k), x.coeff(2*k+1));
+    this->transform(z.data(), m);
+    Plan& p = this->plan(m);
+    if (p.unpack.empty())
+      internal::fft_twiddles(&(p.unpack), n, m + 1);
+    for (int k = 0 ; k <= m ; ++k)
+    {
+      const Complex zk = z.coeff(k % m);
+      const Complex zc = std::conj(z.coeff((m - k) % m));
+      const Complex even = (zk + zc) * static_cast<Scalar>(0.5);
+      const Complex odd = (zk - zc) * Complex(0, static_cast<Scalar>(-0.5));
+      X.coeffRef(k) = even + p.unpack[k] * odd;
+    }
+    return X;
+  };
+  
+  /**
+   * Discrete Fourier transform of a complex (or real) vector (see the class FFT).
+   * As in Matlab and NumPy, the forward transform is not scaled.
+   */
+  template<typename Derived>
+  Matrix<std::complex<typename NumTraits<typename Derived::Scalar>::Real>, Dynamic, 1> fft(const MatrixBase<Derived>& x)
+  {
+    return FFT<typename NumTraits<typename Derived::Scalar>::Real>().fwd(x);
+  };
+  
+  /**
+   * Inverse discrete Fourier transform of a complex vector (scaled by 1/n).
+   */
+  template<typename Derived>
+  Matrix<std::complex<typename NumTraits<typename Derived::Scalar>::Real>, Dynamic, 1> ifft(const MatrixBase<Derived>& X)
+  {
+    return FFT<typename NumTraits<typename Derived::Scalar>::Real>().inv(X);
+  };
+  
+  /**
+   * Discrete Fourier transform of a real vector. Only the n/2+1 first coefficients are returned 
+   * (see FFT::rfwd()).
+   */
+  template<typename Derived>
+  Matrix<std::complex<typename Derived::Scalar>, Dynamic, 1> rfft(const MatrixBase<Derived>& x)
+  {
+    return FFT<typename Derived::Scalar>().rfwd(x);
+  };
+};
+
+#endif // __btkEigenFFT_h
@@ -51,15 +51,15 @@ namespace btkEigen
   typedef enum {Elliptic = 0, Butterworth, ChebyshevI, ChebyshevII, Bessel} FilterType;
   typedef enum {LowPass = 0, HighPass, BandPass, BandStop} BandType;
 
-  bool iirfilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn, double* rp = NULL, double* rs = NULL, BandType btype = LowPass, FilterType ftype = Butterworth);
-  bool iirfilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn[2], double* rp = NULL, double* rs = NULL, BandType btype = BandPass, FilterType ftype = Butterworth);
+  inline bool iirfilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn, double* rp = NULL, double* rs = NULL, BandType btype = LowPass, FilterType ftype = Butterworth);
+  inline bool iirfilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn[2], double* rp = NULL, double* rs = NULL, BandType btype = BandPass, FilterType ftype = Butterworth);
 
-  bool butter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn, BandType btype = LowPass)
+  inline bool butter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn, BandType btype = LowPass)
   {
     return iirfilter(b, a, order, Wn, NULL, NULL, btype, Butterworth);
   };
   
-  bool butter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn[2], BandType btype = BandPass)
+  inline bool butter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn[2], BandType btype = BandPass)
   {
     return iirfilter(b, a, order, Wn, NULL, NULL, btype, Butterworth);
   };
@@ -67,7 +67,7 @@ namespace btkEigen
   // See the  paper "Design and responses of Butterworth and critically damped digital filters", Robertson & Dowling, Journal of Electromyography and Kinesiology, 2003.
   // or the paragraph 3.4.4.2 in the book "Biomechanics and Motor Control of Human Movement" (David A. Winter)
   // for more explanation on the need to adjust the order and the cutoff frequency.
-  void adjustZeroLagButterworth(int& n, double (*wn)[2])
+  inline void adjustZeroLagButterworth(int& n, double (*wn)[2])
   {
     const double c = 1.0 / std::pow(std::pow(2,1.0/static_cast<double>(n))-1.0, 0.25);
     (*wn)[0] *= c;
@@ -75,7 +75,7 @@ namespace btkEigen
     n /= 2;
   };
   
-  void adjustZeroLagButterworth(int& n, double& wn)
+  inline void adjustZeroLagButterworth(int& n, double& wn)
   {
     double wn_[2] = {wn, 0.0};
     adjustZeroLagButterworth(n, &wn_);
@@ -126,7 +126,7 @@ namespace btkEigen
 
   // ------------------------------------------------------------------------- //
 
-  void buttap(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* /* z */, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* p, double* k, int n)
+  inline void buttap(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* /* z */, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* p, double* k, int n)
   {
     // z is set to [], so no modification.
     std::complex<double> _1j(0.0, 1.0);
@@ -137,13 +137,13 @@ namespace btkEigen
     *k = 1.0;
   };
 
-  void zpk2tf(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, const Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>& z, const Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>& p, double k)
+  inline void zpk2tf(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, const Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>& z, const Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>& p, double k)
   {
     poly(b, z); *b *= k;
     poly(a, p);
   };
 
-  void lp2lp(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, double wo = 1.0)
+  inline void lp2lp(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, double wo = 1.0)
   {
     typedef Matrix<double,-1,-1>::Index Index;
     const Index d = a->rows();
@@ -161,7 +161,7 @@ namespace btkEigen
     normalize(b,a);
   };
   
-  void lp2hp(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, double wo = 1.0)
+  inline void lp2hp(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, double wo = 1.0)
   {
     typedef Matrix<double,-1,-1>::Index Index;
     Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1> a_ = *a, b_ = *b;
@@ -192,7 +192,7 @@ namespace btkEigen
     normalize(b,a);
   };
   
-  void lp2bp(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, double wo = 1.0, double bw = 1.0)
+  inline void lp2bp(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, double wo = 1.0, double bw = 1.0)
   {
     typedef Matrix<double,-1,-1>::Index Index;
     const Index d = a->rows() - 1;
@@ -233,7 +233,7 @@ namespace btkEigen
     normalize(b,a);
   };
   
-  void lp2bs(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, double wo = 1.0, double bw = 1.0)
+  inline void lp2bs(Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* b, Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>* a, double wo = 1.0, double bw = 1.0)
   {
     typedef Matrix<double,-1,-1>::Index Index;
     const Index d = a->rows() - 1;
@@ -274,7 +274,7 @@ namespace btkEigen
     normalize(b,a);
   };
 
-  void bilinear(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix< double, Eigen::Dynamic, 1>* a, const Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>& b_, const Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>& a_, double fs = 1.0)
+  inline void bilinear(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix< double, Eigen::Dynamic, 1>* a, const Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>& b_, const Eigen::Matrix< std::complex<double>, Eigen::Dynamic, 1>& a_, double fs = 1.0)
   {
     typedef Matrix<double,-1,-1>::Index Index;
     const Index d = a_.rows() - 1;
@@ -337,7 +337,7 @@ namespace btkEigen
    *  - 3: Chebyshev II
    *  - 4: Bessel
    */
-  bool iirfilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn, double* rp, double* rs, BandType btype, FilterType ftype)
+  inline bool iirfilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn, double* rp, double* rs, BandType btype, FilterType ftype)
   {
     // This function is only for low pass or high pass filter
     if ((btype == 2) || (btype == 3))
@@ -349,7 +349,7 @@ namespace btkEigen
     return iirfilter(b, a, order, Wn_, rp, rs, btype, ftype);
   };
 
-  bool iirfilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn[2], double* /*rp*/, double* /*rs*/, BandType btype, FilterType ftype)
+  inline bool iirfilter(Eigen::Matrix<double, Eigen::Dynamic, 1>* b, Eigen::Matrix<double, Eigen::Dynamic, 1>* a, int order, double Wn[2], double* /*rp*/, double* /*rs*/, BandType btype, FilterType ftype)
   {
     // This function is only for band pass or band stop filter
     if (((btype == 0) || (btype == 1)) && (Wn[1] != -1.0))
@@ -171,8 +171,8 @@ T _gammaln(T x)
 };
 
 template <typename T> T gammaln(T x) {return (x == T(0)) ? std::numeric_limits<T>::infinity() : static_cast<T>(_gammaln<double>(static_cast<double>(x)));};
-template <> double gammaln<double>(double x) {return _gammaln(x);};
-template <> float gammaln<float>(float x) {return _gammaln(x);};
+template <> inline double gammaln<double>(double x) {return _gammaln(x);};
+template <> inline float gammaln<float>(float x) {return _gammaln(x);};
 
 template <typename T> std::complex<T> gammaln(const std::complex<T>& x)
 {